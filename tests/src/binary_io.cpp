@@ -0,0 +1,258 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/binary_io.cpp  Tests writing and reading matrices in the ViennaCL binary format.
+*   \test Tests writing and reading matrices in the ViennaCL binary format.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <map>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/coordinate_matrix.hpp"
+#include "viennacl/ell_matrix.hpp"
+#include "viennacl/sliced_ell_matrix.hpp"
+#include "viennacl/hyb_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/io/matrix_market.hpp"
+#include "viennacl/io/binary.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+static const char * test_file = "binary_io_test.vclb";
+
+template<typename NumericT>
+NumericT diff(std::vector<NumericT> const & v1, viennacl::vector<NumericT> const & v2)
+{
+  std::vector<NumericT> v2_cpu(v2.size());
+  viennacl::copy(v2, v2_cpu);
+
+  NumericT norm_inf = 0;
+  for (std::size_t i=0; i<v1.size(); ++i)
+    norm_inf = std::max<NumericT>(norm_inf, std::fabs(v1[i] - v2_cpu[i]));
+  return norm_inf;
+}
+
+/** @brief Writes the sparse matrix to a file, reads it into a new matrix and compares the matrix-vector products */
+template<typename SparseMatrixT, typename NumericT>
+int test_sparse(SparseMatrixT const & A, viennacl::vector<NumericT> const & x, std::vector<NumericT> const & reference, const char * name)
+{
+  std::cout << "Testing " << name << "..." << std::endl;
+
+  CHECK(viennacl::io::write_binary_file(A, test_file) > 0, "writing " << name << " failed");
+
+  SparseMatrixT B;
+  CHECK(viennacl::io::read_binary_file(B, test_file) > 0, "reading " << name << " failed");
+  CHECK(B.size1() == A.size1() && B.size2() == A.size2(), "wrong size of " << name);
+
+  viennacl::vector<NumericT> y = viennacl::linalg::prod(B, x);
+  CHECK(diff(reference, y) <= 0, "wrong result of matrix-vector product with " << name << " read from file");
+
+  // the buffers refer to the file mapping, which must remain valid after the file is removed:
+  std::remove(test_file);
+  y = viennacl::linalg::prod(B, x);
+  CHECK(diff(reference, y) <= 0, "wrong result of matrix-vector product with " << name << " after removal of the file");
+
+  return EXIT_SUCCESS;
+}
+
+template<typename NumericT, typename LayoutT>
+int test_dense(const char * name)
+{
+  std::cout << "Testing " << name << "..." << std::endl;
+
+  std::size_t rows = 67, cols = 131;
+  std::vector<std::vector<NumericT> > std_A(rows, std::vector<NumericT>(cols));
+  for (std::size_t i=0; i<rows; ++i)
+    for (std::size_t j=0; j<cols; ++j)
+      std_A[i][j] = NumericT(i) - NumericT(2 * j) / NumericT(3);
+
+  viennacl::matrix<NumericT, LayoutT> A(rows, cols);
+  viennacl::copy(std_A, A);
+  CHECK(viennacl::io::write_binary_file(A, test_file) > 0, "writing " << name << " failed");
+
+  viennacl::matrix<NumericT, LayoutT> B;
+  CHECK(viennacl::io::read_binary_file(B, test_file) > 0, "reading " << name << " failed");
+  CHECK(B.size1() == rows && B.size2() == cols, "wrong size of " << name);
+
+  std::vector<std::vector<NumericT> > std_B(rows, std::vector<NumericT>(cols));
+  viennacl::copy(B, std_B);
+  for (std::size_t i=0; i<rows; ++i)
+    for (std::size_t j=0; j<cols; ++j)
+      CHECK(std_A[i][j] == std_B[i][j], "wrong entry (" << i << ", " << j << ") of " << name);
+
+  // modifications of the matrix must not alter the file:
+  B *= NumericT(2);
+  viennacl::matrix<NumericT, LayoutT> C;
+  CHECK(viennacl::io::read_binary_file(C, test_file) > 0, "reading " << name << " failed");
+  CHECK(C(rows - 1, cols - 1) == std_A[rows - 1][cols - 1], "file modified through matrix");
+  CHECK(B(rows - 1, cols - 1) == 2 * std_A[rows - 1][cols - 1], "matrix not modified");
+
+  std::remove(test_file);
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Binary file format for matrices" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  typedef double NumericT;
+
+  std::vector<std::map<unsigned int, NumericT> > std_matrix;
+  if (viennacl::io::read_matrix_market_file(std_matrix, "../examples/testdata/mat65k.mtx") == EXIT_FAILURE)
+  {
+    std::cout << "Error reading Matrix file" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<NumericT> std_x(std_matrix.size());
+  for (std::size_t i=0; i<std_x.size(); ++i)
+    std_x[i] = NumericT(1) + NumericT(i % 17) / NumericT(7);
+  viennacl::vector<NumericT> x(std_x.size());
+  viennacl::copy(std_x, x);
+
+  viennacl::compressed_matrix<NumericT>  A_csr;
+  viennacl::coordinate_matrix<NumericT>  A_coo;
+  viennacl::ell_matrix<NumericT>         A_ell;
+  viennacl::sliced_ell_matrix<NumericT>  A_sell;
+  viennacl::hyb_matrix<NumericT>         A_hyb;
+  viennacl::copy(std_matrix, A_csr);
+  viennacl::copy(std_matrix, A_coo);
+  viennacl::copy(std_matrix, A_ell);
+  viennacl::copy(std_matrix, A_sell);
+  viennacl::copy(std_matrix, A_hyb);
+
+  // products of the in-memory matrices serve as reference, the loaded matrices must reproduce them exactly:
+  std::vector<NumericT> reference(std_x.size());
+  viennacl::vector<NumericT> y = viennacl::linalg::prod(A_csr, x);
+  viennacl::copy(y, reference);
+
+  if (test_sparse(A_csr, x, reference, "compressed_matrix") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  y = viennacl::linalg::prod(A_coo, x);
+  viennacl::copy(y, reference);
+  if (test_sparse(A_coo, x, reference, "coordinate_matrix") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  y = viennacl::linalg::prod(A_ell, x);
+  viennacl::copy(y, reference);
+  if (test_sparse(A_ell, x, reference, "ell_matrix") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  y = viennacl::linalg::prod(A_sell, x);
+  viennacl::copy(y, reference);
+  if (test_sparse(A_sell, x, reference, "sliced_ell_matrix") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  viennacl::sliced_ell_matrix<NumericT>  A_sell_sorted(std_matrix.size(), std_matrix.size(), 32, 256);
+  viennacl::copy(std_matrix, A_sell_sorted);
+  y = viennacl::linalg::prod(A_sell_sorted, x);
+  viennacl::copy(y, reference);
+  if (test_sparse(A_sell_sorted, x, reference, "sliced_ell_matrix, sorted rows") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  y = viennacl::linalg::prod(A_hyb, x);
+  viennacl::copy(y, reference);
+  if (test_sparse(A_hyb, x, reference, "hyb_matrix") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  if (test_dense<float, viennacl::row_major>("row-major matrix<float>") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (test_dense<double, viennacl::column_major>("column-major matrix<double>") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "Testing detection of invalid files..." << std::endl;
+  {
+    CHECK(viennacl::io::write_binary_file(A_csr, test_file) > 0, "writing compressed_matrix failed");
+
+    viennacl::compressed_matrix<float> A_float;
+    CHECK(viennacl::io::read_binary_file(A_float, test_file) == 0, "value type mismatch not detected");
+
+    viennacl::coordinate_matrix<NumericT> A_other;
+    CHECK(viennacl::io::read_binary_file(A_other, test_file) == 0, "matrix type mismatch not detected");
+
+    viennacl::matrix<NumericT> A_dense;
+    CHECK(viennacl::io::read_binary_file(A_dense, test_file) == 0, "matrix type mismatch not detected");
+
+    // claim more nonzeros in the header than the sections hold (with a valid header checksum):
+    {
+      std::fstream file(test_file, std::ios::in | std::ios::out | std::ios::binary);
+      viennacl::io::detail::binary_file_header header;
+      std::vector<viennacl::io::detail::binary_file_section> sections(3);
+      file.read(reinterpret_cast<char *>(&header), sizeof(header));
+      file.read(reinterpret_cast<char *>(&sections[0]), static_cast<std::streamsize>(sizeof(sections[0]) * sections.size()));
+      header.parameters[2] += 1000;
+      header.checksum = viennacl::io::detail::binary_header_checksum(header, sections);
+      file.seekp(0);
+      file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    viennacl::compressed_matrix<NumericT> A_short(5, 5);
+    CHECK(viennacl::io::read_binary_file(A_short, test_file, false) == 0, "section sizes not matching the header not detected");
+    CHECK(A_short.size1() == 5 && A_short.nnz() == 0, "matrix modified when reading an invalid file");
+    CHECK(viennacl::io::write_binary_file(A_csr, test_file) > 0, "writing compressed_matrix failed");
+
+    // flip a bit in the middle of the data:
+    {
+      std::fstream file(test_file, std::ios::in | std::ios::out | std::ios::binary);
+      file.seekg(0, std::ios::end);
+      std::streamoff middle = file.tellg() / 2;
+      char c = 0;
+      file.seekg(middle);
+      file.get(c);
+      file.seekp(middle);
+      file.put(static_cast<char>(c ^ 0x10));
+    }
+    viennacl::compressed_matrix<NumericT> A_corrupt;
+    CHECK(viennacl::io::read_binary_file(A_corrupt, test_file) == 0, "corrupted data not detected");
+
+    std::remove(test_file);
+    CHECK(viennacl::io::read_binary_file(A_corrupt, test_file) == 0, "missing file not detected");
+  }
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
+//
+// -------------------------------------------------------------
+//
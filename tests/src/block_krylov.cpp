@@ -0,0 +1,238 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/block_krylov.cpp  Tests the block CG and block GMRES solvers for multiple right hand sides.
+*   \test Tests the block CG and block GMRES solvers for multiple right hand sides against the solvers for a single right hand side, including zero and linearly dependent right hand sides.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/coordinate_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/gmres.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/ilu.hpp"
+#include "viennacl/linalg/ichol.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+/** @brief Sets up a sparse matrix: The five-point finite difference Laplacian on a points x points grid with a convection term in x-direction (symmetric if convection is zero). */
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > generate_matrix(std::size_t points, NumericT convection)
+{
+  std::size_t n = points * points;
+  std::vector<std::map<unsigned int, NumericT> > A(n);
+  for (std::size_t row = 0; row < n; ++row)
+  {
+    std::size_t i = row % points;
+    std::size_t j = row / points;
+    A[row][static_cast<unsigned int>(row)] = NumericT(4 + row % 3);
+    if (i > 0)          A[row][static_cast<unsigned int>(row - 1)]      = NumericT(-1) - convection;
+    if (i + 1 < points) A[row][static_cast<unsigned int>(row + 1)]      = NumericT(-1) + convection;
+    if (j > 0)          A[row][static_cast<unsigned int>(row - points)] = NumericT(-1);
+    if (j + 1 < points) A[row][static_cast<unsigned int>(row + points)] = NumericT(-1);
+  }
+  return A;
+}
+
+/** @brief Sets up the right hand sides: Column 1 is zero, column 3 is a multiple of column 0, all others are linearly independent. */
+template<typename NumericT>
+std::vector<std::vector<NumericT> > generate_rhs(std::size_t n, std::size_t num_rhs)
+{
+  std::vector<std::vector<NumericT> > B(n, std::vector<NumericT>(num_rhs));
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < num_rhs; ++j)
+    {
+      if (j == 1)
+        continue;
+      else if (j == 3)
+        B[i][j] = NumericT(2) * B[i][0];
+      else
+        B[i][j] = NumericT(1) + NumericT((i * (j + 1) + 3 * j) % 17) / NumericT(7);
+    }
+  return B;
+}
+
+/** @brief Solves for all right hand sides with the block solver, then checks the true residuals and compares the iteration counts with the solver for each single right hand side */
+template<typename NumericT, typename MatrixT, typename RHSMatrixT, typename TagT, typename PreconditionerT>
+int check_solver(MatrixT const & A, RHSMatrixT const & B, TagT const & tag, PreconditionerT const & precond, NumericT tolerance, std::string const & name)
+{
+  RHSMatrixT X = viennacl::linalg::solve(A, B, tag, precond);
+  CHECK(X.size1() == B.size1() && X.size2() == B.size2(), name << ": wrong size of result");
+
+  unsigned int block_iterations = tag.iters();
+  CHECK(tag.error() < 10 * tolerance, name << ": block solver did not converge, error estimate " << tag.error());
+
+  unsigned int max_single_iterations = 0;
+  for (std::size_t j = 0; j < B.size2(); ++j)
+  {
+    viennacl::vector<NumericT> b = viennacl::column(B, static_cast<unsigned int>(j));
+    viennacl::vector<NumericT> x = viennacl::column(X, static_cast<unsigned int>(j));
+    NumericT norm_b = viennacl::linalg::norm_2(b);
+
+    if (norm_b <= 0)
+    {
+      CHECK(viennacl::linalg::norm_2(x) <= 0, name << ": nonzero result for zero right hand side " << j);
+      continue;
+    }
+
+    viennacl::vector<NumericT> residual = viennacl::linalg::prod(A, x);
+    residual -= b;
+    NumericT relative_residual = viennacl::linalg::norm_2(residual) / norm_b;
+    CHECK(relative_residual < NumericT(100) * tolerance, name << ": residual too large for right hand side " << j << ": " << relative_residual);
+
+    // the single right hand side solver is only used for the iteration counts, its solution may be less accurate than the one of the block solver:
+    TagT single_tag(tag);
+    viennacl::linalg::solve(A, b, single_tag, precond);
+    max_single_iterations = std::max(max_single_iterations, single_tag.iters());
+  }
+
+  std::cout << "  " << name << ": " << block_iterations << " block iterations (single right hand side: at most " << max_single_iterations << "), error " << tag.error() << std::endl;
+  CHECK(block_iterations <= max_single_iterations, name << ": block solver needs more iterations than for a single right hand side");
+
+  return EXIT_SUCCESS;
+}
+
+template<typename NumericT>
+int test(NumericT tolerance)
+{
+  std::size_t points = 30;
+  std::size_t n = points * points;
+  std::size_t num_rhs = 6;
+
+  std::vector<std::map<unsigned int, NumericT> > std_A = generate_matrix<NumericT>(points, NumericT(0));
+  viennacl::compressed_matrix<NumericT> A(n, n);
+  viennacl::copy(std_A, A);
+  viennacl::coordinate_matrix<NumericT> A_coo(n, n);
+  viennacl::copy(std_A, A_coo);
+
+  std::vector<std::map<unsigned int, NumericT> > std_A_nonsym = generate_matrix<NumericT>(points, NumericT(0.4));
+  viennacl::compressed_matrix<NumericT> A_nonsym(n, n);
+  viennacl::copy(std_A_nonsym, A_nonsym);
+
+  std::vector<std::vector<NumericT> > std_B = generate_rhs<NumericT>(n, num_rhs);
+  viennacl::matrix<NumericT> B(n, num_rhs);
+  viennacl::copy(std_B, B);
+  viennacl::matrix<NumericT, viennacl::column_major> B_col(n, num_rhs);
+  viennacl::copy(std_B, B_col);
+
+  //
+  // block CG:
+  //
+  viennacl::linalg::cg_tag cg_tag(tolerance, 1000);
+  if (check_solver(A, B, cg_tag, viennacl::linalg::no_precond(), tolerance, "block CG") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  viennacl::linalg::jacobi_precond<viennacl::compressed_matrix<NumericT> > jacobi(A, viennacl::linalg::jacobi_tag());
+  if (check_solver(A, B_col, cg_tag, jacobi, tolerance, "block CG, Jacobi, column-major right hand sides") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  viennacl::linalg::ichol0_precond<viennacl::compressed_matrix<NumericT> > ichol0(A, viennacl::linalg::ichol0_tag());
+  if (check_solver(A, B, cg_tag, ichol0, tolerance, "block CG, incomplete Cholesky") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  if (check_solver(A_coo, B, cg_tag, viennacl::linalg::no_precond(), tolerance, "block CG, coordinate_matrix") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  viennacl::matrix<NumericT> X = viennacl::linalg::solve(A, B, cg_tag);
+  CHECK(cg_tag.error() < 10 * tolerance, "block CG without preconditioner argument did not converge");
+
+  // not enough iterations:
+  viennacl::linalg::cg_tag short_cg_tag(tolerance, 3);
+  X = viennacl::linalg::solve(A, B, short_cg_tag);
+  CHECK(short_cg_tag.iters() == 3 && short_cg_tag.error() > tolerance, "block CG: wrong iteration count or error estimate if not converged");
+
+  //
+  // block GMRES:
+  //
+  viennacl::linalg::gmres_tag gmres_tag(tolerance, 1000, 10);
+  if (check_solver(A_nonsym, B, gmres_tag, viennacl::linalg::no_precond(), tolerance, "block GMRES") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  viennacl::linalg::ilu0_precond<viennacl::compressed_matrix<NumericT> > ilu0(A_nonsym, viennacl::linalg::ilu0_tag());
+  if (check_solver(A_nonsym, B_col, gmres_tag, ilu0, tolerance, "block GMRES, ILU0, column-major right hand sides") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  viennacl::linalg::gmres_tag large_gmres_tag(tolerance, 1000, 100);
+  if (check_solver(A_nonsym, B, large_gmres_tag, viennacl::linalg::no_precond(), tolerance, "block GMRES, no restarts") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  X = viennacl::linalg::solve(A_nonsym, B, gmres_tag);
+  CHECK(gmres_tag.error() < 10 * tolerance, "block GMRES without preconditioner argument did not converge");
+
+  // all right hand sides zero:
+  viennacl::matrix<NumericT> zero(n, num_rhs);
+  X = viennacl::linalg::solve(A, zero, cg_tag);
+  CHECK(cg_tag.iters() == 0, "block CG: iterations for zero right hand sides");
+  X = viennacl::linalg::solve(A_nonsym, zero, gmres_tag);
+  CHECK(gmres_tag.iters() == 0, "block GMRES: iterations for zero right hand sides");
+  for (std::size_t j = 0; j < num_rhs; ++j)
+  {
+    viennacl::vector<NumericT> x = viennacl::column(X, static_cast<unsigned int>(j));
+    CHECK(viennacl::linalg::norm_2(x) <= 0, "nonzero result for zero right hand sides");
+  }
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Block Krylov solvers" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: float" << std::endl;
+  if (test<float>(1e-4f) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: double" << std::endl;
+  if (test<double>(1e-10) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,269 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/block_sparse.cpp  Tests the block compressed sparse row format (block_compressed_matrix).
+*   \test Tests the block compressed sparse row format (block_compressed_matrix): Conversions, matrix-vector products, and iterative solvers with block Jacobi preconditioner.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/vector_proxy.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/block_compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/bicgstab.hpp"
+#include "viennacl/linalg/gmres.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/tools/sparse_format.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+template<typename NumericT>
+NumericT diff(std::vector<NumericT> const & v1, viennacl::vector_base<NumericT> const & v2)
+{
+  std::vector<NumericT> v2_cpu(v2.size());
+  viennacl::copy(v2, v2_cpu);
+
+  NumericT norm_inf = 0;
+  for (std::size_t i=0; i<v1.size(); ++i)
+    norm_inf = std::max<NumericT>(norm_inf, std::fabs(v1[i] - v2_cpu[i]) / std::max<NumericT>(1, std::fabs(v1[i])));
+  return norm_inf;
+}
+
+/** @brief Reference product y = A * x with the host matrix */
+template<typename NumericT>
+std::vector<NumericT> reference_prod(std::vector<std::map<unsigned int, NumericT> > const & A, std::vector<NumericT> const & x)
+{
+  std::vector<NumericT> y(A.size());
+  for (std::size_t i=0; i<A.size(); ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = A[i].begin(); it != A[i].end(); ++it)
+      y[i] += it->second * x[it->first];
+  return y;
+}
+
+/** @brief Sets up the symmetric positive definite matrix L (x) I + D of a system with block_size unknowns per node on a points x points grid.
+*
+* L is the five-point finite difference Laplacian, D is block diagonal with node-dependent symmetric positive definite blocks, some of which are sparse.
+*/
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > generate_block_system(std::size_t points, std::size_t block_size)
+{
+  std::size_t nodes = points * points;
+  std::vector<std::map<unsigned int, NumericT> > A(nodes * block_size);
+
+  for (std::size_t node = 0; node < nodes; ++node)
+  {
+    std::size_t i = node % points;
+    std::size_t j = node / points;
+    std::vector<std::size_t> neighbors;
+    if (i > 0)          neighbors.push_back(node - 1);
+    if (i + 1 < points) neighbors.push_back(node + 1);
+    if (j > 0)          neighbors.push_back(node - points);
+    if (j + 1 < points) neighbors.push_back(node + points);
+
+    NumericT node_scaling = NumericT(1 + node % 7);
+    for (std::size_t r = 0; r < block_size; ++r)
+    {
+      unsigned int row = static_cast<unsigned int>(node * block_size + r);
+
+      for (std::size_t k = 0; k < neighbors.size(); ++k)
+        A[row][static_cast<unsigned int>(neighbors[k] * block_size + r)] = NumericT(-1);
+
+      for (std::size_t c = 0; c < block_size; ++c)
+      {
+        if (r != c && node % 3 == 0) // leave some of the diagonal blocks diagonal
+          continue;
+        NumericT coupling = (r == c) ? NumericT(block_size + 1) : NumericT(1) / NumericT(1 + std::max(r, c) - std::min(r, c));
+        A[row][static_cast<unsigned int>(node * block_size + c)] = node_scaling * coupling + ((r == c) ? NumericT(4) : NumericT(0));
+      }
+    }
+  }
+  return A;
+}
+
+/** @brief Checks that x solves A x = b up to the provided relative tolerance */
+template<typename MatrixT, typename NumericT>
+int check_solution(MatrixT const & A, viennacl::vector<NumericT> const & x, viennacl::vector<NumericT> const & b, NumericT tolerance, const char * name)
+{
+  viennacl::vector<NumericT> residual = viennacl::linalg::prod(A, x);
+  residual -= b;
+  NumericT relative_residual = viennacl::linalg::norm_2(residual) / viennacl::linalg::norm_2(b);
+  CHECK(relative_residual < tolerance, "solver " << name << " did not converge, relative residual: " << relative_residual);
+  return EXIT_SUCCESS;
+}
+
+template<typename NumericT, unsigned int BlockSize>
+int test(NumericT eps, NumericT solver_tolerance)
+{
+  std::cout << "Testing block size " << BlockSize << "..." << std::endl;
+
+  std::size_t points = 23;
+  std::vector<std::map<unsigned int, NumericT> > std_A = generate_block_system<NumericT>(points, BlockSize);
+  std::size_t n = std_A.size();
+
+  std::vector<NumericT> std_x(n);
+  for (std::size_t i=0; i<n; ++i)
+    std_x[i] = NumericT(1) + NumericT(i % 11) / NumericT(7);
+  std::vector<NumericT> std_y = reference_prod(std_A, std_x);
+
+  viennacl::vector<NumericT> x(n);
+  viennacl::copy(std_x, x);
+
+  //
+  // set up from host matrix and copy back:
+  //
+  viennacl::block_compressed_matrix<NumericT, BlockSize> A;
+  viennacl::copy(std_A, A);
+  CHECK(A.size1() == n && A.size2() == n, "wrong matrix size");
+  CHECK(A.nonzero_blocks() == points * points + 4 * points * (points - 1), "wrong number of nonzero blocks: " << A.nonzero_blocks());
+
+  std::vector<std::map<unsigned int, NumericT> > std_A2;
+  viennacl::copy(A, std_A2);
+  CHECK(std_A2.size() == n, "wrong size after copy to host");
+  for (std::size_t i=0; i<n; ++i)
+  {
+    CHECK(std_A2[i].size() == std_A[i].size(), "wrong number of nonzeros in row " << i << " after copy to host");
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = std_A[i].begin(); it != std_A[i].end(); ++it)
+      CHECK(std_A2[i][it->first] == it->second, "wrong entry (" << i << ", " << it->first << ") after copy to host");
+  }
+
+  //
+  // matrix-vector products:
+  //
+  viennacl::vector<NumericT> y = viennacl::linalg::prod(A, x);
+  CHECK(diff(std_y, y) < eps, "wrong result of y = prod(A, x)");
+
+  y += viennacl::linalg::prod(A, x);
+  for (std::size_t i=0; i<n; ++i)
+    std_y[i] *= NumericT(2);
+  CHECK(diff(std_y, y) < eps, "wrong result of y += prod(A, x)");
+
+  viennacl::linalg::prod_impl(A, x, NumericT(-3), y, NumericT(2)); // y = -3 A x + 2 * (2 A x) = A x
+  for (std::size_t i=0; i<n; ++i)
+    std_y[i] /= NumericT(2);
+  CHECK(diff(std_y, y) < eps, "wrong result of y = alpha * prod(A, x) + beta * y");
+
+  // strided vectors:
+  viennacl::vector<NumericT> x_large = viennacl::scalar_vector<NumericT>(2 * n, NumericT(7));
+  viennacl::vector<NumericT> y_large = viennacl::scalar_vector<NumericT>(2 * n, NumericT(7));
+  viennacl::vector_slice<viennacl::vector<NumericT> > x_slice(x_large, viennacl::slice(1, 2, n));
+  viennacl::vector_slice<viennacl::vector<NumericT> > y_slice(y_large, viennacl::slice(0, 2, n));
+  x_slice = x;
+  y_slice = viennacl::linalg::prod(A, x_slice);
+  CHECK(diff(std_y, y_slice) < eps, "wrong result of y = prod(A, x) for strided vectors");
+
+  //
+  // conversion from compressed_matrix:
+  //
+  viennacl::compressed_matrix<NumericT> A_csr(n, n);
+  viennacl::copy(std_A, A_csr);
+  viennacl::block_compressed_matrix<NumericT, BlockSize> A_converted;
+  viennacl::tools::convert(A_csr, A_converted);
+  CHECK(A_converted.nonzero_blocks() == A.nonzero_blocks(), "wrong number of nonzero blocks after conversion from compressed_matrix");
+  y = viennacl::linalg::prod(A_converted, x);
+  CHECK(diff(std_y, y) < eps, "wrong result of y = prod(A, x) after conversion from compressed_matrix");
+
+  //
+  // iterative solvers:
+  //
+  viennacl::vector<NumericT> b = viennacl::scalar_vector<NumericT>(n, NumericT(1));
+  viennacl::linalg::jacobi_precond<viennacl::block_compressed_matrix<NumericT, BlockSize> > block_jacobi(A, viennacl::linalg::jacobi_tag());
+
+  viennacl::linalg::cg_tag cg_tag(solver_tolerance, 1000);
+  viennacl::vector<NumericT> result = viennacl::linalg::solve(A, b, cg_tag);
+  if (check_solution(A, result, b, NumericT(10) * solver_tolerance, "CG") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  std::size_t cg_iterations = cg_tag.iters();
+
+  result = viennacl::linalg::solve(A, b, cg_tag, block_jacobi);
+  if (check_solution(A, result, b, NumericT(10) * solver_tolerance, "CG with block Jacobi preconditioner") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  CHECK(cg_tag.iters() < cg_iterations, "block Jacobi preconditioner does not reduce the number of CG iterations: " << cg_tag.iters() << " vs. " << cg_iterations);
+
+  viennacl::linalg::bicgstab_tag bicgstab_tag(solver_tolerance, 1000);
+  result = viennacl::linalg::solve(A, b, bicgstab_tag, block_jacobi);
+  if (check_solution(A, result, b, NumericT(10) * solver_tolerance, "BiCGStab with block Jacobi preconditioner") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  viennacl::linalg::gmres_tag gmres_tag(solver_tolerance, 1000, 30);
+  result = viennacl::linalg::solve(A, b, gmres_tag, block_jacobi);
+  if (check_solution(A, result, b, NumericT(10) * solver_tolerance, "GMRES with block Jacobi preconditioner") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Block compressed sparse row format" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: float" << std::endl;
+  if (test<float, 1>(1e-5f, 1e-5f) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (test<float, 4>(1e-5f, 1e-5f) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (test<float, 9>(1e-5f, 1e-5f) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if ( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  numeric: double" << std::endl;
+    if (test<double, 2>(1e-12, 1e-10) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test<double, 3>(1e-12, 1e-10) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test<double, 5>(1e-12, 1e-10) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
+//
+// -------------------------------------------------------------
+//
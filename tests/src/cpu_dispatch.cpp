@@ -0,0 +1,152 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/cpu_dispatch.cpp  Tests the runtime selection of instruction-set specific variants of host kernels.
+*   \test Tests the limit on the instruction set via VIENNACL_HOST_MAX_ISA and set_max_cpu_isa(), the reported selections, and concurrent use of the dispatchers.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/linalg/inner_prod.hpp"
+#include "viennacl/linalg/host_based/cpu_dispatch.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+using viennacl::linalg::host_based::cpu_isa;
+using viennacl::linalg::host_based::cpu_dispatcher;
+
+/** @brief Dispatcher with a variant for each instruction set extension, where each variant is the value of the extension itself */
+cpu_dispatcher<int> const & test_dispatcher()
+{
+  static cpu_dispatcher<int> const dispatcher = cpu_dispatcher<int>("test", viennacl::linalg::host_based::cpu_isa_scalar)
+                                                  .add(viennacl::linalg::host_based::cpu_isa_sse42,  viennacl::linalg::host_based::cpu_isa_sse42)
+                                                  .add(viennacl::linalg::host_based::cpu_isa_neon,   viennacl::linalg::host_based::cpu_isa_neon)
+                                                  .add(viennacl::linalg::host_based::cpu_isa_avx2,   viennacl::linalg::host_based::cpu_isa_avx2)
+                                                  .add(viennacl::linalg::host_based::cpu_isa_avx512, viennacl::linalg::host_based::cpu_isa_avx512);
+  return dispatcher;
+}
+
+/** @brief Dispatcher with a variant for the scalar code only */
+cpu_dispatcher<int> const & scalar_dispatcher()
+{
+  static cpu_dispatcher<int> const dispatcher = cpu_dispatcher<int>("scalar_only", viennacl::linalg::host_based::cpu_isa_scalar);
+  return dispatcher;
+}
+
+template<typename NumericT>
+int check_inner_prod(std::size_t size)
+{
+  viennacl::vector<NumericT> x = viennacl::scalar_vector<NumericT>(size, NumericT(0.5));
+  viennacl::vector<NumericT> y = viennacl::scalar_vector<NumericT>(size, NumericT(2));
+  NumericT result = viennacl::linalg::inner_prod(x, y);
+  CHECK(std::fabs(result - NumericT(size)) <= NumericT(1e-4) * NumericT(size), "wrong inner product " << result << " instead of " << size);
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Runtime CPU dispatch for host kernels" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  // the limit from the environment is read on first use of a dispatcher:
+#ifdef _WIN32
+  _putenv_s("VIENNACL_HOST_MAX_ISA", "scalar");
+#else
+  setenv("VIENNACL_HOST_MAX_ISA", "scalar", 1);
+#endif
+
+  std::cout << "Testing the limit from VIENNACL_HOST_MAX_ISA..." << std::endl;
+  CHECK(viennacl::linalg::host_based::detected_cpu_isa() == viennacl::linalg::host_based::cpu_isa_scalar, "VIENNACL_HOST_MAX_ISA=scalar not honored by detected_cpu_isa()");
+  CHECK(test_dispatcher().get() == viennacl::linalg::host_based::cpu_isa_scalar, "VIENNACL_HOST_MAX_ISA=scalar not honored by the dispatcher");
+  if (check_inner_prod<float>(100000) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  CHECK(viennacl::linalg::host_based::dispatched_kernel_isa("inner_prod<float>") == "scalar", "inner_prod<float> reported as " << viennacl::linalg::host_based::dispatched_kernel_isa("inner_prod<float>"));
+
+  std::cout << "Testing set_max_cpu_isa()..." << std::endl;
+  viennacl::linalg::host_based::set_max_cpu_isa(viennacl::linalg::host_based::cpu_isa_count);
+  CHECK(viennacl::linalg::host_based::dispatched_kernel_isas().empty(), "selections not reset when changing the limit");
+
+  cpu_isa best = viennacl::linalg::host_based::detected_cpu_isa();
+  std::cout << "  detected: " << viennacl::linalg::host_based::cpu_isa_name(best) << std::endl;
+  CHECK(test_dispatcher().get() == best, "dispatcher selected " << test_dispatcher().get() << " instead of " << best);
+  CHECK(test_dispatcher().isa() == best, "dispatcher reports " << viennacl::linalg::host_based::cpu_isa_name(test_dispatcher().isa()));
+  CHECK(scalar_dispatcher().get() == viennacl::linalg::host_based::cpu_isa_scalar, "missing variants must fall back to the scalar variant");
+
+  for (int isa = 0; isa < viennacl::linalg::host_based::cpu_isa_count; ++isa)
+  {
+    viennacl::linalg::host_based::set_max_cpu_isa(cpu_isa(isa));
+    cpu_isa expected = viennacl::linalg::host_based::detected_cpu_isa();
+    CHECK(expected <= isa, "detected_cpu_isa() exceeds the limit " << viennacl::linalg::host_based::cpu_isa_name(cpu_isa(isa)));
+    CHECK(test_dispatcher().get() == expected, "dispatcher ignores the limit " << viennacl::linalg::host_based::cpu_isa_name(cpu_isa(isa)));
+    if (check_inner_prod<double>(100000) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << "Testing dispatched_kernel_isas()..." << std::endl;
+  std::map<std::string, cpu_isa> isas = viennacl::linalg::host_based::dispatched_kernel_isas();
+  CHECK(isas.size() == 2 && isas.count("test") == 1 && isas.count("inner_prod<double>") == 1, "wrong set of dispatched kernels reported");
+  CHECK(isas["test"] == test_dispatcher().isa(), "wrong instruction set reported for the test dispatcher");
+  CHECK(viennacl::linalg::host_based::dispatched_kernel_isa("inner_prod<float>").empty(), "unused kernel reported");
+
+  std::cout << "Testing concurrent use while changing the limit..." << std::endl;
+  viennacl::linalg::host_based::set_max_cpu_isa(viennacl::linalg::host_based::cpu_isa_count);
+  long errors = 0;
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for reduction(+: errors)
+#endif
+  for (long i = 0; i < 20000; ++i)
+  {
+    if (i % 100 == 0)
+      viennacl::linalg::host_based::set_max_cpu_isa((i % 200 == 0) ? viennacl::linalg::host_based::cpu_isa_scalar : viennacl::linalg::host_based::cpu_isa_count);
+    int selected = test_dispatcher().get();
+    if (selected != viennacl::linalg::host_based::cpu_isa_scalar && selected != best)
+      ++errors;
+  }
+  CHECK(errors == 0, errors << " invalid selections during concurrent use");
+
+  viennacl::linalg::host_based::set_max_cpu_isa(viennacl::linalg::host_based::cpu_isa_count);
+  CHECK(test_dispatcher().get() == best, "dispatcher not restored after concurrent use");
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
+//
+// -------------------------------------------------------------
+//
@@ -0,0 +1,186 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/cpu_ram_copy.cpp  Tests the transfers of the host backend.
+*   \test Tests memory_create(), memory_write(), memory_read() and memory_copy() of the host backend below and above the thresholds for parallel and streaming copies.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/vector_proxy.hpp"
+#include "viennacl/backend/cpu_ram.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+namespace cpu_ram = viennacl::backend::cpu_ram;
+
+/** @brief Returns 'bytes' bytes of a pattern which does not repeat with a period of a power of two */
+std::vector<char> pattern(std::size_t bytes, unsigned int seed)
+{
+  std::vector<char> result(bytes);
+  for (std::size_t i=0; i<bytes; ++i)
+    result[i] = char((i * 131 + seed) % 251);
+  return result;
+}
+
+/** @brief Returns the position of the first byte differing between the two ranges, or 'bytes' if they are equal */
+std::size_t first_mismatch(char const * a, char const * b, std::size_t bytes)
+{
+  for (std::size_t i=0; i<bytes; ++i)
+    if (a[i] != b[i])
+      return i;
+  return bytes;
+}
+
+/** @brief Tests all transfers of 'bytes' bytes, with the given offsets into the source and destination buffers */
+int test_transfers(std::size_t bytes, std::size_t src_offset, std::size_t dst_offset, cpu_ram::memory_pool * pool)
+{
+  std::vector<char> host_src = pattern(src_offset + bytes, 7);
+  std::vector<char> host_dst(dst_offset + bytes + 1, char(0));
+
+  // creation from host data:
+  cpu_ram::handle_type src = cpu_ram::memory_create(src_offset + bytes, &(host_src[0]), pool);
+  CHECK(first_mismatch(src.get(), &(host_src[0]), src_offset + bytes) == src_offset + bytes, "memory_create() with host data failed for " << bytes << " bytes");
+
+  // creation without host data (first touch), write and read back:
+  cpu_ram::handle_type dst = cpu_ram::memory_create(dst_offset + bytes, NULL, pool);
+  cpu_ram::memory_write(dst, dst_offset, bytes, &(host_src[0]) + src_offset, false);
+  CHECK(first_mismatch(dst.get() + dst_offset, &(host_src[0]) + src_offset, bytes) == bytes, "memory_write() failed for " << bytes << " bytes");
+
+  cpu_ram::memory_read(dst, dst_offset, bytes, &(host_dst[0]) + dst_offset, false);
+  CHECK(first_mismatch(&(host_dst[0]) + dst_offset, &(host_src[0]) + src_offset, bytes) == bytes, "memory_read() failed for " << bytes << " bytes");
+  CHECK(host_dst[dst_offset + bytes] == 0, "memory_read() wrote beyond the end of the destination for " << bytes << " bytes");
+
+  // copy between two buffers:
+  std::vector<char> other = pattern(dst_offset + bytes, 11);
+  cpu_ram::handle_type dst2 = cpu_ram::memory_create(dst_offset + bytes, &(other[0]), pool);
+  cpu_ram::memory_copy(src, dst2, src_offset, dst_offset, bytes);
+  CHECK(first_mismatch(dst2.get() + dst_offset, &(host_src[0]) + src_offset, bytes) == bytes, "memory_copy() failed for " << bytes << " bytes");
+  CHECK(first_mismatch(dst2.get(), &(other[0]), dst_offset) == dst_offset, "memory_copy() wrote before the destination range for " << bytes << " bytes");
+
+  return EXIT_SUCCESS;
+}
+
+/** @brief Tests memory_copy() for overlapping ranges within the same buffer, shifting 'bytes' bytes by 'shift' bytes in both directions */
+int test_overlapping_copy(std::size_t bytes, std::size_t shift)
+{
+  std::vector<char> host = pattern(bytes + shift, 3);
+
+  cpu_ram::handle_type buffer = cpu_ram::memory_create(bytes + shift, &(host[0]));
+  cpu_ram::memory_copy(buffer, buffer, 0, shift, bytes);
+  CHECK(first_mismatch(buffer.get() + shift, &(host[0]), bytes) == bytes, "overlapping memory_copy() to higher addresses failed for " << bytes << " bytes");
+
+  buffer = cpu_ram::memory_create(bytes + shift, &(host[0]));
+  cpu_ram::memory_copy(buffer, buffer, shift, 0, bytes);
+  CHECK(first_mismatch(buffer.get(), &(host[0]) + shift, bytes) == bytes, "overlapping memory_copy() to lower addresses failed for " << bytes << " bytes");
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Transfers of the host backend" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::size_t parallel  = VIENNACL_CPU_RAM_PARALLEL_COPY_THRESHOLD;
+  std::size_t streaming = VIENNACL_CPU_RAM_STREAMING_COPY_THRESHOLD;
+
+  // below and above each threshold, with sizes and offsets which are not multiples of the cache line size:
+  std::size_t sizes[] = { 1, 63, 4097, parallel - 1, parallel, parallel + 77, streaming - 1, streaming, streaming + 4099 };
+  std::size_t offsets[][2] = { {0, 0}, {3, 0}, {0, 5}, {13, 7} };
+
+  cpu_ram::memory_pool pool;
+  for (std::size_t i=0; i<sizeof(sizes) / sizeof(sizes[0]); ++i)
+  {
+    std::cout << "Testing transfers of " << sizes[i] << " bytes..." << std::endl;
+    for (std::size_t j=0; j<sizeof(offsets) / sizeof(offsets[0]); ++j)
+    {
+      if (test_transfers(sizes[i], offsets[j][0], offsets[j][1], NULL) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+      if (test_transfers(sizes[i], offsets[j][0], offsets[j][1], &pool) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+    }
+
+    if (test_overlapping_copy(sizes[i], 1) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (test_overlapping_copy(sizes[i], 4096) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  // strided source: the entries of a slice are picked from the buffer read back as a whole:
+  std::cout << "Testing transfers of a strided vector..." << std::endl;
+  {
+    std::size_t stride = 3;
+    std::size_t N = streaming / sizeof(double) / stride + 1001;   // buffer of the slice above the streaming threshold
+
+    std::vector<double> std_x(stride * N + 2);
+    for (std::size_t i=0; i<std_x.size(); ++i)
+      std_x[i] = double(i);
+
+    viennacl::vector<double> x(std_x.size());
+    viennacl::copy(std_x, x);
+    viennacl::vector_slice<viennacl::vector<double> > x_slice(x, viennacl::slice(2, stride, N));
+
+    std::vector<double> std_slice(N);
+    viennacl::copy(x_slice, std_slice);
+    for (std::size_t i=0; i<N; ++i)
+      CHECK(std_slice[i] == std_x[2 + stride * i], "wrong entry " << i << " when reading a strided vector");
+
+    for (std::size_t i=0; i<N; ++i)
+      std_slice[i] = -std_slice[i];
+    viennacl::copy(std_slice, x_slice);
+
+    std::vector<double> std_x2(std_x.size());
+    viennacl::copy(x, std_x2);
+    for (std::size_t i=0; i<std_x.size(); ++i)
+    {
+      bool in_slice = (i >= 2 && (i - 2) % stride == 0 && (i - 2) / stride < N);
+      CHECK(std_x2[i] == (in_slice ? -std_x[i] : std_x[i]), "wrong entry " << i << " after writing a strided vector");
+    }
+
+    // copy of the strided vector to a contiguous vector within the backend:
+    viennacl::vector<double> y = x_slice;
+    std::vector<double> std_y(N);
+    viennacl::copy(y, std_y);
+    for (std::size_t i=0; i<N; ++i)
+      CHECK(std_y[i] == -std_x[2 + stride * i], "wrong entry " << i << " when copying a strided vector");
+  }
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
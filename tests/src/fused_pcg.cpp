@@ -0,0 +1,194 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/fused_pcg.cpp  Tests the fused conjugate gradient iterations with Jacobi and row scaling preconditioners.
+*   \test Tests the fused conjugate gradient iterations with Jacobi and row scaling preconditioners against the generic preconditioned CG implementation.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/coordinate_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/row_scaling.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+/** @brief Forwards apply() to another preconditioner. Hides the type of the preconditioner, so the generic preconditioned CG implementation is used. */
+template<typename PreconditionerT>
+class forwarding_precond
+{
+public:
+  forwarding_precond(PreconditionerT const & precond) : precond_(precond) {}
+
+  template<typename VectorT>
+  void apply(VectorT & vec) const { precond_.apply(vec); }
+
+private:
+  PreconditionerT const & precond_;
+};
+
+/** @brief Monitor callback counting the number of calls */
+template<typename NumericT>
+bool count_iterations(viennacl::vector<NumericT> const &, NumericT, void * data)
+{
+  ++*static_cast<unsigned int *>(data);
+  return false;
+}
+
+/** @brief Sets up a symmetric positive definite matrix: The five-point finite difference Laplacian on a points x points grid with rows scaled badly. */
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > generate_matrix(std::size_t points)
+{
+  std::size_t n = points * points;
+  std::vector<NumericT> scaling(n);
+  for (std::size_t row = 0; row < n; ++row)
+    scaling[row] = NumericT(1 + (row * 7) % 10);
+
+  std::vector<std::map<unsigned int, NumericT> > A(n);
+  for (std::size_t row = 0; row < n; ++row)
+  {
+    std::size_t i = row % points;
+    std::size_t j = row / points;
+    A[row][static_cast<unsigned int>(row)] = NumericT(4) * scaling[row] * scaling[row];
+    if (i > 0)          A[row][static_cast<unsigned int>(row - 1)]      = -scaling[row] * scaling[row - 1];
+    if (i + 1 < points) A[row][static_cast<unsigned int>(row + 1)]      = -scaling[row] * scaling[row + 1];
+    if (j > 0)          A[row][static_cast<unsigned int>(row - points)] = -scaling[row] * scaling[row - points];
+    if (j + 1 < points) A[row][static_cast<unsigned int>(row + points)] = -scaling[row] * scaling[row + points];
+  }
+  return A;
+}
+
+/** @brief Solves with the fused and the generic implementation and compares iteration counts, residuals, and the number of monitor calls */
+template<typename NumericT, typename MatrixT, typename PreconditionerT>
+int check_solver(MatrixT const & A, viennacl::vector<NumericT> const & b, PreconditionerT const & precond, NumericT tolerance, std::string const & name)
+{
+  viennacl::linalg::cg_tag fused_tag(tolerance, 1000);
+  viennacl::vector<NumericT> fused_result = viennacl::linalg::solve(A, b, fused_tag, precond);
+
+  viennacl::linalg::cg_tag generic_tag(tolerance, 1000);
+  viennacl::vector<NumericT> generic_result = viennacl::linalg::solve(A, b, generic_tag, forwarding_precond<PreconditionerT>(precond));
+
+  viennacl::vector<NumericT> residual = viennacl::linalg::prod(A, fused_result);
+  residual -= b;
+  NumericT relative_residual = viennacl::linalg::norm_2(residual) / viennacl::linalg::norm_2(b);
+  std::cout << "  " << name << ": " << fused_tag.iters() << " iterations (generic: " << generic_tag.iters() << "), relative residual " << relative_residual << std::endl;
+
+  CHECK(fused_tag.iters() < fused_tag.max_iterations(), name << ": fused PCG did not converge");
+  CHECK(relative_residual < NumericT(100) * tolerance, name << ": fused PCG residual too large: " << relative_residual);
+  CHECK(fused_tag.iters() <= generic_tag.iters() + generic_tag.iters() / 10 + 2 && generic_tag.iters() <= fused_tag.iters() + fused_tag.iters() / 10 + 2,
+        name << ": iteration counts of fused and generic PCG differ: " << fused_tag.iters() << " vs. " << generic_tag.iters());
+
+  residual = fused_result - generic_result;
+  CHECK(viennacl::linalg::norm_2(residual) < NumericT(100) * tolerance * viennacl::linalg::norm_2(generic_result), name << ": solutions of fused and generic PCG differ");
+
+  // monitor callback:
+  unsigned int monitor_calls = 0;
+  viennacl::linalg::cg_solver<viennacl::vector<NumericT> > solver(viennacl::linalg::cg_tag(tolerance, 1000));
+  solver.set_monitor(count_iterations<NumericT>, &monitor_calls);
+  solver(A, b, precond);
+  CHECK(monitor_calls == solver.tag().iters(), name << ": wrong number of monitor calls: " << monitor_calls << " vs. " << solver.tag().iters());
+
+  return EXIT_SUCCESS;
+}
+
+template<typename NumericT>
+int test(NumericT tolerance)
+{
+  std::vector<std::map<unsigned int, NumericT> > std_A = generate_matrix<NumericT>(50);
+  std::size_t n = std_A.size();
+
+  viennacl::compressed_matrix<NumericT> A(n, n);
+  viennacl::copy(std_A, A);
+  viennacl::coordinate_matrix<NumericT> A_coo(n, n);
+  viennacl::copy(std_A, A_coo);
+
+  std::vector<NumericT> std_b(n);
+  for (std::size_t i=0; i<n; ++i)
+    std_b[i] = NumericT(1) + NumericT(i % 13) / NumericT(5);
+  viennacl::vector<NumericT> b(n);
+  viennacl::copy(std_b, b);
+
+  viennacl::linalg::jacobi_precond<viennacl::compressed_matrix<NumericT> > jacobi(A, viennacl::linalg::jacobi_tag());
+  if (check_solver(A, b, jacobi, tolerance, "compressed_matrix, Jacobi") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  viennacl::linalg::row_scaling<viennacl::compressed_matrix<NumericT> > row_scaling(A, viennacl::linalg::row_scaling_tag(1));
+  if (check_solver(A, b, row_scaling, tolerance, "compressed_matrix, row scaling") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  viennacl::linalg::jacobi_precond<viennacl::coordinate_matrix<NumericT> > jacobi_coo(A_coo, viennacl::linalg::jacobi_tag());
+  if (check_solver(A_coo, b, jacobi_coo, tolerance, "coordinate_matrix, Jacobi") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  viennacl::linalg::row_scaling<viennacl::coordinate_matrix<NumericT> > row_scaling_coo(A_coo, viennacl::linalg::row_scaling_tag(2));
+  if (check_solver(A_coo, b, row_scaling_coo, tolerance, "coordinate_matrix, row scaling") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  // zero right hand side:
+  viennacl::vector<NumericT> zero = viennacl::zero_vector<NumericT>(n);
+  viennacl::vector<NumericT> result = viennacl::linalg::solve(A, zero, viennacl::linalg::cg_tag(tolerance, 1000), jacobi);
+  CHECK(viennacl::linalg::norm_2(result) <= 0, "nonzero result for zero right hand side");
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Fused preconditioned CG" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: float" << std::endl;
+  if (test<float>(1e-4f) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: double" << std::endl;
+  if (test<double>(1e-10) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,232 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/gemm_packed.cpp  Tests the packed, register-blocked matrix-matrix product of the host backend.
+*   \test Tests the edge tiles of the packed matrix-matrix product (sizes which are not multiples of the register and cache blocking) for all micro-kernels available and all combinations of layouts and transpositions.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/host_based/cpu_dispatch.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+typedef std::vector<std::vector<double> > reference_matrix;
+
+/** @brief Fills the matrix with reproducible values in [-1, 1] and returns them in the reference matrix (in the logical layout of 'mat') */
+template<typename MatrixT>
+reference_matrix fill(MatrixT & mat, unsigned int seed)
+{
+  typedef typename viennacl::result_of::cpu_value_type<typename MatrixT::value_type>::type NumericT;
+
+  reference_matrix ref(mat.size1(), std::vector<double>(mat.size2()));
+  std::vector<std::vector<NumericT> > values(mat.size1(), std::vector<NumericT>(mat.size2()));
+  for (std::size_t i=0; i<mat.size1(); ++i)
+    for (std::size_t j=0; j<mat.size2(); ++j)
+    {
+      seed = seed * 1103515245u + 12345u;
+      values[i][j] = NumericT(int((seed >> 16) % 2001) - 1000) / NumericT(1000);
+      ref[i][j] = double(values[i][j]);
+    }
+  viennacl::copy(values, mat);
+  return ref;
+}
+
+/** @brief Returns the maximum deviation of 'mat' from the reference, relative to the largest entry of the reference */
+template<typename MatrixT>
+double rel_diff(reference_matrix const & ref, MatrixT const & mat)
+{
+  typedef typename viennacl::result_of::cpu_value_type<typename MatrixT::value_type>::type NumericT;
+
+  std::vector<std::vector<NumericT> > values(mat.size1(), std::vector<NumericT>(mat.size2()));
+  viennacl::copy(mat, values);
+
+  double max_ref = 1.0;
+  double max_diff = 0.0;
+  for (std::size_t i=0; i<ref.size(); ++i)
+    for (std::size_t j=0; j<ref[i].size(); ++j)
+    {
+      max_ref  = std::max(max_ref, std::fabs(ref[i][j]));
+      max_diff = std::max(max_diff, std::fabs(ref[i][j] - double(values[i][j])));
+    }
+  return max_diff / max_ref;
+}
+
+/** @brief Computes C = alpha * op(A) * op(B) + beta * C for the reference matrices, where op() is the identity or the transposition */
+void reference_prod(reference_matrix const & A, bool trans_A, reference_matrix const & B, bool trans_B,
+                    reference_matrix & C, double alpha, double beta)
+{
+  std::size_t K = trans_A ? A.size() : A[0].size();
+  for (std::size_t i=0; i<C.size(); ++i)
+    for (std::size_t j=0; j<C[i].size(); ++j)
+    {
+      double temp = 0;
+      for (std::size_t k=0; k<K; ++k)
+        temp += (trans_A ? A[k][i] : A[i][k]) * (trans_B ? B[j][k] : B[k][j]);
+      C[i][j] = alpha * temp + beta * C[i][j];
+    }
+}
+
+/** @brief Tests C = op(A) * op(B), C += op(A) * op(B) and C -= op(A) * op(B) for the M x K matrix op(A) and the K x N matrix op(B) */
+template<typename MatrixA, typename MatrixB, typename MatrixC>
+int test_prod(MatrixA & A, bool trans_A, MatrixB & B, bool trans_B, MatrixC & C, double epsilon)
+{
+  reference_matrix ref_A = fill(A, 1u);
+  reference_matrix ref_B = fill(B, 2u);
+  reference_matrix ref_C = fill(C, 3u);
+
+  std::size_t M = C.size1();
+  std::size_t N = C.size2();
+  std::size_t K = trans_A ? A.size1() : A.size2();
+
+  // C = op(A) * op(B)
+  if (!trans_A && !trans_B) C = viennacl::linalg::prod(A, B);
+  if ( trans_A && !trans_B) C = viennacl::linalg::prod(trans(A), B);
+  if (!trans_A &&  trans_B) C = viennacl::linalg::prod(A, trans(B));
+  if ( trans_A &&  trans_B) C = viennacl::linalg::prod(trans(A), trans(B));
+  reference_prod(ref_A, trans_A, ref_B, trans_B, ref_C, 1.0, 0.0);
+  CHECK(rel_diff(ref_C, C) < epsilon, "wrong result of C = prod(A, B) for " << M << " x " << N << " x " << K << ", trans(A): " << trans_A << ", trans(B): " << trans_B
+                                      << ", error: " << rel_diff(ref_C, C));
+
+  // C += op(A) * op(B)
+  if (!trans_A && !trans_B) C += viennacl::linalg::prod(A, B);
+  if ( trans_A && !trans_B) C += viennacl::linalg::prod(trans(A), B);
+  if (!trans_A &&  trans_B) C += viennacl::linalg::prod(A, trans(B));
+  if ( trans_A &&  trans_B) C += viennacl::linalg::prod(trans(A), trans(B));
+  reference_prod(ref_A, trans_A, ref_B, trans_B, ref_C, 1.0, 1.0);
+  CHECK(rel_diff(ref_C, C) < epsilon, "wrong result of C += prod(A, B) for " << M << " x " << N << " x " << K << ", trans(A): " << trans_A << ", trans(B): " << trans_B
+                                      << ", error: " << rel_diff(ref_C, C));
+
+  // C -= op(A) * op(B)
+  if (!trans_A && !trans_B) C -= viennacl::linalg::prod(A, B);
+  if ( trans_A && !trans_B) C -= viennacl::linalg::prod(trans(A), B);
+  if (!trans_A &&  trans_B) C -= viennacl::linalg::prod(A, trans(B));
+  if ( trans_A &&  trans_B) C -= viennacl::linalg::prod(trans(A), trans(B));
+  reference_prod(ref_A, trans_A, ref_B, trans_B, ref_C, -1.0, 1.0);
+  CHECK(rel_diff(ref_C, C) < epsilon, "wrong result of C -= prod(A, B) for " << M << " x " << N << " x " << K << ", trans(A): " << trans_A << ", trans(B): " << trans_B
+                                      << ", error: " << rel_diff(ref_C, C));
+
+  return EXIT_SUCCESS;
+}
+
+/** @brief Tests all transpositions of the factors for the given layouts */
+template<typename NumericT, typename LayoutA, typename LayoutB, typename LayoutC>
+int test_layouts(std::size_t M, std::size_t N, std::size_t K, double epsilon)
+{
+  for (int trans_A = 0; trans_A < 2; ++trans_A)
+    for (int trans_B = 0; trans_B < 2; ++trans_B)
+    {
+      viennacl::matrix<NumericT, LayoutA> A(trans_A ? K : M, trans_A ? M : K);
+      viennacl::matrix<NumericT, LayoutB> B(trans_B ? N : K, trans_B ? K : N);
+      viennacl::matrix<NumericT, LayoutC> C(M, N);
+      if (test_prod(A, trans_A != 0, B, trans_B != 0, C, epsilon) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+
+template<typename NumericT>
+int test(double epsilon)
+{
+  typedef viennacl::row_major    R;
+  typedef viennacl::column_major C;
+
+  // sizes which are not multiples of the register blocking (MR x NR between 4 x 4 and 6 x 32) and the cache blocking (MC = 144, KC = 256):
+  std::size_t sizes[][3] = { {1, 1, 1}, {1, 37, 3}, {37, 1, 5}, {3, 5, 1}, {5, 7, 9}, {6, 16, 8}, {7, 17, 13}, {13, 33, 29},
+                             {24, 64, 32}, {25, 65, 33}, {150, 41, 17}, {31, 23, 300}, {145, 70, 257} };
+  for (std::size_t i=0; i<sizeof(sizes) / sizeof(sizes[0]); ++i)
+    if (test_layouts<NumericT, R, R, R>(sizes[i][0], sizes[i][1], sizes[i][2], epsilon) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+  // all combinations of layouts:
+  std::size_t M = 23, N = 19, K = 31;
+  if (test_layouts<NumericT, R, R, C>(M, N, K, epsilon) != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_layouts<NumericT, R, C, R>(M, N, K, epsilon) != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_layouts<NumericT, R, C, C>(M, N, K, epsilon) != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_layouts<NumericT, C, R, R>(M, N, K, epsilon) != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_layouts<NumericT, C, R, C>(M, N, K, epsilon) != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_layouts<NumericT, C, C, R>(M, N, K, epsilon) != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_layouts<NumericT, C, C, C>(M, N, K, epsilon) != EXIT_SUCCESS) return EXIT_FAILURE;
+
+  // submatrices with offsets and strides:
+  viennacl::matrix<NumericT, R> A_big(3 * M, 3 * K);
+  viennacl::matrix<NumericT, C> B_big(3 * K, 3 * N);
+  viennacl::matrix<NumericT, R> C_big(3 * M, 3 * N);
+  viennacl::matrix_range<viennacl::matrix<NumericT, R> > A_range(A_big, viennacl::range(5, 5 + M), viennacl::range(3, 3 + K));
+  viennacl::matrix_slice<viennacl::matrix<NumericT, C> > B_slice(B_big, viennacl::slice(1, 2, K), viennacl::slice(2, 3, N));
+  viennacl::matrix_slice<viennacl::matrix<NumericT, R> > C_slice(C_big, viennacl::slice(4, 2, M), viennacl::slice(0, 3, N));
+  if (test_prod(A_range, false, B_slice, false, C_slice, epsilon) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Packed matrix-matrix product (host backend)" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  // run the tests for each micro-kernel available on this CPU:
+  std::vector<int> tested_isas;
+  for (int isa = 0; isa < viennacl::linalg::host_based::cpu_isa_count; ++isa)
+  {
+    viennacl::linalg::host_based::set_max_cpu_isa(viennacl::linalg::host_based::cpu_isa(isa));
+    int detected = viennacl::linalg::host_based::detected_cpu_isa();
+    if (std::find(tested_isas.begin(), tested_isas.end(), detected) != tested_isas.end())
+      continue;
+    tested_isas.push_back(detected);
+
+    std::cout << "# Testing float, instruction set: " << viennacl::linalg::host_based::cpu_isa_name(viennacl::linalg::host_based::cpu_isa(detected)) << std::endl;
+    if (test<float>(1e-4) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    std::cout << "  micro-kernel: " << viennacl::linalg::host_based::dispatched_kernel_isa("gemm<float>") << std::endl;
+
+    std::cout << "# Testing double, instruction set: " << viennacl::linalg::host_based::cpu_isa_name(viennacl::linalg::host_based::cpu_isa(detected)) << std::endl;
+    if (test<double>(1e-12) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    std::cout << "  micro-kernel: " << viennacl::linalg::host_based::dispatched_kernel_isa("gemm<double>") << std::endl;
+  }
+  viennacl::linalg::host_based::set_max_cpu_isa(viennacl::linalg::host_based::cpu_isa_count);
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
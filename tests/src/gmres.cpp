@@ -0,0 +1,173 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/gmres.cpp  Tests the residual estimate and the stopping criterion of the preconditioned GMRES.
+*   \test Tests that the preconditioned GMRES stops at the requested residual reduction and reports a residual estimate matching the true residual, also in single precision and for scaled systems.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <string>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/gmres.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/row_scaling.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+/** @brief Sets up the five-point finite difference Laplacian on a points x points grid plus a strongly varying diagonal, multiplied by 'scaling' */
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > generate_matrix(std::size_t points, NumericT scaling)
+{
+  std::size_t n = points * points;
+  std::vector<std::map<unsigned int, NumericT> > A(n);
+  for (std::size_t row = 0; row < n; ++row)
+  {
+    std::size_t i = row % points;
+    std::size_t j = row / points;
+    A[row][static_cast<unsigned int>(row)] = scaling * NumericT(4 + 2 * (1 + row % 7));
+    if (i > 0)          A[row][static_cast<unsigned int>(row - 1)]      = -scaling;
+    if (i + 1 < points) A[row][static_cast<unsigned int>(row + 1)]      = -scaling;
+    if (j > 0)          A[row][static_cast<unsigned int>(row - points)] = -scaling;
+    if (j + 1 < points) A[row][static_cast<unsigned int>(row + points)] = -scaling;
+  }
+  return A;
+}
+
+/** @brief Solves with the preconditioned GMRES, then checks the true preconditioned residual against the tolerance and against the residual estimate of the solver */
+template<typename NumericT, typename MatrixT, typename PreconditionerT>
+int check_solver(MatrixT const & A, viennacl::vector<NumericT> const & b, viennacl::linalg::gmres_tag const & tag, PreconditionerT const & precond, std::string const & name)
+{
+  viennacl::vector<NumericT> x = viennacl::linalg::solve(A, b, tag, precond);
+
+  viennacl::vector<NumericT> r = viennacl::linalg::prod(A, x);
+  r = b - r;
+  precond.apply(r);
+  viennacl::vector<NumericT> precond_b(b);
+  precond.apply(precond_b);
+  double true_residual = double(viennacl::linalg::norm_2(r)) / double(viennacl::linalg::norm_2(precond_b));
+
+  std::cout << "  " << name << ": " << tag.iters() << " iterations, estimated residual " << tag.error() << ", true residual " << true_residual << std::endl;
+  CHECK(tag.iters() < tag.max_iterations(), name << " did not converge");
+  CHECK(true_residual < 10.0 * tag.tolerance(), name << " stopped at a true residual of " << true_residual);
+  CHECK(tag.error() > 0 && true_residual < 10.0 * tag.error(), name << " reported residual " << tag.error() << " for a true residual of " << true_residual);
+
+  return EXIT_SUCCESS;
+}
+
+template<typename NumericT>
+int test(NumericT tolerance)
+{
+  std::size_t points = 30;
+  viennacl::vector<NumericT> b = viennacl::scalar_vector<NumericT>(points * points, NumericT(1));
+
+  //
+  // The residual estimate must follow the true residual in single precision, where the quick convergence with a Jacobi preconditioner leads to cancellation in simple recurrences for the residual norm:
+  //
+  std::vector<std::map<unsigned int, NumericT> > std_A = generate_matrix<NumericT>(points, NumericT(1));
+  viennacl::compressed_matrix<NumericT> A;
+  viennacl::copy(std_A, A);
+  viennacl::linalg::jacobi_precond<viennacl::compressed_matrix<NumericT> > jacobi(A, viennacl::linalg::jacobi_tag());
+
+  viennacl::linalg::gmres_tag tag(tolerance, 1000, 30);
+  if (check_solver(A, b, tag, jacobi, "compressed_matrix, Jacobi") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  unsigned int unscaled_iterations = tag.iters();
+
+  if (check_solver(A, b, viennacl::linalg::gmres_tag(tolerance, 1000, 5), jacobi, "compressed_matrix, Jacobi, restarts") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  viennacl::linalg::row_scaling<viennacl::compressed_matrix<NumericT> > row_scaling(A, viennacl::linalg::row_scaling_tag());
+  if (check_solver(A, b, viennacl::linalg::gmres_tag(tolerance, 1000, 30), row_scaling, "compressed_matrix, row scaling") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  //
+  // The tolerance refers to the preconditioned right hand side, hence scaling the system does not change the accuracy of the solution:
+  //
+  viennacl::compressed_matrix<NumericT> A_scaled;
+  viennacl::copy(generate_matrix<NumericT>(points, NumericT(1000)), A_scaled);
+  viennacl::linalg::jacobi_precond<viennacl::compressed_matrix<NumericT> > jacobi_scaled(A_scaled, viennacl::linalg::jacobi_tag());
+  if (check_solver(A_scaled, b, tag, jacobi_scaled, "compressed_matrix scaled by 1000, Jacobi") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  CHECK(tag.iters() == unscaled_iterations, "scaling the system changed the number of iterations from " << unscaled_iterations << " to " << tag.iters());
+
+  //
+  // The absolute tolerance refers to the preconditioned right hand side as well, hence no iterations are needed if ||M^{-1}b|| is below it (while ||b|| is not):
+  //
+  viennacl::vector<NumericT> precond_b(b);
+  jacobi_scaled.apply(precond_b);
+  viennacl::linalg::gmres_tag abs_tag(tolerance, 1000, 30);
+  abs_tag.abs_tolerance(2.0 * double(viennacl::linalg::norm_2(precond_b)));
+  CHECK(double(viennacl::linalg::norm_2(b)) > abs_tag.abs_tolerance(), "right hand side too small for testing the absolute tolerance");
+
+  viennacl::vector<NumericT> x = viennacl::linalg::solve(A_scaled, b, abs_tag, jacobi_scaled);
+  CHECK(abs_tag.iters() == 0 && viennacl::linalg::norm_2(x) <= 0, "solver iterated although the preconditioned right hand side is below the absolute tolerance");
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Preconditioned GMRES" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: float" << std::endl;
+  if (test<float>(1e-5f) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+#ifdef VIENNACL_WITH_OPENCL
+  if ( viennacl::ocl::current_device().double_support() )
+#endif
+  {
+    std::cout << "# Testing setup:" << std::endl;
+    std::cout << "  numeric: double" << std::endl;
+    if (test<double>(1e-10) != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
+//
+// -------------------------------------------------------------
+//
@@ -0,0 +1,121 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/host_memory_pool.cpp  Tests the memory pool for buffers in main RAM.
+*   \test Tests the memory pool for buffers in main RAM.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Memory pool for buffers in main RAM" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::size_t N = 1000;
+
+  viennacl::backend::cpu_ram::memory_pool pool;
+  viennacl::context ctx(pool);
+
+  std::cout << "Testing allocation and reuse of buffers..." << std::endl;
+  {
+    std::vector<double> std_x(N), std_y(N);
+    for (std::size_t i=0; i<N; ++i)
+    {
+      std_x[i] = double(i) / double(N);
+      std_y[i] = 1.0 - double(i) / double(N);
+    }
+
+    viennacl::vector<double> x(N, ctx);
+    viennacl::vector<double> y(N, ctx);
+    viennacl::copy(std_x, x);
+    viennacl::copy(std_y, y);
+    CHECK(pool.statistics().allocations == 2, "vectors not obtained from the pool");
+
+    // temporaries derived from pooled objects are obtained from the pool as well:
+    viennacl::vector<double> z = x + y;
+    CHECK(pool.statistics().allocations == 3, "temporary not obtained from the pool");
+    CHECK(viennacl::traits::context(z).host_memory_pool() == &pool, "context of temporary does not refer to the pool");
+
+    for (std::size_t i=0; i<N; ++i)
+      CHECK(std::fabs(z[i] - 1.0) < 1e-12, "wrong result of vector addition");
+
+    viennacl::matrix<double> A(N, N / 10, ctx);
+    A = viennacl::scalar_matrix<double>(N, N / 10, 1.0, ctx);
+    viennacl::vector<double> Atx = viennacl::linalg::prod(viennacl::trans(A), x);
+    double sum_x = 0;
+    for (std::size_t i=0; i<N; ++i)
+      sum_x += std_x[i];
+    CHECK(std::fabs(Atx[0] - sum_x) < 1e-10, "wrong result of matrix-vector product");
+  }
+
+  viennacl::backend::cpu_ram::memory_pool_statistics stats = pool.statistics();
+  CHECK(stats.bytes_in_use == 0, "buffers still in use: " << stats.bytes_in_use);
+  CHECK(stats.bytes_cached > 0, "no buffers cached");
+
+  {
+    std::size_t hits = stats.cache_hits;
+    viennacl::vector<double> x(N, ctx);
+    x = viennacl::scalar_vector<double>(N, 2.0, ctx);
+    CHECK(pool.statistics().cache_hits > hits, "cached buffer not reused");
+    CHECK(std::fabs(x[N-1] - 2.0) < 1e-12, "wrong entry in reused buffer");
+  }
+
+  std::cout << "Testing high-water mark and trim..." << std::endl;
+  pool.high_water_mark(sizeof(double) * N);
+  CHECK(pool.statistics().bytes_cached <= sizeof(double) * N, "high-water mark exceeded");
+  {
+    viennacl::vector<double> large(10 * N, ctx);
+  }
+  CHECK(pool.statistics().bytes_cached <= sizeof(double) * N, "buffer above high-water mark cached");
+
+  pool.trim();
+  CHECK(pool.statistics().bytes_cached == 0, "trim() did not release idle buffers");
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
+//
+// -------------------------------------------------------------
+//
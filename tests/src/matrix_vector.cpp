@@ -284,6 +284,40 @@ int test_prod_rank1(Epsilon const & epsilon,
       std::cout << "  diff: " << std::fabs(diff(std_v2, vcl_v2)) << std::endl;
       retval = EXIT_FAILURE;
    }
+
+   std::cout << "Matrix-Vector product with inplace-sub" << std::endl;
+   for (std::size_t i=0; i<std_m1.size(); ++i)
+   {
+     NumericT tmp = 0;
+     for (std::size_t j=0; j<std_m1[i].size(); ++j)
+       tmp += std_m1[i][j] * std_v2[j];
+     std_v1[i] -= tmp;
+   }
+   vcl_v1  -= viennacl::linalg::prod(vcl_m1, vcl_v2);
+
+   if ( std::fabs(diff(std_v1, vcl_v1)) > epsilon )
+   {
+      std::cout << "# Error at operation: matrix-vector product with inplace-sub" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(std_v1, vcl_v1)) << std::endl;
+      retval = EXIT_FAILURE;
+   }
+
+   std::cout << "Transposed Matrix-Vector product with inplace-add" << std::endl;
+   for (std::size_t i=0; i<std_m1[0].size(); ++i)
+   {
+     NumericT tmp = 0;
+     for (std::size_t j=0; j<std_m1.size(); ++j)
+       tmp += std_m1[j][i] * std_v1[j];
+     std_v2[i] += tmp;
+   }
+   vcl_v2  += viennacl::linalg::prod(trans(vcl_m1), vcl_v1);
+
+   if ( std::fabs(diff(std_v2, vcl_v2)) > epsilon )
+   {
+      std::cout << "# Error at operation: transposed matrix-vector product with inplace-add" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(std_v2, vcl_v2)) << std::endl;
+      retval = EXIT_FAILURE;
+   }
    // --------------------------------------------------------------------------
 
    std::cout << "Row sum with matrix" << std::endl;
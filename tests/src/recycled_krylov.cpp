@@ -0,0 +1,220 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/recycled_krylov.cpp  Tests the flexible GMRES solver and the GCRO-DR solver with subspace recycling.
+*   \test Tests FGMRES with a variable preconditioner (inner GMRES iterations) and GCRO-DR for a sequence of slowly varying systems.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <string>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/gmres.hpp"
+#include "viennacl/linalg/fgmres.hpp"
+#include "viennacl/linalg/gcrodr.hpp"
+#include "viennacl/linalg/ilu.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+/** @brief A variable preconditioner: A few iterations of an inner GMRES solver (with ILU0), so the preconditioner changes from one application to the next */
+template<typename MatrixT, typename InnerPreconditionerT>
+class inner_gmres_precond
+{
+public:
+  inner_gmres_precond(MatrixT const & A, InnerPreconditionerT const & inner_precond) : A_(A), inner_precond_(inner_precond) {}
+
+  template<typename VectorT>
+  void apply(VectorT & vec) const
+  {
+    vec = viennacl::linalg::solve(A_, vec, viennacl::linalg::gmres_tag(1e-2, 3, 3), inner_precond_);
+  }
+
+private:
+  MatrixT const & A_;
+  InnerPreconditionerT const & inner_precond_;
+};
+
+/** @brief Sets up a sparse matrix: The five-point finite difference Laplacian on a points x points grid with a convection term in x-direction, plus a diagonal shift */
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > generate_matrix(std::size_t points, NumericT convection, NumericT shift)
+{
+  std::size_t n = points * points;
+  std::vector<std::map<unsigned int, NumericT> > A(n);
+  for (std::size_t row = 0; row < n; ++row)
+  {
+    std::size_t i = row % points;
+    std::size_t j = row / points;
+    A[row][static_cast<unsigned int>(row)] = NumericT(4) + shift;
+    if (i > 0)          A[row][static_cast<unsigned int>(row - 1)]      = NumericT(-1) - convection;
+    if (i + 1 < points) A[row][static_cast<unsigned int>(row + 1)]      = NumericT(-1) + convection;
+    if (j > 0)          A[row][static_cast<unsigned int>(row - points)] = NumericT(-1);
+    if (j + 1 < points) A[row][static_cast<unsigned int>(row + points)] = NumericT(-1);
+  }
+  return A;
+}
+
+template<typename NumericT, typename MatrixT>
+NumericT relative_residual(MatrixT const & A, viennacl::vector<NumericT> const & x, viennacl::vector<NumericT> const & b)
+{
+  viennacl::vector<NumericT> residual = viennacl::linalg::prod(A, x);
+  residual -= b;
+  return viennacl::linalg::norm_2(residual) / viennacl::linalg::norm_2(b);
+}
+
+template<typename NumericT>
+int test(NumericT tolerance)
+{
+  std::size_t points = 40;
+  std::size_t n = points * points;
+
+  std::vector<std::map<unsigned int, NumericT> > std_A = generate_matrix<NumericT>(points, NumericT(0.3), NumericT(0));
+  viennacl::compressed_matrix<NumericT> A(n, n);
+  viennacl::copy(std_A, A);
+
+  std::vector<NumericT> std_b(n);
+  for (std::size_t i=0; i<n; ++i)
+    std_b[i] = NumericT(1) + NumericT((i * 7) % 17) / NumericT(7);
+  viennacl::vector<NumericT> b(n);
+  viennacl::copy(std_b, b);
+
+  //
+  // FGMRES without preconditioner agrees with GMRES:
+  //
+  viennacl::linalg::fgmres_tag fgmres_tag(tolerance, 2000, 30);
+  viennacl::vector<NumericT> x = viennacl::linalg::solve(A, b, fgmres_tag);
+  NumericT residual = relative_residual(A, x, b);
+  std::cout << "  FGMRES: " << fgmres_tag.iters() << " iterations, relative residual " << residual << std::endl;
+  CHECK(residual < NumericT(10) * tolerance && fgmres_tag.error() < tolerance, "FGMRES: no convergence, residual " << residual);
+  unsigned int fgmres_iterations = fgmres_tag.iters();
+
+  viennacl::linalg::gmres_tag gmres_tag(tolerance, 2000, 30);
+  viennacl::vector<NumericT> x_gmres = viennacl::linalg::solve(A, b, gmres_tag);
+  x_gmres -= x;
+  CHECK(viennacl::linalg::norm_2(x_gmres) < NumericT(1000) * tolerance * viennacl::linalg::norm_2(x), "FGMRES and GMRES solutions differ");
+
+  //
+  // FGMRES with a variable preconditioner:
+  //
+  viennacl::linalg::ilu0_precond<viennacl::compressed_matrix<NumericT> > ilu0(A, viennacl::linalg::ilu0_tag());
+  inner_gmres_precond<viennacl::compressed_matrix<NumericT>, viennacl::linalg::ilu0_precond<viennacl::compressed_matrix<NumericT> > > inner_gmres(A, ilu0);
+  x = viennacl::linalg::solve(A, b, fgmres_tag, inner_gmres);
+  residual = relative_residual(A, x, b);
+  std::cout << "  FGMRES, inner GMRES: " << fgmres_tag.iters() << " iterations, relative residual " << residual << std::endl;
+  CHECK(residual < NumericT(10) * tolerance && fgmres_tag.error() < tolerance, "FGMRES with inner GMRES: no convergence, residual " << residual);
+  CHECK(fgmres_tag.iters() < fgmres_iterations / 4, "FGMRES with inner GMRES: too many iterations");
+
+  //
+  // GCRO-DR for a single system:
+  //
+  viennacl::linalg::gcrodr_tag gcrodr_tag(tolerance, 2000, 30, 10);
+  x = viennacl::linalg::solve(A, b, gcrodr_tag);
+  residual = relative_residual(A, x, b);
+  std::cout << "  GCRO-DR: " << gcrodr_tag.iters() << " iterations, relative residual " << residual << std::endl;
+  CHECK(residual < NumericT(10) * tolerance && gcrodr_tag.error() < tolerance, "GCRO-DR: no convergence, residual " << residual);
+  CHECK(gcrodr_tag.iters() <= fgmres_iterations, "GCRO-DR: more iterations than FGMRES with the same search space dimension");
+
+  //
+  // GCRO-DR for a sequence of slowly varying systems, with and without preconditioner:
+  //
+  for (unsigned int with_precond = 0; with_precond < 2; ++with_precond)
+  {
+    viennacl::linalg::gcrodr_solver<viennacl::vector<NumericT> > solver(gcrodr_tag);
+    CHECK(solver.recycled_dim() == 0, "GCRO-DR: recycled subspace before first solve");
+
+    unsigned int first_iterations = 0;
+    for (std::size_t system = 0; system < 5; ++system)
+    {
+      std::vector<std::map<unsigned int, NumericT> > std_A_i = generate_matrix<NumericT>(points, NumericT(0.3), NumericT(system) / NumericT(100));
+      viennacl::compressed_matrix<NumericT> A_i(n, n);
+      viennacl::copy(std_A_i, A_i);
+      std::vector<NumericT> std_b_i(std_b);
+      for (std::size_t i=0; i<n; ++i)
+        std_b_i[i] += NumericT(system) * NumericT(i % 5) / NumericT(10);
+      viennacl::vector<NumericT> b_i(n);
+      viennacl::copy(std_b_i, b_i);
+
+      viennacl::linalg::ilu0_precond<viennacl::compressed_matrix<NumericT> > ilu0_i(A_i, viennacl::linalg::ilu0_tag());
+      x = with_precond ? solver(A_i, b_i, ilu0_i) : solver(A_i, b_i);
+      residual = relative_residual(A_i, x, b_i);
+      std::cout << "  GCRO-DR" << (with_precond ? ", ILU0" : "") << ", system " << system << ": " << solver.tag().iters() << " iterations, relative residual " << residual << std::endl;
+      CHECK(residual < NumericT(10) * tolerance && solver.tag().error() < tolerance, "GCRO-DR: no convergence for system " << system << ", residual " << residual);
+      CHECK(solver.recycled_dim() == gcrodr_tag.recycle_dim(), "GCRO-DR: wrong dimension of recycled subspace: " << solver.recycled_dim());
+
+      if (system == 0)
+        first_iterations = solver.tag().iters();
+      else
+        CHECK(solver.tag().iters() < first_iterations, "GCRO-DR: no savings from the recycled subspace for system " << system);
+    }
+
+    solver.clear_recycled_subspace();
+    CHECK(solver.recycled_dim() == 0, "GCRO-DR: recycled subspace not cleared");
+  }
+
+  // zero right hand side:
+  viennacl::vector<NumericT> zero = viennacl::zero_vector<NumericT>(n);
+  x = viennacl::linalg::solve(A, zero, gcrodr_tag);
+  CHECK(gcrodr_tag.iters() == 0 && viennacl::linalg::norm_2(x) <= 0, "GCRO-DR: nonzero result for zero right hand side");
+  x = viennacl::linalg::solve(A, zero, fgmres_tag);
+  CHECK(fgmres_tag.iters() == 0 && viennacl::linalg::norm_2(x) <= 0, "FGMRES: nonzero result for zero right hand side");
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: FGMRES and GCRO-DR" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: float" << std::endl;
+  if (test<float>(1e-4f) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: double" << std::endl;
+  if (test<double>(1e-10) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
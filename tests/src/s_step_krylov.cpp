@@ -0,0 +1,216 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/s_step_krylov.cpp  Tests the s-step (communication-avoiding) variants of CG and GMRES.
+*   \test Tests the s-step variants of CG and GMRES for several values of s against the standard implementations (s = 1).
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <string>
+#include <sstream>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/coordinate_matrix.hpp"
+#include "viennacl/ell_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/gmres.hpp"
+#include "viennacl/linalg/ilu.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+/** @brief Monitor callback counting the number of calls */
+template<typename NumericT>
+bool count_calls(viennacl::vector<NumericT> const &, NumericT, void * data)
+{
+  ++*static_cast<unsigned int *>(data);
+  return false;
+}
+
+/** @brief Sets up a sparse matrix: The five-point finite difference Laplacian on a points x points grid with a convection term in x-direction (symmetric if convection is zero). */
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > generate_matrix(std::size_t points, NumericT convection)
+{
+  std::size_t n = points * points;
+  std::vector<std::map<unsigned int, NumericT> > A(n);
+  for (std::size_t row = 0; row < n; ++row)
+  {
+    std::size_t i = row % points;
+    std::size_t j = row / points;
+    A[row][static_cast<unsigned int>(row)] = NumericT(4 + row % 3);
+    if (i > 0)          A[row][static_cast<unsigned int>(row - 1)]      = NumericT(-1) - convection;
+    if (i + 1 < points) A[row][static_cast<unsigned int>(row + 1)]      = NumericT(-1) + convection;
+    if (j > 0)          A[row][static_cast<unsigned int>(row - points)] = NumericT(-1);
+    if (j + 1 < points) A[row][static_cast<unsigned int>(row + points)] = NumericT(-1);
+  }
+  return A;
+}
+
+/** @brief Solves with the s-step variant and the standard method (s = 1), then compares residuals, solutions, and iteration counts */
+template<typename NumericT, typename MatrixT, typename TagT, typename PreconditionerT>
+int check_solver(MatrixT const & A, viennacl::vector<NumericT> const & b, TagT const & tag, unsigned int s, PreconditionerT const & precond, NumericT tolerance, std::string const & name)
+{
+  TagT standard_tag(tag);
+  viennacl::vector<NumericT> standard_result = viennacl::linalg::solve(A, b, standard_tag, precond);
+
+  TagT s_step_tag(tag);
+  s_step_tag.s(s);
+  viennacl::vector<NumericT> s_step_result = viennacl::linalg::solve(A, b, s_step_tag, precond);
+
+  viennacl::vector<NumericT> residual = viennacl::linalg::prod(A, s_step_result);
+  residual -= b;
+  NumericT relative_residual = viennacl::linalg::norm_2(residual) / viennacl::linalg::norm_2(b);
+  std::cout << "  " << name << ", s = " << s << ": " << s_step_tag.iters() << " iterations (s = 1: " << standard_tag.iters() << "), relative residual " << relative_residual << std::endl;
+
+  CHECK(s_step_tag.iters() < tag.max_iterations(), name << ", s = " << s << ": no convergence");
+  CHECK(s_step_tag.error() < tolerance, name << ", s = " << s << ": error estimate too large: " << s_step_tag.error());
+  CHECK(relative_residual < NumericT(100) * tolerance, name << ", s = " << s << ": residual too large: " << relative_residual);
+  CHECK(s_step_tag.iters() <= standard_tag.iters() + standard_tag.iters() / 5 + 2 * s, name << ", s = " << s << ": too many iterations: " << s_step_tag.iters() << " vs. " << standard_tag.iters());
+
+  residual = s_step_result - standard_result;
+  CHECK(viennacl::linalg::norm_2(residual) < NumericT(1000) * tolerance * viennacl::linalg::norm_2(standard_result), name << ", s = " << s << ": solutions differ");
+
+  return EXIT_SUCCESS;
+}
+
+template<typename NumericT>
+int test(NumericT tolerance, unsigned int max_s)
+{
+  std::size_t points = 40;
+  std::size_t n = points * points;
+
+  std::vector<std::map<unsigned int, NumericT> > std_A = generate_matrix<NumericT>(points, NumericT(0));
+  viennacl::compressed_matrix<NumericT> A(n, n);
+  viennacl::copy(std_A, A);
+  viennacl::coordinate_matrix<NumericT> A_coo(n, n);
+  viennacl::copy(std_A, A_coo);
+  viennacl::ell_matrix<NumericT> A_ell;
+  viennacl::copy(std_A, A_ell);
+
+  std::vector<std::map<unsigned int, NumericT> > std_A_nonsym = generate_matrix<NumericT>(points, NumericT(0.4));
+  viennacl::compressed_matrix<NumericT> A_nonsym(n, n);
+  viennacl::copy(std_A_nonsym, A_nonsym);
+
+  std::vector<NumericT> std_b(n);
+  for (std::size_t i=0; i<n; ++i)
+    std_b[i] = NumericT(1) + NumericT((i * 7) % 17) / NumericT(7);
+  viennacl::vector<NumericT> b(n);
+  viennacl::copy(std_b, b);
+
+  viennacl::linalg::cg_tag cg_tag(tolerance, 1000);
+  viennacl::linalg::gmres_tag gmres_tag(tolerance, 1000, 30);
+  viennacl::linalg::ilu0_precond<viennacl::compressed_matrix<NumericT> > ilu0(A_nonsym, viennacl::linalg::ilu0_tag());
+
+  for (unsigned int s = 2; s <= max_s; s *= 2)
+  {
+    //
+    // s-step CG:
+    //
+    if (check_solver(A, b, cg_tag, s, viennacl::linalg::no_precond(), tolerance, "CG, compressed_matrix") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (check_solver(A_coo, b, cg_tag, s, viennacl::linalg::no_precond(), tolerance, "CG, coordinate_matrix") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (check_solver(A_ell, b, cg_tag, s, viennacl::linalg::no_precond(), tolerance, "CG, ell_matrix") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+
+    //
+    // s-step GMRES:
+    //
+    if (check_solver(A_nonsym, b, gmres_tag, s, viennacl::linalg::no_precond(), tolerance, "GMRES, compressed_matrix") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+    if (check_solver(A_nonsym, b, gmres_tag, s, ilu0, tolerance, "GMRES, ILU0") != EXIT_SUCCESS)
+      return EXIT_FAILURE;
+  }
+
+  // s does not divide the Krylov dimension:
+  viennacl::linalg::gmres_tag odd_gmres_tag(tolerance, 1000, 25);
+  if (check_solver(A_nonsym, b, odd_gmres_tag, 3, viennacl::linalg::no_precond(), tolerance, "GMRES, Krylov dimension 25") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  // monitor is called once per outer iteration of CG:
+  unsigned int monitor_calls = 0;
+  viennacl::linalg::cg_tag monitored_cg_tag(tolerance, 1000);
+  monitored_cg_tag.s(4);
+  viennacl::linalg::cg_solver<viennacl::vector<NumericT> > solver(monitored_cg_tag);
+  solver.set_monitor(count_calls<NumericT>, &monitor_calls);
+  solver(A, b);
+  CHECK(monitor_calls == (solver.tag().iters() + 3) / 4, "CG: wrong number of monitor calls: " << monitor_calls << " for " << solver.tag().iters() << " iterations");
+
+  // not enough iterations:
+  viennacl::linalg::cg_tag short_cg_tag(tolerance, 6);
+  short_cg_tag.s(4);
+  viennacl::vector<NumericT> x = viennacl::linalg::solve(A, b, short_cg_tag);
+  CHECK(short_cg_tag.iters() == 6 && short_cg_tag.error() > tolerance, "CG: wrong iteration count or error estimate if not converged");
+
+  viennacl::linalg::gmres_tag short_gmres_tag(tolerance, 6, 30);
+  short_gmres_tag.s(4);
+  x = viennacl::linalg::solve(A_nonsym, b, short_gmres_tag);
+  CHECK(short_gmres_tag.iters() <= 8 && short_gmres_tag.error() > tolerance, "GMRES: wrong iteration count or error estimate if not converged");
+
+  // zero right hand side:
+  viennacl::vector<NumericT> zero = viennacl::zero_vector<NumericT>(n);
+  x = viennacl::linalg::solve(A, zero, short_cg_tag);
+  CHECK(short_cg_tag.iters() == 0 && viennacl::linalg::norm_2(x) <= 0, "CG: nonzero result for zero right hand side");
+  x = viennacl::linalg::solve(A_nonsym, zero, short_gmres_tag);
+  CHECK(short_gmres_tag.iters() == 0 && viennacl::linalg::norm_2(x) <= 0, "GMRES: nonzero result for zero right hand side");
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: s-step Krylov solvers" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: float" << std::endl;
+  if (test<float>(1e-4f, 4) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: double" << std::endl;
+  if (test<double>(1e-10, 8) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
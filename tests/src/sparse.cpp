@@ -425,6 +425,154 @@ int test(Epsilon const& epsilon)
     return EXIT_FAILURE;
   }
 
+  std::cout << "Testing products: compressed_matrix with dense rows" << std::endl;
+  {
+    // a few rows holding a large fraction of the nonzeros (as in power-law matrices) challenge the load balancing:
+    std::vector<std::map<unsigned int, NumericT> > std_matrix_dense_rows(std_matrix);
+    for (std::size_t i=0; i<std_matrix_dense_rows.size(); i += 3)
+    {
+      std_matrix_dense_rows[0][static_cast<unsigned int>(i)] = NumericT(0.25);
+      std_matrix_dense_rows[std_matrix_dense_rows.size() / 2][static_cast<unsigned int>(i)] = NumericT(-0.5);
+    }
+    viennacl::compressed_matrix<NumericT> vcl_compressed_matrix_dense_rows;
+    viennacl::copy(std_matrix_dense_rows, vcl_compressed_matrix_dense_rows);
+
+    result = viennacl::linalg::prod(std_matrix_dense_rows, rhs);
+    vcl_result = viennacl::linalg::prod(vcl_compressed_matrix_dense_rows, vcl_rhs);
+
+    if ( std::fabs(diff(result, vcl_result)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with compressed_matrix with dense rows" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Testing products: compressed_matrix read directly from file" << std::endl;
+  {
+    std::vector<std::map<unsigned int, NumericT> > std_matrix_from_file;
+    viennacl::compressed_matrix<NumericT> vcl_compressed_matrix_from_file;
+    if (!viennacl::io::read_matrix_market_file(std_matrix_from_file, "../examples/testdata/mat65k.mtx")
+        || !viennacl::io::read_matrix_market_file(vcl_compressed_matrix_from_file, "../examples/testdata/mat65k.mtx"))
+    {
+      std::cout << "Error reading Matrix file" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    if (vcl_compressed_matrix_from_file.size1() != std_matrix_from_file.size() || vcl_compressed_matrix_from_file.size2() != std_matrix_from_file.size())
+    {
+      std::cout << "# Error at operation: reading compressed_matrix from file (wrong size)" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    result = viennacl::linalg::prod(std_matrix_from_file, rhs);
+    vcl_result = viennacl::linalg::prod(vcl_compressed_matrix_from_file, vcl_rhs);
+
+    if ( std::fabs(diff(result, vcl_result)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with compressed_matrix read from file" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Testing products: compressed_matrix assembled from triplets" << std::endl;
+  {
+    // every entry is split into two halves, triplets are emitted in reverse order:
+    std::vector<unsigned int> row_indices, col_indices;
+    std::vector<NumericT> values;
+    for (std::size_t i2=std_matrix.size(); i2 > 0; --i2)
+      for (typename std::map<unsigned int, NumericT>::const_iterator it = std_matrix[i2-1].begin(); it != std_matrix[i2-1].end(); ++it)
+        for (std::size_t k=0; k<2; ++k)
+        {
+          row_indices.push_back(static_cast<unsigned int>(i2-1));
+          col_indices.push_back(it->first);
+          values.push_back(it->second / NumericT(2));
+        }
+
+    viennacl::compressed_matrix<NumericT> vcl_compressed_matrix_from_triplets;
+    vcl_compressed_matrix_from_triplets.set_from_triplets(std_matrix.size(), std_matrix.size(), row_indices, col_indices, values);
+
+    if (vcl_compressed_matrix_from_triplets.nnz() != vcl_compressed_matrix.nnz())
+    {
+      std::cout << "# Error at operation: assembly of compressed_matrix from triplets (duplicates not merged)" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    result = viennacl::linalg::prod(std_matrix, rhs);
+    vcl_result = viennacl::linalg::prod(vcl_compressed_matrix_from_triplets, vcl_rhs);
+
+    if ( std::fabs(diff(result, vcl_result)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with compressed_matrix assembled from triplets" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // without summation, the last occurrence of an entry determines its value:
+    for (std::size_t i=0; i<values.size(); i += 2)
+      values[i+1] *= NumericT(2);
+    vcl_compressed_matrix_from_triplets.set_from_triplets(std_matrix.size(), std_matrix.size(), row_indices, col_indices, values, false);
+    vcl_result = viennacl::linalg::prod(vcl_compressed_matrix_from_triplets, vcl_rhs);
+
+    if ( std::fabs(diff(result, vcl_result)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with compressed_matrix assembled from triplets (last value wins)" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Testing products: transposed compressed_matrix" << std::endl;
+  {
+    std::vector<std::map<unsigned int, NumericT> > std_matrix_trans(std_matrix.size());
+    for (std::size_t i2=0; i2 < std_matrix.size(); ++i2)
+      for (typename std::map<unsigned int, NumericT>::const_iterator it = std_matrix[i2].begin(); it != std_matrix[i2].end(); ++it)
+        std_matrix_trans[it->first][static_cast<unsigned int>(i2)] = it->second;
+
+    viennacl::compressed_matrix<NumericT> vcl_compressed_matrix_trans = viennacl::trans(vcl_compressed_matrix);
+
+    result = viennacl::linalg::prod(std_matrix_trans, rhs);
+    vcl_result = viennacl::linalg::prod(vcl_compressed_matrix_trans, vcl_rhs);
+
+    if ( std::fabs(diff(result, vcl_result)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with transposed compressed_matrix" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // transposing twice recovers the original matrix including the order of column indices:
+    viennacl::compressed_matrix<NumericT> vcl_compressed_matrix_trans_trans(vcl_compressed_matrix.size1(), vcl_compressed_matrix.size2());
+    vcl_compressed_matrix_trans_trans = viennacl::trans(vcl_compressed_matrix_trans);
+    vcl_compressed_matrix_trans = viennacl::trans(vcl_compressed_matrix_trans);
+
+    std::vector<unsigned int> row_buffer(vcl_compressed_matrix.size1() + 1), row_buffer_trans_trans(row_buffer.size()), row_buffer_in_place(row_buffer.size());
+    std::vector<unsigned int> col_buffer(vcl_compressed_matrix.nnz()),       col_buffer_trans_trans(col_buffer.size()), col_buffer_in_place(col_buffer.size());
+    viennacl::backend::memory_read(vcl_compressed_matrix.handle1(),             0, sizeof(unsigned int) * row_buffer.size(), &(row_buffer[0]));
+    viennacl::backend::memory_read(vcl_compressed_matrix.handle2(),             0, sizeof(unsigned int) * col_buffer.size(), &(col_buffer[0]));
+    viennacl::backend::memory_read(vcl_compressed_matrix_trans_trans.handle1(), 0, sizeof(unsigned int) * row_buffer.size(), &(row_buffer_trans_trans[0]));
+    viennacl::backend::memory_read(vcl_compressed_matrix_trans_trans.handle2(), 0, sizeof(unsigned int) * col_buffer.size(), &(col_buffer_trans_trans[0]));
+    viennacl::backend::memory_read(vcl_compressed_matrix_trans.handle1(),       0, sizeof(unsigned int) * row_buffer.size(), &(row_buffer_in_place[0]));
+    viennacl::backend::memory_read(vcl_compressed_matrix_trans.handle2(),       0, sizeof(unsigned int) * col_buffer.size(), &(col_buffer_in_place[0]));
+
+    if (row_buffer != row_buffer_trans_trans || col_buffer != col_buffer_trans_trans || row_buffer != row_buffer_in_place || col_buffer != col_buffer_in_place)
+    {
+      std::cout << "# Error at operation: transposition of transposed compressed_matrix" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    result = viennacl::linalg::prod(std_matrix, rhs);
+    vcl_result = viennacl::linalg::prod(vcl_compressed_matrix_trans_trans, vcl_rhs);
+
+    if ( std::fabs(diff(result, vcl_result)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with twice transposed compressed_matrix" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   //
   // Triangular solvers for A \ b:
   //
@@ -732,6 +880,27 @@ int test(Epsilon const& epsilon)
     return EXIT_FAILURE;
   }
 
+  std::cout << "Testing products: transposed coordinate_matrix" << std::endl;
+  {
+    std::vector<std::map<unsigned int, NumericT> > std_matrix_trans(std_matrix.size());
+    for (std::size_t i2=0; i2 < std_matrix.size(); ++i2)
+      for (typename std::map<unsigned int, NumericT>::const_iterator it = std_matrix[i2].begin(); it != std_matrix[i2].end(); ++it)
+        std_matrix_trans[it->first][static_cast<unsigned int>(i2)] = it->second;
+
+    viennacl::coordinate_matrix<NumericT> vcl_coordinate_matrix_trans = viennacl::trans(vcl_coordinate_matrix);
+
+    result     = viennacl::linalg::prod(std_matrix_trans, rhs);
+    vcl_result = viennacl::linalg::prod(vcl_coordinate_matrix_trans, vcl_rhs);
+
+    if ( std::fabs(diff(result, vcl_result)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with transposed coordinate_matrix" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+      return EXIT_FAILURE;
+    }
+    result     = viennacl::linalg::prod(std_matrix, rhs);
+  }
+
   std::cout << "Testing products: coordinate_matrix, strided vectors" << std::endl;
   //std::cout << " --> SKIPPING <--" << std::endl;
   retval = strided_matrix_vector_product_test<NumericT, viennacl::coordinate_matrix<NumericT> >(epsilon, result, rhs, vcl_result, vcl_rhs);
@@ -873,6 +1042,35 @@ int test(Epsilon const& epsilon)
     return EXIT_FAILURE;
   }
 
+  std::cout << "Testing products: sliced_ell_matrix, sorted rows" << std::endl;
+  {
+    // block size not a multiple of the SIMD width, so that the scalar remainder of the block kernels is used as well
+    viennacl::sliced_ell_matrix<NumericT> vcl_sliced_ell_matrix_sorted(std_matrix.size(), rhs.size(), 12, 96);
+    viennacl::copy(std_matrix, vcl_sliced_ell_matrix_sorted);
+
+    result     = viennacl::linalg::prod(std_matrix, rhs);
+    vcl_result.clear();
+    vcl_result = viennacl::linalg::prod(vcl_sliced_ell_matrix_sorted, vcl_rhs);
+
+    if ( std::fabs(diff(result, vcl_result)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with sliced_ell_matrix, sorted rows" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    for (std::size_t i=0; i<result.size(); ++i) result[i] = rhs[i] - NumericT(2) * result[i];
+    vcl_result = vcl_rhs;
+    viennacl::linalg::prod_impl(vcl_sliced_ell_matrix_sorted, vcl_rhs, NumericT(-2), vcl_result, NumericT(1));
+
+    if ( std::fabs(diff(result, vcl_result)) > epsilon )
+    {
+      std::cout << "# Error at operation: matrix-vector product with sliced_ell_matrix, sorted rows (alpha, beta)" << std::endl;
+      std::cout << "  diff: " << std::fabs(diff(result, vcl_result)) << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   //
   /////////////////////////
   //
@@ -0,0 +1,243 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/sparse_format.cpp  Tests the analysis of sparse matrices, the selection of sparse matrix formats and the conversion between formats.
+*   \test Tests the analysis of sparse matrices, the selection of sparse matrix formats and the conversion between formats.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/tools/sparse_format.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+template<typename NumericT>
+NumericT diff(std::vector<NumericT> const & v1, viennacl::vector<NumericT> const & v2)
+{
+  std::vector<NumericT> v2_cpu(v2.size());
+  viennacl::copy(v2, v2_cpu);
+
+  NumericT norm_inf = 0;
+  for (std::size_t i=0; i<v1.size(); ++i)
+    norm_inf = std::max<NumericT>(norm_inf, std::fabs(v1[i] - v2_cpu[i]) / std::max<NumericT>(1, std::fabs(v1[i])));
+  return norm_inf;
+}
+
+/** @brief Reference product y = A * x with the host matrix */
+template<typename NumericT>
+std::vector<NumericT> reference_prod(std::vector<std::map<unsigned int, NumericT> > const & A, std::vector<NumericT> const & x)
+{
+  std::vector<NumericT> y(A.size());
+  for (std::size_t i=0; i<A.size(); ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = A[i].begin(); it != A[i].end(); ++it)
+      y[i] += it->second * x[it->first];
+  return y;
+}
+
+/** @brief Converts A to the provided format and compares the matrix-vector product with the reference */
+template<typename SparseMatrixT, typename NumericT>
+int test_convert(viennacl::compressed_matrix<NumericT> const & A, SparseMatrixT & B,
+                 viennacl::vector<NumericT> const & x, std::vector<NumericT> const & reference, const char * name)
+{
+  viennacl::tools::convert(A, B);
+  CHECK(B.size1() == A.size1() && B.size2() == A.size2(), "wrong size after conversion to " << name);
+
+  viennacl::vector<NumericT> y(A.size1());
+  viennacl::linalg::prod_impl(B, x, NumericT(1), y, NumericT(0));
+  CHECK(diff(reference, y) < NumericT(1e-5), "wrong matrix-vector product after conversion to " << name);
+  return EXIT_SUCCESS;
+}
+
+template<typename NumericT>
+int test(std::vector<std::map<unsigned int, NumericT> > const & std_A, std::size_t cols, const char * name, viennacl::tools::sparse_format expected_format)
+{
+  std::cout << "Testing " << name << "..." << std::endl;
+
+  viennacl::compressed_matrix<NumericT> A(std_A.size(), cols);
+  viennacl::copy(viennacl::tools::const_sparse_matrix_adapter<NumericT>(std_A, std_A.size(), cols), A);
+
+  std::vector<NumericT> std_x(cols);
+  for (std::size_t i=0; i<std_x.size(); ++i)
+    std_x[i] = NumericT(1) + NumericT(i % 13) / NumericT(5);
+  viennacl::vector<NumericT> x(cols);
+  viennacl::copy(std_x, x);
+  std::vector<NumericT> reference = reference_prod(std_A, std_x);
+
+  //
+  // statistics:
+  //
+  std::size_t nnz = 0, max_row_length = 0, empty_rows = 0, bandwidth = 0;
+  double sum_of_squares = 0;
+  for (std::size_t i=0; i<std_A.size(); ++i)
+  {
+    nnz += std_A[i].size();
+    max_row_length = std::max(max_row_length, std_A[i].size());
+    sum_of_squares += double(std_A[i].size()) * double(std_A[i].size());
+    if (std_A[i].empty())
+      ++empty_rows;
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = std_A[i].begin(); it != std_A[i].end(); ++it)
+      bandwidth = std::max<std::size_t>(bandwidth, (it->first > i) ? it->first - i : i - it->first);
+  }
+  double mean = double(nnz) / double(std_A.size());
+
+  std::size_t sliced_ell_entries = 0;
+  for (std::size_t block_begin=0; block_begin<std_A.size(); block_begin += 32)
+  {
+    std::size_t block_max_row_length = 0;
+    for (std::size_t i=block_begin; i<std::min(block_begin + 32, std_A.size()); ++i)
+      block_max_row_length = std::max(block_max_row_length, std_A[i].size());
+    sliced_ell_entries += 32 * block_max_row_length;
+  }
+
+  viennacl::tools::sparse_matrix_statistics stats = viennacl::tools::analyze_sparse_matrix(A);
+  CHECK(stats.size1 == std_A.size() && stats.size2 == cols && stats.nnz == nnz, "wrong sizes in statistics");
+  CHECK(stats.max_row_length == max_row_length, "wrong maximum row length: " << stats.max_row_length << " vs. " << max_row_length);
+  CHECK(stats.bandwidth == bandwidth, "wrong bandwidth: " << stats.bandwidth << " vs. " << bandwidth);
+  CHECK(std::fabs(stats.mean_row_length - mean) < 1e-10 * mean, "wrong mean row length");
+  CHECK(std::fabs(stats.row_length_variance - (sum_of_squares / double(std_A.size()) - mean * mean)) < 1e-8 * (1 + sum_of_squares), "wrong row length variance");
+  CHECK(std::fabs(stats.empty_row_fraction - double(empty_rows) / double(std_A.size())) < 1e-12, "wrong fraction of empty rows");
+  CHECK(std::fabs(stats.ell_fill - double(max_row_length * std_A.size()) / double(nnz)) < 1e-10, "wrong fill of ELL format");
+  CHECK(std::fabs(stats.sliced_ell_fill - double(sliced_ell_entries) / double(nnz)) < 1e-10, "wrong fill of SELL format");
+
+  viennacl::tools::sparse_format format = viennacl::tools::recommend_sparse_format(stats, viennacl::MAIN_MEMORY);
+  CHECK(format == expected_format, "recommended " << viennacl::tools::sparse_format_name(format) << " instead of " << viennacl::tools::sparse_format_name(expected_format));
+
+  //
+  // conversions:
+  //
+  viennacl::compressed_compressed_matrix<NumericT> A_cc;
+  viennacl::coordinate_matrix<NumericT>            A_coo;
+  viennacl::ell_matrix<NumericT>                   A_ell;
+  viennacl::sliced_ell_matrix<NumericT>            A_sell;
+  viennacl::sliced_ell_matrix<NumericT>            A_sell_sorted(std_A.size(), cols, 16, 64);
+  viennacl::hyb_matrix<NumericT>                   A_hyb;
+  if (test_convert(A, A_cc,          x, reference, "compressed_compressed_matrix") != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_convert(A, A_coo,         x, reference, "coordinate_matrix")            != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_convert(A, A_ell,         x, reference, "ell_matrix")                   != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_convert(A, A_sell,        x, reference, "sliced_ell_matrix")            != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_convert(A, A_sell_sorted, x, reference, "sliced_ell_matrix, sorted")    != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_convert(A, A_hyb,         x, reference, "hyb_matrix")                   != EXIT_SUCCESS) return EXIT_FAILURE;
+
+  //
+  // adaptive matrix, with and without benchmark:
+  //
+  viennacl::vector<NumericT> y = viennacl::scalar_vector<NumericT>(A.size1(), NumericT(1));
+  viennacl::tools::adaptive_sparse_matrix<NumericT> A_adaptive(A);
+  CHECK(A_adaptive.format() == expected_format, "adaptive matrix not set up in the recommended format");
+  A_adaptive.prod_impl(x, NumericT(2), y, NumericT(1));
+  for (std::size_t i=0; i<reference.size(); ++i)
+    reference[i] = NumericT(2) * reference[i] + NumericT(1);
+  CHECK(diff(reference, y) < NumericT(1e-5), "wrong matrix-vector product with adaptive matrix");
+
+  viennacl::tools::adaptive_sparse_matrix<NumericT> A_benchmarked(A, 3);
+  std::cout << "  fastest format: " << viennacl::tools::sparse_format_name(A_benchmarked.format()) << std::endl;
+  y = viennacl::scalar_vector<NumericT>(A.size1(), NumericT(1));
+  A_benchmarked.prod_impl(x, NumericT(2), y, NumericT(1));
+  CHECK(diff(reference, y) < NumericT(1e-5), "wrong matrix-vector product with benchmarked adaptive matrix");
+
+  // free function interface, as used by e.g. the iterative solvers:
+  y = viennacl::scalar_vector<NumericT>(A.size1(), NumericT(1));
+  y += viennacl::linalg::prod(A_adaptive, x);
+  y += viennacl::linalg::prod(A_benchmarked, x);
+  CHECK(diff(reference, y) < NumericT(1e-5), "wrong matrix-vector product with adaptive matrix via prod()");
+  y -= viennacl::linalg::prod(A_adaptive, x);
+  viennacl::linalg::prod_impl(A_adaptive, x, NumericT(1), y, NumericT(1));
+  CHECK(diff(reference, y) < NumericT(1e-5), "wrong matrix-vector product with adaptive matrix via prod_impl()");
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Sparse matrix analysis and format selection" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  typedef double NumericT;
+  std::size_t n = 3001;
+
+  // tridiagonal: (almost) constant row lengths
+  std::vector<std::map<unsigned int, NumericT> > A_tridiag(n);
+  for (std::size_t i=0; i<n; ++i)
+  {
+    A_tridiag[i][static_cast<unsigned int>(i)] = 2;
+    if (i > 0)     A_tridiag[i][static_cast<unsigned int>(i - 1)] = -1;
+    if (i + 1 < n) A_tridiag[i][static_cast<unsigned int>(i + 1)] = -1;
+  }
+  if (test(A_tridiag, n, "tridiagonal matrix", viennacl::tools::sparse_format_ell) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  // row lengths varying between 1 and 9, similar row lengths within blocks of 32 rows
+  std::vector<std::map<unsigned int, NumericT> > A_varying(n);
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t k=0; k <= (i / 32) % 8 + i % 2; ++k)
+      A_varying[i][static_cast<unsigned int>((i + 17 * k) % n)] = NumericT(1) + NumericT(k);
+  if (test(A_varying, n, "matrix with varying row lengths", viennacl::tools::sparse_format_sliced_ell) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  // two entries per row and a few dense rows
+  std::vector<std::map<unsigned int, NumericT> > A_dense_rows(n);
+  for (std::size_t i=0; i<n; ++i)
+  {
+    A_dense_rows[i][static_cast<unsigned int>(i)] = 4;
+    A_dense_rows[i][static_cast<unsigned int>((i * 31) % n)] += 1;
+    if (i % 1000 == 1)
+      for (std::size_t j=0; j<n; j += 3)
+        A_dense_rows[i][static_cast<unsigned int>(j)] += NumericT(0.5);
+  }
+  if (test(A_dense_rows, n, "matrix with dense rows", viennacl::tools::sparse_format_compressed) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  // mostly empty rows, rectangular
+  std::vector<std::map<unsigned int, NumericT> > A_empty_rows(n);
+  for (std::size_t i=0; i<n; i += 5)
+    for (std::size_t k=0; k<3; ++k)
+      A_empty_rows[i][static_cast<unsigned int>((i + 101 * k) % 1000)] = NumericT(1) + NumericT(k);
+  if (test(A_empty_rows, 1000, "matrix with empty rows", viennacl::tools::sparse_format_compressed_compressed) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
+//
+// -------------------------------------------------------------
+//
@@ -0,0 +1,344 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/sparse_index64.cpp  Tests compressed_matrix and coordinate_matrix with 64-bit indices.
+*   \test Tests compressed_matrix and coordinate_matrix with 64-bit indices: Setup, conversions, products, transposition, triangular solves, binary I/O, and CG, compared against the default 32-bit indices.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/coordinate_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/row_scaling.hpp"
+#include "viennacl/io/binary.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+template<typename NumericT>
+NumericT diff(viennacl::vector_base<NumericT> const & v1, viennacl::vector_base<NumericT> const & v2)
+{
+  std::vector<NumericT> v1_cpu(v1.size());
+  std::vector<NumericT> v2_cpu(v2.size());
+  viennacl::copy(v1, v1_cpu);
+  viennacl::copy(v2, v2_cpu);
+
+  NumericT norm_inf = 0;
+  for (std::size_t i=0; i<v1_cpu.size(); ++i)
+    norm_inf = std::max<NumericT>(norm_inf, std::fabs(v1_cpu[i] - v2_cpu[i]) / std::max<NumericT>(1, std::fabs(v1_cpu[i])));
+  return norm_inf;
+}
+
+template<typename NumericT>
+NumericT diff(viennacl::matrix<NumericT> const & A1, viennacl::matrix<NumericT> const & A2)
+{
+  std::vector<std::vector<NumericT> > A1_cpu(A1.size1(), std::vector<NumericT>(A1.size2()));
+  std::vector<std::vector<NumericT> > A2_cpu(A2.size1(), std::vector<NumericT>(A2.size2()));
+  viennacl::copy(A1, A1_cpu);
+  viennacl::copy(A2, A2_cpu);
+
+  NumericT norm_inf = 0;
+  for (std::size_t i=0; i<A1_cpu.size(); ++i)
+    for (std::size_t j=0; j<A1_cpu[i].size(); ++j)
+      norm_inf = std::max<NumericT>(norm_inf, std::fabs(A1_cpu[i][j] - A2_cpu[i][j]) / std::max<NumericT>(1, std::fabs(A1_cpu[i][j])));
+  return norm_inf;
+}
+
+/** @brief Returns true if the two host matrices hold the same entries */
+template<typename NumericT>
+bool equal(std::vector<std::map<unsigned int, NumericT> > const & A, std::vector<std::map<unsigned int, NumericT> > const & B)
+{
+  if (A.size() != B.size())
+    return false;
+  for (std::size_t i=0; i<A.size(); ++i)
+  {
+    if (A[i].size() != B[i].size())
+      return false;
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = A[i].begin(), it2 = B[i].begin(); it != A[i].end(); ++it, ++it2)
+      if (it->first != it2->first || it->second < it2->second || it->second > it2->second)
+        return false;
+  }
+  return true;
+}
+
+/** @brief Sets up a nonsymmetric, diagonally dominant matrix with a varying number of entries per row and a few long rows */
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > generate_matrix(std::size_t n)
+{
+  std::vector<std::map<unsigned int, NumericT> > A(n);
+  for (std::size_t row = 0; row < n; ++row)
+  {
+    NumericT off_diagonal_sum = 0;
+    std::size_t entries = (row % 13 == 0) ? n / 4 : 1 + row % 5;
+    for (std::size_t k = 1; k <= entries; ++k)
+    {
+      std::size_t col = (row * 7 + k * 31) % n;
+      if (col == row)
+        continue;
+      NumericT value = NumericT(-1) / NumericT(1 + (row + col) % 7);
+      A[row][static_cast<unsigned int>(col)] = value;
+      off_diagonal_sum += std::fabs(value);
+    }
+    A[row][static_cast<unsigned int>(row)] = off_diagonal_sum + NumericT(1 + row % 3);
+  }
+  return A;
+}
+
+/** @brief Returns the symmetric part A + A^T of the matrix */
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > symmetric_part(std::vector<std::map<unsigned int, NumericT> > const & A)
+{
+  std::vector<std::map<unsigned int, NumericT> > S(A.size());
+  for (std::size_t i=0; i<A.size(); ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = A[i].begin(); it != A[i].end(); ++it)
+    {
+      S[i][it->first] += it->second;
+      S[it->first][static_cast<unsigned int>(i)] += it->second;
+    }
+  return S;
+}
+
+template<typename NumericT>
+int test(NumericT eps)
+{
+  typedef viennacl::compressed_matrix<NumericT, 1, unsigned long>    CompressedMatrix64;
+  typedef viennacl::coordinate_matrix<NumericT, 128, unsigned long>  CoordinateMatrix64;
+
+  std::size_t n = 1537;
+  std::vector<std::map<unsigned int, NumericT> > std_A = generate_matrix<NumericT>(n);
+
+  viennacl::compressed_matrix<NumericT> A32(n, n);
+  viennacl::copy(std_A, A32);
+
+  std::vector<NumericT> std_x(n);
+  for (std::size_t i=0; i<n; ++i)
+    std_x[i] = NumericT(1) + NumericT(i % 11) / NumericT(7);
+  viennacl::vector<NumericT> x(n);
+  viennacl::copy(std_x, x);
+
+  //
+  // setup and copy back:
+  //
+  std::cout << "Testing setup of 64-bit index matrices..." << std::endl;
+  CompressedMatrix64 A(n, n);
+  viennacl::copy(std_A, A);
+  CHECK(A.nnz() == A32.nnz(), "wrong number of nonzeros of compressed_matrix: " << A.nnz() << " vs. " << A32.nnz());
+
+  std::vector<std::map<unsigned int, NumericT> > std_A2(n);
+  viennacl::copy(A, std_A2);
+  CHECK(equal(std_A, std_A2), "wrong entries of compressed_matrix after copy to host");
+
+  CoordinateMatrix64 A_coo(n, n);
+  viennacl::copy(std_A, A_coo);
+  CHECK(A_coo.nnz() == A32.nnz(), "wrong number of nonzeros of coordinate_matrix: " << A_coo.nnz() << " vs. " << A32.nnz());
+
+  std::vector<std::map<unsigned int, NumericT> > std_A3(n);
+  viennacl::copy(A_coo, std_A3);
+  CHECK(equal(std_A, std_A3), "wrong entries of coordinate_matrix after copy to host");
+
+  std::vector<unsigned long> triplet_rows;
+  std::vector<unsigned long> triplet_cols;
+  std::vector<NumericT>      triplet_values;
+  for (std::size_t i=n; i>0; --i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = std_A[i-1].begin(); it != std_A[i-1].end(); ++it)
+    {
+      triplet_rows.push_back(i-1);
+      triplet_cols.push_back(it->first);
+      triplet_values.push_back(it->second);
+    }
+  CompressedMatrix64 A_triplets;
+  A_triplets.set_from_triplets(n, n, triplet_values.size(), &triplet_rows[0], &triplet_cols[0], &triplet_values[0]);
+  std::vector<std::map<unsigned int, NumericT> > std_A4(n);
+  viennacl::copy(A_triplets, std_A4);
+  CHECK(equal(std_A, std_A4), "wrong entries of compressed_matrix after set_from_triplets()");
+
+  //
+  // matrix-vector products:
+  //
+  std::cout << "Testing matrix-vector products..." << std::endl;
+  viennacl::vector<NumericT> y32 = viennacl::linalg::prod(A32, x);
+  viennacl::vector<NumericT> y = viennacl::linalg::prod(A, x);
+  CHECK(diff(y32, y) < eps, "wrong result of y = prod(A, x) for compressed_matrix");
+
+  y = viennacl::linalg::prod(A_coo, x);
+  CHECK(diff(y32, y) < eps, "wrong result of y = prod(A, x) for coordinate_matrix");
+
+  y = x;
+  y += viennacl::linalg::prod(A, x);
+  y32 += x;
+  CHECK(diff(y32, y) < eps, "wrong result of y += prod(A, x) for compressed_matrix");
+
+  //
+  // sparse-dense matrix products:
+  //
+  std::cout << "Testing sparse-dense matrix products..." << std::endl;
+  std::size_t k = 7;
+  std::vector<std::vector<NumericT> > std_B(n, std::vector<NumericT>(k));
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<k; ++j)
+      std_B[i][j] = NumericT(1 + (i + 3 * j) % 5) / NumericT(3);
+  viennacl::matrix<NumericT> B(n, k);
+  viennacl::copy(std_B, B);
+  viennacl::matrix<NumericT> B_trans = viennacl::trans(B);
+
+  viennacl::matrix<NumericT> C32 = viennacl::linalg::prod(A32, B);
+  viennacl::matrix<NumericT> C   = viennacl::linalg::prod(A, B);
+  CHECK(diff(C32, C) < eps, "wrong result of C = prod(A, B) for compressed_matrix");
+
+  C = viennacl::linalg::prod(A, viennacl::trans(B_trans));
+  CHECK(diff(C32, C) < eps, "wrong result of C = prod(A, trans(B)) for compressed_matrix");
+
+  C = viennacl::linalg::prod(A_coo, B);
+  CHECK(diff(C32, C) < eps, "wrong result of C = prod(A, B) for coordinate_matrix");
+
+  C = viennacl::linalg::prod(A_coo, viennacl::trans(B_trans));
+  CHECK(diff(C32, C) < eps, "wrong result of C = prod(A, trans(B)) for coordinate_matrix");
+
+  //
+  // transposition:
+  //
+  std::cout << "Testing transposition..." << std::endl;
+  viennacl::compressed_matrix<NumericT> At32 = viennacl::trans(A32);
+  y32 = viennacl::linalg::prod(At32, x);
+
+  CompressedMatrix64 At = viennacl::trans(A);
+  CHECK(At.nnz() == A.nnz(), "wrong number of nonzeros after transposition of compressed_matrix");
+  y = viennacl::linalg::prod(At, x);
+  CHECK(diff(y32, y) < eps, "wrong result of y = prod(trans(A), x) for compressed_matrix");
+
+  CoordinateMatrix64 At_coo = viennacl::trans(A_coo);
+  CHECK(At_coo.nnz() == A.nnz(), "wrong number of nonzeros after transposition of coordinate_matrix");
+  y = viennacl::linalg::prod(At_coo, x);
+  CHECK(diff(y32, y) < eps, "wrong result of y = prod(trans(A), x) for coordinate_matrix");
+
+  //
+  // triangular solves:
+  //
+  std::cout << "Testing triangular solves..." << std::endl;
+  viennacl::vector<NumericT> z32(x);
+  viennacl::vector<NumericT> z(x);
+
+  viennacl::linalg::inplace_solve(A32, z32, viennacl::linalg::lower_tag());
+  viennacl::linalg::inplace_solve(A,   z,   viennacl::linalg::lower_tag());
+  CHECK(diff(z32, z) < eps, "wrong result of lower triangular solve");
+
+  viennacl::linalg::inplace_solve(A32, z32, viennacl::linalg::unit_upper_tag());
+  viennacl::linalg::inplace_solve(A,   z,   viennacl::linalg::unit_upper_tag());
+  CHECK(diff(z32, z) < eps, "wrong result of unit upper triangular solve");
+
+  viennacl::linalg::inplace_solve(viennacl::trans(A32), z32, viennacl::linalg::upper_tag());
+  viennacl::linalg::inplace_solve(viennacl::trans(A),   z,   viennacl::linalg::upper_tag());
+  CHECK(diff(z32, z) < eps, "wrong result of transposed upper triangular solve");
+
+  viennacl::linalg::inplace_solve(viennacl::trans(A32), z32, viennacl::linalg::unit_lower_tag());
+  viennacl::linalg::inplace_solve(viennacl::trans(A),   z,   viennacl::linalg::unit_lower_tag());
+  CHECK(diff(z32, z) < eps, "wrong result of transposed unit lower triangular solve");
+
+  //
+  // binary I/O:
+  //
+  std::cout << "Testing binary I/O..." << std::endl;
+  const char * filename = "sparse_index64-test.vclbin";
+  CHECK(viennacl::io::write_binary_file(A, filename) != 0, "writing binary file failed");
+
+  CompressedMatrix64 A_read;
+  CHECK(viennacl::io::read_binary_file(A_read, filename) != 0, "reading binary file failed");
+  y32 = viennacl::linalg::prod(A32, x);
+  y = viennacl::linalg::prod(A_read, x);
+  CHECK(diff(y32, y) < eps, "wrong result of y = prod(A, x) after reading binary file");
+
+  viennacl::compressed_matrix<NumericT> A32_read;
+  std::cout << "(the following error message is expected)" << std::endl;
+  CHECK(viennacl::io::read_binary_file(A32_read, filename) == 0, "binary file with 64-bit indices read into compressed_matrix with 32-bit indices");
+  std::remove(filename);
+
+  //
+  // conjugate gradients with Jacobi and row scaling preconditioners:
+  //
+  std::cout << "Testing CG with 64-bit index matrices..." << std::endl;
+  std::vector<std::map<unsigned int, NumericT> > std_S = symmetric_part(std_A);
+  CompressedMatrix64 S(n, n);
+  viennacl::copy(std_S, S);
+  CoordinateMatrix64 S_coo(n, n);
+  viennacl::copy(std_S, S_coo);
+
+  viennacl::vector<NumericT> b = viennacl::scalar_vector<NumericT>(n, NumericT(1));
+  NumericT solver_tolerance = std::sqrt(eps);
+  viennacl::linalg::cg_tag cg_tag(solver_tolerance, 500);
+
+  viennacl::linalg::jacobi_precond<CompressedMatrix64> jacobi(S, viennacl::linalg::jacobi_tag());
+  viennacl::vector<NumericT> result = viennacl::linalg::solve(S, b, cg_tag, jacobi);
+  viennacl::vector<NumericT> residual = viennacl::linalg::prod(S, result);
+  residual -= b;
+  CHECK(viennacl::linalg::norm_2(residual) / viennacl::linalg::norm_2(b) < NumericT(10) * solver_tolerance, "CG with Jacobi preconditioner did not converge for compressed_matrix");
+
+  viennacl::linalg::row_scaling<CoordinateMatrix64> row_scaling(S_coo, viennacl::linalg::row_scaling_tag(2));
+  result = viennacl::linalg::solve(S_coo, b, cg_tag, row_scaling);
+  residual = viennacl::linalg::prod(S_coo, result);
+  residual -= b;
+  CHECK(viennacl::linalg::norm_2(residual) / viennacl::linalg::norm_2(b) < NumericT(10) * solver_tolerance, "CG with row scaling preconditioner did not converge for coordinate_matrix");
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Sparse matrices with 64-bit indices" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: float" << std::endl;
+  if (test<float>(1e-5f) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: double" << std::endl;
+  if (test<double>(1e-12) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
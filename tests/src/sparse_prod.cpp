@@ -27,6 +27,7 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <string>
 
 
 //
@@ -35,6 +36,7 @@
 #include "viennacl/scalar.hpp"
 #include "viennacl/compressed_matrix.hpp"
 #include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/host_based/amg_operations.hpp"
 
 #include "viennacl/tools/random.hpp"
 
@@ -125,6 +127,116 @@ void prod(std::vector<std::map<IndexT, NumericT> > const & stl_A,
 }
 
 
+/* Compares the Galerkin product R * A * P of the host-based AMG setup with prod(R, prod(A, P)).
+*
+* A has nnz_row random entries per row plus the diagonal, the first num_dense_rows rows of A are full.
+* Every row of P has P_nnz_row random entries in the coarse_size columns, except for every P_empty_row_step-th row, which is empty.
+*/
+template<typename NumericT, typename Epsilon>
+int test_galerkin(Epsilon const & epsilon,
+                  std::size_t fine_size, std::size_t nnz_row, std::size_t num_dense_rows,
+                  std::size_t coarse_size, std::size_t P_nnz_row, std::size_t P_empty_row_step,
+                  std::string const & name)
+{
+  viennacl::tools::uniform_random_numbers<NumericT> randomNumber;
+  viennacl::context host_ctx(viennacl::MAIN_MEMORY);
+
+  std::vector<std::map<unsigned int, NumericT> > stl_A(fine_size);
+  std::vector<std::map<unsigned int, NumericT> > stl_P(fine_size);
+  std::vector<std::map<unsigned int, NumericT> > stl_R(coarse_size);
+  std::vector<std::map<unsigned int, NumericT> > stl_AP(fine_size);
+  std::vector<std::map<unsigned int, NumericT> > stl_RAP(coarse_size);
+
+  for (std::size_t i=0; i<fine_size; ++i)
+  {
+    stl_A[i][static_cast<unsigned int>(i)] = NumericT(4.0);
+    std::size_t row_entries = (i < num_dense_rows) ? fine_size : nnz_row;
+    for (std::size_t j=0; j<row_entries; ++j)
+    {
+      unsigned int col = (i < num_dense_rows) ? static_cast<unsigned int>(j) : static_cast<unsigned int>(randomNumber() * NumericT(fine_size));
+      stl_A[i][col] = NumericT(1.0) + NumericT(0.5) * randomNumber();
+    }
+  }
+
+  for (std::size_t i=0; i<fine_size; ++i)
+  {
+    if (P_empty_row_step > 0 && i % P_empty_row_step == 0)
+      continue;
+    for (std::size_t j=0; j<P_nnz_row; ++j)
+    {
+      unsigned int col = static_cast<unsigned int>(randomNumber() * NumericT(coarse_size));
+      stl_P[i][col] = NumericT(1.0) + NumericT(0.5) * randomNumber();
+      stl_R[col][static_cast<unsigned int>(i)] = stl_P[i][col];
+    }
+  }
+
+  prod(stl_A, stl_P, stl_AP);
+  prod(stl_R, stl_AP, stl_RAP);
+
+  viennacl::compressed_matrix<NumericT> vcl_A(fine_size, fine_size, host_ctx);
+  viennacl::compressed_matrix<NumericT> vcl_P(fine_size, coarse_size, host_ctx);
+  viennacl::compressed_matrix<NumericT> vcl_R(coarse_size, fine_size, host_ctx);
+  viennacl::tools::sparse_matrix_adapter<NumericT> adapted_stl_A(stl_A, fine_size, fine_size);
+  viennacl::tools::sparse_matrix_adapter<NumericT> adapted_stl_P(stl_P, fine_size, coarse_size);
+  viennacl::tools::sparse_matrix_adapter<NumericT> adapted_stl_R(stl_R, coarse_size, fine_size);
+  viennacl::copy(adapted_stl_A, vcl_A);
+  viennacl::copy(adapted_stl_P, vcl_P);
+  viennacl::copy(adapted_stl_R, vcl_R);
+
+  std::cout << "Testing Galerkin product: " << name << std::endl;
+  viennacl::compressed_matrix<NumericT> vcl_AP(host_ctx);
+  viennacl::compressed_matrix<NumericT> vcl_RAP(host_ctx);
+  vcl_AP  = viennacl::linalg::prod(vcl_A, vcl_P);
+  vcl_RAP = viennacl::linalg::prod(vcl_R, vcl_AP);
+  if ( std::fabs(diff(stl_RAP, vcl_RAP)) > epsilon )
+  {
+    std::cout << "# Error at operation: reference product prod(R, prod(A, P)) (" << name << ")" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(stl_RAP, vcl_RAP)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  viennacl::compressed_matrix<NumericT> vcl_C(host_ctx);
+  viennacl::linalg::host_based::amg::amg_galerkin_prod(vcl_A, vcl_P, vcl_R, vcl_C);
+  if (vcl_C.size1() != coarse_size || vcl_C.size2() != coarse_size || vcl_C.nnz() != vcl_RAP.nnz())
+  {
+    std::cout << "# Error at operation: Galerkin product (" << name << "): wrong size or number of nonzeros" << std::endl;
+    std::cout << "  nnz: " << vcl_C.nnz() << " instead of " << vcl_RAP.nnz() << std::endl;
+    return EXIT_FAILURE;
+  }
+  if ( std::fabs(diff(stl_RAP, vcl_C)) > epsilon )
+  {
+    std::cout << "# Error at operation: Galerkin product (" << name << ")" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(stl_RAP, vcl_C)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/** @brief Tests the Galerkin product for an empty fine space, where the dense accumulators would be selected for rows without any entries */
+template<typename NumericT>
+int test_galerkin_empty_fine_space()
+{
+  viennacl::context host_ctx(viennacl::MAIN_MEMORY);
+
+  // Note: viennacl::copy() does not support matrices without rows, hence the matrices are set up directly:
+  viennacl::compressed_matrix<NumericT> vcl_A(0, 0, host_ctx);
+  viennacl::compressed_matrix<NumericT> vcl_P(0, 5, host_ctx);
+  viennacl::compressed_matrix<NumericT> vcl_R(5, 0, host_ctx);
+
+  std::cout << "Testing Galerkin product: empty fine space" << std::endl;
+  viennacl::compressed_matrix<NumericT> vcl_C(host_ctx);
+  viennacl::linalg::host_based::amg::amg_galerkin_prod(vcl_A, vcl_P, vcl_R, vcl_C);
+  if (vcl_C.size1() != 5 || vcl_C.size2() != 5 || vcl_C.nnz() != 0)
+  {
+    std::cout << "# Error at operation: Galerkin product (empty fine space): wrong size or number of nonzeros" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+
 //
 // -------------------------------------------------------------
 //
@@ -192,6 +304,96 @@ int test(Epsilon const& epsilon)
     retval = EXIT_FAILURE;
   }
 
+  std::cout << "Testing products: compressed_matrix with symbolic and numeric phase" << std::endl;
+  viennacl::linalg::spgemm_plan plan;
+  viennacl::linalg::prod_symbolic(vcl_A, vcl_B, plan);
+
+  viennacl::compressed_matrix<NumericT> vcl_F;
+  viennacl::linalg::prod_numeric(vcl_A, vcl_B, plan, vcl_F);
+  if ( std::fabs(diff(stl_C, vcl_F)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-matrix product with compressed_matrix (vcl_F)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(stl_C, vcl_F)) << std::endl;
+    retval = EXIT_FAILURE;
+  }
+
+  // change the values, but not the sparsity patterns of the factors:
+  for (std::size_t i=0; i<stl_A.size(); ++i)
+    for (typename std::map<unsigned int, NumericT>::iterator it = stl_A[i].begin(); it != stl_A[i].end(); ++it)
+      it->second = NumericT(1.0) + NumericT(0.5) * randomNumber();
+  for (std::size_t i=0; i<stl_B.size(); ++i)
+    for (typename std::map<unsigned int, NumericT>::iterator it = stl_B[i].begin(); it != stl_B[i].end(); ++it)
+      it->second = NumericT(1.0) + NumericT(0.5) * randomNumber();
+  viennacl::copy(adapted_stl_A, vcl_A);
+  viennacl::copy(adapted_stl_B, vcl_B);
+
+  for (std::size_t i=0; i<stl_C.size(); ++i)
+    stl_C[i].clear();
+  prod(stl_A, stl_B, stl_C);
+
+  viennacl::switch_memory_context(vcl_F, viennacl::traits::context(vcl_A)); // diff() moved vcl_F to main memory
+  viennacl::linalg::prod_numeric(vcl_A, vcl_B, plan, vcl_F);
+  if ( std::fabs(diff(stl_C, vcl_F)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-matrix product with compressed_matrix and reused plan (vcl_F)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(stl_C, vcl_F)) << std::endl;
+    retval = EXIT_FAILURE;
+  }
+
+  // rows of A with 0 to 19 entries, i.e. rows of C computed by merges of different numbers of rows of B as well as by hash tables and dense arrays:
+  std::cout << "Testing products: compressed_matrix with symbolic and numeric phase, varying row lengths" << std::endl;
+  std::vector<std::map<unsigned int, NumericT> > stl_A_varying(N);
+  for (std::size_t i=0; i<stl_A_varying.size(); ++i)
+    for (std::size_t j=0; j<i % 20; ++j)
+      stl_A_varying[i][static_cast<unsigned int>(randomNumber() * NumericT(K))] = NumericT(1.0) + NumericT(0.5) * randomNumber();
+  for (std::size_t i=0; i<stl_C.size(); ++i)
+    stl_C[i].clear();
+  prod(stl_A_varying, stl_B, stl_C);
+
+  viennacl::compressed_matrix<NumericT> vcl_A_varying(N, K);
+  viennacl::tools::sparse_matrix_adapter<NumericT> adapted_stl_A_varying(stl_A_varying, N, K);
+  viennacl::copy(adapted_stl_A_varying, vcl_A_varying);
+
+  viennacl::linalg::spgemm_plan plan_varying;
+  viennacl::linalg::prod_symbolic(vcl_A_varying, vcl_B, plan_varying);
+  viennacl::compressed_matrix<NumericT> vcl_F_varying;
+  viennacl::linalg::prod_numeric(vcl_A_varying, vcl_B, plan_varying, vcl_F_varying);
+  if ( std::fabs(diff(stl_C, vcl_F_varying)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-matrix product with compressed_matrix and varying row lengths (vcl_F_varying)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(stl_C, vcl_F_varying)) << std::endl;
+    retval = EXIT_FAILURE;
+  }
+
+  // many rows of the wide matrix contribute to a sparse row of the result:
+  std::cout << "Testing products: compressed_matrix with wide result" << std::endl;
+  std::size_t M_wide = 100000;
+  std::vector<std::map<unsigned int, NumericT> > stl_B_wide(K);
+  std::vector<std::map<unsigned int, NumericT> > stl_C_wide(N);
+  for (std::size_t i=0; i<stl_B_wide.size(); ++i)
+    for (std::size_t j=0; j<3; ++j)
+      stl_B_wide[i][static_cast<unsigned int>(randomNumber() * NumericT(M_wide))] = NumericT(1.0) + NumericT(0.5) * randomNumber();
+  prod(stl_A, stl_B_wide, stl_C_wide);
+
+  viennacl::compressed_matrix<NumericT> vcl_B_wide(K, M_wide);
+  viennacl::tools::sparse_matrix_adapter<NumericT> adapted_stl_B_wide(stl_B_wide, K, M_wide);
+  viennacl::copy(adapted_stl_B_wide, vcl_B_wide);
+
+  viennacl::compressed_matrix<NumericT> vcl_G = viennacl::linalg::prod(vcl_A, vcl_B_wide);
+  if ( std::fabs(diff(stl_C_wide, vcl_G)) > epsilon )
+  {
+    std::cout << "# Error at operation: matrix-matrix product with compressed_matrix and wide result (vcl_G)" << std::endl;
+    std::cout << "  diff: " << std::fabs(diff(stl_C_wide, vcl_G)) << std::endl;
+    retval = EXIT_FAILURE;
+  }
+
+  // Galerkin products of the AMG setup, accumulated in hash tables (short rows) and dense arrays (long rows):
+  if (test_galerkin<NumericT>(epsilon, 500,  2, 0, 400, 1, 0, "hash rows")                          != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_galerkin<NumericT>(epsilon, 500,  5, 3,  60, 3, 0, "dense rows")                         != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_galerkin<NumericT>(epsilon, 500,  2, 2, 300, 2, 7, "mixed rows, empty rows of P")        != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_galerkin<NumericT>(epsilon, 500, 10, 1,   1, 1, 3, "single coarse column")               != EXIT_SUCCESS) return EXIT_FAILURE;
+  if (test_galerkin_empty_fine_space<NumericT>()                                                    != EXIT_SUCCESS) return EXIT_FAILURE;
+
   // --------------------------------------------------------------------------
   return retval;
 }
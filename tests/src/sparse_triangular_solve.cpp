@@ -0,0 +1,314 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/sparse_triangular_solve.cpp  Tests the scheduled (parallel) sparse triangular solves used by the ILU and incomplete Cholesky preconditioners.
+*   \test Compares the scheduled triangular solves and the ILU0, ILUT, and ICHOL0 preconditioners with sequential substitution.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/linalg/ilu.hpp"
+#include "viennacl/linalg/ichol.hpp"
+#include "viennacl/linalg/host_based/sparse_matrix_operations.hpp"
+#include "viennacl/linalg/host_based/sparse_triangular_solve.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+/** @brief The five-point finite difference Laplacian on a points x points grid with a convection term. Many levels, the widest with 'points' rows. */
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > generate_laplacian(std::size_t points, NumericT convection)
+{
+  std::size_t n = points * points;
+  std::vector<std::map<unsigned int, NumericT> > A(n);
+  for (std::size_t row = 0; row < n; ++row)
+  {
+    std::size_t i = row % points;
+    std::size_t j = row / points;
+    A[row][static_cast<unsigned int>(row)] = NumericT(4);
+    if (i > 0)          A[row][static_cast<unsigned int>(row - 1)]      = NumericT(-1) - convection;
+    if (i + 1 < points) A[row][static_cast<unsigned int>(row + 1)]      = NumericT(-1) + convection;
+    if (j > 0)          A[row][static_cast<unsigned int>(row - points)] = NumericT(-1);
+    if (j + 1 < points) A[row][static_cast<unsigned int>(row + points)] = NumericT(-1);
+  }
+  return A;
+}
+
+/** @brief A symmetric, diagonally dominant matrix with pseudo-random long-range couplings. Few, wide levels. */
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > generate_random(std::size_t n)
+{
+  std::vector<std::map<unsigned int, NumericT> > A(n);
+  unsigned int state = 42;
+  for (std::size_t row = 0; row < n; ++row)
+  {
+    A[row][static_cast<unsigned int>(row)] = NumericT(8);
+    for (std::size_t k = 0; k < 3; ++k)
+    {
+      state = state * 1103515245u + 12345u;
+      std::size_t col = (state >> 8) % n;
+      if (col == row)
+        continue;
+      NumericT value = NumericT(-1) / NumericT(1 + k);
+      A[row][static_cast<unsigned int>(col)] = value;
+      A[col][static_cast<unsigned int>(row)] = value;
+    }
+  }
+  for (std::size_t row = 0; row < n; ++row) // keep diagonal dominance after symmetrization
+    A[row][static_cast<unsigned int>(row)] = NumericT(2) * NumericT(A[row].size());
+  return A;
+}
+
+/** @brief Tridiagonal matrix: every level holds a single row, so all levels are merged. */
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > generate_tridiagonal(std::size_t n)
+{
+  std::vector<std::map<unsigned int, NumericT> > A(n);
+  for (std::size_t row = 0; row < n; ++row)
+  {
+    A[row][static_cast<unsigned int>(row)] = NumericT(3);
+    if (row > 0)     A[row][static_cast<unsigned int>(row - 1)] = NumericT(-1);
+    if (row + 1 < n) A[row][static_cast<unsigned int>(row + 1)] = NumericT(-1);
+  }
+  return A;
+}
+
+template<typename NumericT>
+NumericT max_relative_difference(std::vector<NumericT> const & x, std::vector<NumericT> const & y)
+{
+  NumericT diff = 0;
+  NumericT norm = 0;
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    diff = std::max(diff, std::fabs(x[i] - y[i]));
+    norm = std::max(norm, std::fabs(y[i]));
+  }
+  return diff / norm;
+}
+
+template<typename NumericT>
+std::vector<NumericT> to_std(viennacl::vector<NumericT> const & x)
+{
+  std::vector<NumericT> result(x.size());
+  viennacl::copy(x, result);
+  return result;
+}
+
+/** @brief Compares all four scheduled triangular solves of a (factorized) CSR matrix with sequential substitution */
+template<typename NumericT>
+int check_schedules(viennacl::compressed_matrix<NumericT> const & LU, std::vector<NumericT> const & b, NumericT tolerance, std::string const & name)
+{
+  unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LU.handle1());
+  unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LU.handle2());
+  NumericT     const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(LU.handle());
+  std::size_t n = LU.size1();
+
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericT> schedule;
+
+  // unit lower:
+  std::vector<NumericT> x(b), reference(b);
+  viennacl::linalg::host_based::detail::csr_inplace_solve<NumericT>(row_buffer, col_buffer, elements, reference, n, viennacl::linalg::unit_lower_tag());
+  schedule.setup(row_buffer, col_buffer, elements, n, true, true);
+  schedule.solve(x);
+  std::cout << "  " << name << ": " << schedule.levels() << " levels, " << schedule.merged_levels() << " after merging, " << schedule.waits() << " waits, " << schedule.threads() << " threads" << std::endl;
+  CHECK(max_relative_difference(x, reference) <= tolerance, name << ": unit lower triangular solve differs: " << max_relative_difference(x, reference));
+  CHECK(schedule.size() == n && schedule.merged_levels() <= schedule.levels(), name << ": inconsistent schedule");
+
+  // upper:
+  x = b; reference = b;
+  viennacl::linalg::host_based::detail::csr_inplace_solve<NumericT>(row_buffer, col_buffer, elements, reference, n, viennacl::linalg::upper_tag());
+  schedule.setup(row_buffer, col_buffer, elements, n, false, false);
+  schedule.solve(x);
+  CHECK(max_relative_difference(x, reference) <= tolerance, name << ": upper triangular solve differs: " << max_relative_difference(x, reference));
+
+  // lower triangular part of the transpose:
+  x = b; reference = b;
+  viennacl::linalg::host_based::detail::csr_trans_inplace_solve<NumericT>(row_buffer, col_buffer, elements, reference, n, viennacl::linalg::lower_tag());
+  schedule.setup_transposed(row_buffer, col_buffer, elements, n, true, false);
+  schedule.solve(x);
+  CHECK(max_relative_difference(x, reference) <= tolerance, name << ": transposed lower triangular solve differs: " << max_relative_difference(x, reference));
+
+  // unit upper triangular part of the transpose:
+  x = b; reference = b;
+  viennacl::linalg::host_based::detail::csr_trans_inplace_solve<NumericT>(row_buffer, col_buffer, elements, reference, n, viennacl::linalg::unit_upper_tag());
+  schedule.setup_transposed(row_buffer, col_buffer, elements, n, false, true);
+  schedule.solve(x);
+  CHECK(max_relative_difference(x, reference) <= tolerance, name << ": transposed unit upper triangular solve differs: " << max_relative_difference(x, reference));
+
+  // repeated solves with the same schedule:
+  std::vector<NumericT> y(b);
+  schedule.solve(y);
+  CHECK(max_relative_difference(y, x) <= 0, name << ": repeated solve differs");
+
+  return EXIT_SUCCESS;
+}
+
+/** @brief Compares the preconditioners with sequential substitution using factors computed separately */
+template<typename NumericT>
+int check_preconditioners(std::vector<std::map<unsigned int, NumericT> > const & std_A, NumericT tolerance, std::string const & name)
+{
+  std::size_t n = std_A.size();
+  viennacl::compressed_matrix<NumericT> A(n, n);
+  viennacl::copy(std_A, A);
+
+  std::vector<NumericT> b(n);
+  for (std::size_t i = 0; i < n; ++i)
+    b[i] = NumericT(1) + NumericT((i * 7) % 17) / NumericT(7);
+  viennacl::vector<NumericT> vcl_b(n);
+  viennacl::copy(b, vcl_b);
+
+  //
+  // ILU0, with and without level scheduling:
+  //
+  viennacl::compressed_matrix<NumericT> LU(n, n);
+  viennacl::copy(std_A, LU);
+  viennacl::linalg::precondition(LU, viennacl::linalg::ilu0_tag());
+  if (check_schedules(LU, b, tolerance, name) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LU.handle1());
+  unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LU.handle2());
+  NumericT     const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(LU.handle());
+  std::vector<NumericT> reference(b);
+  viennacl::linalg::host_based::detail::csr_inplace_solve<NumericT>(row_buffer, col_buffer, elements, reference, n, viennacl::linalg::unit_lower_tag());
+  viennacl::linalg::host_based::detail::csr_inplace_solve<NumericT>(row_buffer, col_buffer, elements, reference, n, viennacl::linalg::upper_tag());
+
+  for (unsigned int level_scheduling = 0; level_scheduling < 2; ++level_scheduling)
+  {
+    viennacl::linalg::ilu0_precond<viennacl::compressed_matrix<NumericT> > ilu0(A, viennacl::linalg::ilu0_tag(level_scheduling > 0));
+    viennacl::vector<NumericT> x(vcl_b);
+    ilu0.apply(x);
+    CHECK(max_relative_difference(to_std(x), reference) <= tolerance, name << ": ILU0 (level scheduling: " << level_scheduling << ") differs: " << max_relative_difference(to_std(x), reference));
+  }
+
+  //
+  // ILUT:
+  //
+  viennacl::linalg::ilut_tag ilut_config(10, 1e-4);
+  viennacl::compressed_matrix<NumericT> L(n, n), U(n, n);
+  viennacl::linalg::precondition(A, L, U, ilut_config);
+
+  reference = b;
+  viennacl::linalg::host_based::detail::csr_inplace_solve<NumericT>(viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.handle1()),
+                                                                    viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.handle2()),
+                                                                    viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(L.handle()),
+                                                                    reference, n, viennacl::linalg::unit_lower_tag());
+  viennacl::linalg::host_based::detail::csr_inplace_solve<NumericT>(viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.handle1()),
+                                                                    viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.handle2()),
+                                                                    viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(U.handle()),
+                                                                    reference, n, viennacl::linalg::upper_tag());
+
+  viennacl::linalg::ilut_precond<viennacl::compressed_matrix<NumericT> > ilut(A, ilut_config);
+  viennacl::vector<NumericT> x(vcl_b);
+  ilut.apply(x);
+  CHECK(max_relative_difference(to_std(x), reference) <= tolerance, name << ": ILUT differs: " << max_relative_difference(to_std(x), reference));
+
+  //
+  // ICHOL0 (symmetric matrices only):
+  //
+  bool symmetric = true;
+  for (std::size_t row = 0; row < n && symmetric; ++row)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = std_A[row].begin(); it != std_A[row].end(); ++it)
+    {
+      typename std::map<unsigned int, NumericT>::const_iterator transposed = std_A[it->first].find(static_cast<unsigned int>(row));
+      if (transposed == std_A[it->first].end() || transposed->second != it->second)
+        symmetric = false;
+    }
+
+  if (symmetric)
+  {
+    viennacl::compressed_matrix<NumericT> LLT(n, n);
+    viennacl::copy(std_A, LLT);
+    viennacl::linalg::precondition(LLT, viennacl::linalg::ichol0_tag());
+    row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LLT.handle1());
+    col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LLT.handle2());
+    elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(LLT.handle());
+
+    reference = b;
+    viennacl::linalg::host_based::detail::csr_trans_inplace_solve<NumericT>(row_buffer, col_buffer, elements, reference, n, viennacl::linalg::lower_tag());
+    viennacl::linalg::host_based::detail::csr_inplace_solve<NumericT>(row_buffer, col_buffer, elements, reference, n, viennacl::linalg::upper_tag());
+
+    viennacl::linalg::ichol0_tag ichol0_config;
+    viennacl::linalg::ichol0_precond<viennacl::compressed_matrix<NumericT> > ichol0(A, ichol0_config);
+    viennacl::vector<NumericT> x_ichol0(vcl_b);
+    ichol0.apply(x_ichol0);
+    CHECK(max_relative_difference(to_std(x_ichol0), reference) <= tolerance, name << ": ICHOL0 differs: " << max_relative_difference(to_std(x_ichol0), reference));
+  }
+
+  return EXIT_SUCCESS;
+}
+
+template<typename NumericT>
+int test(NumericT tolerance)
+{
+  if (check_preconditioners(generate_laplacian<NumericT>(60, NumericT(0)), tolerance, "Laplacian") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (check_preconditioners(generate_laplacian<NumericT>(60, NumericT(0.3)), tolerance, "Laplacian with convection") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (check_preconditioners(generate_random<NumericT>(20000), tolerance, "random couplings") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (check_preconditioners(generate_tridiagonal<NumericT>(1000), tolerance, "tridiagonal") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+  if (check_preconditioners(generate_tridiagonal<NumericT>(1), tolerance, "1x1") != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Scheduled sparse triangular solves" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: float" << std::endl;
+  if (test<float>(1e-5f) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: double" << std::endl;
+  if (test<double>(1e-13) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
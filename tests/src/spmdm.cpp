@@ -276,6 +276,127 @@ int test(NumericT epsilon)
     return retVal;
   }
 
+  /******************************************************************/
+
+  std::cout << "Testing compressed(CSR) lhs with dense rows * dense rhs" << std::endl;
+  for (std::size_t i=0; i<std_A.size(); i += 3)
+    std_A[std_A.size() / 2][static_cast<unsigned int>(i)] += NumericT(0.25);
+  viennacl::copy(std_A, compressed_A);
+
+  for (std::size_t i=0; i<std_C.size(); ++i)
+    for (std::size_t j=0; j<std_C[i].size(); ++j)
+      std_C[i][j] = 0;
+  compute_reference_result(std_A, std_B, std_C);
+
+  C.clear();
+  C = viennacl::linalg::prod(compressed_A, B1);
+
+  for (std::size_t i=0; i<temp.size(); ++i)
+    for (std::size_t j=0; j<temp[i].size(); ++j)
+      temp[i][j] = 0;
+  viennacl::copy(C, temp);
+  retVal = check_matrices(std_C, temp, epsilon);
+  if (retVal != EXIT_SUCCESS)
+  {
+    std::cerr << "Test failed!" << std::endl;
+    return retVal;
+  }
+
+  std::cout << "Testing compressed(CSR) lhs with dense rows * transposed dense rhs" << std::endl;
+  C.clear();
+  C = viennacl::linalg::prod(compressed_A, viennacl::trans(B2));
+
+  for (std::size_t i=0; i<temp.size(); ++i)
+    for (std::size_t j=0; j<temp[i].size(); ++j)
+      temp[i][j] = 0;
+  viennacl::copy(C, temp);
+  retVal = check_matrices(std_C, temp, epsilon);
+  if (retVal != EXIT_SUCCESS)
+  {
+    std::cerr << "Test failed!" << std::endl;
+    return retVal;
+  }
+
+  /******************************************************************/
+
+  std::cout << "Testing concurrent products with a newly set up compressed(CSR) lhs" << std::endl;
+  {
+    // the row partitions are set up on first use, here by several threads at once:
+    viennacl::compressed_matrix<NumericT> compressed_A_new;
+    viennacl::copy(std_A, compressed_A_new);
+
+    long errors = 0;
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for reduction(+: errors)
+#endif
+    for (long i = 0; i < 8; ++i)
+    {
+      viennacl::matrix<NumericT, ResultLayoutT> C_thread(std_A.size(), cols_rhs);
+      C_thread = viennacl::linalg::prod(compressed_A_new, B1);
+      std::vector<std::vector<NumericT> > temp_thread(std_A.size(), std::vector<NumericT>(cols_rhs));
+      viennacl::copy(C_thread, temp_thread);
+      if (check_matrices(std_C, temp_thread, epsilon) != EXIT_SUCCESS)
+        ++errors;
+    }
+    if (errors > 0)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  /******************************************************************/
+
+  std::cout << "Testing compressed(CSR) lhs * wide dense rhs with alpha and beta" << std::endl;
+  {
+    std::size_t cols_wide = 21;
+    NumericT alpha = NumericT(0.5);
+    NumericT beta  = NumericT(2);
+
+    std::vector<std::vector<NumericT> > std_B_wide(std_A.size(), std::vector<NumericT>(cols_wide));
+    std::vector<std::vector<NumericT> > std_C_wide(std_A.size(), std::vector<NumericT>(cols_wide));
+    std::vector<std::vector<NumericT> > std_C_init(std_A.size(), std::vector<NumericT>(cols_wide));
+    for (std::size_t i = 0; i < std_B_wide.size(); i++)
+      for (std::size_t j = 0; j < cols_wide; j++)
+      {
+        std_B_wide[i][j] = NumericT(0.5) + NumericT(0.1) * randomNumber();
+        std_C_init[i][j] = NumericT(0.5) + NumericT(0.1) * randomNumber();
+      }
+
+    compute_reference_result(std_A, std_B_wide, std_C_wide);
+    for (std::size_t i=0; i<std_C_wide.size(); ++i)
+      for (std::size_t j=0; j<cols_wide; ++j)
+        std_C_wide[i][j] = alpha * std_C_wide[i][j] + beta * std_C_init[i][j];
+
+    viennacl::matrix<NumericT, FactorLayoutT> B_wide(std_A.size(), cols_wide);
+    viennacl::matrix<NumericT, FactorLayoutT> B_wide_trans(cols_wide, std_A.size());
+    viennacl::matrix<NumericT, ResultLayoutT> C_wide(std_A.size(), cols_wide);
+    viennacl::copy(std_B_wide, B_wide);
+    B_wide_trans = viennacl::trans(B_wide);
+
+    std::vector<std::vector<NumericT> > temp_wide(std_A.size(), std::vector<NumericT>(cols_wide));
+
+    viennacl::copy(std_C_init, C_wide);
+    viennacl::linalg::prod_impl(compressed_A, B_wide, alpha, C_wide, beta);
+    viennacl::copy(C_wide, temp_wide);
+    retVal = check_matrices(std_C_wide, temp_wide, epsilon);
+    if (retVal != EXIT_SUCCESS)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      return retVal;
+    }
+
+    viennacl::copy(std_C_init, C_wide);
+    viennacl::linalg::prod_impl(compressed_A, viennacl::trans(B_wide_trans), alpha, C_wide, beta);
+    viennacl::copy(C_wide, temp_wide);
+    retVal = check_matrices(std_C_wide, temp_wide, epsilon);
+    if (retVal != EXIT_SUCCESS)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      return retVal;
+    }
+  }
+
   /******************************************************************/
   if (retVal == EXIT_SUCCESS) {
     std::cout << "Tests passed successfully" << std::endl;
@@ -0,0 +1,237 @@
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the PDF manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** \file tests/src/symmetric_sparse.cpp  Tests symmetric sparse matrices stored as upper triangle (symmetric_compressed_matrix).
+*   \test Tests symmetric sparse matrices stored as upper triangle (symmetric_compressed_matrix): Conversions, matrix-vector products, CG and Lanczos.
+**/
+
+//
+// *** System
+//
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+//
+// *** ViennaCL
+//
+#include "viennacl/vector.hpp"
+#include "viennacl/vector_proxy.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/symmetric_compressed_matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/linalg/cg.hpp"
+#include "viennacl/linalg/lanczos.hpp"
+#include "viennacl/tools/sparse_format.hpp"
+
+
+#define CHECK(cond, msg) if (!(cond)) { std::cout << "# Error: " << msg << std::endl; return EXIT_FAILURE; }
+
+template<typename NumericT>
+NumericT diff(std::vector<NumericT> const & v1, viennacl::vector_base<NumericT> const & v2)
+{
+  std::vector<NumericT> v2_cpu(v2.size());
+  viennacl::copy(v2, v2_cpu);
+
+  NumericT norm_inf = 0;
+  for (std::size_t i=0; i<v1.size(); ++i)
+    norm_inf = std::max<NumericT>(norm_inf, std::fabs(v1[i] - v2_cpu[i]) / std::max<NumericT>(1, std::fabs(v1[i])));
+  return norm_inf;
+}
+
+/** @brief Reference product y = A * x with the host matrix */
+template<typename NumericT>
+std::vector<NumericT> reference_prod(std::vector<std::map<unsigned int, NumericT> > const & A, std::vector<NumericT> const & x)
+{
+  std::vector<NumericT> y(A.size());
+  for (std::size_t i=0; i<A.size(); ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = A[i].begin(); it != A[i].end(); ++it)
+      y[i] += it->second * x[it->first];
+  return y;
+}
+
+/** @brief Sets up a symmetric positive definite matrix: The five-point finite difference Laplacian on a points x points grid
+*   with additional long-range couplings and a dense first row and column, made diagonally dominant.
+*/
+template<typename NumericT>
+std::vector<std::map<unsigned int, NumericT> > generate_symmetric_matrix(std::size_t points)
+{
+  std::size_t n = points * points;
+  std::vector<std::map<unsigned int, NumericT> > A(n);
+
+  for (std::size_t row = 0; row < n; ++row)
+  {
+    std::size_t i = row % points;
+    std::size_t j = row / points;
+    if (i + 1 < points) { A[row][static_cast<unsigned int>(row + 1)]      = NumericT(-1); A[row + 1][static_cast<unsigned int>(row)]      = NumericT(-1); }
+    if (j + 1 < points) { A[row][static_cast<unsigned int>(row + points)] = NumericT(-1); A[row + points][static_cast<unsigned int>(row)] = NumericT(-1); }
+    if (row % 5 == 0 && row + n / 2 < n) { A[row][static_cast<unsigned int>(row + n / 2)] = NumericT(-0.5); A[row + n / 2][static_cast<unsigned int>(row)] = NumericT(-0.5); }
+    if (row > 0 && row % 7 == 0) { A[0][static_cast<unsigned int>(row)] = NumericT(-0.01); A[row][0] = NumericT(-0.01); }
+  }
+
+  for (std::size_t row = 0; row < n; ++row)
+  {
+    NumericT off_diagonal_sum = 0;
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = A[row].begin(); it != A[row].end(); ++it)
+      off_diagonal_sum += std::fabs(it->second);
+    A[row][static_cast<unsigned int>(row)] = off_diagonal_sum + NumericT(1 + row % 5);
+  }
+  return A;
+}
+
+template<typename NumericT>
+int test(NumericT eps, NumericT solver_tolerance)
+{
+  std::size_t points = 73;
+  std::vector<std::map<unsigned int, NumericT> > std_A = generate_symmetric_matrix<NumericT>(points);
+  std::size_t n = std_A.size();
+
+  std::size_t upper_nnz = 0;
+  for (std::size_t i=0; i<n; ++i)
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = std_A[i].begin(); it != std_A[i].end(); ++it)
+      if (it->first >= i)
+        ++upper_nnz;
+
+  std::vector<NumericT> std_x(n);
+  for (std::size_t i=0; i<n; ++i)
+    std_x[i] = NumericT(1) + NumericT(i % 11) / NumericT(7);
+  std::vector<NumericT> std_y = reference_prod(std_A, std_x);
+
+  viennacl::vector<NumericT> x(n);
+  viennacl::copy(std_x, x);
+
+  //
+  // setup and copy back:
+  //
+  viennacl::symmetric_compressed_matrix<NumericT> A;
+  viennacl::copy(std_A, A);
+  CHECK(A.size1() == n && A.size2() == n, "wrong size after copy");
+  CHECK(A.nnz() == upper_nnz, "wrong number of stored entries: " << A.nnz() << " vs. " << upper_nnz);
+
+  std::vector<std::map<unsigned int, NumericT> > std_A2;
+  viennacl::copy(A, std_A2);
+  CHECK(std_A2.size() == n, "wrong number of rows after copy to host");
+  for (std::size_t i=0; i<n; ++i)
+  {
+    CHECK(std_A2[i].size() == std_A[i].size(), "wrong number of entries in row " << i << " after copy to host");
+    for (typename std::map<unsigned int, NumericT>::const_iterator it = std_A[i].begin(); it != std_A[i].end(); ++it)
+      CHECK(std_A2[i][it->first] <= it->second && std_A2[i][it->first] >= it->second, "wrong entry (" << i << ", " << it->first << ") after copy to host");
+  }
+
+  //
+  // matrix-vector products:
+  //
+  viennacl::vector<NumericT> y = viennacl::linalg::prod(A, x);
+  CHECK(diff(std_y, y) < eps, "wrong result of y = prod(A, x)");
+
+  y += viennacl::linalg::prod(A, x);
+  for (std::size_t i=0; i<n; ++i)
+    std_y[i] *= NumericT(2);
+  CHECK(diff(std_y, y) < eps, "wrong result of y += prod(A, x)");
+
+  y -= viennacl::linalg::prod(A, x);
+  for (std::size_t i=0; i<n; ++i)
+    std_y[i] /= NumericT(2);
+  CHECK(diff(std_y, y) < eps, "wrong result of y -= prod(A, x)");
+
+  viennacl::linalg::prod_impl(A, x, NumericT(2), y, NumericT(-3));
+  for (std::size_t i=0; i<n; ++i)
+    std_y[i] = NumericT(2) * std_y[i] - NumericT(3) * std_y[i];
+  CHECK(diff(std_y, y) < eps, "wrong result of y = 2 * prod(A, x) - 3 * y");
+
+  std_y = reference_prod(std_A, std_x);
+  viennacl::vector<NumericT> z(x);
+  z = viennacl::linalg::prod(A, z);
+  CHECK(diff(std_y, z) < eps, "wrong result of x = prod(A, x)");
+
+  viennacl::vector<NumericT> x_strided(2 * n);
+  viennacl::vector<NumericT> y_strided(3 * n);
+  viennacl::vector_slice<viennacl::vector<NumericT> > x_slice(x_strided, viennacl::slice(1, 2, n));
+  viennacl::vector_slice<viennacl::vector<NumericT> > y_slice(y_strided, viennacl::slice(2, 3, n));
+  x_slice = x;
+  y_slice = viennacl::linalg::prod(A, x_slice);
+  CHECK(diff(std_y, y_slice) < eps, "wrong result of y = prod(A, x) for strided vectors");
+
+  //
+  // conversion from compressed_matrix:
+  //
+  viennacl::compressed_matrix<NumericT> A_csr(n, n);
+  viennacl::copy(std_A, A_csr);
+  viennacl::symmetric_compressed_matrix<NumericT> A_converted;
+  viennacl::tools::convert(A_csr, A_converted);
+  CHECK(A_converted.nnz() == upper_nnz, "wrong number of stored entries after conversion from compressed_matrix");
+  y = viennacl::linalg::prod(A_converted, x);
+  CHECK(diff(std_y, y) < eps, "wrong result of y = prod(A, x) after conversion from compressed_matrix");
+
+  //
+  // conjugate gradients:
+  //
+  viennacl::vector<NumericT> b = viennacl::scalar_vector<NumericT>(n, NumericT(1));
+  viennacl::linalg::cg_tag cg_tag(solver_tolerance, 1000);
+  viennacl::vector<NumericT> result = viennacl::linalg::solve(A, b, cg_tag);
+  viennacl::vector<NumericT> residual = viennacl::linalg::prod(A_csr, result);
+  residual -= b;
+  NumericT relative_residual = viennacl::linalg::norm_2(residual) / viennacl::linalg::norm_2(b);
+  CHECK(relative_residual < NumericT(10) * solver_tolerance, "CG did not converge, relative residual: " << relative_residual);
+
+  //
+  // Lanczos:
+  //
+  viennacl::linalg::lanczos_tag lanczos_tag(0.75, 4, viennacl::linalg::lanczos_tag::full_reorthogonalization, 60);
+  std::vector<NumericT> eigenvalues     = viennacl::linalg::eig(A, lanczos_tag);
+  std::vector<NumericT> eigenvalues_csr = viennacl::linalg::eig(A_csr, lanczos_tag);
+  for (std::size_t i=0; i<eigenvalues.size(); ++i)
+    CHECK(std::fabs(eigenvalues[i] - eigenvalues_csr[i]) < NumericT(1e-3) * std::fabs(eigenvalues_csr[i]),
+          "eigenvalue " << i << " differs from the one computed with compressed_matrix: " << eigenvalues[i] << " vs. " << eigenvalues_csr[i]);
+
+  return EXIT_SUCCESS;
+}
+
+//
+// -------------------------------------------------------------
+//
+int main()
+{
+  std::cout << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Test :: Symmetric sparse matrices" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: float" << std::endl;
+  if (test<float>(1e-5f, 1e-5f) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << "# Testing setup:" << std::endl;
+  std::cout << "  numeric: double" << std::endl;
+  if (test<double>(1e-12, 1e-10) != EXIT_SUCCESS)
+    return EXIT_FAILURE;
+
+  std::cout << std::endl;
+  std::cout << "------- Test completed --------" << std::endl;
+  std::cout << std::endl;
+
+  return EXIT_SUCCESS;
+}
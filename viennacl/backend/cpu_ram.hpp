@@ -22,15 +22,45 @@
     @brief Implementations for the OpenCL backend functionality
 */
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
 #include <vector>
-#ifdef VIENNACL_WITH_AVX2
-#include <stdlib.h>
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#include <malloc.h>
 #endif
 
 #include "viennacl/forwards.h"
 #include "viennacl/tools/shared_ptr.hpp"
 
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+// SSE2 is part of the base instruction set on x86-64, hence non-temporal stores are available without runtime checks:
+#if !defined(VIENNACL_HOST_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define VIENNACL_CPU_RAM_STREAMING_STORES
+  #include <emmintrin.h>
+#endif
+
+// Transfers of fewer bytes are carried out by a single memcpy(), larger transfers are split into contiguous chunks copied by all threads:
+#ifndef VIENNACL_CPU_RAM_PARALLEL_COPY_THRESHOLD
+  #define VIENNACL_CPU_RAM_PARALLEL_COPY_THRESHOLD  (1 << 20)
+#endif
+
+// Transfers of at least this many bytes exceed typical last-level caches and bypass the cache via non-temporal stores:
+#ifndef VIENNACL_CPU_RAM_STREAMING_COPY_THRESHOLD
+  #define VIENNACL_CPU_RAM_STREAMING_COPY_THRESHOLD  (1 << 24)
+#endif
+
+// Default for the maximum number of bytes a memory_pool keeps in idle blocks for reuse:
+#ifndef VIENNACL_CPU_RAM_POOL_HIGH_WATER_MARK
+  #define VIENNACL_CPU_RAM_POOL_HIGH_WATER_MARK  (vcl_size_t(1) << 28)
+#endif
+
 namespace viennacl
 {
 namespace backend
@@ -49,50 +79,368 @@ typedef viennacl::tools::shared_ptr<char>  handle_type;
 // *
 //
 
+/** @brief Alignment (in bytes) of all buffers in main RAM. Suitable for aligned loads and stores of up to 512-bit SIMD registers. */
+static const vcl_size_t buffer_alignment = 64;
+
 namespace detail
 {
+  /** @brief Allocates memory aligned to buffer_alignment. The alignment is guaranteed independent of the instruction set selected at runtime. */
+  inline char * aligned_allocate(vcl_size_t size_in_bytes)
+  {
+    void * ptr = NULL;
+#if defined(_MSC_VER) || defined(__MINGW32__)
+    ptr = _aligned_malloc(size_in_bytes > 0 ? size_in_bytes : 1, buffer_alignment);
+#else
+    if (posix_memalign(&ptr, buffer_alignment, size_in_bytes > 0 ? size_in_bytes : 1) != 0)
+      ptr = NULL;
+#endif
+    if (!ptr)
+      throw std::bad_alloc();
+    return static_cast<char *>(ptr);
+  }
+
   /** @brief Helper struct for deleting an pointer to an array */
   template<class U>
   struct array_deleter
   {
-#ifdef VIENNACL_WITH_AVX2
+#if defined(_MSC_VER) || defined(__MINGW32__)
+    void operator()(U* p) const { _aligned_free(p); }
+#else
     void operator()(U* p) const { free(p); }
+#endif
+  };
+
+  /** @brief Copies 'bytes' bytes using non-temporal stores, so that the destination does not evict the working set from the caches. */
+  inline void streaming_copy(char * dst, const char * src, vcl_size_t bytes)
+  {
+#ifdef VIENNACL_CPU_RAM_STREAMING_STORES
+    // non-temporal stores require an aligned destination:
+    vcl_size_t head = (16 - reinterpret_cast<vcl_size_t>(dst) % 16) % 16;
+    if (head >= bytes)
+    {
+      std::memcpy(dst, src, bytes);
+      return;
+    }
+    std::memcpy(dst, src, head);
+
+    vcl_size_t blocks = (bytes - head) / 64;
+    __m128i       * dst_vec = reinterpret_cast<__m128i *>(dst + head);
+    __m128i const * src_vec = reinterpret_cast<__m128i const *>(src + head);
+    for (vcl_size_t i = 0; i < blocks; ++i, dst_vec += 4, src_vec += 4)
+    {
+      __m128i r0 = _mm_loadu_si128(src_vec);
+      __m128i r1 = _mm_loadu_si128(src_vec + 1);
+      __m128i r2 = _mm_loadu_si128(src_vec + 2);
+      __m128i r3 = _mm_loadu_si128(src_vec + 3);
+      _mm_stream_si128(dst_vec,     r0);
+      _mm_stream_si128(dst_vec + 1, r1);
+      _mm_stream_si128(dst_vec + 2, r2);
+      _mm_stream_si128(dst_vec + 3, r3);
+    }
+    _mm_sfence(); // make the non-temporal stores visible to other threads
+
+    vcl_size_t done = head + 64 * blocks;
+    std::memcpy(dst + done, src + done, bytes - done);
 #else
-    void operator()(U* p) const { delete[] p; }
+    std::memcpy(dst, src, bytes);
 #endif
+  }
+
+  /** @brief Copies 'bytes' bytes from 'src' to 'dst'. The two ranges must not overlap.
+  *
+  * Small transfers use memcpy() directly to avoid the overhead of spawning threads. Large transfers are split into one contiguous chunk per thread,
+  * which also places the pages of freshly allocated destinations close to the threads later operating on them (first-touch policy).
+  * Transfers larger than the caches use non-temporal stores.
+  */
+  inline void copy_bytes(char * dst, const char * src, vcl_size_t bytes)
+  {
+    if (bytes < VIENNACL_CPU_RAM_PARALLEL_COPY_THRESHOLD)
+    {
+      if (bytes > 0)
+        std::memcpy(dst, src, bytes);
+      return;
+    }
+
+    bool streaming = (bytes >= VIENNACL_CPU_RAM_STREAMING_COPY_THRESHOLD);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel
+#endif
+    {
+      vcl_size_t id = 0;
+      vcl_size_t num_threads = 1;
+#ifdef VIENNACL_WITH_OPENMP
+      id          = static_cast<vcl_size_t>(omp_get_thread_num());
+      num_threads = static_cast<vcl_size_t>(omp_get_num_threads());
+#endif
+      // chunk boundaries on cache lines, so that no two threads write to the same line:
+      vcl_size_t chunk_begin = ((bytes * id)       / num_threads) / 64 * 64;
+      vcl_size_t chunk_end   = (id + 1 == num_threads) ? bytes : ((bytes * (id + 1)) / num_threads) / 64 * 64;
+
+      if (streaming)
+        streaming_copy(dst + chunk_begin, src + chunk_begin, chunk_end - chunk_begin);
+      else
+        std::memcpy(dst + chunk_begin, src + chunk_begin, chunk_end - chunk_begin);
+    }
+  }
+
+  /** @brief Touches each page of a freshly allocated buffer from the thread which operates on the respective part of the buffer in a static parallel loop.
+  *
+  * Operating systems with a first-touch policy (e.g. Linux) thus place the pages on the NUMA node of that thread rather than on the node of the allocating thread.
+  * Only applied if OpenMP is enabled and the buffer is large enough for parallel processing.
+  */
+  inline void first_touch(char * ptr, vcl_size_t bytes)
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    if (bytes < VIENNACL_CPU_RAM_PARALLEL_COPY_THRESHOLD || omp_get_max_threads() < 2)
+      return;
+
+    vcl_size_t const page_size = 4096;
+    #pragma omp parallel for schedule(static)
+    for (long page = 0; page < static_cast<long>((bytes + page_size - 1) / page_size); ++page)
+      ptr[vcl_size_t(page) * page_size] = 0;
+#else
+    (void)ptr; (void)bytes;
+#endif
+  }
+
+}
+
+/** @brief Usage statistics of a memory_pool */
+struct memory_pool_statistics
+{
+  memory_pool_statistics() : allocations(0), cache_hits(0), bytes_in_use(0), peak_bytes_in_use(0), bytes_cached(0) {}
+
+  vcl_size_t allocations;         // number of buffers handed out
+  vcl_size_t cache_hits;          // number of buffers handed out by reusing an idle block
+  vcl_size_t bytes_in_use;        // bytes currently handed out (rounded up to the size classes)
+  vcl_size_t peak_bytes_in_use;   // maximum of bytes_in_use so far
+  vcl_size_t bytes_cached;        // bytes currently held in idle blocks
+};
+
+namespace detail
+{
+  /** @brief Rounds a buffer size up to the size class of a memory_pool. Four size classes per power of two keep the overhead below 25 percent. */
+  inline vcl_size_t memory_pool_size_class(vcl_size_t size_in_bytes)
+  {
+    if (size_in_bytes <= buffer_alignment)
+      return buffer_alignment;
+
+    vcl_size_t lower = buffer_alignment;
+    while (2 * lower < size_in_bytes)
+      lower *= 2;
+    vcl_size_t step = lower / 4;
+    return ((size_in_bytes + step - 1) / step) * step;
+  }
+
+  /** @brief Internal state of a memory_pool.
+  *
+  * Buffers must not outlive the pool, since memory handles and contexts refer to the pool itself. As a safeguard against leaks, blocks still in use when the pool is destroyed
+  * are freed directly on release, which is why the state is kept until the last block is returned.
+  */
+  struct memory_pool_state
+  {
+    memory_pool_state(vcl_size_t hwm) : high_water_mark(hwm), blocks_in_use(0), closed(false) {}
+
+    /** @brief Frees idle blocks (largest first) until at most 'max_bytes_cached' bytes are cached. Must be called from within the critical section. */
+    void release_cached(vcl_size_t max_bytes_cached)
+    {
+      while (stats.bytes_cached > max_bytes_cached && !free_blocks.empty())
+      {
+        std::map<vcl_size_t, std::vector<char *> >::iterator it = free_blocks.end();
+        --it;
+        array_deleter<char>()(it->second.back());
+        it->second.pop_back();
+        stats.bytes_cached -= it->first;
+        if (it->second.empty())
+          free_blocks.erase(it);
+      }
+    }
+
+    vcl_size_t high_water_mark;
+    vcl_size_t blocks_in_use;
+    bool       closed;
+    std::map<vcl_size_t, std::vector<char *> > free_blocks;  // size class -> idle blocks
+    memory_pool_statistics stats;
   };
 
+  /** @brief Deleter of buffers handed out by a memory_pool: Returns the block to the pool unless this exceeds the high-water mark. */
+  struct memory_pool_deleter
+  {
+    memory_pool_deleter(memory_pool_state * state, vcl_size_t size_class) : state_(state), size_class_(size_class) {}
+
+    void operator()(char * p) const
+    {
+      bool delete_state = false;
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp critical(viennacl_cpu_ram_pool)
+#endif
+      {
+        state_->stats.bytes_in_use -= size_class_;
+        --state_->blocks_in_use;
+        if (!state_->closed && state_->stats.bytes_cached + size_class_ <= state_->high_water_mark)
+        {
+          state_->free_blocks[size_class_].push_back(p);
+          state_->stats.bytes_cached += size_class_;
+          p = NULL;
+        }
+        delete_state = (state_->closed && state_->blocks_in_use == 0);
+      }
+
+      if (p)
+        array_deleter<char>()(p);
+      if (delete_state)
+        delete state_;
+    }
+
+  private:
+    memory_pool_state * state_;
+    vcl_size_t          size_class_;
+  };
 }
 
+/** @brief A size-class memory pool for buffers in main RAM.
+*
+* Buffers released by the user are kept in idle blocks (up to the high-water mark) and handed out again for subsequent requests of the same size class.
+* This avoids the cost of malloc/free and page faults for temporaries created over and over again, e.g. in iterative solvers on small systems.
+* Pass the pool to a viennacl::context to use it for all objects created in that context, including temporaries derived from these objects:
+*
+*   viennacl::backend::cpu_ram::memory_pool pool;
+*   viennacl::context ctx(pool);
+*   viennacl::vector<double> x(n, ctx);
+*
+* The pool must outlive the objects created in its context. Allocations and releases from multiple OpenMP threads are safe.
+*/
+class memory_pool
+{
+public:
+  explicit memory_pool(vcl_size_t high_water_mark = VIENNACL_CPU_RAM_POOL_HIGH_WATER_MARK) : state_(new detail::memory_pool_state(high_water_mark)) {}
+
+  ~memory_pool()
+  {
+    bool delete_state = false;
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp critical(viennacl_cpu_ram_pool)
+#endif
+    {
+      state_->closed = true;
+      state_->release_cached(0);
+      delete_state = (state_->blocks_in_use == 0);
+    }
+    if (delete_state)
+      delete state_;
+  }
+
+  /** @brief Returns a buffer of at least 'size_in_bytes' bytes, reusing an idle block of the same size class if available. The content of the buffer is undefined. */
+  handle_type allocate(vcl_size_t size_in_bytes)
+  {
+    vcl_size_t size_class = detail::memory_pool_size_class(size_in_bytes);
+    char * ptr = NULL;
+    handle_type result;
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp critical(viennacl_cpu_ram_pool)
+#endif
+    {
+      std::map<vcl_size_t, std::vector<char *> >::iterator it = state_->free_blocks.find(size_class);
+      if (it != state_->free_blocks.end())
+      {
+        ptr = it->second.back();
+        it->second.pop_back();
+        if (it->second.empty())
+          state_->free_blocks.erase(it);
+        state_->stats.bytes_cached -= size_class;
+        ++state_->stats.cache_hits;
+      }
+    }
+
+    bool fresh = (ptr == NULL);
+    if (fresh)
+      ptr = detail::aligned_allocate(size_class);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp critical(viennacl_cpu_ram_pool)
+#endif
+    {
+      result = handle_type(ptr, detail::memory_pool_deleter(state_, size_class));
+      ++state_->blocks_in_use;
+      ++state_->stats.allocations;
+      state_->stats.bytes_in_use += size_class;
+      state_->stats.peak_bytes_in_use = std::max(state_->stats.peak_bytes_in_use, state_->stats.bytes_in_use);
+    }
+
+    if (fresh)
+      detail::first_touch(ptr, size_class);
+
+    return result;
+  }
+
+  /** @brief Frees idle blocks until at most 'max_bytes_cached' bytes remain cached. Call without argument to release all idle blocks. */
+  void trim(vcl_size_t max_bytes_cached = 0)
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp critical(viennacl_cpu_ram_pool)
+#endif
+    state_->release_cached(max_bytes_cached);
+  }
+
+  /** @brief Returns the maximum number of bytes kept in idle blocks */
+  vcl_size_t high_water_mark() const { return state_->high_water_mark; }
+
+  /** @brief Sets the maximum number of bytes kept in idle blocks. Idle blocks exceeding the new limit are freed. */
+  void high_water_mark(vcl_size_t new_high_water_mark)
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp critical(viennacl_cpu_ram_pool)
+#endif
+    {
+      state_->high_water_mark = new_high_water_mark;
+      state_->release_cached(new_high_water_mark);
+    }
+  }
+
+  /** @brief Returns the usage statistics of the pool */
+  memory_pool_statistics statistics() const
+  {
+    memory_pool_statistics result;
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp critical(viennacl_cpu_ram_pool)
+#endif
+    result = state_->stats;
+    return result;
+  }
+
+private:
+  memory_pool(memory_pool const &);
+  memory_pool & operator=(memory_pool const &);
+
+  detail::memory_pool_state * state_;
+};
+
+
 /** @brief Creates an array of the specified size in main RAM. If the second argument is provided, the buffer is initialized with data from that pointer.
  *
  * @param size_in_bytes   Number of bytes to allocate
  * @param host_ptr        Pointer to data which will be copied to the new array. Must point to at least 'size_in_bytes' bytes of data.
+ * @param pool            Optional memory pool from which the array is obtained
  *
  */
-inline handle_type  memory_create(vcl_size_t size_in_bytes, const void * host_ptr = NULL)
+inline handle_type  memory_create(vcl_size_t size_in_bytes, const void * host_ptr = NULL, memory_pool * pool = NULL)
 {
-#ifdef VIENNACL_WITH_AVX2
-  // Note: aligned_alloc not available on all compilers. Consider platform-specific alternatives such as posix_memalign()
-  if (!host_ptr)
-    return handle_type(reinterpret_cast<char*>(aligned_alloc(32, size_in_bytes)), detail::array_deleter<char>());
+  if (pool)
+  {
+    handle_type new_handle = pool->allocate(size_in_bytes);
+    if (host_ptr)
+      detail::copy_bytes(new_handle.get(), static_cast<const char *>(host_ptr), size_in_bytes);
+    return new_handle;
+  }
 
-  handle_type new_handle(reinterpret_cast<char*>(aligned_alloc(32, size_in_bytes)), detail::array_deleter<char>());
-#else
-  if (!host_ptr)
-    return handle_type(new char[size_in_bytes], detail::array_deleter<char>());
+  handle_type new_handle(detail::aligned_allocate(size_in_bytes), detail::array_deleter<char>());
 
-  handle_type new_handle(new char[size_in_bytes], detail::array_deleter<char>());
-#endif
-
-  // copy data:
-  char * raw_ptr = new_handle.get();
-  const char * data_ptr = static_cast<const char *>(host_ptr);
-#ifdef VIENNACL_WITH_OPENMP
-    #pragma omp parallel for
-#endif
-  for (long i=0; i<long(size_in_bytes); ++i)
-    raw_ptr[i] = data_ptr[i];
+  if (host_ptr)
+    detail::copy_bytes(new_handle.get(), static_cast<const char *>(host_ptr), size_in_bytes); // also takes care of first touch
+  else
+    detail::first_touch(new_handle.get(), size_in_bytes);
 
   return new_handle;
 }
@@ -114,11 +462,12 @@ inline void memory_copy(handle_type const & src_buffer,
   assert( (dst_buffer.get() != NULL) && bool("Memory not initialized!"));
   assert( (src_buffer.get() != NULL) && bool("Memory not initialized!"));
 
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-  for (long i=0; i<long(bytes_to_copy); ++i)
-    dst_buffer.get()[vcl_size_t(i)+dst_offset] = src_buffer.get()[vcl_size_t(i) + src_offset];
+  char       * dst = dst_buffer.get() + dst_offset;
+  const char * src = src_buffer.get() + src_offset;
+  if (src_buffer.get() == dst_buffer.get() && dst < src + bytes_to_copy && src < dst + bytes_to_copy) // overlapping ranges within the same buffer
+    std::memmove(dst, src, bytes_to_copy);
+  else
+    detail::copy_bytes(dst, src, bytes_to_copy);
 }
 
 /** @brief Writes data from main RAM identified by 'ptr' to the buffer identified by 'dst_buffer'
@@ -136,11 +485,7 @@ inline void memory_write(handle_type & dst_buffer,
 {
   assert( (dst_buffer.get() != NULL) && bool("Memory not initialized!"));
 
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-  for (long i=0; i<long(bytes_to_copy); ++i)
-    dst_buffer.get()[vcl_size_t(i)+dst_offset] = static_cast<const char *>(ptr)[i];
+  detail::copy_bytes(dst_buffer.get() + dst_offset, static_cast<const char *>(ptr), bytes_to_copy);
 }
 
 /** @brief Reads data from a buffer back to main RAM.
@@ -158,11 +503,7 @@ inline void memory_read(handle_type const & src_buffer,
 {
   assert( (src_buffer.get() != NULL) && bool("Memory not initialized!"));
 
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-  for (long i=0; i<long(bytes_to_copy); ++i)
-    static_cast<char *>(ptr)[i] = src_buffer.get()[vcl_size_t(i)+src_offset];
+  detail::copy_bytes(static_cast<char *>(ptr), src_buffer.get() + src_offset, bytes_to_copy);
 }
 
 }
@@ -93,13 +93,18 @@ public:
   typedef viennacl::tools::shared_ptr<char>      cuda_handle_type;
 
   /** @brief Default CTOR. No memory is allocated */
-  mem_handle() : active_handle_(MEMORY_NOT_INITIALIZED), size_in_bytes_(0) {}
+  mem_handle() : active_handle_(MEMORY_NOT_INITIALIZED), ram_memory_pool_(NULL), size_in_bytes_(0) {}
 
   /** @brief Returns the handle to a buffer in CPU RAM. NULL is returned if no such buffer has been allocated. */
   ram_handle_type       & ram_handle()       { return ram_handle_; }
   /** @brief Returns the handle to a buffer in CPU RAM. NULL is returned if no such buffer has been allocated. */
   ram_handle_type const & ram_handle() const { return ram_handle_; }
 
+  /** @brief Returns the memory pool the buffer in CPU RAM has been obtained from. NULL if the buffer has not been obtained from a pool. The pool must outlive the buffer. */
+  viennacl::backend::cpu_ram::memory_pool * ram_memory_pool() const { return ram_memory_pool_; }
+  /** @brief Sets the memory pool the buffer in CPU RAM has been obtained from. Temporaries derived from this buffer are obtained from the same pool. */
+  void ram_memory_pool(viennacl::backend::cpu_ram::memory_pool * pool) { ram_memory_pool_ = pool; }
+
 #ifdef VIENNACL_WITH_OPENCL
   /** @brief Returns the handle to an OpenCL buffer. The handle contains NULL if no such buffer has been allocated. */
   viennacl::ocl::handle<cl_mem>       & opencl_handle()       { return opencl_handle_; }
@@ -215,6 +220,10 @@ public:
     other.ram_handle_ = ram_handle_;
     ram_handle_ = ram_handle_tmp;
 
+    viennacl::backend::cpu_ram::memory_pool * ram_memory_pool_tmp = other.ram_memory_pool_;
+    other.ram_memory_pool_ = ram_memory_pool_;
+    ram_memory_pool_ = ram_memory_pool_tmp;
+
     // swap OpenCL handle:
 #ifdef VIENNACL_WITH_OPENCL
     opencl_handle_.swap(other.opencl_handle_);
@@ -235,6 +244,7 @@ public:
 private:
   memory_types active_handle_;
   ram_handle_type ram_handle_;
+  viennacl::backend::cpu_ram::memory_pool * ram_memory_pool_;
 #ifdef VIENNACL_WITH_OPENCL
   viennacl::ocl::handle<cl_mem> opencl_handle_;
 #endif
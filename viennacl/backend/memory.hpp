@@ -94,7 +94,8 @@ namespace backend
       switch (handle.get_active_handle_id())
       {
       case MAIN_MEMORY:
-        handle.ram_handle() = cpu_ram::memory_create(size_in_bytes, host_ptr);
+        handle.ram_handle() = cpu_ram::memory_create(size_in_bytes, host_ptr, ctx.host_memory_pool());
+        handle.ram_memory_pool(ctx.host_memory_pool());
         handle.raw_size(size_in_bytes);
         break;
 #ifdef VIENNACL_WITH_OPENCL
@@ -184,6 +185,7 @@ namespace backend
     case MAIN_MEMORY:
       dst_buffer.switch_active_handle_id(src_buffer.get_active_handle_id());
       dst_buffer.ram_handle() = src_buffer.ram_handle();
+      dst_buffer.ram_memory_pool(src_buffer.ram_memory_pool());
       dst_buffer.raw_size(src_buffer.raw_size());
       break;
 #ifdef VIENNACL_WITH_OPENCL
@@ -418,6 +420,7 @@ namespace backend
         {
         case MAIN_MEMORY:
           handle.ram_handle() = cpu_ram::memory_create(handle.raw_size());
+          handle.ram_memory_pool(NULL);
           opencl::memory_read(handle.opencl_handle(), 0, handle.raw_size(), handle.ram_handle().get());
           break;
 #ifdef VIENNACL_WITH_CUDA
@@ -442,6 +445,7 @@ namespace backend
         {
         case MAIN_MEMORY:
           handle.ram_handle() = cpu_ram::memory_create(handle.raw_size());
+          handle.ram_memory_pool(NULL);
           cuda::memory_read(handle.cuda_handle(), 0, handle.raw_size(), handle.ram_handle().get());
           break;
 #ifdef VIENNACL_WITH_OPENCL
@@ -0,0 +1,431 @@
+#ifndef VIENNACL_BLOCK_COMPRESSED_MATRIX_HPP_
+#define VIENNACL_BLOCK_COMPRESSED_MATRIX_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/block_compressed_matrix.hpp
+    @brief Implementation of the block_compressed_matrix class (block compressed sparse row format, BSR)
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+
+#include "viennacl/tools/tools.hpp"
+
+#include "viennacl/linalg/sparse_matrix_operations.hpp"
+
+namespace viennacl
+{
+/** @brief Sparse matrix class using the block compressed sparse row (BSR) format for storing dense blocks of size BlockSize x BlockSize.
+    *
+    * Systems of partial differential equations with several unknowns per mesh node (e.g. displacements in structural mechanics
+    * or the conserved quantities in multi-component flow) result in matrices made up of small dense blocks.
+    * Storing one column index per block rather than per entry reduces the memory traffic of matrix-vector products,
+    * and the products of the dense blocks with the vector are computed by small dense kernels.
+    *
+    * The format is the compressed sparse row format applied to blocks: handle1() holds the offsets of the block rows,
+    * handle2() holds the block column indices (sorted within each block row), and handle() holds the entries of the blocks.
+    * Each block is stored column by column, i.e. entry (r, c) of the k-th block is located at k * BlockSize * BlockSize + c * BlockSize + r.
+    * Entries within a nonzero block which are zero in the original matrix are stored explicitly.
+    *
+    * The number of rows and columns must be multiples of BlockSize.
+    * Matrix-vector products are available for the host and the OpenCL backend, the CUDA backend does not support this format yet.
+    */
+template<typename NumericT, unsigned int BlockSize>
+class block_compressed_matrix
+{
+public:
+  typedef viennacl::backend::mem_handle                                                              handle_type;
+  typedef scalar<typename viennacl::tools::CHECK_SCALAR_TEMPLATE_ARGUMENT<NumericT>::ResultType>   value_type;
+  typedef vcl_size_t                                                                                 size_type;
+
+  block_compressed_matrix() : rows_(0), cols_(0), nonzero_blocks_(0) {}
+
+  explicit block_compressed_matrix(viennacl::context ctx) : rows_(0), cols_(0), nonzero_blocks_(0)
+  {
+    init_context(ctx);
+  }
+
+  /** @brief Construction of a block compressed matrix with the supplied number of rows and columns. Both must be multiples of BlockSize.
+  *
+  * @param rows     Number of rows
+  * @param cols     Number of columns
+  * @param ctx      Optional context in which the matrix is created (one out of multiple OpenCL contexts, CUDA, host)
+  */
+  block_compressed_matrix(vcl_size_t rows, vcl_size_t cols, viennacl::context ctx = viennacl::context())
+    : rows_(rows), cols_(cols), nonzero_blocks_(0)
+  {
+    assert(rows % BlockSize == 0 && cols % BlockSize == 0 && bool("Matrix dimensions must be multiples of the block size!"));
+    init_context(ctx);
+  }
+
+  /** @brief Sets the matrix from the three arrays of the BSR format in main memory.
+  *
+  * @param row_blocks      Offsets of the block rows, rows / BlockSize + 1 entries
+  * @param col_blocks      Block column indices, nonzero_blocks entries
+  * @param elements        Entries of the blocks (each stored column by column), nonzero_blocks * BlockSize * BlockSize entries
+  * @param rows            Number of rows
+  * @param cols            Number of columns
+  * @param nonzero_blocks  Number of nonzero blocks
+  */
+  void set(unsigned int const * row_blocks, unsigned int const * col_blocks, NumericT const * elements,
+           vcl_size_t rows, vcl_size_t cols, vcl_size_t nonzero_blocks)
+  {
+    assert(rows % BlockSize == 0 && cols % BlockSize == 0 && bool("Matrix dimensions must be multiples of the block size!"));
+
+    rows_ = rows;
+    cols_ = cols;
+    nonzero_blocks_ = nonzero_blocks;
+
+    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(row_blocks_, rows / BlockSize + 1);
+    for (vcl_size_t i = 0; i <= rows / BlockSize; ++i)
+      row_buffer.set(i, row_blocks[i]);
+    viennacl::backend::memory_create(row_blocks_, row_buffer.raw_size(), viennacl::traits::context(row_blocks_), row_buffer.get());
+
+    if (nonzero_blocks > 0)
+    {
+      viennacl::backend::typesafe_host_array<unsigned int> col_buffer(col_blocks_, nonzero_blocks);
+      for (vcl_size_t k = 0; k < nonzero_blocks; ++k)
+        col_buffer.set(k, col_blocks[k]);
+      viennacl::backend::memory_create(col_blocks_, col_buffer.raw_size(), viennacl::traits::context(col_blocks_), col_buffer.get());
+      viennacl::backend::memory_create(elements_, sizeof(NumericT) * nonzero_blocks * BlockSize * BlockSize, viennacl::traits::context(elements_), elements);
+    }
+  }
+
+  /** @brief Resets all entries in the matrix back to zero without changing the matrix size. Resets the sparsity pattern. */
+  void clear()
+  {
+    nonzero_blocks_ = 0;
+
+    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(row_blocks_, rows_ / BlockSize + 1);
+    viennacl::backend::memory_create(row_blocks_, row_buffer.raw_size(), viennacl::traits::context(row_blocks_), row_buffer.get());
+  }
+
+  /** @brief Returns the number of rows and columns of a block */
+  static vcl_size_t block_size() { return BlockSize; }
+
+  vcl_size_t size1() const { return rows_; }
+  vcl_size_t size2() const { return cols_; }
+
+  /** @brief Returns the number of block rows, i.e. size1() / block_size() */
+  vcl_size_t block_rows() const { return rows_ / BlockSize; }
+  /** @brief Returns the number of block columns, i.e. size2() / block_size() */
+  vcl_size_t block_cols() const { return cols_ / BlockSize; }
+
+  /** @brief Returns the number of nonzero blocks */
+  vcl_size_t nonzero_blocks() const { return nonzero_blocks_; }
+  /** @brief Returns the number of stored entries, i.e. the entries of all nonzero blocks */
+  vcl_size_t nnz() const { return nonzero_blocks_ * BlockSize * BlockSize; }
+
+  /** @brief Returns the handle to the offsets of the block rows */
+  handle_type & handle1()       { return row_blocks_; }
+  const handle_type & handle1() const { return row_blocks_; }
+
+  /** @brief Returns the handle to the block column indices */
+  handle_type & handle2()       { return col_blocks_; }
+  const handle_type & handle2() const { return col_blocks_; }
+
+  /** @brief Returns the handle to the entries of the blocks */
+  handle_type & handle()       { return elements_; }
+  const handle_type & handle() const { return elements_; }
+
+private:
+  void init_context(viennacl::context ctx)
+  {
+    row_blocks_.switch_active_handle_id(ctx.memory_type());
+    col_blocks_.switch_active_handle_id(ctx.memory_type());
+    elements_.switch_active_handle_id(ctx.memory_type());
+
+#ifdef VIENNACL_WITH_OPENCL
+    if (ctx.memory_type() == OPENCL_MEMORY)
+    {
+      row_blocks_.opencl_handle().context(ctx.opencl_context());
+      col_blocks_.opencl_handle().context(ctx.opencl_context());
+      elements_.opencl_handle().context(ctx.opencl_context());
+    }
+#endif
+  }
+
+  vcl_size_t rows_;
+  vcl_size_t cols_;
+  vcl_size_t nonzero_blocks_;
+
+  handle_type row_blocks_;
+  handle_type col_blocks_;
+  handle_type elements_;
+};
+
+
+/** @brief Copies a sparse matrix from the host to the compute device. The nonzeros are grouped into dense blocks of size BlockSize x BlockSize.
+  *
+  * There are some type requirements on the CPUMatrixT type (fulfilled by e.g. boost::numeric::ublas):
+  * - .size1() returns the number of rows, .size2() the number of columns. Both must be multiples of BlockSize.
+  * - const_iterator1 is an iterator along increasing row indices, providing iterators of type const_iterator2 along the entries of the row via .begin() and .end().
+  * - const_iterator2 provides .index1() and .index2() returning the row and column index of the current entry, dereferenciation returns the entry.
+  *
+  * @param cpu_matrix   A sparse matrix on the host.
+  * @param gpu_matrix   A block_compressed_matrix from ViennaCL
+  */
+template<typename CPUMatrixT, typename NumericT, unsigned int BlockSize>
+void copy(const CPUMatrixT & cpu_matrix, block_compressed_matrix<NumericT, BlockSize> & gpu_matrix )
+{
+  assert( (gpu_matrix.size1() == 0 || viennacl::traits::size1(cpu_matrix) == gpu_matrix.size1()) && bool("Size mismatch") );
+  assert( (gpu_matrix.size2() == 0 || viennacl::traits::size2(cpu_matrix) == gpu_matrix.size2()) && bool("Size mismatch") );
+  assert( cpu_matrix.size1() % BlockSize == 0 && cpu_matrix.size2() % BlockSize == 0 && bool("Matrix dimensions must be multiples of the block size!") );
+
+  if (cpu_matrix.size1() > 0 && cpu_matrix.size2() > 0)
+  {
+    vcl_size_t block_rows = cpu_matrix.size1() / BlockSize;
+    vcl_size_t block_cols = cpu_matrix.size2() / BlockSize;
+
+    std::vector<unsigned int> row_blocks(block_rows + 1);
+    std::vector<unsigned int> col_blocks;
+    std::vector<NumericT>     elements;
+
+    // last block row a block column was encountered in, and its position within the block row:
+    std::vector<vcl_size_t> block_row_of_col(block_cols, block_rows);
+    std::vector<vcl_size_t> position_of_col(block_cols);
+
+    typename CPUMatrixT::const_iterator1 row_it = cpu_matrix.begin1();
+    for (vcl_size_t block_row = 0; block_row < block_rows; ++block_row)
+    {
+      vcl_size_t block_row_end = (block_row + 1) * BlockSize;
+      vcl_size_t first_block   = col_blocks.size();
+      row_blocks[block_row]    = static_cast<unsigned int>(first_block);
+
+      // pass 1: collect the block columns of the block row
+      typename CPUMatrixT::const_iterator1 block_row_begin = row_it;
+      for (; row_it != cpu_matrix.end1() && row_it.index1() < block_row_end; ++row_it)
+        for (typename CPUMatrixT::const_iterator2 col_it = row_it.begin(); col_it != row_it.end(); ++col_it)
+        {
+          vcl_size_t col_block = col_it.index2() / BlockSize;
+          if (block_row_of_col[col_block] != block_row)
+          {
+            block_row_of_col[col_block] = block_row;
+            col_blocks.push_back(static_cast<unsigned int>(col_block));
+          }
+        }
+
+      std::sort(col_blocks.begin() + static_cast<long>(first_block), col_blocks.end());
+      for (vcl_size_t k = first_block; k < col_blocks.size(); ++k)
+        position_of_col[col_blocks[k]] = k;
+      elements.resize(col_blocks.size() * BlockSize * BlockSize, NumericT(0));
+
+      // pass 2: write the entries to the blocks
+      for (typename CPUMatrixT::const_iterator1 it = block_row_begin; it != row_it; ++it)
+        for (typename CPUMatrixT::const_iterator2 col_it = it.begin(); col_it != it.end(); ++col_it)
+        {
+          vcl_size_t k = position_of_col[col_it.index2() / BlockSize];
+          elements[k * BlockSize * BlockSize + (col_it.index2() % BlockSize) * BlockSize + col_it.index1() % BlockSize] = *col_it;
+        }
+    }
+    row_blocks[block_rows] = static_cast<unsigned int>(col_blocks.size());
+
+    gpu_matrix.set(&(row_blocks[0]), col_blocks.size() > 0 ? &(col_blocks[0]) : NULL, elements.size() > 0 ? &(elements[0]) : NULL,
+                   cpu_matrix.size1(), cpu_matrix.size2(), col_blocks.size());
+  }
+}
+
+
+/** @brief Copies a sparse matrix from the host to the compute device. The host type is the std::vector< std::map < > > format.
+  *
+  * The number of columns is the smallest multiple of BlockSize holding all nonzeros, unless gpu_matrix has been set to a size before.
+  *
+  * @param cpu_matrix   A sparse matrix on the host composed of an STL vector and an STL map.
+  * @param gpu_matrix   The sparse block_compressed_matrix from ViennaCL
+  */
+template<typename IndexT, typename NumericT, unsigned int BlockSize>
+void copy(std::vector< std::map<IndexT, NumericT> > const & cpu_matrix,
+          block_compressed_matrix<NumericT, BlockSize> & gpu_matrix)
+{
+  vcl_size_t max_col = 0;
+  for (vcl_size_t i=0; i<cpu_matrix.size(); ++i)
+  {
+    if (cpu_matrix[i].size() > 0)
+      max_col = std::max<vcl_size_t>(max_col, (cpu_matrix[i].rbegin())->first);
+  }
+
+  vcl_size_t num_cols = (gpu_matrix.size2() > 0) ? gpu_matrix.size2() : viennacl::tools::align_to_multiple<vcl_size_t>(max_col + 1, BlockSize);
+  viennacl::copy(tools::const_sparse_matrix_adapter<NumericT, IndexT>(cpu_matrix, cpu_matrix.size(), num_cols), gpu_matrix);
+}
+
+
+/** @brief Copies a block_compressed_matrix from the compute device to the host. Zeros within the blocks are not copied.
+  *
+  * @param gpu_matrix   The sparse block_compressed_matrix from ViennaCL
+  * @param cpu_matrix   A sparse matrix on the host supporting the assignment cpu_matrix(i, j) = value
+  */
+template<typename CPUMatrixT, typename NumericT, unsigned int BlockSize>
+void copy(const block_compressed_matrix<NumericT, BlockSize> & gpu_matrix, CPUMatrixT & cpu_matrix)
+{
+  assert( (viennacl::traits::size1(cpu_matrix) == gpu_matrix.size1()) && bool("Size mismatch") );
+  assert( (viennacl::traits::size2(cpu_matrix) == gpu_matrix.size2()) && bool("Size mismatch") );
+
+  if (gpu_matrix.size1() > 0 && gpu_matrix.size2() > 0)
+  {
+    viennacl::backend::typesafe_host_array<unsigned int> row_blocks(gpu_matrix.handle1(), gpu_matrix.block_rows() + 1);
+    viennacl::backend::memory_read(gpu_matrix.handle1(), 0, row_blocks.raw_size(), row_blocks.get());
+
+    if (gpu_matrix.nonzero_blocks() == 0)
+      return;
+
+    viennacl::backend::typesafe_host_array<unsigned int> col_blocks(gpu_matrix.handle2(), gpu_matrix.nonzero_blocks());
+    std::vector<NumericT> elements(gpu_matrix.nnz());
+    viennacl::backend::memory_read(gpu_matrix.handle2(), 0, col_blocks.raw_size(), col_blocks.get());
+    viennacl::backend::memory_read(gpu_matrix.handle(), 0, sizeof(NumericT) * elements.size(), &(elements[0]));
+
+    for (vcl_size_t block_row = 0; block_row < gpu_matrix.block_rows(); ++block_row)
+      for (vcl_size_t k = row_blocks[block_row]; k < row_blocks[block_row + 1]; ++k)
+        for (vcl_size_t c = 0; c < BlockSize; ++c)
+          for (vcl_size_t r = 0; r < BlockSize; ++r)
+          {
+            NumericT val = elements[k * BlockSize * BlockSize + c * BlockSize + r];
+            if (val <= 0 && val >= 0) // val == 0 without compiler warnings
+              continue;
+            cpu_matrix(block_row * BlockSize + r, col_blocks[k] * BlockSize + c) = val;
+          }
+  }
+}
+
+
+/** @brief Copies a block_compressed_matrix from the compute device to the host. The host type is the std::vector< std::map < > > format.
+  *
+  * @param gpu_matrix   The sparse block_compressed_matrix from ViennaCL
+  * @param cpu_matrix   A sparse matrix on the host composed of an STL vector and an STL map.
+  */
+template<typename NumericT, unsigned int BlockSize, typename IndexT>
+void copy(const block_compressed_matrix<NumericT, BlockSize> & gpu_matrix,
+          std::vector< std::map<IndexT, NumericT> > & cpu_matrix)
+{
+  if (cpu_matrix.size() == 0)
+    cpu_matrix.resize(gpu_matrix.size1());
+
+  assert(cpu_matrix.size() == gpu_matrix.size1() && bool("Matrix dimension mismatch!"));
+
+  tools::sparse_matrix_adapter<NumericT, IndexT> temp(cpu_matrix, gpu_matrix.size1(), gpu_matrix.size2());
+  viennacl::copy(gpu_matrix, temp);
+}
+
+//
+// Specify available operations:
+//
+
+/** \cond */
+
+namespace linalg
+{
+namespace detail
+{
+  // x = A * y
+  template<typename T, unsigned int B>
+  struct op_executor<vector_base<T>, op_assign, vector_expression<const block_compressed_matrix<T, B>, const vector_base<T>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const block_compressed_matrix<T, B>, const vector_base<T>, op_prod> const & rhs)
+    {
+      // check for the special case x = A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<T> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(1), temp, T(0));
+        lhs = temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(1), lhs, T(0));
+    }
+  };
+
+  template<typename T, unsigned int B>
+  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const block_compressed_matrix<T, B>, const vector_base<T>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const block_compressed_matrix<T, B>, const vector_base<T>, op_prod> const & rhs)
+    {
+      // check for the special case x += A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<T> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(1), temp, T(0));
+        lhs += temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(1), lhs, T(1));
+    }
+  };
+
+  template<typename T, unsigned int B>
+  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const block_compressed_matrix<T, B>, const vector_base<T>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const block_compressed_matrix<T, B>, const vector_base<T>, op_prod> const & rhs)
+    {
+      // check for the special case x -= A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<T> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(1), temp, T(0));
+        lhs -= temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(-1), lhs, T(1));
+    }
+  };
+
+
+  // x = A * vec_op
+  template<typename T, unsigned int B, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_assign, vector_expression<const block_compressed_matrix<T, B>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const block_compressed_matrix<T, B>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, T(1), lhs, T(0));
+    }
+  };
+
+  // x += A * vec_op
+  template<typename T, unsigned int B, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const block_compressed_matrix<T, B>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const block_compressed_matrix<T, B>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, T(1), lhs, T(1));
+    }
+  };
+
+  // x -= A * vec_op
+  template<typename T, unsigned int B, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const block_compressed_matrix<T, B>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const block_compressed_matrix<T, B>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, T(-1), lhs, T(1));
+    }
+  };
+
+} // namespace detail
+} // namespace linalg
+
+/** \endcond */
+}
+
+#endif
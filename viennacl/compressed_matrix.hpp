@@ -22,6 +22,7 @@
     @brief Implementation of the compressed_matrix class
 */
 
+#include <algorithm>
 #include <vector>
 #include <list>
 #include <map>
@@ -37,25 +38,179 @@
 #include <boost/numeric/ublas/matrix_sparse.hpp>
 #endif
 
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
 namespace viennacl
 {
 namespace detail
 {
 
+  /** @brief Returns the number of threads used for processing 'work' items in the assembly of a compressed_matrix */
+  inline vcl_size_t csr_assembly_threads(vcl_size_t work)
+  {
+    vcl_size_t thread_count = 1;
+#ifdef VIENNACL_WITH_OPENMP
+    thread_count = std::max<vcl_size_t>(1, std::min<vcl_size_t>(static_cast<vcl_size_t>(omp_get_max_threads()), work / VIENNACL_HOST_CSR_MIN_WORK_PER_THREAD));
+#else
+    (void)work;
+#endif
+    return thread_count;
+  }
+
+  /** @brief Stable parallel counting sort of triplets (row_indices[i], col_indices[i], values[i]) by row index.
+    *
+    * Each thread counts the entries per row of a contiguous block of triplets. The exclusive prefix sum over (row, thread) then yields the position of each thread's first entry in a certain row, such that each thread can scatter its block independently.
+    * Fewer threads are used if the count arrays would be larger than the triplets. Only the column indices and values are written; the rows are given by 'row_ptr'.
+    */
+  template<typename NumericT, typename IndexT, typename InputIndexT>
+  void sort_triplets_by_row(vcl_size_t num_rows, vcl_size_t n,
+                            InputIndexT const * row_indices, InputIndexT const * col_indices, NumericT const * values,
+                            std::vector<vcl_size_t> & row_ptr, std::vector<IndexT> & cols, std::vector<NumericT> & vals)
+  {
+    vcl_size_t thread_count = std::max<vcl_size_t>(1, std::min<vcl_size_t>(csr_assembly_threads(n), n / (num_rows + 1)));
+    std::vector<vcl_size_t> offsets(thread_count * num_rows);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for num_threads(static_cast<int>(thread_count)) if (thread_count > 1)
+#endif
+    for (long t = 0; t < static_cast<long>(thread_count); ++t)
+    {
+      vcl_size_t * local_counts = &offsets[0] + static_cast<vcl_size_t>(t) * num_rows;
+      vcl_size_t begin = (static_cast<vcl_size_t>(t)     * n) / thread_count;
+      vcl_size_t end   = (static_cast<vcl_size_t>(t + 1) * n) / thread_count;
+      for (vcl_size_t i = begin; i < end; ++i)
+        ++local_counts[row_indices[i]];
+    }
+
+    row_ptr.resize(num_rows + 1);
+    vcl_size_t offset = 0;
+    for (vcl_size_t row = 0; row < num_rows; ++row)
+    {
+      row_ptr[row] = offset;
+      for (vcl_size_t t = 0; t < thread_count; ++t)
+      {
+        vcl_size_t count = offsets[t * num_rows + row];
+        offsets[t * num_rows + row] = offset;
+        offset += count;
+      }
+    }
+    row_ptr[num_rows] = offset;
+
+    cols.resize(n);
+    vals.resize(n);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for num_threads(static_cast<int>(thread_count)) if (thread_count > 1)
+#endif
+    for (long t = 0; t < static_cast<long>(thread_count); ++t)
+    {
+      vcl_size_t * local_offsets = &offsets[0] + static_cast<vcl_size_t>(t) * num_rows;
+      vcl_size_t begin = (static_cast<vcl_size_t>(t)     * n) / thread_count;
+      vcl_size_t end   = (static_cast<vcl_size_t>(t + 1) * n) / thread_count;
+      for (vcl_size_t i = begin; i < end; ++i)
+      {
+        vcl_size_t pos = local_offsets[row_indices[i]]++;
+        cols[pos] = static_cast<IndexT>(col_indices[i]);
+        vals[pos] = values[i];
+      }
+    }
+  }
+
+  /** @brief Sorts the entries of each row by column index and merges entries with equal column index, either by summation or by keeping the entry appearing last.
+    *
+    * The sort is stable, so 'appearing last' refers to the order in which the triplets were supplied. Returns the number of distinct entries of each row in 'row_lengths'.
+    */
+  template<typename NumericT, typename IndexT>
+  void sort_and_merge_csr_rows(std::vector<vcl_size_t> const & row_ptr, std::vector<IndexT> & col_indices, std::vector<NumericT> & values, bool sum_duplicates, std::vector<vcl_size_t> & row_lengths)
+  {
+    vcl_size_t num_rows = row_ptr.size() - 1;
+    row_lengths.resize(num_rows);
+
+#ifdef VIENNACL_WITH_OPENMP
+    vcl_size_t thread_count = csr_assembly_threads(row_ptr[num_rows] + num_rows);
+    #pragma omp parallel for schedule(dynamic, 256) num_threads(static_cast<int>(thread_count)) if (thread_count > 1)
+#endif
+    for (long row = 0; row < static_cast<long>(num_rows); ++row)
+    {
+      vcl_size_t row_begin = row_ptr[static_cast<vcl_size_t>(row)];
+      vcl_size_t length    = row_ptr[static_cast<vcl_size_t>(row) + 1] - row_begin;
+      IndexT       * cols = length > 0 ? &col_indices[row_begin] : NULL;
+      NumericT     * vals = length > 0 ? &values[row_begin] : NULL;
+
+      bool sorted = true;
+      for (vcl_size_t i = 1; i < length && sorted; ++i)
+        sorted = (cols[i-1] < cols[i]);
+
+      if (!sorted)
+      {
+        if (length <= 32) // stable insertion sort for short rows
+        {
+          for (vcl_size_t i = 1; i < length; ++i)
+          {
+            IndexT   col = cols[i];
+            NumericT val = vals[i];
+            vcl_size_t j = i;
+            for (; j > 0 && cols[j-1] > col; --j)
+            {
+              cols[j] = cols[j-1];
+              vals[j] = vals[j-1];
+            }
+            cols[j] = col;
+            vals[j] = val;
+          }
+        }
+        else
+        {
+          std::vector<std::pair<IndexT, vcl_size_t> > keys(length);
+          for (vcl_size_t i = 0; i < length; ++i)
+            keys[i] = std::make_pair(cols[i], i);
+          std::sort(keys.begin(), keys.end()); // (column, position) is unique, so this sort is stable with respect to the column
+
+          std::vector<NumericT> sorted_values(length);
+          for (vcl_size_t i = 0; i < length; ++i)
+          {
+            cols[i] = keys[i].first;
+            sorted_values[i] = vals[keys[i].second];
+          }
+          std::copy(sorted_values.begin(), sorted_values.end(), vals);
+        }
+
+        vcl_size_t unique = 0;
+        for (vcl_size_t i = 0; i < length; ++i)
+        {
+          if (unique > 0 && cols[unique-1] == cols[i])
+            vals[unique-1] = sum_duplicates ? vals[unique-1] + vals[i] : vals[i];
+          else
+          {
+            cols[unique] = cols[i];
+            vals[unique] = vals[i];
+            ++unique;
+          }
+        }
+        length = unique;
+      }
+
+      row_lengths[static_cast<vcl_size_t>(row)] = length;
+    }
+  }
+
+
   /** @brief Implementation of the copy of a host-based sparse matrix to the device.
     *
     * See convenience copy() routines for type requirements of CPUMatrixT
     */
-  template<typename CPUMatrixT, typename NumericT, unsigned int AlignmentV>
+  template<typename CPUMatrixT, typename NumericT, unsigned int AlignmentV, typename IndexT>
   void copy_impl(const CPUMatrixT & cpu_matrix,
-                 compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
+                 compressed_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix,
                  vcl_size_t nonzeros)
   {
     assert( (gpu_matrix.size1() == 0 || viennacl::traits::size1(cpu_matrix) == gpu_matrix.size1()) && bool("Size mismatch") );
     assert( (gpu_matrix.size2() == 0 || viennacl::traits::size2(cpu_matrix) == gpu_matrix.size2()) && bool("Size mismatch") );
 
-    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(gpu_matrix.handle1(), cpu_matrix.size1() + 1);
-    viennacl::backend::typesafe_host_array<unsigned int> col_buffer(gpu_matrix.handle2(), nonzeros);
+    viennacl::backend::typesafe_host_array<IndexT> row_buffer(gpu_matrix.handle1(), cpu_matrix.size1() + 1);
+    viennacl::backend::typesafe_host_array<IndexT> col_buffer(gpu_matrix.handle2(), nonzeros);
     std::vector<NumericT> elements(nonzeros);
 
     vcl_size_t row_index  = 0;
@@ -108,9 +263,9 @@ namespace detail
   * @param cpu_matrix   A sparse matrix on the host.
   * @param gpu_matrix   A compressed_matrix from ViennaCL
   */
-template<typename CPUMatrixT, typename NumericT, unsigned int AlignmentV>
+template<typename CPUMatrixT, typename NumericT, unsigned int AlignmentV, typename IndexT>
 void copy(const CPUMatrixT & cpu_matrix,
-          compressed_matrix<NumericT, AlignmentV> & gpu_matrix )
+          compressed_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix )
 {
   if ( cpu_matrix.size1() > 0 && cpu_matrix.size2() > 0 )
   {
@@ -145,9 +300,9 @@ void copy(const CPUMatrixT & cpu_matrix,
   * @param cpu_matrix   A sparse square matrix on the host using STL types
   * @param gpu_matrix   A compressed_matrix from ViennaCL
   */
-template<typename SizeT, typename NumericT, unsigned int AlignmentV>
+template<typename SizeT, typename NumericT, unsigned int AlignmentV, typename IndexT>
 void copy(const std::vector< std::map<SizeT, NumericT> > & cpu_matrix,
-          compressed_matrix<NumericT, AlignmentV> & gpu_matrix )
+          compressed_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix )
 {
   vcl_size_t nonzeros = 0;
   vcl_size_t max_col = 0;
@@ -169,19 +324,19 @@ void copy(const std::vector< std::map<SizeT, NumericT> > & cpu_matrix,
   *
   * Optimization which copies the data directly from the internal uBLAS buffers.
   */
-template<typename ScalarType, typename F, vcl_size_t IB, typename IA, typename TA>
+template<typename ScalarType, typename F, vcl_size_t IB, typename IA, typename TA, typename IndexT>
 void copy(const boost::numeric::ublas::compressed_matrix<ScalarType, F, IB, IA, TA> & ublas_matrix,
-          viennacl::compressed_matrix<ScalarType, 1> & gpu_matrix)
+          viennacl::compressed_matrix<ScalarType, 1, IndexT> & gpu_matrix)
 {
   assert( (gpu_matrix.size1() == 0 || viennacl::traits::size1(ublas_matrix) == gpu_matrix.size1()) && bool("Size mismatch") );
   assert( (gpu_matrix.size2() == 0 || viennacl::traits::size2(ublas_matrix) == gpu_matrix.size2()) && bool("Size mismatch") );
 
   //we just need to copy the CSR arrays:
-  viennacl::backend::typesafe_host_array<unsigned int> row_buffer(gpu_matrix.handle1(), ublas_matrix.size1() + 1);
+  viennacl::backend::typesafe_host_array<IndexT> row_buffer(gpu_matrix.handle1(), ublas_matrix.size1() + 1);
   for (vcl_size_t i=0; i<=ublas_matrix.size1(); ++i)
     row_buffer.set(i, ublas_matrix.index1_data()[i]);
 
-  viennacl::backend::typesafe_host_array<unsigned int> col_buffer(gpu_matrix.handle2(), ublas_matrix.nnz());
+  viennacl::backend::typesafe_host_array<IndexT> col_buffer(gpu_matrix.handle2(), ublas_matrix.nnz());
   for (vcl_size_t i=0; i<ublas_matrix.nnz(); ++i)
     col_buffer.set(i, ublas_matrix.index2_data()[i]);
 
@@ -201,15 +356,15 @@ void copy(const boost::numeric::ublas::compressed_matrix<ScalarType, F, IB, IA,
   * Since Armadillo uses a column-major format, while ViennaCL uses row-major, we need to transpose.
   * This is done fairly efficiently working on the CSR arrays directly, rather than (slowly) building an STL matrix.
   */
-template<typename NumericT, unsigned int AlignmentV>
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
 void copy(arma::SpMat<NumericT> const & arma_matrix,
-          viennacl::compressed_matrix<NumericT, AlignmentV> & vcl_matrix)
+          viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & vcl_matrix)
 {
   assert( (vcl_matrix.size1() == 0 || static_cast<vcl_size_t>(arma_matrix.n_rows) == vcl_matrix.size1()) && bool("Size mismatch") );
   assert( (vcl_matrix.size2() == 0 || static_cast<vcl_size_t>(arma_matrix.n_cols) == vcl_matrix.size2()) && bool("Size mismatch") );
 
-  viennacl::backend::typesafe_host_array<unsigned int> row_buffer(vcl_matrix.handle1(), arma_matrix.n_rows + 1);
-  viennacl::backend::typesafe_host_array<unsigned int> col_buffer(vcl_matrix.handle2(), arma_matrix.n_nonzero);
+  viennacl::backend::typesafe_host_array<IndexT> row_buffer(vcl_matrix.handle1(), arma_matrix.n_rows + 1);
+  viennacl::backend::typesafe_host_array<IndexT> col_buffer(vcl_matrix.handle2(), arma_matrix.n_nonzero);
   viennacl::backend::typesafe_host_array<NumericT    > value_buffer(vcl_matrix.handle(), arma_matrix.n_nonzero);
 
   // Step 1: Count number of nonzeros in each row
@@ -225,16 +380,16 @@ void copy(arma::SpMat<NumericT> const & arma_matrix,
   }
 
   // Step 2: Exclusive scan on row_buffer to obtain offsets
-  unsigned int offset = 0;
+  IndexT offset = 0;
   for (vcl_size_t i=0; i<row_buffer.size(); ++i)
   {
-    unsigned int tmp = row_buffer[i];
+    IndexT tmp = row_buffer[i];
     row_buffer.set(i, offset);
     offset += tmp;
   }
 
   // Step 3: Fill data
-  std::vector<unsigned int> row_offsets(arma_matrix.n_rows);
+  std::vector<IndexT> row_offsets(arma_matrix.n_rows);
   for (vcl_size_t col=0; col < static_cast<vcl_size_t>(arma_matrix.n_cols); ++col)
   {
     vcl_size_t col_begin = static_cast<vcl_size_t>(arma_matrix.col_ptrs[col]);
@@ -258,9 +413,9 @@ void copy(arma::SpMat<NumericT> const & arma_matrix,
   *
   * Builds a temporary STL matrix. Patches for avoiding the temporary matrix welcome.
   */
-template<typename NumericT, int flags, unsigned int AlignmentV>
+template<typename NumericT, int flags, unsigned int AlignmentV, typename IndexT>
 void copy(const Eigen::SparseMatrix<NumericT, flags> & eigen_matrix,
-          compressed_matrix<NumericT, AlignmentV> & gpu_matrix)
+          compressed_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix)
 {
   assert( (gpu_matrix.size1() == 0 || static_cast<vcl_size_t>(eigen_matrix.rows()) == gpu_matrix.size1()) && bool("Size mismatch") );
   assert( (gpu_matrix.size2() == 0 || static_cast<vcl_size_t>(eigen_matrix.cols()) == gpu_matrix.size2()) && bool("Size mismatch") );
@@ -281,9 +436,9 @@ void copy(const Eigen::SparseMatrix<NumericT, flags> & eigen_matrix,
   *
   * Builds a temporary STL matrix for the copy. Patches for avoiding the temporary matrix welcome.
   */
-template<typename NumericT, unsigned int AlignmentV>
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
 void copy(const mtl::compressed2D<NumericT> & cpu_matrix,
-          compressed_matrix<NumericT, AlignmentV> & gpu_matrix)
+          compressed_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix)
 {
   assert( (gpu_matrix.size1() == 0 || static_cast<vcl_size_t>(cpu_matrix.num_rows()) == gpu_matrix.size1()) && bool("Size mismatch") );
   assert( (gpu_matrix.size2() == 0 || static_cast<vcl_size_t>(cpu_matrix.num_cols()) == gpu_matrix.size2()) && bool("Size mismatch") );
@@ -337,8 +492,8 @@ void copy(const mtl::compressed2D<NumericT> & cpu_matrix,
   * @param gpu_matrix   A compressed_matrix from ViennaCL
   * @param cpu_matrix   A sparse matrix on the host.
   */
-template<typename CPUMatrixT, typename NumericT, unsigned int AlignmentV>
-void copy(const compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
+template<typename CPUMatrixT, typename NumericT, unsigned int AlignmentV, typename IndexT>
+void copy(const compressed_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix,
           CPUMatrixT & cpu_matrix )
 {
   assert( (viennacl::traits::size1(cpu_matrix) == gpu_matrix.size1()) && bool("Size mismatch") );
@@ -347,8 +502,8 @@ void copy(const compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
   if ( gpu_matrix.size1() > 0 && gpu_matrix.size2() > 0 )
   {
     //get raw data from memory:
-    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(gpu_matrix.handle1(), cpu_matrix.size1() + 1);
-    viennacl::backend::typesafe_host_array<unsigned int> col_buffer(gpu_matrix.handle2(), gpu_matrix.nnz());
+    viennacl::backend::typesafe_host_array<IndexT> row_buffer(gpu_matrix.handle1(), cpu_matrix.size1() + 1);
+    viennacl::backend::typesafe_host_array<IndexT> col_buffer(gpu_matrix.handle2(), gpu_matrix.nnz());
     std::vector<NumericT> elements(gpu_matrix.nnz());
 
     //std::cout << "GPU->CPU, nonzeros: " << gpu_matrix.nnz() << std::endl;
@@ -383,8 +538,8 @@ void copy(const compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
   * @param gpu_matrix   A compressed_matrix from ViennaCL
   * @param cpu_matrix   A sparse matrix on the host.
   */
-template<typename NumericT, unsigned int AlignmentV>
-void copy(const compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void copy(const compressed_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix,
           std::vector< std::map<unsigned int, NumericT> > & cpu_matrix)
 {
   assert( (cpu_matrix.size() == gpu_matrix.size1()) && bool("Size mismatch") );
@@ -398,15 +553,15 @@ void copy(const compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
   *
   * Directly populates the internal buffer of the uBLAS matrix, thus avoiding a temporary STL matrix.
   */
-template<typename ScalarType, unsigned int AlignmentV, typename F, vcl_size_t IB, typename IA, typename TA>
-void copy(viennacl::compressed_matrix<ScalarType, AlignmentV> const & gpu_matrix,
+template<typename ScalarType, unsigned int AlignmentV, typename IndexT, typename F, vcl_size_t IB, typename IA, typename TA>
+void copy(viennacl::compressed_matrix<ScalarType, AlignmentV, IndexT> const & gpu_matrix,
           boost::numeric::ublas::compressed_matrix<ScalarType> & ublas_matrix)
 {
   assert( (viennacl::traits::size1(ublas_matrix) == gpu_matrix.size1()) && bool("Size mismatch") );
   assert( (viennacl::traits::size2(ublas_matrix) == gpu_matrix.size2()) && bool("Size mismatch") );
 
-  viennacl::backend::typesafe_host_array<unsigned int> row_buffer(gpu_matrix.handle1(), gpu_matrix.size1() + 1);
-  viennacl::backend::typesafe_host_array<unsigned int> col_buffer(gpu_matrix.handle2(), gpu_matrix.nnz());
+  viennacl::backend::typesafe_host_array<IndexT> row_buffer(gpu_matrix.handle1(), gpu_matrix.size1() + 1);
+  viennacl::backend::typesafe_host_array<IndexT> col_buffer(gpu_matrix.handle2(), gpu_matrix.nnz());
 
   viennacl::backend::memory_read(gpu_matrix.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
   viennacl::backend::memory_read(gpu_matrix.handle2(), 0, col_buffer.raw_size(), col_buffer.get());
@@ -433,8 +588,8 @@ void copy(viennacl::compressed_matrix<ScalarType, AlignmentV> const & gpu_matrix
  * Performance notice: Inserting the row-major data from the ViennaCL matrix to the column-major Armadillo-matrix is likely to be slow.
  * However, since this operation is unlikely to be performance-critical, further optimizations are postponed.
 */
-template<typename NumericT, unsigned int AlignmentV>
-void copy(viennacl::compressed_matrix<NumericT, AlignmentV> & vcl_matrix,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void copy(viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & vcl_matrix,
           arma::SpMat<NumericT> & arma_matrix)
 {
   assert( (static_cast<vcl_size_t>(arma_matrix.n_rows) == vcl_matrix.size1()) && bool("Size mismatch") );
@@ -443,8 +598,8 @@ void copy(viennacl::compressed_matrix<NumericT, AlignmentV> & vcl_matrix,
   if ( vcl_matrix.size1() > 0 && vcl_matrix.size2() > 0 )
   {
     //get raw data from memory:
-    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(vcl_matrix.handle1(), vcl_matrix.size1() + 1);
-    viennacl::backend::typesafe_host_array<unsigned int> col_buffer(vcl_matrix.handle2(), vcl_matrix.nnz());
+    viennacl::backend::typesafe_host_array<IndexT> row_buffer(vcl_matrix.handle1(), vcl_matrix.size1() + 1);
+    viennacl::backend::typesafe_host_array<IndexT> col_buffer(vcl_matrix.handle2(), vcl_matrix.nnz());
     viennacl::backend::typesafe_host_array<NumericT>     elements  (vcl_matrix.handle(),  vcl_matrix.nnz());
 
     viennacl::backend::memory_read(vcl_matrix.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
@@ -469,8 +624,8 @@ void copy(viennacl::compressed_matrix<NumericT, AlignmentV> & vcl_matrix,
 
 #ifdef VIENNACL_WITH_EIGEN
 /** @brief Convenience routine for copying a ViennaCL sparse matrix back to a sparse Eigen matrix */
-template<typename NumericT, int flags, unsigned int AlignmentV>
-void copy(compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
+template<typename NumericT, int flags, unsigned int AlignmentV, typename IndexT>
+void copy(compressed_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix,
           Eigen::SparseMatrix<NumericT, flags> & eigen_matrix)
 {
   assert( (static_cast<vcl_size_t>(eigen_matrix.rows()) == gpu_matrix.size1()) && bool("Size mismatch") );
@@ -479,8 +634,8 @@ void copy(compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
   if ( gpu_matrix.size1() > 0 && gpu_matrix.size2() > 0 )
   {
     //get raw data from memory:
-    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(gpu_matrix.handle1(), gpu_matrix.size1() + 1);
-    viennacl::backend::typesafe_host_array<unsigned int> col_buffer(gpu_matrix.handle2(), gpu_matrix.nnz());
+    viennacl::backend::typesafe_host_array<IndexT> row_buffer(gpu_matrix.handle1(), gpu_matrix.size1() + 1);
+    viennacl::backend::typesafe_host_array<IndexT> col_buffer(gpu_matrix.handle2(), gpu_matrix.nnz());
     std::vector<NumericT> elements(gpu_matrix.nnz());
 
     viennacl::backend::memory_read(gpu_matrix.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
@@ -507,8 +662,8 @@ void copy(compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
 
 #ifdef VIENNACL_WITH_MTL4
 /** @brief Convenience routine for copying a ViennaCL sparse matrix back to a sparse MTL4 matrix */
-template<typename NumericT, unsigned int AlignmentV>
-void copy(compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void copy(compressed_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix,
           mtl::compressed2D<NumericT> & mtl4_matrix)
 {
   assert( (static_cast<vcl_size_t>(mtl4_matrix.num_rows()) == gpu_matrix.size1()) && bool("Size mismatch") );
@@ -518,8 +673,8 @@ void copy(compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
   {
 
     //get raw data from memory:
-    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(gpu_matrix.handle1(), gpu_matrix.size1() + 1);
-    viennacl::backend::typesafe_host_array<unsigned int> col_buffer(gpu_matrix.handle2(), gpu_matrix.nnz());
+    viennacl::backend::typesafe_host_array<IndexT> row_buffer(gpu_matrix.handle1(), gpu_matrix.size1() + 1);
+    viennacl::backend::typesafe_host_array<IndexT> col_buffer(gpu_matrix.handle2(), gpu_matrix.nnz());
     std::vector<NumericT> elements(gpu_matrix.nnz());
 
     viennacl::backend::memory_read(gpu_matrix.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
@@ -554,8 +709,9 @@ void copy(compressed_matrix<NumericT, AlignmentV> & gpu_matrix,
   *
   * @tparam NumericT    The floating point type (either float or double, checked at compile time)
   * @tparam AlignmentV     The internal memory size for the entries in each row is given by (size()/AlignmentV + 1) * AlignmentV. AlignmentV must be a power of two. Best values or usually 4, 8 or 16, higher values are usually a waste of memory.
+  * @tparam IndexT         The unsigned integer type of the row and column index arrays. Defaults to 'unsigned int'. Use e.g. 'unsigned long' for matrices with more than 2^32 nonzeros (main memory only).
   */
-template<class NumericT, unsigned int AlignmentV /* see VCLForwards.h */>
+template<class NumericT, unsigned int AlignmentV, typename IndexT /* see forwards.h */>
 class compressed_matrix
 {
 public:
@@ -592,13 +748,13 @@ public:
 #endif
     if (rows > 0)
     {
-      viennacl::backend::memory_create(row_buffer_, viennacl::backend::typesafe_host_array<unsigned int>().element_size() * (rows + 1), ctx);
-      viennacl::vector_base<unsigned int> init_temporary(row_buffer_, size_type(rows+1), 0, 1);
-      init_temporary = viennacl::zero_vector<unsigned int>(size_type(rows+1), ctx);
+      viennacl::backend::memory_create(row_buffer_, viennacl::backend::typesafe_host_array<IndexT>().element_size() * (rows + 1), ctx);
+      viennacl::vector_base<IndexT> init_temporary(row_buffer_, size_type(rows+1), 0, 1);
+      init_temporary = viennacl::zero_vector<IndexT>(size_type(rows+1), ctx);
     }
     if (nonzeros > 0)
     {
-      viennacl::backend::memory_create(col_buffer_, viennacl::backend::typesafe_host_array<unsigned int>().element_size() * nonzeros, ctx);
+      viennacl::backend::memory_create(col_buffer_, viennacl::backend::typesafe_host_array<IndexT>().element_size() * nonzeros, ctx);
       viennacl::backend::memory_create(elements_, sizeof(NumericT) * nonzeros, ctx);
     }
   }
@@ -628,9 +784,9 @@ public:
 #endif
     if (rows > 0)
     {
-      viennacl::backend::memory_create(row_buffer_, viennacl::backend::typesafe_host_array<unsigned int>().element_size() * (rows + 1), ctx);
-      viennacl::vector_base<unsigned int> init_temporary(row_buffer_, size_type(rows+1), 0, 1);
-      init_temporary = viennacl::zero_vector<unsigned int>(size_type(rows+1), ctx);
+      viennacl::backend::memory_create(row_buffer_, viennacl::backend::typesafe_host_array<IndexT>().element_size() * (rows + 1), ctx);
+      viennacl::vector_base<IndexT> init_temporary(row_buffer_, size_type(rows+1), 0, 1);
+      init_temporary = viennacl::zero_vector<IndexT>(size_type(rows+1), ctx);
     }
   }
 
@@ -716,6 +872,30 @@ public:
     generate_row_block_information();
   }
 
+  /** @brief Creates the transposed matrix of a compressed_matrix (B = trans(A)) in the memory domain of A. */
+  compressed_matrix(matrix_expression<const compressed_matrix, const compressed_matrix, op_trans> const & proxy)
+    : rows_(0), cols_(0), nonzeros_(0), row_block_num_(0)
+  {
+    viennacl::context ctx = viennacl::traits::context(proxy.lhs());
+
+    row_buffer_.switch_active_handle_id(ctx.memory_type());
+    col_buffer_.switch_active_handle_id(ctx.memory_type());
+    elements_.switch_active_handle_id(ctx.memory_type());
+    row_blocks_.switch_active_handle_id(ctx.memory_type());
+
+#ifdef VIENNACL_WITH_OPENCL
+    if (ctx.memory_type() == OPENCL_MEMORY)
+    {
+      row_buffer_.opencl_handle().context(ctx.opencl_context());
+      col_buffer_.opencl_handle().context(ctx.opencl_context());
+      elements_.opencl_handle().context(ctx.opencl_context());
+      row_blocks_.opencl_handle().context(ctx.opencl_context());
+    }
+#endif
+
+    viennacl::linalg::trans(proxy, *this);
+  }
+
   /** @brief Assignment a compressed matrix from possibly another memory domain. */
   compressed_matrix & operator=(compressed_matrix const & other)
   {
@@ -726,10 +906,11 @@ public:
     cols_ = other.size2();
     nonzeros_ = other.nnz();
     row_block_num_ = other.row_block_num_;
+    row_statistics_ = other.row_statistics_;
 
-    viennacl::backend::typesafe_memory_copy<unsigned int>(other.row_buffer_, row_buffer_);
-    viennacl::backend::typesafe_memory_copy<unsigned int>(other.col_buffer_, col_buffer_);
-    viennacl::backend::typesafe_memory_copy<unsigned int>(other.row_blocks_, row_blocks_);
+    viennacl::backend::typesafe_memory_copy<IndexT>(other.row_buffer_, row_buffer_);
+    viennacl::backend::typesafe_memory_copy<IndexT>(other.col_buffer_, col_buffer_);
+    viennacl::backend::typesafe_memory_copy<IndexT>(other.row_blocks_, row_blocks_);
     viennacl::backend::typesafe_memory_copy<NumericT>(other.elements_, elements_);
 
     return *this;
@@ -747,10 +928,182 @@ public:
     return *this;
   }
 
+  /** @brief Assigns the transposed matrix of a compressed_matrix (B = trans(A)). The column indices of B are sorted within each row. */
+  compressed_matrix & operator=(matrix_expression<const compressed_matrix, const compressed_matrix, op_trans> const & proxy)
+  {
+    assert( (rows_ == 0 || rows_ == proxy.lhs().size2()) && bool("Size mismatch") );
+    assert( (cols_ == 0 || cols_ == proxy.lhs().size1()) && bool("Size mismatch") );
+
+    if (&proxy.lhs() == this) // in-place transposition through a temporary
+    {
+      compressed_matrix temp(proxy);
+      *this = temp;
+    }
+    else
+      viennacl::linalg::trans(proxy, *this);
+
+    return *this;
+  }
+
+
+  /** @brief Sets the matrix from coordinate (COO) triplets (row_indices[i], col_indices[i], values[i]) for i = 0, ..., num_triplets - 1.
+    *
+    * The triplets may be supplied in any order. They are sorted in parallel (counting sort by row index, followed by a sort by column index within each row)
+    * and written to the memory buffers directly, avoiding the std::map-based intermediate representation required by viennacl::copy().
+    *
+    * @param rows            Number of rows
+    * @param cols            Number of columns
+    * @param num_triplets    Number of triplets
+    * @param row_indices     Array of (zero-based) row indices
+    * @param col_indices     Array of (zero-based) column indices
+    * @param values          Array of values
+    * @param sum_duplicates  If true, the values of triplets with equal row and column index are summed up (as required for finite element assembly). Otherwise, the triplet supplied last wins.
+    */
+  template<typename InputIndexT>
+  void set_from_triplets(vcl_size_t rows, vcl_size_t cols, vcl_size_t num_triplets,
+                         const InputIndexT * row_indices, const InputIndexT * col_indices, const NumericT * values,
+                         bool sum_duplicates = true)
+  {
+    assert( (rows > 0) && bool("Error in compressed_matrix::set_from_triplets(): Number of rows must be larger than zero!"));
+    assert( (cols > 0) && bool("Error in compressed_matrix::set_from_triplets(): Number of columns must be larger than zero!"));
+#ifndef NDEBUG
+    for (vcl_size_t i = 0; i < num_triplets; ++i)
+    {
+      assert( (static_cast<vcl_size_t>(row_indices[i]) < rows) && bool("Error in compressed_matrix::set_from_triplets(): Row index out of bounds!"));
+      assert( (static_cast<vcl_size_t>(col_indices[i]) < cols) && bool("Error in compressed_matrix::set_from_triplets(): Column index out of bounds!"));
+    }
+#endif
+
+    std::vector<vcl_size_t> row_ptr;
+    std::vector<IndexT>     row_col_indices;
+    std::vector<NumericT>   row_values;
+    viennacl::detail::sort_triplets_by_row(rows, num_triplets, row_indices, col_indices, values, row_ptr, row_col_indices, row_values);
+
+    set_from_rows(rows, cols, row_ptr, row_col_indices, row_values, sum_duplicates);
+  }
+
+  /** @brief Sets the matrix from entries grouped by row: The entries of row i are (col_indices[k], values[k]) for k = row_ptr[i], ..., row_ptr[i+1] - 1.
+    *
+    * The entries of a row may be supplied in any order. They are sorted by column index in place, hence 'col_indices' and 'values' are modified.
+    * Used by set_from_triplets() after sorting the triplets by row, and by readers which group the entries by row while reading (e.g. the Matrix Market reader).
+    *
+    * @param rows            Number of rows
+    * @param cols            Number of columns
+    * @param row_ptr         Offsets of the entries of each row, rows + 1 entries
+    * @param col_indices     Column indices of the entries grouped by row
+    * @param values          Values of the entries grouped by row
+    * @param sum_duplicates  If true, the values of entries with equal column index in a row are summed up. Otherwise, the entry supplied last wins.
+    */
+  void set_from_rows(vcl_size_t rows, vcl_size_t cols, std::vector<vcl_size_t> const & row_ptr,
+                     std::vector<IndexT> & col_indices, std::vector<NumericT> & values,
+                     bool sum_duplicates = true)
+  {
+    assert( (rows > 0) && bool("Error in compressed_matrix::set_from_rows(): Number of rows must be larger than zero!"));
+    assert( (cols > 0) && bool("Error in compressed_matrix::set_from_rows(): Number of columns must be larger than zero!"));
+    assert( (row_ptr.size() == rows + 1 && col_indices.size() >= row_ptr[rows] && values.size() >= row_ptr[rows]) && bool("Error in compressed_matrix::set_from_rows(): Array sizes do not match!"));
+
+    std::vector<vcl_size_t> row_lengths;
+    viennacl::detail::sort_and_merge_csr_rows(row_ptr, col_indices, values, sum_duplicates, row_lengths);
+
+    std::vector<vcl_size_t> new_row_ptr(rows + 1);
+    for (vcl_size_t row = 0; row < rows; ++row)
+      new_row_ptr[row + 1] = viennacl::tools::align_to_multiple<vcl_size_t>(new_row_ptr[row] + row_lengths[row], AlignmentV);
+    vcl_size_t nonzeros = new_row_ptr[rows];
+
+    if (nonzeros == 0)
+    {
+      rows_ = rows;
+      cols_ = cols;
+      clear();
+      generate_row_block_information();
+      return;
+    }
+
+    // write to the buffers of the matrix directly if in main memory, otherwise go through a host buffer:
+    viennacl::context ctx = viennacl::traits::context(row_buffer_);
+    bool in_main_memory = (ctx.memory_type() == MAIN_MEMORY);
+    std::vector<IndexT>   host_row_buffer;
+    std::vector<IndexT>   host_col_buffer;
+    std::vector<NumericT> host_elements;
+    IndexT   * row_data = NULL;
+    IndexT   * col_data = NULL;
+    NumericT * elements = NULL;
+    if (in_main_memory)
+    {
+      viennacl::backend::memory_create(row_buffer_, sizeof(IndexT)   * (rows + 1), ctx);
+      viennacl::backend::memory_create(col_buffer_, sizeof(IndexT)   * nonzeros,   ctx);
+      viennacl::backend::memory_create(elements_,   sizeof(NumericT) * nonzeros,   ctx);
+      row_data = reinterpret_cast<IndexT *>(row_buffer_.ram_handle().get());
+      col_data = reinterpret_cast<IndexT *>(col_buffer_.ram_handle().get());
+      elements = reinterpret_cast<NumericT *>(elements_.ram_handle().get());
+    }
+    else
+    {
+      host_row_buffer.resize(rows + 1);
+      host_col_buffer.resize(nonzeros);
+      host_elements.resize(nonzeros);
+      row_data = &host_row_buffer[0];
+      col_data = &host_col_buffer[0];
+      elements = &host_elements[0];
+    }
+
+#ifdef VIENNACL_WITH_OPENMP
+    vcl_size_t thread_count = viennacl::detail::csr_assembly_threads(nonzeros + rows);
+    #pragma omp parallel for schedule(dynamic, 256) num_threads(static_cast<int>(thread_count)) if (thread_count > 1)
+#endif
+    for (long row = 0; row < static_cast<long>(rows); ++row)
+    {
+      vcl_size_t src = row_ptr[static_cast<vcl_size_t>(row)];
+      vcl_size_t dst = new_row_ptr[static_cast<vcl_size_t>(row)];
+      row_data[row] = static_cast<IndexT>(dst);
+      for (vcl_size_t k = 0; k < row_lengths[static_cast<vcl_size_t>(row)]; ++k, ++src, ++dst)
+      {
+        col_data[dst] = col_indices[src];
+        elements[dst] = values[src];
+      }
+      for (; dst < new_row_ptr[static_cast<vcl_size_t>(row) + 1]; ++dst) // padding
+      {
+        col_data[dst] = 0;
+        elements[dst] = 0;
+      }
+    }
+    row_data[rows] = static_cast<IndexT>(nonzeros);
+
+    if (in_main_memory)
+    {
+      rows_     = rows;
+      cols_     = cols;
+      nonzeros_ = nonzeros;
+      row_statistics_ = viennacl::detail::csr_row_statistics();
+      generate_row_block_information();
+    }
+    else
+    {
+      viennacl::backend::typesafe_host_array<IndexT> row_buffer(row_buffer_, rows + 1);
+      viennacl::backend::typesafe_host_array<IndexT> col_buffer(col_buffer_, nonzeros);
+      for (vcl_size_t i = 0; i <= rows; ++i)
+        row_buffer.set(i, host_row_buffer[i]);
+      for (vcl_size_t i = 0; i < nonzeros; ++i)
+        col_buffer.set(i, host_col_buffer[i]);
+      set(row_buffer.get(), col_buffer.get(), &host_elements[0], rows, cols, nonzeros);
+    }
+  }
+
+  /** @brief Sets the matrix from coordinate (COO) triplets supplied in three arrays of equal length. See the overload taking pointers for details. */
+  template<typename InputIndexT>
+  void set_from_triplets(vcl_size_t rows, vcl_size_t cols,
+                         std::vector<InputIndexT> const & row_indices, std::vector<InputIndexT> const & col_indices, std::vector<NumericT> const & values,
+                         bool sum_duplicates = true)
+  {
+    assert( (row_indices.size() == values.size() && col_indices.size() == values.size()) && bool("Error in compressed_matrix::set_from_triplets(): Array sizes do not match!"));
+    set_from_triplets(rows, cols, values.size(),
+                      values.size() > 0 ? &row_indices[0] : NULL, values.size() > 0 ? &col_indices[0] : NULL, values.size() > 0 ? &values[0] : NULL,
+                      sum_duplicates);
+  }
 
   /** @brief Sets the row, column and value arrays of the compressed matrix
     *
-    * Type of row_jumper and col_buffer is 'unsigned int' for CUDA and OpenMP (host) backend, but *must* be cl_uint for OpenCL.
+    * Type of row_jumper and col_buffer is IndexT ('unsigned int' by default) for CUDA and OpenMP (host) backend, but *must* be cl_uint for OpenCL.
     * The reason is that 'unsigned int' might have a different bit representation on the host than 'unsigned int' on the OpenCL device.
     * cl_uint is guaranteed to have the correct bit representation for OpenCL devices.
     *
@@ -774,10 +1127,10 @@ public:
     //std::cout << "Setting memory: " << cols + 1 << ", " << nonzeros << std::endl;
 
     //row_buffer_.switch_active_handle_id(viennacl::backend::OPENCL_MEMORY);
-    viennacl::backend::memory_create(row_buffer_, viennacl::backend::typesafe_host_array<unsigned int>(row_buffer_).element_size() * (rows + 1), viennacl::traits::context(row_buffer_), row_jumper);
+    viennacl::backend::memory_create(row_buffer_, viennacl::backend::typesafe_host_array<IndexT>(row_buffer_).element_size() * (rows + 1), viennacl::traits::context(row_buffer_), row_jumper);
 
     //col_buffer_.switch_active_handle_id(viennacl::backend::OPENCL_MEMORY);
-    viennacl::backend::memory_create(col_buffer_, viennacl::backend::typesafe_host_array<unsigned int>(col_buffer_).element_size() * nonzeros, viennacl::traits::context(col_buffer_), col_buffer);
+    viennacl::backend::memory_create(col_buffer_, viennacl::backend::typesafe_host_array<IndexT>(col_buffer_).element_size() * nonzeros, viennacl::traits::context(col_buffer_), col_buffer);
 
     //elements_.switch_active_handle_id(viennacl::backend::OPENCL_MEMORY);
     viennacl::backend::memory_create(elements_, sizeof(NumericT) * nonzeros, viennacl::traits::context(elements_), elements);
@@ -802,7 +1155,7 @@ public:
         viennacl::backend::memory_shallow_copy(col_buffer_, col_buffer_old);
         viennacl::backend::memory_shallow_copy(elements_,   elements_old);
 
-        viennacl::backend::typesafe_host_array<unsigned int> size_deducer(col_buffer_);
+        viennacl::backend::typesafe_host_array<IndexT> size_deducer(col_buffer_);
         viennacl::backend::memory_create(col_buffer_, size_deducer.element_size() * new_nonzeros, viennacl::traits::context(col_buffer_));
         viennacl::backend::memory_create(elements_,   sizeof(NumericT) * new_nonzeros,          viennacl::traits::context(elements_));
 
@@ -811,7 +1164,7 @@ public:
       }
       else
       {
-        viennacl::backend::typesafe_host_array<unsigned int> size_deducer(col_buffer_);
+        viennacl::backend::typesafe_host_array<IndexT> size_deducer(col_buffer_);
         viennacl::backend::memory_create(col_buffer_, size_deducer.element_size() * new_nonzeros, viennacl::traits::context(col_buffer_));
         viennacl::backend::memory_create(elements_,   sizeof(NumericT)            * new_nonzeros, viennacl::traits::context(elements_));
       }
@@ -834,11 +1187,12 @@ public:
     {
       if (!preserve)
       {
-        viennacl::backend::typesafe_host_array<unsigned int> host_row_buffer(row_buffer_, new_size1 + 1);
-        viennacl::backend::memory_create(row_buffer_, viennacl::backend::typesafe_host_array<unsigned int>().element_size() * (new_size1 + 1), viennacl::traits::context(row_buffer_), host_row_buffer.get());
+        viennacl::backend::typesafe_host_array<IndexT> host_row_buffer(row_buffer_, new_size1 + 1);
+        viennacl::backend::memory_create(row_buffer_, viennacl::backend::typesafe_host_array<IndexT>().element_size() * (new_size1 + 1), viennacl::traits::context(row_buffer_), host_row_buffer.get());
         // faster version without initializing memory:
-        //viennacl::backend::memory_create(row_buffer_, viennacl::backend::typesafe_host_array<unsigned int>().element_size() * (new_size1 + 1), viennacl::traits::context(row_buffer_));
+        //viennacl::backend::memory_create(row_buffer_, viennacl::backend::typesafe_host_array<IndexT>().element_size() * (new_size1 + 1), viennacl::traits::context(row_buffer_));
         nonzeros_ = 0;
+        row_statistics_ = viennacl::detail::csr_row_statistics();
       }
       else
       {
@@ -887,8 +1241,8 @@ public:
   /** @brief Resets all entries in the matrix back to zero without changing the matrix size. Resets the sparsity pattern. */
   void clear()
   {
-    viennacl::backend::typesafe_host_array<unsigned int> host_row_buffer(row_buffer_, rows_ + 1);
-    viennacl::backend::typesafe_host_array<unsigned int> host_col_buffer(col_buffer_, 1);
+    viennacl::backend::typesafe_host_array<IndexT> host_row_buffer(row_buffer_, rows_ + 1);
+    viennacl::backend::typesafe_host_array<IndexT> host_col_buffer(col_buffer_, 1);
     std::vector<NumericT> host_elements(1);
 
     viennacl::backend::memory_create(row_buffer_, host_row_buffer.element_size() * (rows_ + 1), viennacl::traits::context(row_buffer_), host_row_buffer.get());
@@ -896,6 +1250,7 @@ public:
     viennacl::backend::memory_create(elements_,   sizeof(NumericT) * 1,                         viennacl::traits::context(elements_), &(host_elements[0]));
 
     nonzeros_ = 0;
+    row_statistics_ = viennacl::detail::csr_row_statistics();
   }
 
   /** @brief Returns a reference to the (i,j)-th entry of the sparse matrix. If (i,j) does not exist (zero), it is inserted (slow!) */
@@ -941,7 +1296,7 @@ public:
   /** @brief  Returns the OpenCL handle to the matrix entry array */
   const handle_type & handle() const { return elements_; }
 
-  /** @brief  Returns the OpenCL handle to the row index array */
+  /** @brief  Returns the OpenCL handle to the row index array. Call generate_row_block_information() or reset_row_statistics() after modifying the row offsets through the handle. */
   handle_type & handle1() { return row_buffer_; }
   /** @brief  Returns the OpenCL handle to the column index array */
   handle_type & handle2() { return col_buffer_; }
@@ -950,15 +1305,21 @@ public:
   /** @brief  Returns the OpenCL handle to the matrix entry array */
   handle_type & handle() { return elements_; }
 
+  /** @brief Returns the cached row statistics used by the host backend. Reset whenever the sparsity pattern changes. */
+  viennacl::detail::csr_row_statistics & row_statistics() const { return row_statistics_; }
+
+  /** @brief Discards the cached row statistics. Required after modifying the row offsets through handle1() unless generate_row_block_information() is called. */
+  void reset_row_statistics() { row_statistics_ = viennacl::detail::csr_row_statistics(); }
+
   /** @brief Switches the memory context of the matrix.
     *
     * Allows for e.g. an migration of the full matrix from OpenCL memory to host memory for e.g. computing a preconditioner.
     */
   void switch_memory_context(viennacl::context new_ctx)
   {
-    viennacl::backend::switch_memory_context<unsigned int>(row_buffer_, new_ctx);
-    viennacl::backend::switch_memory_context<unsigned int>(col_buffer_, new_ctx);
-    viennacl::backend::switch_memory_context<unsigned int>(row_blocks_, new_ctx);
+    viennacl::backend::switch_memory_context<IndexT>(row_buffer_, new_ctx);
+    viennacl::backend::switch_memory_context<IndexT>(col_buffer_, new_ctx);
+    viennacl::backend::switch_memory_context<IndexT>(row_blocks_, new_ctx);
     viennacl::backend::switch_memory_context<NumericT>(elements_, new_ctx);
   }
 
@@ -974,11 +1335,11 @@ private:
   vcl_size_t element_index(vcl_size_t i, vcl_size_t j)
   {
     //read row indices
-    viennacl::backend::typesafe_host_array<unsigned int> row_indices(row_buffer_, 2);
+    viennacl::backend::typesafe_host_array<IndexT> row_indices(row_buffer_, 2);
     viennacl::backend::memory_read(row_buffer_, row_indices.element_size()*i, row_indices.element_size()*2, row_indices.get());
 
     //get column indices for row i:
-    viennacl::backend::typesafe_host_array<unsigned int> col_indices(col_buffer_, row_indices[1] - row_indices[0]);
+    viennacl::backend::typesafe_host_array<IndexT> col_indices(col_buffer_, row_indices[1] - row_indices[0]);
     viennacl::backend::memory_read(col_buffer_, col_indices.element_size()*row_indices[0], row_indices.element_size()*col_indices.size(), col_indices.get());
 
     for (vcl_size_t k=0; k<col_indices.size(); ++k)
@@ -998,10 +1359,12 @@ public:
    */
   void generate_row_block_information()
   {
-    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(row_buffer_, rows_ + 1);
+    row_statistics_ = viennacl::detail::csr_row_statistics();
+
+    viennacl::backend::typesafe_host_array<IndexT> row_buffer(row_buffer_, rows_ + 1);
     viennacl::backend::memory_read(row_buffer_, 0, row_buffer.raw_size(), row_buffer.get());
 
-    viennacl::backend::typesafe_host_array<unsigned int> row_blocks(row_buffer_, rows_ + 1);
+    viennacl::backend::typesafe_host_array<IndexT> row_blocks(row_buffer_, rows_ + 1);
 
     vcl_size_t num_entries_in_current_batch = 0;
 
@@ -1034,6 +1397,9 @@ public:
 
   }
 
+  template<typename MatrixT>
+  friend struct viennacl::io::detail::binary_matrix_io;
+
 private:
   // /** @brief Copy constructor is by now not available. */
   //compressed_matrix(compressed_matrix const &);
@@ -1048,6 +1414,8 @@ private:
   handle_type row_blocks_;
   handle_type col_buffer_;
   handle_type elements_;
+
+  mutable viennacl::detail::csr_row_statistics row_statistics_;
 };
 
 /** @brief Output stream support for compressed_matrix. Output format is same as MATLAB, Octave, or SciPy
@@ -1055,8 +1423,8 @@ private:
   * @param os   STL output stream
   * @param A    The compressed matrix to be printed.
 */
-template<typename NumericT, unsigned int AlignmentV>
-std::ostream & operator<<(std::ostream & os, compressed_matrix<NumericT, AlignmentV> const & A)
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+std::ostream & operator<<(std::ostream & os, compressed_matrix<NumericT, AlignmentV, IndexT> const & A)
 {
   std::vector<std::map<unsigned int, NumericT> > tmp(A.size1());
   viennacl::copy(A, tmp);
@@ -1081,10 +1449,10 @@ namespace linalg
 namespace detail
 {
   // x = A * y
-  template<typename T, unsigned int A>
-  struct op_executor<vector_base<T>, op_assign, vector_expression<const compressed_matrix<T, A>, const vector_base<T>, op_prod> >
+  template<typename T, unsigned int A, typename I>
+  struct op_executor<vector_base<T>, op_assign, vector_expression<const compressed_matrix<T, A, I>, const vector_base<T>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A>, const vector_base<T>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A, I>, const vector_base<T>, op_prod> const & rhs)
     {
       // check for the special case x = A * x
       if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
@@ -1098,10 +1466,10 @@ namespace detail
     }
   };
 
-  template<typename T, unsigned int A>
-  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const compressed_matrix<T, A>, const vector_base<T>, op_prod> >
+  template<typename T, unsigned int A, typename I>
+  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const compressed_matrix<T, A, I>, const vector_base<T>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A>, const vector_base<T>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A, I>, const vector_base<T>, op_prod> const & rhs)
     {
       // check for the special case x += A * x
       if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
@@ -1115,10 +1483,10 @@ namespace detail
     }
   };
 
-  template<typename T, unsigned int A>
-  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const compressed_matrix<T, A>, const vector_base<T>, op_prod> >
+  template<typename T, unsigned int A, typename I>
+  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const compressed_matrix<T, A, I>, const vector_base<T>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A>, const vector_base<T>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A, I>, const vector_base<T>, op_prod> const & rhs)
     {
       // check for the special case x -= A * x
       if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
@@ -1134,10 +1502,10 @@ namespace detail
 
 
   // x = A * vec_op
-  template<typename T, unsigned int A, typename LHS, typename RHS, typename OP>
-  struct op_executor<vector_base<T>, op_assign, vector_expression<const compressed_matrix<T, A>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  template<typename T, unsigned int A, typename I, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_assign, vector_expression<const compressed_matrix<T, A, I>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A, I>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
     {
       viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
       viennacl::linalg::prod_impl(rhs.lhs(), temp, lhs);
@@ -1145,10 +1513,10 @@ namespace detail
   };
 
   // x = A * vec_op
-  template<typename T, unsigned int A, typename LHS, typename RHS, typename OP>
-  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const compressed_matrix<T, A>, vector_expression<const LHS, const RHS, OP>, op_prod> >
+  template<typename T, unsigned int A, typename I, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const compressed_matrix<T, A, I>, vector_expression<const LHS, const RHS, OP>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A>, vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A, I>, vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
     {
       viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
       viennacl::vector<T> temp_result(lhs);
@@ -1158,10 +1526,10 @@ namespace detail
   };
 
   // x = A * vec_op
-  template<typename T, unsigned int A, typename LHS, typename RHS, typename OP>
-  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const compressed_matrix<T, A>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  template<typename T, unsigned int A, typename I, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const compressed_matrix<T, A, I>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const compressed_matrix<T, A, I>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
     {
       viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
       viennacl::vector<T> temp_result(lhs);
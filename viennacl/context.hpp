@@ -39,7 +39,7 @@ namespace viennacl
 class context
 {
 public:
-  context() : mem_type_(viennacl::backend::default_memory_type())
+  context() : mem_type_(viennacl::backend::default_memory_type()), host_memory_pool_(NULL)
   {
 #ifdef VIENNACL_WITH_OPENCL
     if (mem_type_ == OPENCL_MEMORY)
@@ -49,7 +49,7 @@ public:
 #endif
   }
 
-  explicit context(viennacl::memory_types mtype) : mem_type_(mtype)
+  explicit context(viennacl::memory_types mtype) : mem_type_(mtype), host_memory_pool_(NULL)
   {
     if (mem_type_ == MEMORY_NOT_INITIALIZED)
       mem_type_ = viennacl::backend::default_memory_type();
@@ -61,8 +61,16 @@ public:
 #endif
   }
 
+  /** @brief Creates a context for main RAM in which all buffers are obtained from the provided memory pool. The pool must outlive all objects created in this context. */
+  explicit context(viennacl::backend::cpu_ram::memory_pool & pool) : mem_type_(MAIN_MEMORY), host_memory_pool_(&pool)
+  {
+#ifdef VIENNACL_WITH_OPENCL
+    ocl_context_ptr_ = NULL;
+#endif
+  }
+
 #ifdef VIENNACL_WITH_OPENCL
-  context(viennacl::ocl::context const & ctx) : mem_type_(OPENCL_MEMORY), ocl_context_ptr_(&ctx) {}
+  context(viennacl::ocl::context const & ctx) : mem_type_(OPENCL_MEMORY), host_memory_pool_(NULL), ocl_context_ptr_(&ctx) {}
 
   viennacl::ocl::context const & opencl_context() const
   {
@@ -75,8 +83,12 @@ public:
 
   viennacl::memory_types  memory_type() const { return mem_type_; }
 
+  /** @brief Returns the memory pool for buffers in main RAM, or NULL if buffers are allocated individually */
+  viennacl::backend::cpu_ram::memory_pool * host_memory_pool() const { return host_memory_pool_; }
+
 private:
   viennacl::memory_types   mem_type_;
+  viennacl::backend::cpu_ram::memory_pool * host_memory_pool_;
 #ifdef VIENNACL_WITH_OPENCL
   viennacl::ocl::context const * ocl_context_ptr_;
 #endif
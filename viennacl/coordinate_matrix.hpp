@@ -43,9 +43,9 @@ namespace viennacl
   * @param cpu_matrix   A sparse matrix on the host.
   * @param gpu_matrix   A compressed_matrix from ViennaCL
   */
-template<typename CPUMatrixT, typename NumericT, unsigned int AlignmentV>
+template<typename CPUMatrixT, typename NumericT, unsigned int AlignmentV, typename IndexT>
 void copy(const CPUMatrixT & cpu_matrix,
-          coordinate_matrix<NumericT, AlignmentV> & gpu_matrix )
+          coordinate_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix )
 {
   assert( (gpu_matrix.size1() == 0 || viennacl::traits::size1(cpu_matrix) == gpu_matrix.size1()) && bool("Size mismatch") );
   assert( (gpu_matrix.size2() == 0 || viennacl::traits::size2(cpu_matrix) == gpu_matrix.size2()) && bool("Size mismatch") );
@@ -65,8 +65,8 @@ void copy(const CPUMatrixT & cpu_matrix,
     gpu_matrix.rows_ = cpu_matrix.size1();
     gpu_matrix.cols_ = cpu_matrix.size2();
 
-    viennacl::backend::typesafe_host_array<unsigned int> group_boundaries(gpu_matrix.handle3(), group_num + 1);
-    viennacl::backend::typesafe_host_array<unsigned int> coord_buffer(gpu_matrix.handle12(), 2*gpu_matrix.internal_nnz());
+    viennacl::backend::typesafe_host_array<IndexT> group_boundaries(gpu_matrix.handle3(), group_num + 1);
+    viennacl::backend::typesafe_host_array<IndexT> coord_buffer(gpu_matrix.handle12(), 2*gpu_matrix.internal_nnz());
     std::vector<NumericT> elements(gpu_matrix.internal_nnz());
 
     vcl_size_t data_index = 0;
@@ -106,9 +106,9 @@ void copy(const CPUMatrixT & cpu_matrix,
   * @param cpu_matrix   A sparse square matrix on the host.
   * @param gpu_matrix   A coordinate_matrix from ViennaCL
   */
-template<typename NumericT, unsigned int AlignmentV>
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
 void copy(const std::vector< std::map<unsigned int, NumericT> > & cpu_matrix,
-          coordinate_matrix<NumericT, AlignmentV> & gpu_matrix )
+          coordinate_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix )
 {
   vcl_size_t max_col = 0;
   for (vcl_size_t i=0; i<cpu_matrix.size(); ++i)
@@ -130,8 +130,8 @@ void copy(const std::vector< std::map<unsigned int, NumericT> > & cpu_matrix,
   * @param gpu_matrix   A coordinate_matrix from ViennaCL
   * @param cpu_matrix   A sparse matrix on the host.
   */
-template<typename CPUMatrixT, typename NumericT, unsigned int AlignmentV>
-void copy(const coordinate_matrix<NumericT, AlignmentV> & gpu_matrix,
+template<typename CPUMatrixT, typename NumericT, unsigned int AlignmentV, typename IndexT>
+void copy(const coordinate_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix,
           CPUMatrixT & cpu_matrix )
 {
   assert( (viennacl::traits::size1(cpu_matrix) == gpu_matrix.size1()) && bool("Size mismatch") );
@@ -140,7 +140,7 @@ void copy(const coordinate_matrix<NumericT, AlignmentV> & gpu_matrix,
   if ( gpu_matrix.size1() > 0 && gpu_matrix.size2() > 0 )
   {
     //get raw data from memory:
-    viennacl::backend::typesafe_host_array<unsigned int> coord_buffer(gpu_matrix.handle12(), 2*gpu_matrix.nnz());
+    viennacl::backend::typesafe_host_array<IndexT> coord_buffer(gpu_matrix.handle12(), 2*gpu_matrix.nnz());
     std::vector<NumericT> elements(gpu_matrix.nnz());
 
     //std::cout << "GPU nonzeros: " << gpu_matrix.nnz() << std::endl;
@@ -160,8 +160,8 @@ void copy(const coordinate_matrix<NumericT, AlignmentV> & gpu_matrix,
   * @param gpu_matrix   A coordinate_matrix from ViennaCL
   * @param cpu_matrix   A sparse matrix on the host.
   */
-template<typename NumericT, unsigned int AlignmentV>
-void copy(const coordinate_matrix<NumericT, AlignmentV> & gpu_matrix,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void copy(const coordinate_matrix<NumericT, AlignmentV, IndexT> & gpu_matrix,
           std::vector< std::map<unsigned int, NumericT> > & cpu_matrix)
 {
   if (cpu_matrix.size() == 0)
@@ -181,8 +181,9 @@ void copy(const coordinate_matrix<NumericT, AlignmentV> & gpu_matrix,
   *
   * @tparam NumericT    The floating point type (either float or double, checked at compile time)
   * @tparam AlignmentV     The internal memory size for the arrays, given by (size()/AlignmentV + 1) * AlignmentV. AlignmentV must be a power of two.
+  * @tparam IndexT         The unsigned integer type of the coordinate and group arrays. Defaults to 'unsigned int'. Use e.g. 'unsigned long' for matrices with more than 2^32 nonzeros (main memory only).
   */
-template<class NumericT, unsigned int AlignmentV /* see forwards.h */ >
+template<class NumericT, unsigned int AlignmentV, typename IndexT /* see forwards.h */ >
 class coordinate_matrix
 {
 public:
@@ -217,12 +218,12 @@ public:
       * @param ctx      Optional context in which the matrix is created (one out of multiple OpenCL contexts, CUDA, host)
       */
   coordinate_matrix(vcl_size_t rows, vcl_size_t cols, vcl_size_t nonzeros = 0, viennacl::context ctx = viennacl::context()) :
-    rows_(rows), cols_(cols), nonzeros_(nonzeros)
+    rows_(rows), cols_(cols), nonzeros_(nonzeros), group_num_(64)
   {
     if (nonzeros > 0)
     {
-      viennacl::backend::memory_create(group_boundaries_, viennacl::backend::typesafe_host_array<unsigned int>().element_size() * (group_num_ + 1), ctx);
-      viennacl::backend::memory_create(coord_buffer_,     viennacl::backend::typesafe_host_array<unsigned int>().element_size() * 2 * internal_nnz(), ctx);
+      viennacl::backend::memory_create(group_boundaries_, viennacl::backend::typesafe_host_array<IndexT>().element_size() * (group_num_ + 1), ctx);
+      viennacl::backend::memory_create(coord_buffer_,     viennacl::backend::typesafe_host_array<IndexT>().element_size() * 2 * internal_nnz(), ctx);
       viennacl::backend::memory_create(elements_,         sizeof(NumericT) * internal_nnz(), ctx);
     }
     else
@@ -249,7 +250,7 @@ public:
       * @param ctx      Context in which to create the matrix
       */
   explicit coordinate_matrix(vcl_size_t rows, vcl_size_t cols, viennacl::context ctx)
-    : rows_(rows), cols_(cols), nonzeros_(0)
+    : rows_(rows), cols_(cols), nonzeros_(0), group_num_(64)
   {
     group_boundaries_.switch_active_handle_id(ctx.memory_type());
     coord_buffer_.switch_active_handle_id(ctx.memory_type());
@@ -266,6 +267,54 @@ public:
   }
 
 
+  /** @brief Creates the transposed matrix of a coordinate_matrix (B = trans(A)) in the memory domain of A. */
+  coordinate_matrix(matrix_expression<const coordinate_matrix, const coordinate_matrix, op_trans> const & proxy)
+    : rows_(0), cols_(0), nonzeros_(0), group_num_(64)
+  {
+    viennacl::context ctx = viennacl::traits::context(proxy.lhs());
+
+    group_boundaries_.switch_active_handle_id(ctx.memory_type());
+    coord_buffer_.switch_active_handle_id(ctx.memory_type());
+    elements_.switch_active_handle_id(ctx.memory_type());
+
+#ifdef VIENNACL_WITH_OPENCL
+    if (ctx.memory_type() == OPENCL_MEMORY)
+    {
+      group_boundaries_.opencl_handle().context(ctx.opencl_context());
+      coord_buffer_.opencl_handle().context(ctx.opencl_context());
+      elements_.opencl_handle().context(ctx.opencl_context());
+    }
+#endif
+
+    *this = proxy;
+  }
+
+  /** @brief Assigns the transposed matrix of another coordinate_matrix (B = trans(A)). The entries of A must be sorted by row, as established by viennacl::copy(). */
+  coordinate_matrix & operator=(matrix_expression<const coordinate_matrix, const coordinate_matrix, op_trans> const & proxy)
+  {
+    coordinate_matrix const & A = proxy.lhs();
+    assert( (&A != this) && bool("In-place transposition of coordinate_matrix not supported") );
+    assert( (rows_ == 0 || rows_ == A.size2()) && bool("Size mismatch") );
+    assert( (cols_ == 0 || cols_ == A.size1()) && bool("Size mismatch") );
+
+    rows_ = A.size2();
+    cols_ = A.size1();
+    nonzeros_ = A.nnz();
+    group_num_ = A.groups();
+
+    if (nonzeros_ > 0)
+    {
+      viennacl::context ctx = viennacl::traits::context(A);
+      viennacl::backend::memory_create(group_boundaries_, viennacl::backend::typesafe_host_array<IndexT>().element_size() * (group_num_ + 1), ctx);
+      viennacl::backend::memory_create(coord_buffer_,     viennacl::backend::typesafe_host_array<IndexT>().element_size() * 2 * internal_nnz(), ctx);
+      viennacl::backend::memory_create(elements_,         sizeof(NumericT) * internal_nnz(), ctx);
+
+      viennacl::linalg::trans(proxy, *this);
+    }
+
+    return *this;
+  }
+
   /** @brief Allocate memory for the supplied number of nonzeros in the matrix. Old values are preserved. */
   void reserve(vcl_size_t new_nonzeros)
   {
@@ -277,7 +326,7 @@ public:
       viennacl::backend::memory_shallow_copy(elements_, elements_old);
 
       vcl_size_t internal_new_nnz = viennacl::tools::align_to_multiple<vcl_size_t>(new_nonzeros, AlignmentV);
-      viennacl::backend::typesafe_host_array<unsigned int> size_deducer(coord_buffer_);
+      viennacl::backend::typesafe_host_array<IndexT> size_deducer(coord_buffer_);
       viennacl::backend::memory_create(coord_buffer_, size_deducer.element_size() * 2 * internal_new_nnz, viennacl::traits::context(coord_buffer_));
       viennacl::backend::memory_create(elements_,     sizeof(NumericT)  * internal_new_nnz,             viennacl::traits::context(elements_));
 
@@ -341,8 +390,8 @@ public:
   /** @brief Resets all entries in the matrix back to zero without changing the matrix size. Resets the sparsity pattern. */
   void clear()
   {
-    viennacl::backend::typesafe_host_array<unsigned int> host_group_buffer(group_boundaries_, 65);
-    viennacl::backend::typesafe_host_array<unsigned int> host_coord_buffer(coord_buffer_, 2);
+    viennacl::backend::typesafe_host_array<IndexT> host_group_buffer(group_boundaries_, 65);
+    viennacl::backend::typesafe_host_array<IndexT> host_coord_buffer(coord_buffer_, 2);
     std::vector<NumericT> host_elements(1);
 
     viennacl::backend::memory_create(group_boundaries_, host_group_buffer.element_size() * 65, viennacl::traits::context(group_boundaries_), host_group_buffer.get());
@@ -369,16 +418,26 @@ public:
   /** @brief  Returns the OpenCL handle to the group start index array */
   const handle_type & handle3() const { return group_boundaries_; }
 
+  /** @brief  Returns the OpenCL handle to the (row, column) index array */
+  handle_type & handle12() { return coord_buffer_; }
+  /** @brief  Returns the OpenCL handle to the matrix entry array */
+  handle_type & handle() { return elements_; }
+  /** @brief  Returns the OpenCL handle to the group start index array */
+  handle_type & handle3() { return group_boundaries_; }
+
   vcl_size_t groups() const { return group_num_; }
 
 #if defined(_MSC_VER) && _MSC_VER < 1500      //Visual Studio 2005 needs special treatment
   template<typename CPUMatrixT>
   friend void copy(const CPUMatrixT & cpu_matrix, coordinate_matrix & gpu_matrix );
 #else
-  template<typename CPUMatrixT, typename NumericT2, unsigned int AlignmentV2>
-  friend void copy(const CPUMatrixT & cpu_matrix, coordinate_matrix<NumericT2, AlignmentV2> & gpu_matrix );
+  template<typename CPUMatrixT, typename NumericT2, unsigned int AlignmentV2, typename IndexT2>
+  friend void copy(const CPUMatrixT & cpu_matrix, coordinate_matrix<NumericT2, AlignmentV2, IndexT2> & gpu_matrix );
 #endif
 
+  template<typename MatrixT>
+  friend struct viennacl::io::detail::binary_matrix_io;
+
 private:
   /** @brief Copy constructor is by now not available. */
   coordinate_matrix(coordinate_matrix const &);
@@ -408,10 +467,10 @@ namespace linalg
 namespace detail
 {
   // x = A * y
-  template<typename T, unsigned int A>
-  struct op_executor<vector_base<T>, op_assign, vector_expression<const coordinate_matrix<T, A>, const vector_base<T>, op_prod> >
+  template<typename T, unsigned int A, typename I>
+  struct op_executor<vector_base<T>, op_assign, vector_expression<const coordinate_matrix<T, A, I>, const vector_base<T>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A>, const vector_base<T>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A, I>, const vector_base<T>, op_prod> const & rhs)
     {
       // check for the special case x = A * x
       if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
@@ -425,10 +484,10 @@ namespace detail
     }
   };
 
-  template<typename T, unsigned int A>
-  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const coordinate_matrix<T, A>, const vector_base<T>, op_prod> >
+  template<typename T, unsigned int A, typename I>
+  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const coordinate_matrix<T, A, I>, const vector_base<T>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A>, const vector_base<T>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A, I>, const vector_base<T>, op_prod> const & rhs)
     {
       // check for the special case x += A * x
       if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
@@ -442,10 +501,10 @@ namespace detail
     }
   };
 
-  template<typename T, unsigned int A>
-  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const coordinate_matrix<T, A>, const vector_base<T>, op_prod> >
+  template<typename T, unsigned int A, typename I>
+  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const coordinate_matrix<T, A, I>, const vector_base<T>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A>, const vector_base<T>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A, I>, const vector_base<T>, op_prod> const & rhs)
     {
       // check for the special case x -= A * x
       if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
@@ -461,10 +520,10 @@ namespace detail
 
 
   // x = A * vec_op
-  template<typename T, unsigned int A, typename LHS, typename RHS, typename OP>
-  struct op_executor<vector_base<T>, op_assign, vector_expression<const coordinate_matrix<T, A>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  template<typename T, unsigned int A, typename I, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_assign, vector_expression<const coordinate_matrix<T, A, I>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A, I>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
     {
       viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
       viennacl::linalg::prod_impl(rhs.lhs(), temp, lhs);
@@ -472,10 +531,10 @@ namespace detail
   };
 
   // x += A * vec_op
-  template<typename T, unsigned int A, typename LHS, typename RHS, typename OP>
-  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const coordinate_matrix<T, A>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  template<typename T, unsigned int A, typename I, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const coordinate_matrix<T, A, I>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A, I>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
     {
       viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
       viennacl::vector<T> temp_result(lhs);
@@ -485,10 +544,10 @@ namespace detail
   };
 
   // x -= A * vec_op
-  template<typename T, unsigned int A, typename LHS, typename RHS, typename OP>
-  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const coordinate_matrix<T, A>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  template<typename T, unsigned int A, typename I, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const coordinate_matrix<T, A, I>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
   {
-    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    static void apply(vector_base<T> & lhs, vector_expression<const coordinate_matrix<T, A, I>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
     {
       viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
       viennacl::vector<T> temp_result(lhs);
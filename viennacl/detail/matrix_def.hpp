@@ -248,6 +248,9 @@ public:
   bool row_major() const { return row_major_; }
   void switch_memory_context(viennacl::context new_ctx) { viennacl::backend::switch_memory_context<NumericT>(elements_, new_ctx); }
 
+  template<typename MatrixT>
+  friend struct viennacl::io::detail::binary_matrix_io;
+
 protected:
   void set_handle(viennacl::backend::mem_handle const & h);
   void resize(size_type rows, size_type columns, bool preserve = true);
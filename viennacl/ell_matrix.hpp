@@ -111,6 +111,9 @@ public:
   friend void copy(const CPUMatrixT & cpu_matrix, ell_matrix<T, ALIGN> & gpu_matrix );
 #endif
 
+  template<typename MatrixT>
+  friend struct viennacl::io::detail::binary_matrix_io;
+
 private:
   vcl_size_t rows_;
   vcl_size_t cols_;
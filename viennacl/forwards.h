@@ -63,7 +63,9 @@
 
 #include <cstddef>
 #include <cassert>
+#include <map>
 #include <string>
+#include <vector>
 #include <stdexcept>
 
 #include "viennacl/meta/enable_if.hpp"
@@ -386,14 +388,42 @@ namespace viennacl
   template<class SCALARTYPE>
   class scalar_matrix;
 
-  template<class SCALARTYPE, unsigned int ALIGNMENT = 1>
+  template<class SCALARTYPE, unsigned int ALIGNMENT = 1, typename INDEXTYPE = unsigned int>
   class compressed_matrix;
 
+  namespace detail
+  {
+    /** @brief Split of the rows of a compressed_matrix into contiguous blocks of about the same work (nonzeros plus rows) for the threads of the host backend. */
+    struct csr_row_partition
+    {
+      csr_row_partition() : imbalance(1.0) {}
+
+      std::vector<vcl_size_t> row_offsets;   // block i holds the rows [row_offsets[i], row_offsets[i+1]). May hold fewer blocks than threads requested for small matrices.
+      double                  imbalance;     // ratio of the largest work per block to the average if dense rows are processed as part of the blocks
+    };
+
+    /** @brief Execution metadata of a compressed_matrix used by the host backend for scheduling sparse matrix products.
+      *
+      * Computed from the row array on first use by a host kernel (under a lock, so concurrent products with the same matrix are safe) and reset whenever the sparsity pattern of the matrix changes.
+      * Repeated products with the same matrix (e.g. in iterative solvers) thus do not pay for the scheduling again.
+      */
+    struct csr_row_statistics
+    {
+      csr_row_statistics() : valid(false), max_row_length(0), avg_row_length(0) {}
+
+      bool                    valid;            // max_row_length, avg_row_length and dense_rows are up to date
+      vcl_size_t              max_row_length;   // largest number of entries in a row
+      double                  avg_row_length;   // average number of entries per row
+      std::vector<vcl_size_t> dense_rows;       // (sorted) rows with many more entries than the average, processed by all threads jointly
+      std::map<vcl_size_t, csr_row_partition> partitions;  // thread count -> row partition (dense rows only contribute their row overhead)
+    };
+  }
+
   template<class SCALARTYPE>
   class compressed_compressed_matrix;
 
 
-  template<class SCALARTYPE, unsigned int ALIGNMENT = 128>
+  template<class SCALARTYPE, unsigned int ALIGNMENT = 128, typename INDEXTYPE = unsigned int>
   class coordinate_matrix;
 
   template<class SCALARTYPE, unsigned int ALIGNMENT = 1>
@@ -405,6 +435,12 @@ namespace viennacl
   template<class SCALARTYPE, unsigned int ALIGNMENT = 1>
   class hyb_matrix;
 
+  template<typename NumericT, unsigned int BlockSize>
+  class block_compressed_matrix;
+
+  template<typename NumericT>
+  class symmetric_compressed_matrix;
+
   template<class SCALARTYPE, unsigned int ALIGNMENT = 1>
   class circulant_matrix;
 
@@ -522,6 +558,13 @@ namespace viennacl
     enum { value = false };
   };
 
+  /** @brief Helper class for checking whether a matrix is a block_compressed_matrix (block compressed sparse row format) */
+  template<typename T>
+  struct is_block_compressed_matrix
+  {
+    enum { value = false };
+  };
+
   /** @brief Helper class for checking whether the provided type is one of the sparse matrix types (compressed_matrix, coordinate_matrix, etc.) */
   template<typename T>
   struct is_any_sparse_matrix
@@ -620,6 +663,9 @@ namespace viennacl
 
       static void apply(const MATRIXTYPE & /*mat*/, unsigned int & /*row*/, unsigned int & /*col*/) {}
     };
+
+    template<typename NumericT>
+    class adaptive_sparse_matrix;
   }
 
   namespace linalg
@@ -811,6 +857,18 @@ namespace viennacl
                    const vector_base<NumericT> & vec,
                          vector_base<NumericT> & result);
 
+    template<typename NumericT>
+    void prod_impl(const matrix_base<NumericT> & mat,
+                   const vector_base<NumericT> & vec,
+                         vector_base<NumericT> & result,
+                   NumericT alpha, NumericT beta);
+
+    template<typename NumericT>
+    void prod_impl(const matrix_expression< const matrix_base<NumericT>, const matrix_base<NumericT>, op_trans> & mat_trans,
+                   const vector_base<NumericT> & vec,
+                         vector_base<NumericT> & result,
+                   NumericT alpha, NumericT beta);
+
     template<typename SparseMatrixType, class SCALARTYPE, unsigned int ALIGNMENT>
     typename viennacl::enable_if< viennacl::is_any_sparse_matrix<SparseMatrixType>::value,
                                   vector_expression<const SparseMatrixType,
@@ -866,6 +924,24 @@ namespace viennacl
       static const char * name() { return "unit_upper"; }
     }; //unit upper triangular matrix
 
+    /** @brief Sparsity pattern of a sparse matrix-matrix product C = A * B of compressed_matrix objects.
+      *
+      * Computed once by prod_symbolic() and reused by prod_numeric() as long as only the values (not the sparsity patterns) of A and B change.
+      * The pattern is only stored for matrices in main memory. For other memory domains prod_numeric() computes the full product.
+      */
+    struct spgemm_plan
+    {
+      spgemm_plan() : size1(0), size2(0), A_nnz(0), B_nnz(0), max_row_length(0) {}
+
+      vcl_size_t                size1;           // number of rows of C
+      vcl_size_t                size2;           // number of columns of C
+      vcl_size_t                A_nnz;           // number of nonzeros of the factors the plan was computed for
+      vcl_size_t                B_nnz;
+      unsigned int              max_row_length;  // upper bound for the length of a row of C, determines the size of the merge buffers
+      std::vector<unsigned int> row_buffer;      // row pointers of C (empty if the plan was computed in a memory domain other than main memory)
+      std::vector<unsigned int> col_buffer;      // column indices of C
+    };
+
     //preconditioner tags
     class ilut_tag;
 
@@ -945,7 +1021,11 @@ namespace viennacl
   namespace io
   {
     /** @brief Implementation details for IO functionality. Usually not of interest for a library user. */
-    namespace detail {}
+    namespace detail
+    {
+      template<typename MatrixT>
+      struct binary_matrix_io;
+    }
 
     /** @brief Namespace holding the various XML tag definitions for the kernel parameter tuning facility. */
     namespace tag {}
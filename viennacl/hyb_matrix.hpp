@@ -117,6 +117,9 @@ public:
   friend void copy(const CPUMatrixT & cpu_matrix, hyb_matrix<T, ALIGN> & gpu_matrix );
 #endif
 
+  template<typename MatrixT>
+  friend struct viennacl::io::detail::binary_matrix_io;
+
 private:
   NumericT  csr_threshold_;
   vcl_size_t rows_;
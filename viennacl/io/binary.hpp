@@ -0,0 +1,725 @@
+#ifndef VIENNACL_IO_BINARY_HPP
+#define VIENNACL_IO_BINARY_HPP
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+
+/** @file viennacl/io/binary.hpp
+    @brief A versioned binary file format for dense and sparse matrices, allowing for loading without parsing or copying.
+
+    A file consists of a header (matrix type, index and value type, sizes), a table of sections and the sections themselves.
+    Each section holds the raw contents of one of the memory buffers of the matrix, aligned to 64 bytes within the file.
+    Header and sections are protected by checksums. All data is stored in native byte order, which is checked when loading.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "viennacl/forwards.h"
+#include "viennacl/backend/memory.hpp"
+#include "viennacl/tools/shared_ptr.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/io/detail/mapped_file.hpp"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+namespace viennacl
+{
+namespace io
+{
+namespace detail
+{
+  static const unsigned int binary_file_version = 1;
+  static const unsigned int binary_file_byte_order = 0x01020304;
+  static const vcl_size_t   binary_file_alignment = 64;
+
+  /** @brief Matrix types supported by the binary file format. The values are part of the file format and must not change. */
+  enum binary_matrix_type
+  {
+    BINARY_DENSE_MATRIX       = 1,
+    BINARY_COMPRESSED_MATRIX  = 2,
+    BINARY_COORDINATE_MATRIX  = 3,
+    BINARY_ELL_MATRIX         = 4,
+    BINARY_SLICED_ELL_MATRIX  = 5,
+    BINARY_HYB_MATRIX         = 6
+  };
+
+  /** @brief Value types supported by the binary file format. The values are part of the file format and must not change. */
+  template<typename NumericT> struct binary_value_type;
+  template<> struct binary_value_type<float>  { static const unsigned int value = 1; };
+  template<> struct binary_value_type<double> { static const unsigned int value = 2; };
+
+  /** @brief Header of a binary matrix file */
+  struct binary_file_header
+  {
+    char               magic[8];       // "VIENNACL"
+    unsigned int       version;
+    unsigned int       byte_order;
+    unsigned int       matrix_type;    // see binary_matrix_type
+    unsigned int       index_size;     // size of the index type in bytes, zero for dense matrices
+    unsigned int       value_type;     // see binary_value_type
+    unsigned int       num_sections;
+    unsigned long long parameters[8];  // sizes, specific to the matrix type
+    unsigned long long checksum;       // checksum of the header (with this field set to zero) and the section table
+  };
+
+  /** @brief Entry of the section table following the header */
+  struct binary_file_section
+  {
+    unsigned long long offset;         // from the beginning of the file
+    unsigned long long size;           // in bytes
+    unsigned long long checksum;
+  };
+
+  /** @brief Computes a Fletcher-type checksum over 64-bit words (the last word is padded with zeros).
+  *
+  * The sum of all words and the sum of all prefix sums are accumulated separately for contiguous chunks and then combined, hence the checksum can be computed in parallel.
+  */
+  inline unsigned long long binary_checksum(const char * data, vcl_size_t size_in_bytes)
+  {
+    vcl_size_t num_words = (size_in_bytes + 7) / 8;
+    vcl_size_t num_chunks = 1;
+#ifdef VIENNACL_WITH_OPENMP
+    num_chunks = std::max<vcl_size_t>(1, std::min<vcl_size_t>(static_cast<vcl_size_t>(omp_get_max_threads()), num_words / (1 << 16)));
+#endif
+
+    std::vector<unsigned long long> sums(num_chunks), prefix_sums(num_chunks);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for num_threads(static_cast<int>(num_chunks)) if (num_chunks > 1)
+#endif
+    for (long chunk = 0; chunk < static_cast<long>(num_chunks); ++chunk)
+    {
+      vcl_size_t word_begin = (static_cast<vcl_size_t>(chunk)     * num_words) / num_chunks;
+      vcl_size_t word_end   = (static_cast<vcl_size_t>(chunk + 1) * num_words) / num_chunks;
+
+      unsigned long long a = 0;
+      unsigned long long b = 0;
+      for (vcl_size_t i = word_begin; i < word_end; ++i)
+      {
+        unsigned long long word = 0;
+        std::memcpy(&word, data + 8 * i, std::min<vcl_size_t>(8, size_in_bytes - 8 * i));
+        a += word;
+        b += a;
+      }
+      sums[static_cast<vcl_size_t>(chunk)]        = a;
+      prefix_sums[static_cast<vcl_size_t>(chunk)] = b;
+    }
+
+    unsigned long long a = 0;
+    unsigned long long b = 0;
+    for (vcl_size_t chunk = 0; chunk < num_chunks; ++chunk)
+    {
+      vcl_size_t chunk_words = ((chunk + 1) * num_words) / num_chunks - (chunk * num_words) / num_chunks;
+      b += static_cast<unsigned long long>(chunk_words) * a + prefix_sums[chunk];
+      a += sums[chunk];
+    }
+
+    return ((b << 32) | (b >> 32)) ^ a ^ static_cast<unsigned long long>(size_in_bytes);
+  }
+
+  inline unsigned long long binary_header_checksum(binary_file_header header, std::vector<binary_file_section> const & sections)
+  {
+    header.checksum = 0;
+    std::vector<char> buffer(sizeof(binary_file_header) + sizeof(binary_file_section) * sections.size());
+    std::memcpy(&buffer[0], &header, sizeof(binary_file_header));
+    if (sections.size() > 0)
+      std::memcpy(&buffer[0] + sizeof(binary_file_header), &sections[0], sizeof(binary_file_section) * sections.size());
+    return binary_checksum(&buffer[0], buffer.size());
+  }
+
+  /** @brief Returns true if a section of 'size_in_bytes' bytes holds n1 x n2 entries of 'entry_size' bytes each, where both dimensions are padded to a multiple of 'alignment'.
+  *
+  * The sizes are taken from the file, hence overflows are avoided for arbitrary values.
+  */
+  inline bool binary_section_holds(unsigned long long size_in_bytes, vcl_size_t entry_size,
+                                   unsigned long long n1, unsigned long long n2 = 1, unsigned long long alignment = 1)
+  {
+    if (n1 == 0 || n2 == 0)
+      return true;
+
+    unsigned long long entries = size_in_bytes / entry_size;
+    if (n1 > entries || n2 > entries)
+      return false;
+
+    n1 = viennacl::tools::align_to_multiple<unsigned long long>(n1, alignment);
+    n2 = viennacl::tools::align_to_multiple<unsigned long long>(n2, alignment);
+    return n2 <= entries / n1;
+  }
+
+  /** @brief Deleter for buffers pointing into a mapped file: The mapping is released once the last buffer referring to it is destroyed. */
+  struct mapped_file_deleter
+  {
+    mapped_file_deleter(viennacl::tools::shared_ptr<mapped_file> const & f) : file(f) {}
+
+    void operator()(char *) const {}
+
+    viennacl::tools::shared_ptr<mapped_file> file;
+  };
+
+  /** @brief Makes 'handle' refer to 'size_in_bytes' bytes starting at 'data' inside the mapped file.
+  *
+  * Buffers in main memory directly point into the (copy-on-write) mapping, hence no data is copied. Buffers in other memory domains are initialized with a copy of the data.
+  */
+  inline void binary_load_buffer(viennacl::backend::mem_handle & handle, viennacl::context const & ctx,
+                                 viennacl::tools::shared_ptr<mapped_file> const & file, char * data, vcl_size_t size_in_bytes)
+  {
+    if (handle.get_active_handle_id() == MEMORY_NOT_INITIALIZED)
+      handle.switch_active_handle_id(ctx.memory_type());
+
+    if (size_in_bytes == 0)
+      return;
+
+    if (handle.get_active_handle_id() == MAIN_MEMORY)
+    {
+      handle.ram_handle() = viennacl::backend::mem_handle::ram_handle_type(data, mapped_file_deleter(file));
+      handle.ram_memory_pool(NULL);
+      handle.raw_size(size_in_bytes);
+    }
+    else
+      viennacl::backend::memory_create(handle, size_in_bytes, ctx, data);
+  }
+
+
+  //
+  // Access to the internals of the individual matrix types:
+  //
+  //   matrix_type, index_size:   Entries of the file header
+  //   handles(A, h):             Collects pointers to the memory buffers of A, which are stored as sections
+  //   get_parameters(A, p):      Writes the sizes of A to the array p
+  //   sections_valid(p, s):      Returns true if the sizes of the sections s are consistent with the sizes p in the header
+  //   set_parameters(A, p):      Sets the sizes of A from p. Returns false and reports the problem if the sizes are not compatible with A
+  //   finalize(A):               Called after all buffers are loaded
+  //
+
+  template<typename NumericT>
+  struct binary_matrix_io< viennacl::matrix_base<NumericT> >
+  {
+    typedef viennacl::matrix_base<NumericT>    MatrixType;
+    typedef NumericT                           value_type;
+    static const unsigned int matrix_type = BINARY_DENSE_MATRIX;
+    static const unsigned int index_size  = 0;
+
+    template<typename MatrixT, typename HandleT>
+    static void handles(MatrixT & A, std::vector<HandleT *> & h) { h.push_back(&A.elements_); }
+
+    static bool supported(MatrixType const & A)
+    {
+      if (A.start1_ != 0 || A.start2_ != 0 || A.stride1_ != 1 || A.stride2_ != 1)
+      {
+        std::cerr << "ViennaCL: Binary writer: Ranges and slices of matrices are not supported" << std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    static void get_parameters(MatrixType const & A, unsigned long long * p)
+    {
+      p[0] = A.size1_;          p[1] = A.size2_;
+      p[2] = A.internal_size1_; p[3] = A.internal_size2_;
+      p[4] = A.row_major_ ? 1 : 0;
+    }
+
+    static bool sections_valid(unsigned long long const * p, std::vector<binary_file_section> const & s)
+    {
+      return binary_section_holds(s[0].size, sizeof(NumericT), p[2], p[3]);
+    }
+
+    static bool set_parameters(MatrixType & A, unsigned long long const * p)
+    {
+      if (A.row_major_fixed_ && A.row_major_ != (p[4] == 1))
+      {
+        std::cerr << "ViennaCL: Binary reader: Memory layout (row-major vs. column-major) of the matrix in the file does not match" << std::endl;
+        return false;
+      }
+      if (p[2] < p[0] || p[3] < p[1])
+        return false;
+
+      A.size1_ = static_cast<vcl_size_t>(p[0]);          A.size2_ = static_cast<vcl_size_t>(p[1]);
+      A.start1_ = 0;                                     A.start2_ = 0;
+      A.stride1_ = 1;                                    A.stride2_ = 1;
+      A.internal_size1_ = static_cast<vcl_size_t>(p[2]); A.internal_size2_ = static_cast<vcl_size_t>(p[3]);
+      A.row_major_ = (p[4] == 1);
+      return true;
+    }
+
+    static void finalize(MatrixType &) {}
+  };
+
+  template<typename NumericT, typename F, unsigned int AlignmentV>
+  struct binary_matrix_io< viennacl::matrix<NumericT, F, AlignmentV> > : public binary_matrix_io< viennacl::matrix_base<NumericT> > {};
+
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  struct binary_matrix_io< viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> >
+  {
+    typedef viennacl::compressed_matrix<NumericT, AlignmentV, IndexT>    MatrixType;
+    typedef NumericT                                             value_type;
+    static const unsigned int matrix_type = BINARY_COMPRESSED_MATRIX;
+    static const unsigned int index_size  = sizeof(IndexT);
+
+    template<typename MatrixT, typename HandleT>
+    static void handles(MatrixT & A, std::vector<HandleT *> & h)
+    {
+      h.push_back(&A.row_buffer_);
+      h.push_back(&A.col_buffer_);
+      h.push_back(&A.elements_);
+    }
+
+    static bool supported(MatrixType const &) { return true; }
+
+    static void get_parameters(MatrixType const & A, unsigned long long * p)
+    {
+      p[0] = A.rows_; p[1] = A.cols_; p[2] = A.nonzeros_;
+    }
+
+    static bool sections_valid(unsigned long long const * p, std::vector<binary_file_section> const & s)
+    {
+      return (p[0] == 0 || s[0].size / sizeof(IndexT) > p[0])     // rows + 1 entries
+          && binary_section_holds(s[1].size, sizeof(IndexT),   p[2])
+          && binary_section_holds(s[2].size, sizeof(NumericT), p[2]);
+    }
+
+    static bool set_parameters(MatrixType & A, unsigned long long const * p)
+    {
+      A.rows_     = static_cast<vcl_size_t>(p[0]);
+      A.cols_     = static_cast<vcl_size_t>(p[1]);
+      A.nonzeros_ = static_cast<vcl_size_t>(p[2]);
+      A.row_statistics_ = viennacl::detail::csr_row_statistics();
+      return true;
+    }
+
+    static void finalize(MatrixType & A)
+    {
+      if (A.rows_ > 0)
+        A.generate_row_block_information();
+    }
+  };
+
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  struct binary_matrix_io< viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> >
+  {
+    typedef viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT>    MatrixType;
+    typedef NumericT                                             value_type;
+    static const unsigned int matrix_type = BINARY_COORDINATE_MATRIX;
+    static const unsigned int index_size  = sizeof(IndexT);
+
+    template<typename MatrixT, typename HandleT>
+    static void handles(MatrixT & A, std::vector<HandleT *> & h)
+    {
+      h.push_back(&A.coord_buffer_);
+      h.push_back(&A.elements_);
+      h.push_back(&A.group_boundaries_);
+    }
+
+    static bool supported(MatrixType const &) { return true; }
+
+    static void get_parameters(MatrixType const & A, unsigned long long * p)
+    {
+      p[0] = A.rows_; p[1] = A.cols_; p[2] = A.nonzeros_; p[3] = A.group_num_;
+    }
+
+    static bool sections_valid(unsigned long long const * p, std::vector<binary_file_section> const & s)
+    {
+      return binary_section_holds(s[0].size, sizeof(IndexT),   p[2], 2)
+          && binary_section_holds(s[1].size, sizeof(NumericT), p[2])
+          && (p[2] == 0 || s[2].size / sizeof(IndexT) > p[3]);  // group_num + 1 entries
+    }
+
+    static bool set_parameters(MatrixType & A, unsigned long long const * p)
+    {
+      A.rows_      = static_cast<vcl_size_t>(p[0]);
+      A.cols_      = static_cast<vcl_size_t>(p[1]);
+      A.nonzeros_  = static_cast<vcl_size_t>(p[2]);
+      A.group_num_ = static_cast<vcl_size_t>(p[3]);
+      return true;
+    }
+
+    static void finalize(MatrixType &) {}
+  };
+
+  template<typename NumericT, unsigned int AlignmentV>
+  struct binary_matrix_io< viennacl::ell_matrix<NumericT, AlignmentV> >
+  {
+    typedef viennacl::ell_matrix<NumericT, AlignmentV>    MatrixType;
+    typedef NumericT                                      value_type;
+    static const unsigned int matrix_type = BINARY_ELL_MATRIX;
+    static const unsigned int index_size  = sizeof(unsigned int);
+
+    template<typename MatrixT, typename HandleT>
+    static void handles(MatrixT & A, std::vector<HandleT *> & h)
+    {
+      h.push_back(&A.coords_);
+      h.push_back(&A.elements_);
+    }
+
+    static bool supported(MatrixType const &) { return true; }
+
+    static void get_parameters(MatrixType const & A, unsigned long long * p)
+    {
+      p[0] = A.rows_; p[1] = A.cols_; p[2] = A.maxnnz_;
+    }
+
+    static bool sections_valid(unsigned long long const * p, std::vector<binary_file_section> const & s)
+    {
+      return binary_section_holds(s[0].size, sizeof(unsigned int), p[0], p[2], AlignmentV)
+          && binary_section_holds(s[1].size, sizeof(NumericT),     p[0], p[2], AlignmentV);
+    }
+
+    static bool set_parameters(MatrixType & A, unsigned long long const * p)
+    {
+      A.rows_   = static_cast<vcl_size_t>(p[0]);
+      A.cols_   = static_cast<vcl_size_t>(p[1]);
+      A.maxnnz_ = static_cast<vcl_size_t>(p[2]);
+      return true;
+    }
+
+    static void finalize(MatrixType &) {}
+  };
+
+  template<typename ScalarT, typename IndexT>
+  struct binary_matrix_io< viennacl::sliced_ell_matrix<ScalarT, IndexT> >
+  {
+    typedef viennacl::sliced_ell_matrix<ScalarT, IndexT>    MatrixType;
+    typedef ScalarT                                         value_type;
+    static const unsigned int matrix_type = BINARY_SLICED_ELL_MATRIX;
+    static const unsigned int index_size  = sizeof(IndexT);
+
+    template<typename MatrixT, typename HandleT>
+    static void handles(MatrixT & A, std::vector<HandleT *> & h)
+    {
+      h.push_back(&A.columns_per_block_);
+      h.push_back(&A.column_indices_);
+      h.push_back(&A.block_start_);
+      h.push_back(&A.elements_);
+      h.push_back(&A.row_permutation_);  // empty if the rows are not reordered
+    }
+
+    static bool supported(MatrixType const &) { return true; }
+
+    static void get_parameters(MatrixType const & A, unsigned long long * p)
+    {
+      p[0] = A.rows_; p[1] = A.cols_; p[2] = A.rows_per_block_; p[3] = A.rows_for_sorting_;
+    }
+
+    static bool sections_valid(unsigned long long const * p, std::vector<binary_file_section> const & s)
+    {
+      if (p[0] == 0)
+        return true;
+      if (p[2] == 0)
+        return false;
+
+      // the size of the column index and element buffers depends on the row lengths, hence only their consistency is checked:
+      unsigned long long num_blocks = (p[0] - 1) / p[2] + 1;
+      return binary_section_holds(s[0].size, sizeof(IndexT), num_blocks)
+          && binary_section_holds(s[2].size, sizeof(IndexT), num_blocks)
+          && s[1].size / sizeof(IndexT) == s[3].size / sizeof(ScalarT)
+          && (s[4].size == 0 || binary_section_holds(s[4].size, sizeof(IndexT), p[0]));
+    }
+
+    static bool set_parameters(MatrixType & A, unsigned long long const * p)
+    {
+      A.rows_             = static_cast<vcl_size_t>(p[0]);
+      A.cols_             = static_cast<vcl_size_t>(p[1]);
+      A.rows_per_block_   = static_cast<vcl_size_t>(p[2]);
+      A.rows_for_sorting_ = std::max<vcl_size_t>(1, static_cast<vcl_size_t>(p[3]));
+      A.row_permutation_  = viennacl::backend::mem_handle();  // an empty section does not overwrite the buffer
+      return true;
+    }
+
+    static void finalize(MatrixType &) {}
+  };
+
+  template<typename NumericT, unsigned int AlignmentV>
+  struct binary_matrix_io< viennacl::hyb_matrix<NumericT, AlignmentV> >
+  {
+    typedef viennacl::hyb_matrix<NumericT, AlignmentV>    MatrixType;
+    typedef NumericT                                      value_type;
+    static const unsigned int matrix_type = BINARY_HYB_MATRIX;
+    static const unsigned int index_size  = sizeof(unsigned int);
+
+    template<typename MatrixT, typename HandleT>
+    static void handles(MatrixT & A, std::vector<HandleT *> & h)
+    {
+      h.push_back(&A.ell_coords_);
+      h.push_back(&A.ell_elements_);
+      h.push_back(&A.csr_rows_);
+      h.push_back(&A.csr_cols_);
+      h.push_back(&A.csr_elements_);
+    }
+
+    static bool supported(MatrixType const &) { return true; }
+
+    static void get_parameters(MatrixType const & A, unsigned long long * p)
+    {
+      double threshold = static_cast<double>(A.csr_threshold_);
+      p[0] = A.rows_; p[1] = A.cols_; p[2] = A.ellnnz_; p[3] = A.csrnnz_;
+      std::memcpy(p + 4, &threshold, sizeof(double));
+    }
+
+    static bool sections_valid(unsigned long long const * p, std::vector<binary_file_section> const & s)
+    {
+      return binary_section_holds(s[0].size, sizeof(unsigned int), p[0], p[2], AlignmentV)
+          && binary_section_holds(s[1].size, sizeof(NumericT),     p[0], p[2], AlignmentV)
+          && (p[0] == 0 || s[2].size / sizeof(unsigned int) > p[0])    // rows + 1 entries
+          && binary_section_holds(s[3].size, sizeof(unsigned int), p[3])
+          && binary_section_holds(s[4].size, sizeof(NumericT),     p[3]);
+    }
+
+    static bool set_parameters(MatrixType & A, unsigned long long const * p)
+    {
+      double threshold;
+      std::memcpy(&threshold, p + 4, sizeof(double));
+      A.rows_   = static_cast<vcl_size_t>(p[0]);
+      A.cols_   = static_cast<vcl_size_t>(p[1]);
+      A.ellnnz_ = static_cast<vcl_size_t>(p[2]);
+      A.csrnnz_ = static_cast<vcl_size_t>(p[3]);
+      A.csr_threshold_ = static_cast<NumericT>(threshold);
+      return true;
+    }
+
+    static void finalize(MatrixType &) {}
+  };
+
+  /** @brief Writes a matrix to a binary file. Returns the number of bytes written, or zero if an error occurred. */
+  template<typename MatrixT>
+  vcl_size_t write_binary_file_impl(MatrixT const & mat, const char * file)
+  {
+    typedef binary_matrix_io<MatrixT>                  IOType;
+    typedef typename IOType::value_type                NumericT;
+
+    if (!IOType::supported(mat))
+      return 0;
+
+    std::vector<viennacl::backend::mem_handle const *> handles;
+    IOType::handles(mat, handles);
+
+    binary_file_header header;
+    std::memset(&header, 0, sizeof(binary_file_header));
+    std::memcpy(header.magic, "VIENNACL", 8);
+    header.version      = binary_file_version;
+    header.byte_order   = binary_file_byte_order;
+    header.matrix_type  = IOType::matrix_type;
+    header.index_size   = IOType::index_size;
+    header.value_type   = binary_value_type<NumericT>::value;
+    header.num_sections = static_cast<unsigned int>(handles.size());
+    IOType::get_parameters(mat, header.parameters);
+
+    // buffers not residing in main memory are copied to the host first:
+    std::vector<std::vector<char> > host_buffers(handles.size());
+    std::vector<const char *>       section_data(handles.size());
+    std::vector<binary_file_section> sections(handles.size());
+
+    vcl_size_t offset = viennacl::tools::align_to_multiple<vcl_size_t>(sizeof(binary_file_header) + sizeof(binary_file_section) * handles.size(), binary_file_alignment);
+    for (vcl_size_t i = 0; i < handles.size(); ++i)
+    {
+      viennacl::backend::mem_handle const & h = *handles[i];
+      vcl_size_t size_in_bytes = h.raw_size();
+      if (size_in_bytes > 0 && h.get_active_handle_id() == MAIN_MEMORY)
+        section_data[i] = h.ram_handle().get();
+      else if (size_in_bytes > 0)
+      {
+        host_buffers[i].resize(size_in_bytes);
+        viennacl::backend::memory_read(h, 0, size_in_bytes, &(host_buffers[i][0]));
+        section_data[i] = &(host_buffers[i][0]);
+      }
+
+      sections[i].offset   = offset;
+      sections[i].size     = size_in_bytes;
+      sections[i].checksum = binary_checksum(section_data[i], size_in_bytes);
+      offset = viennacl::tools::align_to_multiple<vcl_size_t>(offset + size_in_bytes, binary_file_alignment);
+    }
+    header.checksum = binary_header_checksum(header, sections);
+
+    std::ofstream writer(file, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!writer)
+    {
+      std::cerr << "ViennaCL: Binary writer: Cannot open file " << file << std::endl;
+      return 0;
+    }
+
+    const char padding[binary_file_alignment] = { 0 };
+    writer.write(reinterpret_cast<const char *>(&header), sizeof(binary_file_header));
+    if (sections.size() > 0)
+      writer.write(reinterpret_cast<const char *>(&sections[0]), static_cast<std::streamsize>(sizeof(binary_file_section) * sections.size()));
+    vcl_size_t position = sizeof(binary_file_header) + sizeof(binary_file_section) * sections.size();
+    for (vcl_size_t i = 0; i < sections.size(); ++i)
+    {
+      writer.write(padding, static_cast<std::streamsize>(sections[i].offset - position));
+      if (sections[i].size > 0)
+        writer.write(section_data[i], static_cast<std::streamsize>(sections[i].size));
+      position = static_cast<vcl_size_t>(sections[i].offset + sections[i].size);
+    }
+    writer.write(padding, static_cast<std::streamsize>(offset - position));
+
+    if (!writer)
+    {
+      std::cerr << "ViennaCL: Binary writer: Error while writing file " << file << std::endl;
+      return 0;
+    }
+    return offset;
+  }
+
+  /** @brief Reads a matrix from a binary file. Returns the size of the file in bytes, or zero if an error occurred. */
+  template<typename MatrixT>
+  vcl_size_t read_binary_file_impl(MatrixT & mat, const char * file, bool verify_checksums)
+  {
+    typedef binary_matrix_io<MatrixT>                  IOType;
+    typedef typename IOType::value_type                NumericT;
+
+    viennacl::tools::shared_ptr<mapped_file> data(new mapped_file(file, true));
+    if (!data->valid())
+    {
+      std::cerr << "ViennaCL: Binary reader: Cannot open file " << file << std::endl;
+      return 0;
+    }
+
+    binary_file_header header;
+    if (data->size() < sizeof(binary_file_header))
+    {
+      std::cerr << "ViennaCL: Binary reader: File " << file << " is too small" << std::endl;
+      return 0;
+    }
+    std::memcpy(&header, data->begin(), sizeof(binary_file_header));
+
+    if (std::memcmp(header.magic, "VIENNACL", 8) != 0)
+    {
+      std::cerr << "ViennaCL: Binary reader: File " << file << " is not a ViennaCL binary file" << std::endl;
+      return 0;
+    }
+    if (header.version != binary_file_version || header.byte_order != binary_file_byte_order)
+    {
+      std::cerr << "ViennaCL: Binary reader: Unsupported version or byte order in file " << file << std::endl;
+      return 0;
+    }
+
+    std::vector<viennacl::backend::mem_handle *> handles;
+    IOType::handles(mat, handles);
+
+    if (header.matrix_type != IOType::matrix_type || header.index_size != IOType::index_size || header.value_type != binary_value_type<NumericT>::value || header.num_sections != handles.size())
+    {
+      std::cerr << "ViennaCL: Binary reader: Type of the matrix in file " << file << " does not match (matrix type, index type, or value type)" << std::endl;
+      return 0;
+    }
+
+    std::vector<binary_file_section> sections(handles.size());
+    if (data->size() < sizeof(binary_file_header) + sizeof(binary_file_section) * sections.size())
+    {
+      std::cerr << "ViennaCL: Binary reader: File " << file << " is truncated" << std::endl;
+      return 0;
+    }
+    if (sections.size() > 0)
+      std::memcpy(&sections[0], data->begin() + sizeof(binary_file_header), sizeof(binary_file_section) * sections.size());
+
+    if (binary_header_checksum(header, sections) != header.checksum)
+    {
+      std::cerr << "ViennaCL: Binary reader: Header checksum mismatch in file " << file << std::endl;
+      return 0;
+    }
+
+    for (vcl_size_t i = 0; i < sections.size(); ++i)
+    {
+      if (sections[i].offset % binary_file_alignment != 0 || sections[i].offset > data->size() || sections[i].size > data->size() - sections[i].offset)
+      {
+        std::cerr << "ViennaCL: Binary reader: File " << file << " is truncated" << std::endl;
+        return 0;
+      }
+      if (verify_checksums && binary_checksum(data->begin() + sections[i].offset, static_cast<vcl_size_t>(sections[i].size)) != sections[i].checksum)
+      {
+        std::cerr << "ViennaCL: Binary reader: Checksum mismatch in section " << i << " of file " << file << std::endl;
+        return 0;
+      }
+    }
+
+    // the sizes in the header must be consistent with the sections before the matrix is modified:
+    if (!IOType::sections_valid(header.parameters, sections))
+    {
+      std::cerr << "ViennaCL: Binary reader: Sizes of the sections in file " << file << " do not match the sizes of the matrix" << std::endl;
+      return 0;
+    }
+
+    viennacl::context ctx = viennacl::traits::context(*handles[0]);
+    if (!IOType::set_parameters(mat, header.parameters))
+      return 0;
+
+    for (vcl_size_t i = 0; i < sections.size(); ++i)
+      binary_load_buffer(*handles[i], ctx, data, data->data() + sections[i].offset, static_cast<vcl_size_t>(sections[i].size));
+
+    IOType::finalize(mat);
+
+    return data->size();
+  }
+
+} //namespace detail
+
+
+/** @brief Writes a matrix to a file in the ViennaCL binary format.
+*
+* Supported types are matrix (dense, not ranges or slices), compressed_matrix, coordinate_matrix, ell_matrix, sliced_ell_matrix, and hyb_matrix.
+* The file holds the raw contents of the memory buffers of the matrix, so it can be loaded with read_binary_file() without any parsing.
+*
+* @param mat   The matrix to be written
+* @param file  The filename
+* @return Returns the number of bytes written, or zero if an error occurred
+*/
+template<typename MatrixT>
+vcl_size_t write_binary_file(MatrixT const & mat, const char * file)
+{
+  return detail::write_binary_file_impl(mat, file);
+}
+
+template<typename MatrixT>
+vcl_size_t write_binary_file(MatrixT const & mat, const std::string & file)
+{
+  return detail::write_binary_file_impl(mat, file.c_str());
+}
+
+/** @brief Reads a matrix from a file in the ViennaCL binary format written by write_binary_file().
+*
+* If the matrix resides in main memory, the file is memory-mapped (copy-on-write) and the buffers of the matrix directly refer to the mapping, so no data is copied.
+* Pages of the file are then only loaded from disk when accessed, unless checksums are verified. Changes to the matrix are never written back to the file.
+* For matrices in other memory domains, the buffers are initialized from the mapping.
+*
+* The type of the matrix (matrix type, index type, value type) must match the one used for writing the file.
+*
+* @param mat               The matrix to be read
+* @param file              The filename
+* @param verify_checksums  If true, the checksums of all data sections are verified
+* @return Returns the size of the file in bytes, or zero if an error occurred
+*/
+template<typename MatrixT>
+vcl_size_t read_binary_file(MatrixT & mat, const char * file, bool verify_checksums = true)
+{
+  return detail::read_binary_file_impl(mat, file, verify_checksums);
+}
+
+template<typename MatrixT>
+vcl_size_t read_binary_file(MatrixT & mat, const std::string & file, bool verify_checksums = true)
+{
+  return detail::read_binary_file_impl(mat, file.c_str(), verify_checksums);
+}
+
+} //namespace io
+} //namespace viennacl
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef VIENNACL_IO_DETAIL_MAPPED_FILE_HPP
+#define VIENNACL_IO_DETAIL_MAPPED_FILE_HPP
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/io/detail/mapped_file.hpp
+    @brief Provides the contents of a file in memory, using memory mapping where available.
+*/
+
+#include <fstream>
+#include <vector>
+#include "viennacl/forwards.h"
+
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+  #define VIENNACL_IO_WITH_MMAP
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace viennacl
+{
+namespace io
+{
+namespace detail
+{
+
+/** @brief View of the contents of a file. Uses mmap() where available, otherwise the file is read into a buffer.
+*
+* In both cases the contents start at an address aligned to 64 bytes (mappings are page-aligned), so aligned offsets within the file yield aligned pointers.
+*
+* By default the view is read-only and the file is expected to be read sequentially.
+* If 'copy_on_write' is set, the contents may be modified through data(). Modifications are private to the process and never written back to the file.
+*/
+class mapped_file
+{
+public:
+  explicit mapped_file(const char * file, bool copy_on_write = false) : data_(NULL), size_(0), mapped_(false)
+  {
+#ifdef VIENNACL_IO_WITH_MMAP
+    int fd = ::open(file, O_RDONLY);
+    if (fd < 0)
+      return;
+
+    struct stat file_info;
+    if (::fstat(fd, &file_info) == 0 && file_info.st_size > 0)
+    {
+      int protection = copy_on_write ? (PROT_READ | PROT_WRITE) : PROT_READ;
+      void * ptr = ::mmap(NULL, static_cast<size_t>(file_info.st_size), protection, MAP_PRIVATE, fd, 0);
+      if (ptr != MAP_FAILED)
+      {
+  #ifdef MADV_SEQUENTIAL
+        if (!copy_on_write)
+          ::madvise(ptr, static_cast<size_t>(file_info.st_size), MADV_SEQUENTIAL);
+  #endif
+        data_   = static_cast<char *>(ptr);
+        size_   = static_cast<vcl_size_t>(file_info.st_size);
+        mapped_ = true;
+      }
+    }
+    ::close(fd);
+    if (mapped_)
+      return;
+#else
+    (void)copy_on_write;
+#endif
+    std::ifstream reader(file, std::ios::in | std::ios::binary);
+    if (!reader)
+      return;
+    reader.seekg(0, std::ios::end);
+    std::streamoff file_size = reader.tellg();
+    reader.seekg(0, std::ios::beg);
+    if (file_size <= 0)
+      return;
+    buffer_.resize(static_cast<vcl_size_t>(file_size) + buffer_alignment - 1);
+    vcl_size_t misalignment = reinterpret_cast<vcl_size_t>(&buffer_[0]) % buffer_alignment;
+    data_ = &buffer_[0] + (misalignment > 0 ? buffer_alignment - misalignment : 0);
+    reader.read(data_, file_size);
+    size_ = static_cast<vcl_size_t>(reader.gcount());
+  }
+
+  ~mapped_file()
+  {
+#ifdef VIENNACL_IO_WITH_MMAP
+    if (mapped_)
+      ::munmap(data_, size_);
+#endif
+  }
+
+  char       * data()        { return data_; }
+  const char * begin() const { return data_; }
+  const char * end()   const { return data_ + size_; }
+  vcl_size_t   size()  const { return size_; }
+  bool         valid() const { return data_ != NULL; }
+
+  /** @brief Returns true if the file is memory-mapped rather than read into a buffer */
+  bool         mapped() const { return mapped_; }
+
+private:
+  static const vcl_size_t buffer_alignment = 64;
+
+  mapped_file(mapped_file const &);
+  mapped_file & operator=(mapped_file const &);
+
+  char * data_;
+  vcl_size_t size_;
+  bool mapped_;
+  std::vector<char> buffer_;
+};
+
+} //namespace detail
+} //namespace io
+} //namespace viennacl
+
+#endif
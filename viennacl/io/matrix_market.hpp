@@ -31,9 +31,17 @@
 #include <vector>
 #include <map>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include "viennacl/forwards.h"
 #include "viennacl/tools/adapter.hpp"
 #include "viennacl/traits/size.hpp"
 #include "viennacl/traits/fill.hpp"
+#include "viennacl/io/detail/mapped_file.hpp"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
 
 namespace viennacl
 {
@@ -161,11 +169,7 @@ long read_matrix_market_file_impl(MatrixT & mat,
         if (detail::tolower(token) != "coordinate")
         {
           if (detail::tolower(token) == "array")
-          {
             dense_format = true;
-            std::cerr << "Error in file " << file << " at line " << linenum << " in file " << file << ": 'array' type is not supported yet!" << std::endl;
-            return 0;
-          }
           else
           {
             std::cerr << "Error in file " << file << " at line " << linenum << " in file " << file << ": Expected 'array' or 'coordinate', got '" << token << "'" << std::endl;
@@ -247,14 +251,22 @@ long read_matrix_market_file_impl(MatrixT & mat,
         if (dense_format)
         {
           ScalarT value;
-          line >> value;
+          if (!(line >> value))
+          {
+            std::cerr << "Error in file " << file << ": Parse error for matrix entry in line " << linenum << std::endl;
+            return 0;
+          }
           viennacl::traits::fill(mat, static_cast<vcl_size_t>(cur_row), static_cast<vcl_size_t>(cur_col), value);
+          if (symmetric && cur_row != cur_col)
+            viennacl::traits::fill(mat, static_cast<vcl_size_t>(cur_col), static_cast<vcl_size_t>(cur_row), value);
 
           if (++cur_row == static_cast<long>(viennacl::traits::size1(mat)))
           {
-            //next column
+            //next column (only the lower triangular part is stored for symmetric matrices)
             ++cur_col;
-            cur_row = 0;
+            cur_row = symmetric ? cur_col : 0;
+            if (cur_col == static_cast<long>(viennacl::traits::size2(mat)))
+              break;
           }
         }
         else //sparse format
@@ -369,6 +381,510 @@ long read_matrix_market_file(std::vector< std::map<unsigned int, ScalarT> > & ma
   return read_matrix_market_file_impl(adapted_matrix, file.c_str(), index_base);
 }
 
+///////// direct reader for compressed_matrix ////////////
+
+namespace detail
+{
+  inline bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+  inline const char * skip_blanks(const char * p, const char * end)
+  {
+    while (p < end && is_blank(*p))
+      ++p;
+    return p;
+  }
+
+  inline const char * next_line(const char * p, const char * end)
+  {
+    const char * newline = static_cast<const char *>(std::memchr(p, '\n', static_cast<vcl_size_t>(end - p)));
+    return newline ? newline + 1 : end;
+  }
+
+  /** @brief Parses a (possibly signed) integer. Returns false if no digits are found. */
+  inline bool parse_integer(const char * & p, const char * end, long & value)
+  {
+    p = skip_blanks(p, end);
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+      negative = (*p++ == '-');
+
+    const char * start = p;
+    long result = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+      result = 10 * result + (*p++ - '0');
+
+    value = negative ? -result : result;
+    return p != start;
+  }
+
+  /** @brief Parses a floating point number.
+  *
+  * Numbers with at most 19 significant digits whose decimal significand is exactly representable in double precision and whose exponent is within the range of exactly representable powers of ten are converted with a single multiplication or division, which is correctly rounded.
+  * All other numbers (including inf and nan) are handed to strtod().
+  */
+  inline bool parse_floating_point(const char * & p, const char * end, double & value)
+  {
+    static const double powers_of_ten[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9, 1e10, 1e11,
+                                           1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    p = skip_blanks(p, end);
+    const char * token = p;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+      negative = (*p++ == '-');
+
+    unsigned long long significand = 0;
+    long significant_digits = 0;
+    long exponent = 0;
+    bool any_digits = false;
+
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+      any_digits = true;
+      if (significand > 0 || *p != '0')
+      {
+        if (significant_digits < 19)
+          significand = 10 * significand + static_cast<unsigned long long>(*p - '0');
+        else
+          ++exponent;
+        ++significant_digits;
+      }
+      ++p;
+    }
+    if (p < end && *p == '.')
+    {
+      ++p;
+      while (p < end && *p >= '0' && *p <= '9')
+      {
+        any_digits = true;
+        if (significand > 0 || *p != '0')
+        {
+          if (significant_digits < 19)
+          {
+            significand = 10 * significand + static_cast<unsigned long long>(*p - '0');
+            --exponent;
+          }
+          ++significant_digits;
+        }
+        else
+          --exponent;
+        ++p;
+      }
+    }
+
+    if (any_digits && p < end && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D'))
+    {
+      const char * exponent_start = p++;
+      bool negative_exponent = false;
+      if (p < end && (*p == '-' || *p == '+'))
+        negative_exponent = (*p++ == '-');
+
+      const char * exponent_digits = p;
+      long exponent_value = 0;
+      while (p < end && *p >= '0' && *p <= '9' && exponent_value < 100000)
+        exponent_value = 10 * exponent_value + (*p++ - '0');
+
+      if (p != exponent_digits)
+        exponent += negative_exponent ? -exponent_value : exponent_value;
+      else
+        p = exponent_start;
+    }
+
+    if (any_digits && (p == end || is_blank(*p) || *p == '\n')
+        && significant_digits <= 19 && significand <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+    {
+      double result = static_cast<double>(significand);
+      result = (exponent < 0) ? result / powers_of_ten[-exponent] : result * powers_of_ten[exponent];
+      value = negative ? -result : result;
+      return true;
+    }
+
+    // slow path: copy the token and let the C library do the conversion
+    p = token;
+    char buffer[128];
+    vcl_size_t length = 0;
+    while (p < end && !is_blank(*p) && *p != '\n' && length < sizeof(buffer) - 1)
+      buffer[length++] = *p++;
+    buffer[length] = 0;
+
+    char * token_end = NULL;
+    value = std::strtod(buffer, &token_end);
+    return token_end != buffer && *token_end == 0;
+  }
+
+  /** @brief Header information of a MatrixMarket file */
+  struct matrix_market_header
+  {
+    matrix_market_header() : dense_format(false), pattern_matrix(false), symmetric(false), rows(0), cols(0), nnz(0), lines(0), data_begin(NULL) {}
+
+    bool dense_format;
+    bool pattern_matrix;
+    bool symmetric;
+    vcl_size_t rows;
+    vcl_size_t cols;
+    vcl_size_t nnz;
+    long lines;               //number of lines up to and including the line with the matrix dimensions
+    const char * data_begin;
+  };
+
+  /** @brief Parses the banner and the matrix dimensions. Returns false and reports the problem to std::cerr on failure. */
+  inline bool parse_matrix_market_header(const char * p, const char * end, const char * file, matrix_market_header & header)
+  {
+    std::string token;
+
+    while (p < end)
+    {
+      const char * line_end = next_line(p, end);
+      ++header.lines;
+      const char * q = skip_blanks(p, line_end);
+
+      if (q + 1 < line_end && q[0] == '%' && q[1] == '%')
+      {
+        std::stringstream line(std::string(q + 2, line_end));
+        line >> token;
+        if (detail::tolower(token) != "matrixmarket")
+        {
+          std::cerr << "Error in file " << file << " at line " << header.lines << ": Expected 'MatrixMarket', got '" << token << "'" << std::endl;
+          return false;
+        }
+
+        line >> token;
+        if (detail::tolower(token) != "matrix")
+        {
+          std::cerr << "Error in file " << file << " at line " << header.lines << ": Expected 'matrix', got '" << token << "'" << std::endl;
+          return false;
+        }
+
+        line >> token;
+        if (detail::tolower(token) == "array")
+          header.dense_format = true;
+        else if (token != "coordinate")
+        {
+          std::cerr << "Error in file " << file << " at line " << header.lines << ": Expected 'array' or 'coordinate', got '" << token << "'" << std::endl;
+          return false;
+        }
+
+        line >> token;
+        if (detail::tolower(token) == "pattern")
+          header.pattern_matrix = true;
+        else if (token != "real" && token != "complex" && token != "integer")
+        {
+          std::cerr << "Error in file " << file << ": The MatrixMarket reader provided with ViennaCL supports only real valued floating point arithmetic or pattern type matrices." << std::endl;
+          return false;
+        }
+
+        line >> token;
+        if (detail::tolower(token) == "symmetric")
+          header.symmetric = true;
+        else if (token != "general")
+        {
+          std::cerr << "Error in file " << file << ": The MatrixMarket reader provided with ViennaCL supports only general or symmetric matrices." << std::endl;
+          return false;
+        }
+      }
+      else if (q < line_end && *q != '%' && *q != '\n')
+      {
+        long rows = 0, cols = 0, nnz = 0;
+        if (!parse_integer(q, line_end, rows) || !parse_integer(q, line_end, cols)
+            || (!header.dense_format && !parse_integer(q, line_end, nnz))
+            || rows < 0 || cols < 0 || nnz < 0)
+        {
+          std::cerr << "Error in file " << file << ": Could not get matrix dimensions in line " << header.lines << std::endl;
+          return false;
+        }
+
+        header.rows = static_cast<vcl_size_t>(rows);
+        header.cols = static_cast<vcl_size_t>(cols);
+        if (header.dense_format)
+          header.nnz = header.symmetric ? header.rows * (header.rows + 1) / 2 : header.rows * header.cols;
+        else
+          header.nnz = static_cast<vcl_size_t>(nnz);
+        header.data_begin = line_end;
+        return true;
+      }
+
+      p = line_end;
+    }
+
+    std::cerr << "Error in file " << file << ": Could not find matrix dimensions" << std::endl;
+    return false;
+  }
+
+  /** @brief Entries parsed by a single thread from a contiguous chunk of lines */
+  template<typename NumericT>
+  struct matrix_market_chunk
+  {
+    matrix_market_chunk() : lines(0), error_position(NULL) {}
+
+    std::vector<unsigned int> row_indices;
+    std::vector<unsigned int> col_indices;
+    std::vector<NumericT>     values;
+    long lines;
+    const char * error_position;
+    std::string error;
+  };
+
+  /** @brief Parses all data lines in [p, end). Stops at the first malformed entry and records its position. */
+  template<typename NumericT>
+  void parse_matrix_market_chunk(const char * p, const char * end, matrix_market_header const & header, long index_base, matrix_market_chunk<NumericT> & chunk)
+  {
+    while (p < end)
+    {
+      const char * line_end = next_line(p, end);
+      ++chunk.lines;
+      const char * q = skip_blanks(p, line_end);
+
+      if (q < line_end && *q != '%' && *q != '\n')
+      {
+        double value = 1.0;
+        if (header.dense_format)
+        {
+          if (!parse_floating_point(q, line_end, value))
+          {
+            chunk.error_position = p;
+            chunk.error = "Parse error for matrix entry";
+            return;
+          }
+        }
+        else
+        {
+          long row = 0, col = 0;
+          if (!parse_integer(q, line_end, row) || !parse_integer(q, line_end, col))
+          {
+            chunk.error_position = p;
+            chunk.error = "Parse error for matrix row or column entry";
+            return;
+          }
+          if (!header.pattern_matrix && !parse_floating_point(q, line_end, value))
+          {
+            chunk.error_position = p;
+            chunk.error = "Parse error for matrix entry";
+            return;
+          }
+
+          row -= index_base;
+          col -= index_base;
+          if (row < 0 || row >= static_cast<long>(header.rows) || col < 0 || col >= static_cast<long>(header.cols))
+          {
+            std::stringstream ss;
+            ss << "Index out of bounds: (" << row << ", " << col << ") (matrix dim: " << header.rows << " x " << header.cols << ")";
+            chunk.error_position = p;
+            chunk.error = ss.str();
+            return;
+          }
+
+          chunk.row_indices.push_back(static_cast<unsigned int>(row));
+          chunk.col_indices.push_back(static_cast<unsigned int>(col));
+        }
+        chunk.values.push_back(static_cast<NumericT>(value));
+      }
+
+      p = line_end;
+    }
+  }
+
+  /** @brief Reads the entries of a MatrixMarket file grouped by row, where the entries of each row are in file order.
+  *
+  * The file is mapped into memory and split into chunks of complete lines, which are parsed in parallel.
+  * The entries are then distributed to rows by a counting sort directly from the parsed chunks, which are released one after another.
+  * Entries of symmetric matrices are mirrored. Explicit zeros in files in array format are not stored.
+  *
+  * @return The number of lines read, or zero if an error occurred
+  */
+  template<typename NumericT, typename IndexT>
+  long read_matrix_market_file_rows(const char * file, long index_base,
+                                    vcl_size_t & rows, vcl_size_t & cols,
+                                    std::vector<vcl_size_t> & row_ptr, std::vector<IndexT> & col_indices, std::vector<NumericT> & values)
+  {
+    mapped_file data(file);
+    if (!data.valid())
+    {
+      std::cerr << "ViennaCL: Matrix Market Reader: Cannot open file " << file << std::endl;
+      return 0;
+    }
+
+    matrix_market_header header;
+    if (!parse_matrix_market_header(data.begin(), data.end(), file, header))
+      return 0;
+    rows = header.rows;
+    cols = header.cols;
+
+    //
+    // Split the data into chunks of complete lines and parse them in parallel:
+    //
+    vcl_size_t data_size = static_cast<vcl_size_t>(data.end() - header.data_begin);
+    vcl_size_t num_chunks = 1;
+#ifdef VIENNACL_WITH_OPENMP
+    num_chunks = std::max<vcl_size_t>(1, std::min<vcl_size_t>(static_cast<vcl_size_t>(omp_get_max_threads()), data_size / (1 << 16)));
+#endif
+
+    std::vector<const char *> chunk_begin(num_chunks + 1, data.end());
+    chunk_begin[0] = header.data_begin;
+    for (vcl_size_t i = 1; i < num_chunks; ++i)
+      chunk_begin[i] = std::max(chunk_begin[i-1], next_line(header.data_begin + (i * data_size) / num_chunks, data.end()));
+
+    std::vector<matrix_market_chunk<NumericT> > chunks(num_chunks);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for num_threads(static_cast<int>(num_chunks)) schedule(static, 1) if (num_chunks > 1)
+#endif
+    for (long i = 0; i < static_cast<long>(num_chunks); ++i)
+      parse_matrix_market_chunk(chunk_begin[static_cast<vcl_size_t>(i)], chunk_begin[static_cast<vcl_size_t>(i) + 1], header, index_base, chunks[static_cast<vcl_size_t>(i)]);
+
+    // Only the first 'nnz' entries are relevant. Errors are reported for the first offending line before that:
+    long linenum = header.lines;
+    vcl_size_t entries = 0;
+    for (vcl_size_t i = 0; i < num_chunks && entries < header.nnz; ++i)
+    {
+      if (chunks[i].error_position && entries + chunks[i].values.size() < header.nnz)
+      {
+        long line = linenum + 1 + static_cast<long>(std::count(chunk_begin[i], chunks[i].error_position, '\n'));
+        std::cerr << "Error in file " << file << " at line " << line << ": " << chunks[i].error << std::endl;
+        return 0;
+      }
+      entries += chunks[i].values.size();
+      linenum += chunks[i].lines;
+    }
+
+    if (entries < header.nnz)
+    {
+      std::cerr << "Error in file " << file << ": Expected " << header.nnz << " entries, but found only " << entries << std::endl;
+      return 0;
+    }
+
+    //
+    // Counting sort of the first 'nnz' entries into rows:
+    //
+    row_ptr.assign(rows + 1, 0);
+    if (header.dense_format)
+    {
+      // entries are stored column by column, only the lower triangular part for symmetric matrices:
+      vcl_size_t i = 0, j = 0;
+      for (vcl_size_t c = 0; c < num_chunks; ++c)
+        for (vcl_size_t k = 0; k < chunks[c].values.size() && j < cols; ++k)
+        {
+          if (chunks[c].values[k] != NumericT(0))
+          {
+            ++row_ptr[i + 1];
+            if (header.symmetric && i != j)
+              ++row_ptr[j + 1];
+          }
+          if (++i == rows) { ++j; i = header.symmetric ? j : 0; }
+        }
+    }
+    else
+    {
+      vcl_size_t remaining = header.nnz;
+      for (vcl_size_t c = 0; c < num_chunks && remaining > 0; ++c)
+      {
+        vcl_size_t n = std::min(remaining, chunks[c].values.size());
+        for (vcl_size_t k = 0; k < n; ++k)
+        {
+          ++row_ptr[chunks[c].row_indices[k] + 1];
+          if (header.symmetric && chunks[c].row_indices[k] != chunks[c].col_indices[k])
+            ++row_ptr[chunks[c].col_indices[k] + 1];
+        }
+        remaining -= n;
+      }
+    }
+
+    for (vcl_size_t i = 0; i < rows; ++i)
+      row_ptr[i + 1] += row_ptr[i];
+
+    col_indices.resize(row_ptr[rows]);
+    values.resize(row_ptr[rows]);
+    std::vector<vcl_size_t> row_fill(row_ptr.begin(), row_ptr.end() - 1);
+
+    if (header.dense_format)
+    {
+      vcl_size_t i = 0, j = 0;
+      for (vcl_size_t c = 0; c < num_chunks; ++c)
+      {
+        for (vcl_size_t k = 0; k < chunks[c].values.size() && j < cols; ++k)
+        {
+          NumericT value = chunks[c].values[k];
+          if (value != NumericT(0))
+          {
+            col_indices[row_fill[i]] = static_cast<IndexT>(j); values[row_fill[i]++] = value;
+            if (header.symmetric && i != j)
+            {
+              col_indices[row_fill[j]] = static_cast<IndexT>(i); values[row_fill[j]++] = value;
+            }
+          }
+          if (++i == rows) { ++j; i = header.symmetric ? j : 0; }
+        }
+        std::vector<NumericT>().swap(chunks[c].values);
+      }
+    }
+    else
+    {
+      vcl_size_t remaining = header.nnz;
+      for (vcl_size_t c = 0; c < num_chunks && remaining > 0; ++c)
+      {
+        matrix_market_chunk<NumericT> & chunk = chunks[c];
+        vcl_size_t n = std::min(remaining, chunk.values.size());
+        for (vcl_size_t k = 0; k < n; ++k)
+        {
+          unsigned int row = chunk.row_indices[k];
+          unsigned int col = chunk.col_indices[k];
+          col_indices[row_fill[row]] = static_cast<IndexT>(col); values[row_fill[row]++] = chunk.values[k];
+          if (header.symmetric && row != col)
+          {
+            col_indices[row_fill[col]] = static_cast<IndexT>(row); values[row_fill[col]++] = chunk.values[k];
+          }
+        }
+        remaining -= n;
+
+        // release parsed data early to keep the peak memory consumption low:
+        std::vector<unsigned int>().swap(chunk.row_indices);
+        std::vector<unsigned int>().swap(chunk.col_indices);
+        std::vector<NumericT>().swap(chunk.values);
+      }
+    }
+
+    return linenum;
+  }
+} //namespace detail
+
+/** @brief Reads a sparse matrix from a file (MatrixMarket format) directly into a compressed_matrix.
+*
+* Unlike the generic reader, the file is memory-mapped and parsed in parallel if OpenMP is enabled, and the entries are grouped by row while reading and assembled with compressed_matrix::set_from_rows() without an intermediate std::map-based representation.
+* Both the 'coordinate' and the 'array' format are supported. If the matrix in the file is complex, only the real-valued part is loaded.
+*
+* @param mat The matrix that is to be read
+* @param file Filename from which the matrix should be read
+* @param index_base The index base, typically 1
+* @return Returns nonzero if file is read correctly
+*/
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+long read_matrix_market_file(viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & mat,
+                             const char * file,
+                             long index_base = 1)
+{
+  vcl_size_t rows = 0;
+  vcl_size_t cols = 0;
+  std::vector<vcl_size_t> row_ptr;
+  std::vector<IndexT>     col_indices;
+  std::vector<NumericT>   values;
+
+  long linenum = detail::read_matrix_market_file_rows(file, index_base, rows, cols, row_ptr, col_indices, values);
+  if (linenum == 0 || rows == 0 || cols == 0)
+    return linenum;
+
+  // duplicate entries are not summed up, but the last one wins (as for the generic reader):
+  mat.set_from_rows(rows, cols, row_ptr, col_indices, values, false);
+  return linenum;
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+long read_matrix_market_file(viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & mat,
+                             const std::string & file,
+                             long index_base = 1)
+{
+  return read_matrix_market_file(mat, file.c_str(), index_base);
+}
+
 
 ////////// writer /////////////
 template<typename MatrixT>
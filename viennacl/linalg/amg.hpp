@@ -81,12 +81,18 @@ namespace detail
                          compressed_matrix<NumericT> & A_coarse)
   {
 
-    compressed_matrix<NumericT> A_fine_times_P(viennacl::traits::context(A_fine));
-
-    // transpose P in memory (no known way of efficiently multiplying P^T * B for CSR-matrices P and B):
+    // transpose P in memory (no known way of efficiently multiplying P^T * B for CSR-matrices P and B). R is also needed for the restriction in the cycle:
     viennacl::linalg::detail::amg::amg_transpose(P, R);
 
+    // the host backend computes the Galerkin product row by row without a temporary for A_fine * P:
+    if (viennacl::traits::active_handle_id(A_fine) == viennacl::MAIN_MEMORY)
+    {
+      viennacl::linalg::host_based::amg::amg_galerkin_prod(A_fine, P, R, A_coarse);
+      return;
+    }
+
     // compute Galerkin product using a temporary for the result of A_fine * P
+    compressed_matrix<NumericT> A_fine_times_P(viennacl::traits::context(A_fine));
     A_fine_times_P = viennacl::linalg::prod(A_fine, P);
     A_coarse = viennacl::linalg::prod(R, A_fine_times_P);
 
@@ -30,6 +30,8 @@
 #include "viennacl/forwards.h"
 #include "viennacl/tools/tools.hpp"
 #include "viennacl/linalg/ilu.hpp"
+#include "viennacl/linalg/jacobi_precond.hpp"
+#include "viennacl/linalg/row_scaling.hpp"
 #include "viennacl/linalg/prod.hpp"
 #include "viennacl/linalg/inner_prod.hpp"
 #include "viennacl/linalg/norm_2.hpp"
@@ -37,6 +39,8 @@
 #include "viennacl/traits/size.hpp"
 #include "viennacl/meta/result_of.hpp"
 #include "viennacl/linalg/iterative_operations.hpp"
+#include "viennacl/linalg/detail/block_krylov.hpp"
+#include "viennacl/linalg/detail/s_step_krylov.hpp"
 
 namespace viennacl
 {
@@ -53,7 +57,7 @@ public:
   * @param tol              Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||)
   * @param max_iterations   The maximum number of iterations
   */
-  cg_tag(double tol = 1e-8, unsigned int max_iterations = 300) : tol_(tol), abs_tol_(0), iterations_(max_iterations) {}
+  cg_tag(double tol = 1e-8, unsigned int max_iterations = 300) : tol_(tol), abs_tol_(0), iterations_(max_iterations), s_(1) {}
 
   /** @brief Returns the relative tolerance */
   double tolerance() const { return tol_; }
@@ -66,6 +70,15 @@ public:
   /** @brief Returns the maximum number of iterations */
   unsigned int max_iterations() const { return iterations_; }
 
+  /** @brief Returns the number of iterations s carried out per step of the s-step method (s = 1 for the standard method) */
+  unsigned int s() const { return s_; }
+  /** @brief Sets the number of iterations s per step of the s-step method.
+  *
+  * For s > 1, the unpreconditioned CG for the ViennaCL sparse matrix types requires only one global reduction every s iterations.
+  * Values of s up to about 10 are reasonable, larger values result in an ill-conditioned Krylov basis.
+  */
+  void s(unsigned int new_s) { if (new_s > 0) s_ = new_s; }
+
   /** @brief Return the number of solver iterations: */
   unsigned int iters() const { return iters_taken_; }
   void iters(unsigned int i) const { iters_taken_ = i; }
@@ -80,6 +93,7 @@ private:
   double tol_;
   double abs_tol_;
   unsigned int iterations_;
+  unsigned int s_;
 
   //return values from solver
   mutable unsigned int iters_taken_;
@@ -187,7 +201,191 @@ namespace detail
   }
 
 
-  /** @brief Overload for the pipelined CG implementation for the ViennaCL sparse matrix types */
+  /** @brief Implementation of the s-step conjugate gradient method (no preconditioner), see A. T. Chronopoulos and C. W. Gear, J. Comput. Appl. Math. 25(2), 153–168 (1989)
+  *
+  * Each outer iteration computes the Chebyshev basis vectors rho_0(A) p, ..., rho_s(A) p and rho_0(A) r, ..., rho_{s-1}(A) r without any global reduction.
+  * The Gram matrix G of these 2s+1 vectors is the only global reduction of the outer iteration:
+  * s iterations of CG are then carried out on the host with the coordinates of x, r, and p with respect to this basis, where inner products are evaluated through G.
+  * Finally, x, r, and p are recovered by a single dense matrix-matrix product.
+  * The spectral interval for the Chebyshev basis is estimated from the Ritz values of the Lanczos matrix obtained from the CG coefficients.
+  *
+  * @param A            The system matrix
+  * @param rhs          The load vector
+  * @param tag          Solver configuration tag
+  * @param monitor      A callback routine which is called after each outer iteration (i.e. every s iterations)
+  * @param monitor_data Data pointer to be passed to the callback routine to pass on user-specific data
+  * @return The result vector
+  */
+  template<typename MatrixT, typename NumericT>
+  viennacl::vector<NumericT> s_step_solve(MatrixT const & A,
+                                          viennacl::vector<NumericT> const & rhs,
+                                          cg_tag const & tag,
+                                          bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                          void *monitor_data = NULL)
+  {
+    typedef std::vector< std::vector<NumericT> >    HostMatrixType;
+
+    viennacl::context ctx = viennacl::traits::context(rhs);
+    vcl_size_t n = rhs.size();
+    vcl_size_t s = tag.s();
+    vcl_size_t basis_size = 2 * s + 1;
+
+    viennacl::vector<NumericT> result(rhs);
+    viennacl::traits::clear(result);
+
+    NumericT norm_rhs_squared = viennacl::linalg::norm_2(rhs); norm_rhs_squared *= norm_rhs_squared;
+
+    tag.iters(0);
+    if (norm_rhs_squared <= tag.abs_tolerance() * tag.abs_tolerance()) //check for early convergence of A*x = 0
+      return result;
+
+    viennacl::vector<NumericT> residual(rhs);
+    viennacl::vector<NumericT> p(rhs);
+
+    // initial spectral interval from ||A b|| / ||b||, refined by Ritz values later on:
+    viennacl::vector<NumericT> Ab = viennacl::linalg::prod(A, rhs);
+    NumericT lambda_max = NumericT(2) * viennacl::linalg::norm_2(Ab) / std::sqrt(norm_rhs_squared);
+    std::vector<NumericT> alphas;
+    std::vector<NumericT> betas;
+
+    // basis vectors [rho_0(A) p, ..., rho_s(A) p, rho_0(A) r, ..., rho_{s-1}(A) r]:
+    viennacl::matrix<NumericT, viennacl::column_major> Y(n, basis_size, ctx);
+    viennacl::vector_base<NumericT> Y_p(Y.handle(), n, 0, 1);
+    viennacl::vector_base<NumericT> Y_r(Y.handle(), n, (s + 1) * Y.internal_size1(), 1);
+
+    NumericT inner_prod_rr = norm_rhs_squared;
+    bool done = false;
+    while (!done && tag.iters() < tag.max_iterations())
+    {
+      s_step_chebyshev_basis<NumericT> basis(NumericT(0), lambda_max);
+
+      //
+      // Matrix powers kernel and the only global reduction of this outer iteration:
+      //
+      Y_p = p;
+      Y_r = residual;
+      s_step_matrix_powers(A, viennacl::linalg::no_precond(), basis, Y, 0, 1, s);
+      s_step_matrix_powers(A, viennacl::linalg::no_precond(), basis, Y, s + 1, s + 2, s - 1);
+
+      viennacl::matrix<NumericT, viennacl::column_major> vcl_G = viennacl::linalg::prod(trans(Y), Y);
+      HostMatrixType G = block_krylov_to_host(vcl_G);
+
+      // B maps coordinates of a vector to the coordinates of A times this vector (within the first s steps):
+      HostMatrixType B(basis_size, std::vector<NumericT>(basis_size));
+      HostMatrixType B_p = basis.change_of_basis(s);
+      HostMatrixType B_r = basis.change_of_basis(s - 1);
+      for (vcl_size_t j=0; j<s; ++j)
+        for (vcl_size_t i=0; i<=s; ++i)
+          B[i][j] = B_p[i][j];
+      for (vcl_size_t j=0; j+1<s; ++j)
+        for (vcl_size_t i=0; i<s; ++i)
+          B[s + 1 + i][s + 1 + j] = B_r[i][j];
+
+      //
+      // s iterations of CG on the coordinates (columns: x, r, p):
+      //
+      HostMatrixType coords(basis_size, std::vector<NumericT>(3));
+      coords[s + 1][1] = NumericT(1);
+      coords[0][2] = NumericT(1);
+      std::vector<NumericT> Bp(basis_size);
+
+      for (vcl_size_t k = 0; k < s && tag.iters() < tag.max_iterations(); ++k)
+      {
+        tag.iters(tag.iters() + 1);
+
+        for (vcl_size_t i=0; i<basis_size; ++i)
+        {
+          Bp[i] = 0;
+          for (vcl_size_t j=0; j<basis_size; ++j)
+            Bp[i] += B[i][j] * coords[j][2];
+        }
+
+        NumericT inner_prod_pAp = 0;
+        for (vcl_size_t i=0; i<basis_size; ++i)
+          for (vcl_size_t j=0; j<basis_size; ++j)
+            inner_prod_pAp += coords[i][2] * G[i][j] * Bp[j];
+
+        if (inner_prod_pAp <= 0) // breakdown because of an ill-conditioned basis
+        {
+          tag.iters(tag.iters() - 1);
+          done = true;
+          break;
+        }
+
+        NumericT alpha = inner_prod_rr / inner_prod_pAp;
+        for (vcl_size_t i=0; i<basis_size; ++i)
+        {
+          coords[i][0] += alpha * coords[i][2];
+          coords[i][1] -= alpha * Bp[i];
+        }
+
+        NumericT new_inner_prod_rr = 0;
+        for (vcl_size_t i=0; i<basis_size; ++i)
+          for (vcl_size_t j=0; j<basis_size; ++j)
+            new_inner_prod_rr += coords[i][1] * G[i][j] * coords[j][1];
+        new_inner_prod_rr = std::fabs(new_inner_prod_rr);
+
+        alphas.push_back(alpha);
+        if (new_inner_prod_rr / norm_rhs_squared < tag.tolerance() * tag.tolerance() || new_inner_prod_rr < tag.abs_tolerance() * tag.abs_tolerance())    //squared norms involved here
+        {
+          inner_prod_rr = new_inner_prod_rr;
+          done = true;
+          break;
+        }
+
+        NumericT beta = new_inner_prod_rr / inner_prod_rr;
+        betas.push_back(beta);
+        for (vcl_size_t i=0; i<basis_size; ++i)
+          coords[i][2] = coords[i][1] + beta * coords[i][2];
+        inner_prod_rr = new_inner_prod_rr;
+      }
+
+      //
+      // Recover x, r, and p from their coordinates:
+      //
+      viennacl::matrix<NumericT, viennacl::column_major> vcl_coords = block_krylov_from_host(coords, ctx);
+      viennacl::matrix<NumericT, viennacl::column_major> xrp(n, 3, ctx);
+      xrp = viennacl::linalg::prod(Y, vcl_coords);
+      result   += viennacl::vector_base<NumericT>(xrp.handle(), n, 0, 1);
+      residual  = viennacl::vector_base<NumericT>(xrp.handle(), n,     xrp.internal_size1(), 1);
+      p         = viennacl::vector_base<NumericT>(xrp.handle(), n, 2 * xrp.internal_size1(), 1);
+
+      if (monitor && monitor(result, std::sqrt(inner_prod_rr / norm_rhs_squared), monitor_data))
+        break;
+
+      //
+      // Update the spectral interval from the Ritz values of the Lanczos matrix (the extremal Ritz values converge quickly, so the first iterations are sufficient):
+      //
+      vcl_size_t lanczos_size = std::min(betas.size() + 1, alphas.size());
+      if (!done && lanczos_size <= 40)
+      {
+        HostMatrixType T(lanczos_size, std::vector<NumericT>(lanczos_size));
+        for (vcl_size_t j=0; j<lanczos_size; ++j)
+        {
+          T[j][j] = NumericT(1) / alphas[j];
+          if (j > 0)
+            T[j][j] += betas[j-1] / alphas[j-1];
+          if (j + 1 < lanczos_size)
+          {
+            T[j][j+1] = std::sqrt(betas[j]) / alphas[j];
+            T[j+1][j] = T[j][j+1];
+          }
+        }
+        NumericT lambda_min_estimate;
+        NumericT lambda_max_estimate;
+        s_step_spectral_interval(T, lanczos_size, lambda_min_estimate, lambda_max_estimate);
+        lambda_max = lambda_max_estimate;
+      }
+    }
+
+    //store last error estimate:
+    tag.error(std::sqrt(inner_prod_rr / norm_rhs_squared));
+
+    return result;
+  }
+
+
+  /** @brief Overload for the pipelined and s-step CG implementations for the ViennaCL sparse matrix types */
   template<typename NumericT>
   viennacl::vector<NumericT> solve_impl(viennacl::compressed_matrix<NumericT> const & A,
                                         viennacl::vector<NumericT> const & rhs,
@@ -196,11 +394,13 @@ namespace detail
                                         bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
                                         void *monitor_data = NULL)
   {
-    return pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
+    if (tag.s() > 1)
+      return detail::s_step_solve(A, rhs, tag, monitor, monitor_data);
+    return detail::pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
   }
 
 
-  /** @brief Overload for the pipelined CG implementation for the ViennaCL sparse matrix types */
+  /** @brief Overload for the pipelined and s-step CG implementations for the ViennaCL sparse matrix types */
   template<typename NumericT>
   viennacl::vector<NumericT> solve_impl(viennacl::coordinate_matrix<NumericT> const & A,
                                         viennacl::vector<NumericT> const & rhs,
@@ -209,12 +409,14 @@ namespace detail
                                         bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
                                         void *monitor_data = NULL)
   {
+    if (tag.s() > 1)
+      return detail::s_step_solve(A, rhs, tag, monitor, monitor_data);
     return detail::pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
   }
 
 
 
-  /** @brief Overload for the pipelined CG implementation for the ViennaCL sparse matrix types */
+  /** @brief Overload for the pipelined and s-step CG implementations for the ViennaCL sparse matrix types */
   template<typename NumericT>
   viennacl::vector<NumericT> solve_impl(viennacl::ell_matrix<NumericT> const & A,
                                         viennacl::vector<NumericT> const & rhs,
@@ -223,12 +425,14 @@ namespace detail
                                         bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
                                         void *monitor_data = NULL)
   {
+    if (tag.s() > 1)
+      return detail::s_step_solve(A, rhs, tag, monitor, monitor_data);
     return detail::pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
   }
 
 
 
-  /** @brief Overload for the pipelined CG implementation for the ViennaCL sparse matrix types */
+  /** @brief Overload for the pipelined and s-step CG implementations for the ViennaCL sparse matrix types */
   template<typename NumericT>
   viennacl::vector<NumericT> solve_impl(viennacl::sliced_ell_matrix<NumericT> const & A,
                                         viennacl::vector<NumericT> const & rhs,
@@ -237,11 +441,13 @@ namespace detail
                                         bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
                                         void *monitor_data = NULL)
   {
+    if (tag.s() > 1)
+      return detail::s_step_solve(A, rhs, tag, monitor, monitor_data);
     return detail::pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
   }
 
 
-  /** @brief Overload for the pipelined CG implementation for the ViennaCL sparse matrix types */
+  /** @brief Overload for the pipelined and s-step CG implementations for the ViennaCL sparse matrix types */
   template<typename NumericT>
   viennacl::vector<NumericT> solve_impl(viennacl::hyb_matrix<NumericT> const & A,
                                         viennacl::vector<NumericT> const & rhs,
@@ -250,6 +456,8 @@ namespace detail
                                         bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
                                         void *monitor_data = NULL)
   {
+    if (tag.s() > 1)
+      return detail::s_step_solve(A, rhs, tag, monitor, monitor_data);
     return detail::pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
   }
 
@@ -321,6 +529,290 @@ namespace detail
     return result;
   }
 
+
+  /** @brief Implementation of a pipelined preconditioned conjugate gradient algorithm with a diagonal preconditioner M = diag(d), specialized for ViennaCL types in main memory.
+  *
+  * Same recurrences as the unpreconditioned pipelined_solve(), with the inner products (r, r) and (Ap, Ap) replaced by (r, M^{-1} r) and (Ap, M^{-1} Ap).
+  * Each iteration consists of one fused vector update (result, r, and p) and one fused matrix-vector product, each including its inner products.
+  * The preconditioned residual M^{-1} r is computed on the fly and never stored.
+  *
+  * @param A            The system matrix
+  * @param rhs          The load vector
+  * @param tag          Solver configuration tag
+  * @param diagonal     The diagonal d of the preconditioner
+  * @param monitor      A callback routine which is called in each iteration
+  * @param monitor_data Data pointer to be passed to the callback routine to pass on user-specific data
+  * @return The result vector
+  */
+  template<typename MatrixT, typename NumericT>
+  viennacl::vector<NumericT> pipelined_solve(MatrixT const & A,
+                                             viennacl::vector<NumericT> const & rhs,
+                                             cg_tag const & tag,
+                                             viennacl::vector<NumericT> const & diagonal,
+                                             bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                             void *monitor_data = NULL)
+  {
+    typedef typename viennacl::vector<NumericT>::difference_type   difference_type;
+
+    viennacl::vector<NumericT> result(rhs);
+    viennacl::traits::clear(result);
+
+    viennacl::vector<NumericT> inv_diag = viennacl::scalar_vector<NumericT>(rhs.size(), NumericT(1), viennacl::traits::context(rhs));
+    inv_diag = viennacl::linalg::element_div(inv_diag, diagonal);
+
+    viennacl::vector<NumericT> residual(rhs);
+    viennacl::vector<NumericT> p = viennacl::linalg::element_prod(inv_diag, residual);
+    viennacl::vector<NumericT> Ap(rhs.size(), viennacl::traits::context(rhs));
+    viennacl::vector<NumericT> inner_prod_buffer = viennacl::zero_vector<NumericT>(3*256, viennacl::traits::context(rhs)); // temporary buffer
+    std::vector<NumericT>      host_inner_prod_buffer(inner_prod_buffer.size());
+    vcl_size_t                 buffer_size_per_vector = inner_prod_buffer.size() / 3;
+    difference_type            buffer_offset_per_vector = static_cast<difference_type>(buffer_size_per_vector);
+
+    NumericT norm_rhs_squared = viennacl::linalg::inner_prod(residual, p);
+
+    if (norm_rhs_squared <= tag.abs_tolerance() * tag.abs_tolerance()) //check for early convergence of A*x = 0
+      return result;
+
+    viennacl::linalg::pipelined_pcg_prod(A, p, Ap, inv_diag, inner_prod_buffer);
+    viennacl::fast_copy(inner_prod_buffer.begin(), inner_prod_buffer.end(), host_inner_prod_buffer.begin());
+
+    NumericT inner_prod_rz   = norm_rhs_squared;
+    NumericT inner_prod_ApAp = std::accumulate(host_inner_prod_buffer.begin() +     buffer_offset_per_vector, host_inner_prod_buffer.begin() + 2 * buffer_offset_per_vector, NumericT(0));
+    NumericT inner_prod_pAp  = std::accumulate(host_inner_prod_buffer.begin() + 2 * buffer_offset_per_vector, host_inner_prod_buffer.begin() + 3 * buffer_offset_per_vector, NumericT(0));
+    NumericT alpha = inner_prod_rz / inner_prod_pAp;
+    NumericT beta  = (alpha * alpha * inner_prod_ApAp - inner_prod_rz) / inner_prod_rz;
+
+    for (unsigned int i = 0; i < tag.max_iterations(); ++i)
+    {
+      tag.iters(i+1);
+
+      viennacl::linalg::pipelined_pcg_vector_update(result, alpha, p, residual, Ap, inv_diag, beta, inner_prod_buffer);
+      viennacl::linalg::pipelined_pcg_prod(A, p, Ap, inv_diag, inner_prod_buffer);
+
+      // bring back the partial results to the host:
+      viennacl::fast_copy(inner_prod_buffer.begin(), inner_prod_buffer.end(), host_inner_prod_buffer.begin());
+
+      inner_prod_rz   = std::accumulate(host_inner_prod_buffer.begin(),                                host_inner_prod_buffer.begin() +     buffer_offset_per_vector, NumericT(0));
+      inner_prod_ApAp = std::accumulate(host_inner_prod_buffer.begin() +     buffer_offset_per_vector, host_inner_prod_buffer.begin() + 2 * buffer_offset_per_vector, NumericT(0));
+      inner_prod_pAp  = std::accumulate(host_inner_prod_buffer.begin() + 2 * buffer_offset_per_vector, host_inner_prod_buffer.begin() + 3 * buffer_offset_per_vector, NumericT(0));
+
+      if (monitor && monitor(result, std::sqrt(std::fabs(inner_prod_rz / norm_rhs_squared)), monitor_data))
+        break;
+      if (std::fabs(inner_prod_rz / norm_rhs_squared) < tag.tolerance() *  tag.tolerance() || std::fabs(inner_prod_rz) < tag.abs_tolerance() * tag.abs_tolerance())    //squared norms involved here
+        break;
+
+      alpha = inner_prod_rz / inner_prod_pAp;
+      beta  = (alpha*alpha*inner_prod_ApAp - inner_prod_rz) / inner_prod_rz;
+    }
+
+    //store last error estimate:
+    tag.error(std::sqrt(std::fabs(inner_prod_rz) / norm_rhs_squared));
+
+    return result;
+  }
+
+
+  /** @brief Overload for the pipelined preconditioned CG implementation for a compressed_matrix with Jacobi preconditioner. Uses the generic implementation if the data does not reside in main memory. */
+  template<typename NumericT>
+  viennacl::vector<NumericT> solve_impl(viennacl::compressed_matrix<NumericT> const & A,
+                                        viennacl::vector<NumericT> const & rhs,
+                                        cg_tag const & tag,
+                                        viennacl::linalg::jacobi_precond<viennacl::compressed_matrix<NumericT> > const & precond,
+                                        bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                        void *monitor_data = NULL)
+  {
+    if (viennacl::traits::active_handle_id(rhs) == viennacl::MAIN_MEMORY)
+      return detail::pipelined_solve(A, rhs, tag, precond.diagonal(), monitor, monitor_data);
+    return detail::solve_impl<viennacl::compressed_matrix<NumericT>, viennacl::vector<NumericT>, viennacl::linalg::jacobi_precond<viennacl::compressed_matrix<NumericT> > >(A, rhs, tag, precond, monitor, monitor_data);
+  }
+
+
+  /** @brief Overload for the pipelined preconditioned CG implementation for a compressed_matrix with row scaling preconditioner. Uses the generic implementation if the data does not reside in main memory. */
+  template<typename NumericT>
+  viennacl::vector<NumericT> solve_impl(viennacl::compressed_matrix<NumericT> const & A,
+                                        viennacl::vector<NumericT> const & rhs,
+                                        cg_tag const & tag,
+                                        viennacl::linalg::row_scaling<viennacl::compressed_matrix<NumericT> > const & precond,
+                                        bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                        void *monitor_data = NULL)
+  {
+    if (viennacl::traits::active_handle_id(rhs) == viennacl::MAIN_MEMORY)
+      return detail::pipelined_solve(A, rhs, tag, precond.diagonal(), monitor, monitor_data);
+    return detail::solve_impl<viennacl::compressed_matrix<NumericT>, viennacl::vector<NumericT>, viennacl::linalg::row_scaling<viennacl::compressed_matrix<NumericT> > >(A, rhs, tag, precond, monitor, monitor_data);
+  }
+
+
+  /** @brief Overload for the pipelined preconditioned CG implementation for a coordinate_matrix with Jacobi preconditioner. Uses the generic implementation if the data does not reside in main memory. */
+  template<typename NumericT>
+  viennacl::vector<NumericT> solve_impl(viennacl::coordinate_matrix<NumericT> const & A,
+                                        viennacl::vector<NumericT> const & rhs,
+                                        cg_tag const & tag,
+                                        viennacl::linalg::jacobi_precond<viennacl::coordinate_matrix<NumericT> > const & precond,
+                                        bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                        void *monitor_data = NULL)
+  {
+    if (viennacl::traits::active_handle_id(rhs) == viennacl::MAIN_MEMORY)
+      return detail::pipelined_solve(A, rhs, tag, precond.diagonal(), monitor, monitor_data);
+    return detail::solve_impl<viennacl::coordinate_matrix<NumericT>, viennacl::vector<NumericT>, viennacl::linalg::jacobi_precond<viennacl::coordinate_matrix<NumericT> > >(A, rhs, tag, precond, monitor, monitor_data);
+  }
+
+
+  /** @brief Overload for the pipelined preconditioned CG implementation for a coordinate_matrix with row scaling preconditioner. Uses the generic implementation if the data does not reside in main memory. */
+  template<typename NumericT>
+  viennacl::vector<NumericT> solve_impl(viennacl::coordinate_matrix<NumericT> const & A,
+                                        viennacl::vector<NumericT> const & rhs,
+                                        cg_tag const & tag,
+                                        viennacl::linalg::row_scaling<viennacl::coordinate_matrix<NumericT> > const & precond,
+                                        bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                        void *monitor_data = NULL)
+  {
+    if (viennacl::traits::active_handle_id(rhs) == viennacl::MAIN_MEMORY)
+      return detail::pipelined_solve(A, rhs, tag, precond.diagonal(), monitor, monitor_data);
+    return detail::solve_impl<viennacl::coordinate_matrix<NumericT>, viennacl::vector<NumericT>, viennacl::linalg::row_scaling<viennacl::coordinate_matrix<NumericT> > >(A, rhs, tag, precond, monitor, monitor_data);
+  }
+
+
+
+  /** @brief Implementation of the breakdown-free block conjugate gradient method for multiple right hand sides.
+  *
+  * Follows H. Ji and Y. Li, "A breakdown-free block conjugate gradient method", BIT Numer. Math. 57(2), 379-403 (2017):
+  * The search directions are orthonormalized in each iteration, dropping (numerically) linearly dependent directions, so identical or linearly dependent right hand sides do not lead to a breakdown.
+  * All columns share a single sparse matrix-matrix product per iteration, and the small Gram systems are solved on the host.
+  * Columns are removed from the iteration (deflated) as soon as their residual is sufficiently reduced.
+  *
+  * @param A        The system matrix
+  * @param rhs      The right hand sides (one per column)
+  * @param tag      Solver configuration tag. The number of iterations refers to block iterations, the error to the largest relative residual of all columns.
+  * @param precond  A preconditioner, applied to each column separately
+  * @return The solutions (one per column)
+  */
+  template<typename MatrixT, typename NumericT, typename F, unsigned int AlignmentV, typename PreconditionerT>
+  viennacl::matrix<NumericT, F, AlignmentV> block_solve_impl(MatrixT const & A,
+                                                             viennacl::matrix<NumericT, F, AlignmentV> const & rhs,
+                                                             cg_tag const & tag,
+                                                             PreconditionerT const & precond)
+  {
+    typedef viennacl::matrix<NumericT, viennacl::column_major>   BlockType;
+    typedef std::vector< std::vector<NumericT> >                 HostMatrixType;
+
+    viennacl::context ctx = viennacl::traits::context(rhs);
+    vcl_size_t n = rhs.size1();
+    vcl_size_t num_rhs = rhs.size2();
+    viennacl::range all_rows(0, n);
+
+    tag.iters(0);
+    tag.error(0);
+
+    viennacl::matrix<NumericT, F, AlignmentV> result(n, num_rhs, ctx);
+    if (n == 0 || num_rhs == 0)
+      return result;
+
+    BlockType X_all(n, num_rhs, ctx);
+    BlockType R(n, num_rhs, ctx);
+    detail::block_krylov_copy(rhs, R);
+
+    NumericT tol     = static_cast<NumericT>(tag.tolerance());
+    NumericT abs_tol = static_cast<NumericT>(tag.abs_tolerance());
+
+    // columns with zero right hand side have the zero solution:
+    std::vector<NumericT> rhs_norms = detail::block_krylov_column_norms(R);
+    std::vector<NumericT> errors(num_rhs);
+    std::vector<vcl_size_t> active;   // original column index of each column in the iteration
+    for (vcl_size_t j=0; j<num_rhs; ++j)
+      if (rhs_norms[j] > abs_tol)
+      {
+        active.push_back(j);
+        errors[j] = NumericT(1);
+      }
+
+    if (active.empty())
+      return result;
+
+    if (active.size() < num_rhs)
+      detail::block_krylov_assign(R, detail::block_krylov_select_columns(R, active));
+    BlockType X(n, active.size(), ctx);
+
+    BlockType Z = R;
+    detail::block_krylov_apply_precond(Z, precond);
+    BlockType P = Z;
+    vcl_size_t rank = detail::block_krylov_orthonormalize(P);
+
+    for (unsigned int i = 0; i < tag.max_iterations() && rank > 0; ++i)
+    {
+      tag.iters(i+1);
+
+      BlockType Q(n, P.size2(), ctx);   // Note: Constructing Q directly from the product would result in row-major memory layout
+      Q = viennacl::linalg::prod(A, P);
+
+      // alpha = (P^T A P)^{-1} P^T R
+      BlockType vcl_PtQ = viennacl::linalg::prod(trans(P), Q);
+      BlockType vcl_PtR = viennacl::linalg::prod(trans(P), R);
+      HostMatrixType L = detail::block_krylov_to_host(vcl_PtQ);
+      for (vcl_size_t k=0; k<L.size(); ++k)
+        for (vcl_size_t l=0; l<k; ++l)
+          L[k][l] = L[l][k] = NumericT(0.5) * (L[k][l] + L[l][k]);
+      if (!detail::block_krylov_cholesky(L)) // P^T A P not positive definite: A or the preconditioner is not symmetric positive definite
+        break;
+
+      HostMatrixType alpha = detail::block_krylov_to_host(vcl_PtR);
+      detail::block_krylov_cholesky_solve(L, alpha);
+      BlockType vcl_alpha = detail::block_krylov_from_host(alpha, ctx);
+
+      X += viennacl::linalg::prod(P, vcl_alpha);
+      R -= viennacl::linalg::prod(Q, vcl_alpha);
+
+      // deflate converged columns:
+      std::vector<NumericT> residual_norms = detail::block_krylov_column_norms(R);
+      std::vector<vcl_size_t> remaining;
+      for (vcl_size_t j=0; j<active.size(); ++j)
+      {
+        errors[active[j]] = residual_norms[j] / rhs_norms[active[j]];
+        if (errors[active[j]] < tol || residual_norms[j] < abs_tol)
+          viennacl::project(X_all, all_rows, viennacl::range(active[j], active[j]+1)) = viennacl::project(X, all_rows, viennacl::range(j, j+1));
+        else
+          remaining.push_back(j);
+      }
+
+      if (remaining.empty())
+      {
+        active.clear();
+        break;
+      }
+
+      if (remaining.size() < active.size())
+      {
+        detail::block_krylov_assign(R, detail::block_krylov_select_columns(R, remaining));
+        detail::block_krylov_assign(X, detail::block_krylov_select_columns(X, remaining));
+        for (vcl_size_t j=0; j<remaining.size(); ++j)
+          active[j] = active[remaining[j]];
+        active.resize(remaining.size());
+      }
+
+      // P = orth(Z - P (P^T A P)^{-1} Q^T Z)
+      detail::block_krylov_assign(Z, R);
+      detail::block_krylov_apply_precond(Z, precond);
+
+      BlockType vcl_QtZ = viennacl::linalg::prod(trans(Q), Z);
+      HostMatrixType beta = detail::block_krylov_to_host(vcl_QtZ);
+      detail::block_krylov_cholesky_solve(L, beta);
+      BlockType vcl_beta = detail::block_krylov_from_host(beta, ctx);
+
+      Z -= viennacl::linalg::prod(P, vcl_beta);
+      detail::block_krylov_assign(P, Z);
+      rank = detail::block_krylov_orthonormalize(P);
+    }
+
+    // columns not converged:
+    for (vcl_size_t j=0; j<active.size(); ++j)
+      viennacl::project(X_all, all_rows, viennacl::range(active[j], active[j]+1)) = viennacl::project(X, all_rows, viennacl::range(j, j+1));
+
+    //store last error estimate:
+    tag.error(*std::max_element(errors.begin(), errors.end()));
+
+    detail::block_krylov_copy(X_all, result);
+    return result;
+  }
+
 }
 
 
@@ -341,6 +833,22 @@ VectorT solve(MatrixT const & matrix, VectorT const & rhs, cg_tag const & tag, P
   return detail::solve_impl(matrix, rhs, tag, precond);
 }
 
+/** @brief Block conjugate gradient solver for multiple right hand sides, given as the columns of a dense matrix.
+*
+* Each iteration requires one sparse matrix-matrix product with all right hand sides not yet converged, thus the system matrix is only read once per iteration for all of them.
+*
+* @param matrix     The system matrix (symmetric positive definite)
+* @param rhs        The right hand sides (one per column)
+* @param tag        Solver configuration tag
+* @param precond    A preconditioner. Precondition operation is done via member function apply() for each column
+* @return The solutions (one per column)
+*/
+template<typename MatrixT, typename NumericT, typename F, unsigned int AlignmentV, typename PreconditionerT>
+viennacl::matrix<NumericT, F, AlignmentV> solve(MatrixT const & matrix, viennacl::matrix<NumericT, F, AlignmentV> const & rhs, cg_tag const & tag, PreconditionerT const & precond)
+{
+  return detail::block_solve_impl(matrix, rhs, tag, precond);
+}
+
 /** @brief Convenience overload for calling the CG solver using types from the C++ STL.
   *
   * A std::vector<std::map<T, U> > matrix is convenient for e.g. finite element assembly.
@@ -1008,6 +1008,71 @@ namespace detail
 }
 
 
+//
+// Compressed matrix with index types other than unsigned int: The CUDA kernels operate on 32-bit indices only.
+//
+
+namespace detail
+{
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void row_info(compressed_matrix<NumericT, AlignmentV, IndexT> const &, vector_base<NumericT> &, viennacl::linalg::detail::row_info_types)
+  {
+    throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the CUDA backend");
+  }
+
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT, typename SolverTagT>
+  void block_inplace_solve(const matrix_expression<const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                                   const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                                   op_trans> &,
+                           viennacl::backend::mem_handle const &, vcl_size_t,
+                           vector_base<NumericT> const &, vector_base<NumericT> &, SolverTagT)
+  {
+    throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the CUDA backend");
+  }
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::vector_base<NumericT> const &, NumericT,
+               viennacl::vector_base<NumericT> &, NumericT)
+{
+  throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the CUDA backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::matrix_base<NumericT> const &,
+               viennacl::matrix_base<NumericT> &)
+{
+  throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the CUDA backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::matrix_expression<const viennacl::matrix_base<NumericT>,
+                                           const viennacl::matrix_base<NumericT>,
+                                           viennacl::op_trans > const &,
+               viennacl::matrix_base<NumericT> &)
+{
+  throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the CUDA backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT, typename SolverTagT>
+void inplace_solve(compressed_matrix<NumericT, AlignmentV, IndexT> const &, vector_base<NumericT> &, SolverTagT)
+{
+  throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the CUDA backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT, typename SolverTagT>
+void inplace_solve(matrix_expression< const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                      const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                      op_trans> const &,
+                   vector_base<NumericT> &, SolverTagT)
+{
+  throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the CUDA backend");
+}
+
+
 //
 // Compressed Compressed Matrix
 //
@@ -1739,6 +1804,46 @@ void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV> & sp_mat,
 }
 
 
+//
+// Coordinate matrix with index types other than unsigned int: The CUDA kernels operate on 32-bit indices only.
+//
+
+namespace detail
+{
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void row_info(coordinate_matrix<NumericT, AlignmentV, IndexT> const &, vector_base<NumericT> &, viennacl::linalg::detail::row_info_types)
+  {
+    throw memory_exception("coordinate_matrix with index types other than unsigned int not supported by the CUDA backend");
+  }
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::vector_base<NumericT> const &, NumericT,
+               viennacl::vector_base<NumericT> &, NumericT)
+{
+  throw memory_exception("coordinate_matrix with index types other than unsigned int not supported by the CUDA backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::matrix_base<NumericT> const &,
+               viennacl::matrix_base<NumericT> &)
+{
+  throw memory_exception("coordinate_matrix with index types other than unsigned int not supported by the CUDA backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::matrix_expression<const viennacl::matrix_base<NumericT>,
+                                           const viennacl::matrix_base<NumericT>,
+                                           viennacl::op_trans > const &,
+               viennacl::matrix_base<NumericT> &)
+{
+  throw memory_exception("coordinate_matrix with index types other than unsigned int not supported by the CUDA backend");
+}
+
+
 //
 // ELL Matrix
 //
@@ -2197,6 +2302,7 @@ template<typename AlphaBetaHandlerT, typename NumericT>
 __global__ void sliced_ell_matrix_vec_mul_kernel(const unsigned int * columns_per_block,
                                                  const unsigned int * column_indices,
                                                  const unsigned int * block_start,
+                                                 const unsigned int * row_permutation,
                                                  const NumericT * elements,
                                                  const NumericT * x,
                                                  unsigned int start_x,
@@ -2232,13 +2338,18 @@ __global__ void sliced_ell_matrix_vec_mul_kernel(const unsigned int * columns_pe
     }
 
     if (row < size_result)
+    {
+      if (row_permutation)
+        row = row_permutation[row];
       AlphaBetaHandlerT::apply(result[row * inc_result + start_result], alpha, sum, beta);
+    }
   }
 }
 
 /** @brief Carries out matrix-vector multiplication with a sliced_ell_matrix
 *
 * Implementation of the convenience expression result = prod(mat, vec);
+* Rows reordered by sorting within the sorting scope are written to their original position in the result.
 *
 * @param mat    The matrix
 * @param vec    The vector
@@ -2251,10 +2362,13 @@ void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & mat,
                      viennacl::vector_base<NumericT> & result,
                NumericT beta)
 {
+  const unsigned int * row_permutation = (mat.handle4().raw_size() > 0) ? viennacl::cuda_arg<unsigned int>(mat.handle4()) : NULL;
+
   if (alpha < NumericT(1) || alpha > NumericT(1) || beta < 0 || beta > 0)
     sliced_ell_matrix_vec_mul_kernel<detail::spmv_alpha_beta><<<256, 256>>>(viennacl::cuda_arg<unsigned int>(mat.handle1()),
                                                    viennacl::cuda_arg<unsigned int>(mat.handle2()),
                                                    viennacl::cuda_arg<unsigned int>(mat.handle3()),
+                                                   row_permutation,
                                                    viennacl::cuda_arg<NumericT>(mat.handle()),
                                                    viennacl::cuda_arg(vec),
                                                    static_cast<unsigned int>(vec.start()),
@@ -2272,6 +2386,7 @@ void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & mat,
     sliced_ell_matrix_vec_mul_kernel<detail::spmv_pure><<<256, 256>>>(viennacl::cuda_arg<unsigned int>(mat.handle1()),
                                                    viennacl::cuda_arg<unsigned int>(mat.handle2()),
                                                    viennacl::cuda_arg<unsigned int>(mat.handle3()),
+                                                   row_permutation,
                                                    viennacl::cuda_arg<NumericT>(mat.handle()),
                                                    viennacl::cuda_arg(vec),
                                                    static_cast<unsigned int>(vec.start()),
@@ -2289,6 +2404,21 @@ void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & mat,
 }
 
 
+//
+// Block Compressed Matrix: No CUDA kernels yet.
+//
+
+template<typename NumericT, unsigned int BlockSize>
+void prod_impl(const viennacl::block_compressed_matrix<NumericT, BlockSize> &,
+               const viennacl::vector_base<NumericT> &,
+               NumericT,
+                     viennacl::vector_base<NumericT> &,
+               NumericT)
+{
+  throw memory_exception("block_compressed_matrix not supported by the CUDA backend");
+}
+
+
 //
 // Hybrid Matrix
 //
@@ -750,6 +750,7 @@ void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
   // Stage 3: Compute entries in C
   //
   C.reserve(current_offset, false);
+  C.reset_row_statistics();
 
   viennacl::vector<NumericT> scratchpad_values(scratchpad_offset, viennacl::traits::context(A)); // upper bound for the nonzeros per row encountered for each work group
 
@@ -609,6 +609,7 @@ void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
   // Stage 3: Compute entries in C
   //
   C.reserve(current_offset, false);
+  C.reset_row_statistics();
 
   if (max_subwarp_size == 32)
   {
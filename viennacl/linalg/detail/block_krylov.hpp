@@ -0,0 +1,421 @@
+#ifndef VIENNACL_LINALG_DETAIL_BLOCK_KRYLOV_HPP_
+#define VIENNACL_LINALG_DETAIL_BLOCK_KRYLOV_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/detail/block_krylov.hpp
+    @brief Helper routines for the block Krylov solvers (multiple right hand sides) in cg.hpp and gmres.hpp.
+
+    A block of vectors is stored as the columns of a column-major dense matrix, so that each vector is contiguous in memory.
+    The small dense matrices (Gram matrices, coefficients, block Hessenberg matrix) are kept on the host as std::vector< std::vector<> >.
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/sum.hpp"
+#include "viennacl/traits/context.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace detail
+{
+
+  /** @brief Copies a (small) dense matrix to the host */
+  template<typename NumericT>
+  std::vector< std::vector<NumericT> > block_krylov_to_host(viennacl::matrix<NumericT, viennacl::column_major> const & M)
+  {
+    std::vector< std::vector<NumericT> > result(M.size1(), std::vector<NumericT>(M.size2()));
+    viennacl::copy(M, result);
+    return result;
+  }
+
+  /** @brief Copies a (small) dense matrix from the host to the memory domain given by the context */
+  template<typename NumericT>
+  viennacl::matrix<NumericT, viennacl::column_major> block_krylov_from_host(std::vector< std::vector<NumericT> > const & M, viennacl::context ctx)
+  {
+    viennacl::matrix<NumericT, viennacl::column_major> result(M.size(), M[0].size(), ctx);
+    viennacl::copy(M, result);
+    return result;
+  }
+
+  /** @brief Assigns a block of vectors to another block of vectors, which is resized if the number of vectors differs */
+  template<typename NumericT>
+  void block_krylov_assign(viennacl::matrix<NumericT, viennacl::column_major> & dest, viennacl::matrix<NumericT, viennacl::column_major> const & src)
+  {
+    if (dest.size1() != src.size1() || dest.size2() != src.size2())
+      dest.resize(src.size1(), src.size2(), false);
+    dest = src;
+  }
+
+  /** @brief Copies a dense matrix to a dense matrix of the same size, but possibly different memory layout */
+  template<typename NumericT>
+  void block_krylov_copy(viennacl::matrix_base<NumericT> const & src, viennacl::matrix_base<NumericT> & dest)
+  {
+    if (src.row_major() == dest.row_major())
+    {
+      dest = src;
+      return;
+    }
+
+    viennacl::vector<NumericT> tmp(src.size1(), viennacl::traits::context(src));
+    for (vcl_size_t j=0; j<src.size2(); ++j)
+    {
+      vcl_size_t column_start  = dest.row_major() ? dest.start1() * dest.internal_size2() + dest.start2() + j * dest.stride2()
+                                                  : dest.start1() + (dest.start2() + j * dest.stride2()) * dest.internal_size1();
+      vcl_size_t column_stride = dest.row_major() ? dest.stride1() * dest.internal_size2() : dest.stride1();
+      viennacl::vector_base<NumericT> dest_column(dest.handle(), dest.size1(), column_start, column_stride);
+
+      tmp = viennacl::column(src, static_cast<unsigned int>(j));
+      dest_column = tmp;
+    }
+  }
+
+  /** @brief Returns the Euclidean norms of all columns of a block of vectors */
+  template<typename NumericT>
+  std::vector<NumericT> block_krylov_column_norms(viennacl::matrix<NumericT, viennacl::column_major> const & M)
+  {
+    viennacl::matrix<NumericT, viennacl::column_major> squares = viennacl::linalg::element_prod(M, M);
+    viennacl::vector<NumericT> sums = viennacl::linalg::column_sum(squares);
+
+    std::vector<NumericT> result(M.size2());
+    viennacl::copy(sums, result);
+    for (vcl_size_t j=0; j<result.size(); ++j)
+      result[j] = std::sqrt(result[j]);
+    return result;
+  }
+
+  /** @brief Returns a block of vectors consisting of the given columns of M */
+  template<typename NumericT>
+  viennacl::matrix<NumericT, viennacl::column_major> block_krylov_select_columns(viennacl::matrix<NumericT, viennacl::column_major> const & M,
+                                                                                 std::vector<vcl_size_t> const & columns)
+  {
+    viennacl::matrix<NumericT, viennacl::column_major> result(M.size1(), columns.size(), viennacl::traits::context(M));
+    viennacl::range all_rows(0, M.size1());
+    for (vcl_size_t j=0; j<columns.size(); ++j)
+      viennacl::project(result, all_rows, viennacl::range(j, j+1)) = viennacl::project(M, all_rows, viennacl::range(columns[j], columns[j]+1));
+    return result;
+  }
+
+  /** @brief Applies the preconditioner to each column of a block of vectors */
+  template<typename NumericT, typename PreconditionerT>
+  void block_krylov_apply_precond(viennacl::matrix<NumericT, viennacl::column_major> & M, PreconditionerT const & precond)
+  {
+    viennacl::vector<NumericT> z(M.size1(), viennacl::traits::context(M));
+    for (vcl_size_t j=0; j<M.size2(); ++j)
+    {
+      viennacl::vector_base<NumericT> M_column(M.handle(), M.size1(), j * M.internal_size1(), 1);
+      z = M_column;
+      precond.apply(z);
+      M_column = z;
+    }
+  }
+
+  /** @brief Nothing to do without a preconditioner */
+  template<typename NumericT>
+  void block_krylov_apply_precond(viennacl::matrix<NumericT, viennacl::column_major> &, viennacl::linalg::no_precond const &) {}
+
+  /** @brief Computes the eigenvalues and eigenvectors of a small dense symmetric matrix on the host using cyclic Jacobi rotations.
+  *
+  * @param A   The symmetric matrix. Overwritten with a diagonal matrix holding the eigenvalues on exit.
+  * @param V   Holds the eigenvectors (as columns) on exit
+  */
+  template<typename NumericT>
+  void block_krylov_symmetric_eig(std::vector< std::vector<NumericT> > & A, std::vector< std::vector<NumericT> > & V)
+  {
+    vcl_size_t k = A.size();
+    V = std::vector< std::vector<NumericT> >(k, std::vector<NumericT>(k));
+    for (vcl_size_t i=0; i<k; ++i)
+      V[i][i] = NumericT(1);
+
+    NumericT eps = std::numeric_limits<NumericT>::epsilon();
+    for (unsigned int sweep = 0; sweep < 100; ++sweep)
+    {
+      NumericT norm_diag = 0;
+      NumericT norm_offdiag = 0;
+      for (vcl_size_t i=0; i<k; ++i)
+        for (vcl_size_t j=0; j<k; ++j)
+          (i == j ? norm_diag : norm_offdiag) += A[i][j] * A[i][j];
+      if (norm_offdiag <= eps * eps * norm_diag)
+        break;
+
+      for (vcl_size_t p=0; p<k; ++p)
+        for (vcl_size_t q=p+1; q<k; ++q)
+        {
+          if (A[p][q] == 0)
+            continue;
+
+          NumericT theta = (A[q][q] - A[p][p]) / (NumericT(2) * A[p][q]);
+          NumericT t = NumericT(1) / (std::fabs(theta) + std::sqrt(theta * theta + NumericT(1)));
+          if (theta < 0)
+            t = -t;
+          NumericT c = NumericT(1) / std::sqrt(t * t + NumericT(1));
+          NumericT s = t * c;
+
+          for (vcl_size_t r=0; r<k; ++r)
+          {
+            NumericT a_rp = A[r][p];
+            NumericT a_rq = A[r][q];
+            A[r][p] = c * a_rp - s * a_rq;
+            A[r][q] = s * a_rp + c * a_rq;
+          }
+          for (vcl_size_t r=0; r<k; ++r)
+          {
+            NumericT a_pr = A[p][r];
+            NumericT a_qr = A[q][r];
+            A[p][r] = c * a_pr - s * a_qr;
+            A[q][r] = s * a_pr + c * a_qr;
+          }
+          for (vcl_size_t r=0; r<k; ++r)
+          {
+            NumericT v_rp = V[r][p];
+            NumericT v_rq = V[r][q];
+            V[r][p] = c * v_rp - s * v_rq;
+            V[r][q] = s * v_rp + c * v_rq;
+          }
+        }
+    }
+  }
+
+  /** @brief Orthonormalizes the columns of a block of vectors using the SVQB method, dropping linearly dependent columns.
+  *
+  * Two passes of P <- P D U L^{-1/2} are carried out, where D scales the Gram matrix P^T P to unit diagonal and D P^T P D = U L U^T.
+  * Eigenvalues below a small multiple of the machine precision (relative to the largest one) indicate (numerically) linearly dependent columns and are dropped.
+  * Only one dense matrix-matrix product with the block and one product for forming the Gram matrix are needed per pass.
+  *
+  * @param P   The block of vectors. Replaced by an orthonormal basis of its column space on exit.
+  * @return    The number of columns of the orthonormal basis (the numerical rank). P is left unchanged if zero is returned.
+  */
+  template<typename NumericT>
+  vcl_size_t block_krylov_orthonormalize(viennacl::matrix<NumericT, viennacl::column_major> & P)
+  {
+    typedef std::vector< std::vector<NumericT> >    HostMatrixType;
+
+    for (unsigned int pass = 0; pass < 2; ++pass)
+    {
+      vcl_size_t k = P.size2();
+      viennacl::matrix<NumericT, viennacl::column_major> vcl_G = viennacl::linalg::prod(trans(P), P);
+      HostMatrixType G = block_krylov_to_host(vcl_G);
+
+      std::vector<NumericT> D(k);
+      for (vcl_size_t i=0; i<k; ++i)
+        D[i] = (G[i][i] > 0) ? NumericT(1) / std::sqrt(G[i][i]) : NumericT(0);
+      HostMatrixType G_scaled(k, std::vector<NumericT>(k));
+      for (vcl_size_t i=0; i<k; ++i)
+        for (vcl_size_t j=0; j<k; ++j)
+          G_scaled[i][j] = NumericT(0.5) * (G[i][j] + G[j][i]) * D[i] * D[j];
+
+      HostMatrixType U;
+      block_krylov_symmetric_eig(G_scaled, U);
+      G = G_scaled;
+
+      NumericT max_eigenvalue = 0;
+      for (vcl_size_t i=0; i<k; ++i)
+        max_eigenvalue = std::max(max_eigenvalue, G[i][i]);
+
+      std::vector<vcl_size_t> kept;
+      for (vcl_size_t i=0; i<k; ++i)
+        if (G[i][i] > NumericT(10 * k) * std::numeric_limits<NumericT>::epsilon() * max_eigenvalue)
+          kept.push_back(i);
+
+      if (kept.empty())
+        return 0;
+
+      HostMatrixType T(k, std::vector<NumericT>(kept.size()));
+      for (vcl_size_t i=0; i<k; ++i)
+        for (vcl_size_t j=0; j<kept.size(); ++j)
+          T[i][j] = D[i] * U[i][kept[j]] / std::sqrt(G[kept[j]][kept[j]]);
+
+      viennacl::matrix<NumericT, viennacl::column_major> vcl_T = block_krylov_from_host(T, viennacl::traits::context(P));
+      viennacl::matrix<NumericT, viennacl::column_major> P_new = viennacl::linalg::prod(P, vcl_T);
+      block_krylov_assign(P, P_new);
+    }
+
+    return P.size2();
+  }
+
+  /** @brief Computes the Cholesky factor L of a small symmetric positive definite matrix A = L L^T in-place on the host. Returns false if A is not (numerically) positive definite. */
+  template<typename NumericT>
+  bool block_krylov_cholesky(std::vector< std::vector<NumericT> > & A)
+  {
+    vcl_size_t k = A.size();
+    for (vcl_size_t j=0; j<k; ++j)
+    {
+      NumericT diag = A[j][j];
+      for (vcl_size_t l=0; l<j; ++l)
+        diag -= A[j][l] * A[j][l];
+      if (diag <= 0)
+        return false;
+      A[j][j] = std::sqrt(diag);
+
+      for (vcl_size_t i=j+1; i<k; ++i)
+      {
+        NumericT value = A[i][j];
+        for (vcl_size_t l=0; l<j; ++l)
+          value -= A[i][l] * A[j][l];
+        A[i][j] = value / A[j][j];
+      }
+    }
+    return true;
+  }
+
+  /** @brief Returns the inverse of the transpose L^T of the Cholesky factor computed by block_krylov_cholesky() (upper triangular), such that B L^{-T} has orthonormal columns if L L^T = B^T B */
+  template<typename NumericT>
+  std::vector< std::vector<NumericT> > block_krylov_cholesky_inverse_transpose(std::vector< std::vector<NumericT> > const & L)
+  {
+    vcl_size_t k = L.size();
+    std::vector< std::vector<NumericT> > result(k, std::vector<NumericT>(k));
+    for (vcl_size_t j=0; j<k; ++j)
+    {
+      result[j][j] = NumericT(1) / L[j][j];
+      for (vcl_size_t i2=0; i2<j; ++i2)
+      {
+        vcl_size_t i = j - i2 - 1;
+        NumericT value = 0;
+        for (vcl_size_t l=i+1; l<=j; ++l)
+          value += L[l][i] * result[l][j];
+        result[i][j] = -value / L[i][i];
+      }
+    }
+    return result;
+  }
+
+  /** @brief Solves L L^T X = B in-place for all columns of B on the host, where L is the Cholesky factor computed by block_krylov_cholesky() */
+  template<typename NumericT>
+  void block_krylov_cholesky_solve(std::vector< std::vector<NumericT> > const & L, std::vector< std::vector<NumericT> > & B)
+  {
+    vcl_size_t k = L.size();
+    for (vcl_size_t col=0; col<B[0].size(); ++col)
+    {
+      for (vcl_size_t i=0; i<k; ++i)
+      {
+        NumericT value = B[i][col];
+        for (vcl_size_t l=0; l<i; ++l)
+          value -= L[i][l] * B[l][col];
+        B[i][col] = value / L[i][i];
+      }
+      for (vcl_size_t i2=0; i2<k; ++i2)
+      {
+        vcl_size_t i = k - i2 - 1;
+        NumericT value = B[i][col];
+        for (vcl_size_t l=i+1; l<k; ++l)
+          value -= L[l][i] * B[l][col];
+        B[i][col] = value / L[i][i];
+      }
+    }
+  }
+
+  /** @brief Solves the small least squares problems min ||H y_j - s_j|| for all columns s_j of S on the host using Householder reflections.
+  *
+  * @param H               The matrix (at least as many rows as columns). Destroyed on exit.
+  * @param S               The right hand sides (same number of rows as H). Destroyed on exit.
+  * @param Y               The solutions y_j as columns on exit
+  * @param residual_norms  The residual norms ||H y_j - s_j|| on exit
+  */
+  template<typename NumericT>
+  void block_krylov_least_squares(std::vector< std::vector<NumericT> > & H,
+                                  std::vector< std::vector<NumericT> > & S,
+                                  std::vector< std::vector<NumericT> > & Y,
+                                  std::vector<NumericT> & residual_norms)
+  {
+    vcl_size_t rows = H.size();
+    vcl_size_t cols = H[0].size();
+    vcl_size_t num_rhs = S[0].size();
+
+    std::vector<NumericT> v(rows);
+    for (vcl_size_t c=0; c<cols; ++c)
+    {
+      NumericT norm = 0;
+      for (vcl_size_t i=c; i<rows; ++i)
+        norm += H[i][c] * H[i][c];
+      norm = std::sqrt(norm);
+      if (norm <= 0)
+        continue;
+
+      NumericT alpha = (H[c][c] > 0) ? -norm : norm;
+      NumericT v_norm_squared = 0;
+      for (vcl_size_t i=c; i<rows; ++i)
+      {
+        v[i] = H[i][c];
+        if (i == c)
+          v[i] -= alpha;
+        v_norm_squared += v[i] * v[i];
+      }
+      if (v_norm_squared <= 0)
+        continue;
+
+      for (vcl_size_t j=c; j<cols; ++j)
+      {
+        NumericT s = 0;
+        for (vcl_size_t i=c; i<rows; ++i)
+          s += v[i] * H[i][j];
+        s *= NumericT(2) / v_norm_squared;
+        for (vcl_size_t i=c; i<rows; ++i)
+          H[i][j] -= s * v[i];
+      }
+      for (vcl_size_t j=0; j<num_rhs; ++j)
+      {
+        NumericT s = 0;
+        for (vcl_size_t i=c; i<rows; ++i)
+          s += v[i] * S[i][j];
+        s *= NumericT(2) / v_norm_squared;
+        for (vcl_size_t i=c; i<rows; ++i)
+          S[i][j] -= s * v[i];
+      }
+    }
+
+    NumericT max_diag = 0;
+    for (vcl_size_t i=0; i<cols; ++i)
+      max_diag = std::max<NumericT>(max_diag, std::fabs(H[i][i]));
+
+    Y = std::vector< std::vector<NumericT> >(cols, std::vector<NumericT>(num_rhs));
+    residual_norms.resize(num_rhs);
+    for (vcl_size_t j=0; j<num_rhs; ++j)
+    {
+      for (vcl_size_t i2=0; i2<cols; ++i2)
+      {
+        vcl_size_t i = cols - i2 - 1;
+        if (std::fabs(H[i][i]) <= std::numeric_limits<NumericT>::epsilon() * max_diag) // (numerically) singular, skip direction
+          continue;
+        NumericT value = S[i][j];
+        for (vcl_size_t l=i+1; l<cols; ++l)
+          value -= H[i][l] * Y[l][j];
+        Y[i][j] = value / H[i][i];
+      }
+
+      NumericT norm = 0;
+      for (vcl_size_t i=cols; i<rows; ++i)
+        norm += S[i][j] * S[i][j];
+      residual_norms[j] = std::sqrt(norm);
+    }
+  }
+
+} //namespace detail
+} //namespace linalg
+} //namespace viennacl
+
+#endif
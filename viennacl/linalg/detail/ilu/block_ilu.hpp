@@ -117,6 +117,7 @@ namespace detail
       }
       output_row_buffer[row - start_index + 1] = static_cast<unsigned int>(output_counter);
     }
+    diagonal_block_A.reset_row_statistics();
   }
 
 } // namespace detail
@@ -474,6 +475,7 @@ private:
       current_value += tmp;
     }
     gpu_L_trans_.reserve(current_value);
+    gpu_L_trans_.reset_row_statistics();
 
     current_value = 0;
     for (vcl_size_t i=0; i<gpu_U_trans_.size1(); ++i)
@@ -483,6 +485,7 @@ private:
       current_value += tmp;
     }
     gpu_U_trans_.reserve(current_value);
+    gpu_U_trans_.reset_row_statistics();
 
 
     //
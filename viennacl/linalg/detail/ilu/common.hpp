@@ -33,6 +33,7 @@
 #include "viennacl/backend/memory.hpp"
 
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/sparse_triangular_solve.hpp"
 #include "viennacl/linalg/misc_operations.hpp"
 
 namespace viennacl
@@ -247,6 +248,28 @@ void level_scheduling_substitute(viennacl::vector<NumericT> & vec,
 }
 
 
+//
+// Schedules for the substitution on the host:
+//
+
+/** @brief Sets up the cached schedules for the substitutions with the unit lower triangular part of L and the upper triangular part of U (host backend). L and U may be the same matrix. */
+template<typename NumericT, unsigned int AlignmentV>
+void ilu_setup_triangular_schedules(viennacl::compressed_matrix<NumericT, AlignmentV> const & L,
+                                    viennacl::compressed_matrix<NumericT, AlignmentV> const & U,
+                                    viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericT> & L_schedule,
+                                    viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericT> & U_schedule)
+{
+  L_schedule.setup(viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.handle1()),
+                   viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.handle2()),
+                   viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(L.handle()),
+                   L.size1(), true, true);
+  U_schedule.setup(viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.handle1()),
+                   viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.handle2()),
+                   viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(U.handle()),
+                   U.size1(), false, false);
+}
+
+
 
 
 
@@ -45,6 +45,7 @@
 #include "viennacl/backend/memory.hpp"
 
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/sparse_triangular_solve.hpp"
 
 #include <map>
 
@@ -159,12 +160,8 @@ public:
   template<typename VectorT>
   void apply(VectorT & vec) const
   {
-    unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LU_.handle1());
-    unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LU_.handle2());
-    NumericType  const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericType>(LU_.handle());
-
-    viennacl::linalg::host_based::detail::csr_inplace_solve<NumericType>(row_buffer, col_buffer, elements, vec, LU_.size2(), unit_lower_tag());
-    viennacl::linalg::host_based::detail::csr_inplace_solve<NumericType>(row_buffer, col_buffer, elements, vec, LU_.size2(), upper_tag());
+    L_schedule_.solve(vec);
+    U_schedule_.solve(vec);
   }
 
 private:
@@ -175,10 +172,14 @@ private:
 
     viennacl::copy(mat, LU_);
     viennacl::linalg::precondition(LU_, tag_);
+
+    detail::ilu_setup_triangular_schedules(LU_, LU_, L_schedule_, U_schedule_);
   }
 
   ilu0_tag                                   tag_;
   viennacl::compressed_matrix<NumericType>   LU_;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericType> L_schedule_;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericType> U_schedule_;
 };
 
 
@@ -230,37 +231,17 @@ public:
       {
         viennacl::context old_context = viennacl::traits::context(vec);
         viennacl::switch_memory_context(vec, host_context);
-        viennacl::linalg::inplace_solve(LU_, vec, unit_lower_tag());
-        viennacl::linalg::inplace_solve(LU_, vec, upper_tag());
+        NumericT * vec_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(vec.handle());
+        L_schedule_.solve(vec_buffer);
+        U_schedule_.solve(vec_buffer);
         viennacl::switch_memory_context(vec, old_context);
       }
     }
-    else //apply ILU0 directly on CPU
+    else //apply ILU0 directly on CPU, using the cached schedules (with or without level scheduling)
     {
-      if (tag_.use_level_scheduling())
-      {
-        //std::cout << "Using multifrontal..." << std::endl;
-        detail::level_scheduling_substitute(vec,
-                                            multifrontal_L_row_index_arrays_,
-                                            multifrontal_L_row_buffers_,
-                                            multifrontal_L_col_buffers_,
-                                            multifrontal_L_element_buffers_,
-                                            multifrontal_L_row_elimination_num_list_);
-
-        vec = viennacl::linalg::element_div(vec, multifrontal_U_diagonal_);
-
-        detail::level_scheduling_substitute(vec,
-                                            multifrontal_U_row_index_arrays_,
-                                            multifrontal_U_row_buffers_,
-                                            multifrontal_U_col_buffers_,
-                                            multifrontal_U_element_buffers_,
-                                            multifrontal_U_row_elimination_num_list_);
-      }
-      else
-      {
-        viennacl::linalg::inplace_solve(LU_, vec, unit_lower_tag());
-        viennacl::linalg::inplace_solve(LU_, vec, upper_tag());
-      }
+      NumericT * vec_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(vec.handle());
+      L_schedule_.solve(vec_buffer);
+      U_schedule_.solve(vec_buffer);
     }
   }
 
@@ -274,6 +255,8 @@ private:
     LU_ = mat;
     viennacl::linalg::precondition(LU_, tag_);
 
+    detail::ilu_setup_triangular_schedules(LU_, LU_, L_schedule_, U_schedule_);
+
     if (!tag_.use_level_scheduling())
       return;
 
@@ -353,6 +336,8 @@ private:
 
   ilu0_tag tag_;
   viennacl::compressed_matrix<NumericT> LU_;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericT> L_schedule_;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericT> U_schedule_;
 
   std::list<viennacl::backend::mem_handle> multifrontal_L_row_index_arrays_;
   std::list<viennacl::backend::mem_handle> multifrontal_L_row_buffers_;
@@ -343,6 +343,9 @@ void precondition(viennacl::compressed_matrix<NumericT> const & A,
     row_buffer_U[i+1] = offset_U;
 
   } //for i
+
+  L.reset_row_statistics();
+  U.reset_row_statistics();
 }
 
 
@@ -365,21 +368,9 @@ public:
   template<typename VectorT>
   void apply(VectorT & vec) const
   {
-    //Note: Since vec can be a rather arbitrary vector type, we call the more generic version in the backend manually:
-    {
-      unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L_.handle1());
-      unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L_.handle2());
-      NumericType  const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericType>(L_.handle());
-
-      viennacl::linalg::host_based::detail::csr_inplace_solve<NumericType>(row_buffer, col_buffer, elements, vec, L_.size2(), unit_lower_tag());
-    }
-    {
-      unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U_.handle1());
-      unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U_.handle2());
-      NumericType  const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericType>(U_.handle());
-
-      viennacl::linalg::host_based::detail::csr_inplace_solve<NumericType>(row_buffer, col_buffer, elements, vec, U_.size2(), upper_tag());
-    }
+    //Note: Since vec can be a rather arbitrary vector type, the schedules access it via operator[]:
+    L_schedule_.solve(vec);
+    U_schedule_.solve(vec);
   }
 
 private:
@@ -394,11 +385,15 @@ private:
     viennacl::copy(mat, temp);
 
     viennacl::linalg::precondition(temp, L_, U_, tag_);
+
+    detail::ilu_setup_triangular_schedules(L_, U_, L_schedule_, U_schedule_);
   }
 
   ilut_tag tag_;
   viennacl::compressed_matrix<NumericType> L_;
   viennacl::compressed_matrix<NumericType> U_;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericType> L_schedule_;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericType> U_schedule_;
 };
 
 
@@ -452,15 +447,17 @@ public:
         viennacl::context host_context(viennacl::MAIN_MEMORY);
         viennacl::context old_context = viennacl::traits::context(vec);
         viennacl::switch_memory_context(vec, host_context);
-        viennacl::linalg::inplace_solve(L_, vec, unit_lower_tag());
-        viennacl::linalg::inplace_solve(U_, vec, upper_tag());
+        NumericT * vec_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(vec.handle());
+        L_schedule_.solve(vec_buffer);
+        U_schedule_.solve(vec_buffer);
         viennacl::switch_memory_context(vec, old_context);
       }
     }
-    else //apply ILUT directly:
+    else //apply ILUT directly, using the cached schedules:
     {
-      viennacl::linalg::inplace_solve(L_, vec, unit_lower_tag());
-      viennacl::linalg::inplace_solve(U_, vec, upper_tag());
+      NumericT * vec_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(vec.handle());
+      L_schedule_.solve(vec_buffer);
+      U_schedule_.solve(vec_buffer);
     }
   }
 
@@ -485,6 +482,8 @@ private:
       viennacl::linalg::precondition(cpu_mat, L_, U_, tag_);
     }
 
+    detail::ilu_setup_triangular_schedules(L_, U_, L_schedule_, U_schedule_);
+
     if (!tag_.use_level_scheduling())
       return;
 
@@ -570,6 +569,8 @@ private:
   ilut_tag tag_;
   viennacl::compressed_matrix<NumericT> L_;
   viennacl::compressed_matrix<NumericT> U_;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericT> L_schedule_;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericT> U_schedule_;
 
   std::list<viennacl::backend::mem_handle> multifrontal_L_row_index_arrays_;
   std::list<viennacl::backend::mem_handle> multifrontal_L_row_buffers_;
@@ -0,0 +1,161 @@
+#ifndef VIENNACL_LINALG_DETAIL_S_STEP_KRYLOV_HPP_
+#define VIENNACL_LINALG_DETAIL_S_STEP_KRYLOV_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/detail/s_step_krylov.hpp
+    @brief Helper routines for the s-step (communication-avoiding) variants of CG and GMRES in cg.hpp and gmres.hpp.
+
+    The s-step methods compute s basis vectors of the Krylov subspace without any global reduction (matrix powers kernel),
+    then obtain all inner products required for the next s iterations from a single Gram matrix.
+    The basis vectors are stored as the columns of a column-major dense matrix, see also block_krylov.hpp.
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/linalg/detail/block_krylov.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace detail
+{
+
+  /** @brief The Chebyshev basis rho_j(z) = T_j((z - c) / d) of the Krylov subspace used by the s-step solvers.
+  *
+  * T_j denotes the Chebyshev polynomial of the first kind and [c - d, c + d] is an estimate of the spectral interval of the operator.
+  * Unlike the monomial basis z^j, the basis vectors rho_j(A) v remain well-conditioned for larger s as long as the interval covers the spectrum.
+  */
+  template<typename NumericT>
+  class s_step_chebyshev_basis
+  {
+  public:
+    s_step_chebyshev_basis(NumericT lower, NumericT upper) : center_((lower + upper) / NumericT(2)), half_width_((upper - lower) / NumericT(2))
+    {
+      if (half_width_ <= 0) // degenerate interval, fall back to a scaled monomial basis
+        half_width_ = (std::fabs(center_) > 0) ? std::fabs(center_) : NumericT(1);
+    }
+
+    /** @brief Returns the center c of the interval */
+    NumericT center() const { return center_; }
+    /** @brief Returns the half width d of the interval */
+    NumericT half_width() const { return half_width_; }
+
+    /** @brief Returns the (s+1) x s change of basis matrix B with z rho_j(z) = sum_i B(i,j) rho_i(z) for j = 0, ..., s-1 */
+    std::vector< std::vector<NumericT> > change_of_basis(vcl_size_t s) const
+    {
+      std::vector< std::vector<NumericT> > B(s + 1, std::vector<NumericT>(s));
+      for (vcl_size_t j=0; j<s; ++j)
+      {
+        B[j][j] = center_;
+        if (j == 0)
+          B[1][0] = half_width_;
+        else
+        {
+          B[j-1][j] = half_width_ / NumericT(2);
+          B[j+1][j] = half_width_ / NumericT(2);
+        }
+      }
+      return B;
+    }
+
+  private:
+    NumericT center_;
+    NumericT half_width_;
+  };
+
+  /** @brief Computes the basis vectors rho_1(op) v, ..., rho_s(op) v for the preconditioned operator op = M^{-1} A without any global reduction (matrix powers kernel).
+  *
+  * @param A         The system matrix
+  * @param precond   The preconditioner M
+  * @param basis     The Chebyshev basis
+  * @param Y         The block of vectors. Holds v in column 'start' on entry, rho_j(op) v is written to column first + j - 1.
+  * @param start     Column of Y holding v
+  * @param first     Column of Y receiving rho_1(op) v
+  * @param s         Number of basis vectors to compute
+  */
+  template<typename MatrixT, typename NumericT, typename PreconditionerT>
+  void s_step_matrix_powers(MatrixT const & A, PreconditionerT const & precond, s_step_chebyshev_basis<NumericT> const & basis,
+                            viennacl::matrix<NumericT, viennacl::column_major> & Y, vcl_size_t start, vcl_size_t first, vcl_size_t s)
+  {
+    vcl_size_t n = Y.size1();
+    viennacl::vector<NumericT> w(n, viennacl::traits::context(Y));
+
+    for (vcl_size_t j=0; j<s; ++j)
+    {
+      vcl_size_t current = (j == 0) ? start : first + j - 1;
+      viennacl::vector_base<NumericT> rho_current(Y.handle(), n, current * Y.internal_size1(), 1);
+      viennacl::vector_base<NumericT> rho_next(Y.handle(), n, (first + j) * Y.internal_size1(), 1);
+
+      w = viennacl::linalg::prod(A, rho_current);
+      precond.apply(w);
+      w -= basis.center() * rho_current;
+
+      if (j == 0) // rho_1 = (op - c) rho_0 / d
+        rho_next = w / basis.half_width();
+      else        // rho_{j+1} = 2 (op - c) rho_j / d - rho_{j-1}
+      {
+        vcl_size_t previous = (j == 1) ? start : first + j - 2;
+        viennacl::vector_base<NumericT> rho_previous(Y.handle(), n, previous * Y.internal_size1(), 1);
+        rho_next = (NumericT(2) / basis.half_width()) * w - rho_previous;
+      }
+    }
+  }
+
+  /** @brief Estimates the spectral interval [lower, upper] of an operator from the eigenvalues of the symmetric part of its projection H (k x k, on the host).
+  *
+  * The interval spanned by the eigenvalues is widened by a tenth of its width on both sides, since the extremal Ritz values lie inside the spectral interval.
+  */
+  template<typename NumericT>
+  void s_step_spectral_interval(std::vector< std::vector<NumericT> > const & H, vcl_size_t k, NumericT & lower, NumericT & upper)
+  {
+    std::vector< std::vector<NumericT> > H_sym(k, std::vector<NumericT>(k));
+    for (vcl_size_t i=0; i<k; ++i)
+      for (vcl_size_t j=0; j<k; ++j)
+        H_sym[i][j] = (H[i][j] + H[j][i]) / NumericT(2);
+
+    std::vector< std::vector<NumericT> > V;
+    block_krylov_symmetric_eig(H_sym, V);
+
+    lower = H_sym[0][0];
+    upper = H_sym[0][0];
+    for (vcl_size_t i=1; i<k; ++i)
+    {
+      lower = std::min(lower, H_sym[i][i]);
+      upper = std::max(upper, H_sym[i][i]);
+    }
+
+    NumericT margin = (upper - lower) / NumericT(10);
+    lower -= margin;
+    upper += margin;
+  }
+
+} //namespace detail
+} //namespace linalg
+} //namespace viennacl
+
+#endif
@@ -0,0 +1,595 @@
+#ifndef VIENNACL_LINALG_FGMRES_HPP_
+#define VIENNACL_LINALG_FGMRES_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/fgmres.hpp
+    @brief Implementation of the flexible GMRES method (FGMRES), which allows for a different preconditioner in each iteration (e.g. an inner iterative solver).
+
+    The implementation is shared with the GCRO-DR method in gcrodr.hpp, which additionally carries a recycled subspace across restarts and solver calls.
+*/
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <utility>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/matrix_proxy.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/linalg/norm_2.hpp"
+#include "viennacl/traits/clear.hpp"
+#include "viennacl/traits/context.hpp"
+#include "viennacl/meta/result_of.hpp"
+#include "viennacl/linalg/detail/block_krylov.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief A tag for the flexible GMRES solver. Used for supplying solver parameters and for dispatching the solve() function
+*/
+class fgmres_tag
+{
+public:
+  /** @brief The constructor
+  *
+  * @param tol            Relative tolerance for the residual (solver quits if ||r|| < tol * ||b||)
+  * @param max_iterations The maximum number of iterations (including restarts)
+  * @param krylov_dim     The maximum dimension of the Krylov space before restart
+  */
+  fgmres_tag(double tol = 1e-10, unsigned int max_iterations = 300, unsigned int krylov_dim = 20)
+   : tol_(tol), abs_tol_(0), iterations_(max_iterations), krylov_dim_(krylov_dim), iters_taken_(0) {}
+
+  /** @brief Returns the relative tolerance */
+  double tolerance() const { return tol_; }
+
+  /** @brief Returns the absolute tolerance */
+  double abs_tolerance() const { return abs_tol_; }
+  /** @brief Sets the absolute tolerance */
+  void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
+
+  /** @brief Returns the maximum number of iterations */
+  unsigned int max_iterations() const { return iterations_; }
+  /** @brief Returns the maximum dimension of the Krylov space before restart */
+  unsigned int krylov_dim() const { return krylov_dim_; }
+
+  /** @brief Return the number of solver iterations: */
+  unsigned int iters() const { return iters_taken_; }
+  /** @brief Set the number of solver iterations (should only be modified by the solver) */
+  void iters(unsigned int i) const { iters_taken_ = i; }
+
+  /** @brief Returns the estimated relative error at the end of the solver run */
+  double error() const { return last_error_; }
+  /** @brief Sets the estimated relative error at the end of the solver run */
+  void error(double e) const { last_error_ = e; }
+
+private:
+  double tol_;
+  double abs_tol_;
+  unsigned int iterations_;
+  unsigned int krylov_dim_;
+
+  //return values from solver
+  mutable unsigned int iters_taken_;
+  mutable double last_error_;
+};
+
+namespace detail
+{
+
+  /** @brief Column j of a column-major block of vectors as a vector */
+  template<typename NumericT>
+  viennacl::vector_base<NumericT> gcro_dr_column(viennacl::matrix<NumericT, viennacl::column_major> & M, vcl_size_t j)
+  {
+    return viennacl::vector_base<NumericT>(M.handle(), M.size1(), j * M.internal_size1(), 1);
+  }
+
+  /** @brief Computes C = A U for the recycled subspace U of a previous solver run and rescales both such that C has orthonormal columns. Returns false if U is (numerically) rank deficient. */
+  template<typename MatrixT, typename NumericT>
+  bool gcro_dr_setup_recycled_subspace(MatrixT const & A,
+                                       viennacl::matrix<NumericT, viennacl::column_major> & U,
+                                       viennacl::matrix<NumericT, viennacl::column_major> & C)
+  {
+    typedef viennacl::matrix<NumericT, viennacl::column_major>   BlockType;
+
+    viennacl::context ctx = viennacl::traits::context(U);
+    vcl_size_t n = U.size1();
+    vcl_size_t k = U.size2();
+
+    C.resize(n, k, false);
+    for (vcl_size_t j=0; j<k; ++j)
+    {
+      viennacl::vector_base<NumericT> C_j = gcro_dr_column(C, j);
+      C_j = viennacl::linalg::prod(A, gcro_dr_column(U, j));
+    }
+
+    BlockType vcl_G = viennacl::linalg::prod(trans(C), C);
+    std::vector< std::vector<NumericT> > L = block_krylov_to_host(vcl_G);
+    if (!block_krylov_cholesky(L))
+      return false;
+
+    BlockType vcl_T = block_krylov_from_host(block_krylov_cholesky_inverse_transpose(L), ctx);
+    BlockType C_new(n, k, ctx);
+    C_new = viennacl::linalg::prod(C, vcl_T);
+    C = C_new;
+    BlockType U_new(n, k, ctx);
+    U_new = viennacl::linalg::prod(U, vcl_T);
+    U = U_new;
+    return true;
+  }
+
+  /** @brief Implementation of the flexible GCRO-DR method (restarted flexible GMRES with deflated restarting and subspace recycling).
+  *
+  * See M. L. Parks et al., "Recycling Krylov subspaces for sequences of linear systems", SIAM J. Sci. Comput. 28(5), 1651–1674 (2006),
+  * and L. M. Carvalho et al., "A flexible generalized conjugate residual method with inner orthogonalization and deflated restarting", SIAM J. Matrix Anal. Appl. 32(4), 1212–1235 (2011).
+  *
+  * The preconditioner is applied from the right and may change from one application to the next, hence the preconditioned basis vectors Z are kept.
+  * Each restart cycle keeps a subspace U with A U = C, C having orthonormal columns, and runs the Arnoldi process for (I - C C^T) A M^{-1}.
+  * At the end of each cycle, U is replaced by the vectors w of the search space [U, Z] with the smallest ratio ||A w|| / ||w||.
+  * All small dense problems (least squares problem, generalized symmetric eigenvalue problem for the new subspace) are solved on the host.
+  * With recycle_dim = 0, this is the flexible GMRES method.
+  *
+  * @param A            The system matrix
+  * @param rhs          The load vector
+  * @param tag          Solver configuration tag (fgmres_tag or gcrodr_tag)
+  * @param precond      A (possibly variable) preconditioner. Precondition operation is done via member function apply()
+  * @param recycle_dim  The maximum dimension of the recycled subspace
+  * @param U            The recycled subspace. Taken from a previous solver run if it has matching size, replaced by the new recycled subspace on exit.
+  * @param monitor      A callback routine which is called at each restart
+  * @param monitor_data Data pointer to be passed to the callback routine to pass on user-specific data
+  * @return The result vector
+  */
+  template<typename MatrixT, typename NumericT, typename TagT, typename PreconditionerT>
+  viennacl::vector<NumericT> gcro_dr_solve(MatrixT const & A,
+                                           viennacl::vector<NumericT> const & rhs,
+                                           TagT const & tag,
+                                           PreconditionerT const & precond,
+                                           vcl_size_t recycle_dim,
+                                           viennacl::matrix<NumericT, viennacl::column_major> & U,
+                                           bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                           void *monitor_data = NULL)
+  {
+    typedef viennacl::matrix<NumericT, viennacl::column_major>   BlockType;
+    typedef std::vector< std::vector<NumericT> >                 HostMatrixType;
+
+    viennacl::context ctx = viennacl::traits::context(rhs);
+    vcl_size_t n = rhs.size();
+    vcl_size_t m = std::min<vcl_size_t>(tag.krylov_dim(), n);
+    vcl_size_t k_max = (m > 1) ? std::min<vcl_size_t>(recycle_dim, m - 1) : 0;
+    viennacl::range all_rows(0, n);
+
+    viennacl::vector<NumericT> result(rhs);
+    viennacl::traits::clear(result);
+
+    NumericT norm_rhs = viennacl::linalg::norm_2(rhs);
+
+    tag.iters(0);
+    if (norm_rhs <= tag.abs_tolerance()) //solution is zero if RHS norm is zero
+      return result;
+
+    //
+    // Recycled subspace from a previous solver run:
+    //
+    BlockType C;
+    vcl_size_t k = 0;
+    if (k_max > 0 && U.size1() == n && U.size2() > 0)
+    {
+      if (U.size2() > k_max)
+      {
+        BlockType U_leading(n, k_max, ctx);
+        U_leading = viennacl::project(U, all_rows, viennacl::range(0, k_max));
+        U = U_leading;
+      }
+      if (gcro_dr_setup_recycled_subspace(A, U, C))
+        k = U.size2();
+    }
+
+    BlockType V(n, m + 1, ctx);
+    BlockType Z(n, m, ctx);
+    viennacl::vector<NumericT> r(rhs);
+    viennacl::vector<NumericT> w(rhs);
+    viennacl::vector<NumericT> tmp(rhs);
+    NumericT eps = std::numeric_limits<NumericT>::epsilon();
+
+    for (;;)
+    {
+      r = viennacl::linalg::prod(A, result);
+      r = rhs - r;
+      NumericT norm_r = viennacl::linalg::norm_2(r);
+      tag.error(norm_r / norm_rhs);
+      if (norm_r / norm_rhs < tag.tolerance() || norm_r < tag.abs_tolerance() || tag.iters() >= tag.max_iterations())
+        break;
+
+      //
+      // Project out the recycled subspace: r = C C^T r + r_perp
+      //
+      std::vector<NumericT> C_r(k);
+      if (k > 0)
+      {
+        viennacl::vector<NumericT> vcl_C_r = viennacl::linalg::prod(trans(C), r);
+        viennacl::copy(vcl_C_r, C_r);
+        w = viennacl::linalg::prod(C, vcl_C_r);
+        r -= w;
+      }
+      NumericT rho = viennacl::linalg::norm_2(r);
+
+      // A [U D, Z] = [C, V] G, where D scales the columns of U to unit length:
+      HostMatrixType G(m + 1, std::vector<NumericT>(m));
+      std::vector<NumericT> D(k);
+      if (k > 0)
+      {
+        D = block_krylov_column_norms(U);
+        for (vcl_size_t i=0; i<k; ++i)
+        {
+          D[i] = NumericT(1) / D[i];
+          G[i][i] = D[i];
+        }
+      }
+
+      HostMatrixType Y;
+      std::vector<NumericT> residual_norms(1, norm_r);
+      vcl_size_t j = 0;
+      vcl_size_t rows = k;
+      if (rho > eps * norm_r) // otherwise the residual is in the span of C and the cycle reduces to the projection onto the recycled subspace
+      {
+        rows = k + 1;
+        viennacl::vector_base<NumericT> V_0 = gcro_dr_column(V, 0);
+        V_0 = r / rho;
+      }
+
+      if (rows > 0)
+      {
+        //
+        // Arnoldi process for (I - C C^T) A M^{-1}:
+        //
+        while (rows > k && j < m - k && tag.iters() < tag.max_iterations())
+        {
+          tag.iters(tag.iters() + 1);
+
+          viennacl::vector_base<NumericT> Z_j = gcro_dr_column(Z, j);
+          w = gcro_dr_column(V, j);
+          precond.apply(w);
+          Z_j = w;
+          w = viennacl::linalg::prod(A, Z_j);
+
+          NumericT norm_w_squared = 0;
+          if (k > 0)
+          {
+            viennacl::vector<NumericT> vcl_b = viennacl::linalg::prod(trans(C), w);
+            std::vector<NumericT> b(k);
+            viennacl::copy(vcl_b, b);
+            for (vcl_size_t i=0; i<k; ++i)
+            {
+              G[i][k + j] = b[i];
+              norm_w_squared += b[i] * b[i];
+            }
+            tmp = viennacl::linalg::prod(C, vcl_b);
+            w -= tmp;
+          }
+
+          // two passes of classical Gram-Schmidt:
+          viennacl::matrix_range<BlockType> V_j(V, all_rows, viennacl::range(0, j + 1));
+          for (unsigned int pass = 0; pass < 2; ++pass)
+          {
+            viennacl::vector<NumericT> vcl_h = viennacl::linalg::prod(trans(V_j), w);
+            std::vector<NumericT> h(j + 1);
+            viennacl::copy(vcl_h, h);
+            for (vcl_size_t i=0; i<=j; ++i)
+            {
+              G[k + i][k + j] += h[i];
+              if (pass == 0)
+                norm_w_squared += h[i] * h[i];
+            }
+            tmp = viennacl::linalg::prod(V_j, vcl_h);
+            w -= tmp;
+          }
+
+          NumericT h_next = viennacl::linalg::norm_2(w);
+          norm_w_squared += h_next * h_next;
+          ++j;
+
+          bool breakdown = (h_next <= NumericT(10) * eps * std::sqrt(norm_w_squared)); // the Krylov space is (numerically) invariant
+          if (!breakdown)
+          {
+            G[k + j][k + j - 1] = h_next;
+            viennacl::vector_base<NumericT> V_next = gcro_dr_column(V, j);
+            V_next = w / h_next;
+          }
+          rows = breakdown ? k + j : k + j + 1;
+
+          //
+          // least squares problem min || [C^T r; rho e_1] - G y ||:
+          //
+          HostMatrixType H(rows, std::vector<NumericT>(k + j));
+          HostMatrixType S(rows, std::vector<NumericT>(1));
+          for (vcl_size_t i=0; i<rows; ++i)
+            for (vcl_size_t l=0; l<k+j; ++l)
+              H[i][l] = G[i][l];
+          for (vcl_size_t i=0; i<k; ++i)
+            S[i][0] = C_r[i];
+          S[k][0] = rho;
+          block_krylov_least_squares(H, S, Y, residual_norms);
+
+          if (breakdown || residual_norms[0] / norm_rhs < tag.tolerance() || residual_norms[0] < tag.abs_tolerance())
+            break;
+        }
+
+        if (j == 0) // no Arnoldi step, solution within the recycled subspace only
+        {
+          Y = HostMatrixType(k, std::vector<NumericT>(1));
+          for (vcl_size_t i=0; i<k; ++i)
+            Y[i][0] = C_r[i] / D[i];
+          residual_norms[0] = rho;
+        }
+      }
+
+      //
+      // Update the result: x += U D y_1 + Z y_2
+      //
+      if (k > 0)
+      {
+        std::vector<NumericT> y_U(k);
+        for (vcl_size_t i=0; i<k; ++i)
+          y_U[i] = D[i] * Y[i][0];
+        viennacl::vector<NumericT> vcl_y_U(k, ctx);
+        viennacl::copy(y_U, vcl_y_U);
+        w = viennacl::linalg::prod(U, vcl_y_U);
+        result += w;
+      }
+      if (j > 0)
+      {
+        std::vector<NumericT> y_Z(j);
+        for (vcl_size_t i=0; i<j; ++i)
+          y_Z[i] = Y[k + i][0];
+        viennacl::vector<NumericT> vcl_y_Z(j, ctx);
+        viennacl::copy(y_Z, vcl_y_Z);
+        w = viennacl::linalg::prod(viennacl::project(Z, all_rows, viennacl::range(0, j)), vcl_y_Z);
+        result += w;
+      }
+
+      if (monitor && monitor(result, residual_norms[0] / norm_rhs, monitor_data))
+        break;
+
+      if (k_max == 0 || j == 0)
+        continue;
+
+      //
+      // New recycled subspace: vectors W p of the search space W = [U D, Z] with the smallest ratio ||A W p|| / ||W p|| = ||G p|| / ||W p||,
+      // i.e. the eigenvectors for the smallest eigenvalues of G^T G p = theta W^T W p. The first two dense products are the only global reductions.
+      //
+      vcl_size_t cols = k + j;
+      vcl_size_t k_new = std::min(k_max, cols);
+
+      BlockType W(n, cols, ctx);
+      if (k > 0)
+        viennacl::project(W, all_rows, viennacl::range(0, k)) = U;
+      viennacl::project(W, all_rows, viennacl::range(k, cols)) = viennacl::project(Z, all_rows, viennacl::range(0, j));
+
+      std::vector<NumericT> scaling(cols, NumericT(1));
+      for (vcl_size_t i=0; i<k; ++i)
+        scaling[i] = D[i];
+
+      BlockType vcl_WtW = viennacl::linalg::prod(trans(W), W);
+      HostMatrixType L = block_krylov_to_host(vcl_WtW);
+      for (vcl_size_t i=0; i<cols; ++i)
+        for (vcl_size_t l=0; l<cols; ++l)
+          L[i][l] *= scaling[i] * scaling[l];
+      if (!block_krylov_cholesky(L)) // search space (numerically) rank deficient, keep the current recycled subspace
+        continue;
+      HostMatrixType L_inv_T = block_krylov_cholesky_inverse_transpose(L);
+
+      // reduce to the standard symmetric eigenvalue problem L^{-1} G^T G L^{-T} q = theta q:
+      HostMatrixType GL(rows, std::vector<NumericT>(cols));  // G L^{-T}
+      for (vcl_size_t i=0; i<rows; ++i)
+        for (vcl_size_t l=0; l<cols; ++l)
+          for (vcl_size_t t=0; t<=l; ++t)
+            GL[i][l] += G[i][t] * L_inv_T[t][l];
+      HostMatrixType E(cols, std::vector<NumericT>(cols));
+      for (vcl_size_t i=0; i<cols; ++i)
+        for (vcl_size_t l=0; l<cols; ++l)
+          for (vcl_size_t t=0; t<rows; ++t)
+            E[i][l] += GL[t][i] * GL[t][l];
+      HostMatrixType Q_eig;
+      block_krylov_symmetric_eig(E, Q_eig);
+
+      std::vector<std::pair<NumericT, vcl_size_t> > eigenvalues(cols);
+      for (vcl_size_t i=0; i<cols; ++i)
+        eigenvalues[i] = std::make_pair(E[i][i], i);
+      std::sort(eigenvalues.begin(), eigenvalues.end());
+
+      // P = L^{-T} Q_eig (selected columns), GP = G P = GL Q_eig:
+      HostMatrixType P(cols, std::vector<NumericT>(k_new));
+      HostMatrixType GP(rows, std::vector<NumericT>(k_new));
+      for (vcl_size_t l=0; l<k_new; ++l)
+      {
+        vcl_size_t index = eigenvalues[l].second;
+        for (vcl_size_t i=0; i<cols; ++i)
+          for (vcl_size_t t=i; t<cols; ++t)
+            P[i][l] += L_inv_T[i][t] * Q_eig[t][index];
+        for (vcl_size_t i=0; i<rows; ++i)
+          for (vcl_size_t t=0; t<cols; ++t)
+            GP[i][l] += GL[i][t] * Q_eig[t][index];
+      }
+
+      // GP = Q R by modified Gram-Schmidt with reorthogonalization:
+      HostMatrixType R(k_new, std::vector<NumericT>(k_new));
+      bool full_rank = true;
+      for (vcl_size_t l=0; l<k_new && full_rank; ++l)
+      {
+        for (unsigned int pass = 0; pass < 2; ++pass)
+          for (vcl_size_t t=0; t<l; ++t)
+          {
+            NumericT value = 0;
+            for (vcl_size_t i=0; i<rows; ++i)
+              value += GP[i][t] * GP[i][l];
+            R[t][l] += value;
+            for (vcl_size_t i=0; i<rows; ++i)
+              GP[i][l] -= value * GP[i][t];
+          }
+        NumericT norm = 0;
+        for (vcl_size_t i=0; i<rows; ++i)
+          norm += GP[i][l] * GP[i][l];
+        norm = std::sqrt(norm);
+        full_rank = (norm > 0);
+        R[l][l] = norm;
+        for (vcl_size_t i=0; i<rows && full_rank; ++i)
+          GP[i][l] /= norm;
+      }
+      if (!full_rank)
+        continue;
+
+      // U_new = W diag(scaling) P R^{-1}, C_new = [C, V] Q:
+      HostMatrixType T(cols, std::vector<NumericT>(k_new));
+      for (vcl_size_t i=0; i<cols; ++i)
+        for (vcl_size_t l=0; l<k_new; ++l)
+        {
+          NumericT value = scaling[i] * P[i][l];
+          for (vcl_size_t t=0; t<l; ++t)
+            value -= T[i][t] * R[t][l];
+          T[i][l] = value / R[l][l];
+        }
+      BlockType vcl_T = block_krylov_from_host(T, ctx);
+      BlockType U_new(n, k_new, ctx);
+      U_new = viennacl::linalg::prod(W, vcl_T);
+
+      HostMatrixType Q_V(rows - k, std::vector<NumericT>(k_new));
+      for (vcl_size_t i=0; i<rows-k; ++i)
+        for (vcl_size_t l=0; l<k_new; ++l)
+          Q_V[i][l] = GP[k + i][l];
+      BlockType vcl_Q_V = block_krylov_from_host(Q_V, ctx);
+      BlockType C_new(n, k_new, ctx);
+      C_new = viennacl::linalg::prod(viennacl::project(V, all_rows, viennacl::range(0, rows - k)), vcl_Q_V);
+      if (k > 0)
+      {
+        HostMatrixType Q_C(k, std::vector<NumericT>(k_new));
+        for (vcl_size_t i=0; i<k; ++i)
+          for (vcl_size_t l=0; l<k_new; ++l)
+            Q_C[i][l] = GP[i][l];
+        BlockType vcl_Q_C = block_krylov_from_host(Q_C, ctx);
+        BlockType C_part(n, k_new, ctx);
+        C_part = viennacl::linalg::prod(C, vcl_Q_C);
+        C_new += C_part;
+      }
+
+      block_krylov_assign(U, U_new);
+      block_krylov_assign(C, C_new);
+      k = k_new;
+    }
+
+    return result;
+  }
+
+}
+
+/** @brief Flexible GMRES solver. The preconditioner is applied from the right and may change from one application to the next.
+*
+* The relative tolerance refers to the (unpreconditioned) residual b - A x.
+*
+* @param matrix     The system matrix
+* @param rhs        The load vector
+* @param tag        Solver configuration tag
+* @param precond    A (possibly variable) preconditioner. Precondition operation is done via member function apply()
+* @return The result vector
+*/
+template<typename MatrixT, typename NumericT, typename PreconditionerT>
+viennacl::vector<NumericT> solve(MatrixT const & matrix, viennacl::vector<NumericT> const & rhs, fgmres_tag const & tag, PreconditionerT const & precond)
+{
+  viennacl::matrix<NumericT, viennacl::column_major> no_recycled_subspace;
+  return detail::gcro_dr_solve(matrix, rhs, tag, precond, 0, no_recycled_subspace);
+}
+
+/** @brief Entry point for the flexible GMRES method without preconditioner.
+ *
+ *  @param A         The system matrix
+ *  @param rhs       Right hand side vector (load vector)
+ *  @param tag       A FGMRES tag providing relative tolerances, etc.
+ */
+template<typename MatrixT, typename NumericT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, fgmres_tag const & tag)
+{
+  return solve(A, rhs, tag, no_precond());
+}
+
+
+template<typename VectorT>
+class fgmres_solver
+{
+public:
+  typedef typename viennacl::result_of::cpu_value_type<VectorT>::type   numeric_type;
+
+  fgmres_solver(fgmres_tag const & tag) : tag_(tag), monitor_callback_(NULL), user_data_(NULL) {}
+
+  template<typename MatrixT, typename PreconditionerT>
+  VectorT operator()(MatrixT const & A, VectorT const & b, PreconditionerT const & precond) const
+  {
+    viennacl::matrix<numeric_type, viennacl::column_major> no_recycled_subspace;
+    if (viennacl::traits::size(init_guess_) > 0) // take initial guess into account
+    {
+      VectorT mod_rhs = viennacl::linalg::prod(A, init_guess_);
+      mod_rhs = b - mod_rhs;
+      VectorT y = detail::gcro_dr_solve(A, mod_rhs, tag_, precond, 0, no_recycled_subspace, monitor_callback_, user_data_);
+      return init_guess_ + y;
+    }
+    return detail::gcro_dr_solve(A, b, tag_, precond, 0, no_recycled_subspace, monitor_callback_, user_data_);
+  }
+
+
+  template<typename MatrixT>
+  VectorT operator()(MatrixT const & A, VectorT const & b) const
+  {
+    return operator()(A, b, viennacl::linalg::no_precond());
+  }
+
+  /** @brief Specifies an initial guess for the iterative solver.
+    *
+    * An iterative solver for Ax = b with initial guess x_0 is equivalent to an iterative solver for Ay = b' := b - Ax_0, where x = x_0 + y.
+    */
+  void set_initial_guess(VectorT const & x) { init_guess_ = x; }
+
+  /** @brief Sets a monitor function pointer to be called at each restart. Set to NULL to run without monitor.
+   *
+   *  The monitor function is called with the current guess for the result as first argument and the current relative residual estimate as second argument.
+   *  The third argument is a pointer to user-defined data, through which additional information can be passed.
+   *  If the montior function returns true, the solver terminates (either convergence or divergence).
+   */
+  void set_monitor(bool (*monitor_fun)(VectorT const &, numeric_type, void *), void *user_data)
+  {
+    monitor_callback_ = monitor_fun;
+    user_data_ = user_data;
+  }
+
+  /** @brief Returns the solver tag containing basic configuration such as tolerances, etc. */
+  fgmres_tag const & tag() const { return tag_; }
+
+private:
+  fgmres_tag tag_;
+  VectorT    init_guess_;
+  bool       (*monitor_callback_)(VectorT const &, numeric_type, void *);
+  void       *user_data_;
+};
+
+
+}
+}
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef VIENNACL_LINALG_GCRODR_HPP_
+#define VIENNACL_LINALG_GCRODR_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/gcrodr.hpp
+    @brief Implementation of the GCRO-DR method: Restarted (flexible) GMRES with deflated restarting, recycling a subspace across restarts and across sequences of linear systems.
+
+    The recycled subspace is kept by gcrodr_solver, so that successive calls for slowly varying systems (e.g. in a Newton iteration) start from the subspace found in the previous solve.
+*/
+
+#include <vector>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/matrix.hpp"
+#include "viennacl/linalg/prod.hpp"
+#include "viennacl/meta/result_of.hpp"
+#include "viennacl/linalg/fgmres.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+
+/** @brief A tag for the GCRO-DR solver. Used for supplying solver parameters and for dispatching the solve() function
+*/
+class gcrodr_tag
+{
+public:
+  /** @brief The constructor
+  *
+  * @param tol            Relative tolerance for the residual (solver quits if ||r|| < tol * ||b||)
+  * @param max_iterations The maximum number of iterations (including restarts)
+  * @param krylov_dim     The maximum dimension of the search space (recycled subspace plus Krylov space) before restart
+  * @param recycle_dim    The dimension of the recycled subspace. Must be smaller than krylov_dim.
+  */
+  gcrodr_tag(double tol = 1e-10, unsigned int max_iterations = 300, unsigned int krylov_dim = 30, unsigned int recycle_dim = 10)
+   : tol_(tol), abs_tol_(0), iterations_(max_iterations), krylov_dim_(krylov_dim), recycle_dim_(recycle_dim), iters_taken_(0) {}
+
+  /** @brief Returns the relative tolerance */
+  double tolerance() const { return tol_; }
+
+  /** @brief Returns the absolute tolerance */
+  double abs_tolerance() const { return abs_tol_; }
+  /** @brief Sets the absolute tolerance */
+  void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
+
+  /** @brief Returns the maximum number of iterations */
+  unsigned int max_iterations() const { return iterations_; }
+  /** @brief Returns the maximum dimension of the search space before restart */
+  unsigned int krylov_dim() const { return krylov_dim_; }
+  /** @brief Returns the dimension of the recycled subspace */
+  unsigned int recycle_dim() const { return recycle_dim_; }
+
+  /** @brief Return the number of solver iterations: */
+  unsigned int iters() const { return iters_taken_; }
+  /** @brief Set the number of solver iterations (should only be modified by the solver) */
+  void iters(unsigned int i) const { iters_taken_ = i; }
+
+  /** @brief Returns the estimated relative error at the end of the solver run */
+  double error() const { return last_error_; }
+  /** @brief Sets the estimated relative error at the end of the solver run */
+  void error(double e) const { last_error_ = e; }
+
+private:
+  double tol_;
+  double abs_tol_;
+  unsigned int iterations_;
+  unsigned int krylov_dim_;
+  unsigned int recycle_dim_;
+
+  //return values from solver
+  mutable unsigned int iters_taken_;
+  mutable double last_error_;
+};
+
+
+/** @brief GCRO-DR solver for a single system. The subspace is only recycled across restarts, use gcrodr_solver for recycling across sequences of systems.
+*
+* The preconditioner is applied from the right and may change from one application to the next. The relative tolerance refers to the (unpreconditioned) residual b - A x.
+*
+* @param matrix     The system matrix
+* @param rhs        The load vector
+* @param tag        Solver configuration tag
+* @param precond    A preconditioner. Precondition operation is done via member function apply()
+* @return The result vector
+*/
+template<typename MatrixT, typename NumericT, typename PreconditionerT>
+viennacl::vector<NumericT> solve(MatrixT const & matrix, viennacl::vector<NumericT> const & rhs, gcrodr_tag const & tag, PreconditionerT const & precond)
+{
+  viennacl::matrix<NumericT, viennacl::column_major> recycled_subspace;
+  return detail::gcro_dr_solve(matrix, rhs, tag, precond, tag.recycle_dim(), recycled_subspace);
+}
+
+/** @brief Entry point for the GCRO-DR method without preconditioner.
+ *
+ *  @param A         The system matrix
+ *  @param rhs       Right hand side vector (load vector)
+ *  @param tag       A GCRO-DR tag providing relative tolerances, etc.
+ */
+template<typename MatrixT, typename NumericT>
+viennacl::vector<NumericT> solve(MatrixT const & A, viennacl::vector<NumericT> const & rhs, gcrodr_tag const & tag)
+{
+  return solve(A, rhs, tag, no_precond());
+}
+
+
+/** @brief GCRO-DR solver object keeping the recycled subspace across calls.
+*
+* For a sequence of linear systems A_i x_i = b_i with slowly varying matrices and/or right hand sides, the subspace associated with the smallest singular values found in one solve
+* is used from the first iteration of the next solve (after one multiplication with the new matrix), so the iterations spent on rebuilding it after each restart are saved.
+* The recycled subspace is only valid for systems of the same size. Call clear_recycled_subspace() when switching to an unrelated system.
+*/
+template<typename VectorT>
+class gcrodr_solver
+{
+public:
+  typedef typename viennacl::result_of::cpu_value_type<VectorT>::type   numeric_type;
+
+  gcrodr_solver(gcrodr_tag const & tag) : tag_(tag), monitor_callback_(NULL), user_data_(NULL), has_recycled_subspace_(false) {}
+
+  /** @brief Solves A x = b, starting with and updating the recycled subspace */
+  template<typename MatrixT, typename PreconditionerT>
+  VectorT operator()(MatrixT const & A, VectorT const & b, PreconditionerT const & precond)
+  {
+    if (viennacl::traits::size(init_guess_) > 0) // take initial guess into account
+    {
+      VectorT mod_rhs = viennacl::linalg::prod(A, init_guess_);
+      mod_rhs = b - mod_rhs;
+      VectorT y = solve_and_recycle(A, mod_rhs, precond);
+      return init_guess_ + y;
+    }
+    return solve_and_recycle(A, b, precond);
+  }
+
+
+  template<typename MatrixT>
+  VectorT operator()(MatrixT const & A, VectorT const & b)
+  {
+    return operator()(A, b, viennacl::linalg::no_precond());
+  }
+
+  /** @brief Specifies an initial guess for the iterative solver.
+    *
+    * An iterative solver for Ax = b with initial guess x_0 is equivalent to an iterative solver for Ay = b' := b - Ax_0, where x = x_0 + y.
+    */
+  void set_initial_guess(VectorT const & x) { init_guess_ = x; }
+
+  /** @brief Sets a monitor function pointer to be called at each restart. Set to NULL to run without monitor.
+   *
+   *  The monitor function is called with the current guess for the result as first argument and the current relative residual estimate as second argument.
+   *  The third argument is a pointer to user-defined data, through which additional information can be passed.
+   *  If the montior function returns true, the solver terminates (either convergence or divergence).
+   */
+  void set_monitor(bool (*monitor_fun)(VectorT const &, numeric_type, void *), void *user_data)
+  {
+    monitor_callback_ = monitor_fun;
+    user_data_ = user_data;
+  }
+
+  /** @brief Returns the solver tag containing basic configuration such as tolerances, etc. */
+  gcrodr_tag const & tag() const { return tag_; }
+
+  /** @brief Returns the current dimension of the recycled subspace */
+  vcl_size_t recycled_dim() const { return has_recycled_subspace_ ? recycled_subspace_.size2() : 0; }
+
+  /** @brief Discards the recycled subspace, e.g. before solving an unrelated system */
+  void clear_recycled_subspace() { has_recycled_subspace_ = false; }
+
+private:
+  template<typename MatrixT, typename PreconditionerT>
+  VectorT solve_and_recycle(MatrixT const & A, VectorT const & b, PreconditionerT const & precond)
+  {
+    if (has_recycled_subspace_)
+      return detail::gcro_dr_solve(A, b, tag_, precond, tag_.recycle_dim(), recycled_subspace_, monitor_callback_, user_data_);
+
+    // dense matrices cannot be resized to zero columns, hence the new subspace is set up separately:
+    viennacl::matrix<numeric_type, viennacl::column_major> new_subspace;
+    VectorT result = detail::gcro_dr_solve(A, b, tag_, precond, tag_.recycle_dim(), new_subspace, monitor_callback_, user_data_);
+    if (new_subspace.size2() > 0)
+    {
+      detail::block_krylov_assign(recycled_subspace_, new_subspace);
+      has_recycled_subspace_ = true;
+    }
+    return result;
+  }
+
+  gcrodr_tag tag_;
+  VectorT    init_guess_;
+  bool       (*monitor_callback_)(VectorT const &, numeric_type, void *);
+  void       *user_data_;
+  bool       has_recycled_subspace_;
+  viennacl::matrix<numeric_type, viennacl::column_major> recycled_subspace_;
+};
+
+
+}
+}
+
+#endif
@@ -36,6 +36,8 @@
 #include "viennacl/meta/result_of.hpp"
 
 #include "viennacl/linalg/iterative_operations.hpp"
+#include "viennacl/linalg/detail/block_krylov.hpp"
+#include "viennacl/linalg/detail/s_step_krylov.hpp"
 #include "viennacl/vector_proxy.hpp"
 
 
@@ -51,17 +53,17 @@ class gmres_tag       //generalized minimum residual
 public:
   /** @brief The constructor
   *
-  * @param tol            Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||)
+  * @param tol            Relative tolerance for the residual (solver quits if ||r|| < tol * ||r_initial||). With a preconditioner M, r is the preconditioned residual M^{-1}(b - Ax) and r_initial = M^{-1}b.
   * @param max_iterations The maximum number of iterations (including restarts
   * @param krylov_dim     The maximum dimension of the Krylov space before restart (number of restarts is found by max_iterations / krylov_dim)
   */
   gmres_tag(double tol = 1e-10, unsigned int max_iterations = 300, unsigned int krylov_dim = 20)
-   : tol_(tol), abs_tol_(0), iterations_(max_iterations), krylov_dim_(krylov_dim), iters_taken_(0) {}
+   : tol_(tol), abs_tol_(0), iterations_(max_iterations), krylov_dim_(krylov_dim), s_(1), iters_taken_(0) {}
 
   /** @brief Returns the relative tolerance */
   double tolerance() const { return tol_; }
 
-  /** @brief Returns the absolute tolerance */
+  /** @brief Returns the absolute tolerance. With a preconditioner M, it refers to the preconditioned residual M^{-1}(b - Ax), like the relative tolerance */
   double abs_tolerance() const { return abs_tol_; }
   /** @brief Sets the absolute tolerance */
   void abs_tolerance(double new_tol) { if (new_tol >= 0) abs_tol_ = new_tol; }
@@ -79,6 +81,15 @@ public:
     return ret;
   }
 
+  /** @brief Returns the number of Krylov basis vectors s computed per step of the s-step method (s = 1 for the standard method) */
+  unsigned int s() const { return s_; }
+  /** @brief Sets the number of Krylov basis vectors s computed per step of the s-step method.
+  *
+  * For s > 1, the basis vectors are orthogonalized in blocks of s, requiring only two global reductions every s iterations.
+  * Values of s up to about 10 are reasonable, larger values result in an ill-conditioned Krylov basis.
+  */
+  void s(unsigned int new_s) { if (new_s > 0) s_ = new_s; }
+
   /** @brief Return the number of solver iterations: */
   unsigned int iters() const { return iters_taken_; }
   /** @brief Set the number of solver iterations (should only be modified by the solver) */
@@ -94,6 +105,7 @@ private:
   double abs_tol_;
   unsigned int iterations_;
   unsigned int krylov_dim_;
+  unsigned int s_;
 
   //return values from solver
   mutable unsigned int iters_taken_;
@@ -119,6 +131,29 @@ namespace detail
                    dest.begin() + static_cast<difference_type>(start));
   }
 
+  /** @brief Computes the Givens rotation (c, s) with -s * a + c * b = 0, i.e. the rotation eliminating 'b' in the vector (a, b). */
+  template<typename NumericT>
+  void gmres_givens_rotation(NumericT a, NumericT b, NumericT & c, NumericT & s)
+  {
+    if (b == 0)
+    {
+      c = 1;
+      s = 0;
+    }
+    else if (std::fabs(b) > std::fabs(a))
+    {
+      NumericT t = a / b;
+      s = NumericT(1) / std::sqrt(NumericT(1) + t * t);
+      c = s * t;
+    }
+    else
+    {
+      NumericT t = b / a;
+      c = NumericT(1) / std::sqrt(NumericT(1) + t * t);
+      s = c * t;
+    }
+  }
+
   /** @brief Computes the householder vector 'hh_vec' which rotates 'input_vec' such that all entries below the j-th entry of 'v' become zero.
     *
     * @param input_vec       The input vector
@@ -366,7 +401,262 @@ namespace detail
     return result;
   }
 
-  /** @brief Overload for the pipelined CG implementation for the ViennaCL sparse matrix types */
+  /** @brief Implementation of the restarted s-step GMRES method (CA-GMRES), see M. Hoemmen, "Communication-avoiding Krylov subspace methods", PhD thesis, UC Berkeley (2010)
+  *
+  * The Krylov basis is extended by s Chebyshev basis vectors at a time, computed from the last orthonormal basis vector without any global reduction.
+  * The s new vectors are orthogonalized against the previous basis vectors by two passes of block classical Gram-Schmidt,
+  * where each pass computes the projections and the Gram matrix of the new vectors with a single dense matrix-matrix product (i.e. one global reduction).
+  * The new vectors are then orthonormalized by a Cholesky factorization of the Gram matrix on the host (falling back to SVQB if the factorization fails).
+  * The least squares problem is set up on the host from the coordinates of the basis vectors and the change of basis matrix.
+  * The spectral interval for the Chebyshev basis is estimated from the eigenvalues of the symmetric part of the Hessenberg matrix of the first restart cycle.
+  *
+  * @param A            The system matrix
+  * @param rhs          The load vector
+  * @param tag          Solver configuration tag
+  * @param precond      A preconditioner. Precondition operation is done via member function apply()
+  * @param monitor      A callback routine which is called at each GMRES restart
+  * @param monitor_data Data pointer to be passed to the callback routine to pass on user-specific data
+  * @return The result vector
+  */
+  template<typename MatrixT, typename NumericT, typename PreconditionerT>
+  viennacl::vector<NumericT> s_step_solve(MatrixT const & A,
+                                          viennacl::vector<NumericT> const & rhs,
+                                          gmres_tag const & tag,
+                                          PreconditionerT const & precond,
+                                          bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
+                                          void *monitor_data = NULL)
+  {
+    typedef viennacl::matrix<NumericT, viennacl::column_major>   BlockType;
+    typedef std::vector< std::vector<NumericT> >                 HostMatrixType;
+
+    viennacl::context ctx = viennacl::traits::context(rhs);
+    vcl_size_t n = rhs.size();
+    vcl_size_t krylov_dim = std::min<vcl_size_t>(tag.krylov_dim(), n);
+    viennacl::range all_rows(0, n);
+
+    viennacl::vector<NumericT> result(rhs);
+    viennacl::traits::clear(result);
+
+    // The residuals below are preconditioned, hence both tolerances refer to the preconditioned right hand side:
+    viennacl::vector<NumericT> res(rhs);
+    precond.apply(res);
+    NumericT norm_rhs = viennacl::linalg::norm_2(res);
+
+    tag.iters(0);
+    if (norm_rhs <= tag.abs_tolerance()) //solution is zero if RHS norm is zero
+      return result;
+
+    // initial spectral interval from ||M^{-1} A r|| / ||r||, refined by the eigenvalues of the Hessenberg matrix in the first restart cycle:
+    viennacl::vector<NumericT> op_res = viennacl::linalg::prod(A, res);
+    precond.apply(op_res);
+    NumericT lambda_max = NumericT(2) * viennacl::linalg::norm_2(op_res) / norm_rhs;
+    s_step_chebyshev_basis<NumericT> basis(NumericT(0), lambda_max);
+    bool interval_from_ritz_values = false;
+    bool triangular_coordinates = true;  // false once SVQB is used, since then N is no longer upper triangular
+
+    BlockType V(n, krylov_dim + 1, ctx);
+    viennacl::vector_base<NumericT> V_0(V.handle(), n, 0, 1);
+
+    for (unsigned int it = 0; it <= tag.max_restarts(); ++it)
+    {
+      res = viennacl::linalg::prod(A, result);
+      res = rhs - res;
+      precond.apply(res);
+
+      NumericT rho_0 = viennacl::linalg::norm_2(res);
+      if (rho_0 / norm_rhs < tag.tolerance() || rho_0 < tag.abs_tolerance()) // norm_rhs is known to be nonzero here
+      {
+        tag.error(rho_0 / norm_rhs);
+        return result;
+      }
+      V_0 = res / rho_0;
+
+      // coordinates of the directions rho_j(op) q with respect to the orthonormal basis (N), and of op applied to them (M):
+      HostMatrixType N(krylov_dim + 1, std::vector<NumericT>(krylov_dim));
+      HostMatrixType M(krylov_dim + 1, std::vector<NumericT>(krylov_dim));
+      HostMatrixType Y;
+      std::vector<NumericT> residual_norms(1, rho_0);
+
+      vcl_size_t num_q = 1;     // number of orthonormal basis vectors
+      vcl_size_t num_dirs = 0;  // number of directions
+      while (num_dirs < krylov_dim)
+      {
+        vcl_size_t s = std::min<vcl_size_t>(tag.s(), krylov_dim - num_dirs);
+
+        //
+        // Matrix powers kernel: new basis vectors from the last orthonormal basis vector
+        //
+        s_step_matrix_powers(A, precond, basis, V, num_q - 1, num_q, s);
+
+        //
+        // Two passes of block classical Gram-Schmidt. Each pass obtains both Q^T W and W^T W from one product [Q, W]^T W:
+        //
+        viennacl::matrix_range<BlockType> Q(V, all_rows, viennacl::range(0, num_q));
+        viennacl::matrix_range<BlockType> W(V, all_rows, viennacl::range(num_q, num_q + s));
+        viennacl::matrix_range<BlockType> QW(V, all_rows, viennacl::range(0, num_q + s));
+
+        HostMatrixType C_total(num_q, std::vector<NumericT>(s));
+        HostMatrixType G(s, std::vector<NumericT>(s));
+        for (unsigned int pass = 0; pass < 2; ++pass)
+        {
+          BlockType vcl_QW_W = viennacl::linalg::prod(trans(QW), W);
+          HostMatrixType QW_W = block_krylov_to_host(vcl_QW_W);
+
+          HostMatrixType C(num_q, std::vector<NumericT>(s));
+          for (vcl_size_t i=0; i<num_q; ++i)
+            for (vcl_size_t j=0; j<s; ++j)
+            {
+              C[i][j] = QW_W[i][j];
+              C_total[i][j] += QW_W[i][j];
+            }
+
+          for (vcl_size_t i=0; i<s; ++i)  // Gram matrix of W - Q C
+            for (vcl_size_t j=0; j<s; ++j)
+            {
+              G[i][j] = QW_W[num_q + i][j];
+              for (vcl_size_t l=0; l<num_q; ++l)
+                G[i][j] -= C[l][i] * C[l][j];
+            }
+
+          BlockType vcl_C = block_krylov_from_host(C, ctx);
+          BlockType QC = viennacl::linalg::prod(Q, vcl_C);
+          W -= QC;
+        }
+
+        //
+        // Orthonormalize W = W_new R within the block:
+        //
+        BlockType W_copy(n, s, ctx);
+        W_copy = W;
+        HostMatrixType R;
+        vcl_size_t rank = s;
+        if (block_krylov_cholesky(G))
+        {
+          // W_new = W R^{-1} with R = L^T:
+          BlockType vcl_R_inv = block_krylov_from_host(block_krylov_cholesky_inverse_transpose(G), ctx);
+          W = viennacl::linalg::prod(W_copy, vcl_R_inv);
+
+          R = HostMatrixType(s, std::vector<NumericT>(s));
+          for (vcl_size_t i=0; i<s; ++i)
+            for (vcl_size_t j=i; j<s; ++j)
+              R[i][j] = G[j][i];
+        }
+        else
+        {
+          triangular_coordinates = false;
+          BlockType W_new(n, s, ctx);
+          W_new = W_copy;
+          rank = block_krylov_orthonormalize(W_new);
+          if (rank > 0)
+          {
+            BlockType vcl_R = viennacl::linalg::prod(trans(W_new), W_copy);
+            R = block_krylov_to_host(vcl_R);
+            viennacl::project(V, all_rows, viennacl::range(num_q, num_q + rank)) = W_new;
+          }
+        }
+
+        //
+        // Coordinates of the new directions. Only 'rank' directions are kept if the new basis vectors are (numerically) linearly dependent:
+        //
+        vcl_size_t num_new_dirs = std::max<vcl_size_t>(rank, 1);
+        HostMatrixType rho_coords(s + 1, std::vector<NumericT>(num_q + rank));
+        rho_coords[0][num_q - 1] = NumericT(1);
+        for (vcl_size_t j=1; j<=s; ++j)
+        {
+          for (vcl_size_t i=0; i<num_q; ++i)
+            rho_coords[j][i] = C_total[i][j-1];
+          for (vcl_size_t i=0; i<rank; ++i)
+            rho_coords[j][num_q + i] = R[i][j-1];
+        }
+
+        HostMatrixType B = basis.change_of_basis(s);
+        for (vcl_size_t j=0; j<num_new_dirs; ++j)
+          for (vcl_size_t i=0; i<num_q + rank; ++i)
+          {
+            N[i][num_dirs + j] = rho_coords[j][i];
+            for (vcl_size_t l=0; l<=s; ++l)
+              M[i][num_dirs + j] += B[l][j] * rho_coords[l][i];
+          }
+
+        num_q    += rank;
+        num_dirs += num_new_dirs;
+        tag.iters(tag.iters() + static_cast<unsigned int>(num_new_dirs));
+
+        //
+        // Solve the least squares problem min || rho_0 e_1 - M y ||:
+        //
+        HostMatrixType H(num_q, std::vector<NumericT>(num_dirs));
+        HostMatrixType S(num_q, std::vector<NumericT>(1));
+        for (vcl_size_t i=0; i<num_q; ++i)
+          for (vcl_size_t j=0; j<num_dirs; ++j)
+            H[i][j] = M[i][j];
+        S[0][0] = rho_0;
+        block_krylov_least_squares(H, S, Y, residual_norms);
+
+        //
+        // Refine the spectral interval from the Hessenberg matrix M N^{-1} (the square part of N is upper triangular):
+        //
+        if (!interval_from_ritz_values && triangular_coordinates && num_dirs == num_q - 1 && num_dirs <= 40)
+        {
+          HostMatrixType Hessenberg(num_dirs, std::vector<NumericT>(num_dirs));
+          for (vcl_size_t i=0; i<num_dirs; ++i)
+            for (vcl_size_t j=0; j<num_dirs; ++j)
+            {
+              NumericT value = M[i][j];
+              for (vcl_size_t l=0; l<j; ++l)
+                value -= Hessenberg[i][l] * N[l][j];
+              Hessenberg[i][j] = value / N[j][j];
+            }
+          NumericT lower, upper;
+          s_step_spectral_interval(Hessenberg, num_dirs, lower, upper);
+          basis = s_step_chebyshev_basis<NumericT>(lower, upper);
+        }
+
+        if (residual_norms[0] / norm_rhs < tag.tolerance() || residual_norms[0] < tag.abs_tolerance() || rank < s || tag.iters() >= tag.max_iterations())
+          break;
+      }
+      interval_from_ritz_values = true;
+
+      //
+      // Update the result: x += Q N y
+      //
+      std::vector<NumericT> z(num_q);
+      for (vcl_size_t i=0; i<num_q; ++i)
+        for (vcl_size_t j=0; j<num_dirs; ++j)
+          z[i] += N[i][j] * Y[j][0];
+      viennacl::vector<NumericT> vcl_z(num_q, ctx);
+      viennacl::copy(z, vcl_z);
+      res = viennacl::linalg::prod(viennacl::project(V, all_rows, viennacl::range(0, num_q)), vcl_z);
+      result += res;
+
+      tag.error(residual_norms[0] / norm_rhs);
+
+      if (monitor && monitor(result, residual_norms[0] / norm_rhs, monitor_data))
+        break;
+      if (tag.iters() >= tag.max_iterations())
+        break;
+    }
+
+    return result;
+  }
+
+  /** @brief Dispatches to the s-step GMRES for the ViennaCL vector type, otherwise returns false (the standard GMRES is used then) */
+  template<typename MatrixT, typename VectorT, typename PreconditionerT, typename MonitorT>
+  bool s_step_dispatch(MatrixT const &, VectorT const &, VectorT &, gmres_tag const &, PreconditionerT const &, MonitorT, void *)
+  {
+    return false;
+  }
+
+  template<typename MatrixT, typename NumericT, typename PreconditionerT>
+  bool s_step_dispatch(MatrixT const & A, viennacl::vector<NumericT> const & rhs, viennacl::vector<NumericT> & result, gmres_tag const & tag, PreconditionerT const & precond,
+                       bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*), void *monitor_data)
+  {
+    result = s_step_solve(A, rhs, tag, precond, monitor, monitor_data);
+    return true;
+  }
+
+
+  /** @brief Overload for the pipelined and s-step GMRES implementations for the ViennaCL sparse matrix types */
   template<typename NumericT>
   viennacl::vector<NumericT> solve_impl(viennacl::compressed_matrix<NumericT> const & A,
                                         viennacl::vector<NumericT> const & rhs,
@@ -375,11 +665,13 @@ namespace detail
                                         bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
                                         void *monitor_data = NULL)
   {
-    return pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
+    if (tag.s() > 1)
+      return detail::s_step_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
+    return detail::pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
   }
 
 
-  /** @brief Overload for the pipelined CG implementation for the ViennaCL sparse matrix types */
+  /** @brief Overload for the pipelined and s-step GMRES implementations for the ViennaCL sparse matrix types */
   template<typename NumericT>
   viennacl::vector<NumericT> solve_impl(viennacl::coordinate_matrix<NumericT> const & A,
                                         viennacl::vector<NumericT> const & rhs,
@@ -388,12 +680,14 @@ namespace detail
                                         bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
                                         void *monitor_data = NULL)
   {
+    if (tag.s() > 1)
+      return detail::s_step_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
     return detail::pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
   }
 
 
 
-  /** @brief Overload for the pipelined CG implementation for the ViennaCL sparse matrix types */
+  /** @brief Overload for the pipelined and s-step GMRES implementations for the ViennaCL sparse matrix types */
   template<typename NumericT>
   viennacl::vector<NumericT> solve_impl(viennacl::ell_matrix<NumericT> const & A,
                                         viennacl::vector<NumericT> const & rhs,
@@ -402,12 +696,14 @@ namespace detail
                                         bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
                                         void *monitor_data = NULL)
   {
+    if (tag.s() > 1)
+      return detail::s_step_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
     return detail::pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
   }
 
 
 
-  /** @brief Overload for the pipelined CG implementation for the ViennaCL sparse matrix types */
+  /** @brief Overload for the pipelined and s-step GMRES implementations for the ViennaCL sparse matrix types */
   template<typename NumericT>
   viennacl::vector<NumericT> solve_impl(viennacl::sliced_ell_matrix<NumericT> const & A,
                                         viennacl::vector<NumericT> const & rhs,
@@ -416,11 +712,13 @@ namespace detail
                                         bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
                                         void *monitor_data = NULL)
   {
+    if (tag.s() > 1)
+      return detail::s_step_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
     return detail::pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
   }
 
 
-  /** @brief Overload for the pipelined CG implementation for the ViennaCL sparse matrix types */
+  /** @brief Overload for the pipelined and s-step GMRES implementations for the ViennaCL sparse matrix types */
   template<typename NumericT>
   viennacl::vector<NumericT> solve_impl(viennacl::hyb_matrix<NumericT> const & A,
                                         viennacl::vector<NumericT> const & rhs,
@@ -429,13 +727,16 @@ namespace detail
                                         bool (*monitor)(viennacl::vector<NumericT> const &, NumericT, void*) = NULL,
                                         void *monitor_data = NULL)
   {
+    if (tag.s() > 1)
+      return detail::s_step_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
     return detail::pipelined_solve(A, rhs, tag, viennacl::linalg::no_precond(), monitor, monitor_data);
   }
 
 
   /** @brief Implementation of the GMRES solver.
   *
-  * Following the algorithm proposed by Walker in "A Simpler GMRES"
+  * Following the Householder implementation proposed by Walker in "Implementation of the GMRES Method Using Householder Transformations".
+  * The Hessenberg matrix is triangularized by Givens rotations, so the residual norm is available in each iteration from the rotated right hand side of the least squares problem.
   *
   * @param matrix       The system matrix
   * @param rhs          The load vector
@@ -461,6 +762,9 @@ namespace detail
     VectorT result = rhs;
     viennacl::traits::clear(result);
 
+    if (tag.s() > 1 && detail::s_step_dispatch(matrix, rhs, result, tag, precond, monitor, monitor_data))
+      return result;
+
     vcl_size_t krylov_dim = static_cast<vcl_size_t>(tag.krylov_dim());
     if (problem_size < krylov_dim)
       krylov_dim = problem_size; //A Krylov space larger than the matrix would lead to seg-faults (mathematically, error is certain to be zero already)
@@ -469,13 +773,19 @@ namespace detail
     VectorT v_k_tilde = rhs;
     VectorT v_k_tilde_temp = rhs;
 
-    std::vector< std::vector<CPU_NumericType> > R(krylov_dim, std::vector<CPU_NumericType>(tag.krylov_dim()));
-    std::vector<CPU_NumericType> projection_rhs(krylov_dim);
+    // columns of the Hessenberg matrix, triangularized by Givens rotations:
+    std::vector< std::vector<CPU_NumericType> > R(krylov_dim, std::vector<CPU_NumericType>(krylov_dim + 1));
+    std::vector<CPU_NumericType> projection_rhs(krylov_dim + 1);
+    std::vector<CPU_NumericType> givens_c(krylov_dim);
+    std::vector<CPU_NumericType> givens_s(krylov_dim);
 
-    std::vector<VectorT>          householder_reflectors(krylov_dim, rhs);
-    std::vector<CPU_NumericType>  betas(krylov_dim);
+    std::vector<VectorT>          householder_reflectors(krylov_dim + 1, rhs);
+    std::vector<CPU_NumericType>  betas(krylov_dim + 1);
 
-    CPU_NumericType norm_rhs = viennacl::linalg::norm_2(rhs);
+    // The residuals below are preconditioned, hence both tolerances refer to the preconditioned right hand side (the initial residual for a zero initial guess):
+    res = rhs;
+    precond.apply(res);
+    CPU_NumericType norm_rhs = viennacl::linalg::norm_2(res);
 
     if (norm_rhs <= tag.abs_tolerance()) //solution is zero if RHS norm is zero
       return result;
@@ -503,11 +813,11 @@ namespace detail
       }
 
       //
-      // Normalize residual and set 'rho' to 1 as requested in 'A Simpler GMRES' by Walker and Zhou.
+      // Householder reflection P_0 with P_0 r = rho_0 e_0, which defines the first basis vector v_0 = P_0 e_0 = r / rho_0:
       //
-      res /= rho_0;
-      CPU_NumericType rho = static_cast<CPU_NumericType>(1.0);
-
+      viennacl::traits::clear(householder_reflectors[0]);
+      detail::gmres_setup_householder_vector(res, householder_reflectors[0], betas[0], projection_rhs[0], 0);
+      CPU_NumericType rho = std::fabs(projection_rhs[0]);
 
       //
       // Iterate up until maximal Krylove space dimension is reached:
@@ -517,65 +827,56 @@ namespace detail
       {
         tag.iters( tag.iters() + 1 ); //increase iteration counter
 
-        // prepare storage:
-        viennacl::traits::clear(R[k]);
-        viennacl::traits::clear(householder_reflectors[k]);
-
-        //compute v_k = A * v_{k-1} via Householder matrices
-        if (k == 0)
-        {
-          v_k_tilde = viennacl::linalg::prod(matrix, res);
-          precond.apply(v_k_tilde);
-        }
-        else
-        {
-          viennacl::traits::clear(v_k_tilde);
-          v_k_tilde[k-1] = CPU_NumericType(1);
-
-          //Householder rotations, part 1: Compute P_1 * P_2 * ... * P_{k-1} * e_{k-1}
-          for (int i = static_cast<int>(k)-1; i > -1; --i)
-            detail::gmres_householder_reflect(v_k_tilde, householder_reflectors[vcl_size_t(i)], betas[vcl_size_t(i)]);
-
-          v_k_tilde_temp = viennacl::linalg::prod(matrix, v_k_tilde);
-          precond.apply(v_k_tilde_temp);
-          v_k_tilde = v_k_tilde_temp;
-
-          //Householder rotations, part 2: Compute P_{k-1} * ... * P_{1} * v_k_tilde
-          for (vcl_size_t i = 0; i < k; ++i)
-            detail::gmres_householder_reflect(v_k_tilde, householder_reflectors[i], betas[i]);
-        }
-
         //
-        // Compute Householder reflection for v_k_tilde such that all entries below k-th entry are zero:
+        // Compute the basis vector v_k = P_0 * P_1 * ... * P_k * e_k
         //
-        CPU_NumericType rho_k_k = 0;
-        detail::gmres_setup_householder_vector(v_k_tilde, householder_reflectors[k], betas[k], rho_k_k, k);
+        viennacl::traits::clear(v_k_tilde);
+        v_k_tilde[k] = CPU_NumericType(1);
+        for (int i = static_cast<int>(k); i > -1; --i)
+          detail::gmres_householder_reflect(v_k_tilde, householder_reflectors[vcl_size_t(i)], betas[vcl_size_t(i)]);
 
         //
-        // copy first k entries from v_k_tilde to R[k] in order to fill k-th column with result of
-        // P_k * v_k_tilde = (v[0], ... , v[k-1], norm(v), 0, 0, ...) =: (rho_{1,k}, rho_{2,k}, ..., rho_{k,k}, 0, ..., 0);
+        // Compute P_k * ... * P_0 * (M^{-1} A v_k)
         //
-        detail::gmres_copy_helper(v_k_tilde, R[k], k);
-        R[k][k] = rho_k_k;
+        v_k_tilde_temp = viennacl::linalg::prod(matrix, v_k_tilde);
+        precond.apply(v_k_tilde_temp);
+        v_k_tilde = v_k_tilde_temp;
+
+        for (vcl_size_t i = 0; i <= k; ++i)
+          detail::gmres_householder_reflect(v_k_tilde, householder_reflectors[i], betas[i]);
 
         //
-        // Update residual: r = P_k r
-        // Set zeta_k = r[k] including machine precision considerations: mathematically we have |r[k]| <= rho
-        // Set rho *= sin(acos(r[k] / rho))
+        // Householder reflection P_{k+1} such that all entries of v_k_tilde below the (k+1)-th entry become zero.
+        // The first k+2 entries then form the k-th column of the Hessenberg matrix (the last one is zero if the Krylov space spans the whole space):
         //
-        detail::gmres_householder_reflect(res, householder_reflectors[k], betas[k]);
+        viennacl::traits::clear(R[k]);
+        detail::gmres_copy_helper(v_k_tilde, R[k], k+1);
+        if (k + 1 < problem_size)
+        {
+          viennacl::traits::clear(householder_reflectors[k+1]);
+          detail::gmres_setup_householder_vector(v_k_tilde, householder_reflectors[k+1], betas[k+1], R[k][k+1], k+1);
+        }
 
-        if (res[k] > rho) //machine precision reached
-          res[k] = rho;
-        if (res[k] < -rho) //machine precision reached
-          res[k] = -rho;
-        projection_rhs[k] = res[k];
+        //
+        // Triangularize the Hessenberg matrix by Givens rotations, which are also applied to the right hand side rho_0 e_0 of the least squares problem.
+        // The residual norm is the magnitude of the last entry of the rotated right hand side.
+        //
+        for (vcl_size_t i = 0; i < k; ++i)
+        {
+          CPU_NumericType temp = givens_c[i] * R[k][i] + givens_s[i] * R[k][i+1];
+          R[k][i+1] = -givens_s[i] * R[k][i] + givens_c[i] * R[k][i+1];
+          R[k][i] = temp;
+        }
+        detail::gmres_givens_rotation(R[k][k], R[k][k+1], givens_c[k], givens_s[k]);
+        R[k][k]   = givens_c[k] * R[k][k] + givens_s[k] * R[k][k+1];
+        R[k][k+1] = 0;
 
-        rho *= std::sin( std::acos(projection_rhs[k] / rho) );
+        projection_rhs[k+1] = -givens_s[k] * projection_rhs[k];
+        projection_rhs[k]   =  givens_c[k] * projection_rhs[k];
+        rho = std::fabs(projection_rhs[k+1]);
 
-        if (std::fabs(rho * rho_0 / norm_rhs) < tag.tolerance())  // Residual is sufficiently reduced, stop here
+        if (rho / norm_rhs < tag.tolerance())  // Residual is sufficiently reduced, stop here
         {
-          tag.error( std::fabs(rho*rho_0 / norm_rhs) );
           ++k;
           break;
         }
@@ -595,32 +896,27 @@ namespace detail
       }
 
       //
-      // Note: 'projection_rhs' now holds the solution (eta_1, ..., eta_k)
+      // Note: 'projection_rhs' now holds the coefficients (y_0, ..., y_{k-1}) of the update with respect to the basis vectors v_0, ..., v_{k-1}
       //
 
-      res *= projection_rhs[0];
-
-      if (k > 0)
-      {
-        for (unsigned int i = 0; i < k-1; ++i)
-          res[i] += projection_rhs[i+1];
-      }
-
       //
-      // Form z inplace in 'res' by applying P_1 * ... * P_{k}
+      // Form z = sum_i y_i v_i = P_0 * (y_0 e_0 + P_1 * (y_1 e_1 + ... + P_{k-1} * y_{k-1} e_{k-1})) inplace in 'res'
       //
+      viennacl::traits::clear(res);
+      for (vcl_size_t i = 0; i < k; ++i)
+        res[i] = projection_rhs[i];
+
       for (int i=static_cast<int>(k)-1; i>=0; --i)
         detail::gmres_householder_reflect(res, householder_reflectors[vcl_size_t(i)], betas[vcl_size_t(i)]);
 
-      res *= rho_0;
-      result += res;  // x += rho_0 * z    in the paper
+      result += res;
 
       //
       // Check for convergence:
       //
-      tag.error(std::fabs(rho*rho_0 / norm_rhs));
+      tag.error(rho / norm_rhs);
 
-      if (monitor && monitor(result, std::fabs(rho*rho_0 / norm_rhs), monitor_data))
+      if (monitor && monitor(result, rho / norm_rhs, monitor_data))
         break;
 
       if ( tag.error() < tag.tolerance() )
@@ -630,6 +926,201 @@ namespace detail
     return result;
   }
 
+
+  /** @brief Implementation of the restarted block GMRES method for multiple right hand sides.
+  *
+  * In each step of the block Arnoldi process, the sparse matrix is multiplied with a block of basis vectors at once (sparse matrix-matrix product).
+  * The new block is orthogonalized against all previous blocks by two passes of block classical Gram-Schmidt, each requiring only two dense matrix-matrix products,
+  * and then orthonormalized within the block, dropping (numerically) linearly dependent columns.
+  * The small least squares problems with the block Hessenberg matrix are solved on the host.
+  * Converged columns are removed at each restart (deflation).
+  *
+  * Like the single right hand side implementation, the preconditioner is applied from the left and the relative tolerance refers to the preconditioned residuals.
+  *
+  * @param A        The system matrix
+  * @param rhs      The right hand sides (one per column)
+  * @param tag      Solver configuration tag. The Krylov dimension and the number of iterations refer to block steps, the error to the largest relative residual of all columns.
+  * @param precond  A preconditioner, applied to each column separately
+  * @return The solutions (one per column)
+  */
+  template<typename MatrixT, typename NumericT, typename F, unsigned int AlignmentV, typename PreconditionerT>
+  viennacl::matrix<NumericT, F, AlignmentV> block_solve_impl(MatrixT const & A,
+                                                             viennacl::matrix<NumericT, F, AlignmentV> const & rhs,
+                                                             gmres_tag const & tag,
+                                                             PreconditionerT const & precond)
+  {
+    typedef viennacl::matrix<NumericT, viennacl::column_major>   BlockType;
+    typedef std::vector< std::vector<NumericT> >                 HostMatrixType;
+
+    viennacl::context ctx = viennacl::traits::context(rhs);
+    vcl_size_t n = rhs.size1();
+    vcl_size_t num_rhs = rhs.size2();
+    viennacl::range all_rows(0, n);
+
+    tag.iters(0);
+    tag.error(0);
+
+    viennacl::matrix<NumericT, F, AlignmentV> result(n, num_rhs, ctx);
+    if (n == 0 || num_rhs == 0)
+      return result;
+
+    BlockType X(n, num_rhs, ctx);
+    BlockType B(n, num_rhs, ctx);
+    detail::block_krylov_copy(rhs, B);
+
+    NumericT tol     = static_cast<NumericT>(tag.tolerance());
+    NumericT abs_tol = static_cast<NumericT>(tag.abs_tolerance());
+
+    // The residuals below are preconditioned, hence both tolerances refer to the preconditioned right hand sides. Columns with zero right hand side have the zero solution:
+    BlockType preconditioned_B = B;
+    detail::block_krylov_apply_precond(preconditioned_B, precond);
+    std::vector<NumericT> rhs_norms = detail::block_krylov_column_norms(preconditioned_B);
+    std::vector<vcl_size_t> active;   // original column index of each column in the iteration
+    for (vcl_size_t j=0; j<num_rhs; ++j)
+      if (rhs_norms[j] > abs_tol)
+        active.push_back(j);
+
+    std::vector<NumericT> errors(num_rhs);
+    vcl_size_t krylov_dim = std::min<vcl_size_t>(tag.krylov_dim(), n);
+
+    for (unsigned int it = 0; it <= tag.max_restarts() && !active.empty(); ++it)
+    {
+      //
+      // (Re-)Initialize residuals R = M^{-1} (B - A * X) and deflate converged columns:
+      //
+      BlockType X_active = detail::block_krylov_select_columns(X, active);
+      BlockType R(n, active.size(), ctx);   // Note: Constructing R directly from the product would result in row-major memory layout
+      R = viennacl::linalg::prod(A, X_active);
+      R = detail::block_krylov_select_columns(B, active) - R;
+      detail::block_krylov_apply_precond(R, precond);
+
+      std::vector<NumericT> residual_norms = detail::block_krylov_column_norms(R);
+      std::vector<vcl_size_t> remaining;
+      for (vcl_size_t j=0; j<active.size(); ++j)
+      {
+        errors[active[j]] = (rhs_norms[active[j]] > 0) ? residual_norms[j] / rhs_norms[active[j]] : NumericT(0);
+        if (errors[active[j]] >= tol && residual_norms[j] >= abs_tol)
+          remaining.push_back(j);
+      }
+      if (remaining.empty())
+        break;
+
+      if (remaining.size() < active.size())
+      {
+        detail::block_krylov_assign(R, detail::block_krylov_select_columns(R, remaining));
+        for (vcl_size_t j=0; j<remaining.size(); ++j)
+          active[j] = active[remaining[j]];
+        active.resize(remaining.size());
+      }
+      vcl_size_t block_size = active.size();
+
+      //
+      // First block of the Krylov basis: R = V_0 S_0
+      //
+      BlockType V(n, (krylov_dim + 1) * block_size, ctx);
+      BlockType V_0 = R;
+      vcl_size_t rank = detail::block_krylov_orthonormalize(V_0);
+      if (rank == 0)
+        break;
+      viennacl::project(V, all_rows, viennacl::range(0, rank)) = V_0;
+
+      BlockType vcl_S = viennacl::linalg::prod(trans(V_0), R);
+      HostMatrixType S = detail::block_krylov_to_host(vcl_S);
+
+      std::vector<vcl_size_t> block_offsets(1, 0);
+      block_offsets.push_back(rank);
+
+      HostMatrixType H((krylov_dim + 1) * block_size, std::vector<NumericT>(krylov_dim * block_size));
+      HostMatrixType Y;
+      std::vector<NumericT> estimates;
+
+      //
+      // Block Arnoldi process:
+      //
+      for (vcl_size_t k = 0; k < krylov_dim; ++k)
+      {
+        tag.iters( tag.iters() + 1 ); //increase iteration counter
+
+        vcl_size_t basis_size = block_offsets[k+1];
+        viennacl::range current_block(block_offsets[k], basis_size);
+        viennacl::matrix_range<BlockType> V_basis(V, all_rows, viennacl::range(0, basis_size));
+
+        BlockType V_k = viennacl::project(V, all_rows, current_block);
+        BlockType W(n, V_k.size2(), ctx);
+        W = viennacl::linalg::prod(A, V_k);
+        detail::block_krylov_apply_precond(W, precond);
+
+        // block classical Gram-Schmidt, two passes:
+        for (unsigned int pass = 0; pass < 2; ++pass)
+        {
+          BlockType vcl_C = viennacl::linalg::prod(trans(V_basis), W);
+          W -= viennacl::linalg::prod(V_basis, vcl_C);
+
+          HostMatrixType C = detail::block_krylov_to_host(vcl_C);
+          for (vcl_size_t i=0; i<basis_size; ++i)
+            for (vcl_size_t j=0; j<C[i].size(); ++j)
+              H[i][block_offsets[k] + j] += C[i][j];
+        }
+
+        // orthonormalize within the new block:
+        BlockType V_next = W;
+        rank = detail::block_krylov_orthonormalize(V_next);
+        if (rank > 0)
+        {
+          BlockType vcl_H_next = viennacl::linalg::prod(trans(V_next), W);
+          HostMatrixType H_next = detail::block_krylov_to_host(vcl_H_next);
+          for (vcl_size_t i=0; i<rank; ++i)
+            for (vcl_size_t j=0; j<H_next[i].size(); ++j)
+              H[basis_size + i][block_offsets[k] + j] = H_next[i][j];
+
+          viennacl::project(V, all_rows, viennacl::range(basis_size, basis_size + rank)) = V_next;
+        }
+        block_offsets.push_back(basis_size + rank);
+
+        //
+        // Solve least squares problems min ||H y_j - S_0 e_j|| and check for convergence:
+        //
+        HostMatrixType H_k(basis_size + rank, std::vector<NumericT>(basis_size));
+        HostMatrixType S_k(basis_size + rank, std::vector<NumericT>(block_size));
+        for (vcl_size_t i=0; i<basis_size + rank; ++i)
+        {
+          for (vcl_size_t j=0; j<basis_size; ++j)
+            H_k[i][j] = H[i][j];
+          if (i < S.size())
+            S_k[i] = S[i];
+        }
+        detail::block_krylov_least_squares(H_k, S_k, Y, estimates);
+
+        bool converged = true;
+        for (vcl_size_t j=0; j<block_size; ++j)
+        {
+          errors[active[j]] = estimates[j] / rhs_norms[active[j]];
+          if (errors[active[j]] >= tol && estimates[j] >= abs_tol)
+            converged = false;
+        }
+
+        if (converged || rank == 0) // Residuals sufficiently reduced or Krylov space invariant, stop here
+          break;
+      }
+
+      //
+      // Update solutions: X += V Y
+      //
+      BlockType vcl_Y = detail::block_krylov_from_host(Y, ctx);
+      BlockType update = viennacl::linalg::prod(viennacl::project(V, all_rows, viennacl::range(0, Y.size())), vcl_Y);
+      for (vcl_size_t j=0; j<block_size; ++j)
+        viennacl::project(X, all_rows, viennacl::range(active[j], active[j]+1)) += viennacl::project(update, all_rows, viennacl::range(j, j+1));
+
+      // Note: The residual estimates are not checked here, the residuals are recomputed at the beginning of the next restart instead.
+    }
+
+    //store last error estimate:
+    tag.error(*std::max_element(errors.begin(), errors.end()));
+
+    detail::block_krylov_copy(X, result);
+    return result;
+  }
+
 }
 
 template<typename MatrixT, typename VectorT, typename PreconditionerT>
@@ -638,6 +1129,22 @@ VectorT solve(MatrixT const & matrix, VectorT const & rhs, gmres_tag const & tag
   return detail::solve_impl(matrix, rhs, tag, precond);
 }
 
+/** @brief Block GMRES solver for multiple right hand sides, given as the columns of a dense matrix.
+*
+* Each step of the block Arnoldi process requires one sparse matrix-matrix product with all right hand sides not yet converged, thus the system matrix is only read once per step for all of them.
+*
+* @param matrix     The system matrix
+* @param rhs        The right hand sides (one per column)
+* @param tag        Solver configuration tag
+* @param precond    A preconditioner. Precondition operation is done via member function apply() for each column
+* @return The solutions (one per column)
+*/
+template<typename MatrixT, typename NumericT, typename F, unsigned int AlignmentV, typename PreconditionerT>
+viennacl::matrix<NumericT, F, AlignmentV> solve(MatrixT const & matrix, viennacl::matrix<NumericT, F, AlignmentV> const & rhs, gmres_tag const & tag, PreconditionerT const & precond)
+{
+  return detail::block_solve_impl(matrix, rhs, tag, precond);
+}
+
 /** @brief Convenience overload for calling the preconditioned BiCGStab solver using types from the C++ STL.
   *
   * A std::vector<std::map<T, U> > matrix is convenient for e.g. finite element assembly.
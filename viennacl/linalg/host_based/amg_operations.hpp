@@ -25,9 +25,14 @@
 #include <cstdlib>
 #include <cmath>
 #include "viennacl/linalg/detail/amg/amg_base.hpp"
+#include "viennacl/linalg/host_based/sparse_matrix_operations.hpp"
+#include "viennacl/linalg/host_based/spgemm_accumulator.hpp"
 
+#include <algorithm>
+#include <cassert>
 #include <map>
 #include <set>
+#include <vector>
 #include <functional>
 #ifdef VIENNACL_WITH_OPENMP
 #include <omp.h>
@@ -1369,125 +1374,155 @@ void amg_interpol(MatrixT const & A,
 }
 
 
-/** @brief Computes B = trans(A).
-  *
-  * To be replaced by native functionality in ViennaCL.
-  */
+/** @brief Computes B = trans(A) using the parallel sparse transposition of compressed_matrix. */
 template<typename NumericT>
 void amg_transpose(compressed_matrix<NumericT> const & A,
                    compressed_matrix<NumericT> & B)
 {
+  viennacl::linalg::host_based::trans(A, B);
+}
+
+/** @brief Computes the Galerkin product C = R * A * P with R = trans(P) without forming the intermediate product A * P.
+*
+* Each row of C is computed from the respective row of R * A, which is only kept in a per-thread work array.
+* The rows of C are collected per block of rows in a single pass and are copied to C after all row lengths are known.
+*
+* @param A   Operator matrix on the fine grid
+* @param P   Prolongation operator
+* @param R   Restriction operator trans(P)
+* @param C   Result matrix, the Galerkin operator on the coarse grid
+*/
+template<typename NumericT>
+void amg_galerkin_prod(compressed_matrix<NumericT> const & A,
+                       compressed_matrix<NumericT> const & P,
+                       compressed_matrix<NumericT> const & R,
+                       compressed_matrix<NumericT> & C)
+{
+  assert(A.size1() == A.size2() && bool("Operator matrix must be quadratic"));
+  assert(R.size2() == A.size1() && A.size2() == P.size1() && bool("Size mismatch in Galerkin product"));
+
   NumericT     const * A_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(A.handle());
   unsigned int const * A_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle1());
   unsigned int const * A_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle2());
 
-  // initialize datastructures for B:
-  B = compressed_matrix<NumericT>(A.size2(), A.size1(), A.nnz(), viennacl::traits::context(A));
+  NumericT     const * P_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(P.handle());
+  unsigned int const * P_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(P.handle1());
+  unsigned int const * P_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(P.handle2());
+
+  NumericT     const * R_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(R.handle());
+  unsigned int const * R_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(R.handle1());
+  unsigned int const * R_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(R.handle2());
 
-  NumericT     * B_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(B.handle());
-  unsigned int * B_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(B.handle1());
-  unsigned int * B_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(B.handle2());
+  unsigned int fine_size   = static_cast<unsigned int>(A.size2());
+  unsigned int coarse_size = static_cast<unsigned int>(P.size2());
 
 #ifdef VIENNACL_WITH_OPENMP
-  int threads = 8;
+  unsigned int max_threads = omp_get_max_threads();
 #else
-  int threads = 1;
+  unsigned int max_threads = 1;
 #endif
-  std::size_t scratchpad_size = threads * (B.size1()+1); //column-oriented matrix with 'threads' columns
-  unsigned int * scratchpad = (unsigned int *)malloc(sizeof(unsigned int) * scratchpad_size);
+  // several blocks per thread for load balancing, the rows of each block are stored contiguously:
+  long block_num  = long(4 * max_threads);
+  long block_size = long(R.size1()) / block_num + 1;
 
-  // prepare uninitialized scratchpad:
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-  for (std::size_t i = 0; i < scratchpad_size; ++i)
-    scratchpad[i] = 0;
+  std::vector<unsigned int> C_row_lengths(R.size1() + 1);
+  std::vector<std::vector<unsigned int> > C_block_col_buffers(block_num);
+  std::vector<std::vector<NumericT> >     C_block_elements(block_num);
+
+  std::vector<spgemm_accumulator<NumericT> > fine_accumulators(max_threads, spgemm_accumulator<NumericT>(fine_size));
+  std::vector<spgemm_accumulator<NumericT> > coarse_accumulators(max_threads, spgemm_accumulator<NumericT>(coarse_size));
+  std::vector<std::vector<unsigned int> > RA_col_buffers(max_threads);
+  std::vector<std::vector<NumericT> >     RA_elements(max_threads);
 
-  //
-  // Stage 1: Compute pattern for B
-  //
 #ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for num_threads(threads)
+  #pragma omp parallel for schedule(dynamic)
 #endif
-  for (std::size_t row = 0; row < A.size1(); ++row)
+  for (long block = 0; block < block_num; ++block)
   {
     unsigned int thread_id = 0;
 #ifdef VIENNACL_WITH_OPENMP
     thread_id = omp_get_thread_num();
 #endif
+    spgemm_accumulator<NumericT> & fine_accumulator   = fine_accumulators[thread_id];
+    spgemm_accumulator<NumericT> & coarse_accumulator = coarse_accumulators[thread_id];
+    std::vector<unsigned int> & RA_cols   = RA_col_buffers[thread_id];
+    std::vector<NumericT>     & RA_values = RA_elements[thread_id];
+    std::vector<unsigned int> & C_cols    = C_block_col_buffers[block];
+    std::vector<NumericT>     & C_values  = C_block_elements[block];
+
+    long row_end = std::min<long>((block + 1) * block_size, long(R.size1()));
+    for (long row = block * block_size; row < row_end; ++row)
+    {
+      // row of R * A:
+      unsigned int R_row_start = R_row_buffer[row];
+      unsigned int R_row_end   = R_row_buffer[row+1];
+      unsigned int RA_upper_bound = spgemm_row_upper_bound(R_row_start, R_row_end, R_col_buffer, A_row_buffer);
+      if (RA_cols.size() < RA_upper_bound)
+      {
+        RA_cols.resize(RA_upper_bound);
+        RA_values.resize(RA_upper_bound);
+      }
 
-    unsigned int row_start = A_row_buffer[row];
-    unsigned int row_stop  = A_row_buffer[row+1];
-
-    for (unsigned int nnz_index = row_start; nnz_index < row_stop; ++nnz_index)
-      scratchpad[thread_id * (B.size1()+1) + A_col_buffer[nnz_index]] += 1;
+      // Note: Empty rows (upper bound 0) are skipped, since the buffers may be empty. This also applies to empty matrices, for which the dense accumulator would be selected.
+      unsigned int RA_len = 0;
+      if (RA_upper_bound > 0 && vcl_size_t(RA_upper_bound) * VIENNACL_HOST_SPGEMM_DENSE_FRACTION >= vcl_size_t(fine_size))
+        RA_len = fine_accumulator.numeric_dense(R_row_start, R_row_end, R_col_buffer, R_elements,
+                                                A_row_buffer, A_col_buffer, A_elements, &(RA_cols[0]), &(RA_values[0]));
+      else if (RA_upper_bound > 0)
+        RA_len = fine_accumulator.numeric_hash(R_row_start, R_row_end, R_col_buffer, R_elements,
+                                               A_row_buffer, A_col_buffer, A_elements, RA_upper_bound, &(RA_cols[0]), &(RA_values[0]));
+
+      // row of (R * A) * P, appended to the entries of the block:
+      unsigned int C_upper_bound = spgemm_row_upper_bound(0, RA_len, RA_len > 0 ? &(RA_cols[0]) : NULL, P_row_buffer);
+      std::size_t C_offset = C_cols.size();
+      C_cols.resize(C_offset + C_upper_bound);
+      C_values.resize(C_offset + C_upper_bound);
+
+      unsigned int C_len = 0;
+      if (C_upper_bound > 0 && vcl_size_t(C_upper_bound) * VIENNACL_HOST_SPGEMM_DENSE_FRACTION >= vcl_size_t(coarse_size))
+        C_len = coarse_accumulator.numeric_dense(0, RA_len, &(RA_cols[0]), &(RA_values[0]),
+                                                 P_row_buffer, P_col_buffer, P_elements, &(C_cols[0]) + C_offset, &(C_values[0]) + C_offset);
+      else if (C_upper_bound > 0)
+        C_len = coarse_accumulator.numeric_hash(0, RA_len, &(RA_cols[0]), &(RA_values[0]),
+                                                P_row_buffer, P_col_buffer, P_elements, C_upper_bound, &(C_cols[0]) + C_offset, &(C_values[0]) + C_offset);
+
+      C_cols.resize(C_offset + C_len);
+      C_values.resize(C_offset + C_len);
+      C_row_lengths[row] = C_len;
+    }
   }
 
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-  for (std::size_t row = 0; row < B.size1(); ++row)
+  // exclusive scan to obtain row start indices:
+  unsigned int current_offset = 0;
+  for (std::size_t i = 0; i < R.size1(); ++i)
   {
-    unsigned int offset = scratchpad[row];
-    for (std::size_t i = 1; i<threads; ++i)
-    {
-      unsigned int tmp = scratchpad[i*(B.size1()+1) + row];
-      scratchpad[i*(B.size1()+1) + row] = offset;
-      offset += tmp;
-    }
-    scratchpad[row] = offset;
+    unsigned int tmp = C_row_lengths[i];
+    C_row_lengths[i] = current_offset;
+    current_offset += tmp;
   }
+  C_row_lengths[R.size1()] = current_offset;
 
-  //
-  // Stage 2: Bring row-start array in place using exclusive-scan:
-  //
-  viennacl::vector_base<unsigned int> helper_vec(scratchpad, viennacl::MAIN_MEMORY, B.size1()+1);
-  viennacl::linalg::host_based::exclusive_scan(helper_vec, helper_vec);
+  C = compressed_matrix<NumericT>(R.size1(), P.size2(), current_offset, viennacl::traits::context(A));
+  if (current_offset == 0)
+    return;
 
-  // propagate offsets and copy CSR datastructure over to B:
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-  for (std::size_t row = 0; row < B.size1(); ++row)
-  {
-    unsigned int row_offset = scratchpad[row];
-    B_row_buffer[row] = row_offset;
-    for (std::size_t i = 1; i<threads; ++i)
-      scratchpad[i*(B.size1()+1) + row] += row_offset;
-  }
-  B_row_buffer[B.size1()] = scratchpad[B.size1()];
+  NumericT     * C_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(C.handle());
+  unsigned int * C_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(C.handle1());
+  unsigned int * C_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(C.handle2());
+
+  std::copy(C_row_lengths.begin(), C_row_lengths.end(), C_row_buffer);
 
-  //
-  // Stage 3: Fill with data
-  //
 #ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for num_threads(threads)
+  #pragma omp parallel for
 #endif
-  for (std::size_t row = 0; row < A.size1(); ++row)
+  for (long block = 0; block < block_num; ++block)
   {
-    unsigned int thread_id = 0;
-#ifdef VIENNACL_WITH_OPENMP
-    thread_id = omp_get_thread_num();
-#endif
-    //std::cout << "Row " << row << ": ";
-    unsigned int row_start = A_row_buffer[row];
-    unsigned int row_stop  = A_row_buffer[row+1];
-
-    for (unsigned int nnz_index = row_start; nnz_index < row_stop; ++nnz_index)
-    {
-      unsigned int col_in_A = A_col_buffer[nnz_index];
-      unsigned int array_index = thread_id * (B.size1()+1) + col_in_A;
-      unsigned int B_nnz_index = scratchpad[array_index];
-      scratchpad[array_index] += 1;
-      B_col_buffer[B_nnz_index] = static_cast<unsigned int>(row);
-      B_elements[B_nnz_index] = A_elements[nnz_index];
-    }
+    long row_start = std::min<long>(block * block_size, long(R.size1()));
+    std::copy(C_block_col_buffers[block].begin(), C_block_col_buffers[block].end(), C_col_buffer + C_row_lengths[row_start]);
+    std::copy(C_block_elements[block].begin(),    C_block_elements[block].end(),    C_elements   + C_row_lengths[row_start]);
   }
 
-  // Step 3: Make datastructure consistent (row blocks!)
-  B.generate_row_block_information();
-
-  free(scratchpad);
+  C.generate_row_block_information();
 }
 
 /** Assign sparse matrix A to dense matrix B */
@@ -0,0 +1,229 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_BSR_SPMV_HPP_
+#define VIENNACL_LINALG_HOST_BASED_BSR_SPMV_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/bsr_spmv.hpp
+    @brief Block row kernels for matrix-vector products with the block compressed sparse row format (block_compressed_matrix) on the host.
+
+    The blocks of a block_compressed_matrix are stored column by column. Hence, a block times the corresponding part of x is a sum of block columns,
+    each scaled by one entry of x: The SIMD variants keep the partial result of (up to a SIMD width of) rows in a register and accumulate
+    one fused multiply-add per block column, with the entry of x broadcast to all lanes.
+    Block sizes which are not a multiple of the SIMD width are handled by masked loads and stores, so no scalar remainder loop is needed.
+    The block size is a compile-time constant, hence all loops over the block are unrolled by the compiler.
+*/
+
+#include "viennacl/forwards.h"
+#include "viennacl/linalg/host_based/cpu_dispatch.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+namespace detail
+{
+
+//
+// Kernels for y[0:BlockSize] = sum_k A_k * x[BlockSize * col_blocks[k] : BlockSize * (col_blocks[k] + 1)] over the num_blocks blocks A_k of a block row.
+// x must be unit-stride.
+//
+
+template<typename NumericT, unsigned int BlockSize>
+void bsr_block_row_kernel_scalar(vcl_size_t num_blocks, unsigned int const * col_blocks, NumericT const * elements,
+                                 NumericT const * x, NumericT * y)
+{
+  NumericT temp[BlockSize];
+  for (unsigned int r = 0; r < BlockSize; ++r)
+    temp[r] = 0;
+
+  for (vcl_size_t k = 0; k < num_blocks; ++k)
+  {
+    NumericT const * block   = elements + k * BlockSize * BlockSize;
+    NumericT const * x_block = x + vcl_size_t(col_blocks[k]) * BlockSize;
+    for (unsigned int c = 0; c < BlockSize; ++c)
+      for (unsigned int r = 0; r < BlockSize; ++r)
+        temp[r] += block[c * BlockSize + r] * x_block[c];
+  }
+
+  for (unsigned int r = 0; r < BlockSize; ++r)
+    y[r] = temp[r];
+}
+
+#ifdef VIENNACL_HOST_X86_SIMD
+// Mask of the lanes [0, n) of a SIMD vector for maskload/maskstore:
+VIENNACL_HOST_TARGET_AVX2
+inline __m256i bsr_lane_mask_epi64(unsigned int n)
+{
+  return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(n)), _mm256_set_epi64x(3, 2, 1, 0));
+}
+
+VIENNACL_HOST_TARGET_AVX2
+inline __m256i bsr_lane_mask_epi32(unsigned int n)
+{
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(n)), _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+template<unsigned int BlockSize>
+VIENNACL_HOST_TARGET_AVX2
+void bsr_block_row_kernel_avx2(vcl_size_t num_blocks, unsigned int const * col_blocks, double const * elements,
+                               double const * x, double * y)
+{
+  for (unsigned int r = 0; r < BlockSize; r += 4)
+  {
+    unsigned int lanes = (BlockSize - r < 4) ? BlockSize - r : 4;
+    __m256i mask = bsr_lane_mask_epi64(lanes);
+    __m256d temp = _mm256_setzero_pd();
+    for (vcl_size_t k = 0; k < num_blocks; ++k)
+    {
+      double const * block   = elements + k * BlockSize * BlockSize + r;
+      double const * x_block = x + vcl_size_t(col_blocks[k]) * BlockSize;
+      for (unsigned int c = 0; c < BlockSize; ++c)
+      {
+        __m256d column = (lanes == 4) ? _mm256_loadu_pd(block + c * BlockSize) : _mm256_maskload_pd(block + c * BlockSize, mask);
+        temp = _mm256_fmadd_pd(column, _mm256_broadcast_sd(x_block + c), temp);
+      }
+    }
+    if (lanes == 4)
+      _mm256_storeu_pd(y + r, temp);
+    else
+      _mm256_maskstore_pd(y + r, mask, temp);
+  }
+}
+
+template<unsigned int BlockSize>
+VIENNACL_HOST_TARGET_AVX2
+void bsr_block_row_kernel_avx2(vcl_size_t num_blocks, unsigned int const * col_blocks, float const * elements,
+                               float const * x, float * y)
+{
+  for (unsigned int r = 0; r < BlockSize; r += 8)
+  {
+    unsigned int lanes = (BlockSize - r < 8) ? BlockSize - r : 8;
+    __m256i mask = bsr_lane_mask_epi32(lanes);
+    __m256 temp = _mm256_setzero_ps();
+    for (vcl_size_t k = 0; k < num_blocks; ++k)
+    {
+      float const * block   = elements + k * BlockSize * BlockSize + r;
+      float const * x_block = x + vcl_size_t(col_blocks[k]) * BlockSize;
+      for (unsigned int c = 0; c < BlockSize; ++c)
+      {
+        __m256 column = (lanes == 8) ? _mm256_loadu_ps(block + c * BlockSize) : _mm256_maskload_ps(block + c * BlockSize, mask);
+        temp = _mm256_fmadd_ps(column, _mm256_broadcast_ss(x_block + c), temp);
+      }
+    }
+    if (lanes == 8)
+      _mm256_storeu_ps(y + r, temp);
+    else
+      _mm256_maskstore_ps(y + r, mask, temp);
+  }
+}
+
+template<unsigned int BlockSize>
+VIENNACL_HOST_TARGET_AVX512
+void bsr_block_row_kernel_avx512(vcl_size_t num_blocks, unsigned int const * col_blocks, double const * elements,
+                                 double const * x, double * y)
+{
+  for (unsigned int r = 0; r < BlockSize; r += 8)
+  {
+    unsigned int lanes = (BlockSize - r < 8) ? BlockSize - r : 8;
+    __mmask8 mask = static_cast<__mmask8>((1u << lanes) - 1);
+    __m512d temp = _mm512_setzero_pd();
+    for (vcl_size_t k = 0; k < num_blocks; ++k)
+    {
+      double const * block   = elements + k * BlockSize * BlockSize + r;
+      double const * x_block = x + vcl_size_t(col_blocks[k]) * BlockSize;
+      for (unsigned int c = 0; c < BlockSize; ++c)
+        temp = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, block + c * BlockSize), _mm512_set1_pd(x_block[c]), temp);
+    }
+    _mm512_mask_storeu_pd(y + r, mask, temp);
+  }
+}
+
+template<unsigned int BlockSize>
+VIENNACL_HOST_TARGET_AVX512
+void bsr_block_row_kernel_avx512(vcl_size_t num_blocks, unsigned int const * col_blocks, float const * elements,
+                                 float const * x, float * y)
+{
+  for (unsigned int r = 0; r < BlockSize; r += 16)
+  {
+    unsigned int lanes = (BlockSize - r < 16) ? BlockSize - r : 16;
+    __mmask16 mask = static_cast<__mmask16>((1u << lanes) - 1);
+    __m512 temp = _mm512_setzero_ps();
+    for (vcl_size_t k = 0; k < num_blocks; ++k)
+    {
+      float const * block   = elements + k * BlockSize * BlockSize + r;
+      float const * x_block = x + vcl_size_t(col_blocks[k]) * BlockSize;
+      for (unsigned int c = 0; c < BlockSize; ++c)
+        temp = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, block + c * BlockSize), _mm512_set1_ps(x_block[c]), temp);
+    }
+    _mm512_mask_storeu_ps(y + r, mask, temp);
+  }
+}
+#endif
+
+/** @brief Provides the block row kernel for the given value type and block size via get(). SIMD variants are available for float and double. */
+template<typename NumericT, unsigned int BlockSize>
+struct bsr_block_row_kernel
+{
+  typedef void (*type)(vcl_size_t, unsigned int const *, NumericT const *, NumericT const *, NumericT *);
+
+  static type get() { return bsr_block_row_kernel_scalar<NumericT, BlockSize>; }
+};
+
+#ifdef VIENNACL_HOST_X86_SIMD
+  #define VIENNACL_BSR_BLOCK_ROW_KERNEL_VARIANTS  .add(cpu_isa_avx2,   bsr_block_row_kernel_avx2<BlockSize>) \
+                                                  .add(cpu_isa_avx512, bsr_block_row_kernel_avx512<BlockSize>)
+#else
+  #define VIENNACL_BSR_BLOCK_ROW_KERNEL_VARIANTS
+#endif
+
+template<unsigned int BlockSize>
+struct bsr_block_row_kernel<float, BlockSize>
+{
+  typedef void (*type)(vcl_size_t, unsigned int const *, float const *, float const *, float *);
+
+  static type get()
+  {
+    static cpu_dispatcher<type> const dispatcher
+      = cpu_dispatcher<type>("bsr_spmv<float>", bsr_block_row_kernel_scalar<float, BlockSize>) VIENNACL_BSR_BLOCK_ROW_KERNEL_VARIANTS;
+    return dispatcher.get();
+  }
+};
+
+template<unsigned int BlockSize>
+struct bsr_block_row_kernel<double, BlockSize>
+{
+  typedef void (*type)(vcl_size_t, unsigned int const *, double const *, double const *, double *);
+
+  static type get()
+  {
+    static cpu_dispatcher<type> const dispatcher
+      = cpu_dispatcher<type>("bsr_spmv<double>", bsr_block_row_kernel_scalar<double, BlockSize>) VIENNACL_BSR_BLOCK_ROW_KERNEL_VARIANTS;
+    return dispatcher.get();
+  }
+};
+
+#undef VIENNACL_BSR_BLOCK_ROW_KERNEL_VARIANTS
+
+} // namespace detail
+} // namespace host_based
+} // namespace linalg
+} // namespace viennacl
+
+#endif
@@ -0,0 +1,320 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_CPU_DISPATCH_HPP_
+#define VIENNACL_LINALG_HOST_BASED_CPU_DISPATCH_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/cpu_dispatch.hpp
+    @brief Runtime selection of instruction-set specific variants of host kernels.
+
+    Kernels register one variant per instruction set extension (scalar, SSE4.2, AVX2, AVX-512, NEON).
+    On first use the best variant supported by the CPU the program runs on is selected, so a single binary runs on older CPUs
+    and still makes use of wide vector units on newer ones. SIMD variants are compiled via function-level target attributes,
+    no global compiler flags (-mavx2, etc.) are required.
+
+    The selection can be capped via set_max_cpu_isa() or the environment variable VIENNACL_HOST_MAX_ISA (values: scalar, sse4.2, avx2, avx512, neon).
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+#include "viennacl/forwards.h"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+// SIMD variants on x86 are compiled via __attribute__((target(...))), which requires GCC 4.9+ or Clang:
+#if !defined(VIENNACL_HOST_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+  #define VIENNACL_HOST_X86_SIMD
+  #include <immintrin.h>
+  #define VIENNACL_HOST_TARGET_SSE42   __attribute__((target("sse4.2")))
+  #define VIENNACL_HOST_TARGET_AVX2    __attribute__((target("avx2,fma")))
+  #define VIENNACL_HOST_TARGET_AVX512  __attribute__((target("avx512f")))
+#endif
+
+// NEON is part of the base instruction set on AArch64:
+#if !defined(VIENNACL_HOST_NO_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)
+  #define VIENNACL_HOST_NEON
+  #include <arm_neon.h>
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+
+/** @brief Instruction set extensions for which host kernels may provide specialized variants. Higher values are preferred if available. */
+enum cpu_isa
+{
+  cpu_isa_scalar = 0,
+  cpu_isa_sse42,
+  cpu_isa_neon,
+  cpu_isa_avx2,     // AVX2 together with FMA3
+  cpu_isa_avx512,   // AVX-512 Foundation
+  cpu_isa_count
+};
+
+/** @brief Returns a human-readable name of the instruction set extension */
+inline const char * cpu_isa_name(cpu_isa isa)
+{
+  switch (isa)
+  {
+  case cpu_isa_scalar: return "scalar";
+  case cpu_isa_sse42:  return "sse4.2";
+  case cpu_isa_neon:   return "neon";
+  case cpu_isa_avx2:   return "avx2";
+  case cpu_isa_avx512: return "avx512";
+  default: break;
+  }
+  return "unknown";
+}
+
+namespace detail
+{
+  /** @brief Queries the CPU (and operating system support for the respective register state) */
+  inline bool cpu_supports_impl(cpu_isa isa)
+  {
+    switch (isa)
+    {
+    case cpu_isa_scalar: return true;
+#ifdef VIENNACL_HOST_X86_SIMD
+    case cpu_isa_sse42:  __builtin_cpu_init(); return __builtin_cpu_supports("sse4.2") != 0;
+    case cpu_isa_avx2:   __builtin_cpu_init(); return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case cpu_isa_avx512: __builtin_cpu_init(); return __builtin_cpu_supports("avx512f") != 0;
+#endif
+#ifdef VIENNACL_HOST_NEON
+    case cpu_isa_neon:   return true;
+#endif
+    default: break;
+    }
+    return false;
+  }
+
+  /** @brief Parses the value of VIENNACL_HOST_MAX_ISA. Returns cpu_isa_count if not set or not recognized. */
+  inline cpu_isa cpu_isa_from_environment()
+  {
+    const char * env = std::getenv("VIENNACL_HOST_MAX_ISA");
+    if (env)
+    {
+      for (int i = 0; i < cpu_isa_count; ++i)
+        if (std::strcmp(env, cpu_isa_name(cpu_isa(i))) == 0)
+          return cpu_isa(i);
+    }
+    return cpu_isa_count;
+  }
+
+  /** @brief Global dispatch state: Upper limit on the instruction set and a counter which invalidates cached selections whenever the limit changes.
+  *
+  * 'max_isa' and 'generation' are only modified within the critical section 'viennacl_cpu_dispatch' and read atomically outside of it. 'selected' is only accessed within the critical section.
+  */
+  struct cpu_dispatch_state
+  {
+    cpu_dispatch_state() : max_isa(cpu_isa_from_environment()), generation(1) {}
+
+    int           max_isa;
+    unsigned int  generation;
+    std::map<std::string, cpu_isa> selected;  // kernel name -> selected variant
+  };
+
+  inline cpu_dispatch_state & get_cpu_dispatch_state()
+  {
+    static cpu_dispatch_state state;
+    return state;
+  }
+
+  inline int cpu_dispatch_max_isa()
+  {
+    int result;
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp atomic read
+#endif
+    result = get_cpu_dispatch_state().max_isa;
+    return result;
+  }
+
+  inline unsigned int cpu_dispatch_generation()
+  {
+    unsigned int result;
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp atomic read
+#endif
+    result = get_cpu_dispatch_state().generation;
+    return result;
+  }
+}
+
+/** @brief Returns true if the CPU the program is running on supports the provided instruction set extension. Honors the limit set via set_max_cpu_isa(). */
+inline bool cpu_supports(cpu_isa isa)
+{
+  static bool supported[cpu_isa_count] = { detail::cpu_supports_impl(cpu_isa_scalar),
+                                           detail::cpu_supports_impl(cpu_isa_sse42),
+                                           detail::cpu_supports_impl(cpu_isa_neon),
+                                           detail::cpu_supports_impl(cpu_isa_avx2),
+                                           detail::cpu_supports_impl(cpu_isa_avx512) };
+  if (isa >= cpu_isa_count || isa > detail::cpu_dispatch_max_isa())
+    return false;
+  return supported[isa];
+}
+
+/** @brief Returns the most capable instruction set extension available */
+inline cpu_isa detected_cpu_isa()
+{
+  for (int i = cpu_isa_count - 1; i > 0; --i)
+    if (cpu_supports(cpu_isa(i)))
+      return cpu_isa(i);
+  return cpu_isa_scalar;
+}
+
+/** @brief Limits the kernel variants to the provided instruction set extension (e.g. for benchmarking or working around problems). Pass cpu_isa_count to remove the limit. */
+inline void set_max_cpu_isa(cpu_isa isa)
+{
+  detail::cpu_dispatch_state & state = detail::get_cpu_dispatch_state();
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp critical(viennacl_cpu_dispatch)
+#endif
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp atomic write
+#endif
+    state.max_isa = isa;
+    state.selected.clear();
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp atomic update
+#endif
+    ++state.generation;
+  }
+}
+
+/** @brief Returns the instruction set extension selected for each dispatched kernel used so far. Keys are the kernel names, e.g. 'gemm<double>' */
+inline std::map<std::string, cpu_isa> dispatched_kernel_isas()
+{
+  std::map<std::string, cpu_isa> result;
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp critical(viennacl_cpu_dispatch)
+#endif
+  result = detail::get_cpu_dispatch_state().selected;
+  return result;
+}
+
+/** @brief Returns the name of the instruction set extension selected for the kernel with the given name, or an empty string if the kernel has not been used yet. */
+inline std::string dispatched_kernel_isa(std::string const & kernel_name)
+{
+  std::map<std::string, cpu_isa> isas = dispatched_kernel_isas();
+  std::map<std::string, cpu_isa>::const_iterator it = isas.find(kernel_name);
+  return (it != isas.end()) ? std::string(cpu_isa_name(it->second)) : std::string();
+}
+
+
+/** @brief Holds the variants of a kernel for the different instruction set extensions and selects the best one available at runtime.
+*
+* The variant type is typically a function pointer, but may also be a struct carrying additional information such as the register blocking.
+* Usage:
+*
+*   static cpu_dispatcher<FunctionT> const dispatcher = cpu_dispatcher<FunctionT>("name", scalar_variant).add(cpu_isa_avx2, avx2_variant);
+*   dispatcher.get()(...);
+*/
+template<typename VariantT>
+class cpu_dispatcher
+{
+public:
+  cpu_dispatcher(const char * name, VariantT const & scalar_variant) : name_(name), selection_(0)
+  {
+    for (int i = 0; i < cpu_isa_count; ++i)
+      available_[i] = false;
+    variants_[cpu_isa_scalar] = scalar_variant;
+    available_[cpu_isa_scalar] = true;
+  }
+
+  /** @brief Registers a variant for the given instruction set extension. Returns *this for chaining. */
+  cpu_dispatcher & add(cpu_isa isa, VariantT const & variant)
+  {
+    variants_[isa] = variant;
+    available_[isa] = true;
+    selection_ = 0;
+    return *this;
+  }
+
+  /** @brief Returns the best variant for the CPU the program is running on. May be called concurrently from multiple threads. */
+  VariantT get() const
+  {
+    return variants_[selected_isa()];
+  }
+
+  /** @brief Returns the instruction set extension of the variant returned by get() */
+  cpu_isa isa() const
+  {
+    return selected_isa();
+  }
+
+  const char * name() const { return name_; }
+
+private:
+  /** @brief Returns the cached selection if it is still valid for the current limit on the instruction set, otherwise selects anew */
+  cpu_isa selected_isa() const
+  {
+    unsigned int selection;
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp atomic read
+#endif
+    selection = selection_;
+
+    if (selection / cpu_isa_count != detail::cpu_dispatch_generation())
+      selection = select();
+    return cpu_isa(selection % cpu_isa_count);
+  }
+
+  unsigned int select() const
+  {
+    unsigned int selection = 0;
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp critical(viennacl_cpu_dispatch)
+#endif
+    {
+      detail::cpu_dispatch_state & state = detail::get_cpu_dispatch_state();
+      int isa = cpu_isa_count - 1;
+      while (isa > 0 && !(available_[isa] && cpu_supports(cpu_isa(isa))))
+        --isa;
+      state.selected[name_] = cpu_isa(isa);
+      selection = state.generation * cpu_isa_count + static_cast<unsigned int>(isa);
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp atomic write
+#endif
+      selection_ = selection;
+    }
+    return selection;
+  }
+
+  const char * name_;
+  VariantT     variants_[cpu_isa_count];
+  bool         available_[cpu_isa_count];
+
+  // generation of the dispatch state times cpu_isa_count plus the selected instruction set, so that both are read and written in one atomic operation:
+  mutable unsigned int selection_;
+};
+
+} //namespace host_based
+} //namespace linalg
+} //namespace viennacl
+
+
+#endif
@@ -0,0 +1,550 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_GEMM_PACKED_HPP_
+#define VIENNACL_LINALG_HOST_BASED_GEMM_PACKED_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/gemm_packed.hpp
+    @brief Packed, register-blocked dense matrix-matrix multiplication (GEMM) for the host backend.
+
+    The implementation follows the GotoBLAS/BLIS layering: The operands are split into cache-sized blocks (MC x KC for A, KC x NC for B),
+    which are packed into contiguous, aligned panels. A small register-blocked micro-kernel then computes MR x NR tiles of the result.
+    The micro-kernel is selected at runtime based on the instruction set extensions supported by the CPU (see cpu_dispatch.hpp).
+*/
+
+#include <vector>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/linalg/host_based/cpu_dispatch.hpp"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+// Minimum Matrix size(size1*size2) for using OpenMP on matrix operations:
+#ifndef VIENNACL_OPENMP_MATRIX_MIN_SIZE
+  #define VIENNACL_OPENMP_MATRIX_MIN_SIZE  5000
+#endif
+
+// Number of rows of A packed per block (should keep an MC x KC block of A in L2 cache):
+#ifndef VIENNACL_HOST_GEMM_MC
+  #define VIENNACL_HOST_GEMM_MC  144
+#endif
+
+// Number of columns of A (rows of B) packed per block (should keep a KC x NR panel of B in L1 cache):
+#ifndef VIENNACL_HOST_GEMM_KC
+  #define VIENNACL_HOST_GEMM_KC  256
+#endif
+
+// Number of columns of B packed per block (should keep a KC x NC block of B in L3 cache):
+#ifndef VIENNACL_HOST_GEMM_NC
+  #define VIENNACL_HOST_GEMM_NC  4096
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+namespace detail
+{
+
+/** @brief Scratch buffer with its first element aligned to a 64-byte boundary (cache line and AVX-512 register width). */
+template<typename NumericT>
+class gemm_aligned_buffer
+{
+  static const vcl_size_t alignment = 64;
+
+public:
+  gemm_aligned_buffer() : ptr_(NULL) {}
+
+  explicit gemm_aligned_buffer(vcl_size_t num_elements) : ptr_(NULL) { resize(num_elements); }
+
+  void resize(vcl_size_t num_elements)
+  {
+    storage_.resize(num_elements * sizeof(NumericT) + alignment);
+    char * raw_ptr = &(storage_[0]);
+    vcl_size_t misalignment = reinterpret_cast<vcl_size_t>(raw_ptr) % alignment;
+    ptr_ = reinterpret_cast<NumericT *>(raw_ptr + (misalignment > 0 ? alignment - misalignment : 0));
+  }
+
+  NumericT       * get()       { return ptr_; }
+  NumericT const * get() const { return ptr_; }
+
+private:
+  std::vector<char> storage_;
+  NumericT * ptr_;
+};
+
+
+//
+// Micro-kernels: Compute the MR x NR tile AB = sum_k a(:,k) * b(k,:) from packed panels.
+// Panel 'a' holds MR consecutive entries for each k, panel 'b' holds NR consecutive entries for each k.
+// The result tile is written to 'ab' in row-major layout (leading dimension NR).
+//
+
+/** @brief Portable micro-kernel. Relies on the compiler to vectorize the innermost loop over the NR columns. */
+template<typename NumericT, unsigned int MR, unsigned int NR>
+void gemm_micro_kernel_generic(vcl_size_t kc, NumericT const * a, NumericT const * b, NumericT * ab)
+{
+  NumericT acc[MR * NR];
+  for (unsigned int i = 0; i < MR * NR; ++i)
+    acc[i] = NumericT(0);
+
+  for (vcl_size_t k = 0; k < kc; ++k)
+  {
+    for (unsigned int i = 0; i < MR; ++i)
+    {
+      NumericT a_ik = a[i];
+      for (unsigned int j = 0; j < NR; ++j)
+        acc[i * NR + j] += a_ik * b[j];
+    }
+    a += MR;
+    b += NR;
+  }
+
+  for (unsigned int i = 0; i < MR * NR; ++i)
+    ab[i] = acc[i];
+}
+
+#ifdef VIENNACL_HOST_X86_SIMD
+
+/** @brief AVX2/FMA micro-kernel for double precision, 6 x 8 tile (12 accumulator registers). */
+VIENNACL_HOST_TARGET_AVX2
+inline void gemm_micro_kernel_avx2(vcl_size_t kc, double const * a, double const * b, double * ab)
+{
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+  __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+  for (vcl_size_t k = 0; k < kc; ++k)
+  {
+    __m256d b0 = _mm256_loadu_pd(b);
+    __m256d b1 = _mm256_loadu_pd(b + 4);
+    __m256d ai;
+
+    ai = _mm256_broadcast_sd(a + 0); c00 = _mm256_fmadd_pd(ai, b0, c00); c01 = _mm256_fmadd_pd(ai, b1, c01);
+    ai = _mm256_broadcast_sd(a + 1); c10 = _mm256_fmadd_pd(ai, b0, c10); c11 = _mm256_fmadd_pd(ai, b1, c11);
+    ai = _mm256_broadcast_sd(a + 2); c20 = _mm256_fmadd_pd(ai, b0, c20); c21 = _mm256_fmadd_pd(ai, b1, c21);
+    ai = _mm256_broadcast_sd(a + 3); c30 = _mm256_fmadd_pd(ai, b0, c30); c31 = _mm256_fmadd_pd(ai, b1, c31);
+    ai = _mm256_broadcast_sd(a + 4); c40 = _mm256_fmadd_pd(ai, b0, c40); c41 = _mm256_fmadd_pd(ai, b1, c41);
+    ai = _mm256_broadcast_sd(a + 5); c50 = _mm256_fmadd_pd(ai, b0, c50); c51 = _mm256_fmadd_pd(ai, b1, c51);
+
+    a += 6;
+    b += 8;
+  }
+
+  _mm256_storeu_pd(ab +  0, c00); _mm256_storeu_pd(ab +  4, c01);
+  _mm256_storeu_pd(ab +  8, c10); _mm256_storeu_pd(ab + 12, c11);
+  _mm256_storeu_pd(ab + 16, c20); _mm256_storeu_pd(ab + 20, c21);
+  _mm256_storeu_pd(ab + 24, c30); _mm256_storeu_pd(ab + 28, c31);
+  _mm256_storeu_pd(ab + 32, c40); _mm256_storeu_pd(ab + 36, c41);
+  _mm256_storeu_pd(ab + 40, c50); _mm256_storeu_pd(ab + 44, c51);
+}
+
+/** @brief AVX2/FMA micro-kernel for single precision, 6 x 16 tile (12 accumulator registers). */
+VIENNACL_HOST_TARGET_AVX2
+inline void gemm_micro_kernel_avx2(vcl_size_t kc, float const * a, float const * b, float * ab)
+{
+  __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+  __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+  __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+  __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+  __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+  __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+  for (vcl_size_t k = 0; k < kc; ++k)
+  {
+    __m256 b0 = _mm256_loadu_ps(b);
+    __m256 b1 = _mm256_loadu_ps(b + 8);
+    __m256 ai;
+
+    ai = _mm256_broadcast_ss(a + 0); c00 = _mm256_fmadd_ps(ai, b0, c00); c01 = _mm256_fmadd_ps(ai, b1, c01);
+    ai = _mm256_broadcast_ss(a + 1); c10 = _mm256_fmadd_ps(ai, b0, c10); c11 = _mm256_fmadd_ps(ai, b1, c11);
+    ai = _mm256_broadcast_ss(a + 2); c20 = _mm256_fmadd_ps(ai, b0, c20); c21 = _mm256_fmadd_ps(ai, b1, c21);
+    ai = _mm256_broadcast_ss(a + 3); c30 = _mm256_fmadd_ps(ai, b0, c30); c31 = _mm256_fmadd_ps(ai, b1, c31);
+    ai = _mm256_broadcast_ss(a + 4); c40 = _mm256_fmadd_ps(ai, b0, c40); c41 = _mm256_fmadd_ps(ai, b1, c41);
+    ai = _mm256_broadcast_ss(a + 5); c50 = _mm256_fmadd_ps(ai, b0, c50); c51 = _mm256_fmadd_ps(ai, b1, c51);
+
+    a += 6;
+    b += 16;
+  }
+
+  _mm256_storeu_ps(ab +  0, c00); _mm256_storeu_ps(ab +  8, c01);
+  _mm256_storeu_ps(ab + 16, c10); _mm256_storeu_ps(ab + 24, c11);
+  _mm256_storeu_ps(ab + 32, c20); _mm256_storeu_ps(ab + 40, c21);
+  _mm256_storeu_ps(ab + 48, c30); _mm256_storeu_ps(ab + 56, c31);
+  _mm256_storeu_ps(ab + 64, c40); _mm256_storeu_ps(ab + 72, c41);
+  _mm256_storeu_ps(ab + 80, c50); _mm256_storeu_ps(ab + 88, c51);
+}
+
+/** @brief AVX-512 micro-kernel for double precision, 6 x 16 tile (12 accumulator registers). */
+VIENNACL_HOST_TARGET_AVX512
+inline void gemm_micro_kernel_avx512(vcl_size_t kc, double const * a, double const * b, double * ab)
+{
+  __m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd();
+  __m512d c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd();
+  __m512d c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd();
+  __m512d c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd();
+  __m512d c40 = _mm512_setzero_pd(), c41 = _mm512_setzero_pd();
+  __m512d c50 = _mm512_setzero_pd(), c51 = _mm512_setzero_pd();
+
+  for (vcl_size_t k = 0; k < kc; ++k)
+  {
+    __m512d b0 = _mm512_loadu_pd(b);
+    __m512d b1 = _mm512_loadu_pd(b + 8);
+    __m512d ai;
+
+    ai = _mm512_set1_pd(a[0]); c00 = _mm512_fmadd_pd(ai, b0, c00); c01 = _mm512_fmadd_pd(ai, b1, c01);
+    ai = _mm512_set1_pd(a[1]); c10 = _mm512_fmadd_pd(ai, b0, c10); c11 = _mm512_fmadd_pd(ai, b1, c11);
+    ai = _mm512_set1_pd(a[2]); c20 = _mm512_fmadd_pd(ai, b0, c20); c21 = _mm512_fmadd_pd(ai, b1, c21);
+    ai = _mm512_set1_pd(a[3]); c30 = _mm512_fmadd_pd(ai, b0, c30); c31 = _mm512_fmadd_pd(ai, b1, c31);
+    ai = _mm512_set1_pd(a[4]); c40 = _mm512_fmadd_pd(ai, b0, c40); c41 = _mm512_fmadd_pd(ai, b1, c41);
+    ai = _mm512_set1_pd(a[5]); c50 = _mm512_fmadd_pd(ai, b0, c50); c51 = _mm512_fmadd_pd(ai, b1, c51);
+
+    a += 6;
+    b += 16;
+  }
+
+  _mm512_storeu_pd(ab +  0, c00); _mm512_storeu_pd(ab +  8, c01);
+  _mm512_storeu_pd(ab + 16, c10); _mm512_storeu_pd(ab + 24, c11);
+  _mm512_storeu_pd(ab + 32, c20); _mm512_storeu_pd(ab + 40, c21);
+  _mm512_storeu_pd(ab + 48, c30); _mm512_storeu_pd(ab + 56, c31);
+  _mm512_storeu_pd(ab + 64, c40); _mm512_storeu_pd(ab + 72, c41);
+  _mm512_storeu_pd(ab + 80, c50); _mm512_storeu_pd(ab + 88, c51);
+}
+
+/** @brief AVX-512 micro-kernel for single precision, 6 x 32 tile (12 accumulator registers). */
+VIENNACL_HOST_TARGET_AVX512
+inline void gemm_micro_kernel_avx512(vcl_size_t kc, float const * a, float const * b, float * ab)
+{
+  __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+  __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+  __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+  __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+  __m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+  __m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+
+  for (vcl_size_t k = 0; k < kc; ++k)
+  {
+    __m512 b0 = _mm512_loadu_ps(b);
+    __m512 b1 = _mm512_loadu_ps(b + 16);
+    __m512 ai;
+
+    ai = _mm512_set1_ps(a[0]); c00 = _mm512_fmadd_ps(ai, b0, c00); c01 = _mm512_fmadd_ps(ai, b1, c01);
+    ai = _mm512_set1_ps(a[1]); c10 = _mm512_fmadd_ps(ai, b0, c10); c11 = _mm512_fmadd_ps(ai, b1, c11);
+    ai = _mm512_set1_ps(a[2]); c20 = _mm512_fmadd_ps(ai, b0, c20); c21 = _mm512_fmadd_ps(ai, b1, c21);
+    ai = _mm512_set1_ps(a[3]); c30 = _mm512_fmadd_ps(ai, b0, c30); c31 = _mm512_fmadd_ps(ai, b1, c31);
+    ai = _mm512_set1_ps(a[4]); c40 = _mm512_fmadd_ps(ai, b0, c40); c41 = _mm512_fmadd_ps(ai, b1, c41);
+    ai = _mm512_set1_ps(a[5]); c50 = _mm512_fmadd_ps(ai, b0, c50); c51 = _mm512_fmadd_ps(ai, b1, c51);
+
+    a += 6;
+    b += 32;
+  }
+
+  _mm512_storeu_ps(ab +   0, c00); _mm512_storeu_ps(ab +  16, c01);
+  _mm512_storeu_ps(ab +  32, c10); _mm512_storeu_ps(ab +  48, c11);
+  _mm512_storeu_ps(ab +  64, c20); _mm512_storeu_ps(ab +  80, c21);
+  _mm512_storeu_ps(ab +  96, c30); _mm512_storeu_ps(ab + 112, c31);
+  _mm512_storeu_ps(ab + 128, c40); _mm512_storeu_ps(ab + 144, c41);
+  _mm512_storeu_ps(ab + 160, c50); _mm512_storeu_ps(ab + 176, c51);
+}
+
+#endif // VIENNACL_HOST_X86_SIMD
+
+#ifdef VIENNACL_HOST_NEON
+
+/** @brief NEON micro-kernel for double precision, 8 x 4 tile (16 accumulator registers). */
+inline void gemm_micro_kernel_neon(vcl_size_t kc, double const * a, double const * b, double * ab)
+{
+  float64x2_t c[8][2];
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    c[i][0] = vdupq_n_f64(0.0);
+    c[i][1] = vdupq_n_f64(0.0);
+  }
+
+  for (vcl_size_t k = 0; k < kc; ++k)
+  {
+    float64x2_t b0 = vld1q_f64(b);
+    float64x2_t b1 = vld1q_f64(b + 2);
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+      c[i][0] = vfmaq_n_f64(c[i][0], b0, a[i]);
+      c[i][1] = vfmaq_n_f64(c[i][1], b1, a[i]);
+    }
+    a += 8;
+    b += 4;
+  }
+
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    vst1q_f64(ab + 4 * i,     c[i][0]);
+    vst1q_f64(ab + 4 * i + 2, c[i][1]);
+  }
+}
+
+/** @brief NEON micro-kernel for single precision, 8 x 8 tile (16 accumulator registers). */
+inline void gemm_micro_kernel_neon(vcl_size_t kc, float const * a, float const * b, float * ab)
+{
+  float32x4_t c[8][2];
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    c[i][0] = vdupq_n_f32(0.0f);
+    c[i][1] = vdupq_n_f32(0.0f);
+  }
+
+  for (vcl_size_t k = 0; k < kc; ++k)
+  {
+    float32x4_t b0 = vld1q_f32(b);
+    float32x4_t b1 = vld1q_f32(b + 4);
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+      c[i][0] = vfmaq_n_f32(c[i][0], b0, a[i]);
+      c[i][1] = vfmaq_n_f32(c[i][1], b1, a[i]);
+    }
+    a += 8;
+    b += 8;
+  }
+
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    vst1q_f32(ab + 8 * i,     c[i][0]);
+    vst1q_f32(ab + 8 * i + 4, c[i][1]);
+  }
+}
+
+#endif // VIENNACL_HOST_NEON
+
+
+/** @brief Largest tile (MR * NR) produced by any of the micro-kernels above. */
+static const vcl_size_t gemm_max_tile_size = 6 * 32;
+
+/** @brief Describes a micro-kernel together with its register blocking. */
+template<typename NumericT>
+struct gemm_micro_kernel
+{
+  typedef void (*kernel_type)(vcl_size_t, NumericT const *, NumericT const *, NumericT *);
+
+  gemm_micro_kernel() : kernel(NULL), mr(0), nr(0) {}
+  gemm_micro_kernel(kernel_type k, vcl_size_t m, vcl_size_t n) : kernel(k), mr(m), nr(n) {}
+
+  kernel_type kernel;
+  vcl_size_t  mr;
+  vcl_size_t  nr;
+};
+
+/** @brief Returns the micro-kernel for generic numeric types (integers, etc.). */
+template<typename NumericT>
+gemm_micro_kernel<NumericT> get_gemm_micro_kernel()
+{
+  return gemm_micro_kernel<NumericT>(gemm_micro_kernel_generic<NumericT, 4, 4>, 4, 4);
+}
+
+/** \cond */
+template<>
+inline gemm_micro_kernel<float> get_gemm_micro_kernel<float>()
+{
+  static cpu_dispatcher<gemm_micro_kernel<float> > const dispatcher
+    = cpu_dispatcher<gemm_micro_kernel<float> >("gemm<float>", gemm_micro_kernel<float>(gemm_micro_kernel_generic<float, 4, 8>, 4, 8))
+#ifdef VIENNACL_HOST_X86_SIMD
+        .add(cpu_isa_avx2,   gemm_micro_kernel<float>(gemm_micro_kernel_avx2,   6, 16))
+        .add(cpu_isa_avx512, gemm_micro_kernel<float>(gemm_micro_kernel_avx512, 6, 32))
+#endif
+#ifdef VIENNACL_HOST_NEON
+        .add(cpu_isa_neon,   gemm_micro_kernel<float>(gemm_micro_kernel_neon,   8, 8))
+#endif
+        ;
+  return dispatcher.get();
+}
+
+template<>
+inline gemm_micro_kernel<double> get_gemm_micro_kernel<double>()
+{
+  static cpu_dispatcher<gemm_micro_kernel<double> > const dispatcher
+    = cpu_dispatcher<gemm_micro_kernel<double> >("gemm<double>", gemm_micro_kernel<double>(gemm_micro_kernel_generic<double, 4, 4>, 4, 4))
+#ifdef VIENNACL_HOST_X86_SIMD
+        .add(cpu_isa_avx2,   gemm_micro_kernel<double>(gemm_micro_kernel_avx2,   6, 8))
+        .add(cpu_isa_avx512, gemm_micro_kernel<double>(gemm_micro_kernel_avx512, 6, 16))
+#endif
+#ifdef VIENNACL_HOST_NEON
+        .add(cpu_isa_neon,   gemm_micro_kernel<double>(gemm_micro_kernel_neon,   8, 4))
+#endif
+        ;
+  return dispatcher.get();
+}
+/** \endcond */
+
+
+/** @brief Packs the block A(row_start:row_start+mc, col_start:col_start+kc) into consecutive MR x kc row panels. Rows beyond mc are padded with zeros. */
+template<typename MatrixAccT, typename NumericT>
+void gemm_pack_A(MatrixAccT & A, vcl_size_t row_start, vcl_size_t col_start, vcl_size_t mc, vcl_size_t kc, vcl_size_t mr, NumericT * buffer)
+{
+  for (vcl_size_t panel_start = 0; panel_start < mc; panel_start += mr)
+  {
+    vcl_size_t rows = std::min(mr, mc - panel_start);
+    for (vcl_size_t k = 0; k < kc; ++k)
+    {
+      for (vcl_size_t i = 0; i < rows; ++i)
+        buffer[i] = A(row_start + panel_start + i, col_start + k);
+      for (vcl_size_t i = rows; i < mr; ++i)
+        buffer[i] = NumericT(0);
+      buffer += mr;
+    }
+  }
+}
+
+/** @brief Packs the NR-wide column panel B(row_start:row_start+kc, col_start:col_start+nr) into consecutive rows of length nr. Columns beyond 'cols' are padded with zeros. */
+template<typename MatrixAccT, typename NumericT>
+void gemm_pack_B_panel(MatrixAccT & B, vcl_size_t row_start, vcl_size_t col_start, vcl_size_t kc, vcl_size_t cols, vcl_size_t nr, NumericT * buffer)
+{
+  for (vcl_size_t k = 0; k < kc; ++k)
+  {
+    for (vcl_size_t j = 0; j < cols; ++j)
+      buffer[j] = B(row_start + k, col_start + j);
+    for (vcl_size_t j = cols; j < nr; ++j)
+      buffer[j] = NumericT(0);
+    buffer += nr;
+  }
+}
+
+
+/** @brief Computes C = alpha * A * B + beta * C using packed panels and a register-blocked micro-kernel.
+*
+* The accessors A, B, C provide element access via operator()(i, j) and hide layout, strides, offsets and transposition.
+*
+* @param A        Accessor for the C_size1 x A_size2 matrix A
+* @param B        Accessor for the A_size2 x C_size2 matrix B
+* @param C        Accessor for the C_size1 x C_size2 result matrix C
+*/
+template<typename MatrixAccT1, typename MatrixAccT2, typename MatrixAccT3, typename NumericT>
+void packed_gemm(MatrixAccT1 & A, MatrixAccT2 & B, MatrixAccT3 & C,
+                 vcl_size_t C_size1, vcl_size_t C_size2, vcl_size_t A_size2,
+                 NumericT alpha, NumericT beta)
+{
+  gemm_micro_kernel<NumericT> micro_kernel = get_gemm_micro_kernel<NumericT>();
+  vcl_size_t mr = micro_kernel.mr;
+  vcl_size_t nr = micro_kernel.nr;
+
+  vcl_size_t thread_count = 1;
+#ifdef VIENNACL_WITH_OPENMP
+  bool use_openmp = (C_size1 * C_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE;
+  if (use_openmp)
+    thread_count = static_cast<vcl_size_t>(omp_get_max_threads());
+#endif
+
+  // cache blocking (rounded to multiples of the register blocking). Reduce MC if otherwise not all threads get a block of A:
+  vcl_size_t kc_max = std::min<vcl_size_t>(VIENNACL_HOST_GEMM_KC, A_size2);
+  vcl_size_t nc_max = std::max<vcl_size_t>(VIENNACL_HOST_GEMM_NC / nr, 1) * nr;
+  vcl_size_t mc_max = std::max<vcl_size_t>(VIENNACL_HOST_GEMM_MC / mr, 1) * mr;
+  vcl_size_t rows_per_thread = (C_size1 - 1) / thread_count + 1;
+  mc_max = std::min(mc_max, ((rows_per_thread - 1) / mr + 1) * mr);
+  nc_max = std::min(nc_max, ((C_size2 - 1) / nr + 1) * nr);
+
+  // B is packed once per (jc, pc) block and shared among all threads:
+  gemm_aligned_buffer<NumericT> buffer_B(kc_max * nc_max);
+  NumericT * packed_B = buffer_B.get();
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel if (use_openmp)
+#endif
+  {
+    // thread-local buffers, allocated once per call (and touched first by the thread using them):
+    gemm_aligned_buffer<NumericT> buffer_A(mc_max * kc_max);
+    NumericT * packed_A = buffer_A.get();
+    NumericT ab[gemm_max_tile_size];
+
+    for (vcl_size_t jc = 0; jc < C_size2; jc += nc_max)
+    {
+      vcl_size_t nc = std::min(nc_max, C_size2 - jc);
+      long num_panels_B = static_cast<long>((nc - 1) / nr + 1);
+
+      for (vcl_size_t pc = 0; pc < A_size2; pc += kc_max)
+      {
+        vcl_size_t kc = std::min(kc_max, A_size2 - pc);
+        bool first_k_block = (pc == 0);
+
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp for
+#endif
+        for (long panel = 0; panel < num_panels_B; ++panel)
+        {
+          vcl_size_t col_offset = static_cast<vcl_size_t>(panel) * nr;
+          gemm_pack_B_panel(B, pc, jc + col_offset, kc, std::min(nr, nc - col_offset), nr, packed_B + col_offset * kc);
+        }
+        // implicit barrier: B is fully packed
+
+        long num_blocks_A = static_cast<long>((C_size1 - 1) / mc_max + 1);
+#ifdef VIENNACL_WITH_OPENMP
+        #pragma omp for
+#endif
+        for (long block_i = 0; block_i < num_blocks_A; ++block_i)
+        {
+          vcl_size_t ic = static_cast<vcl_size_t>(block_i) * mc_max;
+          vcl_size_t mc = std::min(mc_max, C_size1 - ic);
+
+          gemm_pack_A(A, ic, pc, mc, kc, mr, packed_A);
+
+          // macro-kernel: run over all MR x NR tiles of the current mc x nc block of C
+          for (vcl_size_t jr = 0; jr < nc; jr += nr)
+          {
+            vcl_size_t n_tile = std::min(nr, nc - jr);
+            for (vcl_size_t ir = 0; ir < mc; ir += mr)
+            {
+              vcl_size_t m_tile = std::min(mr, mc - ir);
+
+              micro_kernel.kernel(kc, packed_A + ir * kc, packed_B + jr * kc, ab);
+
+              // write result:
+              if (!first_k_block)
+              {
+                for (vcl_size_t i = 0; i < m_tile; ++i)
+                  for (vcl_size_t j = 0; j < n_tile; ++j)
+                    C(ic + ir + i, jc + jr + j) += alpha * ab[i * nr + j];
+              }
+              else if (beta > 0 || beta < 0)
+              {
+                for (vcl_size_t i = 0; i < m_tile; ++i)
+                  for (vcl_size_t j = 0; j < n_tile; ++j)
+                    C(ic + ir + i, jc + jr + j) = beta * C(ic + ir + i, jc + jr + j) + alpha * ab[i * nr + j];
+              }
+              else
+              {
+                for (vcl_size_t i = 0; i < m_tile; ++i)
+                  for (vcl_size_t j = 0; j < n_tile; ++j)
+                    C(ic + ir + i, jc + jr + j) =                                  alpha * ab[i * nr + j];
+              }
+            }
+          }
+        }
+        // implicit barrier: packed B may be overwritten in the next iteration
+      }
+    }
+  }
+}
+
+} // namespace detail
+} // namespace host_based
+} // namespace linalg
+} // namespace viennacl
+
+#endif
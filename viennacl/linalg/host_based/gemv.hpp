@@ -0,0 +1,425 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_GEMV_HPP_
+#define VIENNACL_LINALG_HOST_BASED_GEMV_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/gemv.hpp
+    @brief Blocked dense matrix-vector multiplication (GEMV) y = alpha * op(A) * x + beta * y for the host backend.
+
+    Independent of the storage layout and the transposition, the matrix is traversed along its memory rows (the rows of a row-major matrix, the columns of a column-major matrix).
+    This leaves two kernels:
+      - 'dot form' (row-major A * x, column-major trans(A) * x): One inner product per memory row, parallelized over memory rows.
+      - 'axpy form' (row-major trans(A) * x, column-major A * x): The result is a linear combination of memory rows.
+        Wide results are split into column blocks owned by the individual threads, so no reduction is required.
+        Otherwise each thread accumulates the contributions of its memory rows into a private buffer, followed by a parallel reduction over the buffers.
+    Inner loops over unit-stride data use the SIMD kernels selected at runtime (see cpu_dispatch.hpp). alpha and beta are applied in the same pass.
+*/
+
+#include <vector>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+#include "viennacl/linalg/host_based/cpu_dispatch.hpp"
+#include "viennacl/linalg/host_based/vector_operations.hpp"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+// Minimum Matrix size(size1*size2) for using OpenMP on matrix operations:
+#ifndef VIENNACL_OPENMP_MATRIX_MIN_SIZE
+  #define VIENNACL_OPENMP_MATRIX_MIN_SIZE  5000
+#endif
+
+// Number of result entries updated per sweep in the axpy form (the block of the result should stay in L1 cache):
+#ifndef VIENNACL_HOST_GEMV_NB
+  #define VIENNACL_HOST_GEMV_NB  2048
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+namespace detail
+{
+
+//
+// Kernels for y[0:n] += c[0] * r[0][0:n] + c[1] * r[1][0:n] + c[2] * r[2][0:n] + c[3] * r[3][0:n] with unit-stride rows.
+// Four memory rows are combined per sweep in order to reduce the load/store traffic on y.
+//
+
+template<typename NumericT>
+void gemv_axpy4_kernel_scalar(vcl_size_t n, NumericT const * c, NumericT const * const * r, NumericT * y)
+{
+  NumericT c0 = c[0], c1 = c[1], c2 = c[2], c3 = c[3];
+  NumericT const * r0 = r[0];
+  NumericT const * r1 = r[1];
+  NumericT const * r2 = r[2];
+  NumericT const * r3 = r[3];
+  for (vcl_size_t j = 0; j < n; ++j)
+    y[j] += (c0 * r0[j] + c1 * r1[j]) + (c2 * r2[j] + c3 * r3[j]);
+}
+
+#ifdef VIENNACL_HOST_X86_SIMD
+VIENNACL_HOST_TARGET_AVX2
+inline void gemv_axpy4_kernel_avx2(vcl_size_t n, double const * c, double const * const * r, double * y)
+{
+  __m256d c0 = _mm256_set1_pd(c[0]), c1 = _mm256_set1_pd(c[1]), c2 = _mm256_set1_pd(c[2]), c3 = _mm256_set1_pd(c[3]);
+  double const * r0 = r[0];
+  double const * r1 = r[1];
+  double const * r2 = r[2];
+  double const * r3 = r[3];
+  vcl_size_t j = 0;
+  for (; j + 4 <= n; j += 4)
+  {
+    __m256d temp = _mm256_loadu_pd(y + j);
+    temp = _mm256_fmadd_pd(c0, _mm256_loadu_pd(r0 + j), temp);
+    temp = _mm256_fmadd_pd(c1, _mm256_loadu_pd(r1 + j), temp);
+    temp = _mm256_fmadd_pd(c2, _mm256_loadu_pd(r2 + j), temp);
+    temp = _mm256_fmadd_pd(c3, _mm256_loadu_pd(r3 + j), temp);
+    _mm256_storeu_pd(y + j, temp);
+  }
+  for (; j < n; ++j)
+    y[j] += (c[0] * r0[j] + c[1] * r1[j]) + (c[2] * r2[j] + c[3] * r3[j]);
+}
+
+VIENNACL_HOST_TARGET_AVX2
+inline void gemv_axpy4_kernel_avx2(vcl_size_t n, float const * c, float const * const * r, float * y)
+{
+  __m256 c0 = _mm256_set1_ps(c[0]), c1 = _mm256_set1_ps(c[1]), c2 = _mm256_set1_ps(c[2]), c3 = _mm256_set1_ps(c[3]);
+  float const * r0 = r[0];
+  float const * r1 = r[1];
+  float const * r2 = r[2];
+  float const * r3 = r[3];
+  vcl_size_t j = 0;
+  for (; j + 8 <= n; j += 8)
+  {
+    __m256 temp = _mm256_loadu_ps(y + j);
+    temp = _mm256_fmadd_ps(c0, _mm256_loadu_ps(r0 + j), temp);
+    temp = _mm256_fmadd_ps(c1, _mm256_loadu_ps(r1 + j), temp);
+    temp = _mm256_fmadd_ps(c2, _mm256_loadu_ps(r2 + j), temp);
+    temp = _mm256_fmadd_ps(c3, _mm256_loadu_ps(r3 + j), temp);
+    _mm256_storeu_ps(y + j, temp);
+  }
+  for (; j < n; ++j)
+    y[j] += (c[0] * r0[j] + c[1] * r1[j]) + (c[2] * r2[j] + c[3] * r3[j]);
+}
+
+VIENNACL_HOST_TARGET_AVX512
+inline void gemv_axpy4_kernel_avx512(vcl_size_t n, double const * c, double const * const * r, double * y)
+{
+  __m512d c0 = _mm512_set1_pd(c[0]), c1 = _mm512_set1_pd(c[1]), c2 = _mm512_set1_pd(c[2]), c3 = _mm512_set1_pd(c[3]);
+  double const * r0 = r[0];
+  double const * r1 = r[1];
+  double const * r2 = r[2];
+  double const * r3 = r[3];
+  vcl_size_t j = 0;
+  for (; j + 8 <= n; j += 8)
+  {
+    __m512d temp = _mm512_loadu_pd(y + j);
+    temp = _mm512_fmadd_pd(c0, _mm512_loadu_pd(r0 + j), temp);
+    temp = _mm512_fmadd_pd(c1, _mm512_loadu_pd(r1 + j), temp);
+    temp = _mm512_fmadd_pd(c2, _mm512_loadu_pd(r2 + j), temp);
+    temp = _mm512_fmadd_pd(c3, _mm512_loadu_pd(r3 + j), temp);
+    _mm512_storeu_pd(y + j, temp);
+  }
+  for (; j < n; ++j)
+    y[j] += (c[0] * r0[j] + c[1] * r1[j]) + (c[2] * r2[j] + c[3] * r3[j]);
+}
+
+VIENNACL_HOST_TARGET_AVX512
+inline void gemv_axpy4_kernel_avx512(vcl_size_t n, float const * c, float const * const * r, float * y)
+{
+  __m512 c0 = _mm512_set1_ps(c[0]), c1 = _mm512_set1_ps(c[1]), c2 = _mm512_set1_ps(c[2]), c3 = _mm512_set1_ps(c[3]);
+  float const * r0 = r[0];
+  float const * r1 = r[1];
+  float const * r2 = r[2];
+  float const * r3 = r[3];
+  vcl_size_t j = 0;
+  for (; j + 16 <= n; j += 16)
+  {
+    __m512 temp = _mm512_loadu_ps(y + j);
+    temp = _mm512_fmadd_ps(c0, _mm512_loadu_ps(r0 + j), temp);
+    temp = _mm512_fmadd_ps(c1, _mm512_loadu_ps(r1 + j), temp);
+    temp = _mm512_fmadd_ps(c2, _mm512_loadu_ps(r2 + j), temp);
+    temp = _mm512_fmadd_ps(c3, _mm512_loadu_ps(r3 + j), temp);
+    _mm512_storeu_ps(y + j, temp);
+  }
+  for (; j < n; ++j)
+    y[j] += (c[0] * r0[j] + c[1] * r1[j]) + (c[2] * r2[j] + c[3] * r3[j]);
+}
+#endif
+
+template<typename NumericT>
+struct gemv_axpy4_kernel
+{
+  typedef void (*type)(vcl_size_t, NumericT const *, NumericT const * const *, NumericT *);
+};
+
+#ifdef VIENNACL_HOST_X86_SIMD
+  #define VIENNACL_GEMV_AXPY4_KERNEL_VARIANTS  .add(cpu_isa_avx2,   gemv_axpy4_kernel_avx2) \
+                                               .add(cpu_isa_avx512, gemv_axpy4_kernel_avx512)
+#else
+  #define VIENNACL_GEMV_AXPY4_KERNEL_VARIANTS
+#endif
+
+template<typename NumericT>
+typename gemv_axpy4_kernel<NumericT>::type get_gemv_axpy4_kernel(NumericT const *)
+{
+  return gemv_axpy4_kernel_scalar<NumericT>;
+}
+
+inline gemv_axpy4_kernel<float>::type get_gemv_axpy4_kernel(float const *)
+{
+  static cpu_dispatcher<gemv_axpy4_kernel<float>::type> const dispatcher
+    = cpu_dispatcher<gemv_axpy4_kernel<float>::type>("gemv_axpy<float>", gemv_axpy4_kernel_scalar<float>) VIENNACL_GEMV_AXPY4_KERNEL_VARIANTS;
+  return dispatcher.get();
+}
+
+inline gemv_axpy4_kernel<double>::type get_gemv_axpy4_kernel(double const *)
+{
+  static cpu_dispatcher<gemv_axpy4_kernel<double>::type> const dispatcher
+    = cpu_dispatcher<gemv_axpy4_kernel<double>::type>("gemv_axpy<double>", gemv_axpy4_kernel_scalar<double>) VIENNACL_GEMV_AXPY4_KERNEL_VARIANTS;
+  return dispatcher.get();
+}
+
+#undef VIENNACL_GEMV_AXPY4_KERNEL_VARIANTS
+
+/** @brief Inner product kernel for the dot form. SIMD variants are available for float and double only. */
+template<typename NumericT>
+typename inner_prod_kernel<NumericT>::type get_gemv_dot_kernel(NumericT const *)
+{
+  return inner_prod_kernel_scalar<NumericT>;
+}
+
+inline inner_prod_kernel<float>::type  get_gemv_dot_kernel(float const * x)  { return get_inner_prod_kernel(x); }
+inline inner_prod_kernel<double>::type get_gemv_dot_kernel(double const * x) { return get_inner_prod_kernel(x); }
+
+
+/** @brief Applies y = beta * y, where beta == 0 overwrites y with zeros (i.e. does not propagate NaNs or Infs in the previous content of y) */
+template<typename NumericT>
+void gemv_scale(NumericT * y, vcl_size_t inc_y, vcl_size_t n, NumericT beta)
+{
+  if (beta == NumericT(0))
+    for (vcl_size_t j = 0; j < n; ++j)
+      y[j * inc_y] = 0;
+  else if (beta != NumericT(1))
+    for (vcl_size_t j = 0; j < n; ++j)
+      y[j * inc_y] *= beta;
+}
+
+/** @brief Accumulates y[0:col_end-col_begin] += scale * sum_{i=row_begin}^{row_end-1} x_i * A_i[col_begin:col_end] for the memory rows A_i = A + i * ld with element stride s.
+*
+* y is unit-stride and should fit into L1 cache.
+*/
+template<typename NumericT>
+void gemv_accumulate_rows(typename gemv_axpy4_kernel<NumericT>::type kernel,
+                          NumericT const * A, vcl_size_t ld, vcl_size_t s,
+                          vcl_size_t row_begin, vcl_size_t row_end,
+                          vcl_size_t col_begin, vcl_size_t col_end,
+                          NumericT const * x, vcl_size_t inc_x, NumericT scale,
+                          NumericT * y)
+{
+  vcl_size_t n = col_end - col_begin;
+  vcl_size_t i = row_begin;
+
+  if (s == 1)
+  {
+    NumericT         coeffs[4];
+    NumericT const * rows[4];
+    for (; i + 4 <= row_end; i += 4)
+    {
+      for (vcl_size_t k = 0; k < 4; ++k)
+      {
+        coeffs[k] = scale * x[(i + k) * inc_x];
+        rows[k]   = A + (i + k) * ld + col_begin;
+      }
+      kernel(n, coeffs, rows, y);
+    }
+  }
+
+  // remaining rows, non-unit stride:
+  for (; i < row_end; ++i)
+  {
+    NumericT coeff = scale * x[i * inc_x];
+    NumericT const * row = A + i * ld + col_begin * s;
+    for (vcl_size_t j = 0; j < n; ++j)
+      y[j] += coeff * row[j * s];
+  }
+}
+
+
+/** @brief Computes y[i] = alpha * <A_i, x> + beta * y[i] for the memory rows A_i = A + i * ld, i = 0, ..., rows-1, with element stride s and length cols.
+*
+* x and y must not overlap.
+*/
+template<typename NumericT>
+void gemv_dot_form(NumericT const * A, vcl_size_t ld, vcl_size_t s, vcl_size_t rows, vcl_size_t cols,
+                   NumericT const * x, vcl_size_t inc_x,
+                   NumericT       * y, vcl_size_t inc_y,
+                   NumericT alpha, NumericT beta)
+{
+  // gather a strided x once, so that the SIMD kernel can be used for all rows:
+  std::vector<NumericT> x_buffer;
+  if (s == 1 && inc_x != 1 && cols > 0)
+  {
+    x_buffer.resize(cols);
+    for (vcl_size_t j = 0; j < cols; ++j)
+      x_buffer[j] = x[j * inc_x];
+    x = &(x_buffer[0]);
+    inc_x = 1;
+  }
+
+  typename inner_prod_kernel<NumericT>::type kernel = get_gemv_dot_kernel(x);
+  bool use_kernel = (cols >= 32); // the call overhead does not pay off for short rows
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for if ((rows*cols) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+#endif
+  for (long i = 0; i < static_cast<long>(rows); ++i)
+  {
+    NumericT const * row = A + static_cast<vcl_size_t>(i) * ld;
+    NumericT temp = 0;
+    if (s != 1)
+      for (vcl_size_t j = 0; j < cols; ++j)
+        temp += row[j * s] * x[j * inc_x];
+    else if (use_kernel)
+      temp = kernel(row, x, cols);
+    else
+      for (vcl_size_t j = 0; j < cols; ++j)
+        temp += row[j] * x[j];
+
+    NumericT & y_i = y[static_cast<vcl_size_t>(i) * inc_y];
+    y_i = (beta == NumericT(0)) ? alpha * temp : alpha * temp + beta * y_i;
+  }
+}
+
+
+/** @brief Computes y = alpha * sum_i x_i * A_i + beta * y for the memory rows A_i = A + i * ld, i = 0, ..., rows-1, with element stride s and length cols.
+*
+* x and y must not overlap.
+*/
+template<typename NumericT>
+void gemv_axpy_form(NumericT const * A, vcl_size_t ld, vcl_size_t s, vcl_size_t rows, vcl_size_t cols,
+                    NumericT const * x, vcl_size_t inc_x,
+                    NumericT       * y, vcl_size_t inc_y,
+                    NumericT alpha, NumericT beta)
+{
+  typename gemv_axpy4_kernel<NumericT>::type kernel = get_gemv_axpy4_kernel(A);
+  vcl_size_t const nb = VIENNACL_HOST_GEMV_NB;
+
+  vcl_size_t thread_count = 1;
+#ifdef VIENNACL_WITH_OPENMP
+  if ((rows*cols) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
+    thread_count = static_cast<vcl_size_t>(omp_get_max_threads());
+#endif
+
+  if (thread_count == 1 || cols >= thread_count * nb)
+  {
+    //
+    // Split the result into column blocks, each updated by a single thread with all rows. No reduction required.
+    //
+    long num_blocks = static_cast<long>((cols + nb - 1) / nb);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel if (thread_count > 1)
+#endif
+    {
+      std::vector<NumericT> y_buffer((inc_y == 1) ? 0 : std::min(nb, cols));
+
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp for
+#endif
+      for (long block = 0; block < num_blocks; ++block)
+      {
+        vcl_size_t col_begin = static_cast<vcl_size_t>(block) * nb;
+        vcl_size_t col_end   = std::min(col_begin + nb, cols);
+        vcl_size_t n         = col_end - col_begin;
+
+        NumericT * y_block = y + col_begin * inc_y;
+        if (inc_y != 1) // work on a unit-stride copy
+        {
+          for (vcl_size_t j = 0; j < n; ++j)
+            y_buffer[j] = (beta == NumericT(0)) ? NumericT(0) : y_block[j * inc_y];
+          y_block = &(y_buffer[0]);
+        }
+        gemv_scale(y_block, 1, n, beta);
+
+        gemv_accumulate_rows(kernel, A, ld, s, 0, rows, col_begin, col_end, x, inc_x, alpha, y_block);
+
+        if (inc_y != 1)
+          for (vcl_size_t j = 0; j < n; ++j)
+            y[(col_begin + j) * inc_y] = y_buffer[j];
+      }
+    }
+  }
+  else
+  {
+    //
+    // Narrow result: Each thread accumulates the rows assigned to it into a private buffer.
+    // The buffers are then summed up in parallel, with each thread responsible for a slice of the result.
+    // The buffers are allocated for each call, so concurrent calls from different threads do not share them.
+    //
+    std::vector<NumericT> partial_results(thread_count * cols);
+    NumericT * partial = &(partial_results[0]);
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel
+#endif
+    {
+      vcl_size_t id = 0;
+      vcl_size_t num_threads = 1;
+#ifdef VIENNACL_WITH_OPENMP
+      id          = static_cast<vcl_size_t>(omp_get_thread_num());
+      num_threads = static_cast<vcl_size_t>(omp_get_num_threads());
+#endif
+      NumericT * my_partial = partial + id * cols;
+      std::fill(my_partial, my_partial + cols, NumericT(0));
+
+      vcl_size_t row_begin = (rows *  id     ) / num_threads;
+      vcl_size_t row_end   = (rows * (id + 1)) / num_threads;
+      for (vcl_size_t col_begin = 0; col_begin < cols; col_begin += nb)
+        gemv_accumulate_rows(kernel, A, ld, s, row_begin, row_end, col_begin, std::min(col_begin + nb, cols), x, inc_x, NumericT(1), my_partial + col_begin);
+
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp barrier
+#endif
+
+      vcl_size_t col_begin = (cols *  id     ) / num_threads;
+      vcl_size_t col_end   = (cols * (id + 1)) / num_threads;
+      for (vcl_size_t j = col_begin; j < col_end; ++j)
+      {
+        NumericT temp = partial[j];
+        for (vcl_size_t k = 1; k < num_threads; ++k)
+          temp += partial[k * cols + j];
+
+        NumericT & y_j = y[j * inc_y];
+        y_j = (beta == NumericT(0)) ? alpha * temp : alpha * temp + beta * y_j;
+      }
+    }
+  }
+}
+
+} // namespace detail
+} // namespace host_based
+} // namespace linalg
+} // namespace viennacl
+
+#endif
@@ -33,6 +33,7 @@
 #include "viennacl/traits/size.hpp"
 #include "viennacl/traits/start.hpp"
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/sparse_matrix_operations.hpp"
 #include "viennacl/linalg/vector_operations.hpp"
 #include "viennacl/traits/stride.hpp"
 
@@ -116,6 +117,7 @@ void extract_L(compressed_matrix<NumericT> const & A,
     }
   }
 
+  L.reset_row_statistics();
 } // extract_L
 
 
@@ -340,6 +342,8 @@ void extract_LU(compressed_matrix<NumericT> const & A,
     }
   }
 
+  L.reset_row_statistics();
+  U.reset_row_statistics();
 } // extract_LU
 
 
@@ -431,69 +435,8 @@ template<typename NumericT>
 void ilu_transpose(compressed_matrix<NumericT> const & A,
                    compressed_matrix<NumericT>       & B)
 {
-  NumericT     const * A_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(A.handle());
-  unsigned int const * A_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle1());
-  unsigned int const * A_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle2());
-
-  // initialize datastructures for B:
-  B = compressed_matrix<NumericT>(A.size2(), A.size1(), A.nnz(), viennacl::traits::context(A));
-
-  NumericT     * B_elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(B.handle());
-  unsigned int * B_row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(B.handle1());
-  unsigned int * B_col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(B.handle2());
-
-  // prepare uninitialized B_row_buffer:
-  for (std::size_t i = 0; i < B.size1(); ++i)
-    B_row_buffer[i] = 0;
-
-  //
-  // Stage 1: Compute pattern for B
-  //
-  for (std::size_t row = 0; row < A.size1(); ++row)
-  {
-    unsigned int row_start = A_row_buffer[row];
-    unsigned int row_stop  = A_row_buffer[row+1];
-
-    for (unsigned int nnz_index = row_start; nnz_index < row_stop; ++nnz_index)
-      B_row_buffer[A_col_buffer[nnz_index]] += 1;
-  }
-
-  // Bring row-start array in place using exclusive-scan:
-  unsigned int offset = B_row_buffer[0];
-  B_row_buffer[0] = 0;
-  for (std::size_t row = 1; row < B.size1(); ++row)
-  {
-    unsigned int tmp = B_row_buffer[row];
-    B_row_buffer[row] = offset;
-    offset += tmp;
-  }
-  B_row_buffer[B.size1()] = offset;
-
-  //
-  // Stage 2: Fill with data
-  //
-
-  std::vector<unsigned int> B_row_offsets(B.size1()); //number of elements already written per row
-
-  for (unsigned int row = 0; row < static_cast<unsigned int>(A.size1()); ++row)
-  {
-    //std::cout << "Row " << row << ": ";
-    unsigned int row_start = A_row_buffer[row];
-    unsigned int row_stop  = A_row_buffer[row+1];
-
-    for (unsigned int nnz_index = row_start; nnz_index < row_stop; ++nnz_index)
-    {
-      unsigned int col_in_A = A_col_buffer[nnz_index];
-      unsigned int B_nnz_index = B_row_buffer[col_in_A] + B_row_offsets[col_in_A];
-      B_col_buffer[B_nnz_index] = row;
-      B_elements[B_nnz_index] = A_elements[nnz_index];
-      ++B_row_offsets[col_in_A];
-      //B_temp.at(A_col_buffer[nnz_index])[row] = A_elements[nnz_index];
-    }
-  }
-
-  // Step 3: Make datastructure consistent (row blocks!)
-  B.generate_row_block_information();
+  // the column indices of B are sorted within each row, hence the entries of B are ordered as if they were assigned row by row:
+  viennacl::linalg::host_based::trans(A, B);
 }
 
 
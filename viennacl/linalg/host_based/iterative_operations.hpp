@@ -24,6 +24,7 @@
 
 #include <cmath>
 #include <algorithm>  //for std::max and std::min
+#include <vector>
 
 #include "viennacl/forwards.h"
 #include "viennacl/scalar.hpp"
@@ -33,6 +34,7 @@
 #include "viennacl/traits/size.hpp"
 #include "viennacl/traits/start.hpp"
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/sparse_matrix_operations.hpp"
 #include "viennacl/linalg/detail/op_applier.hpp"
 #include "viennacl/traits/stride.hpp"
 
@@ -54,6 +56,7 @@ namespace detail
     * This routines computes for a matrix A and vectors 'p', 'Ap', and 'r0':
     *   Ap = prod(A, p);
     * and computes the two reduction stages for computing inner_prod(p,Ap), inner_prod(Ap,Ap), inner_prod(Ap, r0)
+    * If 'weights' is given, the weighted inner product sum_i weights[i] * Ap[i] * Ap[i] is computed instead of inner_prod(Ap,Ap).
     */
   template<typename NumericT>
   void pipelined_prod_impl(compressed_matrix<NumericT> const & A,
@@ -62,7 +65,8 @@ namespace detail
                            NumericT const * r0star,
                            vector_base<NumericT> & inner_prod_buffer,
                            vcl_size_t buffer_chunk_size,
-                           vcl_size_t buffer_chunk_offset)
+                           vcl_size_t buffer_chunk_offset,
+                           NumericT const * weights = NULL)
   {
     typedef NumericT        value_type;
 
@@ -77,23 +81,73 @@ namespace detail
     value_type inner_prod_pAp = 0;
     value_type inner_prod_Ap_r0star = 0;
 
+    vcl_size_t thread_count = 1;
 #ifdef VIENNACL_WITH_OPENMP
-    #pragma omp parallel for reduction(+: inner_prod_ApAp, inner_prod_pAp, inner_prod_Ap_r0star)
+    thread_count = static_cast<vcl_size_t>(omp_get_max_threads());
 #endif
-    for (long row = 0; row < static_cast<long>(A.size1()); ++row)
+
+    // rows are processed in the blocks of the row partition cached with the matrix, the entries of dense rows are split across all blocks:
+    viennacl::detail::csr_row_partition const & partition = detail::row_partition(A, thread_count);
+    long blocks = static_cast<long>(partition.row_offsets.size()) - 1;
+
+    std::vector<vcl_size_t> no_dense_rows;
+    std::vector<vcl_size_t> const & dense_rows = (blocks > 1) ? A.row_statistics().dense_rows : no_dense_rows;
+    std::vector<value_type> dense_row_partials(static_cast<vcl_size_t>(blocks) * dense_rows.size());
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for num_threads(static_cast<int>(blocks)) if (blocks > 1) reduction(+: inner_prod_ApAp, inner_prod_pAp, inner_prod_Ap_r0star)
+#endif
+    for (long block = 0; block < blocks; ++block)
     {
-      value_type dot_prod = 0;
-      value_type val_p_diag = p_buf[static_cast<vcl_size_t>(row)]; //likely to be loaded from cache if required again in this row
+      vcl_size_t block_begin = partition.row_offsets[static_cast<vcl_size_t>(block)];
+      vcl_size_t block_end   = partition.row_offsets[static_cast<vcl_size_t>(block) + 1];
+      std::vector<vcl_size_t>::const_iterator next_dense_row = std::lower_bound(dense_rows.begin(), dense_rows.end(), block_begin);
+      for (vcl_size_t row = block_begin; row < block_end; ++row)
+      {
+        if (next_dense_row != dense_rows.end() && *next_dense_row == row)
+        {
+          ++next_dense_row;
+          continue;
+        }
+
+        value_type dot_prod = 0;
+        value_type val_p_diag = p_buf[row]; //likely to be loaded from cache if required again in this row
+
+        vcl_size_t row_end = row_buffer[row+1];
+        for (vcl_size_t i = row_buffer[row]; i < row_end; ++i)
+          dot_prod += elements[i] * p_buf[col_buffer[i]];
+
+        // update contributions for the inner products (Ap, Ap) and (p, Ap)
+        Ap_buf[row] = dot_prod;
+        inner_prod_ApAp += weights ? weights[row] * dot_prod * dot_prod : dot_prod * dot_prod;
+        inner_prod_pAp  += val_p_diag * dot_prod;
+        inner_prod_Ap_r0star += r0star ? dot_prod * r0star[row] : value_type(0);
+      }
 
-      vcl_size_t row_end = row_buffer[row+1];
-      for (vcl_size_t i = row_buffer[row]; i < row_end; ++i)
-        dot_prod += elements[i] * p_buf[col_buffer[i]];
+      // this block's share of the dense rows:
+      for (vcl_size_t j = 0; j < dense_rows.size(); ++j)
+      {
+        vcl_size_t row_start  = row_buffer[dense_rows[j]];
+        vcl_size_t row_length = row_buffer[dense_rows[j] + 1] - row_start;
+        vcl_size_t i_end = row_start + (row_length * static_cast<vcl_size_t>(block + 1)) / static_cast<vcl_size_t>(blocks);
+        value_type dot_prod = 0;
+        for (vcl_size_t i = row_start + (row_length * static_cast<vcl_size_t>(block)) / static_cast<vcl_size_t>(blocks); i < i_end; ++i)
+          dot_prod += elements[i] * p_buf[col_buffer[i]];
+        dense_row_partials[static_cast<vcl_size_t>(block) * dense_rows.size() + j] = dot_prod;
+      }
+    }
+
+    for (vcl_size_t j = 0; j < dense_rows.size(); ++j)
+    {
+      vcl_size_t row = dense_rows[j];
+      value_type dot_prod = 0;
+      for (vcl_size_t block = 0; block < static_cast<vcl_size_t>(blocks); ++block)
+        dot_prod += dense_row_partials[block * dense_rows.size() + j];
 
-      // update contributions for the inner products (Ap, Ap) and (p, Ap)
-      Ap_buf[static_cast<vcl_size_t>(row)] = dot_prod;
-      inner_prod_ApAp += dot_prod * dot_prod;
-      inner_prod_pAp  += val_p_diag * dot_prod;
-      inner_prod_Ap_r0star += r0star ? dot_prod * r0star[static_cast<vcl_size_t>(row)] : value_type(0);
+      Ap_buf[row] = dot_prod;
+      inner_prod_ApAp += weights ? weights[row] * dot_prod * dot_prod : dot_prod * dot_prod;
+      inner_prod_pAp  += p_buf[row] * dot_prod;
+      inner_prod_Ap_r0star += r0star ? dot_prod * r0star[row] : value_type(0);
     }
 
     data_buffer[    buffer_chunk_size] = inner_prod_ApAp;
@@ -109,6 +163,7 @@ namespace detail
     * This routines computes for a matrix A and vectors 'p', 'Ap', and 'r0':
     *   Ap = prod(A, p);
     * and computes the two reduction stages for computing inner_prod(p,Ap), inner_prod(Ap,Ap), inner_prod(Ap, r0)
+    * If 'weights' is given, the weighted inner product sum_i weights[i] * Ap[i] * Ap[i] is computed instead of inner_prod(Ap,Ap).
     */
   template<typename NumericT>
   void pipelined_prod_impl(coordinate_matrix<NumericT> const & A,
@@ -117,7 +172,8 @@ namespace detail
                            NumericT const * r0star,
                            vector_base<NumericT> & inner_prod_buffer,
                            vcl_size_t buffer_chunk_size,
-                           vcl_size_t buffer_chunk_offset)
+                           vcl_size_t buffer_chunk_offset,
+                           NumericT const * weights = NULL)
   {
     typedef NumericT        value_type;
 
@@ -145,7 +201,7 @@ namespace detail
       NumericT value_Ap = Ap_buf[i];
       NumericT value_p  =  p_buf[i];
 
-      inner_prod_ApAp += value_Ap * value_Ap;
+      inner_prod_ApAp += weights ? weights[i] * value_Ap * value_Ap : value_Ap * value_Ap;
       inner_prod_pAp  += value_Ap * value_p;
       inner_prod_Ap_r0star += r0star ? value_Ap * r0star[i] : value_type(0);
     }
@@ -237,44 +293,39 @@ namespace detail
     IndexT     const * columns_per_block = detail::extract_raw_pointer<IndexT>(A.handle1());
     IndexT     const * column_indices    = detail::extract_raw_pointer<IndexT>(A.handle2());
     IndexT     const * block_start       = detail::extract_raw_pointer<IndexT>(A.handle3());
+    IndexT     const * row_permutation   = (A.handle4().raw_size() > 0) ? detail::extract_raw_pointer<IndexT>(A.handle4()) : NULL;
     value_type         * data_buffer     = detail::extract_raw_pointer<value_type>(inner_prod_buffer);
 
-    vcl_size_t num_blocks = A.size1() / A.rows_per_block() + 1;
+    typename detail::sell_block_kernel<value_type, IndexT>::type kernel = detail::get_sell_block_kernel(elements, column_indices);
+
+    vcl_size_t rows_per_block = A.rows_per_block();
+    vcl_size_t num_blocks     = (A.size1() > 0) ? (A.size1() - 1) / rows_per_block + 1 : 0;
 
     value_type inner_prod_ApAp = 0;
     value_type inner_prod_pAp = 0;
     value_type inner_prod_Ap_r0star = 0;
 
 #ifdef VIENNACL_WITH_OPENMP
-    #pragma omp parallel for reduction(+: inner_prod_ApAp, inner_prod_pAp, inner_prod_Ap_r0star)
+    #pragma omp parallel reduction(+: inner_prod_ApAp, inner_prod_pAp, inner_prod_Ap_r0star)
 #endif
-    for (vcl_size_t block_idx = 0; block_idx < num_blocks; ++block_idx)
     {
-      vcl_size_t current_columns_per_block = columns_per_block[block_idx];
-
-      std::vector<value_type> result_values(A.rows_per_block());
-
-      for (IndexT column_entry_index = 0;
-                  column_entry_index < current_columns_per_block;
-                ++column_entry_index)
-      {
-        vcl_size_t stride_start = block_start[block_idx] + column_entry_index * A.rows_per_block();
-        // Note: This for-loop may be unrolled by hand for exploiting vectorization
-        //       Careful benchmarking recommended first, memory channels may be saturated already!
-        for (IndexT row_in_block = 0; row_in_block < A.rows_per_block(); ++row_in_block)
-        {
-          value_type val = elements[stride_start + row_in_block];
-
-          result_values[row_in_block] += val ? p_buf[column_indices[stride_start + row_in_block]] * val : 0;
-        }
-      }
+      std::vector<value_type> result_values(rows_per_block);
 
-      vcl_size_t first_row_in_matrix = block_idx * A.rows_per_block();
-      for (IndexT row_in_block = 0; row_in_block < A.rows_per_block(); ++row_in_block)
+#ifdef VIENNACL_WITH_OPENMP
+      #pragma omp for
+#endif
+      for (long block_idx2 = 0; block_idx2 < static_cast<long>(num_blocks); ++block_idx2)
       {
-        vcl_size_t row = first_row_in_matrix + row_in_block;
-        if (row < Ap.size())
+        vcl_size_t block_idx = static_cast<vcl_size_t>(block_idx2);
+        kernel(rows_per_block, columns_per_block[block_idx],
+               elements + block_start[block_idx], column_indices + block_start[block_idx],
+               p_buf, &(result_values[0]));
+
+        vcl_size_t first_row_in_block = block_idx * rows_per_block;
+        vcl_size_t rows_in_block      = std::min(rows_per_block, A.size1() - first_row_in_block);
+        for (vcl_size_t row_in_block = 0; row_in_block < rows_in_block; ++row_in_block)
         {
+          vcl_size_t row = row_permutation ? static_cast<vcl_size_t>(row_permutation[first_row_in_block + row_in_block]) : first_row_in_block + row_in_block;
           value_type row_result = result_values[row_in_block];
 
           Ap_buf[row] = row_result;
@@ -505,6 +556,97 @@ void pipelined_cg_prod(hyb_matrix<NumericT> const & A,
   viennacl::linalg::host_based::detail::pipelined_prod_impl(A, p, Ap, PtrType(NULL), inner_prod_buffer, inner_prod_buffer.size() / 3, 0);
 }
 
+
+/** @brief Performs a joint vector update operation needed for an efficient pipelined CG algorithm with a diagonal preconditioner M = diag(d).
+  *
+  * This routines computes for vectors 'result', 'p', 'r', 'Ap' and the inverse diagonal 'inv_diag' = 1/d:
+  *   result += alpha * p;
+  *   r      -= alpha * Ap;
+  *   p       = inv_diag .* r + beta * p;
+  * and runs the parallel reduction stage for computing inner_prod(r, inv_diag .* r). The preconditioned residual is never stored.
+  */
+template<typename NumericT>
+void pipelined_pcg_vector_update(vector_base<NumericT> & result,
+                                 NumericT alpha,
+                                 vector_base<NumericT> & p,
+                                 vector_base<NumericT> & r,
+                                 vector_base<NumericT> const & Ap,
+                                 vector_base<NumericT> const & inv_diag,
+                                 NumericT beta,
+                                 vector_base<NumericT> & inner_prod_buffer)
+{
+  typedef NumericT       value_type;
+
+  value_type       * data_result   = detail::extract_raw_pointer<value_type>(result);
+  value_type       * data_p        = detail::extract_raw_pointer<value_type>(p);
+  value_type       * data_r        = detail::extract_raw_pointer<value_type>(r);
+  value_type const * data_Ap       = detail::extract_raw_pointer<value_type>(Ap);
+  value_type const * data_inv_diag = detail::extract_raw_pointer<value_type>(inv_diag);
+  value_type       * data_buffer   = detail::extract_raw_pointer<value_type>(inner_prod_buffer);
+
+  // Note: Due to the special setting in CG, there is no need to check for sizes and strides
+  vcl_size_t size  = viennacl::traits::size(result);
+
+  value_type inner_prod_rz = 0;
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for reduction(+: inner_prod_rz)
+#endif
+  for (long i = 0; i < static_cast<long>(size); ++i)
+  {
+    value_type value_p = data_p[static_cast<vcl_size_t>(i)];
+    value_type value_r = data_r[static_cast<vcl_size_t>(i)];
+
+    data_result[static_cast<vcl_size_t>(i)] += alpha * value_p;
+    value_r -= alpha * data_Ap[static_cast<vcl_size_t>(i)];
+    value_type value_z = data_inv_diag[static_cast<vcl_size_t>(i)] * value_r;
+    value_p  = value_z + beta * value_p;
+    inner_prod_rz += value_r * value_z;
+
+    data_p[static_cast<vcl_size_t>(i)] = value_p;
+    data_r[static_cast<vcl_size_t>(i)] = value_r;
+  }
+
+  data_buffer[0] = inner_prod_rz;
+}
+
+
+/** @brief Performs a fused matrix-vector product with a compressed_matrix for an efficient pipelined CG algorithm with a diagonal preconditioner.
+  *
+  * This routines computes for a matrix A, vectors 'p' and 'Ap', and the inverse diagonal 'inv_diag' of the preconditioner:
+  *   Ap = prod(A, p);
+  * and computes the two reduction stages for computing inner_prod(p,Ap), inner_prod(Ap, inv_diag .* Ap)
+  */
+template<typename NumericT>
+void pipelined_pcg_prod(compressed_matrix<NumericT> const & A,
+                        vector_base<NumericT> const & p,
+                        vector_base<NumericT> & Ap,
+                        vector_base<NumericT> const & inv_diag,
+                        vector_base<NumericT> & inner_prod_buffer)
+{
+  typedef NumericT const *    PtrType;
+  viennacl::linalg::host_based::detail::pipelined_prod_impl(A, p, Ap, PtrType(NULL), inner_prod_buffer, inner_prod_buffer.size() / 3, 0,
+                                                            detail::extract_raw_pointer<NumericT>(inv_diag));
+}
+
+
+/** @brief Performs a fused matrix-vector product with a coordinate_matrix for an efficient pipelined CG algorithm with a diagonal preconditioner.
+  *
+  * This routines computes for a matrix A, vectors 'p' and 'Ap', and the inverse diagonal 'inv_diag' of the preconditioner:
+  *   Ap = prod(A, p);
+  * and computes the two reduction stages for computing inner_prod(p,Ap), inner_prod(Ap, inv_diag .* Ap)
+  */
+template<typename NumericT>
+void pipelined_pcg_prod(coordinate_matrix<NumericT> const & A,
+                        vector_base<NumericT> const & p,
+                        vector_base<NumericT> & Ap,
+                        vector_base<NumericT> const & inv_diag,
+                        vector_base<NumericT> & inner_prod_buffer)
+{
+  typedef NumericT const *    PtrType;
+  viennacl::linalg::host_based::detail::pipelined_prod_impl(A, p, Ap, PtrType(NULL), inner_prod_buffer, inner_prod_buffer.size() / 3, 0,
+                                                            detail::extract_raw_pointer<NumericT>(inv_diag));
+}
+
 //////////////////////////
 
 
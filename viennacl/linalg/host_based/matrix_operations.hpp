@@ -36,6 +36,8 @@
 #include "viennacl/traits/stride.hpp"
 #include "viennacl/linalg/detail/op_applier.hpp"
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/gemm_packed.hpp"
+#include "viennacl/linalg/host_based/gemv.hpp"
 #include "viennacl/linalg/prod.hpp"
 
 // Minimum Matrix size(size1*size2) for using OpenMP on matrix operations:
@@ -980,19 +982,23 @@ void element_op(matrix_base<NumericT> & A,
 
 // A * x
 
-/** @brief Carries out matrix-vector multiplication
+/** @brief Carries out matrix-vector multiplication result = alpha * op(mat) * vec + beta * result
 *
-* Implementation of the convenience expression result = prod(mat, vec);
+* Implementation of the convenience expressions result = prod(mat, vec), result += prod(mat, vec), etc.
+* If beta is zero, the previous content of result is not read.
 *
 * @param mat    The matrix
 * @param trans  Flag whether mat is to be transposed
-* @param vec    The vector
+* @param vec    The vector. Must not share its memory with result.
 * @param result The result vector
+* @param alpha  Scaling factor for the matrix-vector product
+* @param beta   Scaling factor for the previous content of result
 */
 template<typename NumericT>
 void prod_impl(const matrix_base<NumericT> & mat, bool trans,
                const vector_base<NumericT> & vec,
-                     vector_base<NumericT> & result)
+                     vector_base<NumericT> & result,
+               NumericT alpha, NumericT beta)
 {
   typedef NumericT        value_type;
 
@@ -1015,119 +1021,47 @@ void prod_impl(const matrix_base<NumericT> & mat, bool trans,
   vcl_size_t start2 = viennacl::traits::start(result);
   vcl_size_t inc2   = viennacl::traits::stride(result);
 
+  // View the matrix as a set of 'memory rows' (rows for row-major, columns for column-major):
+  value_type const * A_begin;
+  vcl_size_t memory_rows, memory_cols, ld, s;
   if (mat.row_major())
   {
-    if (trans)
-    {
-      vcl_size_t thread_count = 1;
-#ifdef VIENNACL_WITH_OPENMP
-      if ((A_size1*A_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
-        thread_count = omp_get_max_threads();
-#endif
-      std::vector<value_type> temp_array(A_size2*thread_count, 0);
-      detail::vector_array_wrapper<value_type> wrapper_res(data_result, start2, inc2);
-
-      for (vcl_size_t col = 0; col < A_size2; ++col)
-        wrapper_res(col) = 0;
-
-#ifdef VIENNACL_WITH_OPENMP
-      #pragma omp parallel if ((A_size1*A_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
-#endif
-      {
-        vcl_size_t id = 0;
-#ifdef VIENNACL_WITH_OPENMP
-        if ((A_size1*A_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
-          id = omp_get_thread_num();
- #endif
-        vcl_size_t begin = (A_size1 * id) / thread_count;
-        vcl_size_t end   = (A_size1 * (id + 1)) / thread_count;
-
-        detail::matrix_array_wrapper<value_type const, row_major, false> wrapper_mat(data_A, A_start1 + A_inc1 * begin, A_start2, A_inc1, A_inc2, A_internal_size1, A_internal_size2);
-        detail::vector_array_wrapper<value_type const> wrapper_vec(data_x, start1 + inc1 * begin, inc1);
-
-        for (vcl_size_t row = 0; row < (end - begin); ++row)  //run through matrix sequentially
-        {
-          value_type temp = wrapper_vec(row);
-          for (vcl_size_t col = 0; col < A_size2; ++col)
-            temp_array[A_size2 * id + col] += wrapper_mat(row , col) * temp;
-        }
-      }
-      for (vcl_size_t id = 0; id < thread_count; ++id)
-        for (vcl_size_t col = 0; col < A_size2; ++col)
-          wrapper_res(col) += temp_array[A_size2 * id + col];
-    }
-
-    else
-    {
-#ifdef VIENNACL_WITH_OPENMP
-      #pragma omp parallel for if ((A_size1*A_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
-#endif
-      for (long row = 0; row < static_cast<long>(A_size1); ++row)
-      {
-        value_type temp = 0;
-        for (vcl_size_t col = 0; col < A_size2; ++col)
-          temp += data_A[viennacl::row_major::mem_index(static_cast<vcl_size_t>(row) * A_inc1 + A_start1, col * A_inc2 + A_start2, A_internal_size1, A_internal_size2)] * data_x[col * inc1 + start1];
-
-        data_result[static_cast<vcl_size_t>(row) * inc2 + start2] = temp;
-      }
-    }
+    A_begin     = data_A + viennacl::row_major::mem_index(A_start1, A_start2, A_internal_size1, A_internal_size2);
+    memory_rows = A_size1;
+    memory_cols = A_size2;
+    ld          = A_inc1 * A_internal_size2;
+    s           = A_inc2;
   }
   else
   {
-    if (!trans)
-    {
-      vcl_size_t thread_count = 1;
-#ifdef VIENNACL_WITH_OPENMP
-      if ((A_size1*A_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
-        thread_count = omp_get_max_threads();
-#endif
-      std::vector<value_type> temp_array(A_size1*thread_count, 0);
-      detail::vector_array_wrapper<value_type> wrapper_res(data_result, start2, inc2);
-
-      for (vcl_size_t row = 0; row < A_size1; ++row)
-        wrapper_res(row) = 0;
-
-#ifdef VIENNACL_WITH_OPENMP
-      #pragma omp parallel if ((A_size1*A_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
-#endif
-      {
-        vcl_size_t id = 0;
-#ifdef VIENNACL_WITH_OPENMP
-        if ((A_size1*A_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
-          id = omp_get_thread_num();
- #endif
-        vcl_size_t begin = (A_size2 * id) / thread_count;
-        vcl_size_t end   = (A_size2 * (id + 1)) / thread_count;
-
-        detail::matrix_array_wrapper<value_type const, column_major, false> wrapper_mat(data_A, A_start1, A_start2 + A_inc2 * begin, A_inc1, A_inc2, A_internal_size1, A_internal_size2);
-        detail::vector_array_wrapper<value_type const> wrapper_vec(data_x, start1 + inc1 * begin, inc1);
+    A_begin     = data_A + viennacl::column_major::mem_index(A_start1, A_start2, A_internal_size1, A_internal_size2);
+    memory_rows = A_size2;
+    memory_cols = A_size1;
+    ld          = A_inc2 * A_internal_size1;
+    s           = A_inc1;
+  }
 
-        for (vcl_size_t col = 0; col < (end - begin); ++col)  //run through matrix sequentially
-        {
-          value_type temp = wrapper_vec(col);
-          for (vcl_size_t row = 0; row < A_size1; ++row)
-            temp_array[A_size1 * id + row] += wrapper_mat(row , col) * temp;
-        }
-      }
-      for (vcl_size_t id = 0; id < thread_count; ++id)
-        for (vcl_size_t row = 0; row < A_size1; ++row)
-          wrapper_res(row) += temp_array[A_size1 * id + row];
-    }
-    else
-    {
-#ifdef VIENNACL_WITH_OPENMP
-      #pragma omp parallel for if ((A_size1*A_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
-#endif
-      for (long row = 0; row < static_cast<long>(A_size2); ++row)
-      {
-        value_type temp = 0;
-        for (vcl_size_t col = 0; col < A_size1; ++col)
-          temp += data_A[viennacl::column_major::mem_index(col * A_inc1 + A_start1, static_cast<vcl_size_t>(row) * A_inc2 + A_start2, A_internal_size1, A_internal_size2)] * data_x[col * inc1 + start1];
+  if (mat.row_major() != trans) // y_i = <memory row i, x>
+    detail::gemv_dot_form(A_begin, ld, s, memory_rows, memory_cols, data_x + start1, inc1, data_result + start2, inc2, alpha, beta);
+  else                          // y = sum_i x_i * memory row i
+    detail::gemv_axpy_form(A_begin, ld, s, memory_rows, memory_cols, data_x + start1, inc1, data_result + start2, inc2, alpha, beta);
+}
 
-        data_result[static_cast<vcl_size_t>(row) * inc2 + start2] = temp;
-      }
-    }
-  }
+/** @brief Carries out matrix-vector multiplication
+*
+* Implementation of the convenience expression result = prod(mat, vec);
+*
+* @param mat    The matrix
+* @param trans  Flag whether mat is to be transposed
+* @param vec    The vector
+* @param result The result vector
+*/
+template<typename NumericT>
+void prod_impl(const matrix_base<NumericT> & mat, bool trans,
+               const vector_base<NumericT> & vec,
+                     vector_base<NumericT> & result)
+{
+  prod_impl(mat, trans, vec, result, NumericT(1), NumericT(0));
 }
 
 
@@ -1146,86 +1080,8 @@ namespace detail
     if (C_size1 == 0 || C_size2 == 0 || A_size2 == 0)
       return;
 
-    static const vcl_size_t blocksize = 64;
-
-    vcl_size_t num_blocks_C1 = (C_size1 - 1) / blocksize + 1;
-    vcl_size_t num_blocks_C2 = (C_size2 - 1) / blocksize + 1;
-    vcl_size_t num_blocks_A2 = (A_size2 - 1) / blocksize + 1;
-
-    //
-    // outer loop pair: Run over all blocks with indices (block_idx_i, block_idx_j) of the result matrix C:
-    //
-#ifdef VIENNACL_WITH_OPENMP
-    #pragma omp parallel for if ((C_size1*C_size2) > VIENNACL_OPENMP_MATRIX_MIN_SIZE)
-#endif
-    for (long block_idx_i2=0; block_idx_i2<static_cast<long>(num_blocks_C1); ++block_idx_i2)
-    {
-      // thread-local auxiliary buffers
-      std::vector<NumericT> buffer_A(blocksize * blocksize); // row-major
-      std::vector<NumericT> buffer_B(blocksize * blocksize); // column-major
-      std::vector<NumericT> buffer_C(blocksize * blocksize); // row-major
-
-      vcl_size_t block_idx_i = static_cast<vcl_size_t>(block_idx_i2);
-      for (vcl_size_t block_idx_j=0; block_idx_j<num_blocks_C2; ++block_idx_j)
-      {
-        // Reset block matrix:
-        std::fill(buffer_C.begin(), buffer_C.end(), NumericT(0));
-
-        vcl_size_t offset_i = block_idx_i*blocksize;
-        vcl_size_t offset_j = block_idx_j*blocksize;
-
-        //  C(block_idx_i, block_idx_i) += A(block_idx_i, block_idx_k) * B(block_idx_k, block_idx_j)
-        for (vcl_size_t block_idx_k=0; block_idx_k<num_blocks_A2; ++block_idx_k)
-        {
-          // flush buffers:
-          std::fill(buffer_A.begin(), buffer_A.end(), NumericT(0));
-          std::fill(buffer_B.begin(), buffer_B.end(), NumericT(0));
-
-          vcl_size_t offset_k = block_idx_k*blocksize;
-
-          // load current data:
-          for (vcl_size_t i = offset_i; i < std::min(offset_i + blocksize, C_size1); ++i)
-            for (vcl_size_t k = offset_k; k < std::min(offset_k + blocksize, A_size2); ++k)
-              buffer_A[(i - offset_i) * blocksize + (k - offset_k)] = A(i, k);
-
-          for (vcl_size_t j = offset_j; j < std::min(offset_j + blocksize, C_size2); ++j)
-            for (vcl_size_t k = offset_k; k < std::min(offset_k + blocksize, A_size2); ++k)
-              buffer_B[(k - offset_k) + (j - offset_j) * blocksize] = B(k, j);
-
-          // multiply (this is the hot spot in terms of flops)
-          for (vcl_size_t i = 0; i < blocksize; ++i)
-          {
-            NumericT const * ptrA = &(buffer_A[i*blocksize]);
-            for (vcl_size_t j = 0; j < blocksize; ++j)
-            {
-              NumericT const * ptrB = &(buffer_B[j*blocksize]);
-
-              NumericT temp = NumericT(0);
-              for (vcl_size_t k = 0; k < blocksize; ++k)
-                temp += ptrA[k] * ptrB[k];  // buffer_A[i*blocksize + k] * buffer_B[k + j*blocksize];
-
-              buffer_C[i*blocksize + j] += temp;
-            }
-          }
-        }
-
-        // write result:
-        if (beta > 0 || beta < 0)
-        {
-          for (vcl_size_t i = offset_i; i < std::min(offset_i + blocksize, C_size1); ++i)
-            for (vcl_size_t j = offset_j; j < std::min(offset_j + blocksize, C_size2); ++j)
-              C(i,j) = beta * C(i,j) + alpha * buffer_C[(i - offset_i) * blocksize + (j - offset_j)];
-        }
-        else
-        {
-          for (vcl_size_t i = offset_i; i < std::min(offset_i + blocksize, C_size1); ++i)
-            for (vcl_size_t j = offset_j; j < std::min(offset_j + blocksize, C_size2); ++j)
-              C(i,j) =                 alpha * buffer_C[(i - offset_i) * blocksize + (j - offset_j)];
-        }
-
-      } // for block j
-    } // for block i
-
+    // packing into cache-sized panels takes care of layouts, offsets, strides and transpositions of all operands:
+    packed_gemm(A, B, C, C_size1, C_size2, A_size2, alpha, beta);
   } // prod()
 
 } // namespace detail
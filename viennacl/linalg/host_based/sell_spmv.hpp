@@ -0,0 +1,208 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_SELL_SPMV_HPP_
+#define VIENNACL_LINALG_HOST_BASED_SELL_SPMV_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/sell_spmv.hpp
+    @brief Block kernels for matrix-vector products with the SELL-C-sigma format (sliced_ell_matrix) on the host.
+
+    A block of a sliced_ell_matrix holds C rows, stored column by column. Hence, C consecutive entries of a block column belong to C consecutive rows of the block
+    and can be processed as one SIMD vector: The values are loaded contiguously, the entries of x are gathered via the column indices.
+    The SIMD variants process the rows of a block in chunks of the SIMD width, so C should be a multiple of the SIMD width (the default C = 32 is).
+    Remaining rows are processed by scalar code.
+
+    Padding entries carry the value zero and a valid column index, so no branches are required in the inner loops.
+*/
+
+#include "viennacl/forwards.h"
+#include "viennacl/linalg/host_based/cpu_dispatch.hpp"
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+namespace detail
+{
+
+//
+// Kernels for y[0:C] = A_block * x, where the block A_block has C = rows_per_block rows and num_columns columns stored column by column.
+// x must be unit-stride.
+//
+
+template<typename NumericT, typename IndexT>
+void sell_block_kernel_scalar(vcl_size_t rows_per_block, vcl_size_t num_columns,
+                              NumericT const * elements, IndexT const * column_indices,
+                              NumericT const * x, NumericT * y)
+{
+  for (vcl_size_t r = 0; r < rows_per_block; ++r)
+    y[r] = 0;
+
+  for (vcl_size_t j = 0; j < num_columns; ++j)
+  {
+    NumericT const * e = elements       + j * rows_per_block;
+    IndexT   const * c = column_indices + j * rows_per_block;
+    for (vcl_size_t r = 0; r < rows_per_block; ++r)
+      y[r] += e[r] * x[c[r]];
+  }
+}
+
+/** @brief Processes the rows [row_begin, rows_per_block) of a block with scalar code. Used for the rows not filling a SIMD vector. */
+template<typename NumericT, typename IndexT>
+void sell_block_kernel_remainder(vcl_size_t row_begin, vcl_size_t rows_per_block, vcl_size_t num_columns,
+                                 NumericT const * elements, IndexT const * column_indices,
+                                 NumericT const * x, NumericT * y)
+{
+  for (vcl_size_t r = row_begin; r < rows_per_block; ++r)
+  {
+    NumericT temp = 0;
+    for (vcl_size_t j = 0; j < num_columns; ++j)
+      temp += elements[j * rows_per_block + r] * x[column_indices[j * rows_per_block + r]];
+    y[r] = temp;
+  }
+}
+
+// The gather instructions interpret the column indices as signed 32-bit integers, hence the SIMD variants require fewer than 2^31 columns.
+// The masked gathers with all lanes enabled avoid reading an undefined source register (and the resulting compiler warnings).
+#ifdef VIENNACL_HOST_X86_SIMD
+VIENNACL_HOST_TARGET_AVX2
+inline void sell_block_kernel_avx2(vcl_size_t rows_per_block, vcl_size_t num_columns,
+                                   double const * elements, unsigned int const * column_indices,
+                                   double const * x, double * y)
+{
+  __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+  vcl_size_t r = 0;
+  for (; r + 4 <= rows_per_block; r += 4)
+  {
+    __m256d temp = _mm256_setzero_pd();
+    for (vcl_size_t j = 0; j < num_columns; ++j)
+    {
+      vcl_size_t offset = j * rows_per_block + r;
+      __m128i cols = _mm_loadu_si128(reinterpret_cast<__m128i const *>(column_indices + offset));
+      temp = _mm256_fmadd_pd(_mm256_loadu_pd(elements + offset), _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, cols, all, 8), temp);
+    }
+    _mm256_storeu_pd(y + r, temp);
+  }
+  sell_block_kernel_remainder(r, rows_per_block, num_columns, elements, column_indices, x, y);
+}
+
+VIENNACL_HOST_TARGET_AVX2
+inline void sell_block_kernel_avx2(vcl_size_t rows_per_block, vcl_size_t num_columns,
+                                   float const * elements, unsigned int const * column_indices,
+                                   float const * x, float * y)
+{
+  __m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+  vcl_size_t r = 0;
+  for (; r + 8 <= rows_per_block; r += 8)
+  {
+    __m256 temp = _mm256_setzero_ps();
+    for (vcl_size_t j = 0; j < num_columns; ++j)
+    {
+      vcl_size_t offset = j * rows_per_block + r;
+      __m256i cols = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(column_indices + offset));
+      temp = _mm256_fmadd_ps(_mm256_loadu_ps(elements + offset), _mm256_mask_i32gather_ps(_mm256_setzero_ps(), x, cols, all, 4), temp);
+    }
+    _mm256_storeu_ps(y + r, temp);
+  }
+  sell_block_kernel_remainder(r, rows_per_block, num_columns, elements, column_indices, x, y);
+}
+
+VIENNACL_HOST_TARGET_AVX512
+inline void sell_block_kernel_avx512(vcl_size_t rows_per_block, vcl_size_t num_columns,
+                                     double const * elements, unsigned int const * column_indices,
+                                     double const * x, double * y)
+{
+  vcl_size_t r = 0;
+  for (; r + 8 <= rows_per_block; r += 8)
+  {
+    __m512d temp = _mm512_setzero_pd();
+    for (vcl_size_t j = 0; j < num_columns; ++j)
+    {
+      vcl_size_t offset = j * rows_per_block + r;
+      __m256i cols = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(column_indices + offset));
+      temp = _mm512_fmadd_pd(_mm512_loadu_pd(elements + offset), _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, cols, x, 8), temp);
+    }
+    _mm512_storeu_pd(y + r, temp);
+  }
+  sell_block_kernel_remainder(r, rows_per_block, num_columns, elements, column_indices, x, y);
+}
+
+VIENNACL_HOST_TARGET_AVX512
+inline void sell_block_kernel_avx512(vcl_size_t rows_per_block, vcl_size_t num_columns,
+                                     float const * elements, unsigned int const * column_indices,
+                                     float const * x, float * y)
+{
+  vcl_size_t r = 0;
+  for (; r + 16 <= rows_per_block; r += 16)
+  {
+    __m512 temp = _mm512_setzero_ps();
+    for (vcl_size_t j = 0; j < num_columns; ++j)
+    {
+      vcl_size_t offset = j * rows_per_block + r;
+      __m512i cols = _mm512_loadu_si512(reinterpret_cast<void const *>(column_indices + offset));
+      temp = _mm512_fmadd_ps(_mm512_loadu_ps(elements + offset), _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, cols, x, 4), temp);
+    }
+    _mm512_storeu_ps(y + r, temp);
+  }
+  sell_block_kernel_remainder(r, rows_per_block, num_columns, elements, column_indices, x, y);
+}
+#endif
+
+template<typename NumericT, typename IndexT>
+struct sell_block_kernel
+{
+  typedef void (*type)(vcl_size_t, vcl_size_t, NumericT const *, IndexT const *, NumericT const *, NumericT *);
+};
+
+#ifdef VIENNACL_HOST_X86_SIMD
+  #define VIENNACL_SELL_BLOCK_KERNEL_VARIANTS  .add(cpu_isa_avx2,   sell_block_kernel_avx2) \
+                                               .add(cpu_isa_avx512, sell_block_kernel_avx512)
+#else
+  #define VIENNACL_SELL_BLOCK_KERNEL_VARIANTS
+#endif
+
+/** @brief Returns the block kernel for the provided value and index type. SIMD variants are available for float and double with 32-bit indices only. */
+template<typename NumericT, typename IndexT>
+typename sell_block_kernel<NumericT, IndexT>::type get_sell_block_kernel(NumericT const *, IndexT const *)
+{
+  return sell_block_kernel_scalar<NumericT, IndexT>;
+}
+
+inline sell_block_kernel<float, unsigned int>::type get_sell_block_kernel(float const *, unsigned int const *)
+{
+  static cpu_dispatcher<sell_block_kernel<float, unsigned int>::type> const dispatcher
+    = cpu_dispatcher<sell_block_kernel<float, unsigned int>::type>("sell_spmv<float>", sell_block_kernel_scalar<float, unsigned int>) VIENNACL_SELL_BLOCK_KERNEL_VARIANTS;
+  return dispatcher.get();
+}
+
+inline sell_block_kernel<double, unsigned int>::type get_sell_block_kernel(double const *, unsigned int const *)
+{
+  static cpu_dispatcher<sell_block_kernel<double, unsigned int>::type> const dispatcher
+    = cpu_dispatcher<sell_block_kernel<double, unsigned int>::type>("sell_spmv<double>", sell_block_kernel_scalar<double, unsigned int>) VIENNACL_SELL_BLOCK_KERNEL_VARIANTS;
+  return dispatcher.get();
+}
+
+#undef VIENNACL_SELL_BLOCK_KERNEL_VARIANTS
+
+} // namespace detail
+} // namespace host_based
+} // namespace linalg
+} // namespace viennacl
+
+#endif
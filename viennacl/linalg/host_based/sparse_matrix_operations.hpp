@@ -30,13 +30,42 @@
 #include "viennacl/linalg/host_based/vector_operations.hpp"
 
 #include "viennacl/linalg/host_based/spgemm_vector.hpp"
+#include "viennacl/linalg/host_based/spgemm_accumulator.hpp"
+#include "viennacl/linalg/host_based/sell_spmv.hpp"
+#include "viennacl/linalg/host_based/bsr_spmv.hpp"
 
+#include <algorithm>
+#include <map>
 #include <vector>
 
 #ifdef VIENNACL_WITH_OPENMP
 #include <omp.h>
 #endif
 
+// Imbalance (largest work per thread relative to the average) of the row partition above which CSR matrix-vector products use a merge-path decomposition:
+#ifndef VIENNACL_HOST_CSR_MERGE_PATH_IMBALANCE
+  #define VIENNACL_HOST_CSR_MERGE_PATH_IMBALANCE  1.25
+#endif
+
+// Minimum work (nonzeros plus rows) per thread for CSR products. Smaller matrices use fewer threads, avoiding the threading overhead where it does not pay off:
+#ifndef VIENNACL_HOST_CSR_MIN_WORK_PER_THREAD
+  #define VIENNACL_HOST_CSR_MIN_WORK_PER_THREAD  4096
+#endif
+
+// A row of a CSR matrix is considered dense if it has at least VIENNACL_HOST_CSR_DENSE_ROW_MIN_LENGTH entries and more than VIENNACL_HOST_CSR_DENSE_ROW_RATIO times the average number of entries per row:
+#ifndef VIENNACL_HOST_CSR_DENSE_ROW_MIN_LENGTH
+  #define VIENNACL_HOST_CSR_DENSE_ROW_MIN_LENGTH  1024
+#endif
+
+#ifndef VIENNACL_HOST_CSR_DENSE_ROW_RATIO
+  #define VIENNACL_HOST_CSR_DENSE_ROW_RATIO  32
+#endif
+
+// Number of columns of the result computed at once in registers by products of CSR matrices with dense matrices:
+#ifndef VIENNACL_HOST_SPMM_TILE_WIDTH
+  #define VIENNACL_HOST_SPMM_TILE_WIDTH  8
+#endif
+
 namespace viennacl
 {
 namespace linalg
@@ -49,41 +78,41 @@ namespace host_based
 
 namespace detail
 {
-  template<typename NumericT, unsigned int AlignmentV>
-  void row_info(compressed_matrix<NumericT, AlignmentV> const & mat,
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void row_info(compressed_matrix<NumericT, AlignmentV, IndexT> const & mat,
                 vector_base<NumericT> & vec,
                 viennacl::linalg::detail::row_info_types info_selector)
   {
     NumericT         * result_buf = detail::extract_raw_pointer<NumericT>(vec.handle());
     NumericT   const * elements   = detail::extract_raw_pointer<NumericT>(mat.handle());
-    unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
-    unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
+    IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(mat.handle1());
+    IndexT const * col_buffer = detail::extract_raw_pointer<IndexT>(mat.handle2());
 
     for (vcl_size_t row = 0; row < mat.size1(); ++row)
     {
       NumericT value = 0;
-      unsigned int row_end = row_buffer[row+1];
+      IndexT row_end = row_buffer[row+1];
 
       switch (info_selector)
       {
         case viennacl::linalg::detail::SPARSE_ROW_NORM_INF: //inf-norm
-          for (unsigned int i = row_buffer[row]; i < row_end; ++i)
+          for (IndexT i = row_buffer[row]; i < row_end; ++i)
             value = std::max<NumericT>(value, std::fabs(elements[i]));
           break;
 
         case viennacl::linalg::detail::SPARSE_ROW_NORM_1: //1-norm
-          for (unsigned int i = row_buffer[row]; i < row_end; ++i)
+          for (IndexT i = row_buffer[row]; i < row_end; ++i)
             value += std::fabs(elements[i]);
           break;
 
         case viennacl::linalg::detail::SPARSE_ROW_NORM_2: //2-norm
-          for (unsigned int i = row_buffer[row]; i < row_end; ++i)
+          for (IndexT i = row_buffer[row]; i < row_end; ++i)
             value += elements[i] * elements[i];
           value = std::sqrt(value);
           break;
 
         case viennacl::linalg::detail::SPARSE_ROW_DIAGONAL: //diagonal entry
-          for (unsigned int i = row_buffer[row]; i < row_end; ++i)
+          for (IndexT i = row_buffer[row]; i < row_end; ++i)
           {
             if (col_buffer[i] == row)
             {
@@ -99,39 +128,378 @@ namespace detail
 }
 
 
-/** @brief Carries out matrix-vector multiplication with a compressed_matrix, optimized for contiguous access
-*
-* Implementation of the convenience expression result = prod(mat, vec);
-*
-* @param mat    The matrix
-* @param vec    The vector
-* @param result The result vector
-*/
-template<typename NumericT, unsigned int AlignmentV>
-void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & mat,
-               const viennacl::vector_base<NumericT> & vec,
-               viennacl::vector_base<NumericT> & result)
+namespace detail
 {
-  NumericT           * result_buf = detail::extract_raw_pointer<NumericT>(result.handle());
-  NumericT     const * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
-  NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(mat.handle());
-  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
-  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
+  /** @brief Computes the row statistics of a compressed_matrix. The caller must hold the lock on the cached statistics. */
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void compute_row_statistics(compressed_matrix<NumericT, AlignmentV, IndexT> const & A, viennacl::detail::csr_row_statistics & stats)
+  {
+    IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(A.handle1());
+    vcl_size_t rows = A.size1();
+    vcl_size_t nnz  = (rows > 0) ? row_buffer[rows] : 0;
+
+    vcl_size_t max_row_length = 0;
+    for (vcl_size_t row = 0; row < rows; ++row)
+      max_row_length = std::max<vcl_size_t>(max_row_length, row_buffer[row+1] - row_buffer[row]);
+
+    stats.max_row_length = max_row_length;
+    stats.avg_row_length = (rows > 0) ? double(nnz) / double(rows) : 0.0;
+    stats.dense_rows.clear();
+    stats.partitions.clear();
+    if (max_row_length >= VIENNACL_HOST_CSR_DENSE_ROW_MIN_LENGTH && double(max_row_length) > VIENNACL_HOST_CSR_DENSE_ROW_RATIO * stats.avg_row_length)
+    {
+      for (vcl_size_t row = 0; row < rows; ++row)
+      {
+        vcl_size_t row_length = row_buffer[row+1] - row_buffer[row];
+        if (row_length >= VIENNACL_HOST_CSR_DENSE_ROW_MIN_LENGTH && double(row_length) > VIENNACL_HOST_CSR_DENSE_ROW_RATIO * stats.avg_row_length)
+          stats.dense_rows.push_back(row);
+      }
+    }
+    stats.valid = true;
+  }
 
+  /** @brief Computes the partition of the rows of a compressed_matrix into blocks of about equal work (nonzeros plus rows) for the provided number of threads.
+  *
+  * Dense rows only contribute their row overhead, since their entries are meant to be processed jointly by all threads.
+  * Matrices with less than VIENNACL_HOST_CSR_MIN_WORK_PER_THREAD work per thread are split into fewer blocks.
+  *
+  * @param A             The matrix
+  * @param stats         The (valid) row statistics of A
+  * @param thread_count  Maximum number of threads
+  * @param partition     The partition to be filled
+  */
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void compute_row_partition(compressed_matrix<NumericT, AlignmentV, IndexT> const & A, viennacl::detail::csr_row_statistics const & stats,
+                             vcl_size_t thread_count, viennacl::detail::csr_row_partition & partition)
+  {
+    IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(A.handle1());
+    vcl_size_t rows = A.size1();
+    std::vector<vcl_size_t> const & dense_rows = stats.dense_rows;
+
+    vcl_size_t total_work = rows + ((rows > 0) ? row_buffer[rows] : 0);
+    for (vcl_size_t i = 0; i < dense_rows.size(); ++i)
+      total_work -= row_buffer[dense_rows[i] + 1] - row_buffer[dense_rows[i]];
+
+    vcl_size_t blocks = std::max<vcl_size_t>(1, std::min<vcl_size_t>(thread_count, total_work / VIENNACL_HOST_CSR_MIN_WORK_PER_THREAD));
+
+    partition.row_offsets.resize(blocks + 1);
+    partition.row_offsets[0] = 0;
+
+    vcl_size_t block = 1;
+    vcl_size_t work = 0;
+    vcl_size_t block_work = 0;
+    vcl_size_t max_block_work = 0;
+    std::vector<vcl_size_t>::const_iterator next_dense_row = dense_rows.begin();
+    for (vcl_size_t row = 0; row < rows; ++row)
+    {
+      while (block < blocks && work >= (total_work * block) / blocks)
+      {
+        partition.row_offsets[block++] = row;
+        max_block_work = std::max(max_block_work, block_work);
+        block_work = 0;
+      }
+
+      vcl_size_t row_work = 1;
+      if (next_dense_row != dense_rows.end() && *next_dense_row == row)
+        ++next_dense_row;
+      else
+        row_work += row_buffer[row+1] - row_buffer[row];
+      work       += row_work;
+      block_work += row_work;
+    }
+    max_block_work = std::max(max_block_work, block_work);
+    for (; block <= blocks; ++block)
+      partition.row_offsets[block] = rows;
+
+    partition.imbalance = (total_work > 0) ? double(max_block_work) * double(blocks) / double(total_work) : 1.0;
+  }
+
+  /** @brief Returns the row statistics of a compressed_matrix on the host, computing the cached values if required.
+  *
+  * The cache is filled under a lock, so products with the same matrix may be issued concurrently from several threads.
+  */
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  viennacl::detail::csr_row_statistics const & row_statistics(compressed_matrix<NumericT, AlignmentV, IndexT> const & A)
+  {
+    viennacl::detail::csr_row_statistics & stats = A.row_statistics();
 #ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
+    #pragma omp critical(viennacl_csr_row_statistics)
 #endif
-  for (long row = 0; row < static_cast<long>(mat.size1()); ++row)
+    {
+      if (!stats.valid)
+        compute_row_statistics(A, stats);
+    }
+    return stats;
+  }
+
+  /** @brief Returns the cached partition of the rows of a compressed_matrix for the provided number of threads, computing it along with the row statistics if required.
+  *
+  * Entries of the cache are never removed while the sparsity pattern is unchanged, hence the returned reference remains valid when partitions for other thread counts are added concurrently.
+  */
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  viennacl::detail::csr_row_partition const & row_partition(compressed_matrix<NumericT, AlignmentV, IndexT> const & A, vcl_size_t thread_count)
   {
-    NumericT dot_prod = 0;
+    viennacl::detail::csr_row_statistics & stats = A.row_statistics();
+    viennacl::detail::csr_row_partition * partition = NULL;
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp critical(viennacl_csr_row_statistics)
+#endif
+    {
+      if (!stats.valid)
+        compute_row_statistics(A, stats);
+
+      std::map<vcl_size_t, viennacl::detail::csr_row_partition>::iterator it = stats.partitions.find(thread_count);
+      if (it == stats.partitions.end())
+      {
+        it = stats.partitions.insert(std::make_pair(thread_count, viennacl::detail::csr_row_partition())).first;
+        compute_row_partition(A, stats, thread_count, it->second);
+      }
+      partition = &(it->second);
+    }
+    return *partition;
+  }
+
+  /** @brief Sparse matrix-vector product result = alpha * A * x + beta * result using a merge-path decomposition.
+  *
+  * The merge of the row end offsets with the nonzero indices is split into equally sized pieces, one per thread, so that each thread processes the same number of rows plus nonzeros.
+  * Partial sums of rows split across threads are carried out and added in a serial fixup step. This keeps all threads busy even if a few rows hold a large fraction of the nonzeros.
+  */
+  template<typename NumericT, typename IndexT>
+  void csr_merge_path_prod(IndexT const * row_buffer, IndexT const * col_buffer, NumericT const * elements, vcl_size_t rows,
+                           NumericT const * x, vcl_size_t inc_x,
+                           NumericT       * y, vcl_size_t inc_y,
+                           NumericT alpha, NumericT beta, vcl_size_t thread_count)
+  {
+    vcl_size_t nnz = row_buffer[rows];
+    std::vector<vcl_size_t> carry_row(thread_count, rows);
+    std::vector<NumericT>   carry_value(thread_count, NumericT(0));
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel
+#endif
+    {
+      vcl_size_t id = 0;
+      vcl_size_t num_threads = 1;
+#ifdef VIENNACL_WITH_OPENMP
+      id          = static_cast<vcl_size_t>(omp_get_thread_num());
+      num_threads = static_cast<vcl_size_t>(omp_get_num_threads());
+#endif
+      vcl_size_t path_length   = rows + nnz;
+      vcl_size_t diagonal_begin = std::min(path_length, (path_length * id) / num_threads);
+      vcl_size_t diagonal_end   = std::min(path_length, (path_length * (id + 1)) / num_threads);
+
+      // find the coordinates (row, nonzero index) on the merge path for the start and the end of the thread's piece:
+      vcl_size_t coords[2][2];
+      vcl_size_t diagonals[2] = { diagonal_begin, diagonal_end };
+      for (vcl_size_t k = 0; k < 2; ++k)
+      {
+        vcl_size_t d = diagonals[k];
+        vcl_size_t lower = (d > nnz) ? d - nnz : 0;
+        vcl_size_t upper = std::min(d, rows);
+        while (lower < upper) // binary search along the diagonal
+        {
+          vcl_size_t pivot = (lower + upper) / 2;
+          if (row_buffer[pivot + 1] <= d - pivot - 1)
+            lower = pivot + 1;
+          else
+            upper = pivot;
+        }
+        coords[k][0] = lower;
+        coords[k][1] = d - lower;
+      }
+
+      vcl_size_t row       = coords[0][0];
+      vcl_size_t index     = coords[0][1];
+      vcl_size_t row_end   = coords[1][0];
+      vcl_size_t index_end = coords[1][1];
+
+      // rows completed by this thread:
+      for (; row < row_end; ++row)
+      {
+        NumericT dot_prod = 0;
+        vcl_size_t next_row_start = row_buffer[row + 1];
+        for (; index < next_row_start; ++index)
+          dot_prod += elements[index] * x[col_buffer[index] * inc_x];
+
+        NumericT & y_row = y[row * inc_y];
+        y_row = (beta < 0 || beta > 0) ? alpha * dot_prod + beta * y_row : alpha * dot_prod;
+      }
+
+      // partial row at the end of the piece:
+      NumericT dot_prod = 0;
+      for (; index < index_end; ++index)
+        dot_prod += elements[index] * x[col_buffer[index] * inc_x];
+      carry_row[id]   = row_end;
+      carry_value[id] = dot_prod;
+    }
+
+    for (vcl_size_t id = 0; id < thread_count; ++id)
+      if (carry_row[id] < rows)
+        y[carry_row[id] * inc_y] += alpha * carry_value[id];
+  }
+
+  /** @brief Raw pointer and strides of a dense matrix (or its transpose), such that entry (i, j) is located at data[i * stride1 + j * stride2] */
+  template<typename NumericT>
+  struct strided_dense_matrix
+  {
+    template<typename MatrixT>
+    strided_dense_matrix(MatrixT & A, bool trans) : data(detail::extract_raw_pointer<NumericT>(A))
+    {
+      vcl_size_t inc1 = viennacl::traits::stride1(A);
+      vcl_size_t inc2 = viennacl::traits::stride2(A);
+      if (A.row_major())
+      {
+        data   += viennacl::traits::start1(A) * A.internal_size2() + viennacl::traits::start2(A);
+        stride1 = inc1 * A.internal_size2();
+        stride2 = inc2;
+      }
+      else
+      {
+        data   += viennacl::traits::start1(A) + viennacl::traits::start2(A) * A.internal_size1();
+        stride1 = inc1;
+        stride2 = inc2 * A.internal_size1();
+      }
+      if (trans)
+        std::swap(stride1, stride2);
+    }
+
+    NumericT * data;
+    vcl_size_t stride1;
+    vcl_size_t stride2;
+  };
+
+  /** @brief Computes a tile of VIENNACL_HOST_SPMM_TILE_WIDTH consecutive columns of a row of C = alpha * A * B + beta * C in registers.
+  *
+  * The entries of the row of A are streamed once per tile. If B_contiguous is true, the columns of the tile are adjacent in memory (unit stride2 of B), which allows the compiler to vectorize the inner loop.
+  */
+  template<bool B_contiguous, typename NumericT, typename IndexT>
+  void csr_dense_matrix_prod_tile(NumericT const * elements, IndexT const * col_buffer, vcl_size_t row_start, vcl_size_t row_end,
+                                  NumericT const * B, vcl_size_t B_stride1, vcl_size_t B_stride2,
+                                  NumericT * C, vcl_size_t C_stride2, NumericT alpha, NumericT beta)
+  {
+    NumericT tile[VIENNACL_HOST_SPMM_TILE_WIDTH];
+    for (vcl_size_t j = 0; j < VIENNACL_HOST_SPMM_TILE_WIDTH; ++j)
+      tile[j] = 0;
+
+    for (vcl_size_t k = row_start; k < row_end; ++k)
+    {
+      NumericT a = elements[k];
+      NumericT const * B_row = B + col_buffer[k] * B_stride1;
+      if (B_contiguous)
+        for (vcl_size_t j = 0; j < VIENNACL_HOST_SPMM_TILE_WIDTH; ++j)
+          tile[j] += a * B_row[j];
+      else
+        for (vcl_size_t j = 0; j < VIENNACL_HOST_SPMM_TILE_WIDTH; ++j)
+          tile[j] += a * B_row[j * B_stride2];
+    }
+
+    if (beta < 0 || beta > 0)
+      for (vcl_size_t j = 0; j < VIENNACL_HOST_SPMM_TILE_WIDTH; ++j)
+        C[j * C_stride2] = alpha * tile[j] + beta * C[j * C_stride2];
+    else
+      for (vcl_size_t j = 0; j < VIENNACL_HOST_SPMM_TILE_WIDTH; ++j)
+        C[j * C_stride2] = alpha * tile[j];
+  }
 
-    unsigned int row_end = row_buffer[row+1];
-    for (unsigned int i = row_buffer[row]; i < row_end; ++i)
-      dot_prod += elements[i] * vec_buf[col_buffer[i]];
+  /** @brief Computes the columns [col_begin, col_end) of a row of C = alpha * A * B + beta * C, using register tiles for all full tiles. */
+  template<typename NumericT, typename IndexT>
+  void csr_dense_matrix_prod_row(NumericT const * elements, IndexT const * col_buffer, vcl_size_t row_start, vcl_size_t row_end,
+                                 strided_dense_matrix<NumericT const> const & B, vcl_size_t col_begin, vcl_size_t col_end,
+                                 NumericT * C_row, vcl_size_t C_stride2, NumericT alpha, NumericT beta)
+  {
+    vcl_size_t col = col_begin;
+    for (; col + VIENNACL_HOST_SPMM_TILE_WIDTH <= col_end; col += VIENNACL_HOST_SPMM_TILE_WIDTH)
+    {
+      if (B.stride2 == 1)
+        csr_dense_matrix_prod_tile<true>(elements, col_buffer, row_start, row_end, B.data + col, B.stride1, B.stride2, C_row + col * C_stride2, C_stride2, alpha, beta);
+      else
+        csr_dense_matrix_prod_tile<false>(elements, col_buffer, row_start, row_end, B.data + col * B.stride2, B.stride1, B.stride2, C_row + col * C_stride2, C_stride2, alpha, beta);
+    }
 
-    result_buf[row] = dot_prod;
+    // remaining columns:
+    for (; col < col_end; ++col)
+    {
+      NumericT const * B_col = B.data + col * B.stride2;
+      NumericT temp = 0;
+      for (vcl_size_t k = row_start; k < row_end; ++k)
+        temp += elements[k] * B_col[col_buffer[k] * B.stride1];
+      NumericT & C_entry = C_row[col * C_stride2];
+      C_entry = (beta < 0 || beta > 0) ? alpha * temp + beta * C_entry : alpha * temp;
+    }
   }
 
+  /** @brief Sparse matrix-dense matrix product C = alpha * A * B + beta * C with the rows of A processed in the blocks of the cached row partition.
+  *
+  * Each row of C is computed in register tiles of VIENNACL_HOST_SPMM_TILE_WIDTH columns, so the row of A is streamed once per tile rather than once per column.
+  * Dense rows of A are processed separately with the tiles of C split across all threads.
+  * All combinations of row- and column-major storage (and transposition of B) are handled through the strides of B and C.
+  *
+  * @param A      The sparse matrix
+  * @param B      The dense matrix (possibly transposed)
+  * @param B_cols Number of columns of B
+  * @param alpha  Scaling factor for the product
+  * @param C      The result matrix
+  * @param beta   Scaling factor for the previous content of C. If zero, C is not read.
+  */
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void csr_dense_matrix_prod(compressed_matrix<NumericT, AlignmentV, IndexT> const & A,
+                             strided_dense_matrix<NumericT const> const & B, vcl_size_t B_cols,
+                             NumericT alpha,
+                             strided_dense_matrix<NumericT> const & C,
+                             NumericT beta)
+  {
+    NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(A.handle());
+    IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(A.handle1());
+    IndexT const * col_buffer = detail::extract_raw_pointer<IndexT>(A.handle2());
+
+    if (A.size1() == 0 || B_cols == 0)
+      return;
+
+    vcl_size_t thread_count = 1;
+#ifdef VIENNACL_WITH_OPENMP
+    thread_count = static_cast<vcl_size_t>(omp_get_max_threads());
+#endif
+
+    viennacl::detail::csr_row_partition const & partition = detail::row_partition(A, thread_count);
+    long blocks = static_cast<long>(partition.row_offsets.size()) - 1;
+
+    std::vector<vcl_size_t> no_dense_rows;
+    std::vector<vcl_size_t> const & dense_rows = (blocks > 1) ? A.row_statistics().dense_rows : no_dense_rows;
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for num_threads(static_cast<int>(blocks)) if (blocks > 1)
+#endif
+    for (long block = 0; block < blocks; ++block)
+    {
+      vcl_size_t block_begin = partition.row_offsets[static_cast<vcl_size_t>(block)];
+      vcl_size_t block_end   = partition.row_offsets[static_cast<vcl_size_t>(block) + 1];
+      std::vector<vcl_size_t>::const_iterator next_dense_row = std::lower_bound(dense_rows.begin(), dense_rows.end(), block_begin);
+      for (vcl_size_t row = block_begin; row < block_end; ++row)
+      {
+        if (next_dense_row != dense_rows.end() && *next_dense_row == row)
+        {
+          ++next_dense_row;
+          continue;
+        }
+
+        csr_dense_matrix_prod_row(elements, col_buffer, row_buffer[row], row_buffer[row+1], B, 0, B_cols,
+                                  C.data + row * C.stride1, C.stride2, alpha, beta);
+      }
+    }
+
+    // dense rows: split the tiles of the result across threads
+    vcl_size_t tiles_per_row = (B_cols - 1) / VIENNACL_HOST_SPMM_TILE_WIDTH + 1;
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for
+#endif
+    for (long i = 0; i < static_cast<long>(dense_rows.size() * tiles_per_row); ++i)
+    {
+      vcl_size_t row       = dense_rows[static_cast<vcl_size_t>(i) / tiles_per_row];
+      vcl_size_t col_begin = (static_cast<vcl_size_t>(i) % tiles_per_row) * VIENNACL_HOST_SPMM_TILE_WIDTH;
+      csr_dense_matrix_prod_row(elements, col_buffer, row_buffer[row], row_buffer[row+1], B, col_begin, std::min<vcl_size_t>(col_begin + VIENNACL_HOST_SPMM_TILE_WIDTH, B_cols),
+                                C.data + row * C.stride1, C.stride2, alpha, beta);
+    }
+  }
 }
 
 /** @brief Carries out matrix-vector multiplication with a compressed_matrix
@@ -142,132 +510,147 @@ void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & mat,
 * @param vec    The vector
 * @param result The result vector
 */
-template<typename NumericT, unsigned int AlignmentV>
-void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & mat,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & mat,
+               const viennacl::vector_base<NumericT> & vec,
+               viennacl::vector_base<NumericT> & result)
+{
+  prod_impl(mat, vec, NumericT(1), result, NumericT(0));
+}
+
+/** @brief Carries out matrix-vector multiplication with a compressed_matrix
+*
+* Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+*
+* Rows are split into blocks of about equal work using the partition cached with the matrix. If the matrix has dense rows or the partition is poorly balanced (e.g. for power-law matrices), a merge-path decomposition is used instead.
+*
+* @param mat    The matrix
+* @param vec    The vector
+* @param alpha  Scaling factor for the matrix-vector product
+* @param result The result vector
+* @param beta   Scaling factor for the previous content of result. If zero, result is not read.
+*/
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & mat,
                const viennacl::vector_base<NumericT> & vec,
                NumericT alpha,
                viennacl::vector_base<NumericT> & result,
                NumericT beta)
 {
-  if (   alpha <= NumericT(1) && alpha >= NumericT(1)
-      &&  beta <= NumericT(0) &&  beta >= NumericT(0)
-      && vec.start() == 0 && vec.stride() == 1
-      && result.start() == 0 && result.stride() == 0)
+  NumericT           * result_buf = detail::extract_raw_pointer<NumericT>(result.handle()) + result.start();
+  NumericT     const * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle()) + vec.start();
+  NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(mat.handle());
+  IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(mat.handle1());
+  IndexT const * col_buffer = detail::extract_raw_pointer<IndexT>(mat.handle2());
+  vcl_size_t inc_vec    = vec.stride();
+  vcl_size_t inc_result = result.stride();
+
+  if (mat.size1() == 0)
+    return;
+
+  vcl_size_t thread_count = 1;
+#ifdef VIENNACL_WITH_OPENMP
+  thread_count = static_cast<vcl_size_t>(omp_get_max_threads());
+#endif
+
+  viennacl::detail::csr_row_partition const & partition = detail::row_partition(mat, thread_count);
+  long blocks = static_cast<long>(partition.row_offsets.size()) - 1;
+
+  if (blocks > 1 && (!mat.row_statistics().dense_rows.empty() || partition.imbalance > VIENNACL_HOST_CSR_MERGE_PATH_IMBALANCE))
   {
-    prod_impl(mat, vec, result);
+    detail::csr_merge_path_prod(row_buffer, col_buffer, elements, mat.size1(), vec_buf, inc_vec, result_buf, inc_result, alpha, beta, thread_count);
     return;
   }
 
-  NumericT           * result_buf = detail::extract_raw_pointer<NumericT>(result.handle());
-  NumericT     const * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
-  NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(mat.handle());
-  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
-  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
-
 #ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
+  #pragma omp parallel for num_threads(static_cast<int>(blocks)) if (blocks > 1)
 #endif
-  for (long row = 0; row < static_cast<long>(mat.size1()); ++row)
+  for (long block = 0; block < blocks; ++block)
   {
-    NumericT dot_prod = 0;
-    vcl_size_t row_end = row_buffer[row+1];
-    for (vcl_size_t i = row_buffer[row]; i < row_end; ++i)
-      dot_prod += elements[i] * vec_buf[col_buffer[i] * vec.stride() + vec.start()];
-
-    if (beta < 0 || beta > 0)
+    vcl_size_t block_end = partition.row_offsets[static_cast<vcl_size_t>(block) + 1];
+    for (vcl_size_t row = partition.row_offsets[static_cast<vcl_size_t>(block)]; row < block_end; ++row)
     {
-      vcl_size_t index = static_cast<vcl_size_t>(row) * result.stride() + result.start();
-      result_buf[index] = alpha * dot_prod + beta * result_buf[index];
+      NumericT dot_prod = 0;
+      vcl_size_t row_end = row_buffer[row+1];
+      if (inc_vec == 1)
+        for (vcl_size_t i = row_buffer[row]; i < row_end; ++i)
+          dot_prod += elements[i] * vec_buf[col_buffer[i]];
+      else
+        for (vcl_size_t i = row_buffer[row]; i < row_end; ++i)
+          dot_prod += elements[i] * vec_buf[col_buffer[i] * inc_vec];
+
+      NumericT & result_row = result_buf[row * inc_result];
+      result_row = (beta < 0 || beta > 0) ? alpha * dot_prod + beta * result_row : alpha * dot_prod;
     }
-    else
-      result_buf[static_cast<vcl_size_t>(row) * result.stride() + result.start()] = alpha * dot_prod;
   }
 
 }
 
 /** @brief Carries out sparse_matrix-matrix multiplication first matrix being compressed
 *
-* Implementation of the convenience expression result = prod(sp_mat, d_mat);
+* Implementation of the convenience expression result = alpha * prod(sp_mat, d_mat) + beta * result;
 *
 * @param sp_mat     The sparse matrix
 * @param d_mat      The dense matrix
+* @param alpha      Scaling factor for the product
 * @param result     The result matrix
+* @param beta       Scaling factor for the previous content of result. If zero, result is not read.
 */
-template<typename NumericT, unsigned int AlignmentV>
-void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & sp_mat,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & sp_mat,
                const viennacl::matrix_base<NumericT> & d_mat,
-                     viennacl::matrix_base<NumericT> & result) {
-
-  NumericT     const * sp_mat_elements   = detail::extract_raw_pointer<NumericT>(sp_mat.handle());
-  unsigned int const * sp_mat_row_buffer = detail::extract_raw_pointer<unsigned int>(sp_mat.handle1());
-  unsigned int const * sp_mat_col_buffer = detail::extract_raw_pointer<unsigned int>(sp_mat.handle2());
-
-  NumericT const * d_mat_data  = detail::extract_raw_pointer<NumericT>(d_mat);
-  NumericT       * result_data = detail::extract_raw_pointer<NumericT>(result);
-
-  vcl_size_t d_mat_start1 = viennacl::traits::start1(d_mat);
-  vcl_size_t d_mat_start2 = viennacl::traits::start2(d_mat);
-  vcl_size_t d_mat_inc1   = viennacl::traits::stride1(d_mat);
-  vcl_size_t d_mat_inc2   = viennacl::traits::stride2(d_mat);
-  vcl_size_t d_mat_internal_size1  = viennacl::traits::internal_size1(d_mat);
-  vcl_size_t d_mat_internal_size2  = viennacl::traits::internal_size2(d_mat);
-
-  vcl_size_t result_start1 = viennacl::traits::start1(result);
-  vcl_size_t result_start2 = viennacl::traits::start2(result);
-  vcl_size_t result_inc1   = viennacl::traits::stride1(result);
-  vcl_size_t result_inc2   = viennacl::traits::stride2(result);
-  vcl_size_t result_internal_size1  = viennacl::traits::internal_size1(result);
-  vcl_size_t result_internal_size2  = viennacl::traits::internal_size2(result);
-
-  detail::matrix_array_wrapper<NumericT const, row_major, false>
-      d_mat_wrapper_row(d_mat_data, d_mat_start1, d_mat_start2, d_mat_inc1, d_mat_inc2, d_mat_internal_size1, d_mat_internal_size2);
-  detail::matrix_array_wrapper<NumericT const, column_major, false>
-      d_mat_wrapper_col(d_mat_data, d_mat_start1, d_mat_start2, d_mat_inc1, d_mat_inc2, d_mat_internal_size1, d_mat_internal_size2);
-
-  detail::matrix_array_wrapper<NumericT, row_major, false>
-      result_wrapper_row(result_data, result_start1, result_start2, result_inc1, result_inc2, result_internal_size1, result_internal_size2);
-  detail::matrix_array_wrapper<NumericT, column_major, false>
-      result_wrapper_col(result_data, result_start1, result_start2, result_inc1, result_inc2, result_internal_size1, result_internal_size2);
+               NumericT alpha,
+                     viennacl::matrix_base<NumericT> & result,
+               NumericT beta)
+{
+  detail::csr_dense_matrix_prod(sp_mat,
+                                detail::strided_dense_matrix<NumericT const>(d_mat, false), d_mat.size2(),
+                                alpha,
+                                detail::strided_dense_matrix<NumericT>(result, false),
+                                beta);
+}
 
-  if ( d_mat.row_major() ) {
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-    for (long row = 0; row < static_cast<long>(sp_mat.size1()); ++row) {
-      vcl_size_t row_start = sp_mat_row_buffer[row];
-      vcl_size_t row_end = sp_mat_row_buffer[row+1];
-      for (vcl_size_t col = 0; col < d_mat.size2(); ++col) {
-        NumericT temp = 0;
-        for (vcl_size_t k = row_start; k < row_end; ++k) {
-          temp += sp_mat_elements[k] * d_mat_wrapper_row(static_cast<vcl_size_t>(sp_mat_col_buffer[k]), col);
-        }
-        if (result.row_major())
-          result_wrapper_row(row, col) = temp;
-        else
-          result_wrapper_col(row, col) = temp;
-      }
-    }
-  }
-  else {
-#ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
-#endif
-    for (long col = 0; col < static_cast<long>(d_mat.size2()); ++col) {
-      for (long row = 0; row < static_cast<long>(sp_mat.size1()); ++row) {
-        vcl_size_t row_start = sp_mat_row_buffer[row];
-        vcl_size_t row_end = sp_mat_row_buffer[row+1];
-        NumericT temp = 0;
-        for (vcl_size_t k = row_start; k < row_end; ++k) {
-          temp += sp_mat_elements[k] * d_mat_wrapper_col(static_cast<vcl_size_t>(sp_mat_col_buffer[k]), static_cast<vcl_size_t>(col));
-        }
-        if (result.row_major())
-          result_wrapper_row(row, col) = temp;
-        else
-          result_wrapper_col(row, col) = temp;
-      }
-    }
-  }
+/** @brief Carries out sparse_matrix-matrix multiplication first matrix being compressed
+*
+* Implementation of the convenience expression result = prod(sp_mat, d_mat);
+*
+* @param sp_mat     The sparse matrix
+* @param d_mat      The dense matrix
+* @param result     The result matrix
+*/
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & sp_mat,
+               const viennacl::matrix_base<NumericT> & d_mat,
+                     viennacl::matrix_base<NumericT> & result)
+{
+  prod_impl(sp_mat, d_mat, NumericT(1), result, NumericT(0));
+}
 
+/** @brief Carries out matrix-trans(matrix) multiplication first matrix being compressed
+*          and the second transposed
+*
+* Implementation of the convenience expression result = alpha * prod(sp_mat, trans(d_mat)) + beta * result;
+*
+* @param sp_mat             The sparse matrix
+* @param d_mat              The transposed dense matrix
+* @param alpha              Scaling factor for the product
+* @param result             The result matrix
+* @param beta               Scaling factor for the previous content of result. If zero, result is not read.
+*/
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & sp_mat,
+               const viennacl::matrix_expression< const viennacl::matrix_base<NumericT>,
+                                                  const viennacl::matrix_base<NumericT>,
+                                                  viennacl::op_trans > & d_mat,
+               NumericT alpha,
+                     viennacl::matrix_base<NumericT> & result,
+               NumericT beta)
+{
+  detail::csr_dense_matrix_prod(sp_mat,
+                                detail::strided_dense_matrix<NumericT const>(d_mat.lhs(), true), d_mat.size2(),
+                                alpha,
+                                detail::strided_dense_matrix<NumericT>(result, false),
+                                beta);
 }
 
 /** @brief Carries out matrix-trans(matrix) multiplication first matrix being compressed
@@ -279,85 +662,324 @@ void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & sp_mat,
 * @param d_mat              The transposed dense matrix
 * @param result             The result matrix
 */
-template<typename NumericT, unsigned int AlignmentV>
-void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV> & sp_mat,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & sp_mat,
                const viennacl::matrix_expression< const viennacl::matrix_base<NumericT>,
                                                   const viennacl::matrix_base<NumericT>,
                                                   viennacl::op_trans > & d_mat,
-                viennacl::matrix_base<NumericT> & result) {
+                viennacl::matrix_base<NumericT> & result)
+{
+  prod_impl(sp_mat, d_mat, NumericT(1), result, NumericT(0));
+}
 
-  NumericT     const * sp_mat_elements   = detail::extract_raw_pointer<NumericT>(sp_mat.handle());
-  unsigned int const * sp_mat_row_buffer = detail::extract_raw_pointer<unsigned int>(sp_mat.handle1());
-  unsigned int const * sp_mat_col_buffer = detail::extract_raw_pointer<unsigned int>(sp_mat.handle2());
 
-  NumericT const *  d_mat_data = detail::extract_raw_pointer<NumericT>(d_mat.lhs());
-  NumericT       * result_data = detail::extract_raw_pointer<NumericT>(result);
+namespace detail
+{
+  /** @brief Stage 1 of the sparse matrix-matrix product C = A * B: Returns an upper bound for the number of entries in the rows of C computed by merges, which determines the size of the merge buffers. */
+  template<typename NumericT, unsigned int AlignmentV>
+  unsigned int spgemm_max_row_length(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+                                     viennacl::compressed_matrix<NumericT, AlignmentV> const & B)
+  {
+    unsigned int const * A_row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    unsigned int const * A_col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
+    unsigned int const * B_row_buffer = detail::extract_raw_pointer<unsigned int>(B.handle1());
 
-  vcl_size_t d_mat_start1 = viennacl::traits::start1(d_mat.lhs());
-  vcl_size_t d_mat_start2 = viennacl::traits::start2(d_mat.lhs());
-  vcl_size_t d_mat_inc1   = viennacl::traits::stride1(d_mat.lhs());
-  vcl_size_t d_mat_inc2   = viennacl::traits::stride2(d_mat.lhs());
-  vcl_size_t d_mat_internal_size1  = viennacl::traits::internal_size1(d_mat.lhs());
-  vcl_size_t d_mat_internal_size2  = viennacl::traits::internal_size2(d_mat.lhs());
+#if defined(VIENNACL_WITH_OPENMP)
+    unsigned int block_factor = 10;
+    unsigned int max_threads = omp_get_max_threads();
+    long chunk_size = long(A.size1()) / long(block_factor * max_threads) + 1;
+#else
+    unsigned int max_threads = 1;
+#endif
+    std::vector<unsigned int> max_length_row_C(max_threads);
 
-  vcl_size_t result_start1 = viennacl::traits::start1(result);
-  vcl_size_t result_start2 = viennacl::traits::start2(result);
-  vcl_size_t result_inc1   = viennacl::traits::stride1(result);
-  vcl_size_t result_inc2   = viennacl::traits::stride2(result);
-  vcl_size_t result_internal_size1  = viennacl::traits::internal_size1(result);
-  vcl_size_t result_internal_size2  = viennacl::traits::internal_size2(result);
+#if defined(VIENNACL_WITH_OPENMP)
+    #pragma omp parallel for schedule(dynamic, chunk_size)
+#endif
+    for (long i=0; i<long(A.size1()); ++i)
+    {
+      unsigned int row_start_A = A_row_buffer[i];
+      unsigned int row_end_A   = A_row_buffer[i+1];
 
-  detail::matrix_array_wrapper<NumericT const, row_major, false>
-      d_mat_wrapper_row(d_mat_data, d_mat_start1, d_mat_start2, d_mat_inc1, d_mat_inc2, d_mat_internal_size1, d_mat_internal_size2);
-  detail::matrix_array_wrapper<NumericT const, column_major, false>
-      d_mat_wrapper_col(d_mat_data, d_mat_start1, d_mat_start2, d_mat_inc1, d_mat_inc2, d_mat_internal_size1, d_mat_internal_size2);
+      unsigned int row_C_upper_bound_row = spgemm_row_upper_bound(row_start_A, row_end_A, A_col_buffer, B_row_buffer);
+      if (spgemm_select_row_method(row_end_A - row_start_A, row_C_upper_bound_row, static_cast<unsigned int>(B.size2())) != SPGEMM_ROW_MERGE)
+        continue;
 
-  detail::matrix_array_wrapper<NumericT, row_major, false>
-      result_wrapper_row(result_data, result_start1, result_start2, result_inc1, result_inc2, result_internal_size1, result_internal_size2);
-  detail::matrix_array_wrapper<NumericT, column_major, false>
-      result_wrapper_col(result_data, result_start1, result_start2, result_inc1, result_inc2, result_internal_size1, result_internal_size2);
+#ifdef VIENNACL_WITH_OPENMP
+      unsigned int thread_id = omp_get_thread_num();
+#else
+      unsigned int thread_id = 0;
+#endif
+
+      max_length_row_C[thread_id] = std::max(max_length_row_C[thread_id], std::min(row_C_upper_bound_row, static_cast<unsigned int>(B.size2())));
+    }
+
+    // determine global maximum row length
+    for (std::size_t i=1; i<max_length_row_C.size(); ++i)
+      max_length_row_C[0] = std::max(max_length_row_C[0], max_length_row_C[i]);
+
+    return max_length_row_C[0];
+  }
+
+  /** @brief Stage 2 of the sparse matrix-matrix product C = A * B: Computes the row pointers of C and returns the number of nonzeros of C.
+  *
+  * Each row is computed by a merge, a hash table or a dense accumulator as selected by spgemm_select_row_method().
+  *
+  * @param A               Left factor
+  * @param B               Right factor
+  * @param max_row_length  Upper bound for the row lengths of C as obtained from spgemm_max_row_length()
+  * @param C_row_buffer    Row pointers of C, array of length A.size1() + 1
+  */
+  template<typename NumericT, unsigned int AlignmentV>
+  unsigned int spgemm_symbolic(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+                               viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
+                               unsigned int max_row_length,
+                               unsigned int * C_row_buffer)
+  {
+    unsigned int const * A_row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    unsigned int const * A_col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
+    unsigned int const * B_row_buffer = detail::extract_raw_pointer<unsigned int>(B.handle1());
+    unsigned int const * B_col_buffer = detail::extract_raw_pointer<unsigned int>(B.handle2());
+
+#if defined(VIENNACL_WITH_OPENMP)
+    unsigned int block_factor = 10;
+    unsigned int max_threads = omp_get_max_threads();
+    long chunk_size = long(A.size1()) / long(block_factor * max_threads) + 1;
+#else
+    unsigned int max_threads = 1;
+#endif
+
+    // allocate work vectors:
+    std::vector<unsigned int *> row_C_temp_index_buffers(max_threads);
+    for (unsigned int i=0; i<max_threads; ++i)
+      row_C_temp_index_buffers[i] = (unsigned int *)malloc(sizeof(unsigned int)*3*max_row_length);
+    std::vector<spgemm_accumulator<NumericT> > accumulators(max_threads, spgemm_accumulator<NumericT>(static_cast<unsigned int>(B.size2())));
 
-  if ( d_mat.lhs().row_major() ) {
 #ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
+    #pragma omp parallel for schedule(dynamic, chunk_size)
 #endif
-    for (long row = 0; row < static_cast<long>(sp_mat.size1()); ++row) {
-      vcl_size_t row_start = sp_mat_row_buffer[row];
-      vcl_size_t row_end = sp_mat_row_buffer[row+1];
-      for (vcl_size_t col = 0; col < d_mat.size2(); ++col) {
-        NumericT temp = 0;
-        for (vcl_size_t k = row_start; k < row_end; ++k) {
-          temp += sp_mat_elements[k] * d_mat_wrapper_row(col, static_cast<vcl_size_t>(sp_mat_col_buffer[k]));
-        }
-        if (result.row_major())
-          result_wrapper_row(row, col) = temp;
-        else
-          result_wrapper_col(row, col) = temp;
+    for (long i=0; i<long(A.size1()); ++i)
+    {
+      unsigned int thread_id = 0;
+    #ifdef VIENNACL_WITH_OPENMP
+      thread_id = omp_get_thread_num();
+    #endif
+
+      unsigned int *row_C_vector_1 = row_C_temp_index_buffers[thread_id];
+      unsigned int *row_C_vector_2 = row_C_vector_1 + max_row_length;
+      unsigned int *row_C_vector_3 = row_C_vector_2 + max_row_length;
+
+      unsigned int row_start_A = A_row_buffer[i];
+      unsigned int row_end_A   = A_row_buffer[i+1];
+
+      unsigned int upper_bound = spgemm_row_upper_bound(row_start_A, row_end_A, A_col_buffer, B_row_buffer);
+      switch (spgemm_select_row_method(row_end_A - row_start_A, upper_bound, static_cast<unsigned int>(B.size2())))
+      {
+        case SPGEMM_ROW_HASH:
+          C_row_buffer[i] = accumulators[thread_id].symbolic_hash(row_start_A, row_end_A, A_col_buffer, B_row_buffer, B_col_buffer, upper_bound);
+          break;
+        case SPGEMM_ROW_DENSE:
+          C_row_buffer[i] = accumulators[thread_id].symbolic_dense(row_start_A, row_end_A, A_col_buffer, B_row_buffer, B_col_buffer);
+          break;
+        default:
+          C_row_buffer[i] = row_C_scan_symbolic_vector(row_start_A, row_end_A, A_col_buffer,
+                                                       B_row_buffer, B_col_buffer, static_cast<unsigned int>(B.size2()),
+                                                       row_C_vector_1, row_C_vector_2, row_C_vector_3);
       }
     }
+
+    for (unsigned int i=0; i<max_threads; ++i)
+      free(row_C_temp_index_buffers[i]);
+
+    // exclusive scan to obtain row start indices:
+    unsigned int current_offset = 0;
+    for (std::size_t i=0; i<A.size1(); ++i)
+    {
+      unsigned int tmp = C_row_buffer[i];
+      C_row_buffer[i] = current_offset;
+      current_offset += tmp;
+    }
+    C_row_buffer[A.size1()] = current_offset;
+
+    return current_offset;
   }
-  else {
+
+  /** @brief Computes the column indices of C = A * B for given row pointers without computing any values.
+  *
+  * Each row is computed with the same method as in spgemm_symbolic(), hence the column indices are the same as the ones computed by spgemm_numeric().
+  *
+  * @param A               Left factor
+  * @param B               Right factor
+  * @param max_row_length  Upper bound for the row lengths of C as obtained from spgemm_max_row_length()
+  * @param C_row_buffer    Row pointers of C as obtained from spgemm_symbolic()
+  * @param C_col_buffer    Column indices of C (output)
+  */
+  template<typename NumericT, unsigned int AlignmentV>
+  void spgemm_pattern(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+                      viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
+                      unsigned int max_row_length,
+                      unsigned int const * C_row_buffer,
+                      unsigned int * C_col_buffer)
+  {
+    unsigned int const * A_row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    unsigned int const * A_col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
+    unsigned int const * B_row_buffer = detail::extract_raw_pointer<unsigned int>(B.handle1());
+    unsigned int const * B_col_buffer = detail::extract_raw_pointer<unsigned int>(B.handle2());
+
+#if defined(VIENNACL_WITH_OPENMP)
+    unsigned int block_factor = 10;
+    unsigned int max_threads = omp_get_max_threads();
+    long chunk_size = long(A.size1()) / long(block_factor * max_threads) + 1;
+#else
+    unsigned int max_threads = 1;
+#endif
+
+    // allocate work vectors:
+    std::vector<unsigned int *> row_C_temp_index_buffers(max_threads);
+    for (unsigned int i=0; i<max_threads; ++i)
+      row_C_temp_index_buffers[i] = (unsigned int *)malloc(sizeof(unsigned int)*3*max_row_length);
+    std::vector<spgemm_accumulator<NumericT> > accumulators(max_threads, spgemm_accumulator<NumericT>(static_cast<unsigned int>(B.size2())));
+
 #ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
+    #pragma omp parallel for schedule(dynamic, chunk_size)
 #endif
-    for (long col = 0; col < static_cast<long>(d_mat.size2()); ++col) {
-      for (vcl_size_t row = 0; row < sp_mat.size1(); ++row) {
-        vcl_size_t row_start = sp_mat_row_buffer[row];
-        vcl_size_t row_end = sp_mat_row_buffer[row+1];
-        NumericT temp = 0;
-        for (vcl_size_t k = row_start; k < row_end; ++k) {
-          temp += sp_mat_elements[k] * d_mat_wrapper_col(col, static_cast<vcl_size_t>(sp_mat_col_buffer[k]));
-        }
-        if (result.row_major())
-          result_wrapper_row(row, col) = temp;
-        else
-          result_wrapper_col(row, col) = temp;
+    for (long i = 0; i < long(A.size1()); ++i)
+    {
+      unsigned int row_start_A = A_row_buffer[i];
+      unsigned int row_end_A   = A_row_buffer[i+1];
+      unsigned int * row_C_cols = C_col_buffer + C_row_buffer[i];
+
+#ifdef VIENNACL_WITH_OPENMP
+      unsigned int thread_id = omp_get_thread_num();
+#else
+      unsigned int thread_id = 0;
+#endif
+
+      unsigned int *row_C_vector_1 = row_C_temp_index_buffers[thread_id];
+      unsigned int *row_C_vector_2 = row_C_vector_1 + max_row_length;
+      unsigned int *row_C_vector_3 = row_C_vector_2 + max_row_length;
+
+      unsigned int upper_bound = spgemm_row_upper_bound(row_start_A, row_end_A, A_col_buffer, B_row_buffer);
+      switch (spgemm_select_row_method(row_end_A - row_start_A, upper_bound, static_cast<unsigned int>(B.size2())))
+      {
+        case SPGEMM_ROW_HASH:
+          accumulators[thread_id].pattern_hash(row_start_A, row_end_A, A_col_buffer, B_row_buffer, B_col_buffer, upper_bound, row_C_cols);
+          break;
+        case SPGEMM_ROW_DENSE:
+          accumulators[thread_id].pattern_dense(row_start_A, row_end_A, A_col_buffer, B_row_buffer, B_col_buffer, row_C_cols);
+          break;
+        default:
+          row_C_scan_pattern_vector(row_start_A, row_end_A, A_col_buffer,
+                                    B_row_buffer, B_col_buffer, static_cast<unsigned int>(B.size2()),
+                                    row_C_vector_1, row_C_vector_2, row_C_vector_3, row_C_cols);
       }
     }
+
+    for (unsigned int i=0; i<max_threads; ++i)
+      free(row_C_temp_index_buffers[i]);
   }
 
-}
+  /** @brief Stage 3 of the sparse matrix-matrix product C = A * B: Computes the column indices and values of C for given row pointers.
+  *
+  * Each row is computed with the same method as in spgemm_symbolic().
+  *
+  * @param A               Left factor
+  * @param B               Right factor
+  * @param max_row_length  Upper bound for the row lengths of C as obtained from spgemm_max_row_length()
+  * @param C_row_buffer    Row pointers of C as obtained from spgemm_symbolic()
+  * @param C_col_buffer    Column indices of C (output)
+  * @param C_elements      Values of C (output)
+  */
+  template<typename NumericT, unsigned int AlignmentV>
+  void spgemm_numeric(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+                      viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
+                      unsigned int max_row_length,
+                      unsigned int const * C_row_buffer,
+                      unsigned int * C_col_buffer,
+                      NumericT * C_elements)
+  {
+    NumericT     const * A_elements   = detail::extract_raw_pointer<NumericT>(A.handle());
+    unsigned int const * A_row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    unsigned int const * A_col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
 
+    NumericT     const * B_elements   = detail::extract_raw_pointer<NumericT>(B.handle());
+    unsigned int const * B_row_buffer = detail::extract_raw_pointer<unsigned int>(B.handle1());
+    unsigned int const * B_col_buffer = detail::extract_raw_pointer<unsigned int>(B.handle2());
+
+#if defined(VIENNACL_WITH_OPENMP)
+    unsigned int block_factor = 10;
+    unsigned int max_threads = omp_get_max_threads();
+    long chunk_size = long(A.size1()) / long(block_factor * max_threads) + 1;
+#else
+    unsigned int max_threads = 1;
+#endif
+
+    // allocate work vectors:
+    std::vector<unsigned int *> row_C_temp_index_buffers(max_threads);
+    std::vector<NumericT *>     row_C_temp_value_buffers(max_threads);
+    for (unsigned int i=0; i<max_threads; ++i)
+    {
+      row_C_temp_index_buffers[i] = (unsigned int *)malloc(sizeof(unsigned int)*3*max_row_length);
+      row_C_temp_value_buffers[i] = (NumericT *)malloc(sizeof(NumericT)*3*max_row_length);
+    }
+    std::vector<spgemm_accumulator<NumericT> > accumulators(max_threads, spgemm_accumulator<NumericT>(static_cast<unsigned int>(B.size2())));
+
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for schedule(dynamic, chunk_size)
+#endif
+    for (long i = 0; i < long(A.size1()); ++i)
+    {
+      unsigned int row_start_A  = A_row_buffer[i];
+      unsigned int row_end_A    = A_row_buffer[i+1];
+
+      unsigned int row_C_buffer_start = C_row_buffer[i];
+      unsigned int row_C_buffer_end   = C_row_buffer[i+1];
+
+#ifdef VIENNACL_WITH_OPENMP
+      unsigned int thread_id = omp_get_thread_num();
+#else
+      unsigned int thread_id = 0;
+#endif
+
+      unsigned int *row_C_vector_1 = row_C_temp_index_buffers[thread_id];
+      unsigned int *row_C_vector_2 = row_C_vector_1 + max_row_length;
+      unsigned int *row_C_vector_3 = row_C_vector_2 + max_row_length;
+
+      NumericT *row_C_vector_1_values = row_C_temp_value_buffers[thread_id];
+      NumericT *row_C_vector_2_values = row_C_vector_1_values + max_row_length;
+      NumericT *row_C_vector_3_values = row_C_vector_2_values + max_row_length;
+
+      unsigned int upper_bound = spgemm_row_upper_bound(row_start_A, row_end_A, A_col_buffer, B_row_buffer);
+      switch (spgemm_select_row_method(row_end_A - row_start_A, upper_bound, static_cast<unsigned int>(B.size2())))
+      {
+        case SPGEMM_ROW_HASH:
+          accumulators[thread_id].numeric_hash(row_start_A, row_end_A, A_col_buffer, A_elements,
+                                               B_row_buffer, B_col_buffer, B_elements, upper_bound,
+                                               C_col_buffer + row_C_buffer_start, C_elements + row_C_buffer_start);
+          break;
+        case SPGEMM_ROW_DENSE:
+          accumulators[thread_id].numeric_dense(row_start_A, row_end_A, A_col_buffer, A_elements,
+                                                B_row_buffer, B_col_buffer, B_elements,
+                                                C_col_buffer + row_C_buffer_start, C_elements + row_C_buffer_start);
+          break;
+        default:
+          row_C_scan_numeric_vector(row_start_A, row_end_A, A_col_buffer, A_elements,
+                                    B_row_buffer, B_col_buffer, B_elements, static_cast<unsigned int>(B.size2()),
+                                    row_C_buffer_start, row_C_buffer_end, C_col_buffer, C_elements,
+                                    row_C_vector_1, row_C_vector_1_values,
+                                    row_C_vector_2, row_C_vector_2_values,
+                                    row_C_vector_3, row_C_vector_3_values);
+      }
+    }
+
+    // clean up at the end:
+    for (unsigned int i=0; i<max_threads; ++i)
+    {
+      free(row_C_temp_index_buffers[i]);
+      free(row_C_temp_value_buffers[i]);
+    }
+  }
+}
 
 /** @brief Carries out sparse_matrix-sparse_matrix multiplication for CSR matrices
 *
@@ -373,157 +995,314 @@ void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
                viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
                viennacl::compressed_matrix<NumericT, AlignmentV> & C)
 {
+  C.resize(A.size1(), B.size2(), false);
+  unsigned int * C_row_buffer = detail::extract_raw_pointer<unsigned int>(C.handle1());
+
+  unsigned int max_row_length = detail::spgemm_max_row_length(A, B);
+  unsigned int nnz = detail::spgemm_symbolic(A, B, max_row_length, C_row_buffer);
+  C.reserve(nnz, false);
+  C.reset_row_statistics();
+
+  detail::spgemm_numeric(A, B, max_row_length, C_row_buffer,
+                         detail::extract_raw_pointer<unsigned int>(C.handle2()),
+                         detail::extract_raw_pointer<NumericT>(C.handle()));
+}
+
+/** @brief Computes the sparsity pattern of the sparse matrix-matrix product C = A * B for CSR matrices.
+*
+* The plan can be passed to prod_numeric() for the computation of products of matrices with the same sparsity patterns as A and B.
+*
+* @param A     Left factor
+* @param B     Right factor
+* @param plan  The plan holding the sparsity pattern of C
+*/
+template<typename NumericT, unsigned int AlignmentV>
+void prod_symbolic(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+                   viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
+                   viennacl::linalg::spgemm_plan & plan)
+{
+  plan.size1 = A.size1();
+  plan.size2 = B.size2();
+  plan.A_nnz = A.nnz();
+  plan.B_nnz = B.nnz();
+  plan.max_row_length = detail::spgemm_max_row_length(A, B);
+
+  plan.row_buffer.resize(A.size1() + 1);
+  unsigned int nnz = detail::spgemm_symbolic(A, B, plan.max_row_length, &(plan.row_buffer[0]));
+
+  // only the column indices of C are computed, the values are left to prod_numeric():
+  std::vector<unsigned int>(nnz).swap(plan.col_buffer);
+  if (nnz > 0)
+    detail::spgemm_pattern(A, B, plan.max_row_length, &(plan.row_buffer[0]), &(plan.col_buffer[0]));
+}
+
+/** @brief Computes the sparse matrix-matrix product C = A * B for CSR matrices using the sparsity pattern of C from a plan.
+*
+* Only the numeric merge of the rows of B is carried out. The sparsity pattern of C is set up from the plan if C does not have the size and number of nonzeros of the product.
+* A and B must have the same sparsity patterns as the matrices the plan was computed for.
+*
+* @param A     Left factor
+* @param B     Right factor
+* @param plan  The plan computed by prod_symbolic()
+* @param C     Result matrix
+*/
+template<typename NumericT, unsigned int AlignmentV>
+void prod_numeric(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
+                  viennacl::compressed_matrix<NumericT, AlignmentV> const & B,
+                  viennacl::linalg::spgemm_plan const & plan,
+                  viennacl::compressed_matrix<NumericT, AlignmentV> & C)
+{
+  assert( (A.size1() == plan.size1 && B.size2() == plan.size2 && A.nnz() == plan.A_nnz && B.nnz() == plan.B_nnz) && bool("Sparse matrix-matrix product: factors do not match the plan"));
 
-  NumericT     const * A_elements   = detail::extract_raw_pointer<NumericT>(A.handle());
-  unsigned int const * A_row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
-  unsigned int const * A_col_buffer = detail::extract_raw_pointer<unsigned int>(A.handle2());
-
-  NumericT     const * B_elements   = detail::extract_raw_pointer<NumericT>(B.handle());
-  unsigned int const * B_row_buffer = detail::extract_raw_pointer<unsigned int>(B.handle1());
-  unsigned int const * B_col_buffer = detail::extract_raw_pointer<unsigned int>(B.handle2());
-
-  C.resize(A.size1(), B.size2(), false);
-  unsigned int * C_row_buffer = detail::extract_raw_pointer<unsigned int>(C.handle1());
+  vcl_size_t nnz = plan.col_buffer.size();
+  if (nnz == 0)
+  {
+    C.resize(plan.size1, plan.size2, false);
+    C.clear();
+    return;
+  }
 
-#if defined(VIENNACL_WITH_OPENMP)
-  unsigned int block_factor = 10;
-  unsigned int max_threads = omp_get_max_threads();
-  long chunk_size = long(A.size1()) / long(block_factor * max_threads) + 1;
-#else
-  unsigned int max_threads = 1;
-#endif
-  std::vector<unsigned int> max_length_row_C(max_threads);
-  std::vector<unsigned int *> row_C_temp_index_buffers(max_threads);
-  std::vector<NumericT *>     row_C_temp_value_buffers(max_threads);
+  if (C.size1() != plan.size1 || C.size2() != plan.size2 || C.nnz() != nnz)
+  {
+    std::vector<NumericT> values(nnz);
+    C.set(&(plan.row_buffer[0]), &(plan.col_buffer[0]), &(values[0]), plan.size1, plan.size2, nnz);
+  }
+  else
+  {
+    // C may hold a different sparsity pattern with the same number of nonzeros:
+    viennacl::compressed_matrix<NumericT, AlignmentV> const & C_const = C;
+    unsigned int const * C_row_buffer = detail::extract_raw_pointer<unsigned int>(C_const.handle1());
+    if (!std::equal(plan.row_buffer.begin(), plan.row_buffer.end(), C_row_buffer))
+    {
+      std::copy(plan.row_buffer.begin(), plan.row_buffer.end(), detail::extract_raw_pointer<unsigned int>(C.handle1()));
+      C.generate_row_block_information();
+    }
+  }
 
+  detail::spgemm_numeric(A, B, plan.max_row_length, &(plan.row_buffer[0]),
+                         detail::extract_raw_pointer<unsigned int>(C.handle2()),
+                         detail::extract_raw_pointer<NumericT>(C.handle()));
+}
 
-  /*
-   * Stage 1: Determine maximum length of work buffers:
-   */
 
-#if defined(VIENNACL_WITH_OPENMP)
-  #pragma omp parallel for schedule(dynamic, chunk_size)
+//
+// Transposition of compressed_matrix and coordinate_matrix
+//
+namespace detail
+{
+  /** @brief Returns the number of blocks of entries for the parallel counting sort in a sparse transposition.
+  *
+  * Each block requires a count array with one entry per row of the transposed matrix, hence fewer blocks are used if there are only few entries per column.
+  */
+  inline vcl_size_t transpose_blocks(vcl_size_t nnz, vcl_size_t cols)
+  {
+    vcl_size_t blocks = 1;
+#ifdef VIENNACL_WITH_OPENMP
+    blocks = static_cast<vcl_size_t>(omp_get_max_threads());
 #endif
-  for (long i=0; i<long(A.size1()); ++i)
+    return std::max<vcl_size_t>(1, std::min<vcl_size_t>(blocks, nnz / (cols + 1)));
+  }
+
+  /** @brief Turns the numbers of entries per block and row of the transposed matrix B into the row pointers of B and the positions at which each block writes its entries of a row of B.
+  *
+  * Since the blocks are in the order of the entries of A, the entries of each row of B remain sorted by column.
+  *
+  * @param counts        Numbers of entries, counts[b * (B_size1 + 1) + i] for block b and row i of B. Overwritten with the write positions.
+  * @param blocks        Number of blocks
+  * @param B_size1       Number of rows of B
+  * @param B_row_buffer  Row pointers of B, array of length B_size1 + 1
+  */
+  template<typename IndexT>
+  void transpose_offsets(std::vector<IndexT> & counts, vcl_size_t blocks, vcl_size_t B_size1, IndexT * B_row_buffer)
   {
-    unsigned int row_start_A = A_row_buffer[i];
-    unsigned int row_end_A   = A_row_buffer[i+1];
+    vcl_size_t stride = B_size1 + 1;
 
-    unsigned int row_C_upper_bound_row = 0;
-    for (unsigned int j = row_start_A; j<row_end_A; ++j)
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for
+#endif
+    for (long row = 0; row < static_cast<long>(B_size1); ++row)
     {
-      unsigned int row_B = A_col_buffer[j];
+      IndexT offset = 0;
+      for (vcl_size_t b = 0; b < blocks; ++b)
+      {
+        IndexT tmp = counts[b * stride + vcl_size_t(row)];
+        counts[b * stride + vcl_size_t(row)] = offset;
+        offset += tmp;
+      }
+      B_row_buffer[row] = offset;
+    }
 
-      unsigned int entries_in_row = B_row_buffer[row_B+1] - B_row_buffer[row_B];
-      row_C_upper_bound_row += entries_in_row;
+    // exclusive scan to obtain row start indices:
+    IndexT current_offset = 0;
+    for (vcl_size_t i = 0; i < B_size1; ++i)
+    {
+      IndexT tmp = B_row_buffer[i];
+      B_row_buffer[i] = current_offset;
+      current_offset += tmp;
     }
+    B_row_buffer[B_size1] = current_offset;
 
 #ifdef VIENNACL_WITH_OPENMP
-    unsigned int thread_id = omp_get_thread_num();
-#else
-    unsigned int thread_id = 0;
+    #pragma omp parallel for
 #endif
-
-    max_length_row_C[thread_id] = std::max(max_length_row_C[thread_id], std::min(row_C_upper_bound_row, static_cast<unsigned int>(B.size2())));
+    for (long row = 0; row < static_cast<long>(B_size1); ++row)
+      for (vcl_size_t b = 0; b < blocks; ++b)
+        counts[b * stride + vcl_size_t(row)] += B_row_buffer[row];
   }
 
-  // determine global maximum row length
-  for (std::size_t i=1; i<max_length_row_C.size(); ++i)
-    max_length_row_C[0] = std::max(max_length_row_C[0], max_length_row_C[i]);
-
-  // allocate work vectors:
-  for (unsigned int i=0; i<max_threads; ++i)
-    row_C_temp_index_buffers[i] = (unsigned int *)malloc(sizeof(unsigned int)*3*max_length_row_C[0]);
+  /** @brief Transposes a coordinate_matrix given by its raw arrays. The entries of A are expected to be sorted by row, the entries of B are then sorted by row and column.
+  *
+  * @param A_coords            (row, column) pairs of A
+  * @param A_elements          Values of A
+  * @param nnz                 Number of entries of A
+  * @param A_size2             Number of columns of A
+  * @param B_coords            (row, column) pairs of B, array of length 2 * nnz
+  * @param B_elements          Values of B, array of length nnz
+  * @param B_group_boundaries  Start indices of the groups of entries of B, array of length groups + 1. The groups are split at row boundaries.
+  * @param groups              Number of groups
+  */
+  template<typename NumericT, typename IndexT>
+  void coo_transpose(IndexT const * A_coords, NumericT const * A_elements, vcl_size_t nnz, vcl_size_t A_size2,
+                     IndexT * B_coords, NumericT * B_elements, IndexT * B_group_boundaries, vcl_size_t groups)
+  {
+    vcl_size_t blocks = transpose_blocks(nnz, A_size2);
+    vcl_size_t stride = A_size2 + 1;
+    std::vector<IndexT> counts(blocks * stride);
+    std::vector<IndexT> B_row_buffer(A_size2 + 1);
 
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp parallel for
+#endif
+    for (long b = 0; b < static_cast<long>(blocks); ++b)
+    {
+      IndexT * block_counts = &(counts[vcl_size_t(b) * stride]);
+      vcl_size_t block_end = (nnz * vcl_size_t(b + 1)) / blocks;
+      for (vcl_size_t i = (nnz * vcl_size_t(b)) / blocks; i < block_end; ++i)
+        ++block_counts[A_coords[2*i+1]];
+    }
 
-  /*
-   * Stage 2: Determine sparsity pattern of C
-   */
+    transpose_offsets(counts, blocks, A_size2, &(B_row_buffer[0]));
 
 #ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for schedule(dynamic, chunk_size)
+    #pragma omp parallel for
 #endif
-  for (long i=0; i<long(A.size1()); ++i)
-  {
-    unsigned int thread_id = 0;
-  #ifdef VIENNACL_WITH_OPENMP
-    thread_id = omp_get_thread_num();
-  #endif
-    unsigned int buffer_len = max_length_row_C[0];
-
-    unsigned int *row_C_vector_1 = row_C_temp_index_buffers[thread_id];
-    unsigned int *row_C_vector_2 = row_C_vector_1 + buffer_len;
-    unsigned int *row_C_vector_3 = row_C_vector_2 + buffer_len;
-
-    unsigned int row_start_A = A_row_buffer[i];
-    unsigned int row_end_A   = A_row_buffer[i+1];
-
-    C_row_buffer[i] = row_C_scan_symbolic_vector(row_start_A, row_end_A, A_col_buffer,
-                                                 B_row_buffer, B_col_buffer, static_cast<unsigned int>(B.size2()),
-                                                 row_C_vector_1, row_C_vector_2, row_C_vector_3);
-  }
+    for (long b = 0; b < static_cast<long>(blocks); ++b)
+    {
+      IndexT * block_offsets = &(counts[vcl_size_t(b) * stride]);
+      vcl_size_t block_end = (nnz * vcl_size_t(b + 1)) / blocks;
+      for (vcl_size_t i = (nnz * vcl_size_t(b)) / blocks; i < block_end; ++i)
+      {
+        IndexT index = block_offsets[A_coords[2*i+1]]++;
+        B_coords[2*index]     = A_coords[2*i+1];
+        B_coords[2*index + 1] = A_coords[2*i];
+        B_elements[index]     = A_elements[i];
+      }
+    }
 
-  // exclusive scan to obtain row start indices:
-  unsigned int current_offset = 0;
-  for (std::size_t i=0; i<C.size1(); ++i)
-  {
-    unsigned int tmp = C_row_buffer[i];
-    C_row_buffer[i] = current_offset;
-    current_offset += tmp;
+    // split the entries into groups of about equal size at row boundaries:
+    B_group_boundaries[0] = 0;
+    for (vcl_size_t g = 1; g < groups; ++g)
+    {
+      IndexT target = static_cast<IndexT>((nnz * g) / groups);
+      B_group_boundaries[g] = *(std::upper_bound(B_row_buffer.begin(), B_row_buffer.end(), target) - 1);
+    }
+    B_group_boundaries[groups] = static_cast<IndexT>(nnz);
   }
-  C_row_buffer[C.size1()] = current_offset;
-  C.reserve(current_offset, false);
+}
+
+/** @brief Computes the transposed matrix B = trans(A) of a compressed_matrix.
+*
+* The entries are distributed to the rows of B by a counting sort, where each thread processes a contiguous block of rows of A with about the same number of entries.
+* The column indices of B are sorted within each row.
+*
+* @param A     The matrix to be transposed
+* @param B     The result matrix
+*/
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void trans(viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> const & A,
+           viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & B)
+{
+  B = viennacl::compressed_matrix<NumericT, AlignmentV, IndexT>(A.size2(), A.size1(), A.nnz(), viennacl::traits::context(A));
+  if (A.nnz() == 0)
+    return;
+
+  NumericT     const * A_elements   = detail::extract_raw_pointer<NumericT>(A.handle());
+  IndexT const * A_row_buffer = detail::extract_raw_pointer<IndexT>(A.handle1());
+  IndexT const * A_col_buffer = detail::extract_raw_pointer<IndexT>(A.handle2());
 
-  // allocate work vectors:
-  for (unsigned int i=0; i<max_threads; ++i)
-    row_C_temp_value_buffers[i] = (NumericT *)malloc(sizeof(NumericT)*3*max_length_row_C[0]);
+  NumericT     * B_elements   = detail::extract_raw_pointer<NumericT>(B.handle());
+  IndexT * B_row_buffer = detail::extract_raw_pointer<IndexT>(B.handle1());
+  IndexT * B_col_buffer = detail::extract_raw_pointer<IndexT>(B.handle2());
 
-  /*
-   * Stage 3: Compute product (code similar, maybe pull out into a separate function to avoid code duplication?)
-   */
-  NumericT     * C_elements   = detail::extract_raw_pointer<NumericT>(C.handle());
-  unsigned int * C_col_buffer = detail::extract_raw_pointer<unsigned int>(C.handle2());
+  vcl_size_t blocks = detail::transpose_blocks(A.nnz(), A.size2());
+  vcl_size_t stride = B.size1() + 1;
+  std::vector<IndexT> counts(blocks * stride);
 
+  // block b holds the rows starting at row_offsets[b]:
+  std::vector<IndexT> row_offsets(blocks + 1);
+  for (vcl_size_t b = 0; b < blocks; ++b)
+    row_offsets[b] = static_cast<IndexT>(std::lower_bound(A_row_buffer, A_row_buffer + A.size1(), static_cast<IndexT>((A.nnz() * b) / blocks)) - A_row_buffer);
+  row_offsets[blocks] = static_cast<IndexT>(A.size1());
+
+  //
+  // Stage 1: Count the entries per block and column of A
+  //
 #ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for schedule(dynamic, chunk_size)
+  #pragma omp parallel for
 #endif
-  for (long i = 0; i < long(A.size1()); ++i)
+  for (long b = 0; b < static_cast<long>(blocks); ++b)
   {
-    unsigned int row_start_A  = A_row_buffer[i];
-    unsigned int row_end_A    = A_row_buffer[i+1];
+    IndexT * block_counts = &(counts[vcl_size_t(b) * stride]);
+    for (IndexT nnz_index = A_row_buffer[row_offsets[b]]; nnz_index < A_row_buffer[row_offsets[b+1]]; ++nnz_index)
+      ++block_counts[A_col_buffer[nnz_index]];
+  }
 
-    unsigned int row_C_buffer_start = C_row_buffer[i];
-    unsigned int row_C_buffer_end   = C_row_buffer[i+1];
+  //
+  // Stage 2: Row pointers of B and write positions of each block
+  //
+  detail::transpose_offsets(counts, blocks, B.size1(), B_row_buffer);
 
+  //
+  // Stage 3: Fill with data
+  //
 #ifdef VIENNACL_WITH_OPENMP
-    unsigned int thread_id = omp_get_thread_num();
-#else
-    unsigned int thread_id = 0;
+  #pragma omp parallel for
 #endif
-
-    unsigned int *row_C_vector_1 = row_C_temp_index_buffers[thread_id];
-    unsigned int *row_C_vector_2 = row_C_vector_1 + max_length_row_C[0];
-    unsigned int *row_C_vector_3 = row_C_vector_2 + max_length_row_C[0];
-
-    NumericT *row_C_vector_1_values = row_C_temp_value_buffers[thread_id];
-    NumericT *row_C_vector_2_values = row_C_vector_1_values + max_length_row_C[0];
-    NumericT *row_C_vector_3_values = row_C_vector_2_values + max_length_row_C[0];
-
-    row_C_scan_numeric_vector(row_start_A, row_end_A, A_col_buffer, A_elements,
-                              B_row_buffer, B_col_buffer, B_elements, static_cast<unsigned int>(B.size2()),
-                              row_C_buffer_start, row_C_buffer_end, C_col_buffer, C_elements,
-                              row_C_vector_1, row_C_vector_1_values,
-                              row_C_vector_2, row_C_vector_2_values,
-                              row_C_vector_3, row_C_vector_3_values);
-  }
-
-  // clean up at the end:
-  for (unsigned int i=0; i<max_threads; ++i)
+  for (long b = 0; b < static_cast<long>(blocks); ++b)
   {
-    free(row_C_temp_index_buffers[i]);
-    free(row_C_temp_value_buffers[i]);
+    IndexT * block_offsets = &(counts[vcl_size_t(b) * stride]);
+    for (IndexT row = row_offsets[b]; row < row_offsets[b+1]; ++row)
+    {
+      IndexT row_stop = A_row_buffer[row+1];
+      for (IndexT nnz_index = A_row_buffer[row]; nnz_index < row_stop; ++nnz_index)
+      {
+        IndexT B_nnz_index = block_offsets[A_col_buffer[nnz_index]]++;
+        B_col_buffer[B_nnz_index] = row;
+        B_elements[B_nnz_index]   = A_elements[nnz_index];
+      }
+    }
   }
 
+  B.generate_row_block_information();
+}
+
+/** @brief Computes the transposed matrix B = trans(A) of a coordinate_matrix by a parallel counting sort of the entries.
+*
+* B must provide memory for A.nnz() entries and A.groups() groups, as set up by coordinate_matrix::operator=().
+*
+* @param A     The matrix to be transposed, entries sorted by row
+* @param B     The result matrix
+*/
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void trans(viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> const & A,
+           viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> & B)
+{
+  if (A.nnz() == 0)
+    return;
+
+  detail::coo_transpose(detail::extract_raw_pointer<IndexT>(A.handle12()), detail::extract_raw_pointer<NumericT>(A.handle()), A.nnz(), A.size2(),
+                        detail::extract_raw_pointer<IndexT>(B.handle12()), detail::extract_raw_pointer<NumericT>(B.handle()),
+                        detail::extract_raw_pointer<IndexT>(B.handle3()), B.groups());
 }
 
 
@@ -653,15 +1432,15 @@ namespace detail
 * @param vec  The vector holding the right hand side. Is overwritten by the solution.
 * @param tag  The solver tag identifying the respective triangular solver
 */
-template<typename NumericT, unsigned int AlignmentV>
-void inplace_solve(compressed_matrix<NumericT, AlignmentV> const & L,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void inplace_solve(compressed_matrix<NumericT, AlignmentV, IndexT> const & L,
                    vector_base<NumericT> & vec,
                    viennacl::linalg::unit_lower_tag tag)
 {
   NumericT           * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
   NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(L.handle());
-  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(L.handle1());
-  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(L.handle2());
+  IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(L.handle1());
+  IndexT const * col_buffer = detail::extract_raw_pointer<IndexT>(L.handle2());
 
   detail::csr_inplace_solve<NumericT>(row_buffer, col_buffer, elements, vec_buf, L.size2(), tag);
 }
@@ -672,15 +1451,15 @@ void inplace_solve(compressed_matrix<NumericT, AlignmentV> const & L,
 * @param vec  The vector holding the right hand side. Is overwritten by the solution.
 * @param tag  The solver tag identifying the respective triangular solver
 */
-template<typename NumericT, unsigned int AlignmentV>
-void inplace_solve(compressed_matrix<NumericT, AlignmentV> const & L,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void inplace_solve(compressed_matrix<NumericT, AlignmentV, IndexT> const & L,
                    vector_base<NumericT> & vec,
                    viennacl::linalg::lower_tag tag)
 {
   NumericT           * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
   NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(L.handle());
-  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(L.handle1());
-  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(L.handle2());
+  IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(L.handle1());
+  IndexT const * col_buffer = detail::extract_raw_pointer<IndexT>(L.handle2());
 
   detail::csr_inplace_solve<NumericT>(row_buffer, col_buffer, elements, vec_buf, L.size2(), tag);
 }
@@ -692,15 +1471,15 @@ void inplace_solve(compressed_matrix<NumericT, AlignmentV> const & L,
 * @param vec  The vector holding the right hand side. Is overwritten by the solution.
 * @param tag  The solver tag identifying the respective triangular solver
 */
-template<typename NumericT, unsigned int AlignmentV>
-void inplace_solve(compressed_matrix<NumericT, AlignmentV> const & U,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void inplace_solve(compressed_matrix<NumericT, AlignmentV, IndexT> const & U,
                    vector_base<NumericT> & vec,
                    viennacl::linalg::unit_upper_tag tag)
 {
   NumericT           * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
   NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(U.handle());
-  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(U.handle1());
-  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(U.handle2());
+  IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(U.handle1());
+  IndexT const * col_buffer = detail::extract_raw_pointer<IndexT>(U.handle2());
 
   detail::csr_inplace_solve<NumericT>(row_buffer, col_buffer, elements, vec_buf, U.size2(), tag);
 }
@@ -711,15 +1490,15 @@ void inplace_solve(compressed_matrix<NumericT, AlignmentV> const & U,
 * @param vec  The vector holding the right hand side. Is overwritten by the solution.
 * @param tag  The solver tag identifying the respective triangular solver
 */
-template<typename NumericT, unsigned int AlignmentV>
-void inplace_solve(compressed_matrix<NumericT, AlignmentV> const & U,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void inplace_solve(compressed_matrix<NumericT, AlignmentV, IndexT> const & U,
                    vector_base<NumericT> & vec,
                    viennacl::linalg::upper_tag tag)
 {
   NumericT           * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
   NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(U.handle());
-  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(U.handle1());
-  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(U.handle2());
+  IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(U.handle1());
+  IndexT const * col_buffer = detail::extract_raw_pointer<IndexT>(U.handle2());
 
   detail::csr_inplace_solve<NumericT>(row_buffer, col_buffer, elements, vec_buf, U.size2(), tag);
 }
@@ -751,7 +1530,7 @@ namespace detail
       vcl_size_t col_end = row_buffer[col+1];
       for (vcl_size_t i = col_begin; i < col_end; ++i)
       {
-        unsigned int row_index = col_buffer[i];
+        vcl_size_t row_index = col_buffer[i];
         if (row_index > col)
           vec_buffer[row_index] -= vec_entry * element_buffer[i];
       }
@@ -864,9 +1643,9 @@ namespace detail
   //
   // block solves
   //
-  template<typename NumericT, unsigned int AlignmentV>
-  void block_inplace_solve(const matrix_expression<const compressed_matrix<NumericT, AlignmentV>,
-                                                   const compressed_matrix<NumericT, AlignmentV>,
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void block_inplace_solve(const matrix_expression<const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                                   const compressed_matrix<NumericT, AlignmentV, IndexT>,
                                                    op_trans> & L,
                            viennacl::backend::mem_handle const & /* block_indices */, vcl_size_t /* num_blocks */,
                            vector_base<NumericT> const & /* L_diagonal */,  //ignored
@@ -875,8 +1654,8 @@ namespace detail
   {
     // Note: The following could be implemented more efficiently using the block structure and possibly OpenMP.
 
-    unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.lhs().handle1());
-    unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.lhs().handle2());
+    IndexT const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<IndexT>(L.lhs().handle1());
+    IndexT const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<IndexT>(L.lhs().handle2());
     NumericT     const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(L.lhs().handle());
     NumericT           * vec_buffer = detail::extract_raw_pointer<NumericT>(vec.handle());
 
@@ -887,7 +1666,7 @@ namespace detail
       vcl_size_t col_end = row_buffer[col+1];
       for (vcl_size_t i = col_begin; i < col_end; ++i)
       {
-        unsigned int row_index = col_buffer[i];
+        vcl_size_t row_index = col_buffer[i];
         if (row_index > col)
           vec_buffer[row_index] -= vec_entry * elements[i];
       }
@@ -895,9 +1674,9 @@ namespace detail
     }
   }
 
-  template<typename NumericT, unsigned int AlignmentV>
-  void block_inplace_solve(const matrix_expression<const compressed_matrix<NumericT, AlignmentV>,
-                                                   const compressed_matrix<NumericT, AlignmentV>,
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void block_inplace_solve(const matrix_expression<const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                                   const compressed_matrix<NumericT, AlignmentV, IndexT>,
                                                    op_trans> & L,
                            viennacl::backend::mem_handle const & /*block_indices*/, vcl_size_t /* num_blocks */,
                            vector_base<NumericT> const & L_diagonal,
@@ -906,8 +1685,8 @@ namespace detail
   {
     // Note: The following could be implemented more efficiently using the block structure and possibly OpenMP.
 
-    unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.lhs().handle1());
-    unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(L.lhs().handle2());
+    IndexT const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<IndexT>(L.lhs().handle1());
+    IndexT const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<IndexT>(L.lhs().handle2());
     NumericT     const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(L.lhs().handle());
     NumericT     const * diagonal_buffer = detail::extract_raw_pointer<NumericT>(L_diagonal.handle());
     NumericT           * vec_buffer = detail::extract_raw_pointer<NumericT>(vec.handle());
@@ -931,9 +1710,9 @@ namespace detail
 
 
 
-  template<typename NumericT, unsigned int AlignmentV>
-  void block_inplace_solve(const matrix_expression<const compressed_matrix<NumericT, AlignmentV>,
-                                                   const compressed_matrix<NumericT, AlignmentV>,
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void block_inplace_solve(const matrix_expression<const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                                   const compressed_matrix<NumericT, AlignmentV, IndexT>,
                                                    op_trans> & U,
                            viennacl::backend::mem_handle const & /*block_indices*/, vcl_size_t /* num_blocks */,
                            vector_base<NumericT> const & /* U_diagonal */, //ignored
@@ -942,8 +1721,8 @@ namespace detail
   {
     // Note: The following could be implemented more efficiently using the block structure and possibly OpenMP.
 
-    unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.lhs().handle1());
-    unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.lhs().handle2());
+    IndexT const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<IndexT>(U.lhs().handle1());
+    IndexT const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<IndexT>(U.lhs().handle2());
     NumericT     const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(U.lhs().handle());
     NumericT           * vec_buffer = detail::extract_raw_pointer<NumericT>(vec.handle());
 
@@ -964,9 +1743,9 @@ namespace detail
     }
   }
 
-  template<typename NumericT, unsigned int AlignmentV>
-  void block_inplace_solve(const matrix_expression<const compressed_matrix<NumericT, AlignmentV>,
-                                                   const compressed_matrix<NumericT, AlignmentV>,
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void block_inplace_solve(const matrix_expression<const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                                   const compressed_matrix<NumericT, AlignmentV, IndexT>,
                                                    op_trans> & U,
                            viennacl::backend::mem_handle const & /* block_indices */, vcl_size_t /* num_blocks */,
                            vector_base<NumericT> const & U_diagonal,
@@ -975,8 +1754,8 @@ namespace detail
   {
     // Note: The following could be implemented more efficiently using the block structure and possibly OpenMP.
 
-    unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.lhs().handle1());
-    unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(U.lhs().handle2());
+    IndexT const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<IndexT>(U.lhs().handle1());
+    IndexT const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<IndexT>(U.lhs().handle2());
     NumericT     const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(U.lhs().handle());
     NumericT     const * diagonal_buffer = detail::extract_raw_pointer<NumericT>(U_diagonal.handle());
     NumericT           * vec_buffer = detail::extract_raw_pointer<NumericT>(vec.handle());
@@ -1008,17 +1787,17 @@ namespace detail
 * @param vec    The right hand side vector
 * @param tag    The solver tag identifying the respective triangular solver
 */
-template<typename NumericT, unsigned int AlignmentV>
-void inplace_solve(matrix_expression< const compressed_matrix<NumericT, AlignmentV>,
-                                      const compressed_matrix<NumericT, AlignmentV>,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void inplace_solve(matrix_expression< const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                      const compressed_matrix<NumericT, AlignmentV, IndexT>,
                                       op_trans> const & proxy,
                    vector_base<NumericT> & vec,
                    viennacl::linalg::unit_lower_tag tag)
 {
   NumericT           * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
   NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(proxy.lhs().handle());
-  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(proxy.lhs().handle1());
-  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(proxy.lhs().handle2());
+  IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(proxy.lhs().handle1());
+  IndexT const * col_buffer = detail::extract_raw_pointer<IndexT>(proxy.lhs().handle2());
 
   detail::csr_trans_inplace_solve<NumericT>(row_buffer, col_buffer, elements, vec_buf, proxy.lhs().size1(), tag);
 }
@@ -1029,17 +1808,17 @@ void inplace_solve(matrix_expression< const compressed_matrix<NumericT, Alignmen
 * @param vec    The right hand side vector
 * @param tag    The solver tag identifying the respective triangular solver
 */
-template<typename NumericT, unsigned int AlignmentV>
-void inplace_solve(matrix_expression< const compressed_matrix<NumericT, AlignmentV>,
-                                      const compressed_matrix<NumericT, AlignmentV>,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void inplace_solve(matrix_expression< const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                      const compressed_matrix<NumericT, AlignmentV, IndexT>,
                                       op_trans> const & proxy,
                    vector_base<NumericT> & vec,
                    viennacl::linalg::lower_tag tag)
 {
   NumericT           * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
   NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(proxy.lhs().handle());
-  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(proxy.lhs().handle1());
-  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(proxy.lhs().handle2());
+  IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(proxy.lhs().handle1());
+  IndexT const * col_buffer = detail::extract_raw_pointer<IndexT>(proxy.lhs().handle2());
 
   detail::csr_trans_inplace_solve<NumericT>(row_buffer, col_buffer, elements, vec_buf, proxy.lhs().size1(), tag);
 }
@@ -1051,17 +1830,17 @@ void inplace_solve(matrix_expression< const compressed_matrix<NumericT, Alignmen
 * @param vec    The right hand side vector
 * @param tag    The solver tag identifying the respective triangular solver
 */
-template<typename NumericT, unsigned int AlignmentV>
-void inplace_solve(matrix_expression< const compressed_matrix<NumericT, AlignmentV>,
-                                      const compressed_matrix<NumericT, AlignmentV>,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void inplace_solve(matrix_expression< const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                      const compressed_matrix<NumericT, AlignmentV, IndexT>,
                                       op_trans> const & proxy,
                    vector_base<NumericT> & vec,
                    viennacl::linalg::unit_upper_tag tag)
 {
   NumericT           * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
   NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(proxy.lhs().handle());
-  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(proxy.lhs().handle1());
-  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(proxy.lhs().handle2());
+  IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(proxy.lhs().handle1());
+  IndexT const * col_buffer = detail::extract_raw_pointer<IndexT>(proxy.lhs().handle2());
 
   detail::csr_trans_inplace_solve<NumericT>(row_buffer, col_buffer, elements, vec_buf, proxy.lhs().size1(), tag);
 }
@@ -1073,17 +1852,17 @@ void inplace_solve(matrix_expression< const compressed_matrix<NumericT, Alignmen
 * @param vec    The right hand side vector
 * @param tag    The solver tag identifying the respective triangular solver
 */
-template<typename NumericT, unsigned int AlignmentV>
-void inplace_solve(matrix_expression< const compressed_matrix<NumericT, AlignmentV>,
-                                      const compressed_matrix<NumericT, AlignmentV>,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void inplace_solve(matrix_expression< const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                      const compressed_matrix<NumericT, AlignmentV, IndexT>,
                                       op_trans> const & proxy,
                    vector_base<NumericT> & vec,
                    viennacl::linalg::upper_tag tag)
 {
   NumericT           * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle());
   NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(proxy.lhs().handle());
-  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(proxy.lhs().handle1());
-  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(proxy.lhs().handle2());
+  IndexT const * row_buffer = detail::extract_raw_pointer<IndexT>(proxy.lhs().handle1());
+  IndexT const * col_buffer = detail::extract_raw_pointer<IndexT>(proxy.lhs().handle2());
 
   detail::csr_trans_inplace_solve<NumericT>(row_buffer, col_buffer, elements, vec_buf, proxy.lhs().size1(), tag);
 }
@@ -1153,21 +1932,21 @@ void prod_impl(const viennacl::compressed_compressed_matrix<NumericT> & mat,
 
 namespace detail
 {
-  template<typename NumericT, unsigned int AlignmentV>
-  void row_info(coordinate_matrix<NumericT, AlignmentV> const & mat,
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void row_info(coordinate_matrix<NumericT, AlignmentV, IndexT> const & mat,
                 vector_base<NumericT> & vec,
                 viennacl::linalg::detail::row_info_types info_selector)
   {
     NumericT           * result_buf   = detail::extract_raw_pointer<NumericT>(vec.handle());
     NumericT     const * elements     = detail::extract_raw_pointer<NumericT>(mat.handle());
-    unsigned int const * coord_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle12());
+    IndexT const * coord_buffer = detail::extract_raw_pointer<IndexT>(mat.handle12());
 
     NumericT value = 0;
-    unsigned int last_row = 0;
+    IndexT last_row = 0;
 
     for (vcl_size_t i = 0; i < mat.nnz(); ++i)
     {
-      unsigned int current_row = coord_buffer[2*i];
+      IndexT current_row = coord_buffer[2*i];
 
       if (current_row != last_row)
       {
@@ -1218,8 +1997,8 @@ namespace detail
 * @param vec    The vector
 * @param result The result vector
 */
-template<typename NumericT, unsigned int AlignmentV>
-void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV> & mat,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> & mat,
                const viennacl::vector_base<NumericT> & vec,
                NumericT alpha,
                      viennacl::vector_base<NumericT> & result,
@@ -1228,7 +2007,7 @@ void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV> & mat,
   NumericT           * result_buf   = detail::extract_raw_pointer<NumericT>(result.handle());
   NumericT     const * vec_buf      = detail::extract_raw_pointer<NumericT>(vec.handle());
   NumericT     const * elements     = detail::extract_raw_pointer<NumericT>(mat.handle());
-  unsigned int const * coord_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle12());
+  IndexT const * coord_buffer = detail::extract_raw_pointer<IndexT>(mat.handle12());
 
   if (beta < 0 || beta > 0)
   {
@@ -1254,13 +2033,13 @@ void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV> & mat,
 * @param d_mat      The Dense Matrix
 * @param result     The Result Matrix
 */
-template<typename NumericT, unsigned int AlignmentV>
-void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV> & sp_mat,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> & sp_mat,
                const viennacl::matrix_base<NumericT> & d_mat,
                      viennacl::matrix_base<NumericT> & result) {
 
   NumericT     const * sp_mat_elements = detail::extract_raw_pointer<NumericT>(sp_mat.handle());
-  unsigned int const * sp_mat_coords   = detail::extract_raw_pointer<unsigned int>(sp_mat.handle12());
+  IndexT const * sp_mat_coords   = detail::extract_raw_pointer<IndexT>(sp_mat.handle12());
 
   NumericT const * d_mat_data  = detail::extract_raw_pointer<NumericT>(d_mat);
   NumericT       * result_data = detail::extract_raw_pointer<NumericT>(result);
@@ -1304,14 +2083,15 @@ void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV> & sp_mat,
           result_wrapper_col(row, col) = (NumericT)0; /* filling result with zeros, as the product loops are reordered */
     }
 
+    // entries of the same row may be processed by different threads, hence each thread accumulates into its own columns of the result:
 #ifdef VIENNACL_WITH_OPENMP
   #pragma omp parallel for
 #endif
-    for (long i = 0; i < static_cast<long>(sp_mat.nnz()); ++i) {
-      NumericT x = static_cast<NumericT>(sp_mat_elements[i]);
-      vcl_size_t r = static_cast<vcl_size_t>(sp_mat_coords[2*i]);
-      vcl_size_t c = static_cast<vcl_size_t>(sp_mat_coords[2*i+1]);
-      for (vcl_size_t col = 0; col < d_mat.size2(); ++col) {
+    for (long col = 0; col < static_cast<long>(d_mat.size2()); ++col) {
+      for (vcl_size_t i = 0; i < sp_mat.nnz(); ++i) {
+        NumericT x = static_cast<NumericT>(sp_mat_elements[i]);
+        vcl_size_t r = static_cast<vcl_size_t>(sp_mat_coords[2*i]);
+        vcl_size_t c = static_cast<vcl_size_t>(sp_mat_coords[2*i+1]);
         NumericT y = d_mat_wrapper_row( c, col);
         if (result.row_major())
           result_wrapper_row(r, col) += x * y;
@@ -1368,15 +2148,15 @@ void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV> & sp_mat,
 * @param d_mat      The Dense Transposed Matrix
 * @param result     The Result Matrix
 */
-template<typename NumericT, unsigned int AlignmentV>
-void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV> & sp_mat,
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> & sp_mat,
                const viennacl::matrix_expression< const viennacl::matrix_base<NumericT>,
                                                   const viennacl::matrix_base<NumericT>,
                                                   viennacl::op_trans > & d_mat,
                      viennacl::matrix_base<NumericT> & result) {
 
   NumericT     const * sp_mat_elements     = detail::extract_raw_pointer<NumericT>(sp_mat.handle());
-  unsigned int const * sp_mat_coords       = detail::extract_raw_pointer<unsigned int>(sp_mat.handle12());
+  IndexT const * sp_mat_coords       = detail::extract_raw_pointer<IndexT>(sp_mat.handle12());
 
   NumericT const * d_mat_data = detail::extract_raw_pointer<NumericT>(d_mat.lhs());
   NumericT       * result_data = detail::extract_raw_pointer<NumericT>(result);
@@ -1420,26 +2200,20 @@ void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV> & sp_mat,
           result_wrapper_col( row, col) = (NumericT)0; /* filling result with zeros, as the product loops are reordered */
     }
 
+    // entries of the same row may be processed by different threads, hence each thread accumulates into its own columns of the result:
 #ifdef VIENNACL_WITH_OPENMP
     #pragma omp parallel for
 #endif
-    for (long i = 0; i < static_cast<long>(sp_mat.nnz()); ++i) {
-      NumericT x = static_cast<NumericT>(sp_mat_elements[i]);
-      vcl_size_t r = static_cast<vcl_size_t>(sp_mat_coords[2*i]);
-      vcl_size_t c = static_cast<vcl_size_t>(sp_mat_coords[2*i+1]);
-      if (result.row_major())
-      {
-        for (vcl_size_t col = 0; col < d_mat.size2(); ++col) {
-          NumericT y = d_mat_wrapper_row( col, c);
+    for (long col = 0; col < static_cast<long>(d_mat.size2()); ++col) {
+      for (vcl_size_t i = 0; i < sp_mat.nnz(); ++i) {
+        NumericT x = static_cast<NumericT>(sp_mat_elements[i]);
+        vcl_size_t r = static_cast<vcl_size_t>(sp_mat_coords[2*i]);
+        vcl_size_t c = static_cast<vcl_size_t>(sp_mat_coords[2*i+1]);
+        NumericT y = d_mat_wrapper_row( col, c);
+        if (result.row_major())
           result_wrapper_row(r, col) += x * y;
-        }
-      }
-      else
-      {
-        for (vcl_size_t col = 0; col < d_mat.size2(); ++col) {
-          NumericT y = d_mat_wrapper_row( col, c);
+        else
           result_wrapper_col(r, col) += x * y;
-        }
       }
     }
 
@@ -1460,26 +2234,20 @@ void prod_impl(const viennacl::coordinate_matrix<NumericT, AlignmentV> & sp_mat,
           result_wrapper_col( row, col) = (NumericT)0; /* filling result with zeros, as the product loops are reordered */
     }
 
+    // entries of the same row may be processed by different threads, hence each thread accumulates into its own columns of the result:
 #ifdef VIENNACL_WITH_OPENMP
   #pragma omp parallel for
 #endif
-    for (long i = 0; i < static_cast<long>(sp_mat.nnz()); ++i) {
-      NumericT x = static_cast<NumericT>(sp_mat_elements[i]);
-      vcl_size_t r = static_cast<vcl_size_t>(sp_mat_coords[2*i]);
-      vcl_size_t c = static_cast<vcl_size_t>(sp_mat_coords[2*i+1]);
-      if (result.row_major())
-      {
-        for (vcl_size_t col = 0; col < d_mat.size2(); ++col) {
-          NumericT y = d_mat_wrapper_col( col, c);
+    for (long col = 0; col < static_cast<long>(d_mat.size2()); ++col) {
+      for (vcl_size_t i = 0; i < sp_mat.nnz(); ++i) {
+        NumericT x = static_cast<NumericT>(sp_mat_elements[i]);
+        vcl_size_t r = static_cast<vcl_size_t>(sp_mat_coords[2*i]);
+        vcl_size_t c = static_cast<vcl_size_t>(sp_mat_coords[2*i+1]);
+        NumericT y = d_mat_wrapper_col( col, c);
+        if (result.row_major())
           result_wrapper_row(r, col) += x * y;
-        }
-      }
-      else
-      {
-        for (vcl_size_t col = 0; col < d_mat.size2(); ++col) {
-          NumericT y = d_mat_wrapper_col( col, c);
+        else
           result_wrapper_col(r, col) += x * y;
-        }
       }
     }
   }
@@ -1801,58 +2569,284 @@ void prod_impl(const viennacl::sliced_ell_matrix<NumericT, IndexT> & mat,
                NumericT beta)
 {
   NumericT       * result_buf        = detail::extract_raw_pointer<NumericT>(result.handle());
-  NumericT const * vec_buf           = detail::extract_raw_pointer<NumericT>(vec.handle());
+  NumericT const * vec_buf           = detail::extract_raw_pointer<NumericT>(vec.handle()) + vec.start();
   NumericT const * elements          = detail::extract_raw_pointer<NumericT>(mat.handle());
   IndexT   const * columns_per_block = detail::extract_raw_pointer<IndexT>(mat.handle1());
   IndexT   const * column_indices    = detail::extract_raw_pointer<IndexT>(mat.handle2());
   IndexT   const * block_start       = detail::extract_raw_pointer<IndexT>(mat.handle3());
+  IndexT   const * row_permutation   = (mat.handle4().raw_size() > 0) ? detail::extract_raw_pointer<IndexT>(mat.handle4()) : NULL;
+
+  if (mat.size1() == 0)
+    return;
+
+  // the block kernels gather from a unit-stride vector:
+  std::vector<NumericT> vec_buffer;
+  if (vec.stride() != 1 && vec.size() > 0)
+  {
+    vec_buffer.resize(vec.size());
+    for (vcl_size_t j = 0; j < vec.size(); ++j)
+      vec_buffer[j] = vec_buf[j * vec.stride()];
+    vec_buf = &(vec_buffer[0]);
+  }
 
-  vcl_size_t num_blocks = mat.size1() / mat.rows_per_block() + 1;
+  typename detail::sell_block_kernel<NumericT, IndexT>::type kernel = detail::get_sell_block_kernel(elements, column_indices);
+
+  vcl_size_t rows_per_block = mat.rows_per_block();
+  vcl_size_t num_blocks     = (mat.size1() - 1) / rows_per_block + 1;
 
 #ifdef VIENNACL_WITH_OPENMP
-  #pragma omp parallel for
+  #pragma omp parallel
 #endif
-  for (long block_idx2 = 0; block_idx2 < static_cast<long>(num_blocks); ++block_idx2)
   {
-    vcl_size_t block_idx = static_cast<vcl_size_t>(block_idx2);
-    vcl_size_t current_columns_per_block = columns_per_block[block_idx];
+    std::vector<NumericT> result_values(rows_per_block);
 
-    std::vector<NumericT> result_values(mat.rows_per_block());
-
-    for (IndexT column_entry_index = 0;
-                column_entry_index < current_columns_per_block;
-              ++column_entry_index)
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp for
+#endif
+    for (long block_idx2 = 0; block_idx2 < static_cast<long>(num_blocks); ++block_idx2)
     {
-      vcl_size_t stride_start = block_start[block_idx] + column_entry_index * mat.rows_per_block();
-      // Note: This for-loop may be unrolled by hand for exploiting vectorization
-      //       Careful benchmarking recommended first, memory channels may be saturated already!
-      for (IndexT row_in_block = 0; row_in_block < mat.rows_per_block(); ++row_in_block)
+      vcl_size_t block_idx = static_cast<vcl_size_t>(block_idx2);
+      kernel(rows_per_block, columns_per_block[block_idx],
+             elements + block_start[block_idx], column_indices + block_start[block_idx],
+             vec_buf, &(result_values[0]));
+
+      vcl_size_t first_row_in_block = block_idx * rows_per_block;
+      vcl_size_t rows_in_block      = std::min(rows_per_block, mat.size1() - first_row_in_block);
+      for (vcl_size_t row_in_block = 0; row_in_block < rows_in_block; ++row_in_block)
       {
-        NumericT val = elements[stride_start + row_in_block];
-
-        result_values[row_in_block] += (val > 0 || val < 0) ? vec_buf[column_indices[stride_start + row_in_block] * vec.stride() + vec.start()] * val : 0;
+        vcl_size_t row   = row_permutation ? static_cast<vcl_size_t>(row_permutation[first_row_in_block + row_in_block]) : first_row_in_block + row_in_block;
+        NumericT & y_row = result_buf[row * result.stride() + result.start()];
+        y_row = (beta < 0 || beta > 0) ? alpha * result_values[row_in_block] + beta * y_row : alpha * result_values[row_in_block];
       }
     }
+  }
+}
 
-    vcl_size_t first_row_in_matrix = block_idx * mat.rows_per_block();
-    if (beta < 0 || beta > 0)
+
+//
+// Block Compressed Matrix
+//
+/** @brief Carries out matrix-vector multiplication with a block_compressed_matrix
+*
+* Implementation of the convenience expression result = prod(mat, vec);
+*
+* @param mat    The matrix
+* @param vec    The vector
+* @param result The result vector
+*/
+template<typename NumericT, unsigned int BlockSize>
+void prod_impl(const viennacl::block_compressed_matrix<NumericT, BlockSize> & mat,
+               const viennacl::vector_base<NumericT> & vec,
+               NumericT alpha,
+                     viennacl::vector_base<NumericT> & result,
+               NumericT beta)
+{
+  NumericT           * result_buf = detail::extract_raw_pointer<NumericT>(result.handle());
+  NumericT     const * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle()) + vec.start();
+  NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(mat.handle());
+  unsigned int const * row_blocks = detail::extract_raw_pointer<unsigned int>(mat.handle1());
+  unsigned int const * col_blocks = detail::extract_raw_pointer<unsigned int>(mat.handle2());
+
+  if (mat.size1() == 0)
+    return;
+
+  // the block row kernels read contiguous parts of a unit-stride vector:
+  std::vector<NumericT> vec_buffer;
+  if (vec.stride() != 1 && vec.size() > 0)
+  {
+    vec_buffer.resize(vec.size());
+    for (vcl_size_t j = 0; j < vec.size(); ++j)
+      vec_buffer[j] = vec_buf[j * vec.stride()];
+    vec_buf = &(vec_buffer[0]);
+  }
+
+  typename detail::bsr_block_row_kernel<NumericT, BlockSize>::type kernel = detail::bsr_block_row_kernel<NumericT, BlockSize>::get();
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for
+#endif
+  for (long block_row2 = 0; block_row2 < static_cast<long>(mat.block_rows()); ++block_row2)
+  {
+    vcl_size_t block_row = static_cast<vcl_size_t>(block_row2);
+    vcl_size_t first_block = row_blocks[block_row];
+
+    NumericT result_values[BlockSize];
+    kernel(row_blocks[block_row + 1] - first_block, col_blocks + first_block, elements + first_block * BlockSize * BlockSize, vec_buf, result_values);
+
+    for (vcl_size_t r = 0; r < BlockSize; ++r)
+    {
+      NumericT & y_row = result_buf[(block_row * BlockSize + r) * result.stride() + result.start()];
+      y_row = (beta < 0 || beta > 0) ? alpha * result_values[r] + beta * y_row : alpha * result_values[r];
+    }
+  }
+}
+
+
+//
+// Symmetric Compressed Matrix
+//
+namespace detail
+{
+  /** @brief Computes the partition of the rows of a symmetric_compressed_matrix into blocks of about equal work (stored entries plus rows) for the provided number of threads. */
+  template<typename NumericT>
+  void compute_row_partition(symmetric_compressed_matrix<NumericT> const & A, vcl_size_t thread_count, viennacl::detail::csr_row_partition & partition)
+  {
+    unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(A.handle1());
+    vcl_size_t rows = A.size1();
+    vcl_size_t total_work = rows + ((rows > 0) ? row_buffer[rows] : 0);
+    vcl_size_t blocks = std::max<vcl_size_t>(1, std::min<vcl_size_t>(thread_count, total_work / VIENNACL_HOST_CSR_MIN_WORK_PER_THREAD));
+
+    partition.row_offsets.resize(blocks + 1);
+    partition.row_offsets[0] = 0;
+
+    vcl_size_t block = 1;
+    for (vcl_size_t row = 0; row < rows; ++row)
+      while (block < blocks && row + row_buffer[row] >= (total_work * block) / blocks)
+        partition.row_offsets[block++] = row;
+    for (; block <= blocks; ++block)
+      partition.row_offsets[block] = rows;
+  }
+
+  /** @brief Returns the cached partition of the rows of a symmetric_compressed_matrix for the provided number of threads, computing it under a lock if required. */
+  template<typename NumericT>
+  viennacl::detail::csr_row_partition const & row_partition(symmetric_compressed_matrix<NumericT> const & A, vcl_size_t thread_count)
+  {
+    viennacl::detail::csr_row_statistics & stats = A.row_statistics();
+    viennacl::detail::csr_row_partition * partition = NULL;
+#ifdef VIENNACL_WITH_OPENMP
+    #pragma omp critical(viennacl_csr_row_statistics)
+#endif
     {
-      for (IndexT row_in_block = 0; row_in_block < mat.rows_per_block(); ++row_in_block)
+      std::map<vcl_size_t, viennacl::detail::csr_row_partition>::iterator it = stats.partitions.find(thread_count);
+      if (it == stats.partitions.end())
       {
-        if (first_row_in_matrix + row_in_block < result.size())
-        {
-          vcl_size_t index = (first_row_in_matrix + row_in_block) * result.stride() + result.start();
-          result_buf[index] = alpha * result_values[row_in_block] + beta * result_buf[index];
-        }
+        it = stats.partitions.insert(std::make_pair(thread_count, viennacl::detail::csr_row_partition())).first;
+        compute_row_partition(A, thread_count, it->second);
       }
+      partition = &(it->second);
     }
-    else
+    return *partition;
+  }
+}
+
+/** @brief Carries out matrix-vector multiplication with a symmetric_compressed_matrix
+*
+* Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+*
+* Each stored off-diagonal entry A(i, j) with i < j contributes to row i and to row j. The rows are split into blocks of about equal work, one per thread.
+* Contributions to rows of the own block are accumulated directly, contributions to rows of subsequent blocks are accumulated in a private buffer of the thread
+* covering the rows up to the largest column index of the block. The buffers are added to the result in a second pass, so no atomic operations are needed.
+*
+* @param mat    The matrix
+* @param vec    The vector
+* @param alpha  Scaling factor for the matrix-vector product
+* @param result The result vector
+* @param beta   Scaling factor for the previous content of result. If zero, result is not read.
+*/
+template<typename NumericT>
+void prod_impl(const viennacl::symmetric_compressed_matrix<NumericT> & mat,
+               const viennacl::vector_base<NumericT> & vec,
+               NumericT alpha,
+               viennacl::vector_base<NumericT> & result,
+               NumericT beta)
+{
+  NumericT           * result_buf = detail::extract_raw_pointer<NumericT>(result.handle()) + result.start();
+  NumericT     const * vec_buf    = detail::extract_raw_pointer<NumericT>(vec.handle()) + vec.start();
+  NumericT     const * elements   = detail::extract_raw_pointer<NumericT>(mat.handle());
+  unsigned int const * row_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle1());
+  unsigned int const * col_buffer = detail::extract_raw_pointer<unsigned int>(mat.handle2());
+  vcl_size_t inc_vec    = vec.stride();
+  vcl_size_t inc_result = result.stride();
+
+  if (mat.size1() == 0)
+    return;
+
+  vcl_size_t thread_count = 1;
+#ifdef VIENNACL_WITH_OPENMP
+  thread_count = static_cast<vcl_size_t>(omp_get_max_threads());
+#endif
+
+  viennacl::detail::csr_row_partition const & partition = detail::row_partition(mat, thread_count);
+  std::vector<vcl_size_t> const & row_offsets = partition.row_offsets;
+  long blocks = static_cast<long>(row_offsets.size()) - 1;
+
+  // A * vec is accumulated in the result vector unless its previous content is needed:
+  std::vector<NumericT> product_buffer;
+  NumericT * product = result_buf;
+  vcl_size_t inc_product = inc_result;
+  if (beta < 0 || beta > 0)
+  {
+    product_buffer.resize(mat.size1());
+    product = &(product_buffer[0]);
+    inc_product = 1;
+  }
+
+  // contributions of each block to the rows after the block:
+  std::vector<std::vector<NumericT> > partial_results(static_cast<vcl_size_t>(blocks));
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for num_threads(static_cast<int>(blocks)) if (blocks > 1)
+#endif
+  for (long block2 = 0; block2 < blocks; ++block2)
+  {
+    vcl_size_t block     = static_cast<vcl_size_t>(block2);
+    vcl_size_t row_begin = row_offsets[block];
+    vcl_size_t row_end   = row_offsets[block + 1];
+
+    vcl_size_t col_end = row_end;
+    for (vcl_size_t row = row_begin; row < row_end; ++row)
+    {
+      if (row_buffer[row + 1] > row_buffer[row])
+        col_end = std::max<vcl_size_t>(col_end, col_buffer[row_buffer[row + 1] - 1] + 1);
+      product[row * inc_product] = 0;
+    }
+    std::vector<NumericT> & partial_result = partial_results[block];
+    partial_result.resize(col_end - row_end);
+
+    for (vcl_size_t row = row_begin; row < row_end; ++row)
     {
-      for (IndexT row_in_block = 0; row_in_block < mat.rows_per_block(); ++row_in_block)
+      NumericT vec_row  = vec_buf[row * inc_vec];
+      NumericT dot_prod = 0;
+      vcl_size_t k = row_buffer[row];
+      vcl_size_t k_end = row_buffer[row + 1];
+      if (k < k_end && col_buffer[k] == row) // diagonal entry
+        dot_prod = elements[k++] * vec_row;
+
+      for (; k < k_end; ++k)
       {
-        if (first_row_in_matrix + row_in_block < result.size())
-          result_buf[(first_row_in_matrix + row_in_block) * result.stride() + result.start()] = alpha * result_values[row_in_block];
+        vcl_size_t col = col_buffer[k];
+        dot_prod += elements[k] * vec_buf[col * inc_vec];
+        if (col < row_end)
+          product[col * inc_product] += elements[k] * vec_row;
+        else
+          partial_result[col - row_end] += elements[k] * vec_row;
       }
+      product[row * inc_product] += dot_prod;
+    }
+  }
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for num_threads(static_cast<int>(blocks)) if (blocks > 1)
+#endif
+  for (long block2 = 0; block2 < blocks; ++block2)
+  {
+    vcl_size_t block     = static_cast<vcl_size_t>(block2);
+    vcl_size_t row_begin = row_offsets[block];
+    vcl_size_t row_end   = row_offsets[block + 1];
+
+    for (vcl_size_t other = 0; other < block; ++other)
+    {
+      std::vector<NumericT> const & partial_result = partial_results[other];
+      vcl_size_t offset = row_offsets[other + 1];
+      vcl_size_t other_end = std::min<vcl_size_t>(row_end, offset + partial_result.size());
+      for (vcl_size_t row = row_begin; row < other_end; ++row)
+        product[row * inc_product] += partial_result[row - offset];
+    }
+
+    for (vcl_size_t row = row_begin; row < row_end; ++row)
+    {
+      NumericT & result_row = result_buf[row * inc_result];
+      result_row = (beta < 0 || beta > 0) ? alpha * product[row * inc_product] + beta * result_row : alpha * product[row * inc_product];
     }
   }
 }
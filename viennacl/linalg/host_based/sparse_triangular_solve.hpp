@@ -0,0 +1,415 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_SPARSE_TRIANGULAR_SOLVE_HPP_
+#define VIENNACL_LINALG_HOST_BASED_SPARSE_TRIANGULAR_SOLVE_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/sparse_triangular_solve.hpp
+    @brief A cached schedule for the parallel solution of sparse triangular systems on the CPU, as used by the ILU and incomplete Cholesky preconditioners.
+
+    The rows are grouped into levels (a row only depends on rows of lower levels). Instead of a barrier after each level, every thread processes its rows in the order of
+    their levels and only waits for the rows of other threads it actually depends on (point-to-point synchronization via per-thread progress counters).
+    Dependencies implied by earlier waits of the same thread are dropped, so most rows do not wait at all.
+    Consecutive thin levels, which do not provide enough rows to keep all threads busy, are merged and processed by a single thread without any synchronization.
+
+    The rows are substituted in the same order and with the same arithmetic as the sequential routines csr_inplace_solve() and csr_trans_inplace_solve(),
+    hence the results agree with the sequential substitution.
+*/
+
+#include <vector>
+#include <algorithm>
+
+#include "viennacl/forwards.h"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+/** @brief Levels with fewer than this number of rows per thread are considered thin and are merged with adjacent thin levels into a sequential run. */
+#ifndef VIENNACL_SPARSE_TRIANGULAR_THIN_LEVEL_ROWS_PER_THREAD
+  #define VIENNACL_SPARSE_TRIANGULAR_THIN_LEVEL_ROWS_PER_THREAD 16
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+namespace detail
+{
+
+/** @brief Schedule for the repeated solution of a sparse triangular system with OpenMP threads. Set up once per factor, then solve() is called for each right hand side.
+*
+* The schedule holds a copy of the triangular factor (reordered by thread), so it stays valid if the originating matrix is modified or destroyed.
+* The number of threads is fixed at setup (at most the number of processors). Without OpenMP, or if called from within a parallel region, the rows are substituted sequentially.
+*/
+template<typename NumericT>
+class sparse_triangular_schedule
+{
+public:
+  sparse_triangular_schedule() : size_(0), num_threads_(1), active_threads_(0), unit_diagonal_(false), levels_(0), merged_levels_(0) {}
+
+  /** @brief Sets up the schedule for the triangular part of a CSR matrix.
+  *
+  * @param row_buffer     CSR row array
+  * @param col_buffer     CSR column array
+  * @param elements       CSR value array
+  * @param size           Number of rows
+  * @param lower          If true, the lower triangular part (including the diagonal) is used, otherwise the upper triangular part
+  * @param unit_diagonal  If true, the diagonal entries are assumed to be one and are not accessed
+  */
+  template<typename IndexT>
+  void setup(IndexT const * row_buffer, IndexT const * col_buffer, NumericT const * elements, vcl_size_t size, bool lower, bool unit_diagonal)
+  {
+    std::vector<vcl_size_t> tri_begin(size + 1);
+    std::vector<vcl_size_t> tri_col;
+    std::vector<NumericT>   tri_value;
+    std::vector<NumericT>   diagonal(size, NumericT(0));
+
+    for (vcl_size_t row = 0; row < size; ++row)
+    {
+      tri_begin[row] = tri_col.size();
+      for (vcl_size_t i = row_buffer[row]; i < row_buffer[row+1]; ++i)
+      {
+        vcl_size_t col = col_buffer[i];
+        if (col == row)
+          diagonal[row] = elements[i];
+        else if ((col < row) == lower)
+        {
+          tri_col.push_back(col);
+          tri_value.push_back(elements[i]);
+        }
+      }
+    }
+    tri_begin[size] = tri_col.size();
+
+    build(tri_begin, tri_col, tri_value, diagonal, lower, unit_diagonal);
+  }
+
+  /** @brief Sets up the schedule for the triangular part of the transpose of a CSR matrix, i.e. for the triangular solves of csr_trans_inplace_solve().
+  *
+  * @param lower          If true, the lower triangular part of the transpose (i.e. the upper triangular part of the CSR matrix) is used
+  */
+  template<typename IndexT>
+  void setup_transposed(IndexT const * row_buffer, IndexT const * col_buffer, NumericT const * elements, vcl_size_t size, bool lower, bool unit_diagonal)
+  {
+    std::vector<vcl_size_t> tri_begin(size + 1, 0);
+    std::vector<NumericT>   diagonal(size, NumericT(0));
+
+    // count the entries per row of the transpose:
+    for (vcl_size_t col = 0; col < size; ++col)
+      for (vcl_size_t i = row_buffer[col]; i < row_buffer[col+1]; ++i)
+      {
+        vcl_size_t row = col_buffer[i];
+        if (row != col && (col < row) == lower)
+          ++tri_begin[row + 1];
+      }
+    for (vcl_size_t row = 0; row < size; ++row)
+      tri_begin[row + 1] += tri_begin[row];
+
+    // scatter in ascending order of the columns of the transpose:
+    std::vector<vcl_size_t> tri_col(tri_begin[size]);
+    std::vector<NumericT>   tri_value(tri_begin[size]);
+    std::vector<vcl_size_t> fill(tri_begin.begin(), tri_begin.end() - 1);
+    for (vcl_size_t col = 0; col < size; ++col)
+      for (vcl_size_t i = row_buffer[col]; i < row_buffer[col+1]; ++i)
+      {
+        vcl_size_t row = col_buffer[i];
+        if (row == col)
+          diagonal[row] = elements[i];
+        else if ((col < row) == lower)
+        {
+          tri_col[fill[row]]   = col;
+          tri_value[fill[row]] = elements[i];
+          ++fill[row];
+        }
+      }
+
+    build(tri_begin, tri_col, tri_value, diagonal, lower, unit_diagonal);
+  }
+
+  /** @brief Solves the triangular system in place: On entry, x holds the right hand side, on exit the solution.
+  *
+  * @param x   A pointer to the vector entries, or a host vector type providing operator[]
+  */
+  template<typename ArrayT>
+  void solve(ArrayT & x) const
+  {
+#ifdef VIENNACL_WITH_OPENMP
+    if (active_threads_ > 1 && !omp_in_parallel())
+    {
+      // one counter per cache line:
+      std::vector<long> progress(num_threads_ * progress_stride(), 0);
+      long volatile * progress_ptr = &progress[0];
+
+      #pragma omp parallel num_threads(static_cast<int>(num_threads_))
+      {
+        vcl_size_t thread_id = static_cast<vcl_size_t>(omp_get_thread_num());
+        if (static_cast<vcl_size_t>(omp_get_num_threads()) == num_threads_)
+          solve_thread(x, thread_id, progress_ptr);
+        else if (thread_id == 0) // fewer threads than scheduled (e.g. dynamic adjustment by the runtime), waiting could deadlock
+          solve_sequential(x);
+      }
+      return;
+    }
+#endif
+    solve_sequential(x);
+  }
+
+  /** @brief Returns the number of rows */
+  vcl_size_t size() const { return size_; }
+  /** @brief Returns the number of threads the schedule was set up for */
+  vcl_size_t threads() const { return num_threads_; }
+  /** @brief Returns the number of levels (length of the longest dependency chain) */
+  vcl_size_t levels() const { return levels_; }
+  /** @brief Returns the number of levels after merging consecutive thin levels into sequential runs */
+  vcl_size_t merged_levels() const { return merged_levels_; }
+  /** @brief Returns the total number of waits for other threads per solve */
+  vcl_size_t waits() const { return wait_thread_.size(); }
+
+private:
+  static vcl_size_t progress_stride() { return 128 / sizeof(long); }
+
+  template<typename ArrayT>
+  void solve_row(ArrayT & x, vcl_size_t p) const
+  {
+    NumericT value = x[row_[p]];
+    for (vcl_size_t e = entry_begin_[p]; e < entry_begin_[p+1]; ++e)
+      value -= x[entry_col_[e]] * entry_value_[e];
+    x[row_[p]] = unit_diagonal_ ? value : value / diagonal_[p];
+  }
+
+  template<typename ArrayT>
+  void solve_sequential(ArrayT & x) const
+  {
+    for (vcl_size_t i = 0; i < sequential_order_.size(); ++i)
+      solve_row(x, sequential_order_[i]);
+  }
+
+#ifdef VIENNACL_WITH_OPENMP
+  template<typename ArrayT>
+  void solve_thread(ArrayT & x, vcl_size_t thread_id, long volatile * progress) const
+  {
+    vcl_size_t begin = thread_begin_[thread_id];
+    for (vcl_size_t p = begin; p < thread_begin_[thread_id + 1]; ++p)
+    {
+      if (wait_begin_[p] < wait_begin_[p+1])
+      {
+        for (vcl_size_t w = wait_begin_[p]; w < wait_begin_[p+1]; ++w)
+        {
+          while (progress[wait_thread_[w] * progress_stride()] < wait_count_[w])
+          {
+            #pragma omp flush
+          }
+        }
+        #pragma omp flush
+      }
+
+      solve_row(x, p);
+
+      if (publish_[p])
+      {
+        #pragma omp flush
+        progress[thread_id * progress_stride()] = static_cast<long>(p - begin + 1);
+        #pragma omp flush
+      }
+    }
+  }
+#endif
+
+  void build(std::vector<vcl_size_t> const & tri_begin, std::vector<vcl_size_t> const & tri_col, std::vector<NumericT> const & tri_value,
+             std::vector<NumericT> const & diagonal, bool lower, bool unit_diagonal)
+  {
+    size_ = diagonal.size();
+    unit_diagonal_ = unit_diagonal;
+    num_threads_ = 1;
+#ifdef VIENNACL_WITH_OPENMP
+    // waiting threads spin, so do not oversubscribe the processors:
+    num_threads_ = static_cast<vcl_size_t>(std::max(1, std::min(omp_get_max_threads(), omp_get_num_procs())));
+#endif
+
+    //
+    // Step 1: Levels in processing order (ascending rows for lower, descending rows for upper triangular systems)
+    //
+    std::vector<vcl_size_t> level(size_, 0);
+    levels_ = 0;
+    for (vcl_size_t k = 0; k < size_; ++k)
+    {
+      vcl_size_t row = lower ? k : size_ - k - 1;
+      vcl_size_t row_level = 0;
+      for (vcl_size_t e = tri_begin[row]; e < tri_begin[row+1]; ++e)
+        row_level = std::max(row_level, level[tri_col[e]] + 1);
+      level[row] = row_level;
+      levels_ = std::max(levels_, row_level + 1);
+    }
+
+    std::vector<vcl_size_t> level_begin(levels_ + 1, 0);
+    for (vcl_size_t row = 0; row < size_; ++row)
+      ++level_begin[level[row] + 1];
+    for (vcl_size_t l = 0; l < levels_; ++l)
+      level_begin[l + 1] += level_begin[l];
+
+    std::vector<vcl_size_t> level_rows(size_);
+    std::vector<vcl_size_t> fill(level_begin.begin(), level_begin.end() - 1);
+    for (vcl_size_t row = 0; row < size_; ++row)
+      level_rows[fill[level[row]]++] = row;
+
+    //
+    // Step 2: Assign rows to threads. Wide levels are split into contiguous chunks, runs of consecutive thin levels go to a single thread.
+    //
+    std::vector< std::vector<vcl_size_t> > thread_rows(num_threads_);
+    vcl_size_t thin_level_threshold = VIENNACL_SPARSE_TRIANGULAR_THIN_LEVEL_ROWS_PER_THREAD * num_threads_;
+    vcl_size_t runs = 0;
+    bool in_run = false;
+    merged_levels_ = 0;
+    for (vcl_size_t l = 0; l < levels_; ++l)
+    {
+      vcl_size_t level_size = level_begin[l+1] - level_begin[l];
+      if (num_threads_ == 1 || level_size < thin_level_threshold)
+      {
+        if (!in_run)
+        {
+          ++runs;
+          ++merged_levels_;
+          in_run = true;
+        }
+        for (vcl_size_t k = level_begin[l]; k < level_begin[l+1]; ++k)
+          thread_rows[(runs - 1) % num_threads_].push_back(level_rows[k]);
+      }
+      else
+      {
+        in_run = false;
+        ++merged_levels_;
+        for (vcl_size_t t = 0; t < num_threads_; ++t)
+        {
+          vcl_size_t chunk_begin = level_begin[l] + (level_size * t) / num_threads_;
+          vcl_size_t chunk_end   = level_begin[l] + (level_size * (t + 1)) / num_threads_;
+          for (vcl_size_t k = chunk_begin; k < chunk_end; ++k)
+            thread_rows[t].push_back(level_rows[k]);
+        }
+      }
+    }
+
+    //
+    // Step 3: Copy the factor in thread order
+    //
+    std::vector<vcl_size_t> owner(size_);
+    std::vector<vcl_size_t> position(size_); // global position of each row
+    thread_begin_.resize(num_threads_ + 1);
+    row_.resize(size_);
+    diagonal_.resize(size_);
+    entry_begin_.resize(size_ + 1);
+    entry_col_.resize(tri_col.size());
+    entry_value_.resize(tri_value.size());
+    active_threads_ = 0;
+
+    vcl_size_t p = 0;
+    vcl_size_t e = 0;
+    for (vcl_size_t t = 0; t < num_threads_; ++t)
+    {
+      thread_begin_[t] = p;
+      if (thread_rows[t].size() > 0)
+        ++active_threads_;
+      for (vcl_size_t k = 0; k < thread_rows[t].size(); ++k, ++p)
+      {
+        vcl_size_t row = thread_rows[t][k];
+        owner[row]    = t;
+        position[row] = p;
+        row_[p]       = row;
+        diagonal_[p]  = diagonal[row];
+        entry_begin_[p] = e;
+        for (vcl_size_t i = tri_begin[row]; i < tri_begin[row+1]; ++i, ++e)
+        {
+          entry_col_[e]   = tri_col[i];
+          entry_value_[e] = tri_value[i];
+        }
+      }
+    }
+    thread_begin_[num_threads_] = p;
+    entry_begin_[size_] = e;
+
+    //
+    // Step 4: Waits for rows of other threads. A thread processes its rows in order, so a wait implies all waits for fewer rows of the same thread and is skipped if already implied.
+    //
+    wait_begin_.resize(size_ + 1);
+    wait_thread_.clear();
+    wait_count_.clear();
+    publish_.assign(size_, false);
+
+    std::vector<long> required(num_threads_);
+    std::vector<long> known(num_threads_);
+    for (vcl_size_t t = 0; t < num_threads_; ++t)
+    {
+      std::fill(known.begin(), known.end(), 0);
+      for (p = thread_begin_[t]; p < thread_begin_[t+1]; ++p)
+      {
+        wait_begin_[p] = wait_thread_.size();
+        std::fill(required.begin(), required.end(), 0);
+        for (e = entry_begin_[p]; e < entry_begin_[p+1]; ++e)
+        {
+          vcl_size_t dependency = entry_col_[e];
+          vcl_size_t u = owner[dependency];
+          if (u != t)
+            required[u] = std::max(required[u], static_cast<long>(position[dependency] - thread_begin_[u] + 1));
+        }
+        for (vcl_size_t u = 0; u < num_threads_; ++u)
+          if (required[u] > known[u])
+          {
+            wait_thread_.push_back(u);
+            wait_count_.push_back(required[u]);
+            publish_[thread_begin_[u] + static_cast<vcl_size_t>(required[u]) - 1] = true;
+            known[u] = required[u];
+          }
+      }
+    }
+    wait_begin_[size_] = wait_thread_.size();
+
+    //
+    // Step 5: Level order for sequential substitution
+    //
+    sequential_order_.resize(size_);
+    for (vcl_size_t k = 0; k < size_; ++k)
+      sequential_order_[k] = position[level_rows[k]];
+  }
+
+  vcl_size_t size_;
+  vcl_size_t num_threads_;
+  vcl_size_t active_threads_;
+  bool       unit_diagonal_;
+  vcl_size_t levels_;
+  vcl_size_t merged_levels_;
+
+  std::vector<vcl_size_t> thread_begin_;     // first position of each thread
+  std::vector<vcl_size_t> row_;              // row at each position
+  std::vector<NumericT>   diagonal_;
+  std::vector<vcl_size_t> entry_begin_;      // off-diagonal entries of the row at each position
+  std::vector<vcl_size_t> entry_col_;
+  std::vector<NumericT>   entry_value_;
+  std::vector<vcl_size_t> wait_begin_;       // waits before the row at each position
+  std::vector<vcl_size_t> wait_thread_;
+  std::vector<long>       wait_count_;       // number of rows of wait_thread_ which need to be completed
+  std::vector<bool>       publish_;          // whether the progress of the thread needs to be published after the row at each position
+  std::vector<vcl_size_t> sequential_order_;
+};
+
+} //namespace detail
+} //namespace host_based
+} //namespace linalg
+} //namespace viennacl
+
+#endif
@@ -0,0 +1,368 @@
+#ifndef VIENNACL_LINALG_HOST_BASED_SPGEMM_ACCUMULATOR_HPP_
+#define VIENNACL_LINALG_HOST_BASED_SPGEMM_ACCUMULATOR_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/linalg/host_based/spgemm_accumulator.hpp
+    @brief Hash table and dense accumulators for rows of sparse matrix-matrix products with many contributing rows, complementing the row merges in spgemm_vector.hpp.
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include "viennacl/forwards.h"
+
+// Rows of A with at most this number of entries are computed by merging the respective rows of B:
+#ifndef VIENNACL_HOST_SPGEMM_MERGE_MAX_ROWS
+  #define VIENNACL_HOST_SPGEMM_MERGE_MAX_ROWS  16
+#endif
+
+// Rows of C with an upper bound for the number of entries of at least B.size2() / VIENNACL_HOST_SPGEMM_DENSE_FRACTION are accumulated in a dense array, all other rows with many contributions in a hash table:
+#ifndef VIENNACL_HOST_SPGEMM_DENSE_FRACTION
+  #define VIENNACL_HOST_SPGEMM_DENSE_FRACTION  16
+#endif
+
+namespace viennacl
+{
+namespace linalg
+{
+namespace host_based
+{
+
+/** @brief Method for computing a row of C = A * B */
+enum spgemm_row_method
+{
+  SPGEMM_ROW_MERGE = 0,  // merge of the rows of B (spgemm_vector.hpp)
+  SPGEMM_ROW_HASH,       // accumulation in a hash table of the size of the upper bound
+  SPGEMM_ROW_DENSE       // accumulation in a dense array of length B.size2()
+};
+
+/** @brief Returns the upper bound for the number of entries in a row of C = A * B, i.e. the total number of entries in the rows of B referenced by the row of A. */
+inline unsigned int spgemm_row_upper_bound(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer,
+                                           unsigned int const *B_row_buffer)
+{
+  unsigned int upper_bound = 0;
+  for (unsigned int j = row_start_A; j < row_end_A; ++j)
+    upper_bound += B_row_buffer[A_col_buffer[j] + 1] - B_row_buffer[A_col_buffer[j]];
+  return upper_bound;
+}
+
+/** @brief Selects the method for computing a row of C = A * B.
+*
+* The cost of the merge grows with the number of rows of B merged, so only rows of A with few entries are merged.
+* For all other rows the products are accumulated in a hash table, or in a dense array if the row of C is likely to fill a considerable fraction of the columns.
+*
+* @param rows_merged   Number of entries in the row of A
+* @param upper_bound   Upper bound for the number of entries in the row of C as obtained from spgemm_row_upper_bound()
+* @param B_size2       Number of columns of B
+*/
+inline spgemm_row_method spgemm_select_row_method(unsigned int rows_merged, unsigned int upper_bound, unsigned int B_size2)
+{
+  if (rows_merged <= VIENNACL_HOST_SPGEMM_MERGE_MAX_ROWS)
+    return SPGEMM_ROW_MERGE;
+  if (vcl_size_t(upper_bound) * VIENNACL_HOST_SPGEMM_DENSE_FRACTION >= vcl_size_t(B_size2))
+    return SPGEMM_ROW_DENSE;
+  return SPGEMM_ROW_HASH;
+}
+
+
+/** @brief Per-thread work space for the hash table and dense accumulation of rows of C = A * B.
+*
+* Buffers are allocated on first use and reused for all subsequent rows processed by the thread.
+* Both accumulators compute the full structural sparsity pattern (including entries cancelling to zero), hence yield the same patterns as the merge.
+*/
+template<typename NumericT>
+class spgemm_accumulator
+{
+public:
+  explicit spgemm_accumulator(unsigned int B_size2) : B_size2_(B_size2), current_row_(0) {}
+
+  /** @brief Returns the number of entries in a row of C = A * B using a hash table with (at least) twice the upper bound as capacity */
+  unsigned int symbolic_hash(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer,
+                             unsigned int const *B_row_buffer, unsigned int const *B_col_buffer, unsigned int upper_bound)
+  {
+    unsigned int mask = prepare_hash_table(upper_bound);
+    unsigned int row_C_len = 0;
+
+    for (unsigned int j = row_start_A; j < row_end_A; ++j)
+    {
+      unsigned int B_end = B_row_buffer[A_col_buffer[j] + 1];
+      for (unsigned int k = B_row_buffer[A_col_buffer[j]]; k < B_end; ++k)
+      {
+        unsigned int col = B_col_buffer[k];
+        unsigned int pos = hash(col) & mask;
+        while (hash_keys_[pos] != col && hash_keys_[pos] != empty_key())
+          pos = (pos + 1) & mask;
+        if (hash_keys_[pos] == empty_key())
+        {
+          hash_keys_[pos] = col;
+          ++row_C_len;
+        }
+      }
+    }
+
+    clear_hash_table(mask);
+    return row_C_len;
+  }
+
+  /** @brief Computes the sparsity pattern of a row of C = A * B using a hash table. The column indices are written to C_col_buffer, sorted. Returns the number of entries. */
+  unsigned int pattern_hash(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer,
+                            unsigned int const *B_row_buffer, unsigned int const *B_col_buffer, unsigned int upper_bound,
+                            unsigned int *C_col_buffer)
+  {
+    unsigned int mask = prepare_hash_table(upper_bound);
+    unsigned int row_C_len = 0;
+
+    for (unsigned int j = row_start_A; j < row_end_A; ++j)
+    {
+      unsigned int B_end = B_row_buffer[A_col_buffer[j] + 1];
+      for (unsigned int k = B_row_buffer[A_col_buffer[j]]; k < B_end; ++k)
+      {
+        unsigned int col = B_col_buffer[k];
+        unsigned int pos = hash(col) & mask;
+        while (hash_keys_[pos] != col && hash_keys_[pos] != empty_key())
+          pos = (pos + 1) & mask;
+        if (hash_keys_[pos] == empty_key())
+        {
+          hash_keys_[pos] = col;
+          C_col_buffer[row_C_len++] = col;
+        }
+      }
+    }
+
+    std::sort(C_col_buffer, C_col_buffer + row_C_len);
+    clear_hash_table(mask);
+    return row_C_len;
+  }
+
+  /** @brief Computes a row of C = A * B using a hash table. The column indices and values are written to C_col_buffer and C_elements, sorted by column. Returns the number of entries. */
+  unsigned int numeric_hash(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer, NumericT const *A_elements,
+                    unsigned int const *B_row_buffer, unsigned int const *B_col_buffer, NumericT const *B_elements, unsigned int upper_bound,
+                    unsigned int *C_col_buffer, NumericT *C_elements)
+  {
+    unsigned int mask = prepare_hash_table(upper_bound);
+    if (hash_values_.size() < hash_keys_.size())
+      hash_values_.resize(hash_keys_.size());
+
+    unsigned int row_C_len = 0;
+    for (unsigned int j = row_start_A; j < row_end_A; ++j)
+    {
+      NumericT A_value = A_elements[j];
+      unsigned int B_end = B_row_buffer[A_col_buffer[j] + 1];
+      for (unsigned int k = B_row_buffer[A_col_buffer[j]]; k < B_end; ++k)
+      {
+        unsigned int col = B_col_buffer[k];
+        unsigned int pos = hash(col) & mask;
+        while (hash_keys_[pos] != col && hash_keys_[pos] != empty_key())
+          pos = (pos + 1) & mask;
+        if (hash_keys_[pos] == empty_key())
+        {
+          hash_keys_[pos]   = col;
+          hash_values_[pos] = A_value * B_elements[k];
+          C_col_buffer[row_C_len++] = col;
+        }
+        else
+          hash_values_[pos] += A_value * B_elements[k];
+      }
+    }
+
+    // write the entries sorted by column:
+    std::sort(C_col_buffer, C_col_buffer + row_C_len);
+    for (unsigned int i = 0; i < row_C_len; ++i)
+    {
+      unsigned int pos = hash(C_col_buffer[i]) & mask;
+      while (hash_keys_[pos] != C_col_buffer[i])
+        pos = (pos + 1) & mask;
+      C_elements[i] = hash_values_[pos];
+    }
+
+    clear_hash_table(mask);
+    return row_C_len;
+  }
+
+  /** @brief Returns the number of entries in a row of C = A * B using a dense marker array */
+  unsigned int symbolic_dense(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer,
+                              unsigned int const *B_row_buffer, unsigned int const *B_col_buffer)
+  {
+    unsigned int row_id = next_dense_row();
+    unsigned int row_C_len = 0;
+
+    for (unsigned int j = row_start_A; j < row_end_A; ++j)
+    {
+      unsigned int B_end = B_row_buffer[A_col_buffer[j] + 1];
+      for (unsigned int k = B_row_buffer[A_col_buffer[j]]; k < B_end; ++k)
+      {
+        unsigned int col = B_col_buffer[k];
+        if (dense_marker_[col] != row_id)
+        {
+          dense_marker_[col] = row_id;
+          ++row_C_len;
+        }
+      }
+    }
+
+    return row_C_len;
+  }
+
+  /** @brief Computes the sparsity pattern of a row of C = A * B using a dense marker array. The column indices are written to C_col_buffer, sorted. Returns the number of entries. */
+  unsigned int pattern_dense(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer,
+                             unsigned int const *B_row_buffer, unsigned int const *B_col_buffer,
+                             unsigned int *C_col_buffer)
+  {
+    unsigned int row_id = next_dense_row();
+    unsigned int row_C_len = 0;
+    unsigned int min_col = B_size2_;
+    unsigned int max_col = 0;
+
+    for (unsigned int j = row_start_A; j < row_end_A; ++j)
+    {
+      unsigned int B_end = B_row_buffer[A_col_buffer[j] + 1];
+      for (unsigned int k = B_row_buffer[A_col_buffer[j]]; k < B_end; ++k)
+      {
+        unsigned int col = B_col_buffer[k];
+        if (dense_marker_[col] != row_id)
+        {
+          dense_marker_[col] = row_id;
+          C_col_buffer[row_C_len++] = col;
+          min_col = std::min(min_col, col);
+          max_col = std::max(max_col, col);
+        }
+      }
+    }
+
+    if (row_C_len == 0)
+      return 0;
+
+    // same choice between a scan of the marker array and sorting as in numeric_dense():
+    if (max_col - min_col + 1 <= 8 * row_C_len)
+    {
+      row_C_len = 0;
+      for (unsigned int col = min_col; col <= max_col; ++col)
+        if (dense_marker_[col] == row_id)
+          C_col_buffer[row_C_len++] = col;
+    }
+    else
+      std::sort(C_col_buffer, C_col_buffer + row_C_len);
+
+    return row_C_len;
+  }
+
+  /** @brief Computes a row of C = A * B using a dense accumulator. The column indices and values are written to C_col_buffer and C_elements, sorted by column. Returns the number of entries. */
+  unsigned int numeric_dense(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer, NumericT const *A_elements,
+                     unsigned int const *B_row_buffer, unsigned int const *B_col_buffer, NumericT const *B_elements,
+                     unsigned int *C_col_buffer, NumericT *C_elements)
+  {
+    unsigned int row_id = next_dense_row();
+    if (dense_values_.size() < B_size2_)
+      dense_values_.resize(B_size2_);
+
+    unsigned int row_C_len = 0;
+    unsigned int min_col = B_size2_;
+    unsigned int max_col = 0;
+    for (unsigned int j = row_start_A; j < row_end_A; ++j)
+    {
+      NumericT A_value = A_elements[j];
+      unsigned int B_end = B_row_buffer[A_col_buffer[j] + 1];
+      for (unsigned int k = B_row_buffer[A_col_buffer[j]]; k < B_end; ++k)
+      {
+        unsigned int col = B_col_buffer[k];
+        if (dense_marker_[col] != row_id)
+        {
+          dense_marker_[col] = row_id;
+          dense_values_[col] = A_value * B_elements[k];
+          C_col_buffer[row_C_len++] = col;
+          min_col = std::min(min_col, col);
+          max_col = std::max(max_col, col);
+        }
+        else
+          dense_values_[col] += A_value * B_elements[k];
+      }
+    }
+
+    if (row_C_len == 0)
+      return 0;
+
+    // sorting the column indices only pays off if the row of C is sparse within its column range:
+    if (max_col - min_col + 1 <= 8 * row_C_len)
+    {
+      row_C_len = 0;
+      for (unsigned int col = min_col; col <= max_col; ++col)
+        if (dense_marker_[col] == row_id)
+          C_col_buffer[row_C_len++] = col;
+    }
+    else
+      std::sort(C_col_buffer, C_col_buffer + row_C_len);
+
+    for (unsigned int i = 0; i < row_C_len; ++i)
+      C_elements[i] = dense_values_[C_col_buffer[i]];
+    return row_C_len;
+  }
+
+private:
+  static unsigned int hash(unsigned int col)
+  {
+    unsigned int h = col * 2654435761u;  // multiplicative hashing, mixing the high bits into the low bits used for the slot index
+    return h ^ (h >> 16);
+  }
+  static unsigned int empty_key() { return ~0u; }
+
+  /** @brief Makes sure the hash table holds at least twice the upper bound (but not more than needed for all columns of B), returns the mask for the slot index */
+  unsigned int prepare_hash_table(unsigned int upper_bound)
+  {
+    unsigned int entries = std::min(upper_bound, B_size2_);
+    unsigned int capacity = 16;
+    while (capacity < 2 * entries)
+      capacity *= 2;
+    if (hash_keys_.size() < capacity)
+      hash_keys_.resize(capacity, empty_key());
+    return capacity - 1;
+  }
+
+  void clear_hash_table(unsigned int mask)
+  {
+    std::fill(hash_keys_.begin(), hash_keys_.begin() + mask + 1, empty_key());
+  }
+
+  /** @brief Returns a new identifier for the entries of the dense marker array belonging to the current row, avoiding a reset of the array for each row */
+  unsigned int next_dense_row()
+  {
+    if (dense_marker_.size() < B_size2_)
+      dense_marker_.resize(B_size2_, 0);
+    if (++current_row_ == 0) // wrap-around: reset marker array
+    {
+      std::fill(dense_marker_.begin(), dense_marker_.end(), 0u);
+      current_row_ = 1;
+    }
+    return current_row_;
+  }
+
+  unsigned int B_size2_;
+  unsigned int current_row_;
+
+  std::vector<unsigned int> hash_keys_;
+  std::vector<NumericT>     hash_values_;
+  std::vector<unsigned int> dense_marker_;
+  std::vector<NumericT>     dense_values_;
+};
+
+} // namespace host_based
+} //namespace linalg
+} //namespace viennacl
+
+
+#endif
@@ -24,11 +24,7 @@
 
 #include "viennacl/forwards.h"
 #include "viennacl/linalg/host_based/common.hpp"
-
-
-#ifdef VIENNACL_WITH_AVX2
-#include "immintrin.h"
-#endif
+#include "viennacl/linalg/host_based/cpu_dispatch.hpp"
 
 
 namespace viennacl
@@ -40,7 +36,19 @@ namespace host_based
 
 
 
-#ifdef VIENNACL_WITH_AVX2
+/** @brief Returns true if the AVX2 variants of the row merges are used. Selected at runtime based on the CPU capabilities. */
+inline bool spgemm_use_avx2()
+{
+  static cpu_dispatcher<bool> const dispatcher = cpu_dispatcher<bool>("spgemm", false)
+#ifdef VIENNACL_HOST_X86_SIMD
+                                                   .add(cpu_isa_avx2, true)
+#endif
+                                                   ;
+  return dispatcher.get();
+}
+
+#ifdef VIENNACL_HOST_X86_SIMD
+VIENNACL_HOST_TARGET_AVX2
 inline
 unsigned int row_C_scan_symbolic_vector_AVX2(int const *row_indices_B_begin, int const *row_indices_B_end,
                                              int const *B_row_buffer, int const *B_col_buffer, int B_size2,
@@ -79,7 +87,7 @@ unsigned int row_C_scan_symbolic_vector_AVX2(int const *row_indices_B_begin, int
     avx_temp       = _mm256_shuffle_epi32(avx_index_min1, int(177));    // 0b10110001 = 177, using shuffle instead of permutevar here because of lower latency
     avx_index_min1 = _mm256_min_epi32(avx_index_min1, avx_temp); // now all entries of avx_index_min1 hold the minimum
 
-    int min_index_in_front = ((int*)&avx_index_min1)[0];
+    int min_index_in_front = _mm_cvtsi128_si32(_mm256_castsi256_si128(avx_index_min1));
     // check for end of merge operation:
     if (min_index_in_front == B_size2)
       break;
@@ -103,6 +111,12 @@ unsigned int row_C_scan_symbolic_vector_AVX2(int const *row_indices_B_begin, int
 
   return static_cast<unsigned int>(output_ptr - row_C_vector_output);
 }
+#else
+inline
+unsigned int row_C_scan_symbolic_vector_AVX2(int const *, int const *, int const *, int const *, int, int *)
+{
+  return 0; // never called, since spgemm_use_avx2() returns false
+}
 #endif
 
 /** @brief Merges up to IndexNum rows from B into the result buffer.
@@ -218,6 +232,8 @@ unsigned int row_C_scan_symbolic_vector(unsigned int row_start_A, unsigned int r
     return B_row_buffer[A_col + 1] - B_row_buffer[A_col];
   }
 
+  bool use_avx2 = spgemm_use_avx2();
+
   // Optimizations for row length 2:
   unsigned int row_C_len = 0;
   if (row_end_A - row_start_A == 2)
@@ -229,14 +245,15 @@ unsigned int row_C_scan_symbolic_vector(unsigned int row_start_A, unsigned int r
                                                                       B_size2,
                                                                       row_C_vector_1);
   }
-  else // for more than two rows we can safely merge the first two:
+  else if (use_avx2) // for more than two rows we can safely merge up to eight:
   {
-#ifdef VIENNACL_WITH_AVX2
     row_C_len = row_C_scan_symbolic_vector_AVX2((const int*)(A_col_buffer + row_start_A), (const int*)(A_col_buffer + row_end_A),
                                                 (const int*)B_row_buffer, (const int*)B_col_buffer, int(B_size2),
                                                 (int*)row_C_vector_1);
     row_start_A += 8;
-#else
+  }
+  else // for more than two rows we can safely merge the first two:
+  {
     unsigned int A_col_1 = A_col_buffer[row_start_A];
     unsigned int A_col_2 = A_col_buffer[row_start_A + 1];
     row_C_len =  row_C_scan_symbolic_vector_1<spgemm_output_write_enabled>(B_col_buffer + B_row_buffer[A_col_1], B_col_buffer + B_row_buffer[A_col_1 + 1],
@@ -244,14 +261,12 @@ unsigned int row_C_scan_symbolic_vector(unsigned int row_start_A, unsigned int r
                                                                            B_size2,
                                                                            row_C_vector_1);
     row_start_A += 2;
-#endif
   }
 
   // all other row lengths:
   while (row_end_A > row_start_A)
   {
-#ifdef VIENNACL_WITH_AVX2
-    if (row_end_A - row_start_A > 2) // we deal with one or two remaining rows more efficiently below:
+    if (use_avx2 && row_end_A - row_start_A > 2) // we deal with one or two remaining rows more efficiently below:
     {
       unsigned int merged_len = row_C_scan_symbolic_vector_AVX2((const int*)(A_col_buffer + row_start_A), (const int*)(A_col_buffer + row_end_A),
                                                                 (const int*)B_row_buffer, (const int*)B_col_buffer, int(B_size2),
@@ -268,9 +283,7 @@ unsigned int row_C_scan_symbolic_vector(unsigned int row_start_A, unsigned int r
                                                                                row_C_vector_2);
       row_start_A += 8;
     }
-    else
-#endif
-    if (row_start_A == row_end_A - 1) // last merge operation. No need to write output
+    else if (row_start_A == row_end_A - 1) // last merge operation. No need to write output
     {
       // process last row
       unsigned int row_index_B = A_col_buffer[row_start_A];
@@ -317,6 +330,49 @@ unsigned int row_C_scan_symbolic_vector(unsigned int row_start_A, unsigned int r
   return row_C_len;
 }
 
+/** @brief Merges the rows of B referenced by a row of A and writes the column indices of the respective row of C = A * B to row_C_cols. Returns the number of entries.
+*
+* Two rows of B are merged at a time, the last merge writes directly to row_C_cols.
+**/
+inline
+unsigned int row_C_scan_pattern_vector(unsigned int row_start_A, unsigned int row_end_A, unsigned int const *A_col_buffer,
+                                       unsigned int const *B_row_buffer, unsigned int const *B_col_buffer, unsigned int B_size2,
+                                       unsigned int *row_C_vector_1, unsigned int *row_C_vector_2, unsigned int *row_C_vector_3,
+                                       unsigned int *row_C_cols)
+{
+  unsigned int row_C_len = 0;
+  while (row_start_A < row_end_A)
+  {
+    if (row_start_A + 1 < row_end_A) // merge two rows of B, then merge with the result so far:
+    {
+      unsigned int A_col_1 = A_col_buffer[row_start_A];
+      unsigned int A_col_2 = A_col_buffer[row_start_A + 1];
+      unsigned int merged_len = row_C_scan_symbolic_vector_1<spgemm_output_write_enabled>(B_col_buffer + B_row_buffer[A_col_1], B_col_buffer + B_row_buffer[A_col_1 + 1],
+                                                                                          B_col_buffer + B_row_buffer[A_col_2], B_col_buffer + B_row_buffer[A_col_2 + 1],
+                                                                                          B_size2,
+                                                                                          row_C_vector_3);
+      row_start_A += 2;
+      row_C_len = row_C_scan_symbolic_vector_1<spgemm_output_write_enabled>(row_C_vector_3, row_C_vector_3 + merged_len,
+                                                                            row_C_vector_1, row_C_vector_1 + row_C_len,
+                                                                            B_size2,
+                                                                            (row_start_A == row_end_A) ? row_C_cols : row_C_vector_2);
+    }
+    else // last row of B:
+    {
+      unsigned int row_index_B = A_col_buffer[row_start_A];
+      row_C_len = row_C_scan_symbolic_vector_1<spgemm_output_write_enabled>(B_col_buffer + B_row_buffer[row_index_B], B_col_buffer + B_row_buffer[row_index_B + 1],
+                                                                            row_C_vector_1, row_C_vector_1 + row_C_len,
+                                                                            B_size2,
+                                                                            row_C_cols);
+      ++row_start_A;
+    }
+
+    std::swap(row_C_vector_1, row_C_vector_2);
+  }
+
+  return row_C_len;
+}
+
 //////////////////////////////
 
 /** @brief Merges up to IndexNum rows from B into the result buffer.
@@ -392,7 +448,8 @@ unsigned int row_C_scan_numeric_vector_N(unsigned int const *row_indices_B, Nume
 
 
 
-#ifdef VIENNACL_WITH_AVX2
+#ifdef VIENNACL_HOST_X86_SIMD
+VIENNACL_HOST_TARGET_AVX2
 inline
 unsigned int row_C_scan_numeric_vector_AVX2(int const *row_indices_B_begin, int const *row_indices_B_end, double const *values_A,
                                              int const *B_row_buffer, int const *B_col_buffer, double const *B_elements,
@@ -414,12 +471,12 @@ unsigned int row_C_scan_numeric_vector_AVX2(int const *row_indices_B_begin, int
   __m256d avx_value_A_low  = _mm256_mask_i32gather_pd(_mm256_set_pd(0, 0, 0, 0), //src
                                                       values_A,                  //base ptr
                                                       _mm256_extractf128_si256(avx_row_indices_offsets, 0),                           //indices
-                                                      _mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(3, 7, 2, 6, 1, 5, 0, 4)), 8); // mask
+                                                      _mm256_castsi256_pd(_mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(3, 7, 2, 6, 1, 5, 0, 4))), 8); // mask
   avx_load_mask = avx_load_mask2; // reload mask (destroyed by gather)
   __m256d avx_value_A_high  = _mm256_mask_i32gather_pd(_mm256_set_pd(0, 0, 0, 0), //src
                                                        values_A,                  //base ptr
                                                        _mm256_extractf128_si256(avx_row_indices_offsets, 1),                           //indices
-                                                       _mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(7, 3, 6, 2, 5, 1, 4, 0)), 8); // mask
+                                                       _mm256_castsi256_pd(_mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(7, 3, 6, 2, 5, 1, 4, 0))), 8); // mask
 
 
             avx_load_mask = avx_load_mask2; // reload mask (destroyed by gather)
@@ -437,12 +494,12 @@ unsigned int row_C_scan_numeric_vector_AVX2(int const *row_indices_B_begin, int
   __m256d avx_value_front_low  = _mm256_mask_i32gather_pd(_mm256_set_pd(0, 0, 0, 0), //src
                                                           B_elements,                  //base ptr
                                                           _mm256_extractf128_si256(avx_row_start, 0),                           //indices
-                                                          _mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(3, 7, 2, 6, 1, 5, 0, 4)), 8); // mask
+                                                          _mm256_castsi256_pd(_mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(3, 7, 2, 6, 1, 5, 0, 4))), 8); // mask
   avx_load_mask = avx_load_mask2; // reload mask (destroyed by gather)
   __m256d avx_value_front_high  = _mm256_mask_i32gather_pd(_mm256_set_pd(0, 0, 0, 0), //src
                                                            B_elements,                  //base ptr
                                                            _mm256_extractf128_si256(avx_row_start, 1),                           //indices
-                                                           _mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(7, 3, 6, 2, 5, 1, 4, 0)), 8); // mask
+                                                           _mm256_castsi256_pd(_mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(7, 3, 6, 2, 5, 1, 4, 0))), 8); // mask
 
   int *output_ptr = row_C_vector_output;
 
@@ -459,21 +516,21 @@ unsigned int row_C_scan_numeric_vector_AVX2(int const *row_indices_B_begin, int
     avx_temp       = _mm256_shuffle_epi32(avx_index_min1, int(177));    // 0b10110001 = 177, using shuffle instead of permutevar here because of lower latency
     avx_index_min1 = _mm256_min_epi32(avx_index_min1, avx_temp); // now all entries of avx_index_min1 hold the minimum
 
-    int min_index_in_front = ((int*)&avx_index_min1)[0];
+    int min_index_in_front = _mm_cvtsi128_si32(_mm256_castsi256_si128(avx_index_min1));
     // check for end of merge operation:
     if (min_index_in_front == B_size2)
       break;
 
     // accumulate value (can certainly be done more elegantly...)
+    int    index_front[8];
+    double products[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(index_front), avx_index_front);
+    _mm256_storeu_pd(products,     _mm256_mul_pd(avx_value_front_low,  avx_value_A_low));
+    _mm256_storeu_pd(products + 4, _mm256_mul_pd(avx_value_front_high, avx_value_A_high));
+
     double value = 0;
-    value += (min_index_in_front == ((int*)&avx_index_front)[0]) ? ((double*)&avx_value_front_low)[0] * ((double*)&avx_value_A_low)[0] : 0;
-    value += (min_index_in_front == ((int*)&avx_index_front)[1]) ? ((double*)&avx_value_front_low)[1] * ((double*)&avx_value_A_low)[1] : 0;
-    value += (min_index_in_front == ((int*)&avx_index_front)[2]) ? ((double*)&avx_value_front_low)[2] * ((double*)&avx_value_A_low)[2] : 0;
-    value += (min_index_in_front == ((int*)&avx_index_front)[3]) ? ((double*)&avx_value_front_low)[3] * ((double*)&avx_value_A_low)[3] : 0;
-    value += (min_index_in_front == ((int*)&avx_index_front)[4]) ? ((double*)&avx_value_front_high)[0] * ((double*)&avx_value_A_high)[0] : 0;
-    value += (min_index_in_front == ((int*)&avx_index_front)[5]) ? ((double*)&avx_value_front_high)[1] * ((double*)&avx_value_A_high)[1] : 0;
-    value += (min_index_in_front == ((int*)&avx_index_front)[6]) ? ((double*)&avx_value_front_high)[2] * ((double*)&avx_value_A_high)[2] : 0;
-    value += (min_index_in_front == ((int*)&avx_index_front)[7]) ? ((double*)&avx_value_front_high)[3] * ((double*)&avx_value_A_high)[3] : 0;
+    for (unsigned int i = 0; i < 8; ++i)
+      value += (min_index_in_front == index_front[i]) ? products[i] : 0;
     *row_C_vector_output_values = value;
     ++row_C_vector_output_values;
 
@@ -499,13 +556,13 @@ unsigned int row_C_scan_numeric_vector_AVX2(int const *row_indices_B_begin, int
     avx_value_front_low = _mm256_mask_i32gather_pd(avx_value_front_low, //src
                                             B_elements,                  //base ptr
                                             _mm256_extractf128_si256(avx_row_start, 0),                           //indices
-                                            _mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(3, 7, 2, 6, 1, 5, 0, 4)), 8); // mask
+                                            _mm256_castsi256_pd(_mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(3, 7, 2, 6, 1, 5, 0, 4))), 8); // mask
 
     avx_load_mask = avx_load_mask2; // reload mask (destroyed by gather)
     avx_value_front_high = _mm256_mask_i32gather_pd(avx_value_front_high, //src
                                     B_elements,                  //base ptr
                                     _mm256_extractf128_si256(avx_row_start, 1),                           //indices
-                                    _mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(7, 3, 6, 2, 5, 1, 4, 0)), 8); // mask
+                                    _mm256_castsi256_pd(_mm256_permutevar8x32_epi32(avx_load_mask, _mm256_set_epi32(7, 3, 6, 2, 5, 1, 4, 0))), 8); // mask
 
     //multiply new entries:
 
@@ -515,6 +572,24 @@ unsigned int row_C_scan_numeric_vector_AVX2(int const *row_indices_B_begin, int
 }
 #endif
 
+/** @brief The AVX2 merge is only available for double precision. Never called for other types, since spgemm_numeric_use_avx2() returns false. */
+template<typename NumericT>
+unsigned int row_C_scan_numeric_vector_AVX2(int const *, int const *, NumericT const *,
+                                            int const *, int const *, NumericT const *,
+                                            int,
+                                            int *, NumericT *)
+{
+  return 0;
+}
+
+/** @brief Returns true if the AVX2 variant of the numeric row merge is used for the given numeric type. */
+template<typename NumericT>
+bool spgemm_numeric_use_avx2(NumericT const *) { return false; }
+
+#ifdef VIENNACL_HOST_X86_SIMD
+inline bool spgemm_numeric_use_avx2(double const *) { return spgemm_use_avx2(); }
+#endif
+
 
 template<typename NumericT>
 unsigned int row_C_scan_numeric_vector_1(unsigned int const *input1_index_begin, unsigned int const *input1_index_end, NumericT const *input1_values_begin, NumericT factor1,
@@ -593,6 +668,8 @@ void row_C_scan_numeric_vector(unsigned int row_start_A, unsigned int row_end_A,
     return;
   }
 
+  bool use_avx2 = spgemm_numeric_use_avx2(A_elements);
+
   unsigned int row_C_len = 0;
   if (row_end_A - row_start_A == 2) // directly merge to C:
   {
@@ -608,15 +685,13 @@ void row_C_scan_numeric_vector(unsigned int row_start_A, unsigned int row_end_A,
                                 C_col_buffer + row_start_C, C_elements + row_start_C);
     return;
   }
-#ifdef VIENNACL_WITH_AVX2
-  else if (row_end_A - row_start_A > 10) // safely merge eight rows into temporary buffer:
+  else if (use_avx2 && row_end_A - row_start_A > 10) // safely merge eight rows into temporary buffer:
   {
     row_C_len = row_C_scan_numeric_vector_AVX2((const int*)(A_col_buffer + row_start_A), (const int*)(A_col_buffer + row_end_A), A_elements + row_start_A,
                                                (const int*)B_row_buffer, (const int*)B_col_buffer, B_elements, int(B_size2),
                                                (int*)row_C_vector_1, row_C_vector_1_values);
     row_start_A += 8;
   }
-#endif
   else // safely merge two rows into temporary buffer:
   {
     unsigned int A_col_1 = A_col_buffer[row_start_A];
@@ -635,8 +710,7 @@ void row_C_scan_numeric_vector(unsigned int row_start_A, unsigned int row_end_A,
   // process remaining rows:
   while (row_end_A > row_start_A)
   {
-#ifdef VIENNACL_WITH_AVX2
-    if (row_end_A - row_start_A > 9) // code in other if-conditionals ensures that values get written to C
+    if (use_avx2 && row_end_A - row_start_A > 9) // code in other if-conditionals ensures that values get written to C
     {
       unsigned int merged_len = row_C_scan_numeric_vector_AVX2((const int*)(A_col_buffer + row_start_A), (const int*)(A_col_buffer + row_end_A), A_elements + row_start_A,
                                                                (const int*)B_row_buffer, (const int*)B_col_buffer, B_elements, int(B_size2),
@@ -647,9 +721,7 @@ void row_C_scan_numeric_vector(unsigned int row_start_A, unsigned int row_end_A,
                                               row_C_vector_2, row_C_vector_2_values);
       row_start_A += 8;
     }
-    else
-#endif
-    if (row_start_A + 1 == row_end_A) // last row to merge, write directly to C:
+    else if (row_start_A + 1 == row_end_A) // last row to merge, write directly to C:
     {
       unsigned int A_col    = A_col_buffer[row_start_A];
       unsigned int B_offset = B_row_buffer[A_col];
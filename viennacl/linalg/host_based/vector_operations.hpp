@@ -33,6 +33,7 @@
 #include "viennacl/traits/size.hpp"
 #include "viennacl/traits/start.hpp"
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/cpu_dispatch.hpp"
 #include "viennacl/linalg/detail/op_applier.hpp"
 #include "viennacl/traits/stride.hpp"
 
@@ -469,8 +470,227 @@ VIENNACL_INNER_PROD_IMPL_1(unsigned long, unsigned long)
 VIENNACL_INNER_PROD_IMPL_2(unsigned long)
 
 
+// float and double: unit-stride vectors are handled by the runtime-dispatched SIMD kernels below
+#define VIENNACL_INNER_PROD_IMPL_CONTIGUOUS(RESULTSCALART) \
+    if (inc1 == 1 && inc2 == 1) \
+      return inner_prod_contiguous(data_vec1 + start1, data_vec2 + start2, size1);
+
+//
+// Kernels for the inner product of unit-stride vectors. Partial sums are accumulated in multiple registers to hide latencies.
+//
+
+template<typename NumericT>
+NumericT inner_prod_kernel_scalar(NumericT const * x, NumericT const * y, vcl_size_t size)
+{
+  NumericT temp0 = 0, temp1 = 0, temp2 = 0, temp3 = 0;
+  vcl_size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+  {
+    temp0 += x[i]     * y[i];
+    temp1 += x[i + 1] * y[i + 1];
+    temp2 += x[i + 2] * y[i + 2];
+    temp3 += x[i + 3] * y[i + 3];
+  }
+  for (; i < size; ++i)
+    temp0 += x[i] * y[i];
+  return (temp0 + temp1) + (temp2 + temp3);
+}
+
+#ifdef VIENNACL_HOST_X86_SIMD
+VIENNACL_HOST_TARGET_SSE42
+inline double inner_prod_kernel_sse42(double const * x, double const * y, vcl_size_t size)
+{
+  __m128d temp0 = _mm_setzero_pd(), temp1 = _mm_setzero_pd();
+  vcl_size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+  {
+    temp0 = _mm_add_pd(temp0, _mm_mul_pd(_mm_loadu_pd(x + i),     _mm_loadu_pd(y + i)));
+    temp1 = _mm_add_pd(temp1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+  }
+  double buffer[2];
+  _mm_storeu_pd(buffer, _mm_add_pd(temp0, temp1));
+  double result = buffer[0] + buffer[1];
+  for (; i < size; ++i)
+    result += x[i] * y[i];
+  return result;
+}
+
+VIENNACL_HOST_TARGET_SSE42
+inline float inner_prod_kernel_sse42(float const * x, float const * y, vcl_size_t size)
+{
+  __m128 temp0 = _mm_setzero_ps(), temp1 = _mm_setzero_ps();
+  vcl_size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+  {
+    temp0 = _mm_add_ps(temp0, _mm_mul_ps(_mm_loadu_ps(x + i),     _mm_loadu_ps(y + i)));
+    temp1 = _mm_add_ps(temp1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(y + i + 4)));
+  }
+  float buffer[4];
+  _mm_storeu_ps(buffer, _mm_add_ps(temp0, temp1));
+  float result = (buffer[0] + buffer[1]) + (buffer[2] + buffer[3]);
+  for (; i < size; ++i)
+    result += x[i] * y[i];
+  return result;
+}
+
+VIENNACL_HOST_TARGET_AVX2
+inline double inner_prod_kernel_avx2(double const * x, double const * y, vcl_size_t size)
+{
+  __m256d temp0 = _mm256_setzero_pd(), temp1 = _mm256_setzero_pd(), temp2 = _mm256_setzero_pd(), temp3 = _mm256_setzero_pd();
+  vcl_size_t i = 0;
+  for (; i + 16 <= size; i += 16)
+  {
+    temp0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i),      _mm256_loadu_pd(y + i),      temp0);
+    temp1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4),  _mm256_loadu_pd(y + i + 4),  temp1);
+    temp2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8),  _mm256_loadu_pd(y + i + 8),  temp2);
+    temp3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12), temp3);
+  }
+  for (; i + 4 <= size; i += 4)
+    temp0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), temp0);
+  double buffer[4];
+  _mm256_storeu_pd(buffer, _mm256_add_pd(_mm256_add_pd(temp0, temp1), _mm256_add_pd(temp2, temp3)));
+  double result = (buffer[0] + buffer[1]) + (buffer[2] + buffer[3]);
+  for (; i < size; ++i)
+    result += x[i] * y[i];
+  return result;
+}
+
+VIENNACL_HOST_TARGET_AVX2
+inline float inner_prod_kernel_avx2(float const * x, float const * y, vcl_size_t size)
+{
+  __m256 temp0 = _mm256_setzero_ps(), temp1 = _mm256_setzero_ps(), temp2 = _mm256_setzero_ps(), temp3 = _mm256_setzero_ps();
+  vcl_size_t i = 0;
+  for (; i + 32 <= size; i += 32)
+  {
+    temp0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i),      _mm256_loadu_ps(y + i),      temp0);
+    temp1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8),  _mm256_loadu_ps(y + i + 8),  temp1);
+    temp2 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 16), _mm256_loadu_ps(y + i + 16), temp2);
+    temp3 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 24), _mm256_loadu_ps(y + i + 24), temp3);
+  }
+  for (; i + 8 <= size; i += 8)
+    temp0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), temp0);
+  float buffer[8];
+  _mm256_storeu_ps(buffer, _mm256_add_ps(_mm256_add_ps(temp0, temp1), _mm256_add_ps(temp2, temp3)));
+  float result = ((buffer[0] + buffer[1]) + (buffer[2] + buffer[3])) + ((buffer[4] + buffer[5]) + (buffer[6] + buffer[7]));
+  for (; i < size; ++i)
+    result += x[i] * y[i];
+  return result;
+}
+
+VIENNACL_HOST_TARGET_AVX512
+inline double inner_prod_kernel_avx512(double const * x, double const * y, vcl_size_t size)
+{
+  __m512d temp0 = _mm512_setzero_pd(), temp1 = _mm512_setzero_pd(), temp2 = _mm512_setzero_pd(), temp3 = _mm512_setzero_pd();
+  vcl_size_t i = 0;
+  for (; i + 32 <= size; i += 32)
+  {
+    temp0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i),      _mm512_loadu_pd(y + i),      temp0);
+    temp1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8),  _mm512_loadu_pd(y + i + 8),  temp1);
+    temp2 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 16), _mm512_loadu_pd(y + i + 16), temp2);
+    temp3 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 24), _mm512_loadu_pd(y + i + 24), temp3);
+  }
+  for (; i + 8 <= size; i += 8)
+    temp0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), temp0);
+  double buffer[8];
+  _mm512_storeu_pd(buffer, _mm512_add_pd(_mm512_add_pd(temp0, temp1), _mm512_add_pd(temp2, temp3)));
+  double result = ((buffer[0] + buffer[1]) + (buffer[2] + buffer[3])) + ((buffer[4] + buffer[5]) + (buffer[6] + buffer[7]));
+  for (; i < size; ++i)
+    result += x[i] * y[i];
+  return result;
+}
+
+VIENNACL_HOST_TARGET_AVX512
+inline float inner_prod_kernel_avx512(float const * x, float const * y, vcl_size_t size)
+{
+  __m512 temp0 = _mm512_setzero_ps(), temp1 = _mm512_setzero_ps(), temp2 = _mm512_setzero_ps(), temp3 = _mm512_setzero_ps();
+  vcl_size_t i = 0;
+  for (; i + 64 <= size; i += 64)
+  {
+    temp0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i),      _mm512_loadu_ps(y + i),      temp0);
+    temp1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16), temp1);
+    temp2 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 32), _mm512_loadu_ps(y + i + 32), temp2);
+    temp3 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 48), _mm512_loadu_ps(y + i + 48), temp3);
+  }
+  for (; i + 16 <= size; i += 16)
+    temp0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), temp0);
+  float buffer[16];
+  _mm512_storeu_ps(buffer, _mm512_add_ps(_mm512_add_ps(temp0, temp1), _mm512_add_ps(temp2, temp3)));
+  float result = 0;
+  for (unsigned int j = 0; j < 16; ++j)
+    result += buffer[j];
+  for (; i < size; ++i)
+    result += x[i] * y[i];
+  return result;
+}
+#endif
+
+template<typename NumericT>
+struct inner_prod_kernel
+{
+  typedef NumericT (*type)(NumericT const *, NumericT const *, vcl_size_t);
+};
+
+#ifdef VIENNACL_HOST_X86_SIMD
+  #define VIENNACL_INNER_PROD_KERNEL_VARIANTS  .add(cpu_isa_sse42,  inner_prod_kernel_sse42) \
+                                               .add(cpu_isa_avx2,   inner_prod_kernel_avx2) \
+                                               .add(cpu_isa_avx512, inner_prod_kernel_avx512)
+#else
+  #define VIENNACL_INNER_PROD_KERNEL_VARIANTS
+#endif
+
+inline inner_prod_kernel<float>::type get_inner_prod_kernel(float const *)
+{
+  static cpu_dispatcher<inner_prod_kernel<float>::type> const dispatcher
+    = cpu_dispatcher<inner_prod_kernel<float>::type>("inner_prod<float>", inner_prod_kernel_scalar<float>) VIENNACL_INNER_PROD_KERNEL_VARIANTS;
+  return dispatcher.get();
+}
+
+inline inner_prod_kernel<double>::type get_inner_prod_kernel(double const *)
+{
+  static cpu_dispatcher<inner_prod_kernel<double>::type> const dispatcher
+    = cpu_dispatcher<inner_prod_kernel<double>::type>("inner_prod<double>", inner_prod_kernel_scalar<double>) VIENNACL_INNER_PROD_KERNEL_VARIANTS;
+  return dispatcher.get();
+}
+
+#undef VIENNACL_INNER_PROD_KERNEL_VARIANTS
+
+/** @brief Chunk length for the parallel inner product of unit-stride vectors. Each thread processes whole chunks with the SIMD kernel. */
+static const vcl_size_t inner_prod_chunk_size = 4096;
+
+#define VIENNACL_INNER_PROD_CONTIGUOUS_IMPL(NUMERICT) \
+  inline NUMERICT inner_prod_contiguous(NUMERICT const * x, NUMERICT const * y, vcl_size_t size) \
+  { \
+    inner_prod_kernel<NUMERICT>::type kernel = get_inner_prod_kernel(x); \
+    long num_chunks = static_cast<long>((size + inner_prod_chunk_size - 1) / inner_prod_chunk_size); \
+    NUMERICT temp = 0;
+
+#define VIENNACL_INNER_PROD_CONTIGUOUS_IMPL_2 \
+    for (long chunk = 0; chunk < num_chunks; ++chunk) \
+    { \
+      vcl_size_t offset = static_cast<vcl_size_t>(chunk) * inner_prod_chunk_size; \
+      temp += kernel(x + offset, y + offset, std::min(inner_prod_chunk_size, size - offset)); \
+    } \
+    return temp; \
+  }
+
+VIENNACL_INNER_PROD_CONTIGUOUS_IMPL(float)
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for reduction(+: temp) if (size > VIENNACL_OPENMP_VECTOR_MIN_SIZE)
+#endif
+VIENNACL_INNER_PROD_CONTIGUOUS_IMPL_2
+
+VIENNACL_INNER_PROD_CONTIGUOUS_IMPL(double)
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for reduction(+: temp) if (size > VIENNACL_OPENMP_VECTOR_MIN_SIZE)
+#endif
+VIENNACL_INNER_PROD_CONTIGUOUS_IMPL_2
+
+#undef VIENNACL_INNER_PROD_CONTIGUOUS_IMPL
+#undef VIENNACL_INNER_PROD_CONTIGUOUS_IMPL_2
+
 // float
 VIENNACL_INNER_PROD_IMPL_1(float, float)
+VIENNACL_INNER_PROD_IMPL_CONTIGUOUS(float)
 #ifdef VIENNACL_WITH_OPENMP
   #pragma omp parallel for reduction(+: temp) if (size1 > VIENNACL_OPENMP_VECTOR_MIN_SIZE)
 #endif
@@ -478,6 +698,7 @@ VIENNACL_INNER_PROD_IMPL_2(float)
 
 // double
 VIENNACL_INNER_PROD_IMPL_1(double, double)
+VIENNACL_INNER_PROD_IMPL_CONTIGUOUS(double)
 #ifdef VIENNACL_WITH_OPENMP
   #pragma omp parallel for reduction(+: temp) if (size1 > VIENNACL_OPENMP_VECTOR_MIN_SIZE)
 #endif
@@ -485,6 +706,7 @@ VIENNACL_INNER_PROD_IMPL_2(double)
 
 #undef VIENNACL_INNER_PROD_IMPL_1
 #undef VIENNACL_INNER_PROD_IMPL_2
+#undef VIENNACL_INNER_PROD_IMPL_CONTIGUOUS
 }
 
 /** @brief Computes the inner product of two vectors - implementation. Library users should call inner_prod(vec1, vec2).
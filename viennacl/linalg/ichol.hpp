@@ -30,6 +30,7 @@
 #include "viennacl/compressed_matrix.hpp"
 
 #include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/linalg/host_based/sparse_triangular_solve.hpp"
 
 #include <map>
 
@@ -121,6 +122,26 @@ void precondition(viennacl::compressed_matrix<NumericT> & A, ichol0_tag const &
 }
 
 
+namespace detail
+{
+  /** @brief Sets up the cached schedules for the substitutions with L and L^T (host backend).
+  *
+  * Note: L is stored in a column-oriented fashion, i.e. transposed w.r.t. the row-oriented layout. Thus, the factorization A = L L^T holds L in the upper triangular part of A.
+  */
+  template<typename NumericT>
+  void ichol0_setup_triangular_schedules(viennacl::compressed_matrix<NumericT> const & LLT,
+                                         viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericT> & L_schedule,
+                                         viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericT> & LT_schedule)
+  {
+    unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LLT.handle1());
+    unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LLT.handle2());
+    NumericT     const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(LLT.handle());
+
+    L_schedule.setup_transposed(row_buffer, col_buffer, elements, LLT.size1(), true, false);
+    LT_schedule.setup(row_buffer, col_buffer, elements, LLT.size1(), false, false);
+  }
+}
+
 /** @brief Incomplete Cholesky preconditioner class with static pattern (ICHOL0), can be supplied to solve()-routines
 */
 template<typename MatrixT>
@@ -140,13 +161,8 @@ public:
   template<typename VectorT>
   void apply(VectorT & vec) const
   {
-    unsigned int const * row_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LLT.handle1());
-    unsigned int const * col_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(LLT.handle2());
-    NumericType  const * elements   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericType>(LLT.handle());
-
-    // Note: L is stored in a column-oriented fashion, i.e. transposed w.r.t. the row-oriented layout. Thus, the factorization A = L L^T holds L in the upper triangular part of A.
-    viennacl::linalg::host_based::detail::csr_trans_inplace_solve<NumericType>(row_buffer, col_buffer, elements, vec, LLT.size2(), lower_tag());
-    viennacl::linalg::host_based::detail::csr_inplace_solve<NumericType>(row_buffer, col_buffer, elements, vec, LLT.size2(), upper_tag());
+    L_schedule_.solve(vec);
+    LT_schedule_.solve(vec);
   }
 
 private:
@@ -157,10 +173,14 @@ private:
 
     viennacl::copy(mat, LLT);
     viennacl::linalg::precondition(LLT, tag_);
+
+    detail::ichol0_setup_triangular_schedules(LLT, L_schedule_, LT_schedule_);
   }
 
   ichol0_tag const & tag_;
   viennacl::compressed_matrix<NumericType> LLT;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericType> L_schedule_;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericType> LT_schedule_;
 };
 
 
@@ -190,15 +210,16 @@ public:
       viennacl::context old_ctx = viennacl::traits::context(vec);
 
       viennacl::switch_memory_context(vec, host_ctx);
-      viennacl::linalg::inplace_solve(trans(LLT), vec, lower_tag());
-      viennacl::linalg::inplace_solve(      LLT , vec, upper_tag());
+      NumericT * vec_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(vec.handle());
+      L_schedule_.solve(vec_buffer);
+      LT_schedule_.solve(vec_buffer);
       viennacl::switch_memory_context(vec, old_ctx);
     }
-    else //apply ILU0 directly:
+    else //apply ILU0 directly, using the cached schedules:
     {
-      // Note: L is stored in a column-oriented fashion, i.e. transposed w.r.t. the row-oriented layout. Thus, the factorization A = L L^T holds L in the upper triangular part of A.
-      viennacl::linalg::inplace_solve(trans(LLT), vec, lower_tag());
-      viennacl::linalg::inplace_solve(      LLT , vec, upper_tag());
+      NumericT * vec_buffer = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(vec.handle());
+      L_schedule_.solve(vec_buffer);
+      LT_schedule_.solve(vec_buffer);
     }
   }
 
@@ -210,10 +231,14 @@ private:
     LLT = mat;
 
     viennacl::linalg::precondition(LLT, tag_);
+
+    detail::ichol0_setup_triangular_schedules(LLT, L_schedule_, LT_schedule_);
   }
 
   ichol0_tag const & tag_;
   viennacl::compressed_matrix<NumericT> LLT;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericT> L_schedule_;
+  viennacl::linalg::host_based::detail::sparse_triangular_schedule<NumericT> LT_schedule_;
 };
 
 }
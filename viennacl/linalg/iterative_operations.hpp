@@ -121,6 +121,62 @@ void pipelined_cg_prod(MatrixT const & A,
   }
 }
 
+/** @brief Performs a joint vector update operation needed for an efficient pipelined CG algorithm with a diagonal preconditioner M = diag(d).
+  *
+  * This routines computes for vectors 'result', 'p', 'r', 'Ap' and the inverse diagonal 'inv_diag' = 1/d:
+  *   result += alpha * p;
+  *   r      -= alpha * Ap;
+  *   p       = inv_diag .* r + beta * p;
+  * and runs the parallel reduction stage for computing inner_prod(r, inv_diag .* r). Only available for vectors in main memory.
+  */
+template<typename NumericT>
+void pipelined_pcg_vector_update(vector_base<NumericT> & result,
+                                 NumericT alpha,
+                                 vector_base<NumericT> & p,
+                                 vector_base<NumericT> & r,
+                                 vector_base<NumericT> const & Ap,
+                                 vector_base<NumericT> const & inv_diag,
+                                 NumericT beta,
+                                 vector_base<NumericT> & inner_prod_buffer)
+{
+  switch (viennacl::traits::handle(result).get_active_handle_id())
+  {
+  case viennacl::MAIN_MEMORY:
+    viennacl::linalg::host_based::pipelined_pcg_vector_update(result, alpha, p, r, Ap, inv_diag, beta, inner_prod_buffer);
+    break;
+  case viennacl::MEMORY_NOT_INITIALIZED:
+    throw memory_exception("not initialised!");
+  default:
+    throw memory_exception("not implemented");
+  }
+}
+
+
+/** @brief Performs a fused matrix-vector product needed for an efficient pipelined CG algorithm with a diagonal preconditioner.
+  *
+  * This routines computes for a matrix A, vectors 'p' and 'Ap', and the inverse diagonal 'inv_diag' of the preconditioner:
+  *   Ap = prod(A, p);
+  * and computes the two reduction stages for computing inner_prod(p,Ap), inner_prod(Ap, inv_diag .* Ap). Only available for matrices in main memory.
+  */
+template<typename MatrixT, typename NumericT>
+void pipelined_pcg_prod(MatrixT const & A,
+                        vector_base<NumericT> const & p,
+                        vector_base<NumericT> & Ap,
+                        vector_base<NumericT> const & inv_diag,
+                        vector_base<NumericT> & inner_prod_buffer)
+{
+  switch (viennacl::traits::handle(p).get_active_handle_id())
+  {
+  case viennacl::MAIN_MEMORY:
+    viennacl::linalg::host_based::pipelined_pcg_prod(A, p, Ap, inv_diag, inner_prod_buffer);
+    break;
+  case viennacl::MEMORY_NOT_INITIALIZED:
+    throw memory_exception("not initialised!");
+  default:
+    throw memory_exception("not implemented");
+  }
+}
+
 ////////////////////////////////////////////
 
 /** @brief Performs a joint vector update operation needed for an efficient pipelined CG algorithm.
@@ -27,6 +27,7 @@
 #include "viennacl/forwards.h"
 #include "viennacl/vector.hpp"
 #include "viennacl/compressed_matrix.hpp"
+#include "viennacl/block_compressed_matrix.hpp"
 #include "viennacl/tools/tools.hpp"
 #include "viennacl/linalg/sparse_matrix_operations.hpp"
 #include "viennacl/linalg/row_scaling.hpp"
@@ -125,10 +126,135 @@ class jacobi_precond<MatrixT, true>
       vec = element_div(vec, diag_A_);
     }
 
+    /** @brief Returns the diagonal of the system matrix, by which apply() divides. Used by fused preconditioned solver kernels. */
+    viennacl::vector<NumericType> const & diagonal() const { return diag_A_; }
+
   private:
     viennacl::vector<NumericType> diag_A_;
 };
 
+
+namespace detail
+{
+  /** @brief Inverts a dense block of size BlockSize x BlockSize (stored column by column) using Gauss-Jordan elimination with partial pivoting. */
+  template<typename NumericT, unsigned int BlockSize>
+  void invert_dense_block(NumericT const * block, NumericT * inverse)
+  {
+    NumericT A[BlockSize * BlockSize];
+    for (unsigned int i = 0; i < BlockSize * BlockSize; ++i)
+    {
+      A[i] = block[i];
+      inverse[i] = (i % BlockSize == i / BlockSize) ? NumericT(1) : NumericT(0);
+    }
+
+    for (unsigned int col = 0; col < BlockSize; ++col)
+    {
+      unsigned int pivot_row = col;
+      for (unsigned int row = col + 1; row < BlockSize; ++row)
+        if (std::fabs(A[col * BlockSize + row]) > std::fabs(A[col * BlockSize + pivot_row]))
+          pivot_row = row;
+
+      if (!(std::fabs(A[col * BlockSize + pivot_row]) > 0))
+        throw zero_on_diagonal_exception("ViennaCL: Singular diagonal block encountered while setting up block Jacobi preconditioner!");
+
+      if (pivot_row != col)
+        for (unsigned int j = 0; j < BlockSize; ++j)
+        {
+          std::swap(A[j * BlockSize + col], A[j * BlockSize + pivot_row]);
+          std::swap(inverse[j * BlockSize + col], inverse[j * BlockSize + pivot_row]);
+        }
+
+      NumericT scaling = NumericT(1) / A[col * BlockSize + col];
+      for (unsigned int j = 0; j < BlockSize; ++j)
+      {
+        A[j * BlockSize + col]       *= scaling;
+        inverse[j * BlockSize + col] *= scaling;
+      }
+
+      for (unsigned int row = 0; row < BlockSize; ++row)
+      {
+        NumericT factor = A[col * BlockSize + row];
+        if (row == col || !(factor < 0 || factor > 0))
+          continue;
+        for (unsigned int j = 0; j < BlockSize; ++j)
+        {
+          A[j * BlockSize + row]       -= factor * A[j * BlockSize + col];
+          inverse[j * BlockSize + row] -= factor * inverse[j * BlockSize + col];
+        }
+      }
+    }
+  }
+}
+
+/** @brief Jacobi preconditioner class, can be supplied to solve()-routines.
+*
+*  Specialization for block_compressed_matrix: Block Jacobi preconditioner with the diagonal blocks of the matrix.
+*  The inverses of the diagonal blocks are computed on the host and applied as a block-diagonal block_compressed_matrix,
+*  so the preconditioner is applied in the memory domain of the matrix.
+*/
+template<typename NumericT, unsigned int BlockSize>
+class jacobi_precond<viennacl::block_compressed_matrix<NumericT, BlockSize>, false>
+{
+    typedef viennacl::block_compressed_matrix<NumericT, BlockSize>    MatrixType;
+
+  public:
+    jacobi_precond(MatrixType const & mat, jacobi_tag const &) : inv_diag_A_(viennacl::traits::context(mat)), temp_(mat.size1(), viennacl::traits::context(mat))
+    {
+      init(mat);
+    }
+
+
+    void init(MatrixType const & mat)
+    {
+      vcl_size_t block_rows = mat.block_rows();
+      temp_.resize(mat.size1(), false);
+
+      viennacl::backend::typesafe_host_array<unsigned int> row_blocks(mat.handle1(), block_rows + 1);
+      viennacl::backend::typesafe_host_array<unsigned int> col_blocks(mat.handle2(), mat.nonzero_blocks());
+      std::vector<NumericT> elements(mat.nnz());
+      viennacl::backend::memory_read(mat.handle1(), 0, row_blocks.raw_size(), row_blocks.get());
+      if (mat.nonzero_blocks() > 0)
+      {
+        viennacl::backend::memory_read(mat.handle2(), 0, col_blocks.raw_size(), col_blocks.get());
+        viennacl::backend::memory_read(mat.handle(),  0, sizeof(NumericT) * elements.size(), &(elements[0]));
+      }
+
+      std::vector<unsigned int> inv_row_blocks(block_rows + 1);
+      std::vector<unsigned int> inv_col_blocks(block_rows);
+      std::vector<NumericT>     inv_elements(block_rows * BlockSize * BlockSize);
+      for (vcl_size_t i = 0; i < block_rows; ++i)
+      {
+        inv_row_blocks[i] = static_cast<unsigned int>(i);
+        inv_col_blocks[i] = static_cast<unsigned int>(i);
+
+        vcl_size_t k = row_blocks[i];
+        while (k < row_blocks[i + 1] && col_blocks[k] != i)
+          ++k;
+        if (k == row_blocks[i + 1])
+          throw zero_on_diagonal_exception("ViennaCL: Zero block in diagonal encountered while setting up block Jacobi preconditioner!");
+
+        detail::invert_dense_block<NumericT, BlockSize>(&(elements[k * BlockSize * BlockSize]), &(inv_elements[i * BlockSize * BlockSize]));
+      }
+      inv_row_blocks[block_rows] = static_cast<unsigned int>(block_rows);
+
+      inv_diag_A_.set(&(inv_row_blocks[0]), block_rows > 0 ? &(inv_col_blocks[0]) : NULL, block_rows > 0 ? &(inv_elements[0]) : NULL,
+                      mat.size1(), mat.size2(), block_rows);
+    }
+
+
+    template<unsigned int AlignmentV>
+    void apply(viennacl::vector<NumericT, AlignmentV> & vec) const
+    {
+      assert(inv_diag_A_.size1() == viennacl::traits::size(vec) && bool("Size mismatch"));
+      viennacl::linalg::prod_impl(inv_diag_A_, vec, NumericT(1), temp_, NumericT(0));
+      vec = temp_;
+    }
+
+  private:
+    MatrixType inv_diag_A_;
+    mutable viennacl::vector<NumericT> temp_;
+};
+
 }
 }
 
@@ -506,6 +506,81 @@ namespace viennacl
     }
 
 
+    // alpha * A * x + beta * y
+
+    /** @brief Carries out matrix-vector multiplication with scaling: result = alpha * mat * vec + beta * result
+    *
+    * The host backend computes the expression in a single pass, other backends use a temporary.
+    * If beta is zero, the previous content of result is not read.
+    *
+    * @param mat    The matrix
+    * @param vec    The vector. Must not share its memory with result.
+    * @param result The result vector
+    * @param alpha  Scaling factor for the matrix-vector product
+    * @param beta   Scaling factor for the previous content of result
+    */
+    template<typename NumericT>
+    void prod_impl(const matrix_base<NumericT> & mat,
+                   const vector_base<NumericT> & vec,
+                         vector_base<NumericT> & result,
+                   NumericT alpha, NumericT beta)
+    {
+      assert( (viennacl::traits::size1(mat) == viennacl::traits::size(result)) && bool("Size check failed at v1 = alpha * prod(A, v2) + beta * v1: size1(A) != size(v1)"));
+      assert( (viennacl::traits::size2(mat) == viennacl::traits::size(vec))    && bool("Size check failed at v1 = alpha * prod(A, v2) + beta * v1: size2(A) != size(v2)"));
+
+      switch (viennacl::traits::handle(mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(mat, false, vec, result, alpha, beta);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+        {
+          viennacl::vector<NumericT> temp(viennacl::traits::size(result), viennacl::traits::context(result));
+          viennacl::linalg::prod_impl(mat, vec, temp);
+          viennacl::linalg::avbv(result, temp, alpha, 1, false, false, result, beta, 1, false, false);
+        }
+      }
+    }
+
+    /** @brief Carries out matrix-vector multiplication with a transposed matrix and scaling: result = alpha * trans(mat) * vec + beta * result
+    *
+    * The host backend computes the expression in a single pass, other backends use a temporary.
+    * If beta is zero, the previous content of result is not read.
+    *
+    * @param mat_trans  The transposed matrix proxy
+    * @param vec        The vector. Must not share its memory with result.
+    * @param result     The result vector
+    * @param alpha      Scaling factor for the matrix-vector product
+    * @param beta       Scaling factor for the previous content of result
+    */
+    template<typename NumericT>
+    void prod_impl(const matrix_expression< const matrix_base<NumericT>, const matrix_base<NumericT>, op_trans> & mat_trans,
+                   const vector_base<NumericT> & vec,
+                         vector_base<NumericT> & result,
+                   NumericT alpha, NumericT beta)
+    {
+      assert( (viennacl::traits::size1(mat_trans.lhs()) == viennacl::traits::size(vec))    && bool("Size check failed at v1 = alpha * trans(A) * v2 + beta * v1: size1(A) != size(v2)"));
+      assert( (viennacl::traits::size2(mat_trans.lhs()) == viennacl::traits::size(result)) && bool("Size check failed at v1 = alpha * trans(A) * v2 + beta * v1: size2(A) != size(v1)"));
+
+      switch (viennacl::traits::handle(mat_trans.lhs()).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(mat_trans.lhs(), true, vec, result, alpha, beta);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+        {
+          viennacl::vector<NumericT> temp(viennacl::traits::size(result), viennacl::traits::context(result));
+          viennacl::linalg::prod_impl(mat_trans, vec, temp);
+          viennacl::linalg::avbv(result, temp, alpha, 1, false, false, result, beta, 1, false, false);
+        }
+      }
+    }
+
+
     //
     /////////////////////////   matrix-matrix products /////////////////////////////////
     //
@@ -1143,9 +1218,14 @@ namespace viennacl
   {
     assert(viennacl::traits::size1(proxy.lhs()) == v1.size() && bool("Size check failed for v1 += A * v2: size1(A) != size(v1)"));
 
-    vector<NumericT> result(viennacl::traits::size1(proxy.lhs()));
-    viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), result);
-    v1 += result;
+    if (viennacl::traits::handle(proxy.rhs()) != viennacl::traits::handle(v1) && viennacl::traits::handle(proxy.lhs()) != viennacl::traits::handle(v1))
+      viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), v1, NumericT(1), NumericT(1));
+    else
+    {
+      vector<NumericT> result(viennacl::traits::size1(proxy.lhs()));
+      viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), result);
+      v1 += result;
+    }
     return v1;
   }
 
@@ -1161,9 +1241,14 @@ namespace viennacl
   {
     assert(viennacl::traits::size1(proxy.lhs()) == v1.size() && bool("Size check failed for v1 -= A * v2: size1(A) != size(v1)"));
 
-    vector<NumericT> result(viennacl::traits::size1(proxy.lhs()));
-    viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), result);
-    v1 -= result;
+    if (viennacl::traits::handle(proxy.rhs()) != viennacl::traits::handle(v1) && viennacl::traits::handle(proxy.lhs()) != viennacl::traits::handle(v1))
+      viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), v1, NumericT(-1), NumericT(1));
+    else
+    {
+      vector<NumericT> result(viennacl::traits::size1(proxy.lhs()));
+      viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), result);
+      v1 -= result;
+    }
     return v1;
   }
 
@@ -1225,11 +1310,16 @@ namespace viennacl
                                                               const vector_base<NumericT>,
                                                               op_prod> & proxy)
   {
-    assert(viennacl::traits::size2(proxy.lhs()) == v1.size() && bool("Size check failed in v1 += trans(A) * v2: size2(A) != size(v1)"));
+    assert(viennacl::traits::size1(proxy.lhs()) == v1.size() && bool("Size check failed in v1 += trans(A) * v2: size2(A) != size(v1)"));
 
-    vector<NumericT> result(viennacl::traits::size2(proxy.lhs()));
-    viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), result);
-    v1 += result;
+    if (viennacl::traits::handle(proxy.rhs()) != viennacl::traits::handle(v1) && viennacl::traits::handle(proxy.lhs()) != viennacl::traits::handle(v1))
+      viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), v1, NumericT(1), NumericT(1));
+    else
+    {
+      vector<NumericT> result(viennacl::traits::size1(proxy.lhs()));
+      viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), result);
+      v1 += result;
+    }
     return v1;
   }
 
@@ -1246,11 +1336,16 @@ namespace viennacl
                                                               const vector_base<NumericT>,
                                                               op_prod> & proxy)
   {
-    assert(viennacl::traits::size2(proxy.lhs()) == v1.size() && bool("Size check failed in v1 += trans(A) * v2: size2(A) != size(v1)"));
+    assert(viennacl::traits::size1(proxy.lhs()) == v1.size() && bool("Size check failed in v1 += trans(A) * v2: size2(A) != size(v1)"));
 
-    vector<NumericT> result(viennacl::traits::size2(proxy.lhs()));
-    viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), result);
-    v1 -= result;
+    if (viennacl::traits::handle(proxy.rhs()) != viennacl::traits::handle(v1) && viennacl::traits::handle(proxy.lhs()) != viennacl::traits::handle(v1))
+      viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), v1, NumericT(-1), NumericT(1));
+    else
+    {
+      vector<NumericT> result(viennacl::traits::size1(proxy.lhs()));
+      viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), result);
+      v1 -= result;
+    }
     return v1;
   }
 
@@ -1268,7 +1363,7 @@ namespace viennacl
                                      const vector_base<NumericT>,
                                      op_prod> & proxy)
   {
-    assert(viennacl::traits::size2(proxy.lhs()) == viennacl::traits::size(v1) && bool("Size check failed in v1 + trans(A) * v2: size2(A) != size(v1)"));
+    assert(viennacl::traits::size1(proxy.lhs()) == viennacl::traits::size(v1) && bool("Size check failed in v1 + trans(A) * v2: size2(A) != size(v1)"));
 
     vector<NumericT> result(viennacl::traits::size(v1));
     viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), result);
@@ -1288,7 +1383,7 @@ namespace viennacl
                                      const vector_base<NumericT>,
                                      op_prod> & proxy)
   {
-    assert(viennacl::traits::size2(proxy.lhs()) == viennacl::traits::size(v1) && bool("Size check failed in v1 - trans(A) * v2: size2(A) != size(v1)"));
+    assert(viennacl::traits::size1(proxy.lhs()) == viennacl::traits::size(v1) && bool("Size check failed in v1 - trans(A) * v2: size2(A) != size(v1)"));
 
     vector<NumericT> result(viennacl::traits::size(v1));
     viennacl::linalg::prod_impl(proxy.lhs(), proxy.rhs(), result);
@@ -0,0 +1,123 @@
+#ifndef VIENNACL_LINALG_OPENCL_KERNELS_BLOCK_COMPRESSED_MATRIX_HPP
+#define VIENNACL_LINALG_OPENCL_KERNELS_BLOCK_COMPRESSED_MATRIX_HPP
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+#include "viennacl/tools/tools.hpp"
+#include "viennacl/ocl/kernel.hpp"
+#include "viennacl/ocl/platform.hpp"
+#include "viennacl/ocl/utils.hpp"
+
+#include "viennacl/linalg/opencl/common.hpp"
+
+/** @file viennacl/linalg/opencl/kernels/block_compressed_matrix.hpp
+ *  @brief OpenCL kernel file for block_compressed_matrix operations */
+namespace viennacl
+{
+namespace linalg
+{
+namespace opencl
+{
+namespace kernels
+{
+
+//////////////////////////// Part 1: Kernel generation routines ////////////////////////////////////
+
+/** @brief Generates the matrix-vector product kernel. One work item computes one row, so that consecutive work items read consecutive entries of the (column-major) blocks. */
+template<typename StringT>
+void generate_block_compressed_vec_mul(StringT & source, std::string const & numeric_string, bool with_alpha_beta)
+{
+  if (with_alpha_beta)
+    source.append("__kernel void vec_mul_alpha_beta( \n");
+  else
+    source.append("__kernel void vec_mul( \n");
+  source.append("  __global const unsigned int * row_blocks, \n");
+  source.append("  __global const unsigned int * col_blocks, \n");
+  source.append("  __global const "); source.append(numeric_string); source.append(" * elements, \n");
+  source.append("  __global const "); source.append(numeric_string); source.append(" * x, \n");
+  source.append("  uint4 layout_x, \n");
+  if (with_alpha_beta) { source.append("  "); source.append(numeric_string); source.append(" alpha, \n"); }
+  source.append("  __global "); source.append(numeric_string); source.append(" * result, \n");
+  source.append("  uint4 layout_result, \n");
+  if (with_alpha_beta) { source.append("  "); source.append(numeric_string); source.append(" beta, \n"); }
+  source.append("  unsigned int block_size, \n");
+  source.append("  unsigned int row_num) \n");
+  source.append("{ \n");
+  source.append("  uint block_entries = block_size * block_size; \n");
+  source.append("  for (uint row = get_global_id(0); row < row_num; row += get_global_size(0)) { \n");
+  source.append("    uint block_row    = row / block_size; \n");
+  source.append("    uint row_in_block = row % block_size; \n");
+  source.append("    "); source.append(numeric_string); source.append(" sum = 0; \n");
+  source.append("    for (uint k = row_blocks[block_row]; k < row_blocks[block_row + 1]; ++k) { \n");
+  source.append("      uint first_col = col_blocks[k] * block_size; \n");
+  source.append("      uint offset = k * block_entries + row_in_block; \n");
+  source.append("      for (uint c = 0; c < block_size; ++c, offset += block_size) \n");
+  source.append("        sum += elements[offset] * x[(first_col + c) * layout_x.y + layout_x.x]; \n");
+  source.append("    } \n");
+  if (with_alpha_beta)
+    source.append("    result[row * layout_result.y + layout_result.x] = alpha * sum + ((beta != 0) ? beta * result[row * layout_result.y + layout_result.x] : 0); \n");
+  else
+    source.append("    result[row * layout_result.y + layout_result.x] = sum; \n");
+  source.append("  } \n");
+  source.append("} \n");
+}
+
+//////////////////////////// Part 2: Main kernel class ////////////////////////////////////
+
+// main kernel class
+/** @brief Main kernel class for generating OpenCL kernels for block_compressed_matrix. The block size is a kernel argument, so one program serves all block sizes. */
+template<typename NumericT>
+struct block_compressed_matrix
+{
+  static std::string program_name()
+  {
+    return viennacl::ocl::type_to_string<NumericT>::apply() + "_block_compressed_matrix";
+  }
+
+  static void init(viennacl::ocl::context & ctx)
+  {
+    static std::map<cl_context, bool> init_done;
+    if (!init_done[ctx.handle().get()])
+    {
+      viennacl::ocl::DOUBLE_PRECISION_CHECKER<NumericT>::apply(ctx);
+      std::string numeric_string = viennacl::ocl::type_to_string<NumericT>::apply();
+
+      std::string source;
+      source.reserve(1024);
+
+      viennacl::ocl::append_double_precision_pragma<NumericT>(ctx, source);
+
+      generate_block_compressed_vec_mul(source, numeric_string, true);
+      generate_block_compressed_vec_mul(source, numeric_string, false);
+
+      std::string prog_name = program_name();
+      #ifdef VIENNACL_BUILD_INFO
+      std::cout << "Creating program " << prog_name << std::endl;
+      #endif
+      ctx.add_program(source, prog_name);
+      init_done[ctx.handle().get()] = true;
+    } //if
+  } //init
+};
+
+}  // namespace kernels
+}  // namespace opencl
+}  // namespace linalg
+}  // namespace viennacl
+#endif
+
@@ -39,15 +39,19 @@ namespace kernels
 //////////////////////////// Part 1: Kernel generation routines ////////////////////////////////////
 
 template<typename StringT>
-void generate_sliced_ell_vec_mul(StringT & source, std::string const & numeric_string, bool with_alpha_beta)
+void generate_sliced_ell_vec_mul(StringT & source, std::string const & numeric_string, bool with_alpha_beta, bool with_row_permutation)
 {
+  source.append("__kernel void vec_mul");
   if (with_alpha_beta)
-    source.append("__kernel void vec_mul_alpha_beta( \n");
-  else
-    source.append("__kernel void vec_mul( \n");
+    source.append("_alpha_beta");
+  if (with_row_permutation)
+    source.append("_permuted");
+  source.append("( \n");
   source.append("  __global const unsigned int * columns_per_block, \n");
   source.append("  __global const unsigned int * column_indices, \n");
   source.append("  __global const unsigned int * block_start, \n");
+  if (with_row_permutation)
+    source.append("  __global const unsigned int * row_permutation, \n");
   source.append("  __global const "); source.append(numeric_string); source.append(" * elements, \n");
   source.append("  __global const "); source.append(numeric_string); source.append(" * x, \n");
   source.append("  uint4 layout_x, \n");
@@ -75,11 +79,14 @@ void generate_sliced_ell_vec_mul(StringT & source, std::string const & numeric_s
   source.append("      sum += (val != 0) ? (x[column_indices[index] * layout_x.y + layout_x.x] * val) : 0; \n");
   source.append("    } \n");
 
-  source.append("    if (row < layout_result.z) \n");
+  source.append("    if (row < layout_result.z) { \n");
+  if (with_row_permutation)
+    source.append("      row = row_permutation[row]; \n");
   if (with_alpha_beta)
     source.append("      result[row * layout_result.y + layout_result.x] = alpha * sum + ((beta != 0) ? beta * result[row * layout_result.y + layout_result.x] : 0); \n");
   else
     source.append("      result[row * layout_result.y + layout_result.x] = sum; \n");
+  source.append("    } \n");
   source.append("  } \n");
   source.append("} \n");
 }
@@ -114,8 +121,10 @@ struct sliced_ell_matrix<NumericT, unsigned int>
       viennacl::ocl::append_double_precision_pragma<NumericT>(ctx, source);
 
       // fully parametrized kernels:
-      generate_sliced_ell_vec_mul(source, numeric_string, true);
-      generate_sliced_ell_vec_mul(source, numeric_string, false);
+      generate_sliced_ell_vec_mul(source, numeric_string, true,  false);
+      generate_sliced_ell_vec_mul(source, numeric_string, false, false);
+      generate_sliced_ell_vec_mul(source, numeric_string, true,  true);
+      generate_sliced_ell_vec_mul(source, numeric_string, false, true);
 
       std::string prog_name = program_name();
       #ifdef VIENNACL_BUILD_INFO
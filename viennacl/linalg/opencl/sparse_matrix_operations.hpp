@@ -35,6 +35,7 @@
 #include "viennacl/linalg/opencl/kernels/ell_matrix.hpp"
 #include "viennacl/linalg/opencl/kernels/sliced_ell_matrix.hpp"
 #include "viennacl/linalg/opencl/kernels/hyb_matrix.hpp"
+#include "viennacl/linalg/opencl/kernels/block_compressed_matrix.hpp"
 #include "viennacl/linalg/opencl/kernels/compressed_compressed_matrix.hpp"
 #include "viennacl/linalg/opencl/common.hpp"
 #include "viennacl/linalg/opencl/vector_operations.hpp"
@@ -360,6 +361,7 @@ void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV> const & A,
    */
 
   C.reserve(current_offset, false);
+  C.reset_row_statistics();
 
   viennacl::ocl::kernel & k3 = ctx.get_kernel(viennacl::linalg::opencl::kernels::compressed_matrix<NumericT>::program_name(), "spgemm_stage3");
   k3.local_work_size(0, 32); // run with one warp/wavefront
@@ -642,6 +644,71 @@ void inplace_solve(matrix_expression< const compressed_matrix<NumericT, Alignmen
 }
 
 
+//
+// Compressed matrix with index types other than unsigned int: The OpenCL kernels operate on 32-bit indices only.
+//
+
+namespace detail
+{
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void row_info(compressed_matrix<NumericT, AlignmentV, IndexT> const &, vector_base<NumericT> &, viennacl::linalg::detail::row_info_types)
+  {
+    throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the OpenCL backend");
+  }
+
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT, typename SolverTagT>
+  void block_inplace_solve(const matrix_expression<const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                                   const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                                   op_trans> &,
+                           viennacl::backend::mem_handle const &, vcl_size_t,
+                           vector_base<NumericT> const &, vector_base<NumericT> &, SolverTagT)
+  {
+    throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the OpenCL backend");
+  }
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::vector_base<NumericT> const &, NumericT,
+               viennacl::vector_base<NumericT> &, NumericT)
+{
+  throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the OpenCL backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::matrix_base<NumericT> const &,
+               viennacl::matrix_base<NumericT> &)
+{
+  throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the OpenCL backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::matrix_expression<const viennacl::matrix_base<NumericT>,
+                                           const viennacl::matrix_base<NumericT>,
+                                           viennacl::op_trans > const &,
+               viennacl::matrix_base<NumericT> &)
+{
+  throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the OpenCL backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT, typename SolverTagT>
+void inplace_solve(compressed_matrix<NumericT, AlignmentV, IndexT> const &, vector_base<NumericT> &, SolverTagT)
+{
+  throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the OpenCL backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT, typename SolverTagT>
+void inplace_solve(matrix_expression< const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                      const compressed_matrix<NumericT, AlignmentV, IndexT>,
+                                      op_trans> const &,
+                   vector_base<NumericT> &, SolverTagT)
+{
+  throw memory_exception("compressed_matrix with index types other than unsigned int not supported by the OpenCL backend");
+}
+
+
 //
 // Compressed Compressed matrix
 //
@@ -860,6 +927,46 @@ void prod_impl(viennacl::coordinate_matrix<NumericT, AlignmentV> const & A,
 }
 
 
+//
+// Coordinate matrix with index types other than unsigned int: The OpenCL kernels operate on 32-bit indices only.
+//
+
+namespace detail
+{
+  template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+  void row_info(coordinate_matrix<NumericT, AlignmentV, IndexT> const &, vector_base<NumericT> &, viennacl::linalg::detail::row_info_types)
+  {
+    throw memory_exception("coordinate_matrix with index types other than unsigned int not supported by the OpenCL backend");
+  }
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::vector_base<NumericT> const &, NumericT,
+               viennacl::vector_base<NumericT> &, NumericT)
+{
+  throw memory_exception("coordinate_matrix with index types other than unsigned int not supported by the OpenCL backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::matrix_base<NumericT> const &,
+               viennacl::matrix_base<NumericT> &)
+{
+  throw memory_exception("coordinate_matrix with index types other than unsigned int not supported by the OpenCL backend");
+}
+
+template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+void prod_impl(viennacl::coordinate_matrix<NumericT, AlignmentV, IndexT> const &,
+               viennacl::matrix_expression<const viennacl::matrix_base<NumericT>,
+                                           const viennacl::matrix_base<NumericT>,
+                                           viennacl::op_trans > const &,
+               viennacl::matrix_base<NumericT> &)
+{
+  throw memory_exception("coordinate_matrix with index types other than unsigned int not supported by the OpenCL backend");
+}
+
+
 //
 // ELL Matrix
 //
@@ -1060,7 +1167,12 @@ void prod_impl(viennacl::sliced_ell_matrix<ScalarT, IndexT> const & A,
 
   std::stringstream ss;
   ss << "vec_mul_" << 1;//(AlignmentV != 1?4:1);
-  viennacl::ocl::kernel& k = ctx.get_kernel(viennacl::linalg::opencl::kernels::sliced_ell_matrix<ScalarT, IndexT>::program_name(), with_alpha_beta ? "vec_mul_alpha_beta" : "vec_mul");
+  // rows reordered by sorting within the sorting scope are mapped back to their original position in the result:
+  bool with_row_permutation = (A.handle4().raw_size() > 0);
+  std::string kernel_name = with_alpha_beta ? "vec_mul_alpha_beta" : "vec_mul";
+  if (with_row_permutation)
+    kernel_name += "_permuted";
+  viennacl::ocl::kernel& k = ctx.get_kernel(viennacl::linalg::opencl::kernels::sliced_ell_matrix<ScalarT, IndexT>::program_name(), kernel_name);
 
   vcl_size_t thread_num = std::max(A.rows_per_block(), static_cast<vcl_size_t>(128));
   unsigned int group_num = 256;
@@ -1071,10 +1183,11 @@ void prod_impl(viennacl::sliced_ell_matrix<ScalarT, IndexT> const & A,
   k.local_work_size(0, thread_num);
   k.global_work_size(0, thread_num * group_num);
 
-  if (with_alpha_beta)
+  if (with_alpha_beta && with_row_permutation)
     viennacl::ocl::enqueue(k(A.handle1().opencl_handle(),
                              A.handle2().opencl_handle(),
                              A.handle3().opencl_handle(),
+                             A.handle4().opencl_handle(),
                              A.handle().opencl_handle(),
                              viennacl::traits::opencl_handle(x),
                              layout_x,
@@ -1084,6 +1197,31 @@ void prod_impl(viennacl::sliced_ell_matrix<ScalarT, IndexT> const & A,
                              beta,
                              cl_uint(A.rows_per_block()))
     );
+  else if (with_alpha_beta)
+    viennacl::ocl::enqueue(k(A.handle1().opencl_handle(),
+                             A.handle2().opencl_handle(),
+                             A.handle3().opencl_handle(),
+                             A.handle().opencl_handle(),
+                             viennacl::traits::opencl_handle(x),
+                             layout_x,
+                             alpha,
+                             viennacl::traits::opencl_handle(y),
+                             layout_y,
+                             beta,
+                             cl_uint(A.rows_per_block()))
+    );
+  else if (with_row_permutation)
+    viennacl::ocl::enqueue(k(A.handle1().opencl_handle(),
+                             A.handle2().opencl_handle(),
+                             A.handle3().opencl_handle(),
+                             A.handle4().opencl_handle(),
+                             A.handle().opencl_handle(),
+                             viennacl::traits::opencl_handle(x),
+                             layout_x,
+                             viennacl::traits::opencl_handle(y),
+                             layout_y,
+                             cl_uint(A.rows_per_block()))
+    );
   else
     viennacl::ocl::enqueue(k(A.handle1().opencl_handle(),
                              A.handle2().opencl_handle(),
@@ -1098,6 +1236,61 @@ void prod_impl(viennacl::sliced_ell_matrix<ScalarT, IndexT> const & A,
 }
 
 
+//
+// Block Compressed Matrix
+//
+
+template<typename NumericT, unsigned int BlockSize>
+void prod_impl(viennacl::block_compressed_matrix<NumericT, BlockSize> const & A,
+               viennacl::vector_base<NumericT> const & x,
+               NumericT alpha,
+               viennacl::vector_base<NumericT>       & y,
+               NumericT beta)
+{
+  assert(A.size1() == y.size());
+  assert(A.size2() == x.size());
+
+  viennacl::ocl::context & ctx = const_cast<viennacl::ocl::context &>(viennacl::traits::opencl_handle(A).context());
+  viennacl::linalg::opencl::kernels::block_compressed_matrix<NumericT>::init(ctx);
+
+  bool with_alpha_beta = (alpha < NumericT(1) || alpha > NumericT(1)) || (beta < 0 || beta > 0);
+
+  viennacl::ocl::packed_cl_uint layout_x;
+  layout_x.start  = cl_uint(viennacl::traits::start(x));
+  layout_x.stride = cl_uint(viennacl::traits::stride(x));
+  layout_x.size   = cl_uint(viennacl::traits::size(x));
+  layout_x.internal_size   = cl_uint(viennacl::traits::internal_size(x));
+
+  viennacl::ocl::packed_cl_uint layout_y;
+  layout_y.start  = cl_uint(viennacl::traits::start(y));
+  layout_y.stride = cl_uint(viennacl::traits::stride(y));
+  layout_y.size   = cl_uint(viennacl::traits::size(y));
+  layout_y.internal_size   = cl_uint(viennacl::traits::internal_size(y));
+
+  viennacl::ocl::kernel& k = ctx.get_kernel(viennacl::linalg::opencl::kernels::block_compressed_matrix<NumericT>::program_name(), with_alpha_beta ? "vec_mul_alpha_beta" : "vec_mul");
+
+  k.local_work_size(0, 128);
+  k.global_work_size(0, 128 * 256);
+
+  if (with_alpha_beta)
+    viennacl::ocl::enqueue(k(A.handle1().opencl_handle(), A.handle2().opencl_handle(), A.handle().opencl_handle(),
+                             viennacl::traits::opencl_handle(x), layout_x,
+                             alpha,
+                             viennacl::traits::opencl_handle(y), layout_y,
+                             beta,
+                             cl_uint(BlockSize),
+                             cl_uint(A.size1()))
+    );
+  else
+    viennacl::ocl::enqueue(k(A.handle1().opencl_handle(), A.handle2().opencl_handle(), A.handle().opencl_handle(),
+                             viennacl::traits::opencl_handle(x), layout_x,
+                             viennacl::traits::opencl_handle(y), layout_y,
+                             cl_uint(BlockSize),
+                             cl_uint(A.size1()))
+    );
+}
+
+
 //
 // Hybrid Matrix
 //
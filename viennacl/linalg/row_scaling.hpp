@@ -63,14 +63,14 @@ namespace viennacl
         enum { value = false };
       };
 
-      template<typename ScalarType, unsigned int ALIGNMENT>
-      struct row_scaling_for_viennacl< viennacl::compressed_matrix<ScalarType, ALIGNMENT> >
+      template<typename ScalarType, unsigned int ALIGNMENT, typename IndexType>
+      struct row_scaling_for_viennacl< viennacl::compressed_matrix<ScalarType, ALIGNMENT, IndexType> >
       {
         enum { value = true };
       };
 
-      template<typename ScalarType, unsigned int ALIGNMENT>
-      struct row_scaling_for_viennacl< viennacl::coordinate_matrix<ScalarType, ALIGNMENT> >
+      template<typename ScalarType, unsigned int ALIGNMENT, typename IndexType>
+      struct row_scaling_for_viennacl< viennacl::coordinate_matrix<ScalarType, ALIGNMENT, IndexType> >
       {
         enum { value = true };
       };
@@ -188,6 +188,9 @@ namespace viennacl
           vec = element_div(vec, diag_M);
         }
 
+        /** @brief Returns the row norms of the system matrix, by which apply() divides. Used by fused preconditioned solver kernels. */
+        viennacl::vector<ScalarType> const & diagonal() const { return diag_M; }
+
       private:
         viennacl::vector<ScalarType> diag_M;
     };
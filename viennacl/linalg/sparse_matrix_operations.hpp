@@ -121,6 +121,40 @@ namespace viennacl
     }
 
 
+    /** @brief Carries out matrix-vector multiplication with a symmetric_compressed_matrix
+    *
+    * Implementation of the convenience expression result = alpha * prod(mat, vec) + beta * result;
+    * Only available for matrices in main memory.
+    *
+    * @param mat    The matrix
+    * @param vec    The vector
+    * @param alpha  Scaling factor for the matrix-vector product
+    * @param result The result vector
+    * @param beta   Scaling factor for the previous content of result. If zero, result is not read.
+    */
+    template<typename NumericT>
+    void prod_impl(const viennacl::symmetric_compressed_matrix<NumericT> & mat,
+                   const viennacl::vector_base<NumericT> & vec,
+                   NumericT alpha,
+                         viennacl::vector_base<NumericT> & result,
+                   NumericT beta)
+    {
+      assert( (mat.size1() == result.size()) && bool("Size check failed for symmetric matrix-vector product: size1(mat) != size(result)"));
+      assert( (mat.size2() == vec.size())    && bool("Size check failed for symmetric matrix-vector product: size2(mat) != size(x)"));
+
+      switch (viennacl::traits::handle(mat).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_impl(mat, vec, alpha, result, beta);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+
     // A * B
     /** @brief Carries out matrix-matrix multiplication first matrix being sparse
     *
@@ -203,6 +237,84 @@ namespace viennacl
       }
     }
 
+    /** @brief Carries out matrix-matrix multiplication with a compressed_matrix and a dense matrix
+    *
+    * Implementation of the convenience expression result = alpha * prod(sp_mat, d_mat) + beta * result;
+    * For matrices in main memory the scaling is fused into the product. Other backends compute the product into a temporary if beta is nonzero.
+    *
+    * @param sp_mat   The sparse matrix
+    * @param d_mat    The dense matrix
+    * @param alpha    Scaling factor for the product
+    * @param result   The result matrix (dense)
+    * @param beta     Scaling factor for the previous content of result. If zero, result is not read.
+    */
+    template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+    void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & sp_mat,
+                   const viennacl::matrix_base<NumericT> & d_mat,
+                   NumericT alpha,
+                         viennacl::matrix_base<NumericT> & result,
+                   NumericT beta)
+    {
+      assert( (sp_mat.size1() == result.size1()) && bool("Size check failed for compressed matrix - dense matrix product: size1(sp_mat) != size1(result)"));
+      assert( (sp_mat.size2() == d_mat.size1()) && bool("Size check failed for compressed matrix - dense matrix product: size2(sp_mat) != size1(d_mat)"));
+
+      if (viennacl::traits::handle(sp_mat).get_active_handle_id() == viennacl::MAIN_MEMORY)
+        viennacl::linalg::host_based::prod_impl(sp_mat, d_mat, alpha, result, beta);
+      else if (beta > 0 || beta < 0)
+      {
+        // the temporary has the layout of result, as ambm() does not support mixed layouts:
+        viennacl::matrix_base<NumericT> temp(result.size1(), result.size2(), result.row_major(), viennacl::traits::context(result));
+        prod_impl(sp_mat, d_mat, temp);
+        viennacl::linalg::ambm(result, temp, alpha, 1, false, false, result, beta, 1, false, false);
+      }
+      else
+      {
+        prod_impl(sp_mat, d_mat, result);
+        if (alpha < 1 || alpha > 1)
+          viennacl::linalg::am(result, result, alpha, 1, false, false);
+      }
+    }
+
+    /** @brief Carries out matrix-matrix multiplication with a compressed_matrix and a transposed dense matrix
+    *
+    * Implementation of the convenience expression result = alpha * prod(sp_mat, trans(d_mat)) + beta * result;
+    * For matrices in main memory the scaling is fused into the product. Other backends compute the product into a temporary if beta is nonzero.
+    *
+    * @param sp_mat   The sparse matrix
+    * @param d_mat    The dense matrix (transposed)
+    * @param alpha    Scaling factor for the product
+    * @param result   The result matrix (dense)
+    * @param beta     Scaling factor for the previous content of result. If zero, result is not read.
+    */
+    template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+    void prod_impl(const viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> & sp_mat,
+                   const viennacl::matrix_expression<const viennacl::matrix_base<NumericT>,
+                                                     const viennacl::matrix_base<NumericT>,
+                                                     viennacl::op_trans>& d_mat,
+                   NumericT alpha,
+                         viennacl::matrix_base<NumericT> & result,
+                   NumericT beta)
+    {
+      assert( (sp_mat.size1() == result.size1()) && bool("Size check failed for compressed matrix - dense matrix product: size1(sp_mat) != size1(result)"));
+      assert( (sp_mat.size2() == d_mat.size1()) && bool("Size check failed for compressed matrix - dense matrix product: size2(sp_mat) != size1(d_mat)"));
+
+      if (viennacl::traits::handle(sp_mat).get_active_handle_id() == viennacl::MAIN_MEMORY)
+        viennacl::linalg::host_based::prod_impl(sp_mat, d_mat, alpha, result, beta);
+      else if (beta > 0 || beta < 0)
+      {
+        // the temporary has the layout of result, as ambm() does not support mixed layouts:
+        viennacl::matrix_base<NumericT> temp(result.size1(), result.size2(), result.row_major(), viennacl::traits::context(result));
+        prod_impl(sp_mat, d_mat, temp);
+        viennacl::linalg::ambm(result, temp, alpha, 1, false, false, result, beta, 1, false, false);
+      }
+      else
+      {
+        prod_impl(sp_mat, d_mat, result);
+        if (alpha < 1 || alpha > 1)
+          viennacl::linalg::am(result, result, alpha, 1, false, false);
+      }
+    }
+
     // A * B with both A and B sparse
 
     /** @brief Carries out sparse_matrix-sparse_matrix multiplication for CSR matrices
@@ -247,6 +359,155 @@ namespace viennacl
     }
 
 
+    /** @brief Computes the sparsity pattern of the sparse matrix-matrix product C = A * B for CSR matrices.
+    *
+    * The plan is reused by prod_numeric() for products of matrices with the same sparsity patterns as A and B, e.g. in AMG setups or time-stepping schemes where only the values change.
+    * The sparsity pattern is only computed for matrices in main memory. For other memory domains prod_numeric() carries out the full product.
+    *
+    * @param A     Left factor
+    * @param B     Right factor
+    * @param plan  The plan holding the sparsity pattern of C
+    */
+    template<typename NumericT>
+    void prod_symbolic(const viennacl::compressed_matrix<NumericT> & A,
+                       const viennacl::compressed_matrix<NumericT> & B,
+                             viennacl::linalg::spgemm_plan & plan)
+    {
+      assert( (A.size2() == B.size1()) && bool("Size check failed for sparse matrix-matrix product: size2(A) != size1(B)"));
+
+      switch (viennacl::traits::handle(A).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::prod_symbolic(A, B, plan);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          plan = viennacl::linalg::spgemm_plan();
+          plan.size1 = A.size1();
+          plan.size2 = B.size2();
+          plan.A_nnz = A.nnz();
+          plan.B_nnz = B.nnz();
+      }
+    }
+
+    /** @brief Computes the sparse matrix-matrix product C = A * B for CSR matrices using the sparsity pattern of C computed by prod_symbolic().
+    *
+    * A and B must have the same sparsity patterns as the matrices the plan was computed for. Only their values may differ.
+    *
+    * @param A     Left factor
+    * @param B     Right factor
+    * @param plan  The plan computed by prod_symbolic()
+    * @param C     Result matrix
+    */
+    template<typename NumericT>
+    void prod_numeric(const viennacl::compressed_matrix<NumericT> & A,
+                      const viennacl::compressed_matrix<NumericT> & B,
+                      const viennacl::linalg::spgemm_plan & plan,
+                            viennacl::compressed_matrix<NumericT> & C)
+    {
+      assert( (A.size2() == B.size1())                              && bool("Size check failed for sparse matrix-matrix product: size2(A) != size1(B)"));
+      assert( (A.size1() == plan.size1 && B.size2() == plan.size2)  && bool("Size check failed for sparse matrix-matrix product: factors do not match the plan"));
+
+      if (viennacl::traits::handle(A).get_active_handle_id() == viennacl::MAIN_MEMORY && !plan.row_buffer.empty())
+        viennacl::linalg::host_based::prod_numeric(A, B, plan, C);
+      else
+        prod_impl(A, B, C);
+    }
+
+
+    /** @brief Computes the transposed matrix B = trans(A) of a compressed_matrix. Called by the transposition assignments of compressed_matrix.
+    *
+    * The transposition is carried out in main memory. Matrices in other memory domains are transferred to and from the host.
+    *
+    * @param proxy  An expression template proxy class holding A
+    * @param B      The result matrix
+    */
+    template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+    void trans(const matrix_expression<const compressed_matrix<NumericT, AlignmentV, IndexT>, const compressed_matrix<NumericT, AlignmentV, IndexT>, op_trans> & proxy,
+               compressed_matrix<NumericT, AlignmentV, IndexT> & B)
+    {
+      compressed_matrix<NumericT, AlignmentV, IndexT> const & A = proxy.lhs();
+      assert( (&A != &B) && bool("Output matrix of transposition must not coincide with the input matrix"));
+
+      viennacl::context orig_ctx = viennacl::traits::context(A);
+      viennacl::context cpu_ctx(viennacl::MAIN_MEMORY);
+      (void)orig_ctx;
+      (void)cpu_ctx;
+
+      viennacl::compressed_matrix<NumericT, AlignmentV, IndexT> A_host(0, 0, 0, cpu_ctx);
+      (void)A_host;
+
+      switch (viennacl::traits::handle(A).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::trans(A, B);
+          break;
+#ifdef VIENNACL_WITH_OPENCL
+        case viennacl::OPENCL_MEMORY:
+          A_host = A;
+          B.switch_memory_context(cpu_ctx);
+          viennacl::linalg::host_based::trans(A_host, B);
+          B.switch_memory_context(orig_ctx);
+          break;
+#endif
+#ifdef VIENNACL_WITH_CUDA
+        case viennacl::CUDA_MEMORY:
+          A_host = A;
+          B.switch_memory_context(cpu_ctx);
+          viennacl::linalg::host_based::trans(A_host, B);
+          B.switch_memory_context(orig_ctx);
+          break;
+#endif
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          throw memory_exception("not implemented");
+      }
+    }
+
+    /** @brief Computes the transposed matrix B = trans(A) of a coordinate_matrix. Called by the transposition assignments of coordinate_matrix, which set up the memory of B.
+    *
+    * The transposition is carried out in main memory. Matrices in other memory domains are transferred to and from the host.
+    *
+    * @param proxy  An expression template proxy class holding A
+    * @param B      The result matrix
+    */
+    template<typename NumericT, unsigned int AlignmentV, typename IndexT>
+    void trans(const matrix_expression<const coordinate_matrix<NumericT, AlignmentV, IndexT>, const coordinate_matrix<NumericT, AlignmentV, IndexT>, op_trans> & proxy,
+               coordinate_matrix<NumericT, AlignmentV, IndexT> & B)
+    {
+      coordinate_matrix<NumericT, AlignmentV, IndexT> const & A = proxy.lhs();
+      assert( (&A != &B) && bool("Output matrix of transposition must not coincide with the input matrix"));
+      assert( (B.size1() == A.size2() && B.size2() == A.size1() && B.nnz() == A.nnz()) && bool("Size check failed for transposition of coordinate_matrix"));
+
+      switch (viennacl::traits::handle(A).get_active_handle_id())
+      {
+        case viennacl::MAIN_MEMORY:
+          viennacl::linalg::host_based::trans(A, B);
+          break;
+        case viennacl::MEMORY_NOT_INITIALIZED:
+          throw memory_exception("not initialised!");
+        default:
+          if (A.nnz() > 0)
+          {
+            std::vector<IndexT>   A_coords(2 * A.nnz()), B_coords(2 * A.nnz()), B_group_boundaries(B.groups() + 1);
+            std::vector<NumericT> A_elements(A.nnz()),   B_elements(A.nnz());
+
+            viennacl::backend::memory_read(A.handle12(), 0, sizeof(IndexT)   * A_coords.size(), &(A_coords[0]));
+            viennacl::backend::memory_read(A.handle(),   0, sizeof(NumericT) * A_elements.size(), &(A_elements[0]));
+
+            viennacl::linalg::host_based::detail::coo_transpose(&(A_coords[0]), &(A_elements[0]), A.nnz(), A.size2(),
+                                                                &(B_coords[0]), &(B_elements[0]), &(B_group_boundaries[0]), B.groups());
+
+            viennacl::backend::memory_write(B.handle12(), 0, sizeof(IndexT)   * B_coords.size(),           &(B_coords[0]));
+            viennacl::backend::memory_write(B.handle(),   0, sizeof(NumericT) * B_elements.size(),         &(B_elements[0]));
+            viennacl::backend::memory_write(B.handle3(),  0, sizeof(IndexT)   * B_group_boundaries.size(), &(B_group_boundaries[0]));
+          }
+      }
+    }
+
+
     /** @brief Carries out triangular inplace solves
     *
     * @param mat    The matrix
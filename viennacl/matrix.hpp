@@ -3698,8 +3698,13 @@ namespace detail
   {
     static void apply(vector_base<T> & lhs, vector_expression<const matrix_base<T>, const vector_base<T>, op_prod> const & rhs)
     {
-      vector_base<T> temp(rhs);
-      lhs += temp;
+      if (viennacl::traits::handle(rhs.rhs()) != viennacl::traits::handle(lhs) && viennacl::traits::handle(rhs.lhs()) != viennacl::traits::handle(lhs))
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), lhs, T(1), T(1));
+      else
+      {
+        vector_base<T> temp(rhs);
+        lhs += temp;
+      }
     }
   };
 
@@ -3713,8 +3718,13 @@ namespace detail
                       const vector_base<T>,
                       op_prod> const & rhs)
     {
-      vector_base<T> temp(rhs);
-      lhs += temp;
+      if (viennacl::traits::handle(rhs.rhs()) != viennacl::traits::handle(lhs) && viennacl::traits::handle(rhs.lhs()) != viennacl::traits::handle(lhs))
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), lhs, T(1), T(1));
+      else
+      {
+        vector_base<T> temp(rhs);
+        lhs += temp;
+      }
     }
   };
 
@@ -3792,8 +3802,13 @@ namespace detail
   {
     static void apply(vector_base<T> & lhs, vector_expression<const matrix_base<T>, const vector_base<T>, op_prod> const & rhs)
     {
-      vector_base<T> temp(rhs);
-      lhs -= temp;
+      if (viennacl::traits::handle(rhs.rhs()) != viennacl::traits::handle(lhs) && viennacl::traits::handle(rhs.lhs()) != viennacl::traits::handle(lhs))
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), lhs, T(-1), T(1));
+      else
+      {
+        vector_base<T> temp(rhs);
+        lhs -= temp;
+      }
     }
   };
 
@@ -3807,8 +3822,13 @@ namespace detail
                       const vector_base<T>,
                       op_prod> const & rhs)
     {
-      vector_base<T> temp(rhs);
-      lhs -= temp;
+      if (viennacl::traits::handle(rhs.rhs()) != viennacl::traits::handle(lhs) && viennacl::traits::handle(rhs.lhs()) != viennacl::traits::handle(lhs))
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), lhs, T(-1), T(1));
+      else
+      {
+        vector_base<T> temp(rhs);
+        lhs -= temp;
+      }
     }
   };
 
@@ -283,8 +283,8 @@ struct is_vandermonde_matrix<const viennacl::vandermonde_matrix<ScalarType, Alig
 //
 
 /** \cond */
-template<typename ScalarType, unsigned int AlignmentV>
-struct is_compressed_matrix<viennacl::compressed_matrix<ScalarType, AlignmentV> >
+template<typename ScalarType, unsigned int AlignmentV, typename IndexT>
+struct is_compressed_matrix<viennacl::compressed_matrix<ScalarType, AlignmentV, IndexT> >
 {
   enum { value = true };
 };
@@ -295,8 +295,8 @@ struct is_compressed_matrix<viennacl::compressed_matrix<ScalarType, AlignmentV>
 //
 
 /** \cond */
-template<typename ScalarType, unsigned int AlignmentV>
-struct is_coordinate_matrix<viennacl::coordinate_matrix<ScalarType, AlignmentV> >
+template<typename ScalarType, unsigned int AlignmentV, typename IndexT>
+struct is_coordinate_matrix<viennacl::coordinate_matrix<ScalarType, AlignmentV, IndexT> >
 {
   enum { value = true };
 };
@@ -335,6 +335,17 @@ struct is_hyb_matrix<viennacl::hyb_matrix<ScalarType, AlignmentV> >
 };
 /** \endcond */
 
+//
+// is_block_compressed_matrix
+//
+/** \cond */
+template<typename ScalarType, unsigned int BlockSize>
+struct is_block_compressed_matrix<viennacl::block_compressed_matrix<ScalarType, BlockSize> >
+{
+  enum { value = true };
+};
+/** \endcond */
+
 
 //
 // is_any_sparse_matrix
@@ -346,8 +357,8 @@ struct is_hyb_matrix<viennacl::hyb_matrix<ScalarType, AlignmentV> >
 //};
 
 /** \cond */
-template<typename ScalarType, unsigned int AlignmentV>
-struct is_any_sparse_matrix<viennacl::compressed_matrix<ScalarType, AlignmentV> >
+template<typename ScalarType, unsigned int AlignmentV, typename IndexT>
+struct is_any_sparse_matrix<viennacl::compressed_matrix<ScalarType, AlignmentV, IndexT> >
 {
   enum { value = true };
 };
@@ -358,8 +369,8 @@ struct is_any_sparse_matrix<viennacl::compressed_compressed_matrix<ScalarType> >
   enum { value = true };
 };
 
-template<typename ScalarType, unsigned int AlignmentV>
-struct is_any_sparse_matrix<viennacl::coordinate_matrix<ScalarType, AlignmentV> >
+template<typename ScalarType, unsigned int AlignmentV, typename IndexT>
+struct is_any_sparse_matrix<viennacl::coordinate_matrix<ScalarType, AlignmentV, IndexT> >
 {
   enum { value = true };
 };
@@ -382,6 +393,18 @@ struct is_any_sparse_matrix<viennacl::hyb_matrix<ScalarType, AlignmentV> >
   enum { value = true };
 };
 
+template<typename ScalarType, unsigned int BlockSize>
+struct is_any_sparse_matrix<viennacl::block_compressed_matrix<ScalarType, BlockSize> >
+{
+  enum { value = true };
+};
+
+template<typename ScalarType>
+struct is_any_sparse_matrix<viennacl::symmetric_compressed_matrix<ScalarType> >
+{
+  enum { value = true };
+};
+
 template<typename T>
 struct is_any_sparse_matrix<const T>
 {
@@ -420,8 +420,8 @@ struct cpu_value_type<viennacl::matrix_slice<T> >
   typedef typename cpu_value_type<T>::type    type;
 };
 
-template<typename T, unsigned int AlignmentV>
-struct cpu_value_type<viennacl::compressed_matrix<T, AlignmentV> >
+template<typename T, unsigned int AlignmentV, typename IndexT>
+struct cpu_value_type<viennacl::compressed_matrix<T, AlignmentV, IndexT> >
 {
   typedef typename cpu_value_type<T>::type    type;
 };
@@ -432,8 +432,8 @@ struct cpu_value_type<viennacl::compressed_compressed_matrix<T> >
   typedef typename cpu_value_type<T>::type    type;
 };
 
-template<typename T, unsigned int AlignmentV>
-struct cpu_value_type<viennacl::coordinate_matrix<T, AlignmentV> >
+template<typename T, unsigned int AlignmentV, typename IndexT>
+struct cpu_value_type<viennacl::coordinate_matrix<T, AlignmentV, IndexT> >
 {
   typedef typename cpu_value_type<T>::type    type;
 };
@@ -456,6 +456,24 @@ struct cpu_value_type<viennacl::hyb_matrix<T, AlignmentV> >
   typedef typename cpu_value_type<T>::type    type;
 };
 
+template<typename T, unsigned int BlockSize>
+struct cpu_value_type<viennacl::block_compressed_matrix<T, BlockSize> >
+{
+  typedef typename cpu_value_type<T>::type    type;
+};
+
+template<typename T>
+struct cpu_value_type<viennacl::symmetric_compressed_matrix<T> >
+{
+  typedef typename cpu_value_type<T>::type    type;
+};
+
+template<typename T>
+struct cpu_value_type<viennacl::tools::adaptive_sparse_matrix<T> >
+{
+  typedef typename cpu_value_type<T>::type    type;
+};
+
 template<typename T, unsigned int AlignmentV>
 struct cpu_value_type<viennacl::circulant_matrix<T, AlignmentV> >
 {
@@ -504,18 +522,30 @@ struct vector_for_matrix< viennacl::matrix<T, F, A> >
   typedef viennacl::vector<T,A>   type;
 };
 
-template<typename T, unsigned int A>
-struct vector_for_matrix< viennacl::compressed_matrix<T, A> >
+template<typename T, unsigned int A, typename I>
+struct vector_for_matrix< viennacl::compressed_matrix<T, A, I> >
 {
   typedef viennacl::vector<T,A>   type;
 };
 
-template<typename T, unsigned int A>
-struct vector_for_matrix< viennacl::coordinate_matrix<T, A> >
+template<typename T, unsigned int A, typename I>
+struct vector_for_matrix< viennacl::coordinate_matrix<T, A, I> >
 {
   typedef viennacl::vector<T,A>   type;
 };
 
+template<typename T>
+struct vector_for_matrix< viennacl::symmetric_compressed_matrix<T> >
+{
+  typedef viennacl::vector<T>   type;
+};
+
+template<typename T>
+struct vector_for_matrix< viennacl::tools::adaptive_sparse_matrix<T> >
+{
+  typedef viennacl::vector<T>   type;
+};
+
 #ifdef VIENNACL_WITH_UBLAS
 //Boost:
 template<typename T, typename F, typename A>
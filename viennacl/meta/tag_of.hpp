@@ -233,14 +233,14 @@ namespace traits
     typedef viennacl::tag_viennacl  type;
   };
 
-  template< typename T, unsigned int I>
-  struct tag_of< viennacl::compressed_matrix<T,I> >
+  template< typename T, unsigned int I, typename IndexT>
+  struct tag_of< viennacl::compressed_matrix<T,I,IndexT> >
   {
     typedef viennacl::tag_viennacl  type;
   };
 
-  template< typename T, unsigned int I>
-  struct tag_of< viennacl::coordinate_matrix<T,I> >
+  template< typename T, unsigned int I, typename IndexT>
+  struct tag_of< viennacl::coordinate_matrix<T,I,IndexT> >
   {
     typedef viennacl::tag_viennacl  type;
   };
@@ -264,6 +264,24 @@ namespace traits
     typedef viennacl::tag_viennacl  type;
   };
 
+  template< typename T, unsigned int B>
+  struct tag_of< viennacl::block_compressed_matrix<T,B> >
+  {
+    typedef viennacl::tag_viennacl  type;
+  };
+
+  template< typename T>
+  struct tag_of< viennacl::symmetric_compressed_matrix<T> >
+  {
+    typedef viennacl::tag_viennacl  type;
+  };
+
+  template< typename T>
+  struct tag_of< viennacl::tools::adaptive_sparse_matrix<T> >
+  {
+    typedef viennacl::tag_viennacl  type;
+  };
+
   template< typename T, unsigned int I>
   struct tag_of< viennacl::circulant_matrix<T,I> >
   {
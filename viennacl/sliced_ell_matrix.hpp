@@ -24,6 +24,8 @@
     Based on the SELL-C-sigma format provided by Kreutzer et al., 2014
 */
 
+#include <algorithm>
+#include <vector>
 
 #include "viennacl/forwards.h"
 #include "viennacl/vector.hpp"
@@ -40,7 +42,11 @@ namespace viennacl
   * Can be seen as a block-wise ELLPACK format, where C rows are accumulated into the same block
   * for which a column-wise storage is used. Enables fully-coalesced reads from global memory.
   *
-  * Note: Currently \f$ \sigma \f$ is fixed to 1, since the sorting of rows
+  * Rows are sorted by their number of nonzeros within windows of \f$ \sigma \f$ rows when the matrix is set up in main memory, which reduces the padding.
+  * The resulting permutation of the rows is stored alongside the matrix (see handle4()). For \f$ \sigma = 1 \f$ (default) the rows are not reordered.
+  * The compute kernels for OpenCL and CUDA do not support reordered rows, so \f$ \sigma \f$ is ignored for matrices set up in these memory domains.
+  *
+  * Padding entries have the value zero and repeat the last column index of their row (zero for empty rows), so kernels may process them without branches.
   */
 template<typename ScalarT, typename IndexT /* see forwards.h = unsigned int */>
 class sliced_ell_matrix
@@ -50,35 +56,39 @@ public:
   typedef scalar<typename viennacl::tools::CHECK_SCALAR_TEMPLATE_ARGUMENT<ScalarT>::ResultType>   value_type;
   typedef vcl_size_t                                                                              size_type;
 
-  explicit sliced_ell_matrix() : rows_(0), cols_(0), rows_per_block_(0) {}
+  explicit sliced_ell_matrix() : rows_(0), cols_(0), rows_per_block_(0), rows_for_sorting_(1) {}
 
   /** @brief Standard constructor for setting the row and column sizes as well as the block size.
     *
     * Supported values for num_rows_per_block_ are 32, 64, 128, 256. Other values may work, but are unlikely to yield good performance.
+    * num_rows_for_sorting is the window size \f$ \sigma \f$ for sorting rows by their number of nonzeros. Should be a multiple of num_rows_per_block_.
     **/
   sliced_ell_matrix(size_type num_rows,
                     size_type num_cols,
-                    size_type num_rows_per_block_ = 0)
+                    size_type num_rows_per_block_ = 0,
+                    size_type num_rows_for_sorting = 1)
     : rows_(num_rows),
       cols_(num_cols),
-      rows_per_block_(num_rows_per_block_) {}
+      rows_per_block_(num_rows_per_block_),
+      rows_for_sorting_(num_rows_for_sorting) {}
 
-  explicit sliced_ell_matrix(viennacl::context ctx) : rows_(0), cols_(0), rows_per_block_(0)
+  /** @brief Same as the standard constructor, but with the matrix residing in the provided context. */
+  sliced_ell_matrix(size_type num_rows,
+                    size_type num_cols,
+                    size_type num_rows_per_block_,
+                    size_type num_rows_for_sorting,
+                    viennacl::context ctx)
+    : rows_(num_rows),
+      cols_(num_cols),
+      rows_per_block_(num_rows_per_block_),
+      rows_for_sorting_(num_rows_for_sorting)
   {
-    columns_per_block_.switch_active_handle_id(ctx.memory_type());
-    column_indices_.switch_active_handle_id(ctx.memory_type());
-    block_start_.switch_active_handle_id(ctx.memory_type());
-    elements_.switch_active_handle_id(ctx.memory_type());
+    init_context(ctx);
+  }
 
-#ifdef VIENNACL_WITH_OPENCL
-    if (ctx.memory_type() == OPENCL_MEMORY)
-    {
-      columns_per_block_.opencl_handle().context(ctx.opencl_context());
-      column_indices_.opencl_handle().context(ctx.opencl_context());
-      block_start_.opencl_handle().context(ctx.opencl_context());
-      elements_.opencl_handle().context(ctx.opencl_context());
-    }
-#endif
+  explicit sliced_ell_matrix(viennacl::context ctx) : rows_(0), cols_(0), rows_per_block_(0), rows_for_sorting_(1)
+  {
+    init_context(ctx);
   }
 
   /** @brief Resets all entries in the matrix back to zero without changing the matrix size. Resets the sparsity pattern. */
@@ -103,6 +113,9 @@ public:
 
   vcl_size_t rows_per_block() const { return rows_per_block_; }
 
+  /** @brief Returns the size of the windows within which rows are sorted by their number of nonzeros (parameter sigma) */
+  vcl_size_t rows_for_sorting() const { return rows_for_sorting_; }
+
   //vcl_size_t nnz() const { return rows_ * maxnnz_; }
   //vcl_size_t internal_nnz() const { return internal_size1() * internal_maxnnz(); }
 
@@ -118,6 +131,10 @@ public:
   handle_type & handle()       { return elements_; }
   const handle_type & handle() const { return elements_; }
 
+  /** @brief Returns the handle to the row permutation: Entry i holds the index of the matrix row stored at position i. Empty if the rows are not reordered. */
+  handle_type & handle4()       { return row_permutation_; }
+  const handle_type & handle4() const { return row_permutation_; }
+
 #if defined(_MSC_VER) && _MSC_VER < 1500          //Visual Studio 2005 needs special treatment
   template<typename CPUMatrixT>
   friend void copy(CPUMatrixT const & cpu_matrix, sliced_ell_matrix & gpu_matrix );
@@ -126,17 +143,56 @@ public:
   friend void copy(CPUMatrixT const & cpu_matrix, sliced_ell_matrix<ScalarT2, IndexT2> & gpu_matrix );
 #endif
 
+  template<typename MatrixT>
+  friend struct viennacl::io::detail::binary_matrix_io;
+
 private:
+  void init_context(viennacl::context ctx)
+  {
+    columns_per_block_.switch_active_handle_id(ctx.memory_type());
+    column_indices_.switch_active_handle_id(ctx.memory_type());
+    block_start_.switch_active_handle_id(ctx.memory_type());
+    elements_.switch_active_handle_id(ctx.memory_type());
+    row_permutation_.switch_active_handle_id(ctx.memory_type());
+
+#ifdef VIENNACL_WITH_OPENCL
+    if (ctx.memory_type() == OPENCL_MEMORY)
+    {
+      columns_per_block_.opencl_handle().context(ctx.opencl_context());
+      column_indices_.opencl_handle().context(ctx.opencl_context());
+      block_start_.opencl_handle().context(ctx.opencl_context());
+      elements_.opencl_handle().context(ctx.opencl_context());
+      row_permutation_.opencl_handle().context(ctx.opencl_context());
+    }
+#endif
+  }
+
   vcl_size_t rows_;
   vcl_size_t cols_;
   vcl_size_t rows_per_block_; //parameter C in the paper by Kreutzer et al.
+  vcl_size_t rows_for_sorting_; //parameter sigma in the paper by Kreutzer et al.
 
   handle_type columns_per_block_;
   handle_type column_indices_;
   handle_type block_start_;
   handle_type elements_;
+  handle_type row_permutation_;
 };
 
+namespace detail
+{
+  /** @brief Orders rows of a sliced_ell_matrix by decreasing number of nonzeros */
+  template<typename IndexT>
+  struct sliced_ell_row_length_greater
+  {
+    sliced_ell_row_length_greater(std::vector<vcl_size_t> const & row_lengths) : row_lengths_(row_lengths) {}
+
+    bool operator()(IndexT a, IndexT b) const { return row_lengths_[a] > row_lengths_[b]; }
+
+    std::vector<vcl_size_t> const & row_lengths_;
+  };
+}
+
 template<typename CPUMatrixT, typename ScalarT, typename IndexT>
 void copy(CPUMatrixT const & cpu_matrix, sliced_ell_matrix<ScalarT, IndexT> & gpu_matrix )
 {
@@ -146,28 +202,53 @@ void copy(CPUMatrixT const & cpu_matrix, sliced_ell_matrix<ScalarT, IndexT> & gp
   if (gpu_matrix.rows_per_block() == 0) // not yet initialized by user. Set default: 32 is perfect for NVIDIA GPUs and older AMD GPUs. Still okay for newer AMD GPUs.
     gpu_matrix.rows_per_block_ = 32;
 
+  if (gpu_matrix.rows_for_sorting() == 0)
+    gpu_matrix.rows_for_sorting_ = 1;
+
   if (viennacl::traits::size1(cpu_matrix) > 0 && viennacl::traits::size2(cpu_matrix) > 0)
   {
-    //determine max capacity for row
-    IndexT columns_in_current_block = 0;
-    vcl_size_t total_element_buffer_size = 0;
-    viennacl::backend::typesafe_host_array<IndexT> columns_in_block_buffer(gpu_matrix.handle1(), (viennacl::traits::size1(cpu_matrix) - 1) / gpu_matrix.rows_per_block() + 1);
+    vcl_size_t num_rows       = viennacl::traits::size1(cpu_matrix);
+    vcl_size_t rows_per_block = gpu_matrix.rows_per_block();
+    vcl_size_t num_blocks     = (num_rows - 1) / rows_per_block + 1;
+
+    //determine number of entries in each row
+    std::vector<vcl_size_t> entries_in_row(num_rows);
     for (typename CPUMatrixT::const_iterator1 row_it = cpu_matrix.begin1(); row_it != cpu_matrix.end1(); ++row_it)
-    {
-      vcl_size_t entries_in_row = 0;
       for (typename CPUMatrixT::const_iterator2 col_it = row_it.begin(); col_it != row_it.end(); ++col_it)
-        ++entries_in_row;
+        ++entries_in_row[row_it.index1()];
 
-      columns_in_current_block = std::max(columns_in_current_block, static_cast<IndexT>(entries_in_row));
+    //sort rows by decreasing number of entries within windows of sigma rows. Only supported by the host kernels.
+    std::vector<IndexT> permutation(num_rows);
+    for (vcl_size_t i=0; i<num_rows; ++i)
+      permutation[i] = static_cast<IndexT>(i);
 
-      // check for end of block
-      if ( (row_it.index1() % gpu_matrix.rows_per_block() == gpu_matrix.rows_per_block() - 1)
-           || row_it.index1() == viennacl::traits::size1(cpu_matrix) - 1)
-      {
-        total_element_buffer_size += columns_in_current_block * gpu_matrix.rows_per_block();
-        columns_in_block_buffer.set(row_it.index1() / gpu_matrix.rows_per_block(), columns_in_current_block);
-        columns_in_current_block = 0;
-      }
+    bool sort_rows = (gpu_matrix.rows_for_sorting() > 1 && traits::context(gpu_matrix.handle1()).memory_type() == MAIN_MEMORY);
+    if (sort_rows)
+    {
+      detail::sliced_ell_row_length_greater<IndexT> comp(entries_in_row);
+      for (vcl_size_t window_start = 0; window_start < num_rows; window_start += gpu_matrix.rows_for_sorting())
+        std::stable_sort(permutation.begin() + static_cast<long>(window_start),
+                         permutation.begin() + static_cast<long>(std::min(window_start + gpu_matrix.rows_for_sorting(), num_rows)),
+                         comp);
+    }
+
+    std::vector<vcl_size_t> position_of_row(num_rows);  // inverse permutation
+    for (vcl_size_t i=0; i<num_rows; ++i)
+      position_of_row[permutation[i]] = i;
+
+    //determine max capacity for each block
+    vcl_size_t total_element_buffer_size = 0;
+    viennacl::backend::typesafe_host_array<IndexT> columns_in_block_buffer(gpu_matrix.handle1(), num_blocks);
+    viennacl::backend::typesafe_host_array<IndexT> block_start(gpu_matrix.handle3(), num_blocks);
+    for (vcl_size_t block_index = 0; block_index < num_blocks; ++block_index)
+    {
+      vcl_size_t columns_in_current_block = 0;
+      for (vcl_size_t i = block_index * rows_per_block; i < std::min((block_index + 1) * rows_per_block, num_rows); ++i)
+        columns_in_current_block = std::max(columns_in_current_block, entries_in_row[permutation[i]]);
+
+      columns_in_block_buffer.set(block_index, columns_in_current_block);
+      block_start.set(block_index, static_cast<IndexT>(total_element_buffer_size));
+      total_element_buffer_size += columns_in_current_block * rows_per_block;
     }
 
     //setup GPU matrix
@@ -175,41 +256,44 @@ void copy(CPUMatrixT const & cpu_matrix, sliced_ell_matrix<ScalarT, IndexT> & gp
     gpu_matrix.cols_ = cpu_matrix.size2();
 
     viennacl::backend::typesafe_host_array<IndexT> coords(gpu_matrix.handle2(), total_element_buffer_size);
-    viennacl::backend::typesafe_host_array<IndexT> block_start(gpu_matrix.handle3(), (viennacl::traits::size1(cpu_matrix) - 1) / gpu_matrix.rows_per_block() + 1);
     std::vector<ScalarT> elements(total_element_buffer_size, 0);
 
-    vcl_size_t block_offset = 0;
-    vcl_size_t block_index  = 0;
-    vcl_size_t row_in_block = 0;
     for (typename CPUMatrixT::const_iterator1 row_it = cpu_matrix.begin1(); row_it != cpu_matrix.end1(); ++row_it)
     {
-      vcl_size_t entry_in_row = 0;
+      vcl_size_t position     = position_of_row[row_it.index1()];
+      vcl_size_t block_index  = position / rows_per_block;
+      vcl_size_t row_in_block = position % rows_per_block;
+      vcl_size_t block_offset = block_start[block_index];
 
+      vcl_size_t entry_in_row = 0;
+      vcl_size_t last_column  = 0;
       for (typename CPUMatrixT::const_iterator2 col_it = row_it.begin(); col_it != row_it.end(); ++col_it)
       {
-        vcl_size_t buffer_index = block_offset + entry_in_row * gpu_matrix.rows_per_block() + row_in_block;
+        vcl_size_t buffer_index = block_offset + entry_in_row * rows_per_block + row_in_block;
         coords.set(buffer_index, col_it.index2());
         elements[buffer_index] = *col_it;
+        last_column = col_it.index2();
         entry_in_row++;
       }
 
-      ++row_in_block;
-
-      // check for end of block:
-      if ( (row_it.index1() % gpu_matrix.rows_per_block() == gpu_matrix.rows_per_block() - 1)
-           || row_it.index1() == viennacl::traits::size1(cpu_matrix) - 1)
-      {
-        block_start.set(block_index, static_cast<IndexT>(block_offset));
-        block_offset += columns_in_block_buffer[block_index] * gpu_matrix.rows_per_block();
-        ++block_index;
-        row_in_block = 0;
-      }
+      // padding: value zero, valid column index
+      for (; entry_in_row < columns_in_block_buffer[block_index]; ++entry_in_row)
+        coords.set(block_offset + entry_in_row * rows_per_block + row_in_block, last_column);
     }
 
     viennacl::backend::memory_create(gpu_matrix.handle1(), columns_in_block_buffer.raw_size(), traits::context(gpu_matrix.handle1()), columns_in_block_buffer.get());
     viennacl::backend::memory_create(gpu_matrix.handle2(), coords.raw_size(),                  traits::context(gpu_matrix.handle2()), coords.get());
     viennacl::backend::memory_create(gpu_matrix.handle3(), block_start.raw_size(),             traits::context(gpu_matrix.handle3()), block_start.get());
     viennacl::backend::memory_create(gpu_matrix.handle(),  sizeof(ScalarT) * elements.size(),  traits::context(gpu_matrix.handle()), &(elements[0]));
+
+    gpu_matrix.row_permutation_ = viennacl::backend::mem_handle();
+    if (sort_rows)
+    {
+      viennacl::backend::typesafe_host_array<IndexT> row_permutation(gpu_matrix.handle4(), num_rows);
+      for (vcl_size_t i=0; i<num_rows; ++i)
+        row_permutation.set(i, permutation[i]);
+      viennacl::backend::memory_create(gpu_matrix.handle4(), row_permutation.raw_size(), traits::context(gpu_matrix.handle1()), row_permutation.get());
+    }
   }
 }
 
@@ -0,0 +1,371 @@
+#ifndef VIENNACL_SYMMETRIC_COMPRESSED_MATRIX_HPP_
+#define VIENNACL_SYMMETRIC_COMPRESSED_MATRIX_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/symmetric_compressed_matrix.hpp
+    @brief Implementation of the symmetric_compressed_matrix class (symmetric matrices in compressed sparse row format, upper triangle only)
+*/
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+
+#include "viennacl/tools/tools.hpp"
+
+#include "viennacl/linalg/sparse_matrix_operations.hpp"
+
+namespace viennacl
+{
+/** @brief Sparse matrix class for symmetric matrices, storing the upper triangle (including the diagonal) in the compressed sparse row format.
+    *
+    * Matrix-vector products read each off-diagonal entry once and use it for both the entry and its transposed counterpart,
+    * so only about half of the matrix entries are transferred from memory compared to a compressed_matrix.
+    * This is useful for symmetric systems such as the ones solved with the conjugate gradient method, or for eigenvalue computations with the Lanczos method.
+    *
+    * handle1() holds the row offsets, handle2() the column indices (sorted within each row, each at least the row index), and handle() the entries.
+    * Matrix-vector products are only available in main memory (host backend).
+    */
+template<typename NumericT>
+class symmetric_compressed_matrix
+{
+public:
+  typedef viennacl::backend::mem_handle                                                              handle_type;
+  typedef scalar<typename viennacl::tools::CHECK_SCALAR_TEMPLATE_ARGUMENT<NumericT>::ResultType>   value_type;
+  typedef vcl_size_t                                                                                 size_type;
+
+  symmetric_compressed_matrix() : size_(0), nonzeros_(0) {}
+
+  explicit symmetric_compressed_matrix(viennacl::context ctx) : size_(0), nonzeros_(0)
+  {
+    init_context(ctx);
+  }
+
+  /** @brief Construction of a symmetric compressed matrix with the supplied number of rows (and columns).
+  *
+  * @param size     Number of rows and columns
+  * @param ctx      Optional context in which the matrix is created (one out of multiple OpenCL contexts, CUDA, host)
+  */
+  explicit symmetric_compressed_matrix(vcl_size_t size, viennacl::context ctx = viennacl::context()) : size_(size), nonzeros_(0)
+  {
+    init_context(ctx);
+  }
+
+  /** @brief Sets the matrix from the three arrays of the compressed sparse row format of its upper triangle in main memory.
+  *
+  * @param row_jumper   Row offsets, size + 1 entries
+  * @param col_buffer   Column indices, at least the row index of the respective row, nonzeros entries
+  * @param elements     Entries, nonzeros entries
+  * @param size         Number of rows and columns
+  * @param nonzeros     Number of stored entries
+  */
+  void set(unsigned int const * row_jumper, unsigned int const * col_buffer, NumericT const * elements, vcl_size_t size, vcl_size_t nonzeros)
+  {
+    size_ = size;
+    nonzeros_ = nonzeros;
+    row_statistics_ = viennacl::detail::csr_row_statistics();
+
+    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(row_buffer_, size + 1);
+    for (vcl_size_t i = 0; i <= size; ++i)
+      row_buffer.set(i, row_jumper[i]);
+    viennacl::backend::memory_create(row_buffer_, row_buffer.raw_size(), viennacl::traits::context(row_buffer_), row_buffer.get());
+
+    if (nonzeros > 0)
+    {
+      viennacl::backend::typesafe_host_array<unsigned int> col_buffer_host(col_buffer_, nonzeros);
+      for (vcl_size_t k = 0; k < nonzeros; ++k)
+        col_buffer_host.set(k, col_buffer[k]);
+      viennacl::backend::memory_create(col_buffer_, col_buffer_host.raw_size(), viennacl::traits::context(col_buffer_), col_buffer_host.get());
+      viennacl::backend::memory_create(elements_, sizeof(NumericT) * nonzeros, viennacl::traits::context(elements_), elements);
+    }
+  }
+
+  /** @brief Resets all entries in the matrix back to zero without changing the matrix size. Resets the sparsity pattern. */
+  void clear()
+  {
+    nonzeros_ = 0;
+    row_statistics_ = viennacl::detail::csr_row_statistics();
+
+    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(row_buffer_, size_ + 1);
+    viennacl::backend::memory_create(row_buffer_, row_buffer.raw_size(), viennacl::traits::context(row_buffer_), row_buffer.get());
+  }
+
+  vcl_size_t size1() const { return size_; }
+  vcl_size_t size2() const { return size_; }
+
+  /** @brief Returns the number of stored entries, i.e. the nonzeros of the upper triangle including the diagonal */
+  vcl_size_t nnz() const { return nonzeros_; }
+
+  /** @brief Returns the handle to the row offsets. Call reset_row_statistics() after modifying the row offsets through the handle. */
+  handle_type & handle1()       { return row_buffer_; }
+  const handle_type & handle1() const { return row_buffer_; }
+
+  /** @brief Returns the handle to the column indices */
+  handle_type & handle2()       { return col_buffer_; }
+  const handle_type & handle2() const { return col_buffer_; }
+
+  /** @brief Returns the handle to the entries */
+  handle_type & handle()       { return elements_; }
+  const handle_type & handle() const { return elements_; }
+
+  /** @brief Returns the cached execution metadata (row partitions) used by the host backend. For internal use only. */
+  viennacl::detail::csr_row_statistics & row_statistics() const { return row_statistics_; }
+
+  /** @brief Discards the cached row partitions. Required after modifying the row offsets through handle1(). */
+  void reset_row_statistics() { row_statistics_ = viennacl::detail::csr_row_statistics(); }
+
+private:
+  void init_context(viennacl::context ctx)
+  {
+    row_buffer_.switch_active_handle_id(ctx.memory_type());
+    col_buffer_.switch_active_handle_id(ctx.memory_type());
+    elements_.switch_active_handle_id(ctx.memory_type());
+
+#ifdef VIENNACL_WITH_OPENCL
+    if (ctx.memory_type() == OPENCL_MEMORY)
+    {
+      row_buffer_.opencl_handle().context(ctx.opencl_context());
+      col_buffer_.opencl_handle().context(ctx.opencl_context());
+      elements_.opencl_handle().context(ctx.opencl_context());
+    }
+#endif
+  }
+
+  vcl_size_t size_;
+  vcl_size_t nonzeros_;
+
+  handle_type row_buffer_;
+  handle_type col_buffer_;
+  handle_type elements_;
+
+  mutable viennacl::detail::csr_row_statistics row_statistics_;
+};
+
+
+/** @brief Copies a symmetric sparse matrix from the host to the compute device. Only the entries of the upper triangle (including the diagonal) are read.
+  *
+  * There are some type requirements on the CPUMatrixT type (fulfilled by e.g. boost::numeric::ublas):
+  * - .size1() returns the number of rows, .size2() the number of columns. Both must be equal.
+  * - const_iterator1 is an iterator along increasing row indices, providing iterators of type const_iterator2 along the entries of the row via .begin() and .end().
+  * - const_iterator2 provides .index1() and .index2() returning the row and column index of the current entry, dereferenciation returns the entry.
+  *
+  * @param cpu_matrix   A symmetric sparse matrix on the host.
+  * @param gpu_matrix   A symmetric_compressed_matrix from ViennaCL
+  */
+template<typename CPUMatrixT, typename NumericT>
+void copy(const CPUMatrixT & cpu_matrix, symmetric_compressed_matrix<NumericT> & gpu_matrix)
+{
+  assert( (viennacl::traits::size1(cpu_matrix) == viennacl::traits::size2(cpu_matrix)) && bool("Matrix is not square!") );
+  assert( (gpu_matrix.size1() == 0 || viennacl::traits::size1(cpu_matrix) == gpu_matrix.size1()) && bool("Size mismatch") );
+
+  vcl_size_t size = cpu_matrix.size1();
+  if (size > 0)
+  {
+    std::vector<unsigned int> row_jumper(size + 1);
+    std::vector<unsigned int> col_buffer;
+    std::vector<NumericT>     elements;
+
+    for (typename CPUMatrixT::const_iterator1 row_it = cpu_matrix.begin1(); row_it != cpu_matrix.end1(); ++row_it)
+      for (typename CPUMatrixT::const_iterator2 col_it = row_it.begin(); col_it != row_it.end(); ++col_it)
+      {
+        if (col_it.index2() < col_it.index1())
+          continue;
+        ++row_jumper[col_it.index1() + 1];
+        col_buffer.push_back(static_cast<unsigned int>(col_it.index2()));
+        elements.push_back(*col_it);
+      }
+
+    for (vcl_size_t i = 0; i < size; ++i)
+      row_jumper[i + 1] += row_jumper[i];
+
+    gpu_matrix.set(&(row_jumper[0]), col_buffer.size() > 0 ? &(col_buffer[0]) : NULL, elements.size() > 0 ? &(elements[0]) : NULL,
+                   size, col_buffer.size());
+  }
+}
+
+
+/** @brief Copies a symmetric sparse matrix from the host to the compute device. The host type is the std::vector< std::map < > > format.
+  *
+  * Only the entries of the upper triangle (including the diagonal) are read.
+  *
+  * @param cpu_matrix   A symmetric sparse matrix on the host composed of an STL vector and an STL map.
+  * @param gpu_matrix   The sparse symmetric_compressed_matrix from ViennaCL
+  */
+template<typename IndexT, typename NumericT>
+void copy(std::vector< std::map<IndexT, NumericT> > const & cpu_matrix,
+          symmetric_compressed_matrix<NumericT> & gpu_matrix)
+{
+  viennacl::copy(tools::const_sparse_matrix_adapter<NumericT, IndexT>(cpu_matrix, cpu_matrix.size(), cpu_matrix.size()), gpu_matrix);
+}
+
+
+/** @brief Copies a symmetric_compressed_matrix from the compute device to the host. Both triangles are written.
+  *
+  * @param gpu_matrix   The sparse symmetric_compressed_matrix from ViennaCL
+  * @param cpu_matrix   A sparse matrix on the host supporting the assignment cpu_matrix(i, j) = value
+  */
+template<typename CPUMatrixT, typename NumericT>
+void copy(const symmetric_compressed_matrix<NumericT> & gpu_matrix, CPUMatrixT & cpu_matrix)
+{
+  assert( (viennacl::traits::size1(cpu_matrix) == gpu_matrix.size1()) && bool("Size mismatch") );
+  assert( (viennacl::traits::size2(cpu_matrix) == gpu_matrix.size2()) && bool("Size mismatch") );
+
+  if (gpu_matrix.size1() > 0 && gpu_matrix.nnz() > 0)
+  {
+    viennacl::backend::typesafe_host_array<unsigned int> row_buffer(gpu_matrix.handle1(), gpu_matrix.size1() + 1);
+    viennacl::backend::typesafe_host_array<unsigned int> col_buffer(gpu_matrix.handle2(), gpu_matrix.nnz());
+    std::vector<NumericT> elements(gpu_matrix.nnz());
+    viennacl::backend::memory_read(gpu_matrix.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
+    viennacl::backend::memory_read(gpu_matrix.handle2(), 0, col_buffer.raw_size(), col_buffer.get());
+    viennacl::backend::memory_read(gpu_matrix.handle(),  0, sizeof(NumericT) * elements.size(), &(elements[0]));
+
+    for (vcl_size_t row = 0; row < gpu_matrix.size1(); ++row)
+      for (vcl_size_t k = row_buffer[row]; k < row_buffer[row + 1]; ++k)
+      {
+        cpu_matrix(row, col_buffer[k]) = elements[k];
+        if (col_buffer[k] != row)
+          cpu_matrix(col_buffer[k], row) = elements[k];
+      }
+  }
+}
+
+
+/** @brief Copies a symmetric_compressed_matrix from the compute device to the host. The host type is the std::vector< std::map < > > format. Both triangles are written.
+  *
+  * @param gpu_matrix   The sparse symmetric_compressed_matrix from ViennaCL
+  * @param cpu_matrix   A sparse matrix on the host composed of an STL vector and an STL map.
+  */
+template<typename NumericT, typename IndexT>
+void copy(const symmetric_compressed_matrix<NumericT> & gpu_matrix,
+          std::vector< std::map<IndexT, NumericT> > & cpu_matrix)
+{
+  if (cpu_matrix.size() == 0)
+    cpu_matrix.resize(gpu_matrix.size1());
+
+  assert(cpu_matrix.size() == gpu_matrix.size1() && bool("Matrix dimension mismatch!"));
+
+  tools::sparse_matrix_adapter<NumericT, IndexT> temp(cpu_matrix, gpu_matrix.size1(), gpu_matrix.size2());
+  viennacl::copy(gpu_matrix, temp);
+}
+
+//
+// Specify available operations:
+//
+
+/** \cond */
+
+namespace linalg
+{
+namespace detail
+{
+  // x = A * y
+  template<typename T>
+  struct op_executor<vector_base<T>, op_assign, vector_expression<const symmetric_compressed_matrix<T>, const vector_base<T>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const symmetric_compressed_matrix<T>, const vector_base<T>, op_prod> const & rhs)
+    {
+      // check for the special case x = A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<T> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(1), temp, T(0));
+        lhs = temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(1), lhs, T(0));
+    }
+  };
+
+  template<typename T>
+  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const symmetric_compressed_matrix<T>, const vector_base<T>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const symmetric_compressed_matrix<T>, const vector_base<T>, op_prod> const & rhs)
+    {
+      // check for the special case x += A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<T> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(1), temp, T(0));
+        lhs += temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(1), lhs, T(1));
+    }
+  };
+
+  template<typename T>
+  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const symmetric_compressed_matrix<T>, const vector_base<T>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const symmetric_compressed_matrix<T>, const vector_base<T>, op_prod> const & rhs)
+    {
+      // check for the special case x -= A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<T> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(1), temp, T(0));
+        lhs -= temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), T(-1), lhs, T(1));
+    }
+  };
+
+
+  // x = A * vec_op
+  template<typename T, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_assign, vector_expression<const symmetric_compressed_matrix<T>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const symmetric_compressed_matrix<T>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, T(1), lhs, T(0));
+    }
+  };
+
+  // x += A * vec_op
+  template<typename T, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_inplace_add, vector_expression<const symmetric_compressed_matrix<T>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const symmetric_compressed_matrix<T>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, T(1), lhs, T(1));
+    }
+  };
+
+  // x -= A * vec_op
+  template<typename T, typename LHS, typename RHS, typename OP>
+  struct op_executor<vector_base<T>, op_inplace_sub, vector_expression<const symmetric_compressed_matrix<T>, const vector_expression<const LHS, const RHS, OP>, op_prod> >
+  {
+    static void apply(vector_base<T> & lhs, vector_expression<const symmetric_compressed_matrix<T>, const vector_expression<const LHS, const RHS, OP>, op_prod> const & rhs)
+    {
+      viennacl::vector<T> temp(rhs.rhs(), viennacl::traits::context(rhs));
+      viennacl::linalg::prod_impl(rhs.lhs(), temp, T(-1), lhs, T(1));
+    }
+  };
+
+} // namespace detail
+} // namespace linalg
+
+/** \endcond */
+}
+
+#endif
@@ -19,7 +19,7 @@
 ============================================================================= */
 
 /** @file viennacl/tools/adapter.hpp
-    @brief Adapter classes for sparse matrices made of the STL type std::vector<std::map<SizeT, NumericT> >
+    @brief Adapter classes for sparse matrices made of the STL type std::vector<std::map<SizeT, NumericT> > and for sparse matrices given by CSR arrays
 */
 
 #include <string>
@@ -416,6 +416,100 @@ private:
   size_type size2_;
 };
 
+
+/** @brief A const iterator for sparse matrices given by the three arrays of the compressed sparse row (CSR) format. See const_csr_matrix_adapter.
+*
+*  @tparam NumericT       either float or double
+*  @tparam is_iterator1   if true, this iterator iterates along increasing row indices, otherwise along the nonzeros of a row
+*/
+template<typename NumericT, typename IndexT, bool is_iterator1>
+class const_csr_matrix_adapted_iterator
+{
+  typedef const_csr_matrix_adapted_iterator<NumericT, IndexT, is_iterator1>    self_type;
+
+public:
+  typedef self_type     iterator1;
+  typedef self_type     iterator2;
+  typedef vcl_size_t    size_type;
+
+  /** @brief Iterator at row i (is_iterator1 == true) or at the nonzero with index k of row i (is_iterator1 == false) */
+  const_csr_matrix_adapted_iterator(IndexT const * row_buffer, IndexT const * col_buffer, NumericT const * elements, size_type i, size_type k)
+    : row_buffer_(row_buffer), col_buffer_(col_buffer), elements_(elements), i_(i), k_(k) {}
+
+  NumericT operator*(void) const { return elements_[k_]; }
+
+  self_type & operator++(void)
+  {
+    if (is_iterator1)
+      ++i_;
+    else
+      ++k_;
+    return *this;
+  }
+  self_type operator++(int) { self_type tmp = *this; ++(*this); return tmp; }
+
+  bool operator==(self_type const & other) const { return is_iterator1 ? (i_ == other.i_) : (k_ == other.k_); }
+  bool operator!=(self_type const & other) const { return !(*this == other); }
+
+  size_type index1() const { return i_; }
+  size_type index2() const
+  {
+    if (is_iterator1)
+      return 0;
+    return static_cast<size_type>(col_buffer_[k_]);
+  }
+
+  const_csr_matrix_adapted_iterator<NumericT, IndexT, !is_iterator1> begin() const
+  {
+    return const_csr_matrix_adapted_iterator<NumericT, IndexT, !is_iterator1>(row_buffer_, col_buffer_, elements_, i_, static_cast<size_type>(row_buffer_[i_]));
+  }
+  const_csr_matrix_adapted_iterator<NumericT, IndexT, !is_iterator1> end() const
+  {
+    return const_csr_matrix_adapted_iterator<NumericT, IndexT, !is_iterator1>(row_buffer_, col_buffer_, elements_, i_, static_cast<size_type>(row_buffer_[i_ + 1]));
+  }
+
+private:
+  IndexT   const * row_buffer_;
+  IndexT   const * col_buffer_;
+  NumericT const * elements_;
+  size_type i_;
+  size_type k_;
+};
+
+/** @brief Adapts the three arrays of the compressed sparse row (CSR) format to basic ublas-compatibility, so that a CSR matrix on the host can be copied to any sparse matrix type without an intermediate copy.
+*
+*  The arrays are not copied, hence they must outlive the adapter.
+*
+*  @tparam NumericT   either float or double
+*/
+template<typename NumericT, typename IndexT = unsigned int>
+class const_csr_matrix_adapter
+{
+public:
+  typedef const_csr_matrix_adapted_iterator<NumericT, IndexT, true>      const_iterator1;
+  typedef const_csr_matrix_adapted_iterator<NumericT, IndexT, false>     const_iterator2;
+
+  typedef NumericT    value_type;
+  typedef vcl_size_t  size_type;
+
+  /** @brief Sets up the adapter. row_buffer holds num_rows + 1 entries, col_buffer and elements hold row_buffer[num_rows] entries each. */
+  const_csr_matrix_adapter(IndexT const * row_buffer, IndexT const * col_buffer, NumericT const * elements, size_type num_rows, size_type num_cols)
+    : row_buffer_(row_buffer), col_buffer_(col_buffer), elements_(elements), size1_(num_rows), size2_(num_cols) {}
+
+  size_type size1() const { return size1_; }
+  size_type size2() const { return size2_; }
+
+  const_iterator1 begin1() const { return const_iterator1(row_buffer_, col_buffer_, elements_, 0, 0); }
+  const_iterator1 end1() const   { return const_iterator1(row_buffer_, col_buffer_, elements_, size1_, 0); }
+
+private:
+  IndexT   const * row_buffer_;
+  IndexT   const * col_buffer_;
+  NumericT const * elements_;
+  size_type size1_;
+  size_type size2_;
+};
+
 }
 }
 #endif
@@ -0,0 +1,567 @@
+#ifndef VIENNACL_TOOLS_SPARSE_FORMAT_HPP_
+#define VIENNACL_TOOLS_SPARSE_FORMAT_HPP_
+
+/* =========================================================================
+   Copyright (c) 2010-2016, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+   Portions of this software are copyright by UChicago Argonne, LLC.
+
+                            -----------------
+                  ViennaCL - The Vienna Computing Library
+                            -----------------
+
+   Project Head:    Karl Rupp                   rupp@iue.tuwien.ac.at
+
+   (A list of authors and contributors can be found in the manual)
+
+   License:         MIT (X11), see file LICENSE in the base directory
+============================================================================= */
+
+/** @file viennacl/tools/sparse_format.hpp
+    @brief Analysis of the sparsity pattern of a compressed_matrix, selection of a suitable sparse matrix format, and conversion to that format.
+
+    The statistics of the row lengths of a matrix (mean, variance, maximum, fraction of empty rows, bandwidth, padding overhead of the ELL-type formats)
+    determine which of the sparse matrix formats is likely to yield the fastest matrix-vector products for the compute backend the matrix resides in.
+    The heuristic can optionally be validated by a short benchmark of all candidate formats.
+
+    Conversions read the arrays of the compressed_matrix directly, i.e. they do not set up an intermediate std::vector<std::map<> >.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "viennacl/forwards.h"
+#include "viennacl/vector.hpp"
+#include "viennacl/compressed_matrix.hpp"
+#include "viennacl/compressed_compressed_matrix.hpp"
+#include "viennacl/coordinate_matrix.hpp"
+#include "viennacl/ell_matrix.hpp"
+#include "viennacl/sliced_ell_matrix.hpp"
+#include "viennacl/hyb_matrix.hpp"
+#include "viennacl/backend/memory.hpp"
+#include "viennacl/linalg/host_based/common.hpp"
+#include "viennacl/tools/adapter.hpp"
+#include "viennacl/tools/shared_ptr.hpp"
+#include "viennacl/tools/timer.hpp"
+
+#ifdef VIENNACL_WITH_OPENMP
+#include <omp.h>
+#endif
+
+// Largest ratio of stored entries (including padding) to nonzeros for which ell_matrix is selected:
+#ifndef VIENNACL_SPARSE_FORMAT_ELL_MAX_FILL
+  #define VIENNACL_SPARSE_FORMAT_ELL_MAX_FILL  1.2
+#endif
+
+// Largest ratio of stored entries (including padding) to nonzeros for which sliced_ell_matrix is selected:
+#ifndef VIENNACL_SPARSE_FORMAT_SLICED_ELL_MAX_FILL
+  #define VIENNACL_SPARSE_FORMAT_SLICED_ELL_MAX_FILL  1.5
+#endif
+
+// Smallest fraction of empty rows for which compressed_compressed_matrix is selected:
+#ifndef VIENNACL_SPARSE_FORMAT_EMPTY_ROW_FRACTION
+  #define VIENNACL_SPARSE_FORMAT_EMPTY_ROW_FRACTION  0.5
+#endif
+
+namespace viennacl
+{
+namespace tools
+{
+
+/** @brief The sparse matrix formats among which the format selection chooses */
+enum sparse_format
+{
+  sparse_format_compressed = 0,     // compressed_matrix (CSR)
+  sparse_format_compressed_compressed, // compressed_compressed_matrix (CSR without empty rows)
+  sparse_format_coordinate,         // coordinate_matrix (COO)
+  sparse_format_ell,                // ell_matrix
+  sparse_format_sliced_ell,         // sliced_ell_matrix (SELL-C-sigma)
+  sparse_format_hyb,                // hyb_matrix (ELL + CSR)
+  sparse_format_count
+};
+
+/** @brief Returns the name of the matrix type for the provided sparse format */
+inline const char * sparse_format_name(sparse_format format)
+{
+  switch (format)
+  {
+  case sparse_format_compressed:            return "compressed_matrix";
+  case sparse_format_compressed_compressed: return "compressed_compressed_matrix";
+  case sparse_format_coordinate:            return "coordinate_matrix";
+  case sparse_format_ell:                   return "ell_matrix";
+  case sparse_format_sliced_ell:            return "sliced_ell_matrix";
+  case sparse_format_hyb:                   return "hyb_matrix";
+  default: break;
+  }
+  return "unknown";
+}
+
+/** @brief Statistics on the sparsity pattern of a sparse matrix, see analyze_sparse_matrix() */
+struct sparse_matrix_statistics
+{
+  sparse_matrix_statistics() : size1(0), size2(0), nnz(0), mean_row_length(0), row_length_variance(0), max_row_length(0),
+                               empty_row_fraction(0), bandwidth(0), ell_fill(1), sliced_ell_fill(1) {}
+
+  vcl_size_t size1;
+  vcl_size_t size2;
+  vcl_size_t nnz;
+  double     mean_row_length;
+  double     row_length_variance;
+  vcl_size_t max_row_length;
+  double     empty_row_fraction;
+  vcl_size_t bandwidth;           // largest distance |i - j| of a nonzero (i, j) from the diagonal
+  double     ell_fill;            // entries stored by ell_matrix (including padding) per nonzero
+  double     sliced_ell_fill;     // entries stored by sliced_ell_matrix with 32 rows per block and unsorted rows per nonzero. Sorting reduces the padding further.
+};
+
+namespace detail
+{
+  /** @brief Host access to the arrays of a compressed_matrix. Buffers in main memory are accessed in place, buffers of other compute backends are copied to the host. */
+  template<typename NumericT>
+  class csr_host_arrays
+  {
+  public:
+    template<unsigned int AlignmentV>
+    explicit csr_host_arrays(viennacl::compressed_matrix<NumericT, AlignmentV> const & A) : row_buffer_(NULL), col_buffer_(NULL), elements_(NULL)
+    {
+      if (A.size1() == 0)
+        return;
+
+      if (viennacl::traits::active_handle_id(A) == viennacl::MAIN_MEMORY)
+      {
+        row_buffer_ = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle1());
+        if (A.nnz() > 0)
+        {
+          col_buffer_ = viennacl::linalg::host_based::detail::extract_raw_pointer<unsigned int>(A.handle2());
+          elements_   = viennacl::linalg::host_based::detail::extract_raw_pointer<NumericT>(A.handle());
+        }
+        return;
+      }
+
+      viennacl::backend::typesafe_host_array<unsigned int> row_buffer(A.handle1(), A.size1() + 1);
+      viennacl::backend::memory_read(A.handle1(), 0, row_buffer.raw_size(), row_buffer.get());
+      rows_copy_.resize(A.size1() + 1);
+      for (vcl_size_t i = 0; i < rows_copy_.size(); ++i)
+        rows_copy_[i] = static_cast<unsigned int>(row_buffer[i]);
+      row_buffer_ = &(rows_copy_[0]);
+
+      if (A.nnz() > 0)
+      {
+        viennacl::backend::typesafe_host_array<unsigned int> col_buffer(A.handle2(), A.nnz());
+        viennacl::backend::memory_read(A.handle2(), 0, col_buffer.raw_size(), col_buffer.get());
+        cols_copy_.resize(A.nnz());
+        for (vcl_size_t i = 0; i < cols_copy_.size(); ++i)
+          cols_copy_[i] = static_cast<unsigned int>(col_buffer[i]);
+        col_buffer_ = &(cols_copy_[0]);
+
+        elements_copy_.resize(A.nnz());
+        viennacl::backend::memory_read(A.handle(), 0, sizeof(NumericT) * A.nnz(), &(elements_copy_[0]));
+        elements_ = &(elements_copy_[0]);
+      }
+    }
+
+    unsigned int const * row_buffer() const { return row_buffer_; }
+    unsigned int const * col_buffer() const { return col_buffer_; }
+    NumericT     const * elements()   const { return elements_; }
+
+  private:
+    csr_host_arrays(csr_host_arrays const &);
+    csr_host_arrays & operator=(csr_host_arrays const &);
+
+    unsigned int const * row_buffer_;
+    unsigned int const * col_buffer_;
+    NumericT     const * elements_;
+
+    std::vector<unsigned int> rows_copy_;
+    std::vector<unsigned int> cols_copy_;
+    std::vector<NumericT>     elements_copy_;
+  };
+}
+
+/** @brief Computes statistics on the row lengths and the sparsity pattern of a compressed_matrix. */
+template<typename NumericT, unsigned int AlignmentV>
+sparse_matrix_statistics analyze_sparse_matrix(viennacl::compressed_matrix<NumericT, AlignmentV> const & A)
+{
+  sparse_matrix_statistics stats;
+  stats.size1 = A.size1();
+  stats.size2 = A.size2();
+  if (A.size1() == 0)
+    return stats;
+
+  detail::csr_host_arrays<NumericT> arrays(A);
+  unsigned int const * row_buffer = arrays.row_buffer();
+  unsigned int const * col_buffer = arrays.col_buffer();
+
+  vcl_size_t const rows_per_block = 32; // default block size of sliced_ell_matrix
+  vcl_size_t num_blocks = (A.size1() - 1) / rows_per_block + 1;
+
+  // partial results for contiguous chunks of blocks:
+  vcl_size_t num_chunks = 1;
+#ifdef VIENNACL_WITH_OPENMP
+  num_chunks = std::max<vcl_size_t>(1, std::min<vcl_size_t>(static_cast<vcl_size_t>(omp_get_max_threads()), num_blocks / 64));
+#endif
+  std::vector<double>     sum_of_squares(num_chunks);
+  std::vector<vcl_size_t> max_row_length(num_chunks), empty_rows(num_chunks), bandwidth(num_chunks), sliced_ell_entries(num_chunks);
+
+#ifdef VIENNACL_WITH_OPENMP
+  #pragma omp parallel for num_threads(static_cast<int>(num_chunks)) if (num_chunks > 1)
+#endif
+  for (long chunk = 0; chunk < static_cast<long>(num_chunks); ++chunk)
+  {
+    vcl_size_t block_begin = (static_cast<vcl_size_t>(chunk)     * num_blocks) / num_chunks;
+    vcl_size_t block_end   = (static_cast<vcl_size_t>(chunk + 1) * num_blocks) / num_chunks;
+
+    double     my_sum_of_squares = 0;
+    vcl_size_t my_max_row_length = 0, my_empty_rows = 0, my_bandwidth = 0, my_sliced_ell_entries = 0;
+    for (vcl_size_t block = block_begin; block < block_end; ++block)
+    {
+      vcl_size_t block_max_row_length = 0;
+      for (vcl_size_t row = block * rows_per_block; row < std::min((block + 1) * rows_per_block, A.size1()); ++row)
+      {
+        vcl_size_t row_length = row_buffer[row + 1] - row_buffer[row];
+        my_sum_of_squares += double(row_length) * double(row_length);
+        block_max_row_length = std::max(block_max_row_length, row_length);
+        if (row_length == 0)
+          ++my_empty_rows;
+
+        for (vcl_size_t k = row_buffer[row]; k < row_buffer[row + 1]; ++k)
+        {
+          vcl_size_t col = col_buffer[k];
+          my_bandwidth = std::max(my_bandwidth, (col > row) ? col - row : row - col);
+        }
+      }
+      my_max_row_length = std::max(my_max_row_length, block_max_row_length);
+      my_sliced_ell_entries += block_max_row_length * rows_per_block;
+    }
+
+    sum_of_squares[static_cast<vcl_size_t>(chunk)]     = my_sum_of_squares;
+    max_row_length[static_cast<vcl_size_t>(chunk)]     = my_max_row_length;
+    empty_rows[static_cast<vcl_size_t>(chunk)]         = my_empty_rows;
+    bandwidth[static_cast<vcl_size_t>(chunk)]          = my_bandwidth;
+    sliced_ell_entries[static_cast<vcl_size_t>(chunk)] = my_sliced_ell_entries;
+  }
+
+  double     total_sum_of_squares = 0;
+  vcl_size_t total_empty_rows = 0, total_sliced_ell_entries = 0;
+  for (vcl_size_t chunk = 0; chunk < num_chunks; ++chunk)
+  {
+    total_sum_of_squares     += sum_of_squares[chunk];
+    total_empty_rows         += empty_rows[chunk];
+    total_sliced_ell_entries += sliced_ell_entries[chunk];
+    stats.max_row_length      = std::max(stats.max_row_length, max_row_length[chunk]);
+    stats.bandwidth           = std::max(stats.bandwidth, bandwidth[chunk]);
+  }
+
+  stats.nnz                 = row_buffer[A.size1()];
+  stats.mean_row_length     = double(stats.nnz) / double(A.size1());
+  stats.row_length_variance = std::max(0.0, total_sum_of_squares / double(A.size1()) - stats.mean_row_length * stats.mean_row_length);
+  stats.empty_row_fraction  = double(total_empty_rows) / double(A.size1());
+  if (stats.nnz > 0)
+  {
+    stats.ell_fill        = double(stats.max_row_length * A.size1()) / double(stats.nnz);
+    stats.sliced_ell_fill = double(total_sliced_ell_entries) / double(stats.nnz);
+  }
+
+  return stats;
+}
+
+/** @brief Recommends a sparse matrix format for matrix-vector products based on the statistics of the matrix and the memory domain the products are computed in.
+*
+* ell_matrix is preferred for (almost) constant row lengths, sliced_ell_matrix for moderately varying row lengths.
+* On GPUs, hyb_matrix handles a few long rows in otherwise regular matrices, while compressed_matrix remains for highly irregular matrices.
+* On the host, compressed_matrix balances irregular matrices (see the merge-path kernel). Matrices with mostly empty rows use compressed_compressed_matrix.
+*/
+inline sparse_format recommend_sparse_format(sparse_matrix_statistics const & stats, viennacl::memory_types memory_type)
+{
+  if (stats.nnz == 0)
+    return sparse_format_compressed;
+
+  if (stats.empty_row_fraction >= VIENNACL_SPARSE_FORMAT_EMPTY_ROW_FRACTION)
+    return sparse_format_compressed_compressed;
+
+  if (stats.ell_fill <= VIENNACL_SPARSE_FORMAT_ELL_MAX_FILL)
+    return sparse_format_ell;
+
+  if (stats.sliced_ell_fill <= VIENNACL_SPARSE_FORMAT_SLICED_ELL_MAX_FILL)
+    return sparse_format_sliced_ell;
+
+  if (memory_type != viennacl::MAIN_MEMORY && double(stats.max_row_length) > 4.0 * stats.mean_row_length
+      && stats.row_length_variance <= stats.mean_row_length * stats.mean_row_length)
+    return sparse_format_hyb;
+
+  return sparse_format_compressed;
+}
+
+/** @brief Converts a compressed_matrix to one of the other sparse matrix types (coordinate_matrix, ell_matrix, sliced_ell_matrix, hyb_matrix, compressed_compressed_matrix).
+*
+* The arrays of A are read directly (in place for matrices in main memory), no intermediate std::vector<std::map<> > is set up.
+* The parameters of B (e.g. the block size of a sliced_ell_matrix) and its memory domain are preserved.
+*/
+template<typename NumericT, unsigned int AlignmentV, typename SparseMatrixT>
+void convert(viennacl::compressed_matrix<NumericT, AlignmentV> const & A, SparseMatrixT & B)
+{
+  detail::csr_host_arrays<NumericT> arrays(A);
+  viennacl::tools::const_csr_matrix_adapter<NumericT> A_adapted(arrays.row_buffer(), arrays.col_buffer(), arrays.elements(), A.size1(), A.size2());
+  viennacl::copy(A_adapted, B);
+}
+
+
+/** @brief A sparse matrix which is stored in the format recommended for (or measured to be the fastest for) matrix-vector products.
+*
+* Set up from a compressed_matrix. Only the selected format is kept. Matrix-vector products are available via y = viennacl::linalg::prod(A, x) and viennacl::linalg::prod_impl(A, x, alpha, y, beta),
+* so the matrix can be passed to the iterative solvers like any other sparse matrix type.
+*/
+template<typename NumericT>
+class adaptive_sparse_matrix
+{
+public:
+  /** @brief Sets up the matrix in the recommended format.
+  *
+  * @param A                        The matrix
+  * @param benchmark_repetitions    If nonzero, all candidate formats are set up and the one with the fastest matrix-vector products (over the given number of repetitions) is kept
+  */
+  explicit adaptive_sparse_matrix(viennacl::compressed_matrix<NumericT> const & A, vcl_size_t benchmark_repetitions = 0)
+    : stats_(analyze_sparse_matrix(A)),
+      ctx_(viennacl::traits::context(A)),
+      format_(recommend_sparse_format(stats_, ctx_.memory_type()))
+  {
+    if (benchmark_repetitions == 0)
+    {
+      set_up(A, format_);
+      return;
+    }
+
+    viennacl::vector<NumericT> x = viennacl::scalar_vector<NumericT>(A.size2(), NumericT(1), ctx_);
+    viennacl::vector<NumericT> y(A.size1(), ctx_);
+
+    sparse_format best_format = format_;
+    double best_time = -1;
+    for (int i = 0; i < sparse_format_count; ++i)
+    {
+      sparse_format candidate = sparse_format(i);
+      if (candidate == sparse_format_ell && stats_.ell_fill > 4.0 * VIENNACL_SPARSE_FORMAT_ELL_MAX_FILL) // excessive memory requirements
+        continue;
+
+      format_ = candidate;
+      set_up(A, candidate);
+      prod_impl(x, NumericT(1), y, NumericT(0)); // warm-up
+
+      viennacl::backend::finish();
+      viennacl::tools::timer timer;
+      timer.start();
+      for (vcl_size_t k = 0; k < benchmark_repetitions; ++k)
+        prod_impl(x, NumericT(1), y, NumericT(0));
+      viennacl::backend::finish();
+      double time = timer.get();
+
+      // keep only the fastest format so far, so that at most two formats are allocated at any time:
+      if (best_time < 0 || time < best_time)
+      {
+        if (best_time >= 0)
+          release(best_format);
+        best_time = time;
+        best_format = candidate;
+      }
+      else
+        release(candidate);
+    }
+
+    format_ = best_format;
+  }
+
+  vcl_size_t size1() const { return stats_.size1; }
+  vcl_size_t size2() const { return stats_.size2; }
+
+  /** @brief Returns the format in which the matrix is stored */
+  sparse_format format() const { return format_; }
+
+  /** @brief Returns the statistics on the sparsity pattern the format has been selected by */
+  sparse_matrix_statistics const & statistics() const { return stats_; }
+
+  /** @brief Accessors to the matrix in the respective format. Only the one returned by format() may be called. */
+  viennacl::compressed_matrix<NumericT>            const & compressed()            const { assert(compressed_.get()            && bool("Matrix not stored in this format")); return *compressed_; }
+  viennacl::compressed_compressed_matrix<NumericT> const & compressed_compressed() const { assert(compressed_compressed_.get() && bool("Matrix not stored in this format")); return *compressed_compressed_; }
+  viennacl::coordinate_matrix<NumericT>            const & coordinate()            const { assert(coordinate_.get()            && bool("Matrix not stored in this format")); return *coordinate_; }
+  viennacl::ell_matrix<NumericT>                   const & ell()                   const { assert(ell_.get()                   && bool("Matrix not stored in this format")); return *ell_; }
+  viennacl::sliced_ell_matrix<NumericT>            const & sliced_ell()            const { assert(sliced_ell_.get()            && bool("Matrix not stored in this format")); return *sliced_ell_; }
+  viennacl::hyb_matrix<NumericT>                   const & hyb()                   const { assert(hyb_.get()                   && bool("Matrix not stored in this format")); return *hyb_; }
+
+  /** @brief Computes y = alpha * A * x + beta * y */
+  void prod_impl(viennacl::vector_base<NumericT> const & x, NumericT alpha, viennacl::vector_base<NumericT> & y, NumericT beta) const
+  {
+    switch (format_)
+    {
+    case sparse_format_compressed:            viennacl::linalg::prod_impl(compressed(),            x, alpha, y, beta); break;
+    case sparse_format_compressed_compressed: viennacl::linalg::prod_impl(compressed_compressed(), x, alpha, y, beta); break;
+    case sparse_format_coordinate:            viennacl::linalg::prod_impl(coordinate(),            x, alpha, y, beta); break;
+    case sparse_format_ell:                   viennacl::linalg::prod_impl(ell(),                   x, alpha, y, beta); break;
+    case sparse_format_sliced_ell:            viennacl::linalg::prod_impl(sliced_ell(),            x, alpha, y, beta); break;
+    case sparse_format_hyb:                   viennacl::linalg::prod_impl(hyb(),                   x, alpha, y, beta); break;
+    default: break;
+    }
+  }
+
+private:
+  void set_up(viennacl::compressed_matrix<NumericT> const & A, sparse_format format)
+  {
+    switch (format)
+    {
+    case sparse_format_compressed:
+      compressed_.reset(new viennacl::compressed_matrix<NumericT>(ctx_));
+      *compressed_ = A;
+      break;
+    case sparse_format_compressed_compressed:
+      compressed_compressed_.reset(new viennacl::compressed_compressed_matrix<NumericT>(ctx_));
+      convert(A, *compressed_compressed_);
+      break;
+    case sparse_format_coordinate:
+      coordinate_.reset(new viennacl::coordinate_matrix<NumericT>(ctx_));
+      convert(A, *coordinate_);
+      break;
+    case sparse_format_ell:
+      ell_.reset(new viennacl::ell_matrix<NumericT>(ctx_));
+      convert(A, *ell_);
+      break;
+    case sparse_format_sliced_ell:  // rows are sorted within windows of 256 rows
+      sliced_ell_.reset(new viennacl::sliced_ell_matrix<NumericT>(A.size1(), A.size2(), 32, 256, ctx_));
+      convert(A, *sliced_ell_);
+      break;
+    case sparse_format_hyb:
+      hyb_.reset(new viennacl::hyb_matrix<NumericT>(ctx_));
+      convert(A, *hyb_);
+      break;
+    default: break;
+    }
+  }
+
+  void release(sparse_format format)
+  {
+    switch (format)
+    {
+    case sparse_format_compressed:            compressed_.reset();            break;
+    case sparse_format_compressed_compressed: compressed_compressed_.reset(); break;
+    case sparse_format_coordinate:            coordinate_.reset();            break;
+    case sparse_format_ell:                   ell_.reset();                   break;
+    case sparse_format_sliced_ell:            sliced_ell_.reset();            break;
+    case sparse_format_hyb:                   hyb_.reset();                   break;
+    default: break;
+    }
+  }
+
+  sparse_matrix_statistics stats_;
+  viennacl::context        ctx_;
+  sparse_format            format_;
+
+  viennacl::tools::shared_ptr<viennacl::compressed_matrix<NumericT> >            compressed_;
+  viennacl::tools::shared_ptr<viennacl::compressed_compressed_matrix<NumericT> > compressed_compressed_;
+  viennacl::tools::shared_ptr<viennacl::coordinate_matrix<NumericT> >            coordinate_;
+  viennacl::tools::shared_ptr<viennacl::ell_matrix<NumericT> >                   ell_;
+  viennacl::tools::shared_ptr<viennacl::sliced_ell_matrix<NumericT> >            sliced_ell_;
+  viennacl::tools::shared_ptr<viennacl::hyb_matrix<NumericT> >                   hyb_;
+};
+
+} //namespace tools
+
+
+namespace linalg
+{
+  /** @brief Returns an expression template representing the matrix-vector product A * x with an adaptive_sparse_matrix */
+  template<typename NumericT>
+  viennacl::vector_expression<const viennacl::tools::adaptive_sparse_matrix<NumericT>, const viennacl::vector_base<NumericT>, op_prod>
+  prod(viennacl::tools::adaptive_sparse_matrix<NumericT> const & A, viennacl::vector_base<NumericT> const & x)
+  {
+    return viennacl::vector_expression<const viennacl::tools::adaptive_sparse_matrix<NumericT>, const viennacl::vector_base<NumericT>, op_prod>(A, x);
+  }
+
+  /** @brief Carries out the matrix-vector product y = alpha * A * x + beta * y in the format the adaptive_sparse_matrix is stored in
+  *
+  * @param A      The matrix
+  * @param x      The vector
+  * @param alpha  Scaling factor for A * x
+  * @param y      The result vector
+  * @param beta   Scaling factor for y
+  */
+  template<typename NumericT>
+  void prod_impl(viennacl::tools::adaptive_sparse_matrix<NumericT> const & A,
+                 viennacl::vector_base<NumericT> const & x,
+                 NumericT alpha,
+                 viennacl::vector_base<NumericT> & y,
+                 NumericT beta)
+  {
+    assert( (A.size1() == y.size()) && bool("Size check failed for adaptive matrix-vector product: size1(A) != size(y)"));
+    assert( (A.size2() == x.size()) && bool("Size check failed for adaptive matrix-vector product: size2(A) != size(x)"));
+
+    A.prod_impl(x, alpha, y, beta);
+  }
+
+  /** @brief Carries out the matrix-vector product y = A * x in the format the adaptive_sparse_matrix is stored in */
+  template<typename NumericT>
+  void prod_impl(viennacl::tools::adaptive_sparse_matrix<NumericT> const & A,
+                 viennacl::vector_base<NumericT> const & x,
+                 viennacl::vector_base<NumericT> & y)
+  {
+    viennacl::linalg::prod_impl(A, x, NumericT(1), y, NumericT(0));
+  }
+
+/** \cond */
+namespace detail
+{
+  // x = A * y
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_assign, vector_expression<const viennacl::tools::adaptive_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const viennacl::tools::adaptive_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x = A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs = temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(0));
+    }
+  };
+
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_inplace_add, vector_expression<const viennacl::tools::adaptive_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const viennacl::tools::adaptive_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x += A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs += temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), lhs, NumericT(1));
+    }
+  };
+
+  template<typename NumericT>
+  struct op_executor<vector_base<NumericT>, op_inplace_sub, vector_expression<const viennacl::tools::adaptive_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> >
+  {
+    static void apply(vector_base<NumericT> & lhs, vector_expression<const viennacl::tools::adaptive_sparse_matrix<NumericT>, const vector_base<NumericT>, op_prod> const & rhs)
+    {
+      // check for the special case x -= A * x
+      if (viennacl::traits::handle(lhs) == viennacl::traits::handle(rhs.rhs()))
+      {
+        viennacl::vector<NumericT> temp(lhs);
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(1), temp, NumericT(0));
+        lhs -= temp;
+      }
+      else
+        viennacl::linalg::prod_impl(rhs.lhs(), rhs.rhs(), NumericT(-1), lhs, NumericT(1));
+    }
+  };
+} // namespace detail
+/** \endcond */
+} //namespace linalg
+} //namespace viennacl
+
+#endif
@@ -44,6 +44,9 @@ viennacl::context context(T const & t)
     return viennacl::context(traits::opencl_handle(t).context());
 #endif
 
+  if (traits::active_handle_id(t) == MAIN_MEMORY && traits::host_memory_pool(t))
+    return viennacl::context(*traits::host_memory_pool(t));
+
   return viennacl::context(traits::active_handle_id(t));
 }
 
@@ -55,6 +58,9 @@ inline viennacl::context context(viennacl::backend::mem_handle const & h)
     return viennacl::context(h.opencl_handle().context());
 #endif
 
+  if (h.get_active_handle_id() == MAIN_MEMORY && h.ram_memory_pool())
+    return viennacl::context(*h.ram_memory_pool());
+
   return viennacl::context(h.get_active_handle_id());
 }
 
@@ -263,6 +263,59 @@ viennacl::memory_types active_handle_id(viennacl::vector_expression<LHS, const v
 
 /** \endcond */
 
+
+//
+// Memory pool for buffers in main RAM
+//
+/** @brief Returns the memory pool the buffer of an object in main RAM has been obtained from (NULL if none) */
+template<typename T>
+viennacl::backend::cpu_ram::memory_pool * host_memory_pool(T const & obj)
+{
+  return handle(obj).ram_memory_pool();
+}
+
+/** \cond */
+template<typename T>
+viennacl::backend::cpu_ram::memory_pool * host_memory_pool(circulant_matrix<T> const &) { return NULL; }
+
+template<typename T>
+viennacl::backend::cpu_ram::memory_pool * host_memory_pool(hankel_matrix<T> const &) { return NULL; }
+
+template<typename T>
+viennacl::backend::cpu_ram::memory_pool * host_memory_pool(toeplitz_matrix<T> const &) { return NULL; }
+
+template<typename T>
+viennacl::backend::cpu_ram::memory_pool * host_memory_pool(vandermonde_matrix<T> const &) { return NULL; }
+
+template<typename LHS, typename RHS, typename OP>
+viennacl::backend::cpu_ram::memory_pool * host_memory_pool(viennacl::vector_expression<LHS, RHS, OP> const &);
+
+template<typename LHS, typename RHS, typename OP>
+viennacl::backend::cpu_ram::memory_pool * host_memory_pool(viennacl::scalar_expression<LHS, RHS, OP> const & obj)
+{
+  return host_memory_pool(obj.lhs());
+}
+
+template<typename LHS, typename RHS, typename OP>
+viennacl::backend::cpu_ram::memory_pool * host_memory_pool(viennacl::vector_expression<LHS, RHS, OP> const & obj)
+{
+  return host_memory_pool(obj.lhs());
+}
+
+template<typename LHS, typename RHS, typename OP>
+viennacl::backend::cpu_ram::memory_pool * host_memory_pool(viennacl::matrix_expression<LHS, RHS, OP> const & obj)
+{
+  return host_memory_pool(obj.lhs());
+}
+
+template<typename LHS, typename NumericT>
+viennacl::backend::cpu_ram::memory_pool * host_memory_pool(viennacl::vector_expression<LHS, const vector_base<NumericT>, op_prod> const & obj)
+{
+  return host_memory_pool(obj.rhs());
+}
+
+/** \endcond */
+
 } //namespace traits
 } //namespace viennacl
 